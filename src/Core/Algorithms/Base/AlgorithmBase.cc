@@ -282,6 +282,11 @@ void AlgorithmLogger::setErrorFlag(bool flag)
   logger_->setErrorFlag(flag);
 }
 
+bool AlgorithmLogger::takeErrorFlag()
+{
+  return logger_->takeErrorFlag();
+}
+
 AlgorithmParameterList::AlgorithmParameterList() {}
 
 bool AlgorithmParameterList::set(const AlgorithmParameterName& key, const AlgorithmParameter::Value& value)
@@ -48,6 +48,7 @@ namespace Algorithms {
     void error(const std::string& error) const override;
     bool errorReported() const override;
     void setErrorFlag(bool flag) override;
+    bool takeErrorFlag() override;
     void warning(const std::string& warning) const override;
     void remark(const std::string& remark) const override;
     void status(const std::string& status) const override;
@@ -27,6 +27,7 @@
 
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/BrainStimulator/BiotSavartSolverAlgorithm.h>
+#include <Core/Algorithms/BrainStimulator/TreeCode.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -57,6 +58,69 @@ ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorBField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, VectorAField);
 ALGORITHM_PARAMETER_DEF(BrainStimulator, OutType);
 
+namespace {
+//! Field kernels for the tree code: the contribution at x of a source at y with strength c,
+//! written exactly as in the direct loops below with the strength factors folded into c.
+
+//! coil segment element, c = dL * |I|
+struct SegmentBField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+  {
+    const Vector R = y - x;
+    const double Rn = R.length();
+    return 1.0e-7 * Cross(R, c) * (1.0 / (Rn * Rn * Rn));
+  }
+};
+
+struct SegmentAField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+  {
+    return 1.0e-7 * c * (1.0 / (y - x).length());
+  }
+};
+
+//! volume element, c = J * volume / (4 pi)
+struct VolumeBField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+  {
+    const Vector R = y - x;
+    return Cross(c, R) * (1.0 / R.length());
+  }
+};
+
+struct VolumeAField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+  {
+    return c * (1.0 / (y - x).length());
+  }
+};
+
+//! magnetic dipole, c = moment
+struct DipoleBField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& m) const
+  {
+    const Vector R = y - x;
+    const double Rl = R.length();
+    return 1.0e-7 * (3 * R * Dot(m, R) / (Rl * Rl * Rl * Rl * Rl) - m / (Rl * Rl * Rl));
+  }
+};
+
+struct DipoleAField
+{
+  Vector operator()(const Vector& x, const Vector& y, const Vector& m) const
+  {
+    const Vector R = y - x;
+    const double Rl = R.length();
+    return 1.0e-7 * Cross(m, R) / (Rl * Rl * Rl);
+  }
+};
+}
+
 class KernelBase
 {
  public:
@@ -93,6 +157,10 @@ class KernelBase
   int typeOut_;
   DenseMatrixHandle matOut_;
 
+  //! approximate far sources with the tree code instead of summing all of them
+  bool useTreeCode_{false};
+  TreeCodeParameters treeCodeParameters_;
+
   bool preIntegration(FieldHandle& mesh, FieldHandle& coil)
   {
     vmesh_ = mesh->vmesh();
@@ -109,6 +177,10 @@ class KernelBase
 
     success_.resize(numprocessors_, true);
 
+    useTreeCode_ = algo_->get(Parameters::UseTreeCode).toBool();
+    if (useTreeCode_)
+      treeCodeParameters_ = TreeCodeParameters(algo_->get(Parameters::TreeCodeTolerance).toDouble());
+
     //! get number of nodes for the model
     modelSize_ = vmesh_->num_nodes();
     assert(modelSize_ > 0);
@@ -124,6 +196,49 @@ class KernelBase
     return true;
   }
 
+  //! Evaluates the sources (positions, strengths) at every model node through a tree code,
+  //! with the same partitioning of the model nodes over the processors as the direct kernels.
+  template <class Kernel>
+  void integrateWithTreeCode(const std::vector<Vector>& positions, const std::vector<Vector>& strengths, const Kernel& kernel)
+  {
+    const TreeCode<Kernel> tree(positions, strengths, kernel, treeCodeParameters_);
+    algo_->remark("Tree code over " + std::to_string(tree.numSources()) + " sources, interpolation degree " +
+      std::to_string(treeCodeParameters_.degree));
+
+    Parallel::RunTasks([this, &tree](int proc_num)
+    {
+      int cnt = 0;
+      const index_type begins = (modelSize_ * proc_num) / numprocessors_;
+      const index_type ends = (modelSize_ * (proc_num + 1)) / numprocessors_;
+      try
+      {
+        for (VMesh::Node::index_type iM = begins; iM < ends; iM++)
+        {
+          Point modelNode;
+          vmesh_->get_node(modelNode, iM);
+          const Vector F = tree.evaluate(Vector(modelNode));
+
+          matOut_->put(iM, 0, F[0]);
+          matOut_->put(iM, 1, F[1]);
+          matOut_->put(iM, 2, F[2]);
+
+          //! progress reporter
+          if (proc_num == 0 && ++cnt == 200)
+          {
+            cnt = 0;
+            algo_->update_progress_max(iM, ends - begins);
+          }
+        }
+        success_[proc_num] = true;
+      }
+      catch (...)
+      {
+        algo_->error("Tree code crashed while integrating");
+        success_[proc_num] = false;
+      }
+    }, numprocessors_);
+  }
+
   bool postIntegration(DenseMatrixHandle& outdata)
   {
     //! check for error
@@ -190,8 +305,11 @@ class PieceWiseKernel : public KernelBase
       coilNodes_.emplace_back(enode2);
     }
 
-    //! Start the multi threaded
-    Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
+    if (useTreeCode_)
+      integrateWithTreeCode();
+    else
+      //! Start the multi threaded
+      Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
     return postIntegration(outdata);
   }
@@ -248,50 +366,9 @@ class PieceWiseKernel : public KernelBase
         // result
         Vector F;
 
-        for (size_t iC0 = 0, iC1 = 1, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iC1 += 2, iCV++)
+        for (size_t iC0 = 0, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iCV++)
         {
-          double currentFromField;
-          vcoilField_->get_value(currentFromField, iCV);
-
-          const double current = currentFromField == 0.0 ? 1.0 : currentFromField;
-          auto absCurrent = std::fabs(current);
-
-          Vector coilNodeThis;
-          Vector coilNodeNext;
-
-          if (current >= 0.0)
-          {
-            coilNodeThis = coilNodes_[iC0];
-            coilNodeNext = coilNodes_[iC1];
-          }
-          else
-          {
-            coilNodeThis = coilNodes_[iC1];
-            coilNodeNext = coilNodes_[iC0];
-          }
-
-          //! Length of the curve element
-          Vector diffNodes = coilNodeNext - coilNodeThis;
-          const double newSegLen = diffNodes.length();
-
-          // first check if externally suplied integration step is available and use it
-          if (extstep_ > 0) { nips = newSegLen / extstep_; }
-          else
-          {
-            //! optimization
-            //! only recompute integration step only if segment length changes
-            if (fabs(prevSegLen - newSegLen) > 0.00000001)
-            {
-              prevSegLen = newSegLen;
-
-              // auto adaptive integration step calculation
-              nips = adjustNumberOfIntegrationPoints(newSegLen);
-            }
-          }
-
-          if (nips < 3) { algo_->warning("integration step too big"); }
-
-          integrPoints.clear();
+          const double absCurrent = discretizeSegment(iC0, iCV, prevSegLen, nips, integrPoints);
 
           if (!remarkedOnProblemSize && proc_num == 0)
           {
@@ -300,18 +377,10 @@ class PieceWiseKernel : public KernelBase
                 "Per core load: " + formatWithCommas(problemSize) + " field computations.");
             algo_->remark(
                 "To speed up this module, reduce the number of nodes in either the input mesh or "
-                "the coil, or pick a simpler algorithm.");
+                "the coil, enable the tree code, or pick a simpler algorithm.");
             remarkedOnProblemSize = true;
           }
 
-          //! curve segment discretization
-          for (int iip = 0; iip < nips; iip++)
-          {
-            const double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
-            auto v = Interpolate(coilNodeThis, coilNodeNext, interpolant);
-            integrPoints.push_back(v);
-          }
-
           //! integration step over line segment
           for (int iip = 0; iip < nips - 1; iip++)
           {
@@ -372,6 +441,86 @@ class PieceWiseKernel : public KernelBase
       if (!success_[q]) return;
   }
 
+  //! Splits the coil segment starting at coilNodes_[iC0] into nips integration points,
+  //! ordered along the current, and returns the absolute current of the segment
+  double discretizeSegment(size_t iC0, size_t iCV, double& prevSegLen, int& nips, std::vector<Vector>& integrPoints)
+  {
+    double currentFromField;
+    vcoilField_->get_value(currentFromField, iCV);
+
+    const double current = currentFromField == 0.0 ? 1.0 : currentFromField;
+    auto absCurrent = std::fabs(current);
+
+    Vector coilNodeThis;
+    Vector coilNodeNext;
+
+    if (current >= 0.0)
+    {
+      coilNodeThis = coilNodes_[iC0];
+      coilNodeNext = coilNodes_[iC0 + 1];
+    }
+    else
+    {
+      coilNodeThis = coilNodes_[iC0 + 1];
+      coilNodeNext = coilNodes_[iC0];
+    }
+
+    //! Length of the curve element
+    Vector diffNodes = coilNodeNext - coilNodeThis;
+    const double newSegLen = diffNodes.length();
+
+    // first check if externally suplied integration step is available and use it
+    if (extstep_ > 0) { nips = newSegLen / extstep_; }
+    else
+    {
+      //! optimization
+      //! only recompute integration step only if segment length changes
+      if (fabs(prevSegLen - newSegLen) > 0.00000001)
+      {
+        prevSegLen = newSegLen;
+
+        // auto adaptive integration step calculation
+        nips = adjustNumberOfIntegrationPoints(newSegLen);
+      }
+    }
+
+    if (nips < 3) { algo_->warning("integration step too big"); }
+
+    integrPoints.clear();
+
+    //! curve segment discretization
+    for (int iip = 0; iip < nips; iip++)
+    {
+      const double interpolant = static_cast<double>(iip) / static_cast<double>(nips);
+      auto v = Interpolate(coilNodeThis, coilNodeNext, interpolant);
+      integrPoints.push_back(v);
+    }
+    return absCurrent;
+  }
+
+  //! The integration elements of all coil segments as tree code sources: element midpoints
+  //! with strength dL * |I|
+  void integrateWithTreeCode()
+  {
+    std::vector<Vector> integrPoints, positions, strengths;
+    double prevSegLen = 123456789.12345678;
+    int nips = 0;
+    for (size_t iC0 = 0, iCV = 0; iC0 < coilNodes_.size(); iC0 += 2, iCV++)
+    {
+      const double absCurrent = discretizeSegment(iC0, iCV, prevSegLen, nips, integrPoints);
+      for (int iip = 0; iip < nips - 1; iip++)
+      {
+        positions.push_back((integrPoints[iip] + integrPoints[iip + 1]) / 2);
+        strengths.push_back((integrPoints[iip + 1] - integrPoints[iip]) * absCurrent);
+      }
+    }
+
+    if (typeOut_ == 1)
+      KernelBase::integrateWithTreeCode(positions, strengths, SegmentBField());
+    else if (typeOut_ == 2)
+      KernelBase::integrateWithTreeCode(positions, strengths, SegmentAField());
+  }
+
   //! Auto adjust accuracy of integration
   int adjustNumberOfIntegrationPoints(double len)
   {
@@ -417,13 +566,36 @@ class VolumetricKernel : public KernelBase
 
     vmesh_->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
-    //! Start the multi threaded
-    Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
+    if (useTreeCode_)
+      integrateWithTreeCode();
+    else
+      //! Start the multi threaded
+      Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
     return postIntegration(outdata);
   }
 
  private:
+  //! element centers as tree code sources, with strength J * volume / (4 pi)
+  void integrateWithTreeCode()
+  {
+    std::vector<Vector> positions(coilSize_), strengths(coilSize_);
+    Point coilCenter;
+    Vector current;
+    for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+    {
+      vcoilField_->get_value(current, iC);
+      vcoilField_->get_center(coilCenter, iC);
+      positions[iC] = Vector(coilCenter);
+      strengths[iC] = current * (vcoil_->get_volume(iC) / (4.0 * M_PI));
+    }
+
+    if (typeOut_ == 1)
+      KernelBase::integrateWithTreeCode(positions, strengths, VolumeBField());
+    else if (typeOut_ == 2)
+      KernelBase::integrateWithTreeCode(positions, strengths, VolumeAField());
+  }
+
   void ParallelKernel(int proc_num)
   {
     assert(proc_num >= 0);
@@ -525,13 +697,34 @@ class DipolesKernel : public KernelBase
     // needed?
     vmesh_->synchronize(Mesh::NODES_E | Mesh::EDGES_E);
 
-    //! Start the multi threaded
-    Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
+    if (useTreeCode_)
+      integrateWithTreeCode();
+    else
+      //! Start the multi threaded
+      Parallel::RunTasks([this](int i) { ParallelKernel(i); }, numprocessors_);
 
     return postIntegration(outdata);
   }
 
  private:
+  //! dipole locations as tree code sources, with their moments as strengths
+  void integrateWithTreeCode()
+  {
+    std::vector<Vector> positions(coilSize_), strengths(coilSize_);
+    Point dipoleLocation;
+    for (VMesh::Elem::index_type iC = 0; iC < coilSize_; iC++)
+    {
+      vcoilField_->get_value(strengths[iC], iC);
+      vcoilField_->get_center(dipoleLocation, iC);
+      positions[iC] = Vector(dipoleLocation);
+    }
+
+    if (typeOut_ == 1)
+      KernelBase::integrateWithTreeCode(positions, strengths, DipoleBField());
+    else if (typeOut_ == 2)
+      KernelBase::integrateWithTreeCode(positions, strengths, DipoleAField());
+  }
+
   void ParallelKernel(int proc_num)
   {
     assert(proc_num >= 0);
@@ -34,6 +34,7 @@
 #include <Core/Datatypes/Matrix.h>
 
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/BrainStimulator/TreeCode.h>
 #include <Core/Algorithms/BrainStimulator/share.h>
 
 ///@file BiotSavartSolverAlgorithm
@@ -44,7 +45,9 @@
 /// Implementation: Petar Petrov for SCIRun 4.7
 /// Converted to SCIRun5 by Moritz Dannhauer
 ///@details
-///
+///  With UseTreeCode set, sources far from a mesh node are approximated by a tree code
+///  (see TreeCode.h) to a relative accuracy of about TreeCodeTolerance, which turns the
+///  O(nodes x sources) sum into O(nodes x log(sources)).
 ///
 
 namespace SCIRun {
@@ -64,6 +67,8 @@ namespace BrainStimulator {
     BiotSavartSolverAlgorithm()
     {
       addParameter(Parameters::OutType, 0);
+      addParameter(Parameters::UseTreeCode, false);
+      addParameter(Parameters::TreeCodeTolerance, 1e-6);
     }
     AlgorithmOutput run(const AlgorithmInput& input) const override;
     bool run(FieldHandle mesh, FieldHandle coil, Datatypes::DenseMatrixHandle& outdata, int outtype) const;
@@ -44,6 +44,7 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <memory>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Geometry;
@@ -60,6 +61,27 @@ AlgorithmInputName SimulateForwardMagneticFieldAlgo::DetectorLocations("Detector
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticField("MagneticField");
 AlgorithmOutputName SimulateForwardMagneticFieldAlgo::MagneticFieldMagnitudes("MagneticFieldMagnitudes");
 
+SimulateForwardMagneticFieldAlgo::SimulateForwardMagneticFieldAlgo()
+{
+  addParameter(Parameters::UseTreeCode, false);
+  addParameter(Parameters::TreeCodeTolerance, 1e-6);
+}
+
+namespace
+{
+  // Field of a current element for the tree code, c = J * volume for cells and c = P for
+  // dipoles; the 1/(4 pi) is applied to the sum.
+  struct CurrentElementField
+  {
+    Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+    {
+      const Vector radius = x - y;
+      const double length = radius.length();
+      return Cross(c, radius) / (length * length * length);
+    }
+  };
+}
+
 class CalcFMField
 {
   public:
@@ -77,6 +99,7 @@ class CalcFMField
   private:
     void interpolate(int proc, Point p);
     void set_up_cell_cache();
+    void set_up_tree_code(double tolerance);
     void calc_parallel(int proc);
 
     const AlgorithmBase* algo_;
@@ -93,6 +116,9 @@ class CalcFMField
 
     std::vector<per_cell_cache>  cell_cache_;
 
+    // cells followed by dipoles, when the far field is approximated
+    std::unique_ptr<TreeCode<CurrentElementField>> tree_;
+
     VField* efld_; // Electric Field
     VField* ctfld_; // Conductivity Field
     VField* dipfld_; // Dipole Field
@@ -186,6 +212,35 @@ void CalcFMField::set_up_cell_cache()
   }
 }
 
+void CalcFMField::set_up_tree_code(double tolerance)
+{
+  const VMesh::size_type num_dipoles = dipmsh_->num_nodes();
+  std::vector<Vector> positions, strengths;
+  positions.reserve(cell_cache_.size() + num_dipoles);
+  strengths.reserve(cell_cache_.size() + num_dipoles);
+
+  for (const auto& c : cell_cache_)
+  {
+    positions.emplace_back(c.center_);
+    strengths.push_back(c.cur_density_ * c.volume_);
+  }
+
+  Point pt;
+  Vector P;
+  for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+  {
+    dipmsh_->get_center(pt, dip_idx);
+    dipfld_->value(P, dip_idx);
+    positions.emplace_back(pt);
+    strengths.push_back(P);
+  }
+
+  const TreeCodeParameters parameters(tolerance);
+  tree_.reset(new TreeCode<CurrentElementField>(positions, strengths, CurrentElementField(), parameters));
+  algo_->remark("Tree code over " + std::to_string(positions.size()) + " sources, interpolation degree " +
+    std::to_string(parameters.degree));
+}
+
 void CalcFMField::calc_parallel(int proc)
 {
 
@@ -211,26 +266,36 @@ void CalcFMField::calc_parallel(int proc)
 
     detmsh_->get_center(pt, idx);
 
-    // init the interp val to 0
-    interp_value_[proc] = Vector(0,0,0);
-    interpolate(proc, pt);
-
-    mag_field = interp_value_[proc];
-
     Vector normal;
     detfld_->get_value(normal,idx);
 
-    // iterate over the dipoles.
-    for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+    if (tree_)
+    {
+      // the cell holding the detector is left out, as in interpolate()
+      VMesh::Elem::index_type inside_cell = 0;
+      const bool outside = !(emsh_->locate(inside_cell, pt));
+      mag_field = tree_->evaluate(Vector(pt), outside ? -1 : static_cast<index_type>(inside_cell));
+    }
+    else
     {
-      dipmsh_->get_center(pt2, dip_idx);
-      dipfld_->value(P,dip_idx);
+      // init the interp val to 0
+      interp_value_[proc] = Vector(0,0,0);
+      interpolate(proc, pt);
 
-      Vector radius = pt - pt2; // detector - source
-      Vector valuePXR = Cross(P, radius);
-      double length = radius.length();
+      mag_field = interp_value_[proc];
+
+      // iterate over the dipoles.
+      for (VMesh::Node::index_type dip_idx = 0; dip_idx < num_dipoles; dip_idx++)
+      {
+        dipmsh_->get_center(pt2, dip_idx);
+        dipfld_->value(P,dip_idx);
+
+        Vector radius = pt - pt2; // detector - source
+        Vector valuePXR = Cross(P, radius);
+        double length = radius.length();
 
-      mag_field += valuePXR / (length * length * length);
+        mag_field += valuePXR / (length * length * length);
+      }
     }
 
     mag_field *= one_over_4_pi;
@@ -303,6 +368,12 @@ boost::tuple<FieldHandle,FieldHandle> CalcFMField::calc_forward_magnetic_field(F
   // cache per cell calculations that are used over and over again.
   set_up_cell_cache();
 
+  if (algo_->get(Parameters::UseTreeCode).toBool())
+  {
+    emsh_->synchronize(Mesh::ELEM_LOCATE_E);
+    set_up_tree_code(algo_->get(Parameters::TreeCodeTolerance).toDouble());
+  }
+
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // do the parallel work.
   Thread::parallel(this, &CalcFMField::calc_parallel, np_, mod);
@@ -36,12 +36,15 @@
 ///  The modules has four inputs: an electric field distribution (first) for mesh elements with defnied conductivity tensors (second), dipole sources (third)
 ///  within that mesh and detector locations (fourth) to compute the magnetic field at. All inputs are of Field datatype. The algorithm/module is multi-threaded and
 ///  outputs the magnetic vector potential and its magnitudes as first and second output.
+///  With UseTreeCode set, the sum over mesh elements and dipoles is approximated by a tree
+///  code to a relative accuracy of about TreeCodeTolerance.
 
 #ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_SIMULATEFORWARDMAGNETICFIELD_H
 #define CORE_ALGORITHMS_BRAINSTIMULATOR_SIMULATEFORWARDMAGNETICFIELD_H 1
 
 #include <Core/Datatypes/MatrixFwd.h>
 #include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Algorithms/BrainStimulator/TreeCode.h>
 #include <vector>
 #include <Core/Algorithms/BrainStimulator/share.h>
 
@@ -53,6 +56,7 @@ namespace SCIRun {
 class SCISHARE SimulateForwardMagneticFieldAlgo : public AlgorithmBase
 {
   public:
+    SimulateForwardMagneticFieldAlgo();
 
     static AlgorithmInputName ElectricField;
     static AlgorithmInputName ConductivityTensor;
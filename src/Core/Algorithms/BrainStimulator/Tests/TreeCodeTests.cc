@@ -0,0 +1,108 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Algorithms/BrainStimulator/TreeCode.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms::BrainStimulator;
+
+namespace
+{
+  struct DipoleField
+  {
+    Vector operator()(const Vector& x, const Vector& y, const Vector& c) const
+    {
+      const Vector r = x - y;
+      const double length = r.length();
+      return Cross(c, r) / (length * length * length);
+    }
+  };
+
+  void randomSources(size_t n, std::vector<Vector>& positions, std::vector<Vector>& strengths)
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    for (size_t i = 0; i < n; ++i)
+    {
+      positions.emplace_back(unit(gen), unit(gen), 0.2 * unit(gen));
+      strengths.emplace_back(unit(gen), unit(gen), unit(gen));
+    }
+  }
+
+  Vector directSum(const std::vector<Vector>& positions, const std::vector<Vector>& strengths,
+    const Vector& x, index_type exclude = -1)
+  {
+    Vector F(0, 0, 0);
+    for (size_t i = 0; i < positions.size(); ++i)
+      if (static_cast<index_type>(i) != exclude)
+        F += DipoleField()(x, positions[i], strengths[i]);
+    return F;
+  }
+}
+
+TEST(TreeCodeTests, MatchesDirectSumAwayFromSources)
+{
+  std::vector<Vector> positions, strengths;
+  randomSources(20000, positions, strengths);
+  TreeCode<DipoleField> tree(positions, strengths, DipoleField(), TreeCodeParameters(1e-6));
+  EXPECT_EQ(20000u, tree.numSources());
+
+  double error = 0, norm = 0;
+  for (int i = 0; i < 20; ++i)
+  {
+    const Vector x(-1.5 + 0.15 * i, 0.3, 0.5);
+    const auto diff = tree.evaluate(x) - directSum(positions, strengths, x);
+    error += diff.length2();
+    norm += directSum(positions, strengths, x).length2();
+  }
+  EXPECT_LT(std::sqrt(error / norm), 1e-4);
+}
+
+TEST(TreeCodeTests, LeavesOutExcludedSource)
+{
+  std::vector<Vector> positions, strengths;
+  randomSources(5000, positions, strengths);
+  TreeCode<DipoleField> tree(positions, strengths, DipoleField(), TreeCodeParameters(1e-6));
+
+  // a target on top of a source, which would be singular if it were not left out
+  const index_type exclude = 1234;
+  const Vector x = positions[exclude];
+  const auto expected = directSum(positions, strengths, x, exclude);
+  const auto F = tree.evaluate(x, exclude);
+  EXPECT_LT((F - expected).length(), 1e-3 * expected.length());
+}
+
+TEST(TreeCodeTests, HigherAccuracyRaisesTheDegree)
+{
+  EXPECT_LT(TreeCodeParameters(1e-3).degree, TreeCodeParameters(1e-8).degree);
+  EXPECT_LE(TreeCodeParameters(1e-20).degree, 12);
+}
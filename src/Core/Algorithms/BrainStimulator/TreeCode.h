@@ -0,0 +1,299 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_BRAINSTIMULATOR_TREECODE_H
+#define CORE_ALGORITHMS_BRAINSTIMULATOR_TREECODE_H
+
+#include <Core/Algorithms/Base/AlgorithmBase.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <vector>
+#include <Core/Algorithms/BrainStimulator/share.h>
+
+///@file TreeCode
+///@brief Barnes-Hut style tree code for fields of many point sources.
+///
+///@details
+///  Sums F(x) = sum_j K(x, y_j, c_j) over sources at y_j with vector strengths c_j, for any
+///  kernel K that is linear in c_j and smooth away from y_j. The sources are sorted into a
+///  binary tree; a cluster that is far from x compared to its size (radius < theta * distance)
+///  is replaced by its values at (degree+1)^3 Chebyshev points of its bounding box, with
+///  strengths found by barycentric Lagrange interpolation (Wang, Tlupova & Krasny 2020).
+///  Since the kernel is only ever evaluated pointwise, the same code serves the B and A field
+///  kernels of coils, dipoles and current densities. The cost per target drops from N to
+///  O(degree^3 log N), and the error falls geometrically with the degree.
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace BrainStimulator {
+
+  ALGORITHM_PARAMETER_DECL(UseTreeCode);
+  ALGORITHM_PARAMETER_DECL(TreeCodeTolerance);
+
+  struct SCISHARE TreeCodeParameters
+  {
+    /// picks the interpolation degree that reaches the requested relative accuracy
+    explicit TreeCodeParameters(double tolerance = 1e-6);
+
+    double theta;
+    int degree;
+  };
+
+  template <class Kernel>
+  class TreeCode
+  {
+  public:
+    TreeCode(const std::vector<Geometry::Vector>& positions, const std::vector<Geometry::Vector>& strengths,
+      const Kernel& kernel, const TreeCodeParameters& parameters);
+
+    /// Field at x. The source with index exclude is left out, for targets that lie inside a
+    /// source element.
+    Geometry::Vector evaluate(const Geometry::Vector& x, index_type exclude = -1) const;
+
+    size_t numSources() const { return positions_.size(); }
+
+  private:
+    struct Cluster
+    {
+      size_t begin, end;
+      Geometry::Vector center, halfWidth;
+      double radius;
+      int children[2];
+      /// offset of the proxy sources of clusters that are large enough to have them
+      size_t proxies;
+    };
+
+    static const size_t noProxies = static_cast<size_t>(-1);
+
+    int split(size_t begin, size_t end);
+    void computeProxies(const Cluster& cluster);
+
+    Kernel kernel_;
+    TreeCodeParameters parameters_;
+    size_t proxiesPerCluster_;
+    /// sources in tree order, and the tree position of every original source
+    std::vector<Geometry::Vector> positions_, strengths_;
+    std::vector<size_t> order_, rank_;
+    std::vector<Cluster> clusters_;
+    std::vector<Geometry::Vector> proxyPositions_, proxyStrengths_;
+  };
+
+  template <class Kernel>
+  TreeCode<Kernel>::TreeCode(const std::vector<Geometry::Vector>& positions, const std::vector<Geometry::Vector>& strengths,
+    const Kernel& kernel, const TreeCodeParameters& parameters) :
+    kernel_(kernel), parameters_(parameters),
+    proxiesPerCluster_((parameters.degree + 1) * (parameters.degree + 1) * (parameters.degree + 1))
+  {
+    positions_ = positions;
+    order_.resize(positions.size());
+    std::iota(order_.begin(), order_.end(), 0);
+    if (!positions.empty())
+      split(0, positions.size());
+
+    // sources in tree order, so that every cluster is a contiguous range
+    strengths_.resize(order_.size());
+    rank_.resize(order_.size());
+    for (size_t i = 0; i < order_.size(); ++i)
+    {
+      positions_[i] = positions[order_[i]];
+      strengths_[i] = strengths[order_[i]];
+      rank_[order_[i]] = i;
+    }
+
+    size_t numProxies = 0;
+    for (auto& cluster : clusters_)
+    {
+      if (cluster.proxies != noProxies)
+      {
+        cluster.proxies = numProxies;
+        numProxies += proxiesPerCluster_;
+      }
+    }
+    proxyPositions_.resize(numProxies);
+    proxyStrengths_.resize(numProxies);
+
+    Core::Thread::Parallel::For(0, clusters_.size(), [this](size_t begin, size_t end)
+    {
+      for (auto c = begin; c < end; ++c)
+        if (clusters_[c].proxies != noProxies)
+          computeProxies(clusters_[c]);
+    }, 1);
+  }
+
+  template <class Kernel>
+  int TreeCode<Kernel>::split(size_t begin, size_t end)
+  {
+    Geometry::Vector lo = positions_[order_[begin]], hi = lo;
+    for (auto i = begin; i < end; ++i)
+    {
+      lo = Min(lo, positions_[order_[i]]);
+      hi = Max(hi, positions_[order_[i]]);
+    }
+
+    Cluster cluster;
+    cluster.begin = begin;
+    cluster.end = end;
+    cluster.center = (lo + hi) * 0.5;
+    cluster.halfWidth = (hi - lo) * 0.5;
+    cluster.radius = cluster.halfWidth.length();
+    cluster.children[0] = cluster.children[1] = -1;
+    // Smaller clusters are cheaper to sum directly than through their proxies.
+    cluster.proxies = end - begin > proxiesPerCluster_ ? 0 : noProxies;
+
+    const auto id = static_cast<int>(clusters_.size());
+    clusters_.push_back(cluster);
+    if (end - begin > proxiesPerCluster_)
+    {
+      int axis = 0;
+      if (cluster.halfWidth[1] > cluster.halfWidth[axis]) axis = 1;
+      if (cluster.halfWidth[2] > cluster.halfWidth[axis]) axis = 2;
+      const auto middle = begin + (end - begin) / 2;
+      std::nth_element(order_.begin() + begin, order_.begin() + middle, order_.begin() + end,
+        [this, axis](size_t a, size_t b) { return positions_[a][axis] < positions_[b][axis]; });
+      const int left = split(begin, middle);
+      const int right = split(middle, end);
+      clusters_[id].children[0] = left;
+      clusters_[id].children[1] = right;
+    }
+    return id;
+  }
+
+  template <class Kernel>
+  void TreeCode<Kernel>::computeProxies(const Cluster& cluster)
+  {
+    const int n = parameters_.degree;
+    std::vector<double> nodes[3], weights(n + 1), basis[3];
+    for (int k = 0; k <= n; ++k)
+      weights[k] = (k % 2 ? -1.0 : 1.0) * (k == 0 || k == n ? 0.5 : 1.0);
+    for (int d = 0; d < 3; ++d)
+    {
+      // flat clusters (a planar coil) still need distinct nodes in every direction
+      const double h = std::max({ cluster.halfWidth[d], 1e-6 * cluster.radius, 1e-12 });
+      nodes[d].resize(n + 1);
+      basis[d].resize(n + 1);
+      for (int k = 0; k <= n; ++k)
+        nodes[d][k] = cluster.center[d] + h * std::cos(M_PI * k / n);
+    }
+
+    Geometry::Vector* proxy = &proxyPositions_[cluster.proxies];
+    for (int i = 0; i <= n; ++i)
+      for (int j = 0; j <= n; ++j)
+        for (int k = 0; k <= n; ++k)
+          *proxy++ = Geometry::Vector(nodes[0][i], nodes[1][j], nodes[2][k]);
+
+    Geometry::Vector* strength = &proxyStrengths_[cluster.proxies];
+    for (auto s = cluster.begin; s < cluster.end; ++s)
+    {
+      const auto& y = positions_[s];
+      for (int d = 0; d < 3; ++d)
+      {
+        // barycentric form of the Lagrange polynomials, exact when y hits a node
+        int hit = -1;
+        double sum = 0;
+        for (int k = 0; k <= n; ++k)
+        {
+          const double diff = y[d] - nodes[d][k];
+          if (diff == 0.0)
+          {
+            hit = k;
+            break;
+          }
+          basis[d][k] = weights[k] / diff;
+          sum += basis[d][k];
+        }
+        if (hit >= 0)
+        {
+          std::fill(basis[d].begin(), basis[d].end(), 0.0);
+          basis[d][hit] = 1.0;
+        }
+        else
+        {
+          for (int k = 0; k <= n; ++k)
+            basis[d][k] /= sum;
+        }
+      }
+
+      const auto& c = strengths_[s];
+      auto* q = strength;
+      for (int i = 0; i <= n; ++i)
+        for (int j = 0; j <= n; ++j)
+        {
+          const double lij = basis[0][i] * basis[1][j];
+          for (int k = 0; k <= n; ++k)
+            *q++ += c * (lij * basis[2][k]);
+        }
+    }
+  }
+
+  template <class Kernel>
+  Geometry::Vector TreeCode<Kernel>::evaluate(const Geometry::Vector& x, index_type exclude) const
+  {
+    Geometry::Vector F(0, 0, 0);
+    if (clusters_.empty())
+      return F;
+
+    const size_t skip = exclude >= 0 ? rank_[exclude] : positions_.size();
+    // median splits keep the depth near log2(N), so a small fixed stack suffices
+    int stack[256];
+    int top = 0;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+      const auto& cluster = clusters_[stack[--top]];
+      const bool containsSkipped = skip >= cluster.begin && skip < cluster.end;
+      if (cluster.proxies != noProxies && !containsSkipped &&
+          cluster.radius < parameters_.theta * (x - cluster.center).length())
+      {
+        for (auto p = cluster.proxies; p < cluster.proxies + proxiesPerCluster_; ++p)
+          F += kernel_(x, proxyPositions_[p], proxyStrengths_[p]);
+      }
+      else if (cluster.children[0] < 0)
+      {
+        for (auto s = cluster.begin; s < cluster.end; ++s)
+          if (s != skip)
+            F += kernel_(x, positions_[s], strengths_[s]);
+      }
+      else
+      {
+        stack[top++] = cluster.children[1];
+        stack[top++] = cluster.children[0];
+      }
+    }
+    return F;
+  }
+
+}}}}
+
+#endif
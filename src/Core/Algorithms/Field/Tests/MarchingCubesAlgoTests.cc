@@ -0,0 +1,122 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::TestUtils;
+
+namespace
+{
+  FieldHandle sphereDistanceLatVol()
+  {
+    auto field = CreateEmptyLatVol(16, 16, 16);
+    auto mesh = field->vmesh();
+    auto vfield = field->vfield();
+    Point p;
+    for (VMesh::Node::index_type n = 0; n < mesh->num_nodes(); ++n)
+    {
+      mesh->get_point(p, n);
+      vfield->set_value(Vector(p).length(), n);
+    }
+    return field;
+  }
+
+  struct IsoResult
+  {
+    FieldHandle field;
+    MatrixHandle nodeInterpolant, elemInterpolant;
+  };
+
+  IsoResult extract(FieldHandle input, int numThreads)
+  {
+    MarchingCubesAlgo algo;
+    algo.set(Parameters::build_field, true);
+    algo.set(Parameters::build_node_interpolant, true);
+    algo.set(Parameters::build_elem_interpolant, true);
+    algo.set(Parameters::num_threads, numThreads);
+
+    IsoResult result;
+    std::vector<double> isovalues { 0.5, 0.8 };
+    EXPECT_TRUE(algo.run(input, isovalues, result.field, result.nodeInterpolant, result.elemInterpolant));
+    return result;
+  }
+}
+
+TEST(MarchingCubesAlgoTests, ThreadedExtractionMatchesSerialTopology)
+{
+  auto input = sphereDistanceLatVol();
+
+  // An explicit thread count is honoured up to four times the core count,
+  // so the second run is split four ways even on a single core machine.
+  auto serial = extract(input, 1);
+  auto threaded = extract(input, 4);
+
+  ASSERT_TRUE(serial.field != nullptr);
+  ASSERT_TRUE(threaded.field != nullptr);
+  EXPECT_GT(serial.field->vmesh()->num_elems(), 0);
+  EXPECT_EQ(serial.field->vmesh()->num_nodes(), threaded.field->vmesh()->num_nodes());
+  EXPECT_EQ(serial.field->vmesh()->num_elems(), threaded.field->vmesh()->num_elems());
+  EXPECT_EQ(serial.field->vfield()->num_values(), threaded.field->vfield()->num_values());
+}
+
+TEST(MarchingCubesAlgoTests, InterpolantsMatchOutputSize)
+{
+  auto input = sphereDistanceLatVol();
+  auto result = extract(input, 4);
+
+  ASSERT_TRUE(result.nodeInterpolant != nullptr);
+  ASSERT_TRUE(result.elemInterpolant != nullptr);
+  EXPECT_EQ(result.field->vmesh()->num_nodes(), result.nodeInterpolant->nrows());
+  EXPECT_EQ(input->vmesh()->num_nodes(), result.nodeInterpolant->ncols());
+  EXPECT_EQ(result.field->vmesh()->num_elems(), result.elemInterpolant->nrows());
+  EXPECT_EQ(input->vmesh()->num_elems(), result.elemInterpolant->ncols());
+
+  // Each welded vertex interpolates the two ends of the edge it was cut from.
+  auto interp = castMatrix::toSparse(result.nodeInterpolant);
+  ASSERT_TRUE(interp != nullptr);
+  for (size_t r = 0; r < interp->nrows(); ++r)
+  {
+    double sum = 0;
+    for (SparseRowMatrix::InnerIterator it(*interp, r); it; ++it)
+      sum += it.value();
+    EXPECT_NEAR(1.0, sum, 1e-12);
+  }
+}
@@ -421,3 +421,90 @@ TEST(SplitByConnectedRegionTest, DISABLED_SplitFieldByConnectedRegionAlgoTriTest
   EXPECT_EQ(result8->vmesh()->num_nodes(), 895);
 
 }
+
+namespace
+{
+  // Three unit squares of two triangles each, far apart, with the elements
+  // of the squares interleaved: square 0 gets elements 0 and 3, square 1
+  // elements 1 and 5, square 2 elements 2 and 4.
+  FieldHandle interleavedSquares(data_info_type type)
+  {
+    FieldInformation fi(mesh_info_type::TRISURFMESH_E, databasis_info_type::CONSTANTDATA_E, type);
+    FieldHandle field = CreateField(fi);
+    auto mesh = field->vmesh();
+    for (int s = 0; s < 3; ++s)
+    {
+      mesh->add_point(Point(10 * s, 0, 0));
+      mesh->add_point(Point(10 * s + 1, 0, 0));
+      mesh->add_point(Point(10 * s + 1, 1, 0));
+      mesh->add_point(Point(10 * s, 1, 0));
+    }
+    const int squares[6] = { 0, 1, 2, 0, 2, 1 };
+    const int halves[6] = { 0, 0, 0, 1, 1, 1 };
+    for (int e = 0; e < 6; ++e)
+    {
+      const int b = 4 * squares[e];
+      VMesh::Node::array_type nodes(3);
+      nodes[0] = VMesh::Node::index_type(b);
+      nodes[1] = VMesh::Node::index_type(b + (halves[e] == 0 ? 1 : 2));
+      nodes[2] = VMesh::Node::index_type(b + (halves[e] == 0 ? 2 : 3));
+      mesh->add_elem(nodes);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+}
+
+TEST(SplitByConnectedRegionTest, SplitsInterleavedRegionsInOrderOfFirstElement)
+{
+  auto field = interleavedSquares(data_info_type::DOUBLE_E);
+  for (VMesh::index_type e = 0; e < 6; ++e)
+    field->vfield()->set_value(static_cast<double>(e), e);
+
+  SplitFieldByConnectedRegionAlgo algo;
+  algo.set(Parameters::SortDomainBySize, false);
+  algo.set(Parameters::SortAscending, false);
+  auto result = algo.run(field);
+
+  ASSERT_EQ(3, result.size());
+  const double expected[3][2] = { { 0, 3 }, { 1, 5 }, { 2, 4 } };
+  for (int r = 0; r < 3; ++r)
+  {
+    EXPECT_EQ(4, result[r]->vmesh()->num_nodes());
+    ASSERT_EQ(2, result[r]->vmesh()->num_elems());
+    for (VMesh::index_type e = 0; e < 2; ++e)
+    {
+      double value;
+      result[r]->vfield()->get_value(value, e);
+      EXPECT_EQ(expected[r][e], value);
+    }
+    BBox box = result[r]->vmesh()->get_bounding_box();
+    EXPECT_EQ(Point(10 * r, 0, 0), box.get_min());
+  }
+}
+
+TEST(SplitByConnectedRegionTest, SplitFieldByDomainGroupsElementsByLabel)
+{
+  auto field = interleavedSquares(data_info_type::INT_E);
+  // labels cut across the connected regions
+  const int labels[6] = { 7, -2, 7, 3, -2, 7 };
+  for (VMesh::index_type e = 0; e < 6; ++e)
+    field->vfield()->set_value(labels[e], e);
+
+  SplitFieldByDomainAlgo algo;
+  FieldList result;
+  ASSERT_TRUE(algo.runImpl(field, result));
+
+  ASSERT_EQ(3, result.size());
+  const int expectedLabels[3] = { -2, 3, 7 };
+  const int expectedElems[3] = { 2, 1, 3 };
+  const int expectedNodes[3] = { 6, 3, 9 };
+  for (int r = 0; r < 3; ++r)
+  {
+    EXPECT_EQ(expectedElems[r], result[r]->vmesh()->num_elems());
+    EXPECT_EQ(expectedNodes[r], result[r]->vmesh()->num_nodes());
+    int value;
+    result[r]->vfield()->get_value(value, 0);
+    EXPECT_EQ(expectedLabels[r], value);
+  }
+}
@@ -214,3 +214,62 @@ TEST(BuildFEMatrixAlgorithmTests, DISABLED_TestMeshSize1e6)
 
   EXPECT_TRUE(compare_with_tolerance(*expectedOutput("1e6.mat"), *output));
 }
+
+namespace
+{
+  FieldHandle constantLatVol(size_type size, double conductivity)
+  {
+    FieldInformation lfi(mesh_info_type::LATVOLMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::DOUBLE_E);
+    auto mesh = CreateMesh(lfi, size, size, size, Point(0, 0, 0), Point(1, 1, 1));
+    auto field = CreateField(lfi, mesh);
+    field->vfield()->set_all_values(conductivity);
+    return field;
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, LatVolStiffnessIsSymmetricWithZeroRowSums)
+{
+  auto field = constantLatVol(6, 1.0);
+
+  BuildFEMatrixAlgo algo;
+  auto output = algo.run(withInputData((Variables::InputField, field))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(output, NotNull());
+
+  EXPECT_EQ(216, output->nrows());
+  // 27-point stencil of the interior nodes, clipped at the boundary
+  EXPECT_EQ(16 * 16 * 16, output->nonZeros());
+
+  SparseRowMatrix transpose = output->transpose();
+  EXPECT_TRUE(transpose.isApprox(*output));
+  for (size_t i = 0; i < output->nrows(); ++i)
+  {
+    double sum = 0;
+    for (SparseRowMatrix::InnerIterator it(*output, i); it; ++it)
+      sum += it.value();
+    EXPECT_NEAR(0.0, sum, 1e-12);
+    EXPECT_GT(output->coeff(i, i), 0.0);
+  }
+}
+
+TEST(BuildFEMatrixAlgorithmTests, RerunOnSameMeshReusesStructure)
+{
+  auto field = constantLatVol(5, 1.0);
+
+  BuildFEMatrixAlgo algo;
+  auto first = algo.run(withInputData((Variables::InputField, field))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(first, NotNull());
+
+  field->vfield()->set_all_values(2.5);
+  auto second = algo.run(withInputData((Variables::InputField, field))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(second, NotNull());
+
+  ASSERT_EQ(first->nonZeros(), second->nonZeros());
+  SparseRowMatrix scaled = 2.5 * *first;
+  EXPECT_TRUE(scaled.isApprox(*second));
+
+  // A different mesh must not pick up the cached structure
+  auto other = algo.run(withInputData((Variables::InputField, constantLatVol(4, 1.0)))).get<SparseRowMatrix>(BuildFEMatrixAlgo::Stiffness_Matrix);
+  ASSERT_THAT(other, NotNull());
+  EXPECT_EQ(64, other->nrows());
+  EXPECT_EQ(10 * 10 * 10, other->nonZeros());
+}
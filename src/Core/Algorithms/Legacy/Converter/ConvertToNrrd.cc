@@ -260,8 +260,20 @@ ConvertToNrrdAlgo::runImpl(FieldHandle input, NrrdDataHandle& points,
     {
       size_t size[NRRD_DIM_MAX];
       unsigned int centers[NRRD_DIM_MAX];
-      for (size_t j=0;j<dataDims.size(); j++) size[j] = dataDims[j];
-      nrrdAlloc_nva(data->getNrrd(), nrrdtype, dataDims.size(), size);
+      size_t num_nrrd_values = 1;
+      for (size_t j=0;j<dataDims.size(); j++)
+      {
+        size[j] = dataDims[j];
+        num_nrrd_values *= size[j];
+      }
+
+      // Regular 3D fields keep their values in a shareable buffer, which the
+      // nrrd can then use directly instead of a copy
+      VField::size_type num_values = field->num_values();
+      const bool shared = (num_nrrd_values == static_cast<size_t>(num_values)) &&
+        data->wrap(field->share_values_buffer(), nrrdtype, dataDims.size(), size);
+      if (!shared)
+        nrrdAlloc_nva(data->getNrrd(), nrrdtype, dataDims.size(), size);
 
       if (field->basis_order() == 1)
       {
@@ -306,27 +318,29 @@ ConvertToNrrdAlgo::runImpl(FieldHandle input, NrrdDataHandle& points,
 
       for (size_t j=0;j<dataDims.size(); j++) data->getNrrd()->axis[j].kind = nrrdKindDomain;
 
-      VField::size_type num_values = field->num_values();
-      if (field->is_char())
-        field->get_values(reinterpret_cast<char*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_char())
-        field->get_values(reinterpret_cast<unsigned char*>(data->getNrrd()->data),num_values);
-      if (field->is_short())
-        field->get_values(reinterpret_cast<short*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_short())
-        field->get_values(reinterpret_cast<unsigned short*>(data->getNrrd()->data),num_values);
-      if (field->is_int())
-        field->get_values(reinterpret_cast<int*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_int())
-        field->get_values(reinterpret_cast<unsigned int*>(data->getNrrd()->data),num_values);
-      if (field->is_longlong())
-        field->get_values(reinterpret_cast<long long*>(data->getNrrd()->data),num_values);
-      if (field->is_unsigned_longlong())
-        field->get_values(reinterpret_cast<unsigned long long*>(data->getNrrd()->data),num_values);
-      if (field->is_float())
-        field->get_values(reinterpret_cast<float*>(data->getNrrd()->data),num_values);
-      if (field->is_double())
-        field->get_values(reinterpret_cast<double*>(data->getNrrd()->data),num_values);
+      if (!shared)
+      {
+        if (field->is_char())
+          field->get_values(reinterpret_cast<char*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_char())
+          field->get_values(reinterpret_cast<unsigned char*>(data->getNrrd()->data),num_values);
+        if (field->is_short())
+          field->get_values(reinterpret_cast<short*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_short())
+          field->get_values(reinterpret_cast<unsigned short*>(data->getNrrd()->data),num_values);
+        if (field->is_int())
+          field->get_values(reinterpret_cast<int*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_int())
+          field->get_values(reinterpret_cast<unsigned int*>(data->getNrrd()->data),num_values);
+        if (field->is_longlong())
+          field->get_values(reinterpret_cast<long long*>(data->getNrrd()->data),num_values);
+        if (field->is_unsigned_longlong())
+          field->get_values(reinterpret_cast<unsigned long long*>(data->getNrrd()->data),num_values);
+        if (field->is_float())
+          field->get_values(reinterpret_cast<float*>(data->getNrrd()->data),num_values);
+        if (field->is_double())
+          field->get_values(reinterpret_cast<double*>(data->getNrrd()->data),num_values);
+      }
     }
     else
     {
@@ -90,15 +90,20 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
     dim[2] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
-
-    if (nrrd->data == nullptr)
+    // LatVol values live in a shareable buffer: hand that to the nrrd
+    // instead of copying the volume
+    if (!output->wrap(field->share_values_buffer(),datatype,nrrddim,dim))
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
-      return (false);
-    }
+      nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_nodes());
+      if (nrrd->data == nullptr)
+      {
+        pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+        return (false);
+      }
+
+      field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_nodes());
+    }
 
     nrrdcenter = nrrdCenterNode;
     tf = mesh->get_transform();
@@ -117,15 +122,18 @@ bool FieldToNrrdAlgoT::scalarFieldToNrrd(LoggerHandle pr,FieldHandle input, Nrrd
     dim[0] = static_cast<size_t>(sz[0]);
     dim[1] = static_cast<size_t>(sz[1]);
     dim[2] = static_cast<size_t>(sz[2]);
-    nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
-
-    if (nrrd->data == nullptr)
+    if (!output->wrap(field->share_values_buffer(),datatype,nrrddim,dim))
     {
-      pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
-      return (false);
-    }
+      nrrdAlloc_nva(nrrd,datatype,nrrddim,dim);
 
-    field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_elems());
+      if (nrrd->data == nullptr)
+      {
+        pr->error("FieldToNrrd: Could not allocate enough space for new Nrrd");
+        return (false);
+      }
+
+      field->get_values(reinterpret_cast<T*>(nrrd->data),mesh->num_elems());
+    }
 
     nrrdcenter = nrrdCenterCell;
     tf = mesh->get_transform();
@@ -326,8 +326,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
 
   if (rdim == 1)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(mesh_info_type::SCANLINEMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
@@ -339,16 +337,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      vfield->set_values(dataptr,vfield->num_values());
 
       if (use_tf)
       {
@@ -368,15 +357,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      vfield->set_values(dataptr,vfield->num_values());
       if (use_tf)
       {
         Transform trans = vmesh->get_transform();
@@ -392,8 +373,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
   }
   else if (rdim == 2)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(mesh_info_type::IMAGEMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
@@ -405,16 +384,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      vfield->set_values(dataptr,vfield->num_values());
 
       if (use_tf)
       {
@@ -434,15 +404,7 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      vfield->set_values(dataptr,vfield->num_values());
       if (use_tf)
       {
         Transform trans = vmesh->get_transform();
@@ -458,8 +420,6 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
   }
   else if (rdim == 3)
   {
-    int k = 0;
-
     if (datalocation == "Node")
     {
       FieldInformation fi(mesh_info_type::LATVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
@@ -471,16 +431,10 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Node::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      // The field takes over the nrrd buffer, which stays alive as long as the
+      // field refers to it. Changing the field values gives it its own copy.
+      if (!vfield->adopt_values_buffer(std::shared_ptr<T>(input,dataptr)))
+        vfield->set_values(dataptr,vfield->num_values());
 
       if (use_tf)
       {
@@ -500,15 +454,8 @@ bool NrrdToFieldAlgoT::nrrdToField(LoggerHandle pr,NrrdDataHandle input, FieldHa
       VMesh*  vmesh = output->vmesh();
       VField* vfield = output->vfield();
 
-      VMesh::Elem::iterator it, it_end;
-      vmesh->begin(it);
-      vmesh->end(it_end);
-      while (it != it_end)
-      {
-        vfield->set_value(dataptr[k],*it);
-        ++it;
-        k++;
-      }
+      if (!vfield->adopt_values_buffer(std::shared_ptr<T>(input,dataptr)))
+        vfield->set_values(dataptr,vfield->num_values());
 
       if (use_tf)
       {
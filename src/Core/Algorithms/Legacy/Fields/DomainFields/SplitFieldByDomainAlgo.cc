@@ -27,6 +27,7 @@
 
 
 #include <Core/Algorithms/Legacy/Fields/DomainFields/SplitFieldByDomainAlgo.h>
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/FieldRegions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -119,101 +120,25 @@ SplitFieldByDomainAlgo::runImpl(FieldHandle input, FieldList& output) const
     return (false);
   }
 
-  VMesh::Elem::iterator bei, eei;
-  VMesh::Node::iterator bni, eni;
-
-  VMesh::size_type num_elems = mesh->num_elems();
-  VMesh::size_type num_nodes = mesh->num_nodes();
-
-
-  std::vector<VMesh::Node::index_type> idxarray(num_nodes);
-  std::vector<bool> newidxarray(num_nodes);
-  VMesh::Node::array_type nodes;
-  VMesh::Node::array_type newnodes;
-  VMesh::Node::index_type node;
-
   std::vector<int> labels;
   field->get_values(labels);
 
-  int flabel = 0;
-  if (labels.size()) flabel = labels[0];
-  for (size_t j=0; j<labels.size();j++) { if (labels[j] < flabel) flabel = labels[j]; }
-
-  index_type k = 0;
-
-  int cnt = 0;
-  while (true)
+  // One pass over the elements instead of one per label
+  std::vector<int> regionLabels;
+  const ElementRegions regions = labeledRegions(labels, regionLabels);
+  FieldList fields = extractRegions(input, fo, regions, false);
+  if (fields.size() != regionLabels.size())
   {
-    FieldHandle output_field = CreateField(fo);
-
-    if (!output_field)
-    {
-      error("Could not create output field");
-      output.clear();
-      return(false);
-    }
-
-    VField* ofield = output_field->vfield();
-    VMesh *omesh = output_field->vmesh();
-
-    if (!ofield || !omesh)
-    {
-      error("Could not create output field");
-      output.clear();
-      return(false);
-    }
-
-    for (size_type p =0; p<num_nodes; p++) newidxarray[p] = true;
-
-    for (VMesh::Elem::index_type idx=0; idx< num_elems; idx++)
-    {
-      if (labels[idx] == flabel)
-      {
-        mesh->get_nodes(nodes,idx);
-        newnodes.resize(nodes.size());
-        for (size_t p=0; p< nodes.size(); p++)
-        {
-          node = nodes[p];
-          if (newidxarray[node])
-          {
-            Point pt;
-            mesh->get_center(pt,nodes[p]);
-            idxarray[node] = omesh->add_point(pt);
-            newidxarray[node] = false;
-          }
-          newnodes[p] = idxarray[node];
-        }
-        omesh->add_elem(newnodes);
-        cnt++;
-        if (cnt == 400)
-        {
-          cnt = 0;
-          update_progress_max(k,num_elems);
-        }
-        k++;
-      }
-    }
-
-    ofield->resize_values();
-    ofield->set_all_values(flabel);
-    output.push_back(output_field);
-
-    int elabel = 0;
-    bool found = false;
-
-    for (VMesh::index_type lidx = 0; lidx < num_elems; lidx++)
-    {
-      if (labels[lidx] > flabel)
-      {
-        if (!found) { elabel = labels[lidx]; found = true;}
-        if (labels[lidx] < elabel) elabel = labels[lidx];
-      }
-    }
-    // check whether we are done
-    if (!found) break;
-    flabel = elabel;
+    error("Could not create output field");
+    output.clear();
+    return(false);
   }
 
+  for (size_t j=0; j<fields.size(); j++)
+  {
+    fields[j]->vfield()->set_all_values(regionLabels[j]);
+  }
+  output.insert(output.end(), fields.begin(), fields.end());
 
   if (get(Parameters::SortBySize).toBool())
   {
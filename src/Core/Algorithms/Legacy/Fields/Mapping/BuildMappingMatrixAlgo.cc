@@ -38,6 +38,7 @@
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/SparseRowMatrixFromMap.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <limits>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Datatypes;
@@ -362,11 +363,39 @@ namespace detail
     explicit BuildMappingMatrixInterpolatedDataPAlgo(int nproc) :
         BuildMappingMatrixPAlgoBase("BuildMappingMatrixInterpolatedDataPAlgo Barrier", nproc), e_(0) {}
 
+        void locate();
         void parallel(int proc);
 
         size_type e_;
+
+  private:
+    // Source element, local coordinates and distance for every destination value
+    std::vector<VMesh::Elem::index_type> elems_;
+    std::vector<VMesh::coords_type> coords_;
+    std::vector<double> dists_;
   };
 
+  void BuildMappingMatrixInterpolatedDataPAlgo::locate()
+  {
+    // All destination locations are looked up in one batch, which sorts them
+    // spatially and searches a hierarchy over the source elements
+    const VField::size_type num_values = dfield_->num_values();
+    std::vector<Point> points(num_values);
+    const bool at_elems = dfield_->basis_order() == 0;
+    Parallel::For(0, num_values, [&](size_t begin, size_t end)
+    {
+      for (size_t j = begin; j < end; ++j)
+      {
+        if (at_elems) dmesh_->get_center(points[j], VMesh::Elem::index_type(j));
+        else dmesh_->get_center(points[j], VMesh::Node::index_type(j));
+      }
+    });
+
+    std::vector<Point> results;
+    const double maxdist = maxdist_ < 0.0 ? std::numeric_limits<double>::max() : maxdist_;
+    smesh_->mfind_closest_elem(dists_, results, coords_, elems_, points, maxdist);
+  }
+
   void BuildMappingMatrixInterpolatedDataPAlgo::parallel(int proc)
   {
     // Determine which ones to run
@@ -379,122 +408,36 @@ namespace detail
     barrier_.wait();
 
     int cnt = 0;
+    VMesh::ElemInterpolate interp;
 
-    if (dfield_->basis_order() == 0 && sfield_->basis_order() == 0)
+    for (VMesh::index_type idx=start; idx<end;idx++)
     {
-      Point p, r;
-      VMesh::Elem::index_type didx;
+      const VMesh::Elem::index_type didx = elems_[idx];
+      const bool found = didx >= 0 && (maxdist_ < 0.0 || dists_[idx] < maxdist_);
 
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      if (sfield_->basis_order() == 0)
       {
-        dmesh_->get_center(p,idx);
-
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
-          {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
+        cc_[idx] = found ? static_cast<index_type>(didx) : -1;
+        vv_[idx] = 1.0;
       }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 0)
-    {
-      Point p, r;
-      VMesh::Elem::index_type didx;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
+      else if (found)
       {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,didx,p))
+        smesh_->get_interpolate_weights(coords_[idx],didx,interp,1);
+        for (index_type j=0;j<e_;j++)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            cc_[idx] = didx;
-            vv_[idx] = 1.0;
-          }
-          else
-          {
-            cc_[idx] = -1;
-            vv_[idx] = 1.0;
-          }
+          cc_[idx*e_+j] = interp.node_index[j];
+          vv_[idx*e_+j] = interp.weights[j];
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
       }
-    }
-    else if (dfield_->basis_order() == 0 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      VMesh::ElemInterpolate interp;
-      for (VMesh::Elem::index_type idx=start; idx<end;idx++)
+      else
       {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
+        for (index_type j=0;j<e_;j++)
         {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
-          {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
-          }
+          cc_[idx*e_+j] = -1;
+          vv_[idx*e_+j] = 0.0;
         }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
-    else if (dfield_->basis_order() == 1 && sfield_->basis_order() == 1)
-    {
-      Point p, r;
-      VMesh::coords_type coords;
-      VMesh::Elem::index_type didx;
-      VMesh::ElemInterpolate interp;
-      for (VMesh::Node::index_type idx=start; idx<end;idx++)
-      {
-        dmesh_->get_center(p,idx);
-        double dist;
-        if(smesh_->find_closest_elem(dist,r,coords,didx,p))
-        {
-          if (maxdist_ < 0.0 || dist < maxdist_)
-          {
-            smesh_->get_interpolate_weights(coords,didx,interp,1);
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = interp.node_index[j];
-              vv_[idx*e_+j] = interp.weights[j];
-            }
-          }
-          else
-          {
-            for (index_type j=0;j<e_;j++)
-            {
-              cc_[idx*e_+j] = -1;
-              vv_[idx*e_+j] = 0.0;
-            }
-          }
-        }
-        if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
       }
+      if (proc == 0) { cnt++; if (cnt == 200) {cnt = 0; algo_->update_progress_max(idx,end); } }
     }
 
     barrier_.wait();
@@ -664,6 +607,7 @@ bool BuildMappingMatrixAlgo::runImpl(FieldHandle source, FieldHandle destination
     algo.e_ = e;
     algo.maxdist_ = maxdist;
     algo.algo_ = this;
+    algo.locate();
 
     auto task_i = [&algo](int i) { algo.parallel(i); };
     Parallel::RunTasks(task_i, np);
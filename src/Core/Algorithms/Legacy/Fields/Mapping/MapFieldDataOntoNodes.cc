@@ -34,6 +34,7 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/GeometryPrimitives/Vector.h>
+#include <Core/GeometryPrimitives/Tensor.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -116,61 +117,127 @@ MapFieldDataOntoNodesPAlgo::parallel(int proc)
   VField::index_type      end = localsize*(proc+1);
   if (proc == nproc-1) end = num_nodes;
 
-  int cnt = 0;
+  // Nodes are passed to the data source in blocks, so that it can search for
+  // the ones that need a closest element all at once
+  const VField::size_type block = 16384;
+  std::vector<Point> points;
+
+  auto mapBlocks = [&](auto zero, auto setValues)
+  {
+    std::vector<decltype(zero)> values;
+    for (VField::index_type first=start; first<end; first+=block)
+    {
+      const VField::index_type last = std::min(end, first+block);
+      points.resize(last-first);
+      for (VMesh::Node::index_type idx=first; idx<last; idx++)
+        omesh->get_center(points[idx-first],idx);
+      datasource->get_data(values,points);
+      setValues(first,values);
+      if (proc == 0) algo_->update_progress_max(last,end);
+    }
+  };
+
   if (is_flux_)
   {
     // To compute flux through a surface
-    Point p; Vector val; Vector norm;
-    for (VMesh::Node::index_type idx=start; idx<end; idx++)
+    mapBlocks(Vector(), [&](VField::index_type first, const std::vector<Vector>& values)
     {
-      omesh->get_center(p,idx);
-      omesh->get_normal(norm,idx);
-      datasource->get_data(val,p);
-      ofield->set_value(Dot(val,norm),idx);
-      if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-    }
+      Vector norm;
+      for (size_t j=0; j<values.size(); j++)
+      {
+        const VMesh::Node::index_type idx(first+j);
+        omesh->get_normal(norm,idx);
+        ofield->set_value(Dot(values[j],norm),idx);
+      }
+    });
   }
   else
   {
     // To map value, gradient, or gradientnorm
-    if (datasource->is_scalar())
+    auto setValues = [&](VField::index_type first, const auto& values)
     {
-      Point p; double val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      for (size_t j=0; j<values.size(); j++)
+        ofield->set_value(values[j],VMesh::Node::index_type(first+j));
+    };
+
+    if (datasource->is_scalar())
+      mapBlocks(double(), setValues);
     else if (datasource->is_vector())
-    {
-      Point p; Vector val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      mapBlocks(Vector(), setValues);
     else
-    {
-      Point p; Tensor val;
-      for (VMesh::Node::index_type idx=start; idx<end; idx++)
-      {
-        omesh->get_center(p,idx);
-        datasource->get_data(val,p);
-        ofield->set_value(val,idx);
-        if (proc == 0) { cnt++; if (cnt == 400) {cnt = 0; algo_->update_progress_max(idx,end); } }
-      }
-    }
+      mapBlocks(Tensor(), setValues);
   }
   // Wait until all of the threads are done
   success_[proc] = true;
   barrier_.wait();
 }
+
+/// Value mapping with interpolateddata or closestinterpolateddata without
+/// weights: locates all destination nodes in one batch and interpolates
+/// the source at the returned elements and local coordinates.
+template <class T>
+void
+mapLocatedValues(VField* sfield, VField* ofield,
+  const std::vector<VMesh::Elem::index_type>& elems,
+  const std::vector<VMesh::coords_type>& coords, const T& outside)
+{
+  Parallel::For(0, elems.size(), [&](size_t begin, size_t end)
+  {
+    T val;
+    for (size_t j = begin; j < end; ++j)
+    {
+      if (elems[j] >= 0)
+        sfield->interpolate(val, coords[j], elems[j]);
+      else
+        val = outside;
+      ofield->set_value(val, VMesh::Node::index_type(static_cast<index_type>(j)));
+    }
+  });
+}
+
+bool
+mapInterpolatedValues(FieldHandle source, FieldHandle output, bool closest,
+  double def_value, double maxdist)
+{
+  VMesh* smesh = source->vmesh();
+  VField* sfield = source->vfield();
+  VMesh* omesh = output->vmesh();
+  VField* ofield = output->vfield();
+
+  std::vector<Point> points(omesh->num_nodes());
+  Parallel::For(0, points.size(), [&](size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+      omesh->get_center(points[j], VMesh::Node::index_type(static_cast<index_type>(j)));
+  });
+
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  if (closest)
+  {
+    smesh->synchronize(Mesh::ELEM_LOCATE_E|Mesh::FIND_CLOSEST_ELEM_E);
+    std::vector<double> dists;
+    std::vector<Point> results;
+    smesh->mfind_closest_elem(dists, results, coords, elems, points, maxdist);
+  }
+  else
+  {
+    smesh->synchronize(Mesh::ELEM_LOCATE_E);
+    smesh->mlocate(elems, coords, points);
+  }
+
+  if (sfield->is_scalar())
+    mapLocatedValues(sfield, ofield, elems, coords, def_value);
+  else if (sfield->is_vector())
+    mapLocatedValues(sfield, ofield, elems, coords,
+      closest ? Vector(0.0, 0.0, 0.0) : Vector(def_value, def_value, def_value));
+  else if (sfield->is_tensor())
+    mapLocatedValues(sfield, ofield, elems, coords, Tensor(def_value));
+  else
+    return (false);
+
+  return (true);
+}
 }
 
 bool
@@ -313,6 +380,20 @@ MapFieldDataOntoNodesAlgo::runImpl(FieldHandle source, FieldHandle weights,
     return (false);
   }
 
+  // Plain value mapping is done with one batched locate of all the nodes
+  if (quantity == "value" && !weights && !fi.is_pointcloud() &&
+      source->vmesh()->num_elems() > 0 &&
+      (mappingModel == "interpolateddata" || mappingModel == "closestinterpolateddata"))
+  {
+    if (detail::mapInterpolatedValues(source, output,
+      mappingModel == "closestinterpolateddata",
+      get(Parameters::OutsideValue).toDouble(), get(Parameters::MaxDistance).toDouble()))
+    {
+      CopyProperties(*destination, *output);
+      return (true);
+    }
+  }
+
   // Number of threads is equal to the number of cores
   int np = Parallel::NumCores();
   // Run algorithm in parallel
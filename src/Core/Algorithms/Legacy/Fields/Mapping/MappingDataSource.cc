@@ -535,6 +535,106 @@ class InterpolatedWeightedTensorGradientNormSource : public MappingDataSource {
 };
 
 
+// ClosestInterpolatedData: points that cannot be interpolated take the value of
+// the closest element within the maximum distance
+
+namespace
+{
+  /// Collects the points that interpolation could not place and looks up their
+  /// closest elements together. Large sets go through one batched
+  /// mfind_closest_elem call; a few points, such as the sample points of a
+  /// single element, are searched one by one, as they would not repay building
+  /// the element hierarchy of the batched search.
+  class ClosestElemSearch
+  {
+    public:
+      ClosestElemSearch(const VMesh* mesh, double maxdist) :
+        mesh_(mesh), maxdist_(maxdist) {}
+
+      void add(size_t j, const Point& p)
+      {
+        index_.push_back(j);
+        points_.push_back(p);
+      }
+
+      /// Calls found(j,elem,coords) for every point with an element closer than
+      /// the maximum distance and missing(j) for the others
+      template <class FOUND, class MISSING>
+      void resolve(FOUND found, MISSING missing)
+      {
+        const size_t num = points_.size();
+        if (num >= minimum_batch_size)
+        {
+          mesh_->mfind_closest_elem(dist_,result_,coords_,elems_,points_,maxdist_);
+        }
+        else
+        {
+          dist_.resize(num); result_.resize(num);
+          coords_.resize(num); elems_.resize(num);
+          for (size_t k=0; k<num; k++)
+          {
+            if (!(mesh_->find_closest_elem(dist_[k],result_[k],coords_[k],elems_[k],points_[k],maxdist_)))
+              elems_[k] = -1;
+          }
+        }
+
+        for (size_t k=0; k<num; k++)
+        {
+          if (elems_[k] >= 0 && dist_[k] < maxdist_) found(index_[k],elems_[k],coords_[k]);
+          else missing(index_[k]);
+        }
+      }
+
+    private:
+      static const size_t minimum_batch_size = 256;
+
+      const VMesh* mesh_;
+      double maxdist_;
+      std::vector<size_t> index_;
+      std::vector<Point> points_;
+      std::vector<double> dist_;
+      std::vector<Point> result_;
+      std::vector<VMesh::coords_type> coords_;
+      std::vector<VMesh::Elem::index_type> elems_;
+  };
+
+  template <class T>
+  void interpolateOrClosest(VField* field, const VMesh* mesh, double maxdist,
+    std::vector<T>& data, const std::vector<Point>& p, const T& outside)
+  {
+    data.resize(p.size());
+    ClosestElemSearch search(mesh,maxdist);
+    for (size_t j=0; j<p.size(); j++)
+    {
+      if(!(field->interpolate(data[j],p[j],outside))) search.add(j,p[j]);
+    }
+    search.resolve(
+      [&](size_t j, VMesh::Elem::index_type elem, const VMesh::coords_type& coords)
+        { field->interpolate(data[j],coords,elem); },
+      [&](size_t j) { data[j] = outside; });
+  }
+
+  void gradientOrClosest(VField* field, const VMesh* mesh, double maxdist,
+    std::vector<Vector>& data, const std::vector<Point>& p)
+  {
+    data.resize(p.size());
+    ClosestElemSearch search(mesh,maxdist);
+    StackVector<double,3> grad;
+    for (size_t j=0; j<p.size(); j++)
+    {
+      if(field->gradient(grad,p[j])) data[j] = Vector(grad[0],grad[1],grad[2]);
+      else search.add(j,p[j]);
+    }
+    search.resolve(
+      [&](size_t j, VMesh::Elem::index_type elem, const VMesh::coords_type& coords)
+        {
+          field->gradient(grad,coords,elem);
+          data[j] = Vector(grad[0],grad[1],grad[2]);
+        },
+      [&](size_t j) { data[j] = Vector(0.0,0.0,0.0); });
+  }
+}
+
 class ClosestInterpolatedDataSource : public MappingDataSource {
   public:
     void get_data(double& data, const Point& p) const override
@@ -596,70 +696,17 @@ class ClosestInterpolatedDataSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],def_value_)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          if(smesh_->find_closest_elem(dist,r,coords,elem,p[j],maxdist_))
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = def_value_;
-          }
-        }
-      }
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,def_value_);
     }
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],Vector(0,0,0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-      }
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,Vector(0.0,0.0,0.0));
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->interpolate(data[j],p[j],Tensor(def_value_))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Tensor(def_value_);
-          }
-        }
-      }
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,Tensor(def_value_));
     }
 
     ClosestInterpolatedDataSource(FieldHandle sfield,double def_value,double max_dist)
@@ -794,122 +841,26 @@ class ClosestInterpolatedWeightedDataSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        double weight;
-        if(!(wfield_->interpolate(weight,p[j],0.0)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->interpolate(data[j],p[j],def_value_)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = def_value_;
-          }
-        }
-        data[j] = weight * data[j];
-      }
+      std::vector<double> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,0.0);
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,def_value_);
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j] * data[j];
     }
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        double weight;
-        if(!(wfield_->interpolate(weight,p[j],0.0)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->interpolate(data[j],p[j],Vector(0.0,0.0,0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-        data[j] = weight * data[j];
-      }
+      std::vector<double> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,0.0);
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,Vector(0.0,0.0,0.0));
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j] * data[j];
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        double weight;
-        if(!(wfield_->interpolate(weight,p[j],0.0)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->interpolate(data[j],p[j],Tensor(def_value_))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Tensor(def_value_);
-          }
-        }
-        data[j] = weight * data[j];
-      }
+      std::vector<double> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,0.0);
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,Tensor(def_value_));
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j] * data[j];
     }
 
     ClosestInterpolatedWeightedDataSource(FieldHandle sfield,FieldHandle wfield,double def_value,double max_dist)
@@ -1016,82 +967,26 @@ class ClosestInterpolatedWeightedTensorDataSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      for (size_t j=0; j<p.size(); j++)
-      {
-        Tensor weight;
-        if(!(wfield_->interpolate(weight,p[j],Tensor(0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->interpolate(data[j],p[j],Vector(0.0,0.0,0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-        data[j] = weight * data[j];
-      }
+      std::vector<Tensor> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,Tensor(0.0));
+      interpolateOrClosest(sfield_,smesh_,maxdist_,data,p,Vector(0.0,0.0,0.0));
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j] * data[j];
     }
 
     void get_data(std::vector<Tensor>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,data,p,Tensor(0.0));
+      std::vector<double> tdata(p.size());
+      ClosestElemSearch search(smesh_,maxdist_);
       for (size_t j=0; j<p.size(); j++)
       {
-        if(!(wfield_->interpolate(data[j],p[j],Tensor(0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(data[j],coords,elem);
-          }
-          else
-          {
-             data[j] = 0.0;
-          }
-        }
-        double tdata;
-        if(!(sfield_->interpolate(tdata,p[j],def_value_)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->interpolate(tdata,coords,elem);
-          }
-          else
-          {
-            data[j] = Tensor(def_value_);
-          }
-        }
-        data[j] = tdata * data[j];
+        if(!(sfield_->interpolate(tdata[j],p[j],def_value_))) search.add(j,p[j]);
       }
+      search.resolve(
+        [&](size_t j, VMesh::Elem::index_type elem, const VMesh::coords_type& coords)
+          { sfield_->interpolate(tdata[j],coords,elem); },
+        [&](size_t j) { data[j] = Tensor(def_value_); });
+      for (size_t j=0; j<p.size(); j++) data[j] = tdata[j] * data[j];
     }
 
     ClosestInterpolatedWeightedTensorDataSource(FieldHandle sfield,FieldHandle wfield,double def_value,double max_dist)
@@ -1149,31 +1044,7 @@ class ClosestInterpolatedGradientSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = Vector(grad[0],grad[1],grad[2]);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-        else
-        {
-          data[j] = Vector(grad[0],grad[1],grad[2]);
-        }
-      }
+      gradientOrClosest(sfield_,smesh_,maxdist_,data,p);
     }
 
 
@@ -1238,47 +1109,10 @@ class ClosestInterpolatedWeightedGradientSource : public MappingDataSource {
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        double weight;
-        if(!(wfield_->interpolate(weight,p[j],0.0)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = weight*Vector(grad[0],grad[1],grad[2]);
-          }
-          else
-          {
-            data[j] = weight*Vector(0.0,0.0,0.0);
-          }
-        }
-        else
-        {
-          data[j] = weight*Vector(grad[0],grad[1],grad[2]);
-        }
-      }
+      std::vector<double> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,0.0);
+      gradientOrClosest(sfield_,smesh_,maxdist_,data,p);
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j]*data[j];
     }
 
 
@@ -1348,47 +1182,10 @@ class ClosestInterpolatedWeightedTensorGradientSource : public MappingDataSource
 
     void get_data(std::vector<Vector>& data, const std::vector<Point>& p) const override
     {
-      data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        Tensor weight;
-        if(!(wfield_->interpolate(weight,p[j],Tensor(0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem,Tensor(0.0));
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = weight*Vector(grad[0],grad[1],grad[2]);
-          }
-          else
-          {
-            data[j] = Vector(0.0,0.0,0.0);
-          }
-        }
-        else
-        {
-          data[j] = weight*Vector(grad[0],grad[1],grad[2]);
-        }
-      }
+      std::vector<Tensor> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,Tensor(0.0));
+      gradientOrClosest(sfield_,smesh_,maxdist_,data,p);
+      for (size_t j=0; j<p.size(); j++) data[j] = weights[j]*data[j];
     }
 
 
@@ -1440,31 +1237,10 @@ class ClosestInterpolatedGradientNormSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
+      std::vector<Vector> grads;
+      gradientOrClosest(sfield_,smesh_,maxdist_,grads,p);
       data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = (Vector(grad[0],grad[1],grad[2])).length();
-          }
-          else
-          {
-            data[j] = 0.0;
-          }
-        }
-        else
-        {
-          data[j] = (Vector(grad[0],grad[1],grad[2])).length();
-        }
-      }
+      for (size_t j=0; j<p.size(); j++) data[j] = grads[j].length();
     }
 
 
@@ -1529,47 +1305,12 @@ class ClosestInterpolatedWeightedGradientNormSource : public MappingDataSource {
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
+      std::vector<double> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,0.0);
+      std::vector<Vector> grads;
+      gradientOrClosest(sfield_,smesh_,maxdist_,grads,p);
       data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        double weight;
-        if(!(wfield_->interpolate(weight,p[j],0.0)))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem,0.0);
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = (weight*Vector(grad[0],grad[1],grad[2])).length();
-          }
-          else
-          {
-            data[j] = 0.0;
-          }
-        }
-        else
-        {
-          data[j] = (weight*Vector(grad[0],grad[1],grad[2])).length();
-        }
-      }
+      for (size_t j=0; j<p.size(); j++) data[j] = (weights[j]*grads[j]).length();
     }
 
 
@@ -1639,47 +1380,12 @@ class ClosestInterpolatedWeightedTensorGradientNormSource : public MappingDataSo
 
     void get_data(std::vector<double>& data, const std::vector<Point>& p) const override
     {
+      std::vector<Tensor> weights;
+      interpolateOrClosest(wfield_,wmesh_,maxdist_,weights,p,Tensor(0.0));
+      std::vector<Vector> grads;
+      gradientOrClosest(sfield_,smesh_,maxdist_,grads,p);
       data.resize(p.size());
-      StackVector<double,3> grad;
-      for (size_t j=0; j<p.size(); j++)
-      {
-        Tensor weight;
-        if(!(wfield_->interpolate(weight,p[j],Tensor(0.0))))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          wmesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            wfield_->interpolate(weight,coords,elem,Tensor(0.0));
-          }
-          else
-          {
-            weight = 0.0;
-          }
-        }
-        if(!(sfield_->gradient(grad,p[j])))
-        {
-          double dist; Point r;
-          VMesh::Elem::index_type elem;
-          VMesh::coords_type coords;
-          smesh_->find_closest_elem(dist,r,coords,elem,p[j]);
-          if (dist < maxdist_)
-          {
-            sfield_->gradient(grad,coords,elem);
-            data[j] = (weight*Vector(grad[0],grad[1],grad[2])).length();
-          }
-          else
-          {
-            data[j] = 0.0;
-          }
-        }
-        else
-        {
-          data[j] = (weight*Vector(grad[0],grad[1],grad[2])).length();
-        }
-      }
+      for (size_t j=0; j<p.size(); j++) data[j] = (weights[j]*grads[j]).length();
     }
 
 
@@ -121,3 +121,62 @@ MatrixHandle BaseMC::get_parent_cells()
   #endif
     return MatrixHandle();
 }
+
+
+std::vector<BaseMC::edgepair_t> BaseMC::node_keys(size_type num_nodes) const
+{
+  const edgepair_t none = { -1, -1, 0.0 };
+  std::vector<edgepair_t> keys(num_nodes, none);
+
+  if (basis_order_ == 0)
+  {
+    for (index_type n = 0; n < static_cast<index_type>(node_map_.size()); n++)
+    {
+      const index_type surf = node_map_[n];
+      if (surf >= 0 && surf < num_nodes)
+      {
+        keys[surf].first = n;
+      }
+    }
+  }
+  else
+  {
+    for (const auto& e : edge_map_)
+    {
+      if (e.second >= 0 && e.second < num_nodes)
+        keys[e.second] = e.first;
+    }
+  }
+  return keys;
+}
+
+
+index_type BaseMC::find_node(const edgepair_t& key) const
+{
+  if (basis_order_ == 0)
+  {
+    if (key.first < 0 || key.first >= static_cast<index_type>(node_map_.size()))
+      return -1;
+    return node_map_[key.first];
+  }
+
+  const auto loc = edge_map_.find(key);
+  return loc == edge_map_.end() ? -1 : loc->second;
+}
+
+
+std::vector<BaseMC::edgepair_t> BaseMC::elem_keys(size_type num_elems) const
+{
+  const edgepair_t none = { -1, -1, 0.0 };
+  std::vector<edgepair_t> keys(num_elems, none);
+
+  if (basis_order_ == 0)
+  {
+    for (const auto& e : edge_map_)
+    {
+      if (e.second >= 0 && e.second < num_elems)
+        keys[e.second] = e.first;
+    }
+  }
+  return keys;
+}
@@ -87,6 +87,20 @@ namespace SCIRun {
       SCIRun::index_type second;
       double dfirst;
     };
+
+    /// What each output node was cut from: the source edge (first, second, dfirst) when
+    /// surfacing node data, or the source node (first, -1) when surfacing cell data.
+    /// Two tesselators that produce the same key produced the same point.
+    std::vector<edgepair_t> node_keys(SCIRun::size_type num_nodes) const;
+    /// Output node with the given key, or -1 if this tesselator did not produce it.
+    SCIRun::index_type find_node(const edgepair_t& key) const;
+    /// Source cell pair and weight of each output element when surfacing cell data.
+    std::vector<edgepair_t> elem_keys(SCIRun::size_type num_elems) const;
+    /// Source cell of each output element when surfacing node data.
+    const std::vector<SCIRun::index_type>& parent_cells() const { return cell_map_; }
+    SCIRun::size_type num_source_nodes() const { return nnodes_; }
+    SCIRun::size_type num_source_cells() const { return ncells_; }
+
   protected:
     struct edgepairhash
     {
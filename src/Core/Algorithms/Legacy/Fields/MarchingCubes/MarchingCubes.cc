@@ -35,9 +35,11 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/MarchingCubes.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
-#include <Core/Algorithms/Math/AppendMatrix.h>
 #include <Core/Algorithms/Legacy/Fields/MergeFields/AppendFieldsAlgo.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <numeric>
 
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/HexMC.h>
 #include <Core/Algorithms/Legacy/Fields/MarchingCubes/UHexMC.h>
@@ -59,7 +61,7 @@ using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Algorithms::Fields;
-using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Geometry;
 
 ALGORITHM_PARAMETER_DEF(Fields, transparency);
 ALGORITHM_PARAMETER_DEF(Fields, build_geometry);
@@ -84,6 +86,72 @@ AlgorithmOutput MarchingCubesAlgo::run(const AlgorithmInput&) const
   return output;
 }
 
+namespace
+{
+  // CSR with one or two entries per row: weight 1-dfirst on column first and dfirst on
+  // column second. Rows are independent, so both passes run in parallel.
+  MatrixHandle makeEdgeInterpolant(const std::vector<BaseMC::edgepair_t>& rows, size_type ncols)
+  {
+    const size_t nrows = rows.size();
+    std::vector<index_type> rr(nrows + 1, 0);
+    Parallel::For(0, nrows, [&](size_t first, size_t last)
+    {
+      for (size_t r = first; r < last; r++)
+        rr[r + 1] = (rows[r].first >= 0) + (rows[r].second >= 0);
+    });
+    std::partial_sum(rr.begin(), rr.end(), rr.begin());
+
+    auto matrix = makeShared<SparseRowMatrix>(static_cast<int>(nrows), static_cast<int>(ncols));
+    matrix->resizeNonZeros(rr[nrows]);
+    std::copy(rr.begin(), rr.end(), matrix->outerIndexPtr());
+    auto* cc = matrix->innerIndexPtr();
+    auto* dd = matrix->valuePtr();
+
+    Parallel::For(0, nrows, [&](size_t first, size_t last)
+    {
+      for (size_t r = first; r < last; r++)
+      {
+        auto k = rr[r];
+        if (rows[r].first >= 0)
+        {
+          cc[k] = rows[r].first;
+          dd[k] = 1.0 - rows[r].dfirst;
+          k++;
+        }
+        if (rows[r].second >= 0)
+        {
+          cc[k] = rows[r].second;
+          dd[k] = rows[r].dfirst;
+        }
+      }
+    });
+    return matrix;
+  }
+
+  // One unit entry per row selecting the parent cell.
+  MatrixHandle makeParentCells(const std::vector<index_type>& cells, size_type ncols)
+  {
+    const size_t nrows = cells.size();
+    auto matrix = makeShared<SparseRowMatrix>(static_cast<int>(nrows), static_cast<int>(ncols));
+    matrix->resizeNonZeros(nrows);
+    auto* rr = matrix->outerIndexPtr();
+    auto* cc = matrix->innerIndexPtr();
+    auto* dd = matrix->valuePtr();
+
+    Parallel::For(0, nrows, [&](size_t first, size_t last)
+    {
+      for (size_t r = first; r < last; r++)
+      {
+        rr[r] = r;
+        cc[r] = cells[r];
+        dd[r] = 1.0;
+      }
+    });
+    rr[nrows] = nrows;
+    return matrix;
+  }
+}
+
 template <class TESSELATOR>
 class MarchingCubesAlgoP {
 
@@ -95,21 +163,24 @@ class MarchingCubesAlgoP {
 
     ~MarchingCubesAlgoP()
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       delete_all_items(tesselator_);
-      #endif
+      for (auto* t : tesselator_)
+        delete t;
     }
 
     FieldHandle    input_;
 
     std::vector<TESSELATOR*>   tesselator_;
     std::vector<FieldHandle>  output_field_;
-    std::vector<MatrixHandle> output_interpolant_matrix_;
-    std::vector<MatrixHandle> output_parent_cell_matrix_;
     #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
      std::vector<GeomHandle>   output_geometry_;
     #endif
 
+    // One welded field per isovalue, and the rows of the interpolant matrices in the
+    // same node/element order as those fields appended together.
+    std::vector<FieldHandle>  stitched_field_;
+    std::vector<BaseMC::edgepair_t> interpolant_rows_;
+    std::vector<index_type> parent_cell_rows_;
+
     bool build_field_;
     bool build_node_interpolant_;
     bool build_elem_interpolant_;
@@ -124,10 +195,12 @@ class MarchingCubesAlgoP {
 
     void parallel(int proc, int nproc, size_t iso);
 
+    void stitch(int nproc, size_t iso);
+    void weld(const std::vector<VMesh*>& meshes, size_t iso,
+              FieldHandle& field, std::vector<BaseMC::edgepair_t>& node_rows);
+
   private:
     AppendFieldsAlgorithm append_fields_;
-    AppendMatrixAlgorithm append_matrices_;
-
 };
 
 
@@ -150,33 +223,25 @@ template <class TESSELATOR>
 bool
 MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
                         FieldHandle& output,
-                        MatrixHandle&,
-                        MatrixHandle&)
+                        MatrixHandle& node_interpolant,
+                        MatrixHandle& elem_interpolant)
 {
   algo_ = algo;
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  int np = algo->get_int("num_threads");
   /// By default (-1) choose number of processors
-  if (np < 1) np = Thread::numProcessors();
+  int np = algo->get(Parameters::num_threads).toInt();
+  const int ncores = static_cast<int>(Parallel::NumCores());
+  if (np < 1) np = ncores;
   /// Cap the number of threads
-  if (np > 4*Thread::numProcessors()) np = 4*Thread::numProcessors();
-  */
-  /// @todo: FIX MULTI THREADING OF MARCHING CUBES FIELDS ARE NOT PROPORLY LINKED
- #endif
-  int np = Parallel::NumCores();
+  if (np > 4*ncores) np = 4*ncores;
 
-  np = 1;
-  size_t num_values = iso_values_.size();
+  /// Curves cut into point clouds, which have no elements to weld; keep those serial.
+  if (FieldInformation(input_).is_crv_element()) np = 1;
 
-  tesselator_.resize(np);
-  for (size_t j=0; j<tesselator_.size(); j++)
-    tesselator_[j] = new TESSELATOR(input_);
+  const VMesh::size_type num_elems = input_->vmesh()->num_elems();
+  if (np > num_elems) np = std::max<int>(1, num_elems);
 
-  output_field_.resize(np*num_values);
-  output_interpolant_matrix_.resize(np*num_values);
-  output_parent_cell_matrix_.resize(np*num_values);
-  //output_geometry_.resize(np*num_values);
+  size_t num_values = iso_values_.size();
 
   build_field_ = algo->get(Parameters::build_field).toBool();
   build_geometry_ = algo->get(Parameters::build_geometry).toBool();
@@ -184,10 +249,20 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
   build_elem_interpolant_ = algo->get(Parameters::build_elem_interpolant).toBool();
   transparency_ = algo->get(Parameters::transparency).toBool();
 
+  /// Reset every tesselator once up front so that any mesh synchronization
+  /// it needs happens here, not concurrently inside the worker threads.
+  tesselator_.resize(np);
+  for (size_t j=0; j<tesselator_.size(); j++)
+  {
+    tesselator_[j] = new TESSELATOR(input_);
+    tesselator_[j]->reset(0, build_field_, build_geometry_, transparency_);
+  }
+
+  output_field_.resize(np*num_values);
+  //output_geometry_.resize(np*num_values);
+
  #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   append_fields_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.set_progress_reporter(algo->get_progress_reporter());
-  append_matrices_.setOption("method","append_rows");
  #endif
 
   for (size_t j=0; j<iso_values_.size(); j++)
@@ -198,10 +273,11 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
     }
     else
     {
-      #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-       Thread::parallel(this,&MarchingCubesAlgoP<TESSELATOR>::parallel,np,np,j);
-      #endif
+      Parallel::RunTasks([this, np, j](int proc) { parallel(proc, np, j); }, np);
     }
+
+    if (build_field_)
+      stitch(np, j);
   }
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (output_geometry_.size() == 0)
@@ -223,23 +299,22 @@ MarchingCubesAlgoP<TESSELATOR>::run(const AlgorithmBase* algo,
 
   if (build_field_)
   {
-   if (!(append_fields_.run(output_field_,output)))
+   if (!(append_fields_.run(stitched_field_,output)))
       return (false);
-  }
 
- #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-  if (build_node_interpolant_)
-  {
-    if (!(append_matrices_.run(output_interpolant_matrix_,node_interpolant)))
-      return (false);
-  }
+    const auto* tess = tesselator_[0];
+    if (build_node_interpolant_)
+    {
+      const size_type ncols = input_->vfield()->basis_order() == 0 ?
+        tess->num_source_cells() : tess->num_source_nodes();
+      node_interpolant = makeEdgeInterpolant(interpolant_rows_, ncols);
+    }
 
-  if (build_elem_interpolant_)
-  {
-    if (!(append_matrices_.run(output_parent_cell_matrix_,elem_interpolant)))
-      return (false);
+    if (build_elem_interpolant_)
+    {
+      elem_interpolant = makeParentCells(parent_cell_rows_, tess->num_source_cells());
+    }
   }
- #endif
 
   return (true);
 }
@@ -335,8 +410,6 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   }
 
   output_field_[iso*nproc+proc] = nullptr;
-  output_interpolant_matrix_[iso*nproc+proc] = nullptr;
-  output_parent_cell_matrix_[iso*nproc+proc] = nullptr;
 
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
    output_geometry_[iso*nproc+proc] = 0;
@@ -346,14 +419,6 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   {
     output_field_[iso*nproc+proc] = tesselator_[proc]->get_field(isoval);
   }
-  if (build_node_interpolant_)
-  {
-    output_interpolant_matrix_[iso*nproc+proc] = tesselator_[proc]->get_interpolant();
-  }
-  if (build_elem_interpolant_)
-  {
-    output_parent_cell_matrix_[iso*nproc+proc] = tesselator_[proc]->get_parent_cells();
-  }
 
   #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   if (build_geometry_)
@@ -383,3 +448,166 @@ void MarchingCubesAlgoP<TESSELATOR>::parallel( int proc, int nproc, size_t iso)
   #endif
 
 }
+
+
+/// Joins the per-thread surfaces of one isovalue into a single field and records
+/// the matching interpolant rows.
+template<class TESSELATOR>
+void MarchingCubesAlgoP<TESSELATOR>::stitch(int nproc, size_t iso)
+{
+  const bool node_data = input_->vfield()->basis_order() != 0;
+  const size_t np = static_cast<size_t>(nproc);
+
+  std::vector<VMesh*> meshes(np);
+  for (size_t p = 0; p < np; p++)
+    meshes[p] = output_field_[iso*np+p]->vmesh();
+
+  FieldHandle field;
+  std::vector<BaseMC::edgepair_t> node_rows;
+
+  if (np == 1)
+  {
+    field = output_field_[iso];
+    if (node_data && build_node_interpolant_)
+      node_rows = tesselator_[0]->node_keys(meshes[0]->num_nodes());
+  }
+  else
+  {
+    weld(meshes, iso, field, node_rows);
+  }
+
+  stitched_field_.push_back(field);
+
+  if (build_node_interpolant_)
+  {
+    if (node_data)
+    {
+      interpolant_rows_.insert(interpolant_rows_.end(), node_rows.begin(), node_rows.end());
+    }
+    else
+    {
+      for (size_t p = 0; p < np; p++)
+      {
+        const auto rows = tesselator_[p]->elem_keys(meshes[p]->num_elems());
+        interpolant_rows_.insert(interpolant_rows_.end(), rows.begin(), rows.end());
+      }
+    }
+  }
+
+  if (build_elem_interpolant_)
+  {
+    for (size_t p = 0; p < np; p++)
+    {
+      const auto& cells = tesselator_[p]->parent_cells();
+      parent_cell_rows_.insert(parent_cell_rows_.end(), cells.begin(), cells.end());
+    }
+  }
+}
+
+
+/// An edge cut (or source node) shared by elements of two threads appears in both
+/// outputs with the same key; it belongs to the lowest thread that produced it and
+/// the others map onto that copy. Every pass except the element append runs in parallel.
+template<class TESSELATOR>
+void MarchingCubesAlgoP<TESSELATOR>::weld(const std::vector<VMesh*>& meshes, size_t iso,
+  FieldHandle& field, std::vector<BaseMC::edgepair_t>& node_rows)
+{
+  const bool node_data = input_->vfield()->basis_order() != 0;
+  const size_t np = meshes.size();
+
+  std::vector<std::vector<BaseMC::edgepair_t> > keys(np);
+  std::vector<std::vector<index_type> > merged(np);
+  std::vector<std::vector<int> > owner(np);
+  std::vector<size_type> num_owned(np, 0);
+
+  Parallel::For(0, np, [&](size_t first, size_t last)
+  {
+    for (size_t p = first; p < last; p++)
+    {
+      const size_type nnodes = meshes[p]->num_nodes();
+      keys[p] = tesselator_[p]->node_keys(nnodes);
+      merged[p].assign(nnodes, -1);
+      owner[p].assign(nnodes, static_cast<int>(p));
+      for (index_type n = 0; n < nnodes; n++)
+      {
+        for (size_t q = 0; q < p; q++)
+        {
+          const index_type idx = tesselator_[q]->find_node(keys[p][n]);
+          if (idx >= 0)
+          {
+            owner[p][n] = static_cast<int>(q);
+            merged[p][n] = idx;
+            break;
+          }
+        }
+        if (owner[p][n] == static_cast<int>(p)) num_owned[p]++;
+      }
+    }
+  }, 1);
+
+  std::vector<index_type> node_offset(np + 1, 0);
+  std::vector<index_type> elem_offset(np + 1, 0);
+  for (size_t p = 0; p < np; p++)
+  {
+    node_offset[p+1] = node_offset[p] + num_owned[p];
+    elem_offset[p+1] = elem_offset[p] + meshes[p]->num_elems();
+  }
+  const size_type total_nodes = node_offset[np];
+  const size_type total_elems = elem_offset[np];
+
+  FieldInformation fi(output_field_[iso*np]);
+  field = CreateField(fi);
+  VMesh* omesh = field->vmesh();
+  omesh->resize_nodes(total_nodes);
+
+  if (node_data && build_node_interpolant_)
+    node_rows.resize(total_nodes);
+
+  // Number the nodes each thread owns and copy their points.
+  Parallel::For(0, np, [&](size_t first, size_t last)
+  {
+    for (size_t p = first; p < last; p++)
+    {
+      index_type next = node_offset[p];
+      Point pt;
+      for (index_type n = 0; n < static_cast<index_type>(merged[p].size()); n++)
+      {
+        if (owner[p][n] != static_cast<int>(p)) continue;
+        merged[p][n] = next++;
+        meshes[p]->get_point(pt, VMesh::Node::index_type(n));
+        omesh->set_point(pt, VMesh::Node::index_type(merged[p][n]));
+        if (!node_rows.empty()) node_rows[merged[p][n]] = keys[p][n];
+      }
+    }
+  }, 1);
+
+  // Shared nodes take the number their owner just assigned.
+  Parallel::For(0, np, [&](size_t first, size_t last)
+  {
+    for (size_t p = first; p < last; p++)
+    {
+      for (size_t n = 0; n < merged[p].size(); n++)
+      {
+        const int q = owner[p][n];
+        if (q != static_cast<int>(p)) merged[p][n] = merged[q][merged[p][n]];
+      }
+    }
+  }, 1);
+
+  omesh->elem_reserve(total_elems);
+  VMesh::Node::array_type nodes;
+  for (size_t p = 0; p < np; p++)
+  {
+    const VMesh::size_type nelems = meshes[p]->num_elems();
+    for (VMesh::Elem::index_type e = 0; e < nelems; e++)
+    {
+      meshes[p]->get_nodes(nodes, e);
+      for (size_t k = 0; k < nodes.size(); k++)
+        nodes[k] = merged[p][nodes[k]];
+      omesh->add_elem(nodes);
+    }
+  }
+
+  field->vfield()->resize_values();
+  field->vfield()->set_all_values(iso_values_[iso]);
+}
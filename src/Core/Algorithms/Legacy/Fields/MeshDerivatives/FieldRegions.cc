@@ -0,0 +1,246 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Algorithms/Legacy/Fields/MeshDerivatives/FieldRegions.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/Thread/Parallel.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Algorithms::Fields;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace {
+
+/// Lock free union-find. Roots are always linked to the smaller index, so
+/// the final root of every set is its smallest member.
+class ConcurrentDisjointSets
+{
+  public:
+    explicit ConcurrentDisjointSets(size_type size) : parent_(new std::atomic<index_type>[size])
+    {
+      Parallel::For(0, size, [this](size_t begin, size_t end)
+      {
+        for (size_t j = begin; j < end; ++j)
+          parent_[j].store(static_cast<index_type>(j), std::memory_order_relaxed);
+      });
+    }
+
+    index_type find(index_type x) const
+    {
+      while (true)
+      {
+        index_type p = parent_[x].load(std::memory_order_relaxed);
+        if (p == x) return (x);
+        const index_type gp = parent_[p].load(std::memory_order_relaxed);
+        // path halving, losing the race only means less compression
+        if (p != gp) parent_[x].compare_exchange_weak(p, gp, std::memory_order_relaxed);
+        x = gp;
+      }
+    }
+
+    void unite(index_type a, index_type b)
+    {
+      while (true)
+      {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        index_type expected = a;
+        if (parent_[a].compare_exchange_strong(expected, b)) return;
+      }
+    }
+
+  private:
+    std::unique_ptr<std::atomic<index_type>[]> parent_;
+};
+
+/// Counting sort of the elements by region, elements stay in ascending order
+ElementRegions groupRegions(const std::vector<index_type>& region, size_type numRegions)
+{
+  ElementRegions regions;
+  regions.offsets.assign(numRegions + 1, 0);
+  for (auto r : region) regions.offsets[r+1]++;
+  for (size_type r = 0; r < numRegions; r++) regions.offsets[r+1] += regions.offsets[r];
+
+  regions.elems.resize(region.size());
+  std::vector<index_type> fill(regions.offsets.begin(), regions.offsets.end() - 1);
+  for (size_t e = 0; e < region.size(); e++)
+    regions.elems[fill[region[e]]++] = static_cast<index_type>(e);
+  return (regions);
+}
+
+}
+
+ElementRegions
+SCIRun::Core::Algorithms::Fields::connectedRegions(const VMesh* mesh)
+{
+  const VMesh::size_type num_nodes = mesh->num_nodes();
+  const VMesh::size_type num_elems = mesh->num_elems();
+
+  ConcurrentDisjointSets sets(num_nodes);
+  std::vector<index_type> region(num_elems, -1);
+
+  Parallel::For(0, num_elems, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nodes;
+    for (size_t e = begin; e < end; ++e)
+    {
+      mesh->get_nodes(nodes, VMesh::Elem::index_type(static_cast<index_type>(e)));
+      for (size_t p = 1; p < nodes.size(); p++) sets.unite(nodes[0], nodes[p]);
+      // park the first node, it is replaced by the region below
+      if (!nodes.empty()) region[e] = nodes[0];
+    }
+  });
+
+  // Single pass: number the regions in the order of their first element
+  std::vector<index_type> rootRegion(num_nodes, -1);
+  size_type numRegions = 0;
+  for (VMesh::index_type e = 0; e < num_elems; e++)
+  {
+    if (region[e] < 0) { region[e] = numRegions++; continue; }
+    const index_type root = sets.find(region[e]);
+    if (rootRegion[root] < 0) rootRegion[root] = numRegions++;
+    region[e] = rootRegion[root];
+  }
+
+  return (groupRegions(region, numRegions));
+}
+
+ElementRegions
+SCIRun::Core::Algorithms::Fields::labeledRegions(const std::vector<int>& labels, std::vector<int>& regionLabels)
+{
+  regionLabels = labels;
+  std::sort(regionLabels.begin(), regionLabels.end());
+  regionLabels.erase(std::unique(regionLabels.begin(), regionLabels.end()), regionLabels.end());
+
+  std::vector<index_type> region(labels.size());
+  Parallel::For(0, labels.size(), [&](size_t begin, size_t end)
+  {
+    for (size_t e = begin; e < end; ++e)
+      region[e] = std::lower_bound(regionLabels.begin(), regionLabels.end(), labels[e]) - regionLabels.begin();
+  });
+
+  return (groupRegions(region, static_cast<size_type>(regionLabels.size())));
+}
+
+FieldList
+SCIRun::Core::Algorithms::Fields::extractRegions(FieldHandle input, FieldInformation& fo,
+  const ElementRegions& regions, bool copyValues)
+{
+  const size_type numRegions = regions.size();
+  FieldList output(numRegions);
+
+  // The type registries are shared, so the fields are created up front
+  for (size_type r = 0; r < numRegions; r++)
+  {
+    MeshHandle mesh = CreateMesh(fo);
+    if (!mesh) return (FieldList());
+    output[r] = CreateField(fo, mesh);
+    if (!output[r]) return (FieldList());
+  }
+  if (numRegions == 0) return (output);
+
+  VMesh* imesh = input->vmesh();
+  VField* ifield = input->vfield();
+  const VMesh::size_type num_nodes = imesh->num_nodes();
+  std::atomic<size_type> next(0);
+
+  // Regions vary wildly in size, so each task pulls the next one when done
+  auto task = [&](int)
+  {
+    std::vector<index_type> renumber(num_nodes);
+    std::vector<index_type> stamp(num_nodes, -1);
+    std::vector<VMesh::Node::index_type> nodes;
+    VMesh::Node::array_type elemnodes;
+    Point point;
+
+    for (size_type r = next++; r < numRegions; r = next++)
+    {
+      VMesh* omesh = output[r]->vmesh();
+      VField* ofield = output[r]->vfield();
+      const index_type* begin = &regions.elems[0] + regions.offsets[r];
+      const index_type* end = &regions.elems[0] + regions.offsets[r+1];
+
+      nodes.clear();
+      for (const index_type* e = begin; e != end; ++e)
+      {
+        imesh->get_nodes(elemnodes, VMesh::Elem::index_type(*e));
+        for (auto n : elemnodes)
+        {
+          if (stamp[n] == r) continue;
+          stamp[n] = r;
+          renumber[n] = static_cast<index_type>(nodes.size());
+          nodes.push_back(n);
+        }
+      }
+
+      omesh->node_reserve(static_cast<VMesh::size_type>(nodes.size()));
+      omesh->elem_reserve(static_cast<VMesh::size_type>(end - begin));
+      for (auto n : nodes)
+      {
+        imesh->get_center(point, n);
+        omesh->add_point(point);
+      }
+      for (const index_type* e = begin; e != end; ++e)
+      {
+        imesh->get_nodes(elemnodes, VMesh::Elem::index_type(*e));
+        for (auto& n : elemnodes) n = VMesh::Node::index_type(renumber[n]);
+        omesh->add_elem(elemnodes);
+      }
+
+      ofield->resize_fdata();
+
+      if (copyValues && ifield->basis_order() == 1)
+      {
+        for (size_t q = 0; q < nodes.size(); q++)
+          ofield->copy_value(ifield, nodes[q], static_cast<VMesh::index_type>(q));
+      }
+      else if (copyValues && ifield->basis_order() == 0)
+      {
+        for (const index_type* e = begin; e != end; ++e)
+          ofield->copy_value(ifield, *e, static_cast<VMesh::index_type>(e - begin));
+      }
+    }
+  };
+
+  const int np = static_cast<int>(std::min<size_type>(Parallel::NumCores(), numRegions));
+  Parallel::RunTasks(task, np);
+
+  return (output);
+}
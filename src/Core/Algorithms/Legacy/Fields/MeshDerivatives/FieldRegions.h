@@ -0,0 +1,75 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_ALGORITHMS_FIELDS_MESHDERIVATIVES_FIELDREGIONS_H
+#define CORE_ALGORITHMS_FIELDS_MESHDERIVATIVES_FIELDREGIONS_H 1
+
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Algorithms/Legacy/Fields/share.h>
+#include <vector>
+
+namespace SCIRun {
+  class VMesh;
+  class FieldInformation;
+namespace Core {
+namespace Algorithms {
+namespace Fields {
+
+  /// Elements of a mesh grouped into regions. The elements of region r are
+  /// elems[offsets[r]] .. elems[offsets[r+1]-1], in ascending order.
+  struct SCISHARE ElementRegions
+  {
+    std::vector<index_type> offsets;
+    std::vector<index_type> elems;
+
+    size_type size() const { return offsets.empty() ? 0 : static_cast<size_type>(offsets.size() - 1); }
+    size_type size(size_type r) const { return offsets[r+1] - offsets[r]; }
+  };
+
+  /// Labels the regions of elements connected through shared nodes with a
+  /// concurrent union-find over the nodes. Regions are numbered in the order
+  /// of their first element. No mesh synchronization is needed.
+  SCISHARE ElementRegions connectedRegions(const VMesh* mesh);
+
+  /// Groups the elements by label, one region per distinct label in
+  /// ascending order. The label of each region is returned in regionLabels.
+  SCISHARE ElementRegions labeledRegions(const std::vector<int>& labels, std::vector<int>& regionLabels);
+
+  /// Extracts every region of input into its own field of type fo, in
+  /// parallel over the regions. Nodes are numbered in the order in which the
+  /// elements of the region first use them. With copyValues the node or
+  /// element data of input is copied over. Returns an empty list if a field
+  /// could not be created.
+  SCISHARE FieldList extractRegions(FieldHandle input, FieldInformation& fo,
+    const ElementRegions& regions, bool copyValues);
+
+}}}}
+
+#endif
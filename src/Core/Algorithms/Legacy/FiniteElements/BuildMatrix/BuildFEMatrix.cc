@@ -46,6 +46,9 @@
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <numeric>
 #include <boost/shared_array.hpp>
 
 using namespace SCIRun;
@@ -66,14 +69,40 @@ namespace SCIRun {
         template <typename T>
         using matrix_pointer_type = SharedPointer<matrix_type<T>>;
 
+// Symbolic part of the stiffness matrix: the CSR structure of the node-node
+// coupling and a coloring of the elements in which no two elements of one
+// color share a node. Elements of one color can hence be scattered into the
+// matrix concurrently without locking. It only depends on the mesh.
+class FEMatrixPattern
+{
+public:
+  bool matches(FieldHandle input) const;
+  void build(FieldHandle input);
+
+  index_type num_colors() const { return static_cast<index_type>(color_start_.size()) - 1; }
+
+  std::vector<index_type> rows_;
+  std::vector<index_type> cols_;
+  // Elements grouped by color, color c owns elems_[color_start_[c] .. color_start_[c+1])
+  std::vector<index_type> color_start_;
+  std::vector<index_type> elems_;
+
+private:
+  std::weak_ptr<Mesh> mesh_;
+  int generation_ = -1;
+  size_type num_nodes_ = 0;
+  size_type num_elems_ = 0;
+};
+
 template <typename T>
 class BuildFEMatrixAlgoImpl
 {
 public:
-  explicit BuildFEMatrixAlgoImpl(const AlgorithmBase* algo) : algo_(algo) {}
+  BuildFEMatrixAlgoImpl(const AlgorithmBase* algo, SharedPointer<FEMatrixPattern>& pattern) : algo_(algo), pattern_(pattern) {}
   bool run(FieldHandle input, Datatypes::DenseMatrixHandle ctable, matrix_pointer_type<T>& output) const;
 private:
   const AlgorithmBase* algo_;
+  SharedPointer<FEMatrixPattern>& pattern_;
   mutable int generation_ = 0;
   mutable std::vector<std::vector<T>> basis_values_;
   mutable matrix_pointer_type<T> basis_fematrix_;
@@ -84,8 +113,8 @@ template <typename T>
 class FEMBuilder
 {
 public:
-  explicit FEMBuilder(const AlgorithmBase* algo) :
-    algo_(algo), numprocessors_(Parallel::NumCores()),
+  FEMBuilder(const AlgorithmBase* algo, SharedPointer<FEMatrixPattern>& pattern) :
+    algo_(algo), pattern_(pattern), numprocessors_(Parallel::NumCores()),
     barrier_("FEMBuilder Barrier", numprocessors_),
     mesh_(nullptr), field_(nullptr),
     domain_dimension(0), local_dimension_nodes(0),
@@ -105,6 +134,7 @@ public:
 
 private:
   const AlgorithmBase* algo_;
+  SharedPointer<FEMatrixPattern>& pattern_;
   int numprocessors_;
   Barrier barrier_;
 
@@ -160,11 +190,129 @@ private:
                                   std::vector<double>& w,
                                   std::vector<std::vector<double>>& d,
                                   std::vector<std::vector<T>>& precompute);
+  bool build_element_matrix(VMesh::Elem::index_type c_ind,
+                            std::vector<T>& l_stiff,
+                            const std::vector<std::vector<double>>& d,
+                            const std::vector<std::vector<double>>& geometry);
+  bool element_geometry(VMesh::Elem::index_type c_ind,
+                        const std::vector<VMesh::coords_type>& p,
+                        const std::vector<double>& w,
+                        std::vector<std::vector<double>>& geometry);
+  // Lock-free assembly over the element coloring of the cached pattern
+  bool assemble_colored();
   bool setup();
 
 };
 }}}}
 
+bool FEMatrixPattern::matches(FieldHandle input) const
+{
+  auto mesh = input->vmesh();
+  return mesh_.lock() == input->mesh() &&
+    generation_ == mesh->generation() &&
+    num_nodes_ == mesh->num_nodes() &&
+    num_elems_ == mesh->num_elems();
+}
+
+void FEMatrixPattern::build(FieldHandle input)
+{
+  auto mesh = input->vmesh();
+  mesh_ = input->mesh();
+  generation_ = mesh->generation();
+  num_nodes_ = mesh->num_nodes();
+  num_elems_ = mesh->num_elems();
+
+  mesh->synchronize(Mesh::NODE_NEIGHBORS_E);
+
+  // Couplings of each node: all nodes of the elements around it. Chunks of rows
+  // are gathered independently and concatenated once the row lengths are known.
+  const size_t grain = Parallel::GrainSize(num_nodes_, 0);
+  const size_t numChunks = num_nodes_ > 0 ? (num_nodes_ + grain - 1) / grain : 0;
+  std::vector<std::vector<index_type>> chunkCols(numChunks);
+  rows_.assign(num_nodes_ + 1, 0);
+
+  Parallel::For(0, numChunks, [&](size_t firstChunk, size_t lastChunk)
+  {
+    VMesh::Elem::array_type ca;
+    VMesh::Node::array_type na;
+    std::vector<index_type> neighbors;
+    for (size_t c = firstChunk; c < lastChunk; c++)
+    {
+      auto& mycols = chunkCols[c];
+      const size_t end = std::min<size_t>(num_nodes_, (c+1)*grain);
+      for (size_t i = c*grain; i < end; i++)
+      {
+        neighbors.clear();
+        mesh->get_elems(ca, VMesh::Node::index_type(i));
+        for (const auto& elem : ca)
+        {
+          mesh->get_nodes(na, elem);
+          neighbors.insert(neighbors.end(), na.begin(), na.end());
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        auto last = std::unique(neighbors.begin(), neighbors.end());
+        mycols.insert(mycols.end(), neighbors.begin(), last);
+        rows_[i+1] = last - neighbors.begin();
+      }
+    }
+  }, 1);
+
+  std::vector<size_t> chunkOffset(numChunks + 1, 0);
+  for (size_t c = 0; c < numChunks; c++)
+    chunkOffset[c+1] = chunkOffset[c] + chunkCols[c].size();
+  std::partial_sum(rows_.begin(), rows_.end(), rows_.begin());
+
+  cols_.resize(chunkOffset[numChunks]);
+  Parallel::For(0, numChunks, [&](size_t firstChunk, size_t lastChunk)
+  {
+    for (size_t c = firstChunk; c < lastChunk; c++)
+    {
+      std::copy(chunkCols[c].begin(), chunkCols[c].end(), cols_.begin() + chunkOffset[c]);
+      std::vector<index_type>().swap(chunkCols[c]);
+    }
+  }, 1);
+
+  // Greedy coloring, 64 colors per sweep: a node records which colors of the
+  // current sweep its elements already use.
+  std::vector<index_type> color(num_elems_, -1);
+  std::vector<uint64_t> used(num_nodes_);
+  VMesh::Node::array_type na;
+  size_type remaining = num_elems_;
+  index_type numColors = 0;
+  for (index_type base = 0; remaining > 0; base += 64)
+  {
+    std::fill(used.begin(), used.end(), 0);
+    for (index_type e = 0; e < num_elems_; e++)
+    {
+      if (color[e] >= 0)
+        continue;
+      mesh->get_nodes(na, VMesh::Elem::index_type(e));
+      uint64_t mask = 0;
+      for (const auto& n : na)
+        mask |= used[n];
+      if (mask == ~uint64_t(0))
+        continue;
+      int bit = 0;
+      while (mask & (uint64_t(1) << bit))
+        bit++;
+      for (const auto& n : na)
+        used[n] |= uint64_t(1) << bit;
+      color[e] = base + bit;
+      numColors = std::max(numColors, color[e] + 1);
+      remaining--;
+    }
+  }
+
+  color_start_.assign(numColors + 1, 0);
+  for (index_type e = 0; e < num_elems_; e++)
+    color_start_[color[e]+1]++;
+  std::partial_sum(color_start_.begin(), color_start_.end(), color_start_.begin());
+  elems_.resize(num_elems_);
+  std::vector<index_type> fill(color_start_.begin(), color_start_.end() - 1);
+  for (index_type e = 0; e < num_elems_; e++)
+    elems_[fill[color[e]]++] = e;
+}
+
 template <typename T>
 bool
 FEMBuilder<T>::build_matrix(FieldHandle input,
@@ -254,16 +402,33 @@ FEMBuilder<T>::build_matrix(FieldHandle input,
 
   success_.resize(numprocessors_,true);
 
-  // Start the multi threaded FE matrix builder.
-  Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
-  for (size_t j=0; j<success_.size(); j++)
+  if (field_->basis_order() != 2)
   {
-    if (!success_[j])
+    // Linear elements: every DOF is a mesh node, so the structure can be cached
+    // and each element matrix computed once and scattered.
+    if (!pattern_ || !pattern_->matches(input))
     {
-      std::ostringstream oss;
-      oss << "Algorithm failed in thread " << j;
-      algo_->error(oss.str());
+      auto pattern = makeShared<FEMatrixPattern>();
+      pattern->build(input);
+      pattern_ = pattern;
+    }
+
+    if (!assemble_colored())
       return false;
+  }
+  else
+  {
+    // Start the multi threaded FE matrix builder.
+    Parallel::RunTasks([this](int i) { parallel(i); }, numprocessors_);
+    for (size_t j=0; j<success_.size(); j++)
+    {
+      if (!success_[j])
+      {
+        std::ostringstream oss;
+        oss << "Algorithm failed in thread " << j;
+        algo_->error(oss.str());
+        return false;
+      }
     }
   }
 
@@ -606,6 +771,187 @@ FEMBuilder<T>::build_local_matrix_regular(VMesh::Elem::index_type c_ind,
   return true;
 }
 
+/// inverse Jacobian and scaled determinant of an element at each integration point
+template <typename T>
+bool
+FEMBuilder<T>::element_geometry(VMesh::Elem::index_type c_ind,
+                                const std::vector<VMesh::coords_type> &p,
+                                const std::vector<double> &w,
+                                std::vector<std::vector<double>> &geometry)
+{
+  auto vol = mesh_->get_element_size();
+  geometry.resize(p.size());
+  for (size_t i = 0; i < p.size(); i++)
+  {
+    auto& g = geometry[i];
+    g.resize(10);
+    auto detJ = mesh_->inverse_jacobian(p[i], c_ind, &g[0]);
+
+    // If Jacobian is negative there is a problem with the mesh
+    if (detJ <= 0.0)
+    {
+      algo_->error("Mesh has elements with negative jacobians, check the order of the nodes that define an element");
+      return false;
+    }
+    // weightfactor * Volume Unit element * Volume ratio (real element/unit element)
+    g[9] = detJ * w[i] * vol;
+  }
+  return true;
+}
+
+/// build the full local stiffness matrix of an element, row major
+template <typename T>
+bool
+FEMBuilder<T>::build_element_matrix(VMesh::Elem::index_type c_ind,
+                                    std::vector<T> &l_stiff,
+                                    const std::vector<std::vector<double>> &d,
+                                    const std::vector<std::vector<double>> &geometry)
+{
+  Tensor tensor;
+
+  if (tensors_.empty())
+  {
+    field_->get_value(tensor,c_ind);
+  }
+  else
+  {
+    int tensor_index;
+    field_->get_value(tensor_index,c_ind);
+    tensor = tensors_[tensor_index].second;
+  }
+
+  auto Ca = tensor.val(0,0);
+  auto Cb = tensor.val(0,1);
+  auto Cc = tensor.val(0,2);
+  auto Cd = tensor.val(1,1);
+  auto Ce = tensor.val(1,2);
+  auto Cf = tensor.val(2,2);
+
+  std::fill(l_stiff.begin(), l_stiff.end(), T(0.0));
+  if ( (Ca==0) && (Cb==0) && (Cc==0) && (Cd==0) && (Ce==0) && (Cf==0) )
+    return true;
+
+  auto local_dimension2 = 2*local_dimension;
+
+  for (size_t i = 0; i < d.size(); i++)
+  {
+    const auto Ji = &geometry[i][0];
+    const auto detJ = geometry[i][9];
+
+    auto Nxi = &d[i][0];
+    auto Nyi = &d[i][local_dimension];
+    auto Nzi = &d[i][local_dimension2];
+
+    // Same arithmetic as build_local_matrix, for all rows at once
+    for (int row = 0; row < local_dimension; row++)
+    {
+      const auto uxp = detJ*(Nxi[row]*Ji[0] + Nyi[row]*Ji[1] + Nzi[row]*Ji[2]);
+      const auto uyp = detJ*(Nxi[row]*Ji[3] + Nyi[row]*Ji[4] + Nzi[row]*Ji[5]);
+      const auto uzp = detJ*(Nxi[row]*Ji[6] + Nyi[row]*Ji[7] + Nzi[row]*Ji[8]);
+      const auto uxyzpabc = uxp*Ca + uyp*Cb + uzp*Cc;
+      const auto uxyzpbde = uxp*Cb + uyp*Cd + uzp*Ce;
+      const auto uxyzpcef = uxp*Cc + uyp*Ce + uzp*Cf;
+
+      auto lrow = &l_stiff[row*local_dimension];
+      for (int j = 0; j < local_dimension; j++)
+      {
+        const auto ux = Nxi[j]*Ji[0] + Nyi[j]*Ji[1] + Nzi[j]*Ji[2];
+        const auto uy = Nxi[j]*Ji[3] + Nyi[j]*Ji[4] + Nzi[j]*Ji[5];
+        const auto uz = Nxi[j]*Ji[6] + Nyi[j]*Ji[7] + Nzi[j]*Ji[8];
+        lrow[j] += ux*uxyzpabc+uy*uxyzpbde+uz*uxyzpcef;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+bool
+FEMBuilder<T>::assemble_colored()
+{
+  if (!setup())
+    return false;
+
+  const auto& pattern = *pattern_;
+  const auto nnz = pattern.cols_.size();
+
+  fematrix_ = makeShared<matrix_type<T>>(global_dimension, global_dimension);
+  fematrix_->resizeNonZeros(nnz);
+  std::copy(pattern.rows_.begin(), pattern.rows_.end(), fematrix_->outerIndexPtr());
+  auto values = fematrix_->valuePtr();
+  Parallel::For(0, nnz, [&](size_t begin, size_t end)
+  {
+    std::copy(pattern.cols_.begin() + begin, pattern.cols_.begin() + end, fematrix_->innerIndexPtr() + begin);
+    std::fill(values + begin, values + end, T(0.0));
+  });
+
+  std::vector<VMesh::coords_type> ni_points;
+  std::vector<double> ni_weights;
+  std::vector<std::vector<double>> ni_derivatives;
+  create_numerical_integration(ni_points, ni_weights, ni_derivatives);
+
+  // All elements of a regular mesh share one Jacobian
+  std::vector<std::vector<double>> regular_geometry;
+  const bool regular = mesh_->is_regularmesh();
+  if (regular && !pattern.elems_.empty() &&
+      !element_geometry(VMesh::Elem::index_type(pattern.elems_[0]), ni_points, ni_weights, regular_geometry))
+    return false;
+
+  const auto rows = &pattern.rows_[0];
+  const auto cols = &pattern.cols_[0];
+  std::atomic<bool> success(true);
+
+  try
+  {
+    for (index_type color = 0; color < pattern.num_colors() && success; color++)
+    {
+      // No two elements of this color share a node, so no two of them touch the same row
+      Parallel::For(pattern.color_start_[color], pattern.color_start_[color+1],
+        [&](size_t begin, size_t end)
+      {
+        std::vector<std::vector<double>> geometry;
+        std::vector<T> lsml(local_dimension*local_dimension);
+        VMesh::Node::array_type na;
+
+        for (size_t k = begin; k < end && success; k++)
+        {
+          VMesh::Elem::index_type elem(pattern.elems_[k]);
+          if (!regular && !element_geometry(elem, ni_points, ni_weights, geometry))
+          {
+            success = false;
+            return;
+          }
+          if (!build_element_matrix(elem, lsml, ni_derivatives, regular ? regular_geometry : geometry))
+          {
+            success = false;
+            return;
+          }
+
+          mesh_->get_nodes(na, elem);
+          for (int a = 0; a < local_dimension; a++)
+          {
+            const auto rowBegin = cols + rows[na[a]];
+            const auto rowEnd = cols + rows[na[a]+1];
+            for (int b = 0; b < local_dimension; b++)
+            {
+              const auto pos = std::lower_bound(rowBegin, rowEnd, static_cast<index_type>(na[b])) - cols;
+              values[pos] += lsml[a*local_dimension+b];
+            }
+          }
+        }
+      });
+      algo_->update_progress_max(color+1, pattern.num_colors());
+    }
+  }
+  catch (...)
+  {
+    algo_->error("BuildFEMatrix crashed while filling out stiffness matrix");
+    return false;
+  }
+
+  return success;
+}
+
 template <typename T>
 bool
 FEMBuilder<T>::setup()
@@ -1111,7 +1457,7 @@ BuildFEMatrixAlgoImpl<T>::run(FieldHandle input, DenseMatrixHandle ctable, matri
     }
   }
 
-  FEMBuilder<T> builder(algo_);
+  FEMBuilder<T> builder(algo_, pattern_);
 
   if (algo_->get(BuildFEMatrixAlgo::GenerateBasis).toBool())
   {
@@ -1241,7 +1587,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
   if (field && field->vfield() && field->vfield()->is_complex_double())
 	{
 		matrix_pointer_type<complex> stiffness;
-	  BuildFEMatrixAlgoImpl<complex> impl(this);
+	  BuildFEMatrixAlgoImpl<complex> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.--complex detected	");
 		output[Stiffness_Matrix_Complex] = stiffness;
@@ -1249,7 +1595,7 @@ AlgorithmOutput BuildFEMatrixAlgo::run(const AlgorithmInput& input) const
 	else
 	{
 		matrix_pointer_type<double> stiffness;
-	  BuildFEMatrixAlgoImpl<double> impl(this);
+	  BuildFEMatrixAlgoImpl<double> impl(this, pattern_);
 	  if (!impl.run(field, ctable, stiffness))
 	    THROW_ALGORITHM_PROCESSING_ERROR("False returned on legacy run call.");
 		output[Stiffness_Matrix] = stiffness;
@@ -38,6 +38,8 @@ namespace SCIRun {
 		namespace Algorithms {
 			namespace FiniteElements {
 
+class FEMatrixPattern;
+
 class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
 {
   public:
@@ -61,6 +63,11 @@ class SCISHARE BuildFEMatrixAlgo : public AlgorithmBase
     }
 
     AlgorithmOutput run(const AlgorithmInput &) const override;
+
+  private:
+    // Sparsity structure and element coloring of the last mesh, so that re-running
+    // on the same mesh with new conductivities only redoes the numerical part
+    mutable SharedPointer<FEMatrixPattern> pattern_;
 };
 
 }}}}
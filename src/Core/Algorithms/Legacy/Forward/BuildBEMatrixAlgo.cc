@@ -54,11 +54,13 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Core/GeometryPrimitives/PointVectorOperators.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Core::Algorithms::Forward;
 using namespace SCIRun::Core::Datatypes;
 using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
 
 ALGORITHM_PARAMETER_DEF(Forward, FieldNameList);
 ALGORITHM_PARAMETER_DEF(Forward, FieldTypeList);
@@ -71,6 +73,18 @@ void BuildBEMatrixBase::getOmega(
   const Vector& y2,
   const Vector& y3,
   DenseMatrix& coef)
+{
+  double values[3];
+  getOmega(y1, y2, y3, values);
+  for (int i = 0; i < 3; ++i)
+    coef(0,i) = values[i];
+}
+
+void BuildBEMatrixBase::getOmega(
+  const Vector& y1,
+  const Vector& y2,
+  const Vector& y3,
+  double coef[3])
 {
   /*
   This function deals with the analytical solutions of the various integrals in the stiffness matrix
@@ -145,9 +159,9 @@ void BuildBEMatrixBase::getOmega(
   double Zn3 = Dot(Cross(y1, y2) , N);
 
   double A2 = N.length2();
-  coef(0,0) = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
-  coef(0,1) = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
-  coef(0,2) = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
+  coef[0] = (1/A2) * ( Zn1*Omega + d * Dot(y32, OmegaVec) );
+  coef[1] = (1/A2) * ( Zn2*Omega + d * Dot(y13, OmegaVec) );
+  coef[2] = (1/A2) * ( Zn3*Omega + d * Dot(y21, OmegaVec) );
 
 }
 
@@ -243,27 +257,43 @@ void BuildBEMatrixBase::get_g_coef(
   double r,
   const Vector& centroid,
   DenseMatrix& g_coef)
+{
+  double values[7];
+  get_g_coef(p1, p2, p3, op, s, r, centroid, values);
+  for (int i = 0; i < 7; ++i)
+    g_coef(0,i) = values[i];
+}
+
+void BuildBEMatrixBase::get_g_coef(
+  const Vector& p1,
+  const Vector& p2,
+  const Vector& p3,
+  const Vector& op,
+  double s,
+  double r,
+  const Vector& centroid,
+  double g_coef[7])
 {
   // Inputs: p1,p2,p3= cartesian coordiantes of the triangle vertices ; op= Observation Point
   // Output: g_coef = G Values (Coefficients) at 7 Radon's points = 1/r
   Vector radpt = centroid - op;
-  g_coef(0,0) = 1 / radpt.length();
+  g_coef[0] = 1 / radpt.length();
 
   Vector temp = centroid * (1-s) - op;
   radpt = temp + p1 * s;
-  g_coef(0,1) = 1 / radpt.length();
+  g_coef[1] = 1 / radpt.length();
   radpt = temp + p2 * s;
-  g_coef(0,2) = 1 / radpt.length();
+  g_coef[2] = 1 / radpt.length();
   radpt = temp + p3 * s;
-  g_coef(0,3) = 1 / radpt.length();
+  g_coef[3] = 1 / radpt.length();
 
   temp = centroid * (1-r) - op;
   radpt = temp + p1 * r;
-  g_coef(0,4) = 1 / radpt.length();
+  g_coef[4] = 1 / radpt.length();
   radpt = temp + p2 * r;
-  g_coef(0,5) = 1 / radpt.length();
+  g_coef[5] = 1 / radpt.length();
   radpt = temp + p3 * r;
-  g_coef(0,6) = 1 / radpt.length();
+  g_coef[6] = 1 / radpt.length();
 }
 
 void BuildBEMatrixBase::bem_sing(
@@ -272,13 +302,26 @@ void BuildBEMatrixBase::bem_sing(
   const Vector& p3,
   unsigned int op_n,
   DenseMatrix& g_values)
+{
+  double values[3];
+  bem_sing(p1, p2, p3, op_n, values);
+  for (int i = 0; i < 3; ++i)
+    g_values(i,0) = values[i];
+}
+
+void BuildBEMatrixBase::bem_sing(
+  const Vector& p1,
+  const Vector& p2,
+  const Vector& p3,
+  unsigned int op_n,
+  double g_values[3])
 {
   /*
   This is Jeroen's method, converted from his Matlab code, for dealing with weightings corresponding to singular triangles
   */
   Vector A,B,C,P,BC,BA,AC,AP;
-  DenseMatrix WAPB(3,1);
-  DenseMatrix WAPC(3,1);
+  double WAPB[3];
+  double WAPC[3];
   int one=0,two=1,three=2;
 
   switch(op_n)
@@ -314,44 +357,44 @@ void BuildBEMatrixBase::bem_sing(
   {
     a=lAP; b=lBP; c=lAB;
     log_term=log( (b+c)/a );
-    WAPB(0,0)=a/2 * log_term;
+    WAPB[0]=a/2 * log_term;
     w=1-RL;
-    WAPB(1,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPB[1]=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
     w=RL;
-    WAPB(2,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPB[2]=a*w *( a-c  +  b*log_term )/(2*b);
   }
   else
   {
-    WAPB(0,0)=0; WAPB(1,0)=0; WAPB(2,0)=0;
+    WAPB[0]=0; WAPB[1]=0; WAPB[2]=0;
   }
 
   if(fabs(RL-1) > 0)
   {
     a = lAP; b = lCP; c = lAC;
     log_term = log( (b+c)/a );
-    WAPC(0,0)=a/2 * log_term;
+    WAPC[0]=a/2 * log_term;
     w = 1-RL;
-    WAPC(1,0)=a*w *( a-c  +  b*log_term )/(2*b);
+    WAPC[1]=a*w *( a-c  +  b*log_term )/(2*b);
     w = RL;
-    WAPC(2,0)=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
+    WAPC[2]=a* (( a-c)*(-1+w) + b*w*log_term )/(2*b);
   }
   else
   {
-    WAPC(0,0)=0; WAPC(1,0)=0; WAPC(2,0)=0;
+    WAPC[0]=0; WAPC[1]=0; WAPC[2]=0;
   }
 
   if(RL<0)
   {
-    WAPB(0,0)*=-1.0; WAPB(1,0)*=-1.0; WAPB(2,0)*=-1.0;
+    WAPB[0]*=-1.0; WAPB[1]*=-1.0; WAPB[2]*=-1.0;
   }
   if(RL>1)
   {
-    WAPC(0,0)*=-1.0; WAPC(1,0)*=-1.0; WAPC(2,0)*=-1.0;
+    WAPC[0]*=-1.0; WAPC[1]*=-1.0; WAPC[2]*=-1.0;
   }
 
-  g_values(one,0) = WAPB(0,0) + WAPC(0,0);
-  g_values(two,0) = WAPB(1,0) + WAPC(1,0);
-  g_values(three,0) = WAPB(2,0) + WAPC(2,0);
+  g_values[one] = WAPB[0] + WAPC[0];
+  g_values[two] = WAPB[1] + WAPC[1];
+  g_values[three] = WAPB[2] + WAPC[2];
 }
 
 void BuildBEMatrixBase::get_auto_g(
@@ -480,17 +523,29 @@ double BuildBEMatrixBase::do_radon_g(
 
   Vector centroid = (p1 + p2 + p3) / 3;
 
-  DenseMatrix g_coef(1, 7);
+  double g_coef[7];
   get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
 
   double g2 = 0;
-  for (int i=0; i<7; i++)   g2 = g2 + g_coef(0,i)*R_W(0,i);
+  for (int i=0; i<7; i++)   g2 = g2 + g_coef[i]*R_W(0,i);
 
   Vector aV = Cross(p2 - p1, p3 - p2)*0.5;
 
   return g2 * aV.length();
 }
 
+namespace
+{
+  // Radon's seven point rule on a triangle: the centroid and two rings of three points
+  // pulled towards the vertices by s and r.
+  const double sqrt15 = sqrt(15.0);
+  const double radonS = (1 - sqrt15) / 7;
+  const double radonR = (1 + sqrt15) / 7;
+  const double radonWeights[7] = { 9.0/40.0,
+    (155 + sqrt15) / 1200, (155 + sqrt15) / 1200, (155 + sqrt15) / 1200,
+    (155 - sqrt15) / 1200, (155 - sqrt15) / 1200, (155 - sqrt15) / 1200 };
+}
+
 class BuildBEMatrixBaseCompute : public BuildBEMatrixBase
 {
 public:
@@ -510,8 +565,108 @@ public:
   double,
   double,
   const std::vector<double>& );
+
+  // Everything the node loops need from a source triangle, gathered once so that the
+  // N x T inner loops neither go through VMesh nor allocate.
+  struct SourceTriangle
+  {
+    VMesh::index_type nodes[3];
+    Vector p[3];
+    Vector centroid;
+    // area * cruse weight * Radon weight, per vertex and Radon point (G only)
+    double weights[3][7];
+    // bem_sing for an observation point on each of the vertices (G only)
+    double singular[3][3];
+  };
+
+  static std::vector<Point> gather_points(VMesh* hsurf);
+  static std::vector<SourceTriangle> gather_triangles(VMesh* hsurf, const std::vector<double>* avInn);
+  static void triangle_g_values(const SourceTriangle& tri, const Vector& op, double g_values[3]);
+
+  template <class MatrixType, class RowFunction>
+  static void fill_rows(MatrixType& matrix, size_t nrows, RowFunction computeRow);
 };
 
+std::vector<Point> BuildBEMatrixBaseCompute::gather_points(VMesh* hsurf)
+{
+  std::vector<Point> points(numNodes(hsurf));
+  for (size_t i = 0; i < points.size(); ++i)
+    points[i] = hsurf->get_point(VMesh::Node::index_type(i));
+  return points;
+}
+
+std::vector<BuildBEMatrixBaseCompute::SourceTriangle> BuildBEMatrixBaseCompute::gather_triangles(VMesh* hsurf, const std::vector<double>* avInn)
+{
+  std::vector<SourceTriangle> triangles;
+  VMesh::Node::array_type nodes;
+  VMesh::Face::iterator fi, fie;
+  hsurf->begin(fi); hsurf->end(fie);
+  for (; fi != fie; ++fi)
+  {
+    hsurf->get_nodes(nodes, *fi);
+    SourceTriangle tri;
+    for (int i = 0; i < 3; ++i)
+    {
+      tri.nodes[i] = nodes[i];
+      tri.p[i] = Vector(hsurf->get_point(nodes[i]));
+    }
+    tri.centroid = (tri.p[0] + tri.p[1] + tri.p[2]) / 3.0;
+    triangles.push_back(tri);
+  }
+
+  if (avInn)
+  {
+    Parallel::For(0, triangles.size(), [&](size_t begin, size_t end)
+    {
+      DenseMatrix cruse_weights(3, 7);
+      for (auto t = begin; t < end; ++t)
+      {
+        auto& tri = triangles[t];
+        const double area = (*avInn)[t];
+        get_cruse_weights(tri.p[0], tri.p[1], tri.p[2], radonS, radonR, area, cruse_weights);
+        for (int i = 0; i < 3; ++i)
+        {
+          for (int k = 0; k < 7; ++k)
+            tri.weights[i][k] = area * cruse_weights(i,k) * radonWeights[k];
+          bem_sing(tri.p[0], tri.p[1], tri.p[2], i, tri.singular[i]);
+        }
+      }
+    });
+  }
+  return triangles;
+}
+
+void BuildBEMatrixBaseCompute::triangle_g_values(const SourceTriangle& tri, const Vector& op, double g_values[3])
+{
+  double g_coef[7];
+  get_g_coef(tri.p[0], tri.p[1], tri.p[2], op, radonS, radonR, tri.centroid, g_coef);
+  for (int i = 0; i < 3; ++i)
+  {
+    double value = 0;
+    for (int k = 0; k < 7; ++k)
+      value += tri.weights[i][k] * g_coef[k];
+    g_values[i] = value;
+  }
+}
+
+template <class MatrixType, class RowFunction>
+void BuildBEMatrixBaseCompute::fill_rows(MatrixType& matrix, size_t nrows, RowFunction computeRow)
+{
+  // Every row belongs to one observation node, so rows are independent and can be built
+  // concurrently; each is accumulated in a private buffer and added to the matrix once.
+  const auto ncols = static_cast<size_t>(matrix.cols());
+  Parallel::For(0, nrows, [&](size_t begin, size_t end)
+  {
+    std::vector<double> row(ncols);
+    for (auto ppi = static_cast<VMesh::index_type>(begin); ppi < static_cast<VMesh::index_type>(end); ++ppi)
+    {
+      std::fill(row.begin(), row.end(), 0.0);
+      computeRow(ppi, row);
+      matrix.row(ppi) += Eigen::Map<const Eigen::RowVectorXd>(row.data(), ncols);
+    }
+  });
+}
+
 void BuildBEMatrixBase::make_auto_G_allocate(VMesh* hsurf, DenseMatrixHandle &h_GG_)
 {
   auto nnodes = numNodes(hsurf);
@@ -532,66 +687,25 @@ void BuildBEMatrixBaseCompute::make_auto_G_compute(VMesh* hsurf, MatrixType& aut
   //const double mult = 1/(2*M_PI)*((out_cond - in_cond)/op_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);  // op_cond=out_cond for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-
-  hsurf->begin(fi); hsurf->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf->get_nodes(nodes, *fi);
-    Vector p1(hsurf->get_point(nodes[0]));
-    Vector p2(hsurf->get_point(nodes[1]));
-    Vector p3(hsurf->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-    hsurf->begin(ni); hsurf->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf->get_point(ppi));
-
-      if (ppi == nodes[0])       bem_sing(p1, p2, p3, 0, g_values);
-      else if (ppi == nodes[1])       bem_sing(p1, p2, p3, 1, g_values);
-      else if (ppi == nodes[2])       bem_sing(p1, p2, p3, 2, g_values);
-      else
-      {
-        get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+  const auto triangles = gather_triangles(hsurf, &avInn);
+  const auto points = gather_points(hsurf);
 
-        for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-        g_values = area * (cruse_weights * temp.transpose());
-      } // else
+  fill_rows(auto_G, points.size(), [&](VMesh::index_type ppi, std::vector<double>& row)
+  {
+    const Vector op(points[ppi]);
+    double g_values[3];
+    for (const auto& tri : triangles)
+    { //! find contributions from every triangle
+      const double* values = g_values;
+      if (ppi == tri.nodes[0])       values = tri.singular[0];
+      else if (ppi == tri.nodes[1])  values = tri.singular[1];
+      else if (ppi == tri.nodes[2])  values = tri.singular[2];
+      else                           triangle_g_values(tri, op, g_values);
 
       for (int i=0; i<3; ++i)
-        auto_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+        row[tri.nodes[i]] += values[i]*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_G_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_GG_)
@@ -613,60 +727,20 @@ void BuildBEMatrixBaseCompute::make_cross_G_compute(VMesh* hsurf1, VMesh* hsurf2
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
 
-  VMesh::Node::array_type nodes;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  DenseMatrix cruse_weights(3, 7);
-  DenseMatrix g_coef(1, 7);
-  DenseMatrix R_W(1,7); // Radon Points Weights
-  DenseMatrix temp(1,7);
-  DenseMatrix g_values(3, 1);
-
-  double area;
-
-  double sqrt15 = sqrt(15.0);
-  //R_W(0,0) = 9/40; // <- Burak! FIX ME!
-  R_W(0,0) = 9.0/40.0;
-  R_W(0,1) = (155 + sqrt15) / 1200;
-  R_W(0,2) = R_W(0,1);
-  R_W(0,3) = R_W(0,1);
-  R_W(0,4) = (155 - sqrt15) / 1200;
-  R_W(0,5) = R_W(0,4);
-  R_W(0,6) = R_W(0,4);
-
-  double s = (1 - sqrt15) / 7;
-  double r = (1 + sqrt15) / 7;
-
-  hsurf2->begin(fi); hsurf2->end(fie);
-  for (; fi != fie; ++fi)
-  { //! find contributions from every triangle
-    hsurf2->get_nodes(nodes, *fi);
-    Vector p1(hsurf2->get_point(nodes[0]));
-    Vector p2(hsurf2->get_point(nodes[1]));
-    Vector p3(hsurf2->get_point(nodes[2]));
-
-    area = avInn[*fi];
-
-    get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
-    Vector centroid = (p1 + p2 + p3) / 3.0;
-
-    hsurf1->begin(ni); hsurf1->end(nie);
-    for (; ni != nie; ++ni)
-    { //! for every node
-      VMesh::Node::index_type ppi = *ni;
-      Vector op(hsurf1->get_point(ppi));
-      get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
-
-      for (int i=0; i<7; i++)  temp(0,i) = g_coef(0,i)*R_W(0,i);
-
-      g_values = area * (cruse_weights * temp.transpose());
+  const auto triangles = gather_triangles(hsurf2, &avInn);
+  const auto points = gather_points(hsurf1);
 
+  fill_rows(cross_G, points.size(), [&](VMesh::index_type ppi, std::vector<double>& row)
+  {
+    const Vector op(points[ppi]);
+    double g_values[3];
+    for (const auto& tri : triangles)
+    { //! find contributions from every triangle
+      triangle_g_values(tri, op, g_values);
       for (int i=0; i<3; ++i)
-        cross_G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))+=g_values(i,0)*mult;
+        row[tri.nodes[i]] += g_values[i]*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_cross_P_allocate(VMesh* hsurf1, VMesh* hsurf2, DenseMatrixHandle &h_PP_)
@@ -686,32 +760,20 @@ void BuildBEMatrixBaseCompute::make_cross_P_compute(VMesh* hsurf1, VMesh* hsurf2
 {
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
   //   out_cond and in_cond belong to hsurf2 and op_cond is the out_cond of hsurf1 for all the surfaces but the outermost surface which in op_cond=in_cond
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-  int i;
-
-  VMesh::Node::iterator  ni, nie;
-  VMesh::Face::iterator  fi, fie;
-
-  hsurf1->begin(ni); hsurf1->end(nie);
-  for (; ni != nie; ++ni){ //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf1->get_point(ppi);
-
-    hsurf2->begin(fi); hsurf2->end(fie);
-    for (; fi != fie; ++fi){ //! find contributions from every triangle
-
-      hsurf2->get_nodes(nodes, *fi);
-      Vector v1 = hsurf2->get_point(nodes[0]) - pp;
-      Vector v2 = hsurf2->get_point(nodes[1]) - pp;
-      Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+  const auto triangles = gather_triangles(hsurf2, nullptr);
+  const auto points = gather_points(hsurf1);
 
-      getOmega(v1, v2, v3, coef);
-
-      for (i=0; i<3; ++i)
-        cross_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+  fill_rows(cross_P, points.size(), [&](VMesh::index_type ppi, std::vector<double>& row)
+  {
+    const Vector pp(points[ppi]);
+    double coef[3];
+    for (const auto& tri : triangles)
+    { //! find contributions from every triangle
+      getOmega(tri.p[0] - pp, tri.p[1] - pp, tri.p[2] - pp, coef);
+      for (int i=0; i<3; ++i)
+        row[tri.nodes[i]] -= coef[i]*mult;
     }
-  }
+  });
 }
 
 void BuildBEMatrixBase::make_auto_P_allocate(VMesh* hsurf, DenseMatrixHandle &h_PP_)
@@ -735,49 +797,28 @@ int BuildBEMatrixBase::numNodes(VMesh* hsurf)
 template <class MatrixType>
 void BuildBEMatrixBaseCompute::make_auto_P_compute(VMesh* hsurf, MatrixType& auto_P, double in_cond, double out_cond)
 {
-  auto nnodes = auto_P.rows();
   const double mult = 1/(4*M_PI)*(out_cond - in_cond);
 
-  VMesh::Node::array_type nodes;
-  DenseMatrix coef(1, 3);
-
-  VMesh::Node::iterator ni, nie;
-  VMesh::Face::iterator fi, fie;
-
-  unsigned int i;
-
-  hsurf->begin(ni); hsurf->end(nie);
-
-  for (; ni != nie; ++ni)
-  { //! for every node
-    VMesh::Node::index_type ppi = *ni;
-    Point pp = hsurf->get_point(ppi);
+  const auto triangles = gather_triangles(hsurf, nullptr);
+  const auto points = gather_points(hsurf);
 
-    hsurf->begin(fi); hsurf->end(fie);
-
-    for (; fi != fie; ++fi)
+  fill_rows(auto_P, points.size(), [&](VMesh::index_type ppi, std::vector<double>& row)
+  {
+    const Vector pp(points[ppi]);
+    double coef[3];
+    for (const auto& tri : triangles)
     { //! find contributions from every triangle
-      hsurf->get_nodes(nodes, *fi);
-      if (ppi!=nodes[0] && ppi!=nodes[1] && ppi!=nodes[2])
+      if (ppi!=tri.nodes[0] && ppi!=tri.nodes[1] && ppi!=tri.nodes[2])
       {
-        Vector v1 = hsurf->get_point(nodes[0]) - pp;
-        Vector v2 = hsurf->get_point(nodes[1]) - pp;
-        Vector v3 = hsurf->get_point(nodes[2]) - pp;
-
-        getOmega(v1, v2, v3, coef);
-
-        for (i=0; i<3; ++i)
-          auto_P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i]))-=coef(0,i)*mult;
+        getOmega(tri.p[0] - pp, tri.p[1] - pp, tri.p[2] - pp, coef);
+        for (int i=0; i<3; ++i)
+          row[tri.nodes[i]] -= coef[i]*mult;
       }
     }
-  }
 
-  //! accounting for autosolid angle
-  auto sumOfRows = auto_P.rowwise().sum().eval();
-  for (i=0; i<nnodes; ++i)
-  {
-    auto_P(i,i) = out_cond - sumOfRows(i);
-  }
+    //! accounting for autosolid angle
+    row[ppi] = out_cond - std::accumulate(row.begin(), row.end(), 0.0);
+  });
 }
 
 void BuildBEMatrixBase::make_auto_P(VMesh* hsurf, DenseMatrixHandle &h_PP_,
@@ -69,6 +69,15 @@ namespace SCIRun {
             const Geometry::Vector&,
             Datatypes::DenseMatrix&);
 
+          static void get_g_coef( const Geometry::Vector&,
+            const Geometry::Vector&,
+            const Geometry::Vector&,
+            const Geometry::Vector&,
+            double,
+            double,
+            const Geometry::Vector&,
+            double g_coef[7]);
+
           static void get_cruse_weights( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
@@ -82,6 +91,11 @@ namespace SCIRun {
             const Geometry::Vector&,
             Datatypes::DenseMatrix& );
 
+          static void getOmega( const Geometry::Vector&,
+            const Geometry::Vector&,
+            const Geometry::Vector&,
+            double coef[3] );
+
           static double do_radon_g( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector&,
@@ -105,6 +119,12 @@ namespace SCIRun {
             unsigned int,
             Datatypes::DenseMatrix& );
 
+          static void bem_sing( const Geometry::Vector&,
+            const Geometry::Vector&,
+            const Geometry::Vector&,
+            unsigned int,
+            double g_values[3] );
+
           static double get_new_auto_g( const Geometry::Vector&,
             const Geometry::Vector&,
             const Geometry::Vector& );
@@ -0,0 +1,270 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Forward/BuildBEMatrixAlgo.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Vector.h>
+#include <Core/Thread/Parallel.h>
+#include <map>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Algorithms::Forward;
+
+namespace
+{
+  // Octahedron refined by edge bisection and projected onto a sphere of the given radius.
+  FieldHandle sphereSurface(double radius, int refinements)
+  {
+    std::vector<Vector> points = { Vector(1,0,0), Vector(-1,0,0), Vector(0,1,0),
+      Vector(0,-1,0), Vector(0,0,1), Vector(0,0,-1) };
+    std::vector<std::array<int, 3>> faces = { {{0,2,4}}, {{2,1,4}}, {{1,3,4}}, {{3,0,4}},
+      {{2,0,5}}, {{1,2,5}}, {{3,1,5}}, {{0,3,5}} };
+
+    for (int level = 0; level < refinements; ++level)
+    {
+      std::map<std::pair<int, int>, int> midpoints;
+      auto midpoint = [&](int a, int b)
+      {
+        const auto key = std::make_pair(std::min(a, b), std::max(a, b));
+        auto it = midpoints.find(key);
+        if (it != midpoints.end())
+          return it->second;
+        auto m = points[a] + points[b];
+        m.normalize();
+        points.push_back(m);
+        return midpoints[key] = static_cast<int>(points.size()) - 1;
+      };
+      std::vector<std::array<int, 3>> refined;
+      for (const auto& f : faces)
+      {
+        const int a = midpoint(f[0], f[1]), b = midpoint(f[1], f[2]), c = midpoint(f[2], f[0]);
+        refined.push_back({{f[0], a, c}});
+        refined.push_back({{a, f[1], b}});
+        refined.push_back({{c, b, f[2]}});
+        refined.push_back({{a, b, c}});
+      }
+      faces.swap(refined);
+    }
+
+    FieldInformation fi(mesh_info_type::TRISURFMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::DOUBLE_E);
+    FieldHandle field = CreateField(fi);
+    auto mesh = field->vmesh();
+    for (const auto& p : points)
+      mesh->add_point(Point(radius * p));
+    for (const auto& f : faces)
+    {
+      VMesh::Node::array_type nodes(3);
+      for (int i = 0; i < 3; ++i)
+        nodes[i] = f[i];
+      mesh->add_elem(nodes);
+    }
+    return field;
+  }
+
+  // Exposes the BEM assembly and keeps the original one-triangle-at-a-time loops as the
+  // reference the parallel row assembly has to reproduce.
+  class BEMatrixAssembly : public BuildBEMatrixBase
+  {
+  public:
+    using BuildBEMatrixBase::make_auto_G;
+    using BuildBEMatrixBase::make_cross_G;
+    using BuildBEMatrixBase::make_auto_P;
+    using BuildBEMatrixBase::make_cross_P;
+    using BuildBEMatrixBase::pre_calc_tri_areas;
+
+    static DenseMatrix serialG(VMesh* hsurf1, VMesh* hsurf2, double in_cond, double out_cond,
+      const std::vector<double>& avInn)
+    {
+      const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+      const bool autoG = hsurf1 == hsurf2;
+      DenseMatrix G(numNodes(hsurf1), numNodes(hsurf2), 0.0);
+
+      DenseMatrix cruse_weights(3, 7), g_coef(1, 7), R_W(1, 7), temp(1, 7), g_values(3, 1);
+      const double sqrt15 = sqrt(15.0);
+      R_W(0,0) = 9.0/40.0;
+      R_W(0,1) = R_W(0,2) = R_W(0,3) = (155 + sqrt15) / 1200;
+      R_W(0,4) = R_W(0,5) = R_W(0,6) = (155 - sqrt15) / 1200;
+      const double s = (1 - sqrt15) / 7;
+      const double r = (1 + sqrt15) / 7;
+
+      VMesh::Node::array_type nodes;
+      VMesh::Node::iterator ni, nie;
+      VMesh::Face::iterator fi, fie;
+      hsurf2->begin(fi); hsurf2->end(fie);
+      for (; fi != fie; ++fi)
+      {
+        hsurf2->get_nodes(nodes, *fi);
+        Vector p1(hsurf2->get_point(nodes[0]));
+        Vector p2(hsurf2->get_point(nodes[1]));
+        Vector p3(hsurf2->get_point(nodes[2]));
+        const double area = avInn[*fi];
+        get_cruse_weights(p1, p2, p3, s, r, area, cruse_weights);
+        Vector centroid = (p1 + p2 + p3) / 3.0;
+
+        hsurf1->begin(ni); hsurf1->end(nie);
+        for (; ni != nie; ++ni)
+        {
+          VMesh::Node::index_type ppi = *ni;
+          Vector op(hsurf1->get_point(ppi));
+          if (autoG && ppi == nodes[0]) bem_sing(p1, p2, p3, 0, g_values);
+          else if (autoG && ppi == nodes[1]) bem_sing(p1, p2, p3, 1, g_values);
+          else if (autoG && ppi == nodes[2]) bem_sing(p1, p2, p3, 2, g_values);
+          else
+          {
+            get_g_coef(p1, p2, p3, op, s, r, centroid, g_coef);
+            for (int i = 0; i < 7; i++) temp(0,i) = g_coef(0,i)*R_W(0,i);
+            g_values = area * (cruse_weights * temp.transpose());
+          }
+          for (int i = 0; i < 3; ++i)
+            G(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i])) += g_values(i,0)*mult;
+        }
+      }
+      return G;
+    }
+
+    static DenseMatrix serialP(VMesh* hsurf1, VMesh* hsurf2, double in_cond, double out_cond)
+    {
+      const double mult = 1/(4*M_PI)*(out_cond - in_cond);
+      const bool autoP = hsurf1 == hsurf2;
+      DenseMatrix P(numNodes(hsurf1), numNodes(hsurf2), 0.0);
+      DenseMatrix coef(1, 3);
+
+      VMesh::Node::array_type nodes;
+      VMesh::Node::iterator ni, nie;
+      VMesh::Face::iterator fi, fie;
+      hsurf1->begin(ni); hsurf1->end(nie);
+      for (; ni != nie; ++ni)
+      {
+        VMesh::Node::index_type ppi = *ni;
+        Point pp = hsurf1->get_point(ppi);
+        hsurf2->begin(fi); hsurf2->end(fie);
+        for (; fi != fie; ++fi)
+        {
+          hsurf2->get_nodes(nodes, *fi);
+          if (autoP && (ppi == nodes[0] || ppi == nodes[1] || ppi == nodes[2]))
+            continue;
+          Vector v1 = hsurf2->get_point(nodes[0]) - pp;
+          Vector v2 = hsurf2->get_point(nodes[1]) - pp;
+          Vector v3 = hsurf2->get_point(nodes[2]) - pp;
+          getOmega(v1, v2, v3, coef);
+          for (int i = 0; i < 3; ++i)
+            P(static_cast<uint64_t>(ppi), static_cast<uint64_t>(nodes[i])) -= coef(0,i)*mult;
+        }
+      }
+
+      if (autoP)
+      {
+        auto sumOfRows = P.rowwise().sum().eval();
+        for (int i = 0; i < P.rows(); ++i)
+          P(i,i) = out_cond - sumOfRows(i);
+      }
+      return P;
+    }
+  };
+
+  void expectSameMatrix(const DenseMatrix& expected, const DenseMatrix& actual)
+  {
+    ASSERT_EQ(expected.rows(), actual.rows());
+    ASSERT_EQ(expected.cols(), actual.cols());
+    const double scale = expected.cwiseAbs().maxCoeff();
+    EXPECT_LE((expected - actual).cwiseAbs().maxCoeff(), 1e-12 * scale);
+  }
+
+  class BuildBEMatrixAssemblyTest : public ::testing::Test
+  {
+  protected:
+    void SetUp() override
+    {
+      outer_ = sphereSurface(1.0, 2);
+      inner_ = sphereSurface(0.5, 1);
+      BEMatrixAssembly::pre_calc_tri_areas(outer_->vmesh(), outerAreas_);
+      BEMatrixAssembly::pre_calc_tri_areas(inner_->vmesh(), innerAreas_);
+    }
+
+    FieldHandle outer_, inner_;
+    std::vector<double> outerAreas_, innerAreas_;
+    const double in_cond = 1.0, out_cond = 0.2;
+  };
+}
+
+TEST_F(BuildBEMatrixAssemblyTest, AutoGMatchesSerialAssembly)
+{
+  DenseMatrixHandle G;
+  BEMatrixAssembly::make_auto_G(outer_->vmesh(), G, in_cond, out_cond, outerAreas_);
+  expectSameMatrix(BEMatrixAssembly::serialG(outer_->vmesh(), outer_->vmesh(), in_cond, out_cond, outerAreas_), *G);
+}
+
+TEST_F(BuildBEMatrixAssemblyTest, CrossGMatchesSerialAssembly)
+{
+  DenseMatrixHandle G;
+  BEMatrixAssembly::make_cross_G(outer_->vmesh(), inner_->vmesh(), G, in_cond, out_cond, innerAreas_);
+  expectSameMatrix(BEMatrixAssembly::serialG(outer_->vmesh(), inner_->vmesh(), in_cond, out_cond, innerAreas_), *G);
+}
+
+TEST_F(BuildBEMatrixAssemblyTest, AutoPMatchesSerialAssembly)
+{
+  DenseMatrixHandle P;
+  BEMatrixAssembly::make_auto_P(outer_->vmesh(), P, in_cond, out_cond);
+  expectSameMatrix(BEMatrixAssembly::serialP(outer_->vmesh(), outer_->vmesh(), in_cond, out_cond), *P);
+}
+
+TEST_F(BuildBEMatrixAssemblyTest, CrossPMatchesSerialAssembly)
+{
+  DenseMatrixHandle P;
+  BEMatrixAssembly::make_cross_P(inner_->vmesh(), outer_->vmesh(), P, in_cond, out_cond);
+  expectSameMatrix(BEMatrixAssembly::serialP(inner_->vmesh(), outer_->vmesh(), in_cond, out_cond), *P);
+}
+
+TEST_F(BuildBEMatrixAssemblyTest, AssemblyDoesNotDependOnCoreCount)
+{
+  auto assemble = [this]()
+  {
+    DenseMatrixHandle autoG, crossG, autoP, crossP;
+    BEMatrixAssembly::make_auto_G(outer_->vmesh(), autoG, in_cond, out_cond, outerAreas_);
+    BEMatrixAssembly::make_cross_G(outer_->vmesh(), inner_->vmesh(), crossG, in_cond, out_cond, innerAreas_);
+    BEMatrixAssembly::make_auto_P(outer_->vmesh(), autoP, in_cond, out_cond);
+    BEMatrixAssembly::make_cross_P(inner_->vmesh(), outer_->vmesh(), crossP, in_cond, out_cond);
+    return std::vector<DenseMatrixHandle>{ autoG, crossG, autoP, crossP };
+  };
+
+  Parallel::SetMaximumCores(1);
+  const auto serial = assemble();
+  Parallel::SetMaximumCores(0);
+  const auto parallel = assemble();
+
+  // every entry is summed over its triangles in the same order whichever thread owns the row
+  for (size_t m = 0; m < serial.size(); ++m)
+    EXPECT_EQ(0.0, (*serial[m] - *parallel[m]).cwiseAbs().maxCoeff()) << "matrix " << m;
+}
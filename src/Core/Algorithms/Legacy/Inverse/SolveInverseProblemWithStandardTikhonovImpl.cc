@@ -40,6 +40,11 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 
 #include <Core/Utils/Exception.h>
+#include <Core/Thread/Parallel.h>
+
+#include <Eigen/Eigenvalues>
+#include <algorithm>
+#include <cmath>
 
 using namespace SCIRun;
 using namespace Core;
@@ -90,6 +95,92 @@ using namespace Inverse;
 //////// fi compute inverse solution
 ////////////////////////
 
+/////////////////////////
+///////// compute L-curve
+    void SolveInverseProblemWithStandardTikhonovImpl::computeLcurvePoints(const std::vector<double>& lambdaArray,
+        const DenseMatrix& forwardMatrix, const DenseMatrix& measuredData,
+        const DenseMatrix* sourceWeighting, const DenseMatrix* sensorWeighting,
+        std::vector<double>& rho, std::vector<double>& eta) const
+    {
+        //............................
+        //  OPERATIONS PERFORMED IN THIS SECTION:
+        //      G = M1 + lambda^2 * M2 is factored once with the generalized eigendecomposition
+        //      M1 * V = M2 * V * D, V^T * M2 * V = I, so that for every lambda
+        //
+        //      G^-1 = V * S * V^T,  S = (D + lambda^2)^-1
+        //      x = M3 * V * S * V^T * y = X0 * S * Y,   X0 = M3 * V,  Y = V^T * y
+        //
+        //      eta^2 = || R * X0 * S * Y ||^2 = s^T * ((X0^T R^T R X0) .* (Y Y^T)) * s
+        //      rho   = || C * A * X0 * S * Y - C * b ||
+        //
+        //      The time samples only enter through Y and C*b. They are compressed with a QR
+        //      decomposition of [Y; C*b]^T, so the cost per lambda does not depend on them.
+        //...........................................................................................................
+        const size_t nLambda = lambdaArray.size();
+        rho.assign(nLambda, 0.0);
+        eta.assign(nLambda, 0.0);
+        if (nLambda == 0) return;
+
+        Eigen::GeneralizedSelfAdjointEigenSolver<Eigen::MatrixXd> eigen(M1, M2);
+        if (eigen.info() != Eigen::Success)
+        {
+          // fall back on one solve per lambda
+          TikhonovImpl::computeLcurvePoints(lambdaArray, forwardMatrix, measuredData, sourceWeighting, sensorWeighting, rho, eta);
+          return;
+        }
+
+        // M1 is positive semi-definite, do not let round off push eigenvalues below zero
+        const Eigen::VectorXd d = eigen.eigenvalues().cwiseMax(0.0);
+        const Eigen::MatrixXd& V = eigen.eigenvectors();
+        const int k = static_cast<int>(d.size());
+
+        const Eigen::MatrixXd X0 = M3 * V;
+        const Eigen::MatrixXd Y = V.transpose() * y;
+
+        Eigen::MatrixXd RX0 = sourceWeighting ? Eigen::MatrixXd((*sourceWeighting) * X0) : X0;
+        const Eigen::MatrixXd weightedGram = (RX0.transpose() * RX0).cwiseProduct(Y * Y.transpose());
+        RX0.resize(0, 0);
+
+        Eigen::MatrixXd CAX0 = forwardMatrix * X0;
+        Eigen::MatrixXd Cb = measuredData;
+        if (sensorWeighting)
+        {
+          CAX0 = (*sensorWeighting) * CAX0;
+          Cb = (*sensorWeighting) * Cb;
+        }
+
+        // [Yc; Cbc] has the same row space as [Y; C*b] with at most k + M columns
+        const int numRows = k + static_cast<int>(Cb.rows());
+        Eigen::MatrixXd YCb(numRows, Y.cols());
+        YCb << Y, Cb;
+        if (YCb.cols() > numRows)
+        {
+          Eigen::HouseholderQR<Eigen::MatrixXd> qr(YCb.transpose());
+          YCb = qr.matrixQR().topRows(numRows).triangularView<Eigen::Upper>().transpose();
+        }
+        const Eigen::MatrixXd Yc = YCb.topRows(k);
+        const Eigen::MatrixXd Cbc = YCb.bottomRows(Cb.rows());
+
+        Core::Thread::Parallel::For(0, nLambda, [&](size_t begin, size_t end)
+        {
+          Eigen::VectorXd s(k);
+          Eigen::MatrixXd residual;
+          for (size_t j = begin; j < end; j++)
+          {
+            const double lambda2 = lambdaArray[j] * lambdaArray[j];
+            for (int i = 0; i < k; i++)
+              s[i] = 1.0 / (d[i] + lambda2);
+
+            eta[j] = std::sqrt(std::max(0.0, s.dot(weightedGram * s)));
+            residual.noalias() = CAX0 * s.asDiagonal() * Yc;
+            residual -= Cbc;
+            rho[j] = residual.norm();
+          }
+        });
+    }
+//////// fi compute L-curve
+////////////////////////
+
 /////// precomputeInverseMatrices
 ///////////////
     void SolveInverseProblemWithStandardTikhonovImpl::preAllocateInverseMatrices(const DenseMatrix& forwardMatrix, const
@@ -72,6 +72,12 @@ namespace Core {
             int regularizationResidualSubcase);
 
         Datatypes::DenseMatrix computeInverseSolution(double lambda, bool inverseCalculation) const override;
+        void computeLcurvePoints(const std::vector<double>& lambdaArray,
+            const Datatypes::DenseMatrix& forwardMatrix,
+            const Datatypes::DenseMatrix& measuredData,
+            const Datatypes::DenseMatrix* sourceWeighting,
+            const Datatypes::DenseMatrix* sensorWeighting,
+            std::vector<double>& rho, std::vector<double>& eta) const override;
       };
     }
   }
@@ -0,0 +1,104 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+
+#include <Core/Algorithms/Legacy/Inverse/SolveInverseProblemWithStandardTikhonovImpl.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <random>
+
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Algorithms::Inverse;
+
+namespace
+{
+  DenseMatrix randomMatrix(int rows, int cols, unsigned seed)
+  {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> entry(-1.0, 1.0);
+    DenseMatrix m(rows, cols);
+    for (int i = 0; i < rows; ++i)
+      for (int j = 0; j < cols; ++j)
+        m(i, j) = entry(gen);
+    return m;
+  }
+
+  // Compares the L-curve of the standard Tikhonov implementation with the
+  // residual and solution norms of one solve per lambda.
+  void expectLcurveMatchesSolves(int measurements, int unknowns, int timeSamples,
+    TikhonovAlgoAbstractBase::AlgorithmChoice choice, bool weighted)
+  {
+    const DenseMatrix forward = randomMatrix(measurements, unknowns, 1);
+    const DenseMatrix measured = randomMatrix(measurements, timeSamples, 2);
+    const DenseMatrix sourceWeighting = randomMatrix(unknowns, unknowns, 3);
+    const DenseMatrix sensorWeighting = randomMatrix(measurements, measurements, 4);
+
+    SolveInverseProblemWithStandardTikhonovImpl standard(forward, measured,
+      sourceWeighting, sensorWeighting, choice, 0, 0);
+    const TikhonovImpl& impl = standard;
+
+    const std::vector<double> lambdas = { 1e-3, 3e-2, 0.5, 1.0, 7.0, 100.0 };
+    std::vector<double> rho, eta;
+    impl.computeLcurvePoints(lambdas, forward, measured,
+      weighted ? &sourceWeighting : nullptr, weighted ? &sensorWeighting : nullptr, rho, eta);
+    ASSERT_EQ(lambdas.size(), rho.size());
+    ASSERT_EQ(lambdas.size(), eta.size());
+
+    for (size_t j = 0; j < lambdas.size(); ++j)
+    {
+      const DenseMatrix solution = impl.computeInverseSolution(lambdas[j], false);
+      ASSERT_EQ(unknowns, solution.rows());
+      ASSERT_EQ(timeSamples, solution.cols());
+      const DenseMatrix residual = forward * solution - measured;
+      const double expectedRho = weighted ? (sensorWeighting * residual).norm() : residual.norm();
+      const double expectedEta = weighted ? (sourceWeighting * solution).norm() : solution.norm();
+      EXPECT_NEAR(expectedRho, rho[j], 1e-8 * std::max(1.0, expectedRho)) << "lambda " << lambdas[j];
+      EXPECT_NEAR(expectedEta, eta[j], 1e-8 * std::max(1.0, expectedEta)) << "lambda " << lambdas[j];
+    }
+  }
+}
+
+TEST(TikhonovLcurveTests, UnderdeterminedMatchesSolvePerLambda)
+{
+  expectLcurveMatchesSolves(6, 15, 1, TikhonovAlgoAbstractBase::AlgorithmChoice::automatic, false);
+  expectLcurveMatchesSolves(6, 15, 1, TikhonovAlgoAbstractBase::AlgorithmChoice::automatic, true);
+}
+
+TEST(TikhonovLcurveTests, OverdeterminedMatchesSolvePerLambda)
+{
+  expectLcurveMatchesSolves(14, 5, 1, TikhonovAlgoAbstractBase::AlgorithmChoice::automatic, false);
+  expectLcurveMatchesSolves(14, 5, 1, TikhonovAlgoAbstractBase::AlgorithmChoice::automatic, true);
+}
+
+// More time samples than k + M rows, so the samples are compressed with a QR
+TEST(TikhonovLcurveTests, SeveralTimeSamplesMatchSolvePerLambda)
+{
+  expectLcurveMatchesSolves(6, 15, 40, TikhonovAlgoAbstractBase::AlgorithmChoice::underdetermined, true);
+  expectLcurveMatchesSolves(14, 5, 40, TikhonovAlgoAbstractBase::AlgorithmChoice::overdetermined, true);
+  expectLcurveMatchesSolves(8, 8, 3, TikhonovAlgoAbstractBase::AlgorithmChoice::automatic, false);
+}
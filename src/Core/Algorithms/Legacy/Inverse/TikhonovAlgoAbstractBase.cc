@@ -313,54 +313,27 @@ double TikhonovAlgoAbstractBase::computeLcurve(
   lambdamatrix.reset(new DenseMatrix(nLambda, 3, 0.0));
 
   auto lambdaArray = algoImpl.computeLambdaArray(lambdaMin, lambdaMax, nLambda);
+  lambdaArray[0] = lambdaMin;
 
-  DenseMatrix CAx, Rx;
-  DenseMatrix solution;
+  auto forward = castMatrix::toDense(forwardMatrix);
+  auto measured = castMatrix::toDense(measuredData);
+  auto sourceW = sourceWeighting ? castMatrix::toDense(sourceWeighting) : nullptr;
+  auto sensorW = sensorWeighting ? castMatrix::toDense(sensorWeighting) : nullptr;
 
-  lambdaArray[0] = lambdaMin;
+  // check that regularization matrix and solution match sizes
+  if (sourceW && sourceW->ncols() != forward->ncols())
+  {
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
+                          << ErrorMessage(" Solution weighting matrix unexpectedly does not "
+                                          "fit to compute the weighted solution norm. "));
+  }
+
+  // compute rho and eta for all lambdas at once
+  algoImpl.computeLcurvePoints(lambdaArray, *forward, *measured, sourceW.get(), sensorW.get(), rho, eta);
 
-  // for all lambdas
   for (int j = 0; j < nLambda; j++)
   {
-    solution = algoImpl.computeInverseSolution(lambdaArray[j], false);
     lambdamatrix->put(j, 0, lambdaArray[j]);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sourceWeighting)
-    {
-      if (solution.nrows() ==
-          sourceWeighting->ncols())  // check that regularization matrix and solution match sizes
-      {
-        auto sw = castMatrix::toDense(sourceWeighting);
-        Rx = (*sw) * solution;
-      }
-      else
-      {
-        BOOST_THROW_EXCEPTION(AlgorithmProcessingException()
-                              << ErrorMessage(" Solution weighting matrix unexpectedly does not "
-                                              "fit to compute the weighted solution norm. "));
-      }
-    }
-    else
-      Rx = solution;
-
-    auto forward = castMatrix::toDense(forwardMatrix);
-    auto Ax = (*forward) * solution;
-    auto measured = castMatrix::toDense(measuredData);
-    auto residualSolution = Ax - (*measured);
-
-    // if using source regularization matrix, apply it to compute Rx (for the eta computations)
-    if (sensorWeighting)
-    {
-      auto sw = castMatrix::toDense(sensorWeighting);
-      CAx = (*sw) * residualSolution;
-    }
-    else
-      CAx = residualSolution;
-
-    // compute rho and eta. Using Frobenious norm when using matrices
-    rho[j] = CAx.norm();
-    eta[j] = Rx.norm();
     lambdamatrix->put(j, 1, rho[j]);
     lambdamatrix->put(j, 2, eta[j]);
   }
@@ -30,6 +30,7 @@
 
 
 #include <Core/Algorithms/Legacy/Inverse/TikhonovImpl.h>
+#include <Core/Thread/Parallel.h>
 
 
 	// default lambda step. Can ve overriden if necessary (see TSVD as reference)
@@ -46,3 +47,29 @@
 
 		return lambdaArray;
 	}
+
+	// default L-curve: one solve per lambda, lambdas spread over the cores
+	void SCIRun::Core::Algorithms::Inverse::TikhonovImpl::computeLcurvePoints( const std::vector<double>& lambdaArray,
+		const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix,
+		const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+		const SCIRun::Core::Datatypes::DenseMatrix* sourceWeighting,
+		const SCIRun::Core::Datatypes::DenseMatrix* sensorWeighting,
+		std::vector<double>& rho, std::vector<double>& eta ) const
+	{
+		using SCIRun::Core::Datatypes::DenseMatrix;
+		rho.assign(lambdaArray.size(), 0.0);
+		eta.assign(lambdaArray.size(), 0.0);
+
+		SCIRun::Core::Thread::Parallel::For(0, lambdaArray.size(), [&](size_t begin, size_t end)
+		{
+			for (size_t j = begin; j < end; j++)
+			{
+				const DenseMatrix solution = computeInverseSolution(lambdaArray[j], false);
+				const DenseMatrix residual = forwardMatrix * solution - measuredData;
+
+				// Using Frobenius norms when the data has several time samples
+				rho[j] = sensorWeighting ? ((*sensorWeighting) * residual).norm() : residual.norm();
+				eta[j] = sourceWeighting ? ((*sourceWeighting) * solution).norm() : solution.norm();
+			}
+		}, 1);
+	}
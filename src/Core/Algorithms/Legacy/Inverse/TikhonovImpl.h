@@ -57,6 +57,16 @@ namespace Inverse {
 		// default lambda step. Can ve overriden if necessary (see TSVD as reference)
 		virtual std::vector<double> computeLambdaArray( double lambdaMin, double lambdaMax, int nLambda ) const;
 
+		// L-curve points for every lambda: rho is the residual norm and eta the solution norm, each
+		// weighted when the weighting matrix is given. The default solves for every lambda in
+		// parallel. Override it when all solutions follow from one factorization.
+		virtual void computeLcurvePoints( const std::vector<double>& lambdaArray,
+			const SCIRun::Core::Datatypes::DenseMatrix& forwardMatrix,
+			const SCIRun::Core::Datatypes::DenseMatrix& measuredData,
+			const SCIRun::Core::Datatypes::DenseMatrix* sourceWeighting,
+			const SCIRun::Core::Datatypes::DenseMatrix* sensorWeighting,
+			std::vector<double>& rho, std::vector<double>& eta ) const;
+
 	};
 
 	}}}}
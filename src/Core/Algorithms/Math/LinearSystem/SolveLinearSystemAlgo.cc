@@ -33,27 +33,32 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
+#include <numeric>
 
 using namespace SCIRun::Core::Algorithms;
 using namespace SCIRun::Core::Algorithms::Math;
 using namespace SCIRun::Core::Datatypes;
 
+ALGORITHM_PARAMETER_DEF(Math, MixedPrecision);
+
 SolveLinearSystemAlgo::SolveLinearSystemAlgo()
 {
   // For solver
-  addOption(Variables::Method,"cg","jacobi|cg|bicg|minres");
-  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi");
+  addOption(Variables::Method,"cg","jacobi|cg|pipecg|bicg|minres");
+  addOption(Variables::Preconditioner,"Jacobi","None|Jacobi|AMG|IC0|ILU0");
 
   addParameter(Variables::TargetError, 1e-5);
   addParameter(Variables::MaxIterations, 500);
 
   addParameter(Variables::BuildConvergence, true);
+  addParameter(Parameters::MixedPrecision, false);
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
   // for callback
@@ -79,9 +84,19 @@ public:
             DenseColumnMatrixHandle x0, DenseColumnMatrixHandle& x,
             DenseColumnMatrixHandle& convergence) const;
 protected:
+  // z = M^-1 r, with the diagonal vector for None and Jacobi
+  void precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+    ParallelLinearAlgebra::ParallelVector& diag, ParallelLinearAlgebra::ParallelVector& z) const;
+  void precondition_transpose(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+    ParallelLinearAlgebra::ParallelVector& diag, ParallelLinearAlgebra::ParallelVector& z) const;
+  virtual bool needs_transpose() const { return false; }
+  // Reduced precision copy of the matrix, for the solvers that iterate with one
+  virtual CompactSparseMatrixHandle compact_matrix(const SparseRowMatrix&) const { return nullptr; }
+
   const AlgorithmBase* algo_;
   std::string pre_conditioner_;
   DenseColumnMatrixHandle convergence_;
+  mutable ParallelPreconditionerHandle preconditioner_;
 };
 
 SolveLinearSystemParallelAlgo::SolveLinearSystemParallelAlgo(const AlgorithmBase* base) : algo_(base),
@@ -99,6 +114,7 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
   matrices.A = a;
   matrices.b = b;
   matrices.x0 = x0;
+  matrices.Af = compact_matrix(*a);
 
   // Create output matrix
   auto size = x0->nrows();
@@ -115,7 +131,12 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
   algo->set_handle("convergence", convergence);
 #endif
 
-  if(!start_parallel(matrices))
+  // Factorizations and the multigrid hierarchy are built once, outside the solver threads
+  preconditioner_ = makeParallelPreconditioner(pre_conditioner_, *a, needs_transpose());
+
+  const bool success = start_parallel(matrices);
+  preconditioner_.reset();
+  if (!success)
   {
     const std::string msg = "Encountered an error while running parallel linear algebra";
     algo_->error(msg);
@@ -125,6 +146,24 @@ SolveLinearSystemParallelAlgo::run(SparseRowMatrixHandle a, DenseColumnMatrixHan
   return (true);
 }
 
+void SolveLinearSystemParallelAlgo::precondition(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& diag, ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->apply(PLA, r, z);
+  else
+    PLA.mult(r, diag, z);
+}
+
+void SolveLinearSystemParallelAlgo::precondition_transpose(ParallelLinearAlgebra& PLA, const ParallelLinearAlgebra::ParallelVector& r,
+  ParallelLinearAlgebra::ParallelVector& diag, ParallelLinearAlgebra::ParallelVector& z) const
+{
+  if (preconditioner_)
+    preconditioner_->applyTranspose(PLA, r, z);
+  else
+    PLA.mult(r, diag, z);
+}
+
 //------------------------------------------------------------------
 // CG Solver with simple preconditioner
 
@@ -256,8 +295,16 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       return true;
     }
 
-    PLA.mult(R,DIAG,Z);
-    double bknum = PLA.dot(Z,R);
+    double bknum;
+    if (preconditioner_)
+    {
+      precondition(PLA,R,DIAG,Z);
+      bknum = PLA.dot(Z,R);
+    }
+    else
+    {
+      bknum = PLA.mult_dot(R,DIAG,Z);
+    }
 
     if (niter == 0)
     {
@@ -268,16 +315,13 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
       double bk = bknum/bkden;
       PLA.scale_add(bk,P,Z,P);
     }
-    PLA.mult(A,P,Z);
+    double akden = PLA.mult_dot(A,P,Z);
     bkden = bknum;
 
-    double akden = PLA.dot(Z,P);
     double ak=bknum/akden;
 
     PLA.scale_add(ak,P,X,X);
-    PLA.scale_add(-ak,Z,R,R);
-
-    error = PLA.norm(R)/bnorm;
+    error = PLA.scale_add_norm(-ak,Z,R,R)/bnorm;
     if (error < xmin)
     {
       PLA.copy(X,XMIN);
@@ -338,6 +382,406 @@ bool SolveLinearSystemCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs&
 }
 
 
+//------------------------------------------------------------------
+// Mixed precision CG with iterative refinement. The inner iterations solve
+// A*d = r with a copy of A that has float values and 32 bit indices, which
+// halves the bytes a matrix product reads. After each inner solve the
+// residual is recomputed with the double matrix and x is corrected, so the
+// result reaches double accuracy unless A is too ill conditioned for its
+// float copy to reduce the error any further.
+
+class SolveLinearSystemMixedCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemMixedCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+  protected:
+    CompactSparseMatrixHandle compact_matrix(const SparseRowMatrix& a) const override
+    {
+      return makeShared<CompactSparseMatrix>(a);
+    }
+  private:
+    // Residual reduction of an inner solve, a few digits above float precision
+    static constexpr double InnerReduction = 1e-4;
+    // A refinement step that does not reduce the error by at least this factor
+    // means the float matrix is no longer accurate enough
+    static constexpr double StagnationFactor = 0.9;
+};
+
+bool SolveLinearSystemMixedCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelCompactMatrix AF;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, S, D, Z, P, Q;
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_matrix(matrices.Af, AF) ||
+       !PLA.add_vector(matrices.b, B) ||
+       !PLA.add_vector(matrices.x0, X0) ||
+       !PLA.add_vector(matrices.x, XMIN))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  if ( !PLA.new_vector(X) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(R) ||
+       !PLA.new_vector(S) ||
+       !PLA.new_vector(D) ||
+       !PLA.new_vector(Z) ||
+       !PLA.new_vector(P) ||
+       !PLA.new_vector(Q))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(X0,X);
+  PLA.copy(X0,XMIN);
+
+  // Build a preconditioner
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  double bnorm = PLA.norm(B);
+  double error = PLA.norm(R)/bnorm;
+  double xmin = error;
+  double orig = error;
+
+  if (error <= tolerance)
+  {
+    if (PLA.first())
+    {
+      std::ostringstream ostr;
+      ostr << "Solver found solution with error = " << error;
+      algo_->remark(ostr.str());
+    }
+    PLA.wait();
+    return (true);
+  }
+
+  double log_orig = log(orig);
+  double log_scale = log_orig - log(tolerance);
+
+  int cnt = 0;
+  int nrefine = 0;
+  bool stagnated = false;
+
+  while (niter < max_iter && error > tolerance && !stagnated)
+  {
+    // Inner solve of A*D = R in reduced precision; the last one only needs
+    // to reach the target error
+    const double inner_tolerance = std::max(InnerReduction, 0.5*tolerance/error);
+    const double rnorm = error*bnorm;
+    PLA.zeros(D);
+    PLA.copy(R,S);
+
+    double bkden = 0.0;
+    for (int k = 0; niter < max_iter; ++k)
+    {
+      double bknum;
+      if (preconditioner_)
+      {
+        PLA.wait();
+        preconditioner_->apply(PLA,S,Z);
+        bknum = PLA.dot(Z,S);
+      }
+      else
+      {
+        bknum = PLA.mult_dot(S,DIAG,Z);
+      }
+
+      if (k == 0)
+        PLA.copy(Z,P);
+      else
+        PLA.scale_add(bknum/bkden,P,Z,P);
+
+      double akden = PLA.mult_dot(AF,P,Q);
+      bkden = bknum;
+      double ak = bknum/akden;
+
+      PLA.scale_add(ak,P,D,D);
+      const double inner = PLA.scale_add_norm(-ak,Q,S,S)/rnorm;
+
+      if (PLA.first())
+        (*convergence_)[niter] = std::min(xmin, error*inner);
+      niter++;
+
+      cnt++;
+      if (cnt == 20)
+      {
+        cnt = 0;
+        algo_->update_progress((log_orig-log(error*inner))/log_scale);
+      }
+
+      if (inner <= inner_tolerance)
+        break;
+    }
+
+    // Refinement in double precision
+    PLA.add(D,X,X);
+    PLA.mult(A,X,R);
+    PLA.sub(B,R,R);
+    const double previous = error;
+    error = PLA.norm(R)/bnorm;
+    nrefine++;
+
+    if (error < xmin)
+    {
+      PLA.copy(X,XMIN);
+      xmin = error;
+    }
+    stagnated = error > StagnationFactor*previous;
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    if (xmin <= tolerance)
+      ostr << "Solver converged after " << niter << " iterations and " << nrefine << " refinement steps with error " << xmin;
+    else if (stagnated)
+      ostr << "Solver stopped after " << niter << " iterations: reduced precision refinement stagnated at error " << xmin;
+    else
+      ostr << "Solver stopped after " << niter << " iterations. Error was " << xmin;
+    algo_->remark(ostr.str());
+  }
+  PLA.wait();
+
+  return (true);
+}
+
+//------------------------------------------------------------------
+// Pipelined CG (Ghysels and Vanroose) with simple preconditioner.
+// The recurrences are rearranged so that the dot products of an iteration
+// and the vectors needed by its matrix product are published by the same
+// reduction: with None or Jacobi preconditioning an iteration has a single
+// synchronization point instead of the three of CG. It needs more vectors
+// and its recursive residual can drift, so convergence is confirmed with
+// the true residual and the recurrences restart if that fails.
+
+class SolveLinearSystemPipelinedCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemPipelinedCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+};
+
+bool SolveLinearSystemPipelinedCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelVector B, X, X0, XMIN, DIAG, R, U, W, N, Z, Q, S, P;
+  ParallelLinearAlgebra::ParallelVector M[2];
+
+  double tolerance =     algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =      algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_vector(matrices.b, B) ||
+       !PLA.add_vector(matrices.x0, X0) ||
+       !PLA.add_vector(matrices.x, XMIN))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  if ( !PLA.new_vector(X) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(R) ||
+       !PLA.new_vector(U) ||
+       !PLA.new_vector(W) ||
+       !PLA.new_vector(M[0]) ||
+       !PLA.new_vector(M[1]) ||
+       !PLA.new_vector(N) ||
+       !PLA.new_vector(Z) ||
+       !PLA.new_vector(Q) ||
+       !PLA.new_vector(S) ||
+       !PLA.new_vector(P))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  PLA.copy(X0,X);
+  PLA.copy(X0,XMIN);
+
+  // Build a preconditioner
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+
+  // M may alias neither input; the preconditioner reads rows of all threads
+  auto apply_preconditioner = [&](const ParallelLinearAlgebra::ParallelVector& in, ParallelLinearAlgebra::ParallelVector& out)
+  {
+    if (preconditioner_)
+    {
+      PLA.wait();
+      preconditioner_->apply(PLA,in,out);
+    }
+    else
+    {
+      PLA.mult(in,DIAG,out);
+    }
+  };
+
+  PLA.mult(A,X,R);
+  PLA.sub(B,R,R);
+
+  double bnorm = PLA.norm(B);
+  double error = PLA.norm(R)/bnorm;
+  double xmin = error;
+  double orig = error;
+
+  if (error <= tolerance)
+  {
+    if (PLA.first())
+    {
+      std::ostringstream ostr;
+      ostr << "Solver found solution with error = " << error;
+      algo_->remark(ostr.str());
+    }
+    PLA.wait();
+    return (true);
+  }
+
+  double log_orig = log(orig);
+  double log_scale = log_orig - log(tolerance);
+
+  bool restart = true;
+  int parity = 0;
+  int cnt = 0;
+  double gammaold = 0.0, alphaold = 0.0;
+
+  while (niter < max_iter)
+  {
+    if (restart)
+    {
+      apply_preconditioner(R,U);
+      PLA.mult(A,U,W);
+    }
+
+    double sums[3] = { PLA.local_dot(R,U), PLA.local_dot(W,U), PLA.local_dot(R,R) };
+    auto& Mcur = M[parity];
+    apply_preconditioner(W,Mcur);
+    // The only synchronization: it completes the sums and makes Mcur visible
+    PLA.reduce_sum(sums,3);
+
+    const double gamma = sums[0];
+    const double delta = sums[1];
+    error = sqrt(sums[2])/bnorm;
+
+    if (error < xmin)
+    {
+      PLA.copy(X,XMIN);
+      xmin = error;
+    }
+
+    if (error <= tolerance)
+    {
+      // Confirm with the true residual, and restart the recurrences from it if they drifted
+      PLA.mult(A,X,R);
+      PLA.sub(B,R,R);
+      error = PLA.norm(R)/bnorm;
+      if (error <= tolerance)
+      {
+        PLA.copy(X,XMIN);
+        if (PLA.first())
+        {
+          std::ostringstream ostr;
+          ostr << "Solver converged after " << niter << " iterations with error " << error;
+          algo_->remark(ostr.str());
+        }
+        PLA.wait();
+        return (true);
+      }
+      restart = true;
+      continue;
+    }
+
+    PLA.mult_nowait(A,Mcur,N);
+
+    double beta, alpha;
+    if (restart)
+    {
+      beta = 0.0;
+      alpha = gamma/delta;
+      PLA.copy(N,Z);
+      PLA.copy(Mcur,Q);
+      PLA.copy(W,S);
+      PLA.copy(U,P);
+    }
+    else
+    {
+      beta = gamma/gammaold;
+      alpha = gamma/(delta - beta*gamma/alphaold);
+      PLA.scale_add(beta,Z,N,Z);
+      PLA.scale_add(beta,Q,Mcur,Q);
+      PLA.scale_add(beta,S,W,S);
+      PLA.scale_add(beta,P,U,P);
+    }
+
+    PLA.scale_add(alpha,P,X,X);
+    PLA.scale_add(-alpha,S,R,R);
+    PLA.scale_add(-alpha,Q,U,U);
+    PLA.scale_add(-alpha,Z,W,W);
+
+    gammaold = gamma;
+    alphaold = alpha;
+    restart = false;
+    parity = 1 - parity;
+
+    if (PLA.first())
+      (*convergence_)[niter] = xmin;
+    niter++;
+
+    cnt++;
+    if (cnt == 20)
+    {
+      cnt = 0;
+      algo_->update_progress((log_orig-log(error))/log_scale);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Solver stopped after " << niter << " iterations. Error was " << xmin;
+    algo_->remark(ostr.str());
+  }
+  PLA.wait();
+
+  return (true);
+}
+
 //------------------------------------------------------------------
 // BICG Solver with simple preconditioner
 class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
@@ -346,6 +790,8 @@ class SolveLinearSystemBICGAlgo : public SolveLinearSystemParallelAlgo
     explicit SolveLinearSystemBICGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
     bool parallel(ParallelLinearAlgebra& PLA,
                           SolverInputs& matrices) const override;
+  protected:
+    bool needs_transpose() const override { return true; }
 };
 
 bool
@@ -460,8 +906,8 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
       return (true);
     }
 
-    PLA.mult(R,DIAG,Z);
-    PLA.mult(R1,DIAG,Z1);
+    precondition(PLA,R,DIAG,Z);
+    precondition_transpose(PLA,R1,DIAG,Z1);
 
     double bknum = PLA.dot(Z,R1);
 
@@ -656,7 +1102,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(R,VOLD);
   PLA.copy(R,V);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,V,DIAG,V);
 
   double beta1   = sqrt(PLA.dot(V,VOLD));
   double snprod  = beta1;
@@ -673,7 +1119,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   PLA.copy(VOLD,VOLDER);
   PLA.copy(V,VOLD);
 
-  PLA.mult(DIAG,V,V);
+  precondition(PLA,V,DIAG,V);
 
   double betaold = beta1;
   double beta = sqrt(PLA.dot(VOLD,V));
@@ -734,7 +1180,7 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
     PLA.copy(VOLD,VOLDER);
     PLA.copy(V,VOLD);
 
-    PLA.mult(DIAG,V,V);
+    precondition(PLA,V,DIAG,V);
 
     betaold = beta;
     beta = sqrt(PLA.dot(VOLD,V));
@@ -1067,6 +1513,211 @@ parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
   return (true);
 }
 
+//------------------------------------------------------------------
+// CG Solver for multiple right hand sides. The columns are independent
+// CG iterations that share every pass over A, the preconditioner setup and
+// the reductions; a column drops out of the active set once it converges.
+
+class SolveLinearSystemBlockCGAlgo : public SolveLinearSystemParallelAlgo
+{
+  public:
+    explicit SolveLinearSystemBlockCGAlgo(const AlgorithmBase* base) : SolveLinearSystemParallelAlgo(base) {}
+    bool run(SparseRowMatrixHandle a, DenseMatrixHandle b, DenseMatrixHandle x0,
+             DenseMatrixHandle& x, DenseMatrixHandle& convergence) const;
+    bool parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const override;
+  private:
+    mutable DenseMatrixHandle blockConvergence_;
+};
+
+bool SolveLinearSystemBlockCGAlgo::run(SparseRowMatrixHandle a, DenseMatrixHandle b, DenseMatrixHandle x0,
+                                       DenseMatrixHandle& x, DenseMatrixHandle& convergence) const
+{
+  SolverInputs matrices;
+  matrices.A = a;
+  matrices.B = b;
+  matrices.X0 = x0;
+
+  x = makeShared<DenseMatrix>(b->nrows(), b->ncols());
+  matrices.X = x;
+
+  blockConvergence_ = makeShared<DenseMatrix>(algo_->get(Variables::MaxIterations).toInt(), b->ncols(), 0.0);
+  convergence = blockConvergence_;
+
+  // One setup serves all columns
+  preconditioner_ = makeParallelPreconditioner(pre_conditioner_, *a, false);
+
+  const bool success = start_parallel(matrices);
+  preconditioner_.reset();
+  if (!success)
+  {
+    const std::string msg = "Encountered an error while running parallel linear algebra";
+    algo_->error(msg);
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(msg));
+  }
+
+  return (true);
+}
+
+bool SolveLinearSystemBlockCGAlgo::parallel(ParallelLinearAlgebra& PLA, SolverInputs& matrices) const
+{
+  ParallelLinearAlgebra::ParallelMatrix A;
+  ParallelLinearAlgebra::ParallelBlock B, X, X0, R, Z, P, Q;
+  ParallelLinearAlgebra::ParallelVector DIAG, V, W;
+
+  double tolerance = algo_->get(Variables::TargetError).toDouble();
+  int    max_iter =  algo_->get(Variables::MaxIterations).toInt();
+  int    niter = 0;
+
+  if ( !PLA.add_matrix(matrices.A, A) ||
+       !PLA.add_block(matrices.B, B) ||
+       !PLA.add_block(matrices.X0, X0) ||
+       !PLA.add_block(matrices.X, X))
+  {
+    if (PLA.first())
+      algo_->error("Could not link matrices");
+    PLA.wait();
+    return (false);
+  }
+  if ( !PLA.new_block(R) ||
+       !PLA.new_block(Z) ||
+       !PLA.new_block(P) ||
+       !PLA.new_block(Q) ||
+       !PLA.new_vector(DIAG) ||
+       !PLA.new_vector(V) ||
+       !PLA.new_vector(W))
+  {
+    if (PLA.first())
+      algo_->error("Could not allocate enough memory for algorithm");
+    PLA.wait();
+    return (false);
+  }
+
+  const size_t ncols = B.ncols_;
+  ParallelLinearAlgebra::ColumnSet active(ncols);
+  std::iota(active.begin(), active.end(), 0);
+
+  PLA.copy(X0,X,active);
+
+  // Build a preconditioner
+  if (pre_conditioner_ == "Jacobi")
+  {
+    PLA.absdiag(A,DIAG);
+    double max = PLA.max(DIAG);
+    PLA.absthreshold_invert(DIAG,DIAG,1e-18*max);
+  }
+  else
+  {
+    PLA.ones(DIAG);
+  }
+
+  PLA.mult(A,X,R,active);
+  PLA.sub(B,R,R,active);
+
+  std::vector<double> bnorm, rnorm;
+  PLA.dot(B,B,bnorm,active);
+  PLA.dot(R,R,rnorm,active);
+
+  std::vector<double> error(ncols);
+  ParallelLinearAlgebra::ColumnSet unconverged;
+  for (auto c : active)
+  {
+    // A zero right hand side is measured by the absolute error instead
+    bnorm[c] = bnorm[c] > 0.0 ? sqrt(bnorm[c]) : 1.0;
+    error[c] = sqrt(rnorm[c])/bnorm[c];
+    if (error[c] > tolerance)
+      unconverged.push_back(c);
+  }
+  active.swap(unconverged);
+
+  const double orig = active.empty() ? tolerance : *std::max_element(error.begin(), error.end());
+  const double log_orig = log(orig);
+  const double log_scale = log_orig - log(tolerance);
+
+  std::vector<double> rz, rzold(ncols), beta(ncols), pq, alpha(ncols), malpha(ncols);
+  int cnt = 0;
+
+  while (!active.empty() && niter < max_iter)
+  {
+    if (preconditioner_)
+    {
+      for (auto c : active)
+      {
+        PLA.get_column(R,c,V);
+        PLA.wait();
+        preconditioner_->apply(PLA,V,W);
+        PLA.set_column(W,Z,c);
+      }
+    }
+    else
+    {
+      PLA.mult(DIAG,R,Z,active);
+    }
+    PLA.dot(Z,R,rz,active);
+
+    if (niter == 0)
+    {
+      PLA.copy(Z,P,active);
+    }
+    else
+    {
+      for (auto c : active)
+        beta[c] = rz[c]/rzold[c];
+      PLA.scale_add(beta,P,Z,P,active);
+    }
+    PLA.mult(A,P,Q,active);
+    PLA.dot(Q,P,pq,active);
+
+    for (auto c : active)
+    {
+      alpha[c] = rz[c]/pq[c];
+      malpha[c] = -alpha[c];
+      rzold[c] = rz[c];
+    }
+    PLA.scale_add(alpha,P,X,X,active);
+    PLA.scale_add(malpha,Q,R,R,active);
+    PLA.dot(R,R,rnorm,active);
+
+    unconverged.clear();
+    for (auto c : active)
+    {
+      error[c] = sqrt(rnorm[c])/bnorm[c];
+      if (error[c] > tolerance)
+        unconverged.push_back(c);
+    }
+    active.swap(unconverged);
+
+    if (PLA.first())
+    {
+      for (size_t c = 0; c < ncols; c++)
+        (*blockConvergence_)(niter, c) = error[c];
+    }
+    niter++;
+
+    cnt++;
+    if (cnt == 20 && !active.empty())
+    {
+      cnt = 0;
+      double maxerror = 0.0;
+      for (auto c : active)
+        maxerror = std::max(maxerror, error[c]);
+      algo_->update_progress((log_orig-log(maxerror))/log_scale);
+    }
+  }
+
+  if (PLA.first())
+  {
+    std::ostringstream ostr;
+    ostr << "Block solver finished " << ncols << " right hand sides after " << niter << " iterations with largest error "
+      << *std::max_element(error.begin(), error.end());
+    if (!active.empty())
+      ostr << ", " << active.size() << " of them did not converge";
+    algo_->remark(ostr.str());
+  }
+  PLA.wait();
+
+  return (true);
+}
+
 bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
                            DenseColumnMatrixHandle b,
                            DenseColumnMatrixHandle x0,
@@ -1147,8 +1798,22 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
 
   std::string method = getOption(Variables::Method);
 
+  const bool mixedPrecision = get(Parameters::MixedPrecision).toBool();
+  if (mixedPrecision && method != "cg")
+    remark("Mixed precision is only available for the conjugate gradient method, solving in double precision");
+  if (mixedPrecision && method == "cg" && !CompactSparseMatrix::fits(*A))
+    remark("Matrix is too large for 32 bit indices, solving in double precision");
+
   DenseColumnMatrixHandle conv;
-  if (method == "cg")
+  if (method == "cg" && mixedPrecision && CompactSparseMatrix::fits(*A))
+  {
+    SolveLinearSystemMixedCGAlgo algo(this);
+    if(!algo.run(A,b,x0,x,conv))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Mixed precision Conjugate Gradient method failed"));
+    }
+  }
+  else if (method == "cg")
   {
     SolveLinearSystemCGAlgo algo(this);
     if(!algo.run(A,b,x0,x,conv))
@@ -1156,6 +1821,14 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
       BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Conjugate Gradient method failed"));
     }
   }
+  else if (method == "pipecg")
+  {
+    SolveLinearSystemPipelinedCGAlgo algo(this);
+    if(!algo.run(A,b,x0,x,conv))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Pipelined Conjugate Gradient method failed"));
+    }
+  }
   else if (method == "bicg")
   {
     SolveLinearSystemBICGAlgo algo(this);
@@ -1200,11 +1873,92 @@ bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
   return true;
 }
 
+bool SolveLinearSystemAlgo::run(SparseRowMatrixHandle A,
+                           DenseMatrixHandle b,
+                           DenseMatrixHandle x0,
+                           DenseMatrixHandle& x,
+                           DenseMatrixHandle& convergence) const
+{
+  ScopedAlgorithmStatusReporter ssr(this, "SolveLinearSystem");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(A, "No matrix A is given");
+  ENSURE_ALGORITHM_INPUT_NOT_NULL(b, "No matrix b is given");
+
+  double tolerance = get(Variables::TargetError).toDouble();
+  int maxIterations = get(Variables::MaxIterations).toInt();
+  ENSURE_POSITIVE_DOUBLE(tolerance, "Tolerance out of range!");
+  ENSURE_POSITIVE_INT(maxIterations, "Max iterations out of range!");
+
+  if (!x0)
+  {
+    x0 = makeShared<DenseMatrix>(b->nrows(), b->ncols(), 0.0);
+  }
+
+  if (x0->ncols() != b->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix x0 and b need to have the same number of columns");
+  }
+
+  if (A->nrows() != A->ncols())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A is not square");
+  }
+
+  if (A->nrows() != b->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and b do not have the same number of rows");
+  }
+
+  if (A->nrows() != x0->nrows())
+  {
+    THROW_ALGORITHM_INPUT_ERROR("Matrix A and x0 do not have the same number of rows");
+  }
+
+  std::string method = getOption(Variables::Method);
+
+  // The block solver iterates in double precision, mixed precision solves go one column at a time
+  if (method == "cg" && !get(Parameters::MixedPrecision).toBool())
+  {
+    SolveLinearSystemBlockCGAlgo algo(this);
+    if (!algo.run(A,b,x0,x,convergence))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("Block Conjugate Gradient method failed"));
+    }
+    return true;
+  }
+
+  // The other methods have no block version, they solve one column at a time
+  x = makeShared<DenseMatrix>(b->nrows(), b->ncols());
+  convergence.reset();
+  for (size_t c = 0; c < b->ncols(); ++c)
+  {
+    auto bc = makeShared<DenseColumnMatrix>(b->col(c));
+    auto x0c = makeShared<DenseColumnMatrix>(x0->col(c));
+    DenseColumnMatrixHandle xc;
+    if (!run(A, bc, x0c, xc))
+      return false;
+    x->col(c) = *xc;
+  }
+  return true;
+}
+
 AlgorithmOutput SolveLinearSystemAlgo::run(const AlgorithmInput& input) const
 {
   auto lhs = input.get<SparseRowMatrix>(Variables::LHS);
   auto rhs = input.get<DenseColumnMatrix>(Variables::RHS);
 
+  if (!rhs)
+  {
+    auto rhsBlock = input.get<DenseMatrix>(Variables::RHS);
+    DenseMatrixHandle solution, convergence;
+    if (!run(lhs, rhsBlock, DenseMatrixHandle(), solution, convergence))
+    {
+      BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << ErrorMessage("SolveLinearSystem Algo returned false--need to improve error conditions so it throws before returning."));
+    }
+    AlgorithmOutput output;
+    output[Variables::Solution] = solution;
+    return output;
+  }
+
   DenseColumnMatrixHandle solution;
 
   bool success = run(lhs, rhs, DenseColumnMatrixHandle(), solution);
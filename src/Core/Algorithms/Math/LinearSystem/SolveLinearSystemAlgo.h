@@ -42,6 +42,10 @@ namespace Core {
 namespace Algorithms {
 namespace Math {
 
+// Iterate with a float, 32 bit index copy of A and refine the solution in
+// double precision (cg only)
+ALGORITHM_PARAMETER_DECL(MixedPrecision);
+
 // Solve a linear system in parallel using a standard iterative method
 // Method solves A*x = b, with x0 being the initializer for the solution
 
@@ -61,6 +65,16 @@ class SCISHARE SolveLinearSystemAlgo : public AlgorithmBase
              Datatypes::DenseColumnMatrixHandle x0,
              Datatypes::DenseColumnMatrixHandle& x) const;
 
+    // Solves A*x = b for every column of b. With cg the columns share each
+    // pass over A and the preconditioner setup, and convergence holds the
+    // error of every column per iteration. The other methods solve the
+    // columns one after another and leave convergence empty.
+    bool run(Datatypes::SparseRowMatrixHandle A,
+             Datatypes::DenseMatrixHandle b,
+             Datatypes::DenseMatrixHandle x0,
+             Datatypes::DenseMatrixHandle& x,
+             Datatypes::DenseMatrixHandle& convergence) const;
+
     AlgorithmOutput run(const AlgorithmInput& input) const override;
 };
 
@@ -33,6 +33,7 @@
 ///////////////////////////
 
 #include <cfloat>
+#include <limits>
 
 #include <Core/Datatypes/Matrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
@@ -40,6 +41,7 @@
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebraKernels.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Thread/Parallel.h>
 
@@ -76,6 +78,10 @@ ParallelLinearAlgebra::ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& da
   reduce_[1] = data.reduceBuffer2();
 
   reduce_buffer_ = 0;
+
+  block_reduce_[0] = data.blockReduceBuffer1();
+  block_reduce_[1] = data.blockReduceBuffer2();
+  block_reduce_buffer_ = 0;
 }
 
 void ParallelLinearAlgebra::wait()
@@ -144,6 +150,174 @@ bool ParallelLinearAlgebra::add_matrix(SparseRowMatrixHandle mat, ParallelMatrix
   return (true);
 }
 
+bool ParallelLinearAlgebra::add_matrix(CompactSparseMatrixHandle mat, ParallelCompactMatrix& M)
+{
+  if (!mat) return (false);
+  if (mat->nrows() != size_) return (false);
+
+  M.data_ = mat->data();
+  M.rows_ = mat->rows();
+  M.columns_ = mat->columns();
+
+  M.m_ = mat->nrows();
+  M.n_ = mat->ncols();
+  M.nnz_ = mat->nonZeros();
+
+  return (true);
+}
+
+bool ParallelLinearAlgebra::add_block(DenseMatrixHandle mat, ParallelBlock& V)
+{
+  if (!mat) { return (false); }
+  if (mat->nrows() != size_) { return (false); }
+  if (mat->ncols() != data_.numColumns()) { return (false); }
+
+  V.data_ = mat->data();
+  V.size_ = size_;
+  V.ncols_ = mat->ncols();
+
+  return true;
+}
+
+bool ParallelLinearAlgebra::new_block(ParallelBlock& V)
+{
+  wait();
+
+  data_.setSuccess(proc_);
+  if (proc_ == 0)
+  {
+    try
+    {
+      auto mat(makeShared<DenseMatrix>(data_.getSize(), data_.numColumns()));
+      data_.setCurrentBlock(mat);
+      data_.addBlock(mat);
+    }
+    catch (...)
+    {
+      data_.setFail(0);
+    }
+  }
+
+  wait();
+
+  if (!data_.isSuccess(0))
+    return false;
+
+  auto mat = data_.getCurrentBlock();
+  wait();
+
+  return(add_block(mat,V));
+}
+
+void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols)
+{
+  wait();
+
+  const size_t ncols = b.ncols_;
+  const size_t nactive = cols.size();
+  double* idata = b.data_;
+  double* odata = r.data_;
+
+  double* data = a.data_;
+  auto rows = a.rows_;
+  auto columns = a.columns_;
+
+  std::vector<double> sum(nactive);
+  for (size_t i=start_; i<end_; i++)
+  {
+    std::fill(sum.begin(), sum.end(), 0.0);
+    for (index_type j=rows[i]; j<rows[i+1]; j++)
+    {
+      const double val = data[j];
+      const double* x = idata + columns[j]*ncols;
+      for (size_t k=0; k<nactive; k++)
+        sum[k] += val*x[cols[k]];
+    }
+    double* y = odata + i*ncols;
+    for (size_t k=0; k<nactive; k++)
+      y[cols[k]] = sum[k];
+  }
+}
+
+void ParallelLinearAlgebra::mult(const ParallelVector& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols)
+{
+  const size_t ncols = b.ncols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double s = a.data_[i];
+    const double* b_ptr = b.data_ + i*ncols;
+    double* r_ptr = r.data_ + i*ncols;
+    for (auto c : cols)
+      r_ptr[c] = s*b_ptr[c];
+  }
+}
+
+void ParallelLinearAlgebra::sub(const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols)
+{
+  const size_t ncols = a.ncols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_ptr = a.data_ + i*ncols;
+    const double* b_ptr = b.data_ + i*ncols;
+    double* r_ptr = r.data_ + i*ncols;
+    for (auto c : cols)
+      r_ptr[c] = a_ptr[c]-b_ptr[c];
+  }
+}
+
+void ParallelLinearAlgebra::copy(const ParallelBlock& a, ParallelBlock& r, const ColumnSet& cols)
+{
+  const size_t ncols = a.ncols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_ptr = a.data_ + i*ncols;
+    double* r_ptr = r.data_ + i*ncols;
+    for (auto c : cols)
+      r_ptr[c] = a_ptr[c];
+  }
+}
+
+void ParallelLinearAlgebra::scale_add(const std::vector<double>& s, const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols)
+{
+  const size_t ncols = a.ncols_;
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_ptr = a.data_ + i*ncols;
+    const double* b_ptr = b.data_ + i*ncols;
+    double* r_ptr = r.data_ + i*ncols;
+    for (auto c : cols)
+      r_ptr[c] = s[c]*a_ptr[c]+b_ptr[c];
+  }
+}
+
+void ParallelLinearAlgebra::dot(const ParallelBlock& a, const ParallelBlock& b, std::vector<double>& r, const ColumnSet& cols)
+{
+  const size_t ncols = a.ncols_;
+  r.assign(ncols, 0.0);
+  for (size_t i=start_; i<end_; i++)
+  {
+    const double* a_ptr = a.data_ + i*ncols;
+    const double* b_ptr = b.data_ + i*ncols;
+    for (auto c : cols)
+      r[c] += a_ptr[c]*b_ptr[c];
+  }
+  reduce_sum(r, cols);
+}
+
+void ParallelLinearAlgebra::get_column(const ParallelBlock& a, size_t col, ParallelVector& r)
+{
+  const size_t ncols = a.ncols_;
+  for (size_t i=start_; i<end_; i++)
+    r.data_[i] = a.data_[i*ncols+col];
+}
+
+void ParallelLinearAlgebra::set_column(const ParallelVector& a, ParallelBlock& r, size_t col)
+{
+  const size_t ncols = r.ncols_;
+  for (size_t i=start_; i<end_; i++)
+    r.data_[i*ncols+col] = a.data_[i];
+}
+
 /// @todo: refactor duplication
 
 void ParallelLinearAlgebra::mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
@@ -387,76 +561,27 @@ void ParallelLinearAlgebra::absthreshold_invert(const ParallelVector& a, Paralle
 
 void ParallelLinearAlgebra::scale_add(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-  double* r_ptr = r.data_+start_;
-
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    *r_ptr = s*(*a_ptr)+(*b_ptr); r_ptr++; a_ptr++; b_ptr++;
-  }
+  Kernels::scale_add(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_);
 }
 
 double ParallelLinearAlgebra::dot(const ParallelVector& a, const ParallelVector& b)
 {
-  double* a_ptr = a.data_+start_;
-  double* b_ptr = b.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
+  return(reduce_sum(local_dot(a,b)));
+}
 
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
+double ParallelLinearAlgebra::local_dot(const ParallelVector& a, const ParallelVector& b)
+{
+  return Kernels::dot(a.data_+start_, b.data_+start_, local_size_);
+}
 
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*b_ptr); b_ptr++; a_ptr++;
-  }
+double ParallelLinearAlgebra::mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  return(reduce_sum(Kernels::mult_dot(a.data_+start_, b.data_+start_, r.data_+start_, local_size_)));
+}
 
-  return(reduce_sum(val));
+double ParallelLinearAlgebra::scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r)
+{
+  return(sqrt(reduce_sum(Kernels::scale_add_norm2(s, a.data_+start_, b.data_+start_, r.data_+start_, local_size_))));
 }
 
 void ParallelLinearAlgebra::zeros(ParallelVector& a)
@@ -531,40 +656,7 @@ void ParallelLinearAlgebra::ones(ParallelVector& a)
 
 double ParallelLinearAlgebra::norm(const ParallelVector& a)
 {
-  double* a_ptr = a.data_+start_;
-
-  double val = 0.0;
-  size_t j=0;
-
-  for (; j<local_size16_; j+=16)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
-
-  for (; j<local_size_; j++)
-  {
-    val += (*a_ptr)*(*a_ptr); a_ptr++;
-  }
-
-  return(sqrt(reduce_sum(val)));
+  return(sqrt(reduce_sum(local_dot(a,a))));
 }
 
 /// @todo: refactor to use algorithm
@@ -629,25 +721,30 @@ double ParallelLinearAlgebra::absmax(const ParallelVector& a)
 void ParallelLinearAlgebra::mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
 {
   wait();
+  Kernels::spmv(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_);
+}
 
-  double* idata = b.data_;
-  double* odata = r.data_;
+void ParallelLinearAlgebra::mult_nowait(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  Kernels::spmv(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_);
+}
 
-  double* data = a.data_;
-  auto rows = a.rows_;
-  auto columns = a.columns_;
+double ParallelLinearAlgebra::mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+  return(reduce_sum(Kernels::spmv_dot(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_)));
+}
 
-  for(size_t i=start_;i<end_;i++)
-  {
-    double sum = 0.0;
-    index_type row_idx = rows[i];
-    index_type next_idx = rows[i+1];
-    for(index_type j=row_idx;j<next_idx;j++)
-    {
-	    sum+=data[j]*idata[columns[j]];
-    }
-    odata[i]=sum;
-  }
+void ParallelLinearAlgebra::mult(const ParallelCompactMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+  Kernels::spmv(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_);
+}
+
+double ParallelLinearAlgebra::mult_dot(const ParallelCompactMatrix& a, const ParallelVector& b, ParallelVector& r)
+{
+  wait();
+  return(reduce_sum(Kernels::spmv_dot(a.rows_, a.columns_, a.data_, b.data_, r.data_, start_, end_)));
 }
 
 void ParallelLinearAlgebra::mult_trans(ParallelMatrix& a, ParallelVector& b, ParallelVector& r)
@@ -767,12 +864,86 @@ double ParallelLinearAlgebra::reduce_min(double val)
 
 
 
+void ParallelLinearAlgebra::reduce_sum(std::vector<double>& vals, const ColumnSet& cols)
+{
+  const size_t ncols = vals.size();
+  double* buffer = block_reduce_[block_reduce_buffer_];
+  for (auto c : cols)
+    buffer[proc_*ncols+c] = vals[c];
+  block_reduce_buffer_ = block_reduce_buffer_ ? 0 : 1;
+  wait();
+
+  for (auto c : cols)
+  {
+    double ret = 0.0; for (int j=0; j<nproc_; j++) ret += buffer[j*ncols+c];
+    vals[c] = ret;
+  }
+}
+
+void ParallelLinearAlgebra::reduce_sum(double* vals, size_t n)
+{
+  double* buffer = block_reduce_[block_reduce_buffer_];
+  const size_t stride = std::max(data_.numColumns(), MaxFusedReductions);
+  for (size_t k = 0; k < n; k++)
+    buffer[proc_*stride+k] = vals[k];
+  block_reduce_buffer_ = block_reduce_buffer_ ? 0 : 1;
+  wait();
+
+  for (size_t k = 0; k < n; k++)
+  {
+    double ret = 0.0; for (int j=0; j<nproc_; j++) ret += buffer[j*stride+k];
+    vals[k] = ret;
+  }
+}
+
+CompactSparseMatrix::CompactSparseMatrix(const SparseRowMatrix& A) :
+  rows_(A.nrows() + 1), columns_(A.nonZeros()), data_(A.nonZeros()), ncols_(A.ncols())
+{
+  if (!fits(A))
+    BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Matrix is too large for 32 bit indices"));
+
+  index_type k = 0;
+  for (index_type i = 0; i < A.outerSize(); ++i)
+  {
+    rows_[i] = static_cast<int32_t>(k);
+    for (SparseRowMatrix::InnerIterator it(A, i); it; ++it, ++k)
+    {
+      columns_[k] = static_cast<int32_t>(it.index());
+      data_[k] = static_cast<float>(it.value());
+    }
+  }
+  rows_[A.nrows()] = static_cast<int32_t>(k);
+}
+
+bool CompactSparseMatrix::fits(const SparseRowMatrix& A)
+{
+  const index_type limit = std::numeric_limits<int32_t>::max();
+  return A.nonZeros() <= limit && A.ncols() <= limit && A.nrows() <= limit;
+}
+
+size_t CompactSparseMatrix::memorySize() const
+{
+  return rows_.size() * sizeof(int32_t) + columns_.size() * sizeof(int32_t) + data_.size() * sizeof(float);
+}
+
+size_t SolverInputs::numColumns() const
+{
+  return B ? B->ncols() : 1;
+}
+
+bool SolverInputs::hasConsistentSizes() const
+{
+  const size_t size = A->nrows();
+  if (B)
+    return B->nrows() == size && X->nrows() == size && X0->nrows() == size
+      && X->ncols() == B->ncols() && X0->ncols() == B->ncols();
+  return b->nrows() == size && x->nrows() == size && x0->nrows() == size;
+}
+
 bool ParallelLinearAlgebraBase::start_parallel(SolverInputs& matrices, int nproc) const
 {
   size_t size = matrices.A->nrows();
-  if (matrices.b->nrows() != size
-    || matrices.x->nrows() != size
-    || matrices.x0->nrows() != size)
+  if (!matrices.hasConsistentSizes())
     return false;
 
   /// Require a minimum of 50 variables per processor
@@ -809,8 +980,10 @@ ParallelLinearAlgebraSharedData::ParallelLinearAlgebraSharedData(const SolverInp
   reduce1_(numProcs),
   reduce2_(numProcs)
 {
-  if (inputs.b->nrows() != size_
-    || inputs.x->nrows() != size_
-    || inputs.x0->nrows() != size_)
+  numColumns_ = inputs.numColumns();
+  const size_t stride = std::max(numColumns_, ParallelLinearAlgebra::MaxFusedReductions);
+  blockReduce1_.resize(numProcs * stride);
+  blockReduce2_.resize(numProcs * stride);
+  if (!inputs.hasConsistentSizes())
     BOOST_THROW_EXCEPTION(AlgorithmInputException() << ErrorMessage("Dimension mismatch")); /// @todo: use new DimensionMismatch exception type
 }
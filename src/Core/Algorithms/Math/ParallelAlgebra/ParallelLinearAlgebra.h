@@ -35,6 +35,7 @@
 
 #include <vector>
 #include <list>
+#include <cstdint>
 #include <boost/noncopyable.hpp>
 #include <Core/Datatypes/MatrixFwd.h>
 #include <Core/Thread/Barrier.h>
@@ -48,6 +49,35 @@ namespace Math {
 
   class ParallelLinearAlgebra;
 
+  // Reduced precision copy of a sparse matrix for the mixed precision solvers:
+  // 32 bit indices and float values roughly halve the bytes that a matrix
+  // vector product streams from memory.
+  class SCISHARE CompactSparseMatrix : boost::noncopyable
+  {
+  public:
+    explicit CompactSparseMatrix(const Datatypes::SparseRowMatrix& A);
+
+    // Whether the indices of A can be stored in 32 bits
+    static bool fits(const Datatypes::SparseRowMatrix& A);
+
+    size_t nrows() const { return rows_.size() - 1; }
+    size_t ncols() const { return ncols_; }
+    size_t nonZeros() const { return data_.size(); }
+    size_t memorySize() const;
+
+    const int32_t* rows() const { return &rows_[0]; }
+    const int32_t* columns() const { return columns_.empty() ? nullptr : &columns_[0]; }
+    const float* data() const { return data_.empty() ? nullptr : &data_[0]; }
+
+  private:
+    std::vector<int32_t> rows_;
+    std::vector<int32_t> columns_;
+    std::vector<float> data_;
+    size_t ncols_;
+  };
+
+  typedef SharedPointer<CompactSparseMatrix> CompactSparseMatrixHandle;
+
   struct SCISHARE SolverInputs
   {
     Datatypes::SparseRowMatrixHandle A;
@@ -55,12 +85,29 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle x0;
     Datatypes::DenseColumnMatrixHandle x;
 
+    // Multiple right hand sides, one per column, for the block solvers.
+    // These replace b, x0 and x.
+    Datatypes::DenseMatrixHandle B;
+    Datatypes::DenseMatrixHandle X0;
+    Datatypes::DenseMatrixHandle X;
+
+    // Optional reduced precision copy of A for the inner iterations of the
+    // mixed precision solvers
+    CompactSparseMatrixHandle Af;
+
+    size_t numColumns() const;
+    bool hasConsistentSizes() const;
+
     void clear()
     {
       A.reset();
       b.reset();
       x0.reset();
       x.reset();
+      B.reset();
+      X0.reset();
+      X.reset();
+      Af.reset();
     }
   };
 
@@ -72,6 +119,10 @@ namespace Math {
     Datatypes::DenseColumnMatrixHandle getCurrentMatrix() const { return current_matrix_; }
     void setCurrentMatrix(Datatypes::DenseColumnMatrixHandle mat) { current_matrix_ = mat; }
     void addVector(Datatypes::DenseColumnMatrixHandle mat) { vectors_.push_back(mat); }
+    Datatypes::DenseMatrixHandle getCurrentBlock() const { return current_block_; }
+    void setCurrentBlock(Datatypes::DenseMatrixHandle mat) { current_block_ = mat; }
+    void addBlock(Datatypes::DenseMatrixHandle mat) { blocks_.push_back(mat); }
+    size_t numColumns() const { return numColumns_; }
     void setFlag(size_t i, bool b) { success_[i] = b; }
     void setSuccess(size_t i) { success_[i] = true; }
     void setFail(size_t i) { success_[i] = false; }
@@ -95,11 +146,16 @@ namespace Math {
 
     double* reduceBuffer1() { return &reduce1_[0]; }
     double* reduceBuffer2() { return &reduce2_[0]; }
+    double* blockReduceBuffer1() { return &blockReduce1_[0]; }
+    double* blockReduceBuffer2() { return &blockReduce2_[0]; }
 
   private:
     size_t size_;
     Datatypes::DenseColumnMatrixHandle current_matrix_;
     std::list<Datatypes::DenseColumnMatrixHandle> vectors_;
+    size_t numColumns_;
+    Datatypes::DenseMatrixHandle current_block_;
+    std::list<Datatypes::DenseMatrixHandle> blocks_;
     std::vector<bool> success_;
     SolverInputs imatrices_;
     SCIRun::Core::Thread::Barrier barrier_;
@@ -107,6 +163,8 @@ namespace Math {
     /// classes for communication
     std::vector<double> reduce1_;
     std::vector<double> reduce2_;
+    std::vector<double> blockReduce1_;
+    std::vector<double> blockReduce2_;
   };
 
 // The algorithm that uses this should derive from this class
@@ -147,12 +205,40 @@ public:
       size_t   nnz_;
   };
 
+  class ParallelCompactMatrix {
+    public:
+      const int32_t* rows_;
+      const int32_t* columns_;
+      const float* data_;
+
+      size_t   m_;
+      size_t   n_;
+      size_t   nnz_;
+  };
+
+  // Row major block of vectors, one per right hand side, so that a matrix
+  // row is read once for all of them
+  class ParallelBlock {
+    public:
+      double* data_;
+      size_t size_;
+      size_t ncols_;
+  };
+
+  // Columns of a block that an operation works on, e.g. the ones that have
+  // not converged yet
+  typedef std::vector<size_t> ColumnSet;
+
   // Constructor
   ParallelLinearAlgebra(ParallelLinearAlgebraSharedData& base, int proc);
 
   bool add_vector(Datatypes::DenseColumnMatrixHandle mat, ParallelVector& V);
   bool new_vector(ParallelVector& V);
   bool add_matrix(Datatypes::SparseRowMatrixHandle mat, ParallelMatrix& M);
+  bool add_matrix(CompactSparseMatrixHandle mat, ParallelCompactMatrix& M);
+
+  bool add_block(Datatypes::DenseMatrixHandle mat, ParallelBlock& V);
+  bool new_block(ParallelBlock& V);
 
   void mult(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
   void sub(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
@@ -184,11 +270,44 @@ public:
   double max(const ParallelVector& a);
 
   void mult(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // Same as mult, for callers that have just synchronized, e.g. through a reduction
+  void mult_nowait(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // Product with the reduced precision matrix, accumulated in double
+  void mult(const ParallelCompactMatrix& a, const ParallelVector& b, ParallelVector& r);
 
   void absdiag(const ParallelMatrix& a, ParallelVector& r);
 
   void ones(ParallelVector& r);
 
+  // Fused kernels: one pass over memory and a single reduction
+  // r = a*b, returns r.b
+  double mult_dot(const ParallelMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // r = a.*b, returns r.a
+  double mult_dot(const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+  double mult_dot(const ParallelCompactMatrix& a, const ParallelVector& b, ParallelVector& r);
+  // r = s*a + b, returns |r|
+  double scale_add_norm(double s, const ParallelVector& a, const ParallelVector& b, ParallelVector& r);
+
+  // Dot product over the rows of this thread only, for combining several
+  // products into one reduce_sum
+  double local_dot(const ParallelVector& a, const ParallelVector& b);
+  void reduce_sum(double* vals, size_t n);
+  static constexpr size_t MaxFusedReductions = 4;
+
+  // Block versions, they only touch the columns in cols
+  void mult(const ParallelMatrix& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols);
+  // r_c = a .* b_c
+  void mult(const ParallelVector& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols);
+  void sub(const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols);
+  void copy(const ParallelBlock& a, ParallelBlock& r, const ColumnSet& cols);
+  // r_c = s[c]*a_c + b_c
+  void scale_add(const std::vector<double>& s, const ParallelBlock& a, const ParallelBlock& b, ParallelBlock& r, const ColumnSet& cols);
+  // r[c] = a_c . b_c, with a single reduction for all columns
+  void dot(const ParallelBlock& a, const ParallelBlock& b, std::vector<double>& r, const ColumnSet& cols);
+
+  void get_column(const ParallelBlock& a, size_t col, ParallelVector& r);
+  void set_column(const ParallelVector& a, ParallelBlock& r, size_t col);
+
   int  proc() { return proc_; }
   int  nproc() { return nproc_; }
 
@@ -199,6 +318,7 @@ private:
   double reduce_sum(double val);
   double reduce_min(double val);
   double reduce_max(double val);
+  void reduce_sum(std::vector<double>& vals, const ColumnSet& cols);
 
   ParallelLinearAlgebraSharedData& data_;
 
@@ -213,6 +333,8 @@ private:
 
   double* reduce_[2];
   int     reduce_buffer_;
+  double* block_reduce_[2];
+  int     block_reduce_buffer_;
 
 
 };
@@ -0,0 +1,430 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebraKernels.h>
+
+// The AVX2 and AVX-512 versions are compiled for their instruction set with
+// function attributes, so the rest of the library keeps the default target
+// and the binary still runs on machines without these extensions.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#  include <immintrin.h>
+#  define SCIRUN_PLA_DISPATCH
+#  define SCIRUN_PLA_TARGET(isa) __attribute__((target(isa)))
+#elif defined(_MSC_VER) && defined(_M_X64)
+#  include <immintrin.h>
+#  include <intrin.h>
+#  define SCIRUN_PLA_DISPATCH
+#  define SCIRUN_PLA_TARGET(isa)
+#endif
+
+using namespace SCIRun;
+
+namespace
+{
+  enum class Isa { Scalar, AVX2, AVX512 };
+
+#if defined(SCIRUN_PLA_DISPATCH)
+  Isa detectIsa()
+  {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+      return Isa::Scalar;
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!osxsave)
+      return Isa::Scalar;
+    const unsigned long long xcr0 = _xgetbv(0);
+    __cpuidex(info, 7, 0);
+    const bool avx2 = (info[1] & (1 << 5)) != 0 && (xcr0 & 0x6) == 0x6;
+    const bool avx512 = (info[1] & (1 << 16)) != 0 && (xcr0 & 0xe6) == 0xe6;
+#else
+    __builtin_cpu_init();
+    const bool fma = __builtin_cpu_supports("fma");
+    const bool avx2 = __builtin_cpu_supports("avx2");
+    const bool avx512 = __builtin_cpu_supports("avx512f");
+#endif
+    if (avx512 && avx2 && fma)
+      return Isa::AVX512;
+    if (avx2 && fma)
+      return Isa::AVX2;
+    return Isa::Scalar;
+  }
+#endif
+
+  Isa isa()
+  {
+#if defined(SCIRUN_PLA_DISPATCH)
+    static const Isa value = detectIsa();
+    return value;
+#else
+    return Isa::Scalar;
+#endif
+  }
+
+  // Portable versions, also used for the tails of the vector loops
+
+  double dot_scalar(const double* a, const double* b, size_t j, size_t n)
+  {
+    double v0 = 0.0, v1 = 0.0, v2 = 0.0, v3 = 0.0;
+    for (; j + 4 <= n; j += 4)
+    {
+      v0 += a[j] * b[j];
+      v1 += a[j + 1] * b[j + 1];
+      v2 += a[j + 2] * b[j + 2];
+      v3 += a[j + 3] * b[j + 3];
+    }
+    double val = (v0 + v1) + (v2 + v3);
+    for (; j < n; j++)
+      val += a[j] * b[j];
+    return val;
+  }
+
+  void scale_add_scalar(double s, const double* a, const double* b, double* r, size_t j, size_t n)
+  {
+    for (; j < n; j++)
+      r[j] = s * a[j] + b[j];
+  }
+
+  double scale_add_norm2_scalar(double s, const double* a, const double* b, double* r, size_t j, size_t n)
+  {
+    double val = 0.0;
+    for (; j < n; j++)
+    {
+      r[j] = s * a[j] + b[j];
+      val += r[j] * r[j];
+    }
+    return val;
+  }
+
+  double mult_dot_scalar(const double* a, const double* b, double* r, size_t j, size_t n)
+  {
+    double val = 0.0;
+    for (; j < n; j++)
+    {
+      r[j] = a[j] * b[j];
+      val += r[j] * a[j];
+    }
+    return val;
+  }
+
+  template <class Index, class Value>
+  double spmv_scalar(const Index* rows, const Index* columns, const Value* data,
+    const double* x, double* r, size_t begin, size_t end, bool with_dot)
+  {
+    double val = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      double sum = 0.0;
+      for (Index j = rows[i]; j < rows[i+1]; j++)
+        sum += static_cast<double>(data[j]) * x[columns[j]];
+      r[i] = sum;
+      if (with_dot)
+        val += sum * x[i];
+    }
+    return val;
+  }
+
+#if defined(SCIRUN_PLA_DISPATCH)
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double hsum(__m256d v)
+  {
+    __m128d lo = _mm256_castpd256_pd128(v);
+    __m128d hi = _mm256_extractf128_pd(v, 1);
+    lo = _mm_add_pd(lo, hi);
+    return _mm_cvtsd_f64(_mm_add_sd(lo, _mm_unpackhi_pd(lo, lo)));
+  }
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double dot_avx2(const double* a, const double* b, size_t n)
+  {
+    size_t j = 0;
+    __m256d acc0 = _mm256_setzero_pd(), acc1 = _mm256_setzero_pd();
+    for (; j + 8 <= n; j += 8)
+    {
+      acc0 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j), acc0);
+      acc1 = _mm256_fmadd_pd(_mm256_loadu_pd(a + j + 4), _mm256_loadu_pd(b + j + 4), acc1);
+    }
+    return hsum(_mm256_add_pd(acc0, acc1)) + dot_scalar(a, b, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  void scale_add_avx2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    const __m256d vs = _mm256_set1_pd(s);
+    for (; j + 4 <= n; j += 4)
+      _mm256_storeu_pd(r + j, _mm256_fmadd_pd(vs, _mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j)));
+    scale_add_scalar(s, a, b, r, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double scale_add_norm2_avx2(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    const __m256d vs = _mm256_set1_pd(s);
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= n; j += 4)
+    {
+      const __m256d v = _mm256_fmadd_pd(vs, _mm256_loadu_pd(a + j), _mm256_loadu_pd(b + j));
+      _mm256_storeu_pd(r + j, v);
+      acc = _mm256_fmadd_pd(v, v, acc);
+    }
+    return hsum(acc) + scale_add_norm2_scalar(s, a, b, r, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double mult_dot_avx2(const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    __m256d acc = _mm256_setzero_pd();
+    for (; j + 4 <= n; j += 4)
+    {
+      const __m256d va = _mm256_loadu_pd(a + j);
+      const __m256d v = _mm256_mul_pd(va, _mm256_loadu_pd(b + j));
+      _mm256_storeu_pd(r + j, v);
+      acc = _mm256_fmadd_pd(v, va, acc);
+    }
+    return hsum(acc) + mult_dot_scalar(a, b, r, j, n);
+  }
+
+  // FE rows are long enough (7-27 entries) for a 4 wide gather to pay off
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double spmv_avx2(const index_type* rows, const index_type* columns, const double* data,
+    const double* x, double* r, size_t begin, size_t end, bool with_dot)
+  {
+    double val = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      index_type j = rows[i];
+      const index_type next = rows[i+1];
+      __m256d acc = _mm256_setzero_pd();
+      for (; j + 4 <= next; j += 4)
+      {
+        const __m256d xv = _mm256_set_pd(x[columns[j+3]], x[columns[j+2]], x[columns[j+1]], x[columns[j]]);
+        acc = _mm256_fmadd_pd(_mm256_loadu_pd(data + j), xv, acc);
+      }
+      double sum = hsum(acc);
+      for (; j < next; j++)
+        sum += data[j] * x[columns[j]];
+      r[i] = sum;
+      if (with_dot)
+        val += sum * x[i];
+    }
+    return val;
+  }
+
+  SCIRUN_PLA_TARGET("avx2,fma")
+  double spmv_avx2(const int32_t* rows, const int32_t* columns, const float* data,
+    const double* x, double* r, size_t begin, size_t end, bool with_dot)
+  {
+    double val = 0.0;
+    for (size_t i = begin; i < end; i++)
+    {
+      int32_t j = rows[i];
+      const int32_t next = rows[i+1];
+      __m256d acc = _mm256_setzero_pd();
+      for (; j + 4 <= next; j += 4)
+      {
+        const __m256d xv = _mm256_i32gather_pd(x, _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns + j)), 8);
+        acc = _mm256_fmadd_pd(_mm256_cvtps_pd(_mm_loadu_ps(data + j)), xv, acc);
+      }
+      double sum = hsum(acc);
+      for (; j < next; j++)
+        sum += static_cast<double>(data[j]) * x[columns[j]];
+      r[i] = sum;
+      if (with_dot)
+        val += sum * x[i];
+    }
+    return val;
+  }
+
+  SCIRUN_PLA_TARGET("avx512f")
+  double dot_avx512(const double* a, const double* b, size_t n)
+  {
+    size_t j = 0;
+    __m512d acc0 = _mm512_setzero_pd(), acc1 = _mm512_setzero_pd();
+    for (; j + 16 <= n; j += 16)
+    {
+      acc0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j), acc0);
+      acc1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + j + 8), _mm512_loadu_pd(b + j + 8), acc1);
+    }
+    return _mm512_reduce_add_pd(_mm512_add_pd(acc0, acc1)) + dot_scalar(a, b, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx512f")
+  void scale_add_avx512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    const __m512d vs = _mm512_set1_pd(s);
+    for (; j + 8 <= n; j += 8)
+      _mm512_storeu_pd(r + j, _mm512_fmadd_pd(vs, _mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j)));
+    scale_add_scalar(s, a, b, r, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx512f")
+  double scale_add_norm2_avx512(double s, const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    const __m512d vs = _mm512_set1_pd(s);
+    __m512d acc = _mm512_setzero_pd();
+    for (; j + 8 <= n; j += 8)
+    {
+      const __m512d v = _mm512_fmadd_pd(vs, _mm512_loadu_pd(a + j), _mm512_loadu_pd(b + j));
+      _mm512_storeu_pd(r + j, v);
+      acc = _mm512_fmadd_pd(v, v, acc);
+    }
+    return _mm512_reduce_add_pd(acc) + scale_add_norm2_scalar(s, a, b, r, j, n);
+  }
+
+  SCIRUN_PLA_TARGET("avx512f")
+  double mult_dot_avx512(const double* a, const double* b, double* r, size_t n)
+  {
+    size_t j = 0;
+    __m512d acc = _mm512_setzero_pd();
+    for (; j + 8 <= n; j += 8)
+    {
+      const __m512d va = _mm512_loadu_pd(a + j);
+      const __m512d v = _mm512_mul_pd(va, _mm512_loadu_pd(b + j));
+      _mm512_storeu_pd(r + j, v);
+      acc = _mm512_fmadd_pd(v, va, acc);
+    }
+    return _mm512_reduce_add_pd(acc) + mult_dot_scalar(a, b, r, j, n);
+  }
+
+#endif
+
+  template <class Index, class Value>
+  double spmv_dispatch(const Index* rows, const Index* columns, const Value* data,
+    const double* x, double* r, size_t begin, size_t end, bool with_dot)
+  {
+#if defined(SCIRUN_PLA_DISPATCH)
+    // the 256 bit gather is also the fastest sparse product on AVX-512 machines
+    if (isa() != Isa::Scalar)
+      return spmv_avx2(rows, columns, data, x, r, begin, end, with_dot);
+#endif
+    return spmv_scalar(rows, columns, data, x, r, begin, end, with_dot);
+  }
+}
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+namespace Kernels {
+
+const char* simdName()
+{
+  switch (isa())
+  {
+  case Isa::AVX512: return "AVX-512";
+  case Isa::AVX2: return "AVX2";
+  default: return "scalar";
+  }
+}
+
+double dot(const double* a, const double* b, size_t n)
+{
+#if defined(SCIRUN_PLA_DISPATCH)
+  switch (isa())
+  {
+  case Isa::AVX512: return dot_avx512(a, b, n);
+  case Isa::AVX2: return dot_avx2(a, b, n);
+  default: break;
+  }
+#endif
+  return dot_scalar(a, b, 0, n);
+}
+
+void scale_add(double s, const double* a, const double* b, double* r, size_t n)
+{
+#if defined(SCIRUN_PLA_DISPATCH)
+  switch (isa())
+  {
+  case Isa::AVX512: scale_add_avx512(s, a, b, r, n); return;
+  case Isa::AVX2: scale_add_avx2(s, a, b, r, n); return;
+  default: break;
+  }
+#endif
+  scale_add_scalar(s, a, b, r, 0, n);
+}
+
+double scale_add_norm2(double s, const double* a, const double* b, double* r, size_t n)
+{
+#if defined(SCIRUN_PLA_DISPATCH)
+  switch (isa())
+  {
+  case Isa::AVX512: return scale_add_norm2_avx512(s, a, b, r, n);
+  case Isa::AVX2: return scale_add_norm2_avx2(s, a, b, r, n);
+  default: break;
+  }
+#endif
+  return scale_add_norm2_scalar(s, a, b, r, 0, n);
+}
+
+double mult_dot(const double* a, const double* b, double* r, size_t n)
+{
+#if defined(SCIRUN_PLA_DISPATCH)
+  switch (isa())
+  {
+  case Isa::AVX512: return mult_dot_avx512(a, b, r, n);
+  case Isa::AVX2: return mult_dot_avx2(a, b, r, n);
+  default: break;
+  }
+#endif
+  return mult_dot_scalar(a, b, r, 0, n);
+}
+
+void spmv(const index_type* rows, const index_type* columns, const double* data,
+  const double* x, double* r, size_t begin, size_t end)
+{
+  spmv_dispatch(rows, columns, data, x, r, begin, end, false);
+}
+
+double spmv_dot(const index_type* rows, const index_type* columns, const double* data,
+  const double* x, double* r, size_t begin, size_t end)
+{
+  return spmv_dispatch(rows, columns, data, x, r, begin, end, true);
+}
+
+void spmv(const int32_t* rows, const int32_t* columns, const float* data,
+  const double* x, double* r, size_t begin, size_t end)
+{
+  spmv_dispatch(rows, columns, data, x, r, begin, end, false);
+}
+
+double spmv_dot(const int32_t* rows, const int32_t* columns, const float* data,
+  const double* x, double* r, size_t begin, size_t end)
+{
+  return spmv_dispatch(rows, columns, data, x, r, begin, end, true);
+}
+
+}}}}}
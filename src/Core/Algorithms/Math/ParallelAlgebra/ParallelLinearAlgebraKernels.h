@@ -0,0 +1,80 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELLINEARALGEBRAKERNELS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELLINEARALGEBRAKERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+namespace Kernels {
+
+  /// Loops over [0, n) of contiguous vectors. Each kernel makes a single pass
+  /// over memory and returns the local part of any reduction it fuses in.
+  /// The vector width is picked once at run time from the CPU: AVX-512, AVX2
+  /// with FMA, or portable scalar loops.
+
+  /// "AVX-512", "AVX2" or "scalar"
+  const char* simdName();
+
+  /// returns a . b
+  double dot(const double* a, const double* b, size_t n);
+
+  /// r = s*a + b
+  void scale_add(double s, const double* a, const double* b, double* r, size_t n);
+
+  /// r = s*a + b, returns r . r
+  double scale_add_norm2(double s, const double* a, const double* b, double* r, size_t n);
+
+  /// r = a .* b, returns r . a
+  double mult_dot(const double* a, const double* b, double* r, size_t n);
+
+  /// Rows [begin, end) of r = A*x for a CSR matrix
+  void spmv(const index_type* rows, const index_type* columns, const double* data,
+    const double* x, double* r, size_t begin, size_t end);
+
+  /// Same, returns the local part of r . x
+  double spmv_dot(const index_type* rows, const index_type* columns, const double* data,
+    const double* x, double* r, size_t begin, size_t end);
+
+  /// Same for a CSR matrix with 32 bit indices and float values, which are
+  /// widened to double before they are accumulated
+  void spmv(const int32_t* rows, const int32_t* columns, const float* data,
+    const double* x, double* r, size_t begin, size_t end);
+
+  double spmv_dot(const int32_t* rows, const int32_t* columns, const float* data,
+    const double* x, double* r, size_t begin, size_t end);
+
+}}}}}
+
+#endif
@@ -0,0 +1,711 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelPreconditioners.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Thread/Parallel.h>
+#include <Core/Logging/Log.h>
+
+#include <atomic>
+#include <cmath>
+#include <numeric>
+#include <Eigen/Dense>
+
+using namespace SCIRun::Core::Algorithms::Math;
+using namespace SCIRun::Core::Algorithms;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+using namespace SCIRun;
+
+ParallelPreconditioner::~ParallelPreconditioner()
+{}
+
+namespace
+{
+  typedef Eigen::SparseMatrix<double, Eigen::RowMajor, index_type> CsrMatrix;
+  typedef ParallelLinearAlgebra::ParallelVector ParallelVector;
+
+  /// Levels narrower than this are solved by one thread, splitting them costs more
+  /// in barriers than it gains
+  const size_t MinParallelLevel = 512;
+
+  void throwSetupError(const std::string& message)
+  {
+    BOOST_THROW_EXCEPTION(AlgorithmProcessingException() << SCIRun::Core::ErrorMessage(message));
+  }
+
+  // Rows [begin, end) of a vector of the given size that belong to this solver thread
+  void threadRange(ParallelLinearAlgebra& PLA, size_t size, size_t& begin, size_t& end)
+  {
+    begin = size * PLA.proc() / PLA.nproc();
+    end = size * (PLA.proc() + 1) / PLA.nproc();
+  }
+
+  std::vector<index_type> diagonalPositions(const CsrMatrix& A, const char* method)
+  {
+    std::vector<index_type> diag(A.rows());
+    std::atomic<bool> missing(false);
+    Parallel::For(0, A.rows(), [&](size_t begin, size_t end)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        auto first = A.innerIndexPtr() + A.outerIndexPtr()[i];
+        auto last = A.innerIndexPtr() + A.outerIndexPtr()[i+1];
+        auto pos = std::lower_bound(first, last, static_cast<index_type>(i));
+        if (pos == last || *pos != static_cast<index_type>(i) || A.valuePtr()[pos - A.innerIndexPtr()] == 0.0)
+          missing = true;
+        diag[i] = pos - A.innerIndexPtr();
+      }
+    });
+    if (missing)
+      throwSetupError(std::string(method) + " preconditioner needs a non-zero diagonal in every row");
+    return diag;
+  }
+
+  // Rows of a triangular factor grouped by dependency level: a row only needs
+  // rows of earlier levels. Consecutive narrow levels are merged into one
+  // segment that a single thread solves in order.
+  class LevelSchedule
+  {
+  public:
+    struct Segment
+    {
+      size_t begin, end;
+      bool parallel;
+    };
+
+    void build(const CsrMatrix& factor, bool lower)
+    {
+      const index_type n = factor.rows();
+      std::vector<index_type> level(n, 0);
+      index_type numLevels = n > 0 ? 1 : 0;
+      auto rows = factor.outerIndexPtr();
+      auto cols = factor.innerIndexPtr();
+      for (index_type k = 0; k < n; ++k)
+      {
+        const index_type i = lower ? k : n - 1 - k;
+        index_type lvl = 0;
+        for (auto p = rows[i]; p < rows[i+1]; ++p)
+        {
+          const auto j = cols[p];
+          if (lower ? j < i : j > i)
+            lvl = std::max(lvl, level[j] + 1);
+        }
+        level[i] = lvl;
+        numLevels = std::max(numLevels, lvl + 1);
+      }
+
+      std::vector<size_t> start(numLevels + 1, 0);
+      for (index_type i = 0; i < n; ++i)
+        start[level[i] + 1]++;
+      std::partial_sum(start.begin(), start.end(), start.begin());
+      order_.resize(n);
+      std::vector<size_t> fill(start.begin(), start.end() - 1);
+      for (index_type k = 0; k < n; ++k)
+      {
+        const index_type i = lower ? k : n - 1 - k;
+        order_[fill[level[i]]++] = i;
+      }
+
+      segments_.clear();
+      for (index_type l = 0; l < numLevels; ++l)
+      {
+        const bool wide = start[l+1] - start[l] >= MinParallelLevel;
+        if (!wide && !segments_.empty() && !segments_.back().parallel)
+          segments_.back().end = start[l+1];
+        else
+          segments_.push_back({ start[l], start[l+1], wide });
+      }
+    }
+
+    // Runs rowFunc over all rows in dependency order during setup
+    template <class RowFunc>
+    void forEachRow(RowFunc rowFunc) const
+    {
+      for (const auto& seg : segments_)
+      {
+        if (seg.parallel)
+        {
+          Parallel::For(seg.begin, seg.end, [&](size_t begin, size_t end)
+          {
+            for (size_t k = begin; k < end; ++k)
+              rowFunc(order_[k]);
+          });
+        }
+        else
+        {
+          for (size_t k = seg.begin; k < seg.end; ++k)
+            rowFunc(order_[k]);
+        }
+      }
+    }
+
+    // Runs rowFunc over all rows in dependency order from within the solver threads
+    template <class RowFunc>
+    void forEachRow(ParallelLinearAlgebra& PLA, RowFunc rowFunc) const
+    {
+      for (const auto& seg : segments_)
+      {
+        if (seg.parallel)
+        {
+          size_t begin, end;
+          threadRange(PLA, seg.end - seg.begin, begin, end);
+          for (size_t k = seg.begin + begin; k < seg.begin + end; ++k)
+            rowFunc(order_[k]);
+        }
+        else if (PLA.first())
+        {
+          for (size_t k = seg.begin; k < seg.end; ++k)
+            rowFunc(order_[k]);
+        }
+        PLA.wait();
+      }
+    }
+
+  private:
+    std::vector<index_type> order_;
+    std::vector<Segment> segments_;
+  };
+
+  // One triangle (diagonal included unless unit) with its schedule
+  struct TriangularFactor
+  {
+    CsrMatrix matrix;
+    LevelSchedule schedule;
+    bool unitDiagonal;
+
+    void init(bool lower, bool unit)
+    {
+      unitDiagonal = unit;
+      schedule.build(matrix, lower);
+    }
+
+    // x = T^-1 b, x may alias b as a row only reads rows of earlier levels
+    void solve(ParallelLinearAlgebra& PLA, const double* b, double* x) const
+    {
+      auto rows = matrix.outerIndexPtr();
+      auto cols = matrix.innerIndexPtr();
+      auto vals = matrix.valuePtr();
+      schedule.forEachRow(PLA, [&](index_type i)
+      {
+        double sum = b[i];
+        double diag = 1.0;
+        for (auto p = rows[i]; p < rows[i+1]; ++p)
+        {
+          if (cols[p] == i)
+            diag = vals[p];
+          else
+            sum -= vals[p] * x[cols[p]];
+        }
+        x[i] = unitDiagonal ? sum : sum / diag;
+      });
+    }
+  };
+
+  // Incomplete factorizations can break down on matrices that are not
+  // M-matrices; they are then retried on A + shift*diag(A).
+  template <class Factorize>
+  void factorizeWithShift(const char* method, Factorize factorize)
+  {
+    double shift = 0.0;
+    for (int attempt = 0; !factorize(shift); ++attempt)
+    {
+      if (attempt == 10)
+        throwSetupError(std::string(method) + " factorization broke down, the matrix is probably not positive definite");
+      shift = (shift == 0.0) ? 1e-3 : 2.0 * shift;
+    }
+    if (shift > 0.0)
+      logWarning("{} factorization used a diagonal shift of {}", method, shift);
+  }
+
+  class ILU0Preconditioner : public ParallelPreconditioner
+  {
+  public:
+    ILU0Preconditioner(const CsrMatrix& A, bool withTranspose)
+    {
+      const auto diag = diagonalPositions(A, "ILU0");
+      LevelSchedule schedule;
+      schedule.build(A, true);
+
+      CsrMatrix LU;
+      factorizeWithShift("ILU0", [&](double shift)
+      {
+        LU = A;
+        auto rows = LU.outerIndexPtr();
+        auto cols = LU.innerIndexPtr();
+        auto vals = LU.valuePtr();
+        for (index_type i = 0; i < LU.rows(); ++i)
+          vals[diag[i]] += shift * std::fabs(vals[diag[i]]);
+
+        std::atomic<bool> success(true);
+        schedule.forEachRow([&](index_type i)
+        {
+          const auto rowEnd = rows[i+1];
+          for (auto p = rows[i]; p < diag[i]; ++p)
+          {
+            const auto k = cols[p];
+            vals[p] /= vals[diag[k]];
+            const auto lik = vals[p];
+            // a_ij -= l_ik u_kj over the entries j > k that row i has
+            auto q = diag[k] + 1;
+            auto r = p + 1;
+            while (q < rows[k+1] && r < rowEnd)
+            {
+              if (cols[q] < cols[r])
+                ++q;
+              else if (cols[r] < cols[q])
+                ++r;
+              else
+                vals[r++] -= lik * vals[q++];
+            }
+          }
+          if (!(std::fabs(vals[diag[i]]) > 1e-12 * std::fabs(A.valuePtr()[diag[i]])))
+            success = false;
+        });
+        return success.load();
+      });
+
+      L_.matrix = LU.triangularView<Eigen::StrictlyLower>();
+      L_.init(true, true);
+      U_.matrix = LU.triangularView<Eigen::Upper>();
+      U_.init(false, false);
+      if (withTranspose)
+      {
+        Ut_.matrix = U_.matrix.transpose();
+        Ut_.init(true, false);
+        Lt_.matrix = L_.matrix.transpose();
+        Lt_.init(false, true);
+      }
+    }
+
+    void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      L_.solve(PLA, r.data_, z.data_);
+      U_.solve(PLA, z.data_, z.data_);
+    }
+
+    void applyTranspose(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      Ut_.solve(PLA, r.data_, z.data_);
+      Lt_.solve(PLA, z.data_, z.data_);
+    }
+
+  private:
+    TriangularFactor L_, U_, Ut_, Lt_;
+  };
+
+  class IC0Preconditioner : public ParallelPreconditioner
+  {
+  public:
+    explicit IC0Preconditioner(const CsrMatrix& A)
+    {
+      const CsrMatrix lower = A.triangularView<Eigen::Lower>();
+      // The diagonal is the last entry of each row of the lower triangle
+      const auto diag = diagonalPositions(lower, "IC0");
+      LevelSchedule schedule;
+      schedule.build(lower, true);
+
+      CsrMatrix L;
+      factorizeWithShift("IC0", [&](double shift)
+      {
+        L = lower;
+        auto rows = L.outerIndexPtr();
+        auto cols = L.innerIndexPtr();
+        auto vals = L.valuePtr();
+
+        std::atomic<bool> success(true);
+        schedule.forEachRow([&](index_type i)
+        {
+          for (auto p = rows[i]; p < diag[i]; ++p)
+          {
+            const auto j = cols[p];
+            // l_ij = (a_ij - sum_k<j l_ik l_jk) / l_jj
+            double sum = vals[p];
+            auto q = rows[j];
+            auto r = rows[i];
+            while (q < diag[j] && r < p)
+            {
+              if (cols[q] < cols[r])
+                ++q;
+              else if (cols[r] < cols[q])
+                ++r;
+              else
+                sum -= vals[r++] * vals[q++];
+            }
+            vals[p] = sum / vals[diag[j]];
+          }
+          const double aii = vals[diag[i]] * (1.0 + shift);
+          double d = aii;
+          for (auto p = rows[i]; p < diag[i]; ++p)
+            d -= vals[p] * vals[p];
+          if (!(d > 1e-12 * std::fabs(aii)))
+          {
+            success = false;
+            d = std::fabs(aii);
+          }
+          vals[diag[i]] = std::sqrt(d);
+        });
+        return success.load();
+      });
+
+      L_.matrix = L;
+      L_.init(true, false);
+      Lt_.matrix = L.transpose();
+      Lt_.init(false, false);
+    }
+
+    void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override
+    {
+      L_.solve(PLA, r.data_, z.data_);
+      Lt_.solve(PLA, z.data_, z.data_);
+    }
+
+  private:
+    TriangularFactor L_, Lt_;
+  };
+
+  /// Smoothed aggregation AMG (Vanek, Mandel, Brezina) used as one symmetric
+  /// V-cycle with damped Jacobi smoothing per application.
+  class SmoothedAggregationAMG : public ParallelPreconditioner
+  {
+  public:
+    explicit SmoothedAggregationAMG(const CsrMatrix& A);
+    void apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z) override;
+
+  private:
+    struct Level
+    {
+      const CsrMatrix* A;
+      CsrMatrix ownedA;
+      // Prolongation from the next coarser level and its transpose
+      CsrMatrix P, R;
+      std::vector<double> invDiag;
+      double omega;
+      std::vector<double> b, x, r;
+    };
+
+    static const int Sweeps = 2;
+    static const index_type MaxLevels = 12;
+    static const index_type MaxDirectSize = 1000;
+
+    index_type aggregate(const Level& level, std::vector<index_type>& agg) const;
+    void residual(Level& level, const double* b, const double* x, size_t begin, size_t end);
+    void smooth(ParallelLinearAlgebra& PLA, Level& level, const double* b, double* x, int sweeps, bool zeroGuess);
+    void cycle(ParallelLinearAlgebra& PLA, size_t l, const double* b, double* x);
+
+    std::vector<Level> levels_;
+    Eigen::MatrixXd coarseInverse_;
+    std::vector<double> scratch_;
+  };
+
+  SmoothedAggregationAMG::SmoothedAggregationAMG(const CsrMatrix& fine) : scratch_(fine.rows())
+  {
+    // Reserved up front so that the level operators can point into the vector
+    levels_.reserve(MaxLevels);
+    levels_.emplace_back();
+    levels_.back().A = &fine;
+
+    while (true)
+    {
+      auto& level = levels_.back();
+      const auto& A = *level.A;
+      const auto n = A.rows();
+      const auto diag = diagonalPositions(A, "AMG");
+
+      level.invDiag.resize(n);
+      level.r.resize(n);
+      for (index_type i = 0; i < n; ++i)
+        level.invDiag[i] = 1.0 / A.valuePtr()[diag[i]];
+
+      // Gershgorin bound on the spectral radius of D^-1 A
+      const double rho = Parallel::Reduce(0, n, 0.0, [&](size_t begin, size_t end, double value)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          double sum = 0.0;
+          for (auto p = A.outerIndexPtr()[i]; p < A.outerIndexPtr()[i+1]; ++p)
+            sum += std::fabs(A.valuePtr()[p]);
+          value = std::max(value, sum * std::fabs(level.invDiag[i]));
+        }
+        return value;
+      }, [](double a, double b) { return std::max(a, b); });
+      level.omega = 4.0 / (3.0 * rho);
+
+      if (n <= MaxDirectSize || static_cast<index_type>(levels_.size()) == MaxLevels)
+        break;
+
+      std::vector<index_type> agg;
+      const auto nc = aggregate(level, agg);
+      if (nc == 0 || nc > (4 * n) / 5)
+        break;
+
+      // Tentative prolongator: normalized piecewise constants on the aggregates
+      std::vector<double> aggSize(nc, 0.0);
+      for (index_type i = 0; i < n; ++i)
+        aggSize[agg[i]] += 1.0;
+      CsrMatrix P0(n, nc);
+      P0.reserve(Eigen::VectorXi::Constant(n, 1));
+      for (index_type i = 0; i < n; ++i)
+        P0.insert(i, agg[i]) = 1.0 / std::sqrt(aggSize[agg[i]]);
+      P0.makeCompressed();
+
+      // P = (I - omega D^-1 A) P0, coarse operator R A P with R = P^T
+      Eigen::Map<const Eigen::VectorXd> invDiag(&level.invDiag[0], n);
+      const CsrMatrix DinvA = invDiag.asDiagonal() * A;
+      const CsrMatrix smoothing = DinvA * P0;
+      level.P = P0 - level.omega * smoothing;
+      level.R = level.P.transpose();
+      const CsrMatrix AP = A * level.P;
+
+      levels_.emplace_back();
+      auto& coarse = levels_.back();
+      coarse.ownedA = level.R * AP;
+      coarse.A = &coarse.ownedA;
+      coarse.b.resize(nc);
+      coarse.x.resize(nc);
+    }
+
+    const auto& coarsest = *levels_.back().A;
+    if (coarsest.rows() <= MaxDirectSize)
+    {
+      // Pseudo-inverse, as FE stiffness matrices without Dirichlet conditions are singular
+      const Eigen::MatrixXd dense(coarsest);
+      Eigen::SelfAdjointEigenSolver<Eigen::MatrixXd> eigen(dense);
+      const auto& values = eigen.eigenvalues();
+      const double cutoff = 1e-12 * values.cwiseAbs().maxCoeff();
+      Eigen::VectorXd inverted(values.size());
+      for (index_type i = 0; i < values.size(); ++i)
+        inverted[i] = std::fabs(values[i]) > cutoff ? 1.0 / values[i] : 0.0;
+      coarseInverse_ = eigen.eigenvectors() * inverted.asDiagonal() * eigen.eigenvectors().transpose();
+    }
+
+    LOG_DEBUG("AMG hierarchy with {} levels, coarsest size {}", levels_.size(), coarsest.rows());
+  }
+
+  // Greedy aggregation over the strong connections |a_ij| > theta sqrt(|a_ii a_jj|)
+  index_type SmoothedAggregationAMG::aggregate(const Level& level, std::vector<index_type>& agg) const
+  {
+    const double theta = 0.08;
+    const auto& A = *level.A;
+    const auto n = A.rows();
+    auto rows = A.outerIndexPtr();
+    auto cols = A.innerIndexPtr();
+    auto vals = A.valuePtr();
+
+    auto strong = [&](index_type i, index_type p)
+    {
+      const auto j = cols[p];
+      return j != i && vals[p] * vals[p] > theta * theta / std::fabs(level.invDiag[i] * level.invDiag[j]);
+    };
+
+    agg.assign(n, -1);
+    index_type nc = 0;
+
+    // Roots whose strong neighborhood is still free start an aggregate
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0)
+        continue;
+      bool free = true, connected = false;
+      for (auto p = rows[i]; p < rows[i+1] && free; ++p)
+      {
+        if (strong(i, p))
+        {
+          connected = true;
+          free = agg[cols[p]] < 0;
+        }
+      }
+      if (!free || !connected)
+        continue;
+      agg[i] = nc;
+      for (auto p = rows[i]; p < rows[i+1]; ++p)
+        if (strong(i, p))
+          agg[cols[p]] = nc;
+      nc++;
+    }
+
+    // Attach the rest to a neighboring aggregate of the first pass
+    std::vector<index_type> attached(agg);
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0)
+        continue;
+      for (auto p = rows[i]; p < rows[i+1]; ++p)
+      {
+        if (strong(i, p) && agg[cols[p]] >= 0)
+        {
+          attached[i] = agg[cols[p]];
+          break;
+        }
+      }
+    }
+    agg.swap(attached);
+
+    // Whatever is left forms aggregates with its free neighbors
+    for (index_type i = 0; i < n; ++i)
+    {
+      if (agg[i] >= 0)
+        continue;
+      agg[i] = nc;
+      for (auto p = rows[i]; p < rows[i+1]; ++p)
+        if (strong(i, p) && agg[cols[p]] < 0)
+          agg[cols[p]] = nc;
+      nc++;
+    }
+    return nc;
+  }
+
+  void SmoothedAggregationAMG::residual(Level& level, const double* b, const double* x, size_t begin, size_t end)
+  {
+    const auto& A = *level.A;
+    auto rows = A.outerIndexPtr();
+    auto cols = A.innerIndexPtr();
+    auto vals = A.valuePtr();
+    auto r = &level.r[0];
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = b[i];
+      for (auto p = rows[i]; p < rows[i+1]; ++p)
+        sum -= vals[p] * x[cols[p]];
+      r[i] = sum;
+    }
+  }
+
+  // Damped Jacobi sweeps, the first one from a zero guess if requested
+  void SmoothedAggregationAMG::smooth(ParallelLinearAlgebra& PLA, Level& level, const double* b, double* x, int sweeps, bool zeroGuess)
+  {
+    size_t begin, end;
+    threadRange(PLA, level.invDiag.size(), begin, end);
+    const auto omega = level.omega;
+    int sweep = 0;
+    if (zeroGuess)
+    {
+      for (size_t i = begin; i < end; ++i)
+        x[i] = omega * level.invDiag[i] * b[i];
+      sweep = 1;
+    }
+    for (; sweep < sweeps; ++sweep)
+    {
+      PLA.wait();
+      residual(level, b, x, begin, end);
+      PLA.wait();
+      for (size_t i = begin; i < end; ++i)
+        x[i] += omega * level.invDiag[i] * level.r[i];
+    }
+    PLA.wait();
+  }
+
+  void SmoothedAggregationAMG::cycle(ParallelLinearAlgebra& PLA, size_t l, const double* b, double* x)
+  {
+    auto& level = levels_[l];
+    if (l + 1 == levels_.size())
+    {
+      if (coarseInverse_.size() > 0)
+      {
+        if (PLA.first())
+        {
+          const auto n = coarseInverse_.rows();
+          Eigen::Map<Eigen::VectorXd>(x, n) = coarseInverse_ * Eigen::Map<const Eigen::VectorXd>(b, n);
+        }
+        PLA.wait();
+      }
+      else
+      {
+        smooth(PLA, level, b, x, 2 * Sweeps, true);
+      }
+      return;
+    }
+
+    auto& coarse = levels_[l+1];
+    size_t begin, end;
+
+    smooth(PLA, level, b, x, Sweeps, true);
+    threadRange(PLA, level.invDiag.size(), begin, end);
+    residual(level, b, x, begin, end);
+    PLA.wait();
+
+    // Restrict the residual
+    threadRange(PLA, coarse.b.size(), begin, end);
+    auto rows = level.R.outerIndexPtr();
+    auto cols = level.R.innerIndexPtr();
+    auto vals = level.R.valuePtr();
+    for (size_t c = begin; c < end; ++c)
+    {
+      double sum = 0.0;
+      for (auto p = rows[c]; p < rows[c+1]; ++p)
+        sum += vals[p] * level.r[cols[p]];
+      coarse.b[c] = sum;
+    }
+    PLA.wait();
+
+    cycle(PLA, l + 1, &coarse.b[0], &coarse.x[0]);
+
+    // Prolongate the correction
+    threadRange(PLA, level.invDiag.size(), begin, end);
+    rows = level.P.outerIndexPtr();
+    cols = level.P.innerIndexPtr();
+    vals = level.P.valuePtr();
+    for (size_t i = begin; i < end; ++i)
+    {
+      double sum = 0.0;
+      for (auto p = rows[i]; p < rows[i+1]; ++p)
+        sum += vals[p] * coarse.x[cols[p]];
+      x[i] += sum;
+    }
+
+    smooth(PLA, level, b, x, Sweeps, false);
+  }
+
+  void SmoothedAggregationAMG::apply(ParallelLinearAlgebra& PLA, const ParallelVector& r, ParallelVector& z)
+  {
+    const double* b = r.data_;
+    if (r.data_ == z.data_)
+    {
+      size_t begin, end;
+      threadRange(PLA, scratch_.size(), begin, end);
+      std::copy(r.data_ + begin, r.data_ + end, scratch_.begin() + begin);
+      PLA.wait();
+      b = &scratch_[0];
+    }
+    cycle(PLA, 0, b, z.data_);
+  }
+}
+
+ParallelPreconditionerHandle SCIRun::Core::Algorithms::Math::makeParallelPreconditioner(const std::string& name,
+  const SparseRowMatrix& A, bool withTranspose)
+{
+  if (name == "AMG")
+    return makeShared<SmoothedAggregationAMG>(A);
+  if (name == "IC0")
+    return makeShared<IC0Preconditioner>(A);
+  if (name == "ILU0")
+    return makeShared<ILU0Preconditioner>(A, withTranspose);
+  return nullptr;
+}
@@ -0,0 +1,77 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+#define CORE_ALGORITHMS_MATH_PARALLELALGEBRA_PARALLELPRECONDITIONERS_H
+
+#include <string>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
+#include <Core/Algorithms/Math/share.h>
+
+namespace SCIRun {
+namespace Core {
+namespace Algorithms {
+namespace Math {
+
+  /// Preconditioner z = M^-1 r for the solvers built on ParallelLinearAlgebra.
+  /// It is set up once from the system matrix before the solver threads start;
+  /// apply() is then called by every solver thread with the same vectors and
+  /// returns once z is complete for all of them. z may alias r.
+  class SCISHARE ParallelPreconditioner : boost::noncopyable
+  {
+  public:
+    virtual ~ParallelPreconditioner();
+
+    virtual void apply(ParallelLinearAlgebra& PLA,
+                       const ParallelLinearAlgebra::ParallelVector& r,
+                       ParallelLinearAlgebra::ParallelVector& z) = 0;
+
+    /// z = M^-T r, used for the shadow system of BiCG
+    virtual void applyTranspose(ParallelLinearAlgebra& PLA,
+                                const ParallelLinearAlgebra::ParallelVector& r,
+                                ParallelLinearAlgebra::ParallelVector& z)
+    {
+      apply(PLA, r, z);
+    }
+  };
+
+  typedef SharedPointer<ParallelPreconditioner> ParallelPreconditionerHandle;
+
+  /// Builds the preconditioner selected through Variables::Preconditioner:
+  ///  AMG  - smoothed aggregation algebraic multigrid V-cycle, for SPD systems
+  ///  IC0  - incomplete Cholesky without fill, for SPD systems
+  ///  ILU0 - incomplete LU without fill
+  /// The triangular solves are level scheduled over the solver threads.
+  /// Returns null for None and Jacobi, which the solvers handle with a diagonal
+  /// vector. Throws AlgorithmProcessingException if the setup fails.
+  SCISHARE ParallelPreconditionerHandle makeParallelPreconditioner(const std::string& name,
+    const Datatypes::SparseRowMatrix& A, bool withTranspose);
+
+}}}}
+
+#endif
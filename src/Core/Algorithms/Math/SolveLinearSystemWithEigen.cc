@@ -89,6 +89,11 @@ SolveLinearSystemAlgorithm::ComplexOutputs SolveLinearSystemAlgorithm::run(const
   return runImpl<ComplexInputs, ComplexOutputs>(input, params);
 }
 
+SolveLinearSystemAlgorithm::BlockOutputs SolveLinearSystemAlgorithm::run(const BlockInputs& input, const Parameters& params) const
+{
+  return runImpl<BlockInputs, BlockOutputs>(input, params);
+}
+
 template <typename T>
 using CG = Eigen::ConjugateGradient<T>;
 // Not available yet, need to upgrade Eigen
@@ -114,7 +119,7 @@ Out SolveLinearSystemAlgorithm::runImpl(const In& input, const Parameters& param
 
   auto method = std::get<2>(params);
 
-  using SolutionType = DenseColumnMatrixGeneric<typename std::tuple_element<0, In>::type::element_type::value_type>;
+  using SolutionType = typename std::tuple_element<1, In>::type::element_type;
   using AlgoTypeCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, CG>;
   using AlgoTypeBiCG = SolveLinearSystemAlgorithmEigenCGImpl<SolutionType, BiCG>;
 
@@ -46,9 +46,13 @@ namespace Math {
     typedef std::tuple<double, int, std::string> Parameters;
     typedef std::tuple<SCIRun::Core::Datatypes::DenseColumnMatrixHandle, double, int> Outputs;
     typedef std::tuple<SCIRun::Core::Datatypes::ComplexDenseColumnMatrixHandle, double, int> ComplexOutputs;
+    typedef std::tuple<SCIRun::Core::Datatypes::MatrixHandle, SCIRun::Core::Datatypes::DenseMatrixHandle> BlockInputs;
+    typedef std::tuple<SCIRun::Core::Datatypes::DenseMatrixHandle, double, int> BlockOutputs;
 
     Outputs run(const Inputs& input, const Parameters& params) const;
     ComplexOutputs run(const ComplexInputs& input, const Parameters& params) const;
+    /// Solves for every column of the rhs matrix, reusing one solver and preconditioner setup.
+    BlockOutputs run(const BlockInputs& input, const Parameters& params) const;
 
     AlgorithmOutput run(const AlgorithmInput& input) const override;
   private:
@@ -976,3 +976,192 @@ TEST(ParallelArithmeticTests, CanComputeDotProductMulti)
   EXPECT_EQ(-9 , v23);
   EXPECT_EQ(9 , v13);
 }
+
+namespace
+{
+  DenseMatrixHandle block1()
+  {
+    DenseMatrixHandle m(makeShared<DenseMatrix>(size, 2, 0.0));
+    m->col(0) = *vector1();
+    m->col(1) = *vector3();
+    return m;
+  }
+
+  SolverInputs getDummyBlockSystem()
+  {
+    SolverInputs system;
+    system.A = matrix1();
+    system.B = block1();
+    system.X = block1();
+    system.X0 = block1();
+    return system;
+  }
+}
+
+TEST(ParallelArithmeticTests, CanMultiplyMatrixByBlockMulti)
+{
+  ParallelLinearAlgebraSharedData data(getDummyBlockSystem(), 2);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  ParallelLinearAlgebra::ParallelBlock b1, bR;
+  auto mat1 = matrix1();
+  auto blk1 = block1();
+  auto blkR = block1();
+  blkR->setZero();
+  const ParallelLinearAlgebra::ColumnSet both = { 0, 1 };
+  std::vector<double> dots;
+
+  auto task = [&](int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    pla.add_matrix(mat1, m1);
+    pla.add_block(blk1, b1);
+    pla.add_block(blkR, bR);
+    pla.mult(m1, b1, bR, both);
+    std::vector<double> d;
+    pla.dot(bR, b1, d, both);
+    if (pla.first())
+      dots = d;
+  };
+  std::thread t1(task, 0);
+  std::thread t2(task, 1);
+  t1.join();
+  t2.join();
+
+  EXPECT_EQ(1, (*blkR)(0,0));
+  EXPECT_EQ(-4, (*blkR)(1,0));
+  EXPECT_EQ(-2, (*blkR)(size-1,0));
+  EXPECT_EQ(0, (*blkR)(0,1));
+  EXPECT_EQ(0, (*blkR)(1,1));
+  EXPECT_EQ(-14, (*blkR)(size-1,1));
+
+  ASSERT_EQ(2, dots.size());
+  EXPECT_EQ(1 - 8 + 2, dots[0]);
+  EXPECT_EQ(98, dots[1]);
+}
+
+TEST(ParallelArithmeticTests, BlockOperationsOnlyTouchSelectedColumns)
+{
+  ParallelLinearAlgebraSharedData data(getDummyBlockSystem(), 1);
+  ParallelLinearAlgebra pla(data, 0);
+
+  ParallelLinearAlgebra::ParallelBlock b1, bR;
+  auto blk1 = block1();
+  auto blkR = block1();
+  pla.add_block(blk1, b1);
+  pla.add_block(blkR, bR);
+
+  const ParallelLinearAlgebra::ColumnSet second = { 1 };
+  pla.scale_add({ 0.0, 2.0 }, b1, b1, bR, second);
+
+  EXPECT_EQ(blk1->col(0), blkR->col(0));
+  EXPECT_EQ(DenseColumnMatrix(3 * blk1->col(1)), DenseColumnMatrix(blkR->col(1)));
+}
+
+TEST(ParallelArithmeticTests, FusedKernelsMatchSeparateOperationsMulti)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(), 2);
+
+  ParallelLinearAlgebra::ParallelMatrix m1;
+  ParallelLinearAlgebra::ParallelVector v1, v2, vR;
+  auto mat1 = matrix1();
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vecR = vector3();
+  double spmvDot = 0, multDot = 0, norm = 0;
+
+  auto task = [&](int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    pla.add_matrix(mat1, m1);
+    pla.add_vector(vec1, v1);
+    pla.add_vector(vec2, v2);
+    pla.add_vector(vecR, vR);
+    const double d1 = pla.mult_dot(m1, v1, vR);
+    const double d2 = pla.mult_dot(v1, v2, vR);
+    const double n = pla.scale_add_norm(2.0, v1, v2, vR);
+    if (pla.first())
+    {
+      spmvDot = d1;
+      multDot = d2;
+      norm = n;
+    }
+  };
+  std::thread t1(task, 0);
+  std::thread t2(task, 1);
+  t1.join();
+  t2.join();
+
+  // A*v1 = (1, -4, 0, ..., -2)
+  EXPECT_EQ(1 - 8 + 2, spmvDot);
+  // v1.*v2 = (-1, -4, -16, ..., -1)
+  EXPECT_EQ(-1 - 8 - 64 + 1, multDot);
+  DenseColumnMatrix expected = 2.0 * *vec1 + *vec2;
+  EXPECT_EQ(expected, *vecR);
+  EXPECT_DOUBLE_EQ(expected.norm(), norm);
+}
+
+TEST(ParallelArithmeticTests, CanReduceSeveralLocalDotProductsAtOnceMulti)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(), 2);
+
+  ParallelLinearAlgebra::ParallelVector v1, v2, v3;
+  auto vec1 = vector1();
+  auto vec2 = vector2();
+  auto vec3 = vector3();
+  double sums[3] = { 0, 0, 0 };
+
+  auto task = [&](int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    pla.add_vector(vec1, v1);
+    pla.add_vector(vec2, v2);
+    pla.add_vector(vec3, v3);
+    double local[3] = { pla.local_dot(v1, v2), pla.local_dot(v2, v3), pla.local_dot(v1, v3) };
+    pla.reduce_sum(local, 3);
+    if (pla.first())
+      std::copy(local, local + 3, sums);
+  };
+  std::thread t1(task, 0);
+  std::thread t2(task, 1);
+  t1.join();
+  t2.join();
+
+  EXPECT_EQ(-22, sums[0]);
+  EXPECT_EQ(-9, sums[1]);
+  EXPECT_EQ(9, sums[2]);
+}
+
+TEST(ParallelArithmeticTests, CanMultiplyCompactMatrixByVectorMulti)
+{
+  ParallelLinearAlgebraSharedData data(getDummySystem(), 2);
+
+  ParallelLinearAlgebra::ParallelCompactMatrix m1;
+  ParallelLinearAlgebra::ParallelVector v1, vR;
+  auto mat1 = makeShared<CompactSparseMatrix>(*matrix1());
+  auto vec1 = vector1();
+  auto vecR = vector3();
+  double spmvDot = 0;
+
+  auto task = [&](int proc)
+  {
+    ParallelLinearAlgebra pla(data, proc);
+    pla.add_matrix(mat1, m1);
+    pla.add_vector(vec1, v1);
+    pla.add_vector(vecR, vR);
+    const double d = pla.mult_dot(m1, v1, vR);
+    if (pla.first())
+      spmvDot = d;
+  };
+  std::thread t1(task, 0);
+  std::thread t2(task, 1);
+  t1.join();
+  t2.join();
+
+  EXPECT_EQ(3, m1.nnz_);
+  EXPECT_EQ(1, (*vecR)[0]);
+  EXPECT_EQ(-4, (*vecR)[1]);
+  EXPECT_EQ(0, (*vecR)[2]);
+  EXPECT_EQ(-2, (*vecR)[size-1]);
+  EXPECT_EQ(1 - 8 + 2, spmvDot);
+}
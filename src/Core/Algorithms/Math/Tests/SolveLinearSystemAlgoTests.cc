@@ -31,6 +31,7 @@
 #include <fstream>
 #include <boost/filesystem.hpp>
 #include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
+#include <Core/Algorithms/Math/ParallelAlgebra/ParallelLinearAlgebra.h>
 #include <Core/Algorithms/DataIO/ReadMatrix.h>
 #include <Core/Algorithms/DataIO/WriteMatrix.h>
 #include <Core/Datatypes/DenseMatrix.h>
@@ -40,6 +41,7 @@
 #include <Core/Datatypes/MatrixTypeConversions.h>
 #include <Core/Datatypes/MatrixIO.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 
 using namespace SCIRun::Core::Datatypes;
@@ -147,3 +149,282 @@ TEST(SolveLinearSystemTests, DISABLED_CanSolveDarrell_MINRES)
   double solutionError = 2.4;
   CanSolveDarrellWithMethod("minres", solutionError);
 }
+
+namespace
+{
+  // 7-point finite difference Laplacian on an n^3 grid with Dirichlet boundaries,
+  // plus an optional first order upwind convection term in x that makes it nonsymmetric
+  SparseRowMatrixHandle laplacian3D(int n, double convection = 0)
+  {
+    std::vector<Eigen::Triplet<double>> triplets;
+    auto index = [n](int i, int j, int k) { return (k * n + j) * n + i; };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          const int row = index(i, j, k);
+          triplets.emplace_back(row, row, 6.0 + convection);
+          if (i > 0) triplets.emplace_back(row, index(i - 1, j, k), -1.0 - convection);
+          if (i < n - 1) triplets.emplace_back(row, index(i + 1, j, k), -1.0);
+          if (j > 0) triplets.emplace_back(row, index(i, j - 1, k), -1.0);
+          if (j < n - 1) triplets.emplace_back(row, index(i, j + 1, k), -1.0);
+          if (k > 0) triplets.emplace_back(row, index(i, j, k - 1), -1.0);
+          if (k < n - 1) triplets.emplace_back(row, index(i, j, k + 1), -1.0);
+        }
+    auto A = makeShared<SparseRowMatrix>(n * n * n, n * n * n);
+    A->setFromTriplets(triplets.begin(), triplets.end());
+    return A;
+  }
+
+  double relativeResidual(const SparseRowMatrix& A, const DenseColumnMatrix& b, const DenseColumnMatrix& x)
+  {
+    DenseColumnMatrix r = b - A * x;
+    return r.norm() / b.norm();
+  }
+
+  double solveWith(SparseRowMatrixHandle A, const std::string& method, const std::string& preconditioner, int maxIterations)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, maxIterations);
+    algo.set(Variables::TargetError, 1e-8);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    auto b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(A->nrows()));
+    DenseColumnMatrixHandle x;
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return relativeResidual(*A, *b, *x);
+  }
+}
+
+TEST(SolveLinearSystemPreconditionerTests, JacobiNeedsManyIterations)
+{
+  auto A = laplacian3D(24);
+  EXPECT_GT(solveWith(A, "cg", "Jacobi", 25), 1e-6);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, AMGConvergesQuickly)
+{
+  auto A = laplacian3D(24);
+  EXPECT_LT(solveWith(A, "cg", "AMG", 25), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, IC0ConvergesWithCG)
+{
+  auto A = laplacian3D(24);
+  EXPECT_LT(solveWith(A, "cg", "IC0", 60), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, ILU0ConvergesWithCG)
+{
+  auto A = laplacian3D(24);
+  EXPECT_LT(solveWith(A, "cg", "ILU0", 60), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, AMGWorksWithMINRES)
+{
+  auto A = laplacian3D(16);
+  EXPECT_LT(solveWith(A, "minres", "AMG", 40), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, ILU0WorksWithBiCGOnNonsymmetricSystem)
+{
+  auto A = laplacian3D(16, 2.0);
+  EXPECT_LT(solveWith(A, "bicg", "ILU0", 60), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, PipelinedCGConvergesWithoutPreconditioner)
+{
+  auto A = laplacian3D(12);
+  EXPECT_LT(solveWith(A, "pipecg", "None", 200), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, PipelinedCGConvergesWithJacobi)
+{
+  auto A = laplacian3D(12);
+  EXPECT_LT(solveWith(A, "pipecg", "Jacobi", 200), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, PipelinedCGConvergesWithAMG)
+{
+  auto A = laplacian3D(16);
+  EXPECT_LT(solveWith(A, "pipecg", "AMG", 25), 1e-7);
+}
+
+TEST(SolveLinearSystemPreconditionerTests, PipelinedCGMatchesCG)
+{
+  auto A = laplacian3D(10);
+  auto b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(A->nrows()));
+  DenseColumnMatrixHandle x, xPipelined;
+  SolveLinearSystemAlgo algo;
+  algo.set(Variables::TargetError, 1e-8);
+  algo.setOption(Variables::Method, std::string("cg"));
+  algo.setUpdaterFunc([](double) {});
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+  algo.setOption(Variables::Method, std::string("pipecg"));
+  ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), xPipelined));
+  EXPECT_LT((*x - *xPipelined).norm(), 1e-6 * x->norm());
+}
+
+namespace
+{
+  double solveMixedWith(SparseRowMatrixHandle A, const std::string& method, const std::string& preconditioner, double tolerance)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 500);
+    algo.set(Variables::TargetError, tolerance);
+    algo.set(Parameters::MixedPrecision, true);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+
+    auto b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(A->nrows()));
+    DenseColumnMatrixHandle x;
+    EXPECT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    return relativeResidual(*A, *b, *x);
+  }
+}
+
+TEST(SolveLinearSystemMixedPrecisionTests, RefinementReachesDoubleAccuracy)
+{
+  auto A = laplacian3D(12);
+  EXPECT_LT(solveMixedWith(A, "cg", "Jacobi", 1e-12), 1e-12);
+}
+
+TEST(SolveLinearSystemMixedPrecisionTests, WorksWithAMG)
+{
+  auto A = laplacian3D(16);
+  EXPECT_LT(solveMixedWith(A, "cg", "AMG", 1e-11), 1e-11);
+}
+
+TEST(SolveLinearSystemMixedPrecisionTests, OtherMethodsIgnoreIt)
+{
+  auto A = laplacian3D(8, 0.5);
+  EXPECT_LT(solveMixedWith(A, "bicg", "Jacobi", 1e-8), 1e-8);
+}
+
+TEST(SolveLinearSystemMixedPrecisionTests, CompactMatrixHalvesStorage)
+{
+  auto A = laplacian3D(10);
+  CompactSparseMatrix compact(*A);
+  const size_t full = (A->nrows() + 1 + A->nonZeros()) * sizeof(index_type) + A->nonZeros() * sizeof(double);
+  EXPECT_EQ(A->nonZeros(), compact.nonZeros());
+  EXPECT_EQ(A->nrows(), compact.nrows());
+  EXPECT_EQ(full / 2, compact.memorySize());
+}
+
+TEST(SolveLinearSystemPreconditionerTests, ILU0RejectsMissingDiagonal)
+{
+  auto A = makeShared<SparseRowMatrix>(2, 2);
+  A->insert(0, 1) = 1.0;
+  A->insert(1, 0) = 1.0;
+  A->makeCompressed();
+
+  SolveLinearSystemAlgo algo;
+  algo.setOption(Variables::Preconditioner, std::string("ILU0"));
+  auto b = makeShared<DenseColumnMatrix>(DenseColumnMatrix::Ones(2));
+  DenseColumnMatrixHandle x;
+  EXPECT_THROW(algo.run(A, b, DenseColumnMatrixHandle(), x), AlgorithmProcessingException);
+}
+
+namespace
+{
+  DenseMatrixHandle electrodeColumns(int n, int k)
+  {
+    auto B = makeShared<DenseMatrix>(n, k, 0.0);
+    for (int c = 0; c < k; ++c)
+    {
+      (*B)((c * 7919) % n, c) = 1.0;
+      (*B)((c * 104729 + n / 2) % n, c) = -1.0;
+    }
+    return B;
+  }
+
+  SolveLinearSystemAlgo blockAlgo(const std::string& method, const std::string& preconditioner)
+  {
+    SolveLinearSystemAlgo algo;
+    algo.set(Variables::MaxIterations, 200);
+    algo.set(Variables::TargetError, 1e-8);
+    algo.setOption(Variables::Method, method);
+    algo.setOption(Variables::Preconditioner, preconditioner);
+    algo.setUpdaterFunc([](double) {});
+    return algo;
+  }
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGMatchesColumnByColumnSolves)
+{
+  auto A = laplacian3D(12);
+  auto B = electrodeColumns(A->nrows(), 6);
+  auto algo = blockAlgo("cg", "Jacobi");
+
+  DenseMatrixHandle X, convergence;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X, convergence));
+  ASSERT_EQ(B->ncols(), X->ncols());
+  ASSERT_EQ(B->ncols(), convergence->ncols());
+
+  for (size_t c = 0; c < B->ncols(); ++c)
+  {
+    auto b = makeShared<DenseColumnMatrix>(B->col(c));
+    DenseColumnMatrixHandle x;
+    ASSERT_TRUE(algo.run(A, b, DenseColumnMatrixHandle(), x));
+    DenseColumnMatrix xc = X->col(c);
+    EXPECT_LT((xc - *x).norm(), 1e-6 * x->norm());
+    EXPECT_LT(relativeResidual(*A, *b, xc), 1e-8);
+  }
+}
+
+TEST(SolveLinearSystemBlockTests, BlockCGSharesPreconditionerSetup)
+{
+  auto A = laplacian3D(16);
+  auto B = electrodeColumns(A->nrows(), 4);
+  auto algo = blockAlgo("cg", "AMG");
+
+  DenseMatrixHandle X, convergence;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X, convergence));
+  for (size_t c = 0; c < B->ncols(); ++c)
+    EXPECT_LT(relativeResidual(*A, DenseColumnMatrix(B->col(c)), DenseColumnMatrix(X->col(c))), 1e-8);
+}
+
+TEST(SolveLinearSystemBlockTests, ConvergedColumnsStopIterating)
+{
+  auto A = laplacian3D(10);
+  auto B = electrodeColumns(A->nrows(), 3);
+  B->col(1).setZero();
+  auto algo = blockAlgo("cg", "None");
+
+  DenseMatrixHandle X, convergence;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X, convergence));
+  EXPECT_EQ(0.0, X->col(1).norm());
+  EXPECT_EQ(0.0, convergence->col(1).norm());
+  EXPECT_LT((*convergence)(0, 0), 1.0);
+}
+
+TEST(SolveLinearSystemBlockTests, OtherMethodsSolveColumnByColumn)
+{
+  auto A = laplacian3D(8);
+  auto B = electrodeColumns(A->nrows(), 2);
+  auto algo = blockAlgo("minres", "Jacobi");
+
+  DenseMatrixHandle X, convergence;
+  ASSERT_TRUE(algo.run(A, B, DenseMatrixHandle(), X, convergence));
+  for (size_t c = 0; c < B->ncols(); ++c)
+    EXPECT_LT(relativeResidual(*A, DenseColumnMatrix(B->col(c)), DenseColumnMatrix(X->col(c))), 1e-7);
+}
+
+TEST(SolveLinearSystemBlockTests, AlgorithmInputAcceptsMatrixOfRightHandSides)
+{
+  auto A = laplacian3D(8);
+  auto B = electrodeColumns(A->nrows(), 3);
+  auto algo = blockAlgo("cg", "Jacobi");
+
+  AlgorithmInput input;
+  input[Variables::LHS] = A;
+  input[Variables::RHS] = B;
+  auto output = algo.run(input);
+  auto X = output.get<DenseMatrix>(Variables::Solution);
+  ASSERT_TRUE(X != nullptr);
+  EXPECT_EQ(3, X->ncols());
+  EXPECT_EQ(A->nrows(), X->nrows());
+}
@@ -374,3 +374,30 @@ TEST(EigenSparseSolverTest, DISABLED_CanSolveBigSystem)
   }
 }
 #endif
+
+TEST(SolveLinearSystemWithEigenAlgorithmTests, CanSolveMultipleRightHandSides)
+{
+  const int n = 20;
+  SparseRowMatrixHandle A(new SparseRowMatrix(n, n));
+  for (int i = 0; i < n; ++i)
+  {
+    A->insert(i, i) = 2;
+    if (i > 0)
+      A->insert(i, i - 1) = -1;
+    if (i < n - 1)
+      A->insert(i, i + 1) = -1;
+  }
+  A->makeCompressed();
+
+  DenseMatrix expected(n, 3);
+  expected.setRandom();
+  DenseMatrixHandle rhs(new DenseMatrix(*A * expected));
+
+  SolveLinearSystemAlgorithm algo;
+  auto x = algo.run(std::make_tuple(A, rhs), std::make_tuple(1e-12, 100, std::string("cg")));
+  auto solution = std::get<0>(x);
+
+  ASSERT_TRUE(solution != nullptr);
+  ASSERT_EQ(3, solution->ncols());
+  EXPECT_LT((*solution - expected).norm(), 1e-8 * expected.norm());
+}
@@ -70,6 +70,7 @@ public:
       //("frameInitLimit", po::value<int>(), "ViewScene frame init limit--increase if renderer fails")
       ("guiExpandFactor", po::value<double>(), "Expansion factor for high resolution displays")
       ("max-cores", po::value<unsigned int>(), "Limit the number of cores used by multithreaded algorithms")
+      ("profile", po::value<std::string>(), "Write a Chrome trace of each network execution to this JSON file")
       ("list-modules", "print list of available modules")
       ;
 
@@ -119,9 +120,11 @@ public:
     const std::optional<int>& frameInitLimit,
     const std::optional<int>& regressionTimeout,
     const std::optional<unsigned int>& maxCores,
-    const std::optional<double>& guiExpandFactor
+    const std::optional<double>& guiExpandFactor,
+    const std::optional<std::string>& profileFile
     ) : threadMode_(threadMode), reexecuteMode_(reexecuteMode), frameInitLimit_(frameInitLimit),
-    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor)
+    regressionTimeout_(regressionTimeout), maxCores_(maxCores), guiExpandFactor_(guiExpandFactor),
+    profileFile_(profileFile)
   {}
   std::optional<int> regressionTimeoutSeconds() const override
   {
@@ -147,11 +150,16 @@ public:
   {
     return guiExpandFactor_;
   }
+  std::optional<std::string> profileFile() const override
+  {
+    return profileFile_;
+  }
 private:
   std::optional<std::string> threadMode_, reexecuteMode_;
   std::optional<int> frameInitLimit_, regressionTimeout_;
   std::optional<unsigned int> maxCores_;
   std::optional<double> guiExpandFactor_;
+  std::optional<std::string> profileFile_;
 };
 
 class ApplicationParametersImpl : public ApplicationParameters
@@ -365,7 +373,8 @@ ApplicationParametersHandle CommandLineParser::parse(int argc, const char* argv[
         parseOptionalArg<int>(parsed, "frameInitLimit"),
         parseOptionalArg<int>(parsed, "regression"),
         parseOptionalArg<unsigned int>(parsed, "max-cores"),
-        parseOptionalArg<double>(parsed, "guiExpandFactor")
+        parseOptionalArg<double>(parsed, "guiExpandFactor"),
+        parseOptionalArg<std::string>(parsed, "profile")
       ),
       ApplicationParametersImpl::Flags(
         parsed.count("help") != 0,
@@ -78,6 +78,7 @@ namespace SCIRun {
         virtual std::optional<int> frameInitLimit() const = 0;
         virtual std::optional<unsigned int> maxCores() const = 0;
         virtual std::optional<double> guiExpandFactor() const = 0;
+        virtual std::optional<std::string> profileFile() const = 0;
       };
 
       typedef SharedPointer<ApplicationParameters> ApplicationParametersHandle;
@@ -59,6 +59,8 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     "  --guiExpandFactor arg   Expansion factor for high resolution displays\n"
     "  --max-cores arg         Limit the number of cores used by multithreaded \n"
     "                          algorithms\n"
+    "  --profile arg           Write a Chrome trace of each network execution to \n"
+    "                          this JSON file\n"
     "  --list-modules          print list of available modules\n";
 
   EXPECT_EQ(expectedHelp, parser.describe());
@@ -199,4 +201,15 @@ TEST(ScirunCommandLineSpecTest, CanReadBasicOptions)
     EXPECT_TRUE(!!aph->importNetworkFile());
     EXPECT_EQ("oldnetwork.srn", *aph->importNetworkFile());
   }
+  {
+    const char* argv[] = { "scirun.exe", "-x", "-E", "net.srn5", "--profile", "out.json" };
+    int argc = sizeof(argv) / sizeof(char*);
+
+    auto aph = parser.parse(argc, argv);
+
+    EXPECT_TRUE(aph->executeNetworkAndQuit());
+    EXPECT_EQ("net.srn5", aph->inputFiles()[0]);
+    ASSERT_TRUE(!!aph->developerParameters()->profileFile());
+    EXPECT_EQ("out.json", *aph->developerParameters()->profileFile());
+  }
 }
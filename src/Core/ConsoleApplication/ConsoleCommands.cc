@@ -29,6 +29,7 @@
 #include <Core/ConsoleApplication/ConsoleCommands.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Dataflow/Engine/Controller/NetworkEditorController.h>
+#include <Dataflow/Engine/Scheduler/ExecutionProfiler.h>
 #include <Core/Application/Application.h>
 #include <Dataflow/Serialization/Network/XMLSerializer.h>
 #include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
@@ -58,6 +59,25 @@ namespace
     if (!Application::Instance().parameters()->verboseMode())
       DefaultModuleFactories::defaultLogger_.reset(new Logging::NullLogger);
   }
+
+  // Must run before the quit-after-execute slot is connected, so the trace is
+  // written before exit() is called.
+  void startProfilingIfRequested()
+  {
+    static std::unique_ptr<SCIRun::Dataflow::Engine::ExecutionProfiler> profiler;
+    auto file = Application::Instance().parameters()->developerParameters()->profileFile();
+    if (profiler || !file)
+      return;
+
+    profiler.reset(new SCIRun::Dataflow::Engine::ExecutionProfiler([]() { return Application::Instance().controller()->getNetwork(); }));
+    profiler->attach([file](const SCIRun::Dataflow::Engine::ExecutionProfiler& p, int)
+    {
+      if (p.writeChromeTrace(*file))
+        std::cout << "[SCIRun] Execution profile written to " << *file << std::endl;
+      else
+        std::cerr << "[SCIRun] Could not write execution profile to " << *file << std::endl;
+    });
+  }
 }
 
 /// @todo: real logger
@@ -109,6 +129,7 @@ bool SaveFileCommandConsole::execute()
 
 bool ExecuteCurrentNetworkCommandConsole::execute()
 {
+  startProfilingIfRequested();
   LOG_CONSOLE("Executing network...");
   Application::Instance().controller()->connectStaticNetworkExecutionFinished([](int code){ LOG_CONSOLE("Execution finished with code " << code); });
   Application::Instance().controller()->stopExecutionContextLoopWhenExecutionFinishes();
@@ -128,6 +149,7 @@ QuitAfterExecuteCommandConsole::QuitAfterExecuteCommandConsole()
 
 bool QuitAfterExecuteCommandConsole::execute()
 {
+  startProfilingIfRequested();
   LOG_CONSOLE("Quit after execute is set.");
   Application::Instance().controller()->connectStaticNetworkExecutionFinished([](int code)
   {
@@ -83,11 +83,7 @@ void Pio(Piostream& stream, Array1<T>& array)
     array.resize(size);
   }
 
-  if (stream.supports_block_io())
-  {
-    stream.block_io(&array[0],sizeof(T),size);
-  }
-  else
+  if (size == 0 || !Pio_block(stream, &array[0], size))
   {
     for(index_type i=0;i<size;i++)
       Pio(stream, array[i]);
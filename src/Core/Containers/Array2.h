@@ -137,11 +137,7 @@ void Pio(Piostream& stream, Array2<T>& data)
     Pio(stream, d1);
     Pio(stream, d2);
   }
-  if (stream.supports_block_io())
-  {
-    stream.block_io(&data[0],sizeof(T),data.size());
-  }
-  else
+  if (data.size() == 0 || !Pio_block(stream, &data[0], data.size()))
   {
     for (size_t i=0;i<data.dim1();i++)
     {
@@ -39,7 +39,8 @@
 #ifndef CORE_CONAINTERS_ARRAY3_H
 #define CORE_CONAINTERS_ARRAY3_H 1
 
-#include <boost/multi_array.hpp>
+#include <algorithm>
+#include <memory>
 
 #ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
 #include <sci_defs/bits_defs.h>
@@ -58,57 +59,123 @@
 
 namespace SCIRun {
 
+/// Dense 3D array stored in one contiguous row-major buffer. The buffer is
+/// reference counted so that it can be shared with other data objects (a
+/// Nrrd for instance) without copying it: share() hands out the buffer and
+/// adopt() takes over an external one. Writing through a shared array first
+/// gives it a private copy, so the other holders never see the change.
+/// Copying an Array3 always copies the values.
 template<class T>
 class Array3
 {
 public:
-  typedef boost::multi_array<T, 3> impl_type;
   typedef T value_type;
 
-  Array3() {}
+  Array3() : dm1_(0), dm2_(0), dm3_(0) {}
 
-  Array3(size_t size1, size_t size2, size_t size3)
+  Array3(size_t size1, size_t size2, size_t size3) : dm1_(0), dm2_(0), dm3_(0)
   {
     resize(size1, size2, size3);
   }
 
+  Array3(const Array3& copy) :
+    data_(allocate(copy.size())), dm1_(copy.dm1_), dm2_(copy.dm2_), dm3_(copy.dm3_)
+  {
+    std::copy(copy.data_.get(), copy.data_.get() + copy.size(), data_.get());
+  }
+
+  Array3& operator=(const Array3& copy)
+  {
+    if (this != &copy)
+    {
+      data_ = allocate(copy.size());
+      std::copy(copy.data_.get(), copy.data_.get() + copy.size(), data_.get());
+      dm1_ = copy.dm1_; dm2_ = copy.dm2_; dm3_ = copy.dm3_;
+    }
+    return *this;
+  }
+
+  /// Values in the overlapping part are kept, new values are value initialized
   void resize(size_t size1, size_t size2, size_t size3)
   {
-    typename impl_type::extent_gen extents;
-    impl_.resize(extents[size1][size2][size3]);
+    if (size1 == dm1_ && size2 == dm2_ && size3 == dm3_) return;
+
+    std::shared_ptr<T> data = allocate(size1*size2*size3);
+    const size_t n1 = std::min(size1, dm1_);
+    const size_t n2 = std::min(size2, dm2_);
+    const size_t n3 = std::min(size3, dm3_);
+    for (size_t i = 0; i < n1; i++)
+      for (size_t j = 0; j < n2; j++)
+      {
+        const T* src = data_.get() + (i*dm2_ + j)*dm3_;
+        std::copy(src, src + n3, data.get() + (i*size2 + j)*size3);
+      }
+
+    data_ = data;
+    dm1_ = size1; dm2_ = size2; dm3_ = size3;
   }
 
   size_t size() const
   {
-    return dim1() * dim2() * dim3();
+    return dm1_ * dm2_ * dm3_;
   }
 
   T& operator[](size_t idx)
   {
-    return impl_.origin()[idx];
+    detach();
+    return data_.get()[idx];
   }
 
   const T& operator[](size_t idx) const
   {
-    return impl_.origin()[idx];
+    return data_.get()[idx];
   }
 
   const T& operator()(size_t i1, size_t i2, size_t i3) const
   {
-    return impl_[i1][i2][i3];
+    return data_.get()[(i1*dm2_ + i2)*dm3_ + i3];
   }
 
   T& operator()(size_t i1, size_t i2, size_t i3)
   {
-    return impl_[i1][i2][i3];
+    detach();
+    return data_.get()[(i1*dm2_ + i2)*dm3_ + i3];
   }
 
-  inline size_t dim1() const {return impl_.shape()[0];}
-  inline size_t dim2() const {return impl_.shape()[1];}
-  inline size_t dim3() const {return impl_.shape()[2];}
+  inline size_t dim1() const {return dm1_;}
+  inline size_t dim2() const {return dm2_;}
+  inline size_t dim3() const {return dm3_;}
+
+  /// Handle on the storage for sharing it without a copy
+  std::shared_ptr<T> share() const { return data_; }
+
+  /// Use an external buffer of size() values as storage. The handle keeps the
+  /// buffer alive; the first write copies it unless this array is its only
+  /// holder.
+  void adopt(std::shared_ptr<T> data) { data_ = std::move(data); }
+
+  /// Whether the storage is currently shared with another holder
+  bool is_shared() const { return data_.use_count() > 1; }
 
 private:
-  impl_type impl_;
+  static std::shared_ptr<T> allocate(size_t size)
+  {
+    if (size == 0) return std::shared_ptr<T>();
+    return std::shared_ptr<T>(new T[size](), std::default_delete<T[]>());
+  }
+
+  void detach()
+  {
+    if (data_.use_count() > 1)
+    {
+      std::shared_ptr<T> data = allocate(size());
+      std::copy(data_.get(), data_.get() + size(), data.get());
+      data_ = data;
+    }
+  }
+
+  std::shared_ptr<T> data_;
+  size_t dm1_, dm2_, dm3_;
 };
 
 template<class T> void Pio(Piostream& stream, Array3<T>& array);
@@ -157,20 +224,17 @@ Pio(Piostream& stream, Array3<T>& data)
     Pio(stream, d3);
   }
 
-  if (stream.supports_block_io())
-  {
-    stream.block_io(reinterpret_cast<void*>(&data[0]), sizeof(T), data.size());
-  }
-  else
+  if (data.size() > 0)
   {
-    for(size_t i=0;i<data.dim1();i++)
+    // Writing goes through the const accessors, so that storage shared with
+    // another holder is not detached just to be saved.
+    const Array3<T>& cdata = data;
+    T* values = stream.reading() ? &data[0] : const_cast<T*>(&cdata[0]);
+    if (!Pio_block(stream, values, data.size()))
     {
-      for(size_t j=0;j<data.dim2();j++)
+      for (size_t i = 0; i < data.size(); i++)
       {
-        for(size_t k=0;k<data.dim3();k++)
-        {
-          Pio(stream, data(i,j,k));
-        }
+        Pio(stream, values[i]);
       }
     }
   }
@@ -0,0 +1,140 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Containers/Array3.h>
+#include <Core/Persistent/Pstreams.h>
+#include <boost/filesystem.hpp>
+
+using namespace SCIRun;
+
+namespace
+{
+  Array3<double> makeArray(size_t d1, size_t d2, size_t d3)
+  {
+    Array3<double> a(d1, d2, d3);
+    for (size_t k = 0; k < a.size(); ++k)
+      a[k] = static_cast<double>(k);
+    return a;
+  }
+}
+
+TEST(Array3Test, CanResize)
+{
+  Array3<double> a;
+  EXPECT_EQ(0, a.size());
+  a.resize(2, 3, 4);
+  EXPECT_EQ(2, a.dim1());
+  EXPECT_EQ(3, a.dim2());
+  EXPECT_EQ(4, a.dim3());
+  EXPECT_EQ(24, a.size());
+  EXPECT_EQ(0.0, a(1, 2, 3));
+}
+
+TEST(Array3Test, StorageIsRowMajor)
+{
+  auto a = makeArray(2, 3, 4);
+  EXPECT_EQ(23.0, a(1, 2, 3));
+  EXPECT_EQ(13.0, a(1, 0, 1));
+  EXPECT_EQ(&a(0, 0, 0) + a.size(), &a(1, 2, 3) + 1);
+}
+
+TEST(Array3Test, ResizeKeepsOverlappingValues)
+{
+  auto a = makeArray(2, 3, 4);
+  a.resize(3, 2, 5);
+  EXPECT_EQ(0.0, a(0, 0, 0));
+  EXPECT_EQ(17.0, a(1, 1, 1));
+  EXPECT_EQ(0.0, a(1, 1, 4));
+  EXPECT_EQ(0.0, a(2, 0, 0));
+}
+
+TEST(Array3Test, CopyDoesNotShareStorage)
+{
+  auto a = makeArray(2, 2, 2);
+  Array3<double> b(a);
+  EXPECT_FALSE(a.is_shared());
+  b(0, 0, 0) = -1.0;
+  EXPECT_EQ(0.0, a(0, 0, 0));
+}
+
+TEST(Array3Test, SharedStorageIsCopiedOnWrite)
+{
+  auto a = makeArray(2, 2, 2);
+  std::shared_ptr<double> view = a.share();
+  EXPECT_EQ(view.get(), &static_cast<const Array3<double>&>(a)[0]);
+  EXPECT_TRUE(a.is_shared());
+
+  a[3] = -1.0;
+  EXPECT_FALSE(a.is_shared());
+  EXPECT_EQ(3.0, view.get()[3]);
+  EXPECT_EQ(-1.0, a[3]);
+}
+
+TEST(Array3Test, CanAdoptExternalBuffer)
+{
+  std::shared_ptr<double> buffer(new double[8], std::default_delete<double[]>());
+  for (int k = 0; k < 8; ++k)
+    buffer.get()[k] = 2.0 * k;
+
+  Array3<double> a(2, 2, 2);
+  a.adopt(buffer);
+  const Array3<double>& ca(a);
+  EXPECT_EQ(buffer.get(), &ca(0, 0, 0));
+  EXPECT_EQ(14.0, ca(1, 1, 1));
+
+  a(1, 1, 1) = 0.0;
+  EXPECT_NE(buffer.get(), &ca(0, 0, 0));
+  EXPECT_EQ(14.0, buffer.get()[7]);
+}
+
+TEST(Array3Test, WritingSharedStorageDoesNotCopyIt)
+{
+  const auto filename = (boost::filesystem::temp_directory_path() / "Array3Test_shared.bin").string();
+  auto a = makeArray(2, 3, 4);
+  std::shared_ptr<double> view = a.share();
+  {
+    BinaryPiostream out(filename, Piostream::Direction::Write);
+    Pio(out, a);
+    ASSERT_FALSE(out.error());
+  }
+  EXPECT_TRUE(a.is_shared());
+  EXPECT_EQ(view.get(), &static_cast<const Array3<double>&>(a)[0]);
+
+  Array3<double> loaded;
+  {
+    BinaryPiostream in(filename, Piostream::Direction::Read);
+    Pio(in, loaded);
+    ASSERT_FALSE(in.error());
+  }
+  boost::filesystem::remove(filename);
+
+  ASSERT_EQ(24, loaded.size());
+  EXPECT_EQ(23.0, loaded(1, 2, 3));
+  EXPECT_EQ(13.0, loaded(1, 0, 1));
+}
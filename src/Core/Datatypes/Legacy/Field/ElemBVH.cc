@@ -0,0 +1,258 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/Legacy/Field/ElemBVH.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <cstdint>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  const int NUM_BINS = 16;
+  const index_type MAX_LEAF_SIZE = 4;
+
+  double area(const BBox& box)
+  {
+    if (!box.valid()) return (0.0);
+    const Vector d = box.diagonal();
+    return (d.x()*d.y() + d.y()*d.z() + d.z()*d.x());
+  }
+
+  /// Spreads the lower 21 bits of v so there are two zero bits between them
+  uint64_t spread_bits(uint64_t v)
+  {
+    v &= 0x1fffff;
+    v = (v | v << 32) & 0x1f00000000ffffULL;
+    v = (v | v << 16) & 0x1f0000ff0000ffULL;
+    v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+    v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+    v = (v | v << 2)  & 0x1249249249249249ULL;
+    return (v);
+  }
+}
+
+ElemBVH::ElemBVH(const VMesh* mesh, double epsilon) :
+  depth_(0)
+{
+  VMesh::Elem::size_type num_elems = mesh->num_elems();
+  if (num_elems == 0) return;
+
+  elems_.resize(num_elems);
+  boxes_.resize(num_elems);
+  centers_.resize(num_elems);
+  Parallel::For(0, num_elems, [&](size_t begin, size_t end)
+  {
+    VMesh::Node::array_type nodes;
+    Point p;
+    for (size_t j = begin; j < end; ++j)
+    {
+      const VMesh::Elem::index_type idx = static_cast<index_type>(j);
+      mesh->get_nodes(nodes, idx);
+      BBox box;
+      for (size_t k = 0; k < nodes.size(); k++)
+      {
+        mesh->get_point(p, nodes[k]);
+        box.extend(p);
+      }
+      box.extend(epsilon);
+      elems_[j] = idx;
+      boxes_[j] = box;
+      centers_[j] = box.center();
+    }
+  });
+
+  nodes_.reserve(2*(num_elems/MAX_LEAF_SIZE) + 1);
+  build(0, num_elems, 1);
+
+  // The boxes were permuted along with elems_ and are no longer needed
+  std::vector<BBox>().swap(boxes_);
+  std::vector<Point>().swap(centers_);
+}
+
+index_type
+ElemBVH::build(index_type begin, index_type end, size_type level)
+{
+  depth_ = std::max(depth_, level);
+  const index_type node_index = static_cast<index_type>(nodes_.size());
+  nodes_.emplace_back();
+
+  BBox box, center_box;
+  for (index_type j = begin; j < end; j++)
+  {
+    box.extend(boxes_[j]);
+    center_box.extend(centers_[j]);
+  }
+  {
+    Node& node = nodes_[node_index];
+    const Point lo = box.get_min(), hi = box.get_max();
+    node.min[0] = lo.x(); node.min[1] = lo.y(); node.min[2] = lo.z();
+    node.max[0] = hi.x(); node.max[1] = hi.y(); node.max[2] = hi.z();
+    node.first = begin;
+    node.count = end - begin;
+  }
+
+  const index_type count = end - begin;
+  if (count <= MAX_LEAF_SIZE) return (node_index);
+
+  const Vector extent = center_box.diagonal();
+  int axis = 0;
+  if (extent.y() > extent[axis]) axis = 1;
+  if (extent.z() > extent[axis]) axis = 2;
+  // All centers coincide: nothing to split on
+  if (extent[axis] <= 0.0) return (node_index);
+
+  const double lo = center_box.get_min()[axis];
+  const double scale = NUM_BINS / extent[axis];
+  auto bin_of = [&](index_type j)
+  {
+    return (std::min(NUM_BINS - 1, static_cast<int>((centers_[j][axis] - lo) * scale)));
+  };
+
+  index_type mid = begin + count/2;
+  bool median = (level >= MAX_DEPTH - 32);
+  if (!median)
+  {
+    // Binned surface area heuristic: cost of splitting after bin b
+    BBox bin_box[NUM_BINS];
+    index_type bin_count[NUM_BINS] = {};
+    for (index_type j = begin; j < end; j++)
+    {
+      const int b = bin_of(j);
+      bin_box[b].extend(boxes_[j]);
+      bin_count[b]++;
+    }
+
+    double right_area[NUM_BINS];
+    index_type right_count[NUM_BINS];
+    BBox acc; index_type n = 0;
+    for (int b = NUM_BINS - 1; b > 0; b--)
+    {
+      acc.extend(bin_box[b]); n += bin_count[b];
+      right_area[b] = area(acc); right_count[b] = n;
+    }
+
+    double best_cost = static_cast<double>(count);
+    int best_split = -1;
+    acc.reset(); n = 0;
+    const double parent_area = area(box);
+    for (int b = 0; b < NUM_BINS - 1; b++)
+    {
+      acc.extend(bin_box[b]); n += bin_count[b];
+      if (n == 0 || right_count[b+1] == 0) continue;
+      const double cost = 0.125 + (area(acc)*n + right_area[b+1]*right_count[b+1]) / parent_area;
+      if (cost < best_cost) { best_cost = cost; best_split = b; }
+    }
+
+    if (best_split >= 0)
+    {
+      // Partition the three parallel arrays together
+      index_type i = begin, k = end - 1;
+      while (i <= k)
+      {
+        if (bin_of(i) <= best_split) { i++; continue; }
+        std::swap(elems_[i], elems_[k]);
+        std::swap(boxes_[i], boxes_[k]);
+        std::swap(centers_[i], centers_[k]);
+        k--;
+      }
+      mid = i;
+    }
+    else if (count <= 4*MAX_LEAF_SIZE)
+    {
+      // Splitting does not pay off
+      return (node_index);
+    }
+    else
+    {
+      median = true;
+    }
+  }
+
+  if (median)
+  {
+    std::vector<index_type> order(count);
+    for (index_type j = 0; j < count; j++) order[j] = begin + j;
+    std::nth_element(order.begin(), order.begin() + count/2, order.end(),
+      [&](index_type a, index_type b) { return (centers_[a][axis] < centers_[b][axis]); });
+
+    std::vector<VMesh::Elem::index_type> elems(count);
+    std::vector<BBox> boxes(count);
+    std::vector<Point> centers(count);
+    for (index_type j = 0; j < count; j++)
+    {
+      elems[j] = elems_[order[j]];
+      boxes[j] = boxes_[order[j]];
+      centers[j] = centers_[order[j]];
+    }
+    std::copy(elems.begin(), elems.end(), elems_.begin() + begin);
+    std::copy(boxes.begin(), boxes.end(), boxes_.begin() + begin);
+    std::copy(centers.begin(), centers.end(), centers_.begin() + begin);
+    mid = begin + count/2;
+  }
+
+  build(begin, mid, level + 1);
+  const index_type right = build(mid, end, level + 1);
+  nodes_[node_index].first = right;
+  nodes_[node_index].count = 0;
+  return (node_index);
+}
+
+std::vector<size_t>
+ElemBVH::spatial_order(const std::vector<Point>& points)
+{
+  std::vector<size_t> order(points.size());
+  if (points.empty()) return (order);
+
+  BBox box;
+  for (const auto& p : points) box.extend(p);
+  const Point lo = box.get_min();
+  const Vector d = box.diagonal();
+  const double extent = std::max(d.x(), std::max(d.y(), d.z()));
+  const double scale = extent > 0.0 ? ((1 << 21) - 1) / extent : 0.0;
+
+  std::vector<std::pair<uint64_t, size_t>> keys(points.size());
+  Parallel::For(0, points.size(), [&](size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      const Vector r = (points[j] - lo) * scale;
+      keys[j].first = spread_bits(static_cast<uint64_t>(r.x())) |
+        (spread_bits(static_cast<uint64_t>(r.y())) << 1) |
+        (spread_bits(static_cast<uint64_t>(r.z())) << 2);
+      keys[j].second = j;
+    }
+  });
+  std::sort(keys.begin(), keys.end());
+  for (size_t j = 0; j < keys.size(); ++j) order[j] = keys[j].second;
+  return (order);
+}
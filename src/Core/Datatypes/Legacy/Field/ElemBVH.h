@@ -0,0 +1,124 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_ELEMBVH_H
+#define CORE_DATATYPES_ELEMBVH_H 1
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/BBox.h>
+#include <vector>
+
+#include <Core/Datatypes/Legacy/Field/share.h>
+
+namespace SCIRun {
+
+/// Bounding volume hierarchy over the bounding boxes of the elements of a
+/// mesh. It is built top down with a binned surface area heuristic and stored
+/// depth first in one array: the left child of an interior node directly
+/// follows it. It backs the batched locate functions of VMesh.
+class SCISHARE ElemBVH
+{
+  public:
+    /// Builds the hierarchy for all elements of mesh, growing every element
+    /// box by epsilon.
+    ElemBVH(const VMesh* mesh, double epsilon);
+
+    /// Calls visit(elem) for the elements whose box contains p, until visit
+    /// returns true. Returns whether it did.
+    template <class Visit>
+    bool visit_containing(const Core::Geometry::Point& p, Visit visit) const
+    {
+      if (nodes_.empty()) return (false);
+
+      const double q[3] = { p.x(), p.y(), p.z() };
+      index_type stack[2*MAX_DEPTH];
+      int top = 0;
+      stack[top++] = 0;
+      while (top > 0)
+      {
+        const Node& node = nodes_[stack[--top]];
+        if (q[0] < node.min[0] || q[0] > node.max[0] ||
+            q[1] < node.min[1] || q[1] > node.max[1] ||
+            q[2] < node.min[2] || q[2] > node.max[2]) continue;
+
+        if (node.count > 0)
+        {
+          for (index_type j = node.first; j < node.first + node.count; j++)
+            if (visit(elems_[j])) return (true);
+        }
+        else
+        {
+          const index_type left = static_cast<index_type>(&node - &nodes_[0]) + 1;
+          stack[top++] = node.first;
+          stack[top++] = left;
+        }
+      }
+      return (false);
+    }
+
+    /// Permutation of points that visits them along a Morton (Z-order) curve
+    /// through their bounding box, so consecutive queries hit the same part
+    /// of the hierarchy.
+    static std::vector<size_t> spatial_order(const std::vector<Core::Geometry::Point>& points);
+
+    inline size_type num_nodes() const
+      { return (static_cast<size_type>(nodes_.size())); }
+
+    inline size_type depth() const
+      { return (depth_); }
+
+  private:
+    /// Deeper than this the build falls back to median splits, which bounds
+    /// the traversal stack.
+    static const int MAX_DEPTH = 64;
+
+    struct Node
+    {
+      double min[3];
+      double max[3];
+      /// Leaves: first element in elems_; interior nodes: right child
+      index_type first;
+      /// Number of elements of a leaf, 0 for interior nodes
+      index_type count;
+    };
+
+    index_type build(index_type begin, index_type end, size_type level);
+
+    /// Only used while building
+
+    std::vector<Node> nodes_;
+    std::vector<VMesh::Elem::index_type> elems_;
+    std::vector<Core::Geometry::BBox> boxes_;
+    std::vector<Core::Geometry::Point> centers_;
+    size_type depth_;
+};
+
+} // end namespace SCIRun
+
+#endif
@@ -51,6 +51,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopology.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 
@@ -1682,8 +1683,7 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::EDGES_E,
       "HexVolMesh: Must call synchronize EDGES_E first");
 
-    array.clear();
-    //array.reserve(12);
+    array.resize(12);
     const index_type off = idx * 8;
     typename Node::index_type n1,n2;
 
@@ -1714,6 +1714,7 @@ protected:
     if (n1 != n2) { PEdgeNode e(n1,n2); array[i++] = static_cast<typename ARRAY::value_type>(edge_table_.find(e)->second); }
     n1 = cells_[off + 7]; n2 = cells_[off + 3];
     if (n1 != n2) { PEdgeNode e(n1,n2); array[i++] = static_cast<typename ARRAY::value_type>(edge_table_.find(e)->second); }
+    array.resize(i);
   }
 
   template<class ARRAY, class INDEX>
@@ -1793,10 +1794,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "HexVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>3);
+    const auto neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]>>3);
   }
 
   template<class ARRAY, class INDEX>
@@ -1808,7 +1809,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const auto neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1890,7 +1891,7 @@ protected:
       "HexVolMesh: Must call synchronize FACES_E first");
 
     array.clear();
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const auto neighbors = node_neighbors_[idx];
 
     // Iterate through all those edges
     for (size_t n = 0; n < neighbors.size(); n++)
@@ -2090,12 +2091,12 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on HexVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const auto neighbors = node_neighbors_[node];
 
     std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x7));
+      const index_type base = ((neighbors[i])&(~0x7));
       for (index_type c = base; c < base+8; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -2436,6 +2437,7 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2658,108 +2660,8 @@ protected:
         PEdgeNode(n1,n2) {}
   };
 
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_quarter_int = (int)(sz_int / 4);
-    static const int top4_mask = -(1 << sz_quarter_int << sz_quarter_int << sz_quarter_int);
-    static const int up4_mask = top4_mask ^ -(1 << sz_quarter_int << sz_quarter_int);
-    static const int mid4_mask =  top4_mask ^ -(1 << sz_quarter_int);
-    static const int low4_mask = ~(top4_mask | mid4_mask);
-
-    /// This is the hash function
-    template <class PFACE>
-    size_t operator()(const PFACE &f) const
-    {
-      if (f.nodes_[2] == f.nodes_[3])
-      {
-        if (f.nodes_[1] < f.nodes_[2])
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[3]));
-        }
-        else
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[2] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[1] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[1]));
-        }
-      }
-      else
-      {
-        if (f.nodes_[1] < f.nodes_[3] )
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[3]));
-        }
-        else
-        {
-          return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-                (up4_mask & (f.nodes_[3] << sz_quarter_int << sz_quarter_int)) |
-                (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-                (low4_mask & f.nodes_[1]));
-        }
-      }
-    }
-
-    /// This should return less than rather than equal to.
-    template <class PFACE>
-    bool operator()(const PFACE &f1, const PFACE& f2) const {
-      return f1 < f2;
-    }
-  };
-
-  /*/ hash the egde's node_indecies such that edges with the same nodes
-   *  hash to the same value. nodes are sorted on edge construction. */
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    template<class PEDGE>
-    size_t operator()(const PEDGE &e) const
-    {
-      return (e.nodes_[0] << sz_half_int) |
-	(low_mask & e.nodes_[1]);
-    }
-
-    ///  This should return less than rather than equal to.
-    template<class PEDGE>
-    bool operator()(const PEDGE &e1, const PEDGE &e2) const
-    {
-      return e1 < e2;
-    }
-  };
-
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = std::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = std::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  using face_nt = TopologyTable<PFaceNode, 4, typename Face::index_type, QuadFaceKey>;
+  using edge_nt = TopologyTable<PEdgeNode, 2, typename Edge::index_type, SortedNodesKey<2>>;
 
   typedef std::vector<PFaceCell> face_ct;
   typedef std::vector<PEdgeCell> edge_ct;
@@ -2774,15 +2676,6 @@ protected:
   edge_ct edges_;
   edge_nt edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 index_type combind_index, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2852,7 +2745,7 @@ protected:
     typename Node::array_type   nodes_;
   };
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeNeighborTable<typename Cell::index_type> node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -3212,107 +3105,72 @@ HexVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-HexVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             typename Node::index_type n4,
-                             index_type combined_index,
-                             face_ht &table) const
+HexVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
+  const size_t numCells = cells_.size() >> 3;
+  // 6 faces -- each is entered CCW from outside looking in
+  static const int faceNodes[6][4] =
+    { {0, 1, 2, 3}, {7, 6, 5, 4}, {0, 4, 5, 1}, {2, 6, 7, 3}, {3, 7, 4, 0}, {1, 5, 6, 2} };
 
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
-
-
-  typename face_ht::iterator iter = table.find(f);
-
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  std::vector<TopologyRecord<4>> records(numCells * 6);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
+    for (size_t c = begin; c < end; ++c)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "HexVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const auto* nodes = &cells_[c << 3];
+      for (int f = 0; f < 6; ++f)
+      {
+        index_type n1 = nodes[faceNodes[f][0]], n2 = nodes[faceNodes[f][1]],
+          n3 = nodes[faceNodes[f][2]], n4 = nodes[faceNodes[f][3]];
+        auto& record = records[c * 6 + f];
+        // Degenerate faces are ignored
+        if (!order_face_nodes(n1, n2, n3, n4))
+        {
+          record.combined = MESH_NO_NEIGHBOR;
+          continue;
+        }
+        // Faces are equal up to orientation, see PFaceNode::operator==
+        QuadFaceKey()(PFaceNode(n1, n2, n3, n4), record.key);
+        record.combined = static_cast<index_type>((c << 3) + f);
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-HexVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
-
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(8);
+  });
 
-  face_ht table;
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numFaces = groups.size() - 1;
 
-  while (ci != cie)
+  // The first cell found (the lowest index) owns the face; a face shared by
+  // more than two cells only records the first two.
+  faces_.clear();
+  faces_.resize(numFaces);
+  Core::Thread::Parallel::For(0, numFaces, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 6 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], arr[3], cell_index, table);
-    hash_face(arr[7], arr[6], arr[5], arr[4], cell_index + 1, table);
-    hash_face(arr[0], arr[4], arr[5], arr[1], cell_index + 2, table);
-    hash_face(arr[2], arr[6], arr[7], arr[3], cell_index + 3, table);
-    hash_face(arr[3], arr[7], arr[4], arr[0], cell_index + 4, table);
-    hash_face(arr[1], arr[5], arr[6], arr[2], cell_index + 5, table);
-
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-  boundary_faces_.resize(cells_.size()>>3);
+    for (size_t g = begin; g < end; ++g)
+    {
+      PFaceCell& face = faces_[g];
+      face.cells_[0] = records[groups[g]].combined;
+      for (size_t r = groups[g] + 1; r < groups[g + 1]; ++r)
+      {
+        if ((records[r].combined >> 3) != (face.cells_[0] >> 3))
+        {
+          face.cells_[1] = records[r].combined;
+          break;
+        }
+      }
+    }
+  });
 
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+  face_table_.assign(numFaces, [&](size_t g) { return records[groups[g]].key; });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  boundary_faces_.assign(numCells, 0);
+  for (size_t g = 0; g < numFaces; ++g)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2],pface.nodes_[3])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    if (faces_[g].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = (pface.cells_[0]) >> 3;
-      index_type face = (pface.cells_[0]) & 0x7;
+      index_type cell = (faces_[g].cells_[0]) >> 3;
+      index_type face = (faces_[g].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
@@ -3320,74 +3178,49 @@ HexVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-HexVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 HexVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<4;
-    hash_edge(arr[0], arr[1], cell_index  , table);
-    hash_edge(arr[1], arr[2], cell_index+1, table);
-    hash_edge(arr[2], arr[3], cell_index+2, table);
-    hash_edge(arr[3], arr[0], cell_index+3, table);
-
-    hash_edge(arr[4], arr[5], cell_index+4, table);
-    hash_edge(arr[5], arr[6], cell_index+5, table);
-    hash_edge(arr[6], arr[7], cell_index+6, table);
-    hash_edge(arr[7], arr[4], cell_index+7, table);
+  const size_t numCells = cells_.size() >> 3;
+  static const int edgeNodes[12][2] =
+    { {0, 1}, {1, 2}, {2, 3}, {3, 0}, {4, 5}, {5, 6}, {6, 7}, {7, 4}, {0, 4}, {5, 1}, {2, 6}, {7, 3} };
 
-    hash_edge(arr[0], arr[4], cell_index+8, table);
-    hash_edge(arr[5], arr[1], cell_index+9, table);
-    hash_edge(arr[2], arr[6], cell_index+10,table);
-    hash_edge(arr[7], arr[3], cell_index+11,table);
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-
-  edges_.resize(table.size());
+  std::vector<TopologyRecord<2>> records(numCells * 12);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      const auto* nodes = &cells_[c << 3];
+      for (int e = 0; e < 12; ++e)
+      {
+        const index_type n1 = nodes[edgeNodes[e][0]];
+        const index_type n2 = nodes[edgeNodes[e][1]];
+        auto& record = records[c * 12 + e];
+        record.key[0] = std::min(n1, n2);
+        record.key[1] = std::max(n1, n2);
+        record.combined = (n1 == n2) ? MESH_NO_NEIGHBOR : static_cast<index_type>((c << 4) + e);
+      }
+    }
+  });
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numEdges = groups.size() - 1;
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edges_.clear();
+  edges_.resize(numEdges);
+  Core::Thread::Parallel::For(0, numEdges, [&](size_t begin, size_t end)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+    for (size_t g = begin; g < end; ++g)
+    {
+      auto& cells = edges_[g].cells_;
+      cells.reserve(groups[g + 1] - groups[g]);
+      for (size_t r = groups[g]; r < groups[g + 1]; ++r)
+        cells.push_back(records[r].combined);
+    }
+  });
+
+  edge_table_.assign(numEdges, [&](size_t g) { return records[groups[g]].key; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3677,13 +3510,7 @@ template <class Basis>
 void
 HexVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  computeNodeNeighbors(cells_, points_.size(), node_neighbors_);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3726,12 +3553,9 @@ HexVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::ar
 }
 
 template <class Basis>
-void
-HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+HexVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*8;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3743,26 +3567,24 @@ HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+6]]);
   box.extend(points_[cells_[idx+7]]);
   box.extend(epsilon_);
+  return box;
+}
+
+template <class Basis>
+void
+HexVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
 
-  elem_grid_->insert(ci, box);
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 HexVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*8;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(points_[cells_[idx+6]]);
-  box.extend(points_[cells_[idx+7]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3803,13 +3625,9 @@ HexVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->build_from_boxes(esz,
+      [](size_t ci) { return static_cast<index_type>(ci); },
+      [this](size_t ci) { return elem_grid_bbox(static_cast<index_type>(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3840,13 +3658,9 @@ HexVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->build_from_points(static_cast<size_type>(points_.size()),
+      [](size_t ni) { return static_cast<index_type>(ni); },
+      [this](size_t ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
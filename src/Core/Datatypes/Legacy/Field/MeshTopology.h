@@ -0,0 +1,417 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_DATATYPES_MESHTOPOLOGY_H
+#define CORE_DATATYPES_MESHTOPOLOGY_H 1
+
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Datatypes/Mesh/MeshTraits.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace SCIRun {
+
+/// Sort based construction of the edge, face and node neighbor tables of
+/// unstructured meshes. Every element contributes one record per local edge
+/// or face; sorting the records brings the copies of a shared entity
+/// together, which replaces inserting them one by one into a hash table.
+
+/// A canonical node key for an edge or face and the combined index
+/// (element and local number) of the element side it came from.
+template <size_t N>
+struct TopologyRecord
+{
+  index_type key[N];
+  index_type combined;
+
+  bool operator<(const TopologyRecord& r) const
+  {
+    for (size_t i = 0; i < N; ++i)
+      if (key[i] != r.key[i])
+        return key[i] < r.key[i];
+    return combined < r.combined;
+  }
+
+  bool sameKey(const TopologyRecord& r) const
+  {
+    return std::equal(key, key + N, r.key);
+  }
+};
+
+namespace detail
+{
+  /// Positions [offsets[i], offsets[i+1]) of the items whose bucket is i,
+  /// counted in parallel.
+  template <class BucketOf>
+  std::vector<size_t> bucketOffsets(size_t numItems, size_t numBuckets, BucketOf bucketOf)
+  {
+    std::unique_ptr<std::atomic<size_t>[]> counts(new std::atomic<size_t>[numBuckets]);
+    for (size_t b = 0; b < numBuckets; ++b)
+      counts[b].store(0, std::memory_order_relaxed);
+    Core::Thread::Parallel::For(0, numItems, [&](size_t begin, size_t end)
+    {
+      for (auto i = begin; i < end; ++i)
+        counts[bucketOf(i)].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<size_t> offsets(numBuckets + 1, 0);
+    for (size_t b = 0; b < numBuckets; ++b)
+      offsets[b + 1] = offsets[b] + counts[b].load(std::memory_order_relaxed);
+    return offsets;
+  }
+
+  /// Scatters item i to out[cursor of bucketOf(i)]; the order within a bucket is arbitrary.
+  template <class BucketOf, class Write>
+  void scatterToBuckets(size_t numItems, const std::vector<size_t>& offsets, BucketOf bucketOf, Write write)
+  {
+    const size_t numBuckets = offsets.size() - 1;
+    std::unique_ptr<std::atomic<size_t>[]> cursors(new std::atomic<size_t>[numBuckets]);
+    for (size_t b = 0; b < numBuckets; ++b)
+      cursors[b].store(offsets[b], std::memory_order_relaxed);
+    Core::Thread::Parallel::For(0, numItems, [&](size_t begin, size_t end)
+    {
+      for (auto i = begin; i < end; ++i)
+        write(i, cursors[bucketOf(i)].fetch_add(1, std::memory_order_relaxed));
+    });
+  }
+}
+
+/// Drops the records whose combined index is MESH_NO_NEIGHBOR (degenerate
+/// edges or faces), then sorts by key and combined index: a counting sort
+/// on key[0], which is a node index below numNodes, followed by sorting
+/// every bucket in parallel. Returns the first record of each distinct key,
+/// followed by records.size().
+template <size_t N>
+std::vector<size_t> sortTopologyRecords(std::vector<TopologyRecord<N>>& records, size_t numNodes)
+{
+  records.erase(std::remove_if(records.begin(), records.end(),
+    [](const TopologyRecord<N>& r) { return r.combined == MESH_NO_NEIGHBOR; }), records.end());
+
+  auto bucketOf = [&](size_t i) { return static_cast<size_t>(records[i].key[0]); };
+  const auto offsets = detail::bucketOffsets(records.size(), numNodes, bucketOf);
+
+  std::vector<TopologyRecord<N>> sorted(records.size());
+  detail::scatterToBuckets(records.size(), offsets, bucketOf,
+    [&](size_t from, size_t to) { sorted[to] = records[from]; });
+
+  Core::Thread::Parallel::For(0, numNodes, [&](size_t begin, size_t end)
+  {
+    for (auto b = begin; b < end; ++b)
+      std::sort(sorted.begin() + offsets[b], sorted.begin() + offsets[b + 1]);
+  });
+  records.swap(sorted);
+
+  std::vector<size_t> groups;
+  for (size_t i = 0; i < records.size(); ++i)
+    if (i == 0 || !records[i].sameKey(records[i - 1]))
+      groups.push_back(i);
+  groups.push_back(records.size());
+  return groups;
+}
+
+/// Canonical key of an edge or face whose constructor already sorts nodes_.
+template <size_t N>
+struct SortedNodesKey
+{
+  template <class Key>
+  void operator()(const Key& key, index_type* out) const
+  {
+    std::copy(key.nodes_, key.nodes_ + N, out);
+  }
+};
+
+/// Canonical key of a quadrilateral face whose nodes_ were rotated to start
+/// at the smallest node (see order_face_nodes). The two orientations of the
+/// face differ by swapping nodes 1 and 3; a face whose last two nodes are
+/// equal is a triangle, whose orientations differ by swapping nodes 1 and 2.
+struct QuadFaceKey
+{
+  template <class Key>
+  void operator()(const Key& key, index_type* out) const
+  {
+    const index_type n1 = key.nodes_[0], n2 = key.nodes_[1], n3 = key.nodes_[2], n4 = key.nodes_[3];
+    out[0] = n1;
+    if (n3 == n4)
+    {
+      out[1] = std::min(n2, n3);
+      out[2] = out[3] = std::max(n2, n3);
+    }
+    else
+    {
+      out[1] = std::min(n2, n4);
+      out[2] = n3;
+      out[3] = std::max(n2, n4);
+    }
+  }
+};
+
+/// Lookup table from an edge or face to its index. The entities of the last
+/// bulk build are kept as a flat array of canonical keys in increasing order,
+/// which is searched by bisection. Entities that are added one at a time
+/// while the mesh stays synchronized go to a small hash table, and removed
+/// ones are only marked, so incremental updates do not shift the array.
+///
+/// Canonical()(key, out) writes the N node indices that identify key up to
+/// orientation. The interface follows the subset of std::unordered_map that
+/// the meshes use; iterators are plain pointers and end() is null.
+template <class Key, size_t N, class Index, class Canonical>
+class TopologyTable
+{
+public:
+  using key_type = std::array<index_type, N>;
+  using value_type = std::pair<key_type, Index>;
+  using iterator = value_type*;
+  using const_iterator = const value_type*;
+
+  iterator find(const Key& key) { return lookup(canonical(key)); }
+  const_iterator find(const Key& key) const { return const_cast<TopologyTable*>(this)->lookup(canonical(key)); }
+  iterator end() { return nullptr; }
+  const_iterator end() const { return nullptr; }
+  size_t size() const { return size_; }
+
+  /// Returns the index stored for key, inserting key if it is absent.
+  Index& operator[](const Key& key)
+  {
+    const key_type k = canonical(key);
+    auto it = std::lower_bound(sorted_.begin(), sorted_.end(), k, lessKey);
+    if (it != sorted_.end() && it->first == k)
+    {
+      const size_t pos = it - sorted_.begin();
+      if (removed_[pos])
+      {
+        removed_[pos] = false;
+        it->second = Index();
+        ++size_;
+      }
+      return it->second;
+    }
+    auto added = addedIndex_.find(k);
+    if (added != addedIndex_.end())
+      return added_[added->second].second;
+    addedIndex_.emplace(k, added_.size());
+    added_.emplace_back(k, Index());
+    ++size_;
+    return added_.back().second;
+  }
+
+  void erase(iterator it)
+  {
+    if (!sorted_.empty() && it >= sorted_.data() && it < sorted_.data() + sorted_.size())
+      removed_[it - sorted_.data()] = true;
+    else
+      addedIndex_.erase(it->first);
+    --size_;
+  }
+
+  void clear()
+  {
+    std::vector<value_type>().swap(sorted_);
+    std::vector<bool>().swap(removed_);
+    added_.clear();
+    addedIndex_.clear();
+    size_ = 0;
+  }
+
+  /// Replaces the contents by count entities: entity i gets the key
+  /// keyOf(i) and the index i. The keys must be canonical and increasing.
+  template <class KeyOf>
+  void assign(size_t count, KeyOf keyOf)
+  {
+    clear();
+    sorted_.resize(count);
+    Core::Thread::Parallel::For(0, count, [&](size_t begin, size_t end)
+    {
+      for (auto i = begin; i < end; ++i)
+      {
+        const auto* key = keyOf(i);
+        std::copy(key, key + N, sorted_[i].first.begin());
+        sorted_[i].second = static_cast<Index>(i);
+      }
+    });
+    removed_.assign(count, false);
+    size_ = count;
+  }
+
+private:
+  struct KeyHash
+  {
+    size_t operator()(const key_type& k) const
+    {
+      size_t h = 0;
+      for (auto n : k)
+        h ^= std::hash<index_type>()(n) + 0x9e3779b97f4a7c15ULL + (h << 6) + (h >> 2);
+      return h;
+    }
+  };
+
+  static bool lessKey(const value_type& v, const key_type& k) { return v.first < k; }
+
+  static key_type canonical(const Key& key)
+  {
+    key_type k;
+    Canonical()(key, k.data());
+    return k;
+  }
+
+  iterator lookup(const key_type& k)
+  {
+    auto it = std::lower_bound(sorted_.begin(), sorted_.end(), k, lessKey);
+    if (it != sorted_.end() && it->first == k)
+      return removed_[it - sorted_.begin()] ? nullptr : &*it;
+    if (addedIndex_.empty())
+      return nullptr;
+    auto added = addedIndex_.find(k);
+    return added == addedIndex_.end() ? nullptr : &added_[added->second];
+  }
+
+  std::vector<value_type> sorted_;
+  std::vector<bool> removed_;
+  std::deque<value_type> added_;
+  std::unordered_map<key_type, size_t, KeyHash> addedIndex_;
+  size_t size_ = 0;
+};
+
+/// Node to element (or node to node) adjacency in compressed rows: row n is
+/// values_[offsets_[n], offsets_[n+1]). Rows that are edited after the bulk
+/// build are copied out to a hash table, so single updates stay cheap.
+template <class T>
+class NodeNeighborTable
+{
+public:
+  /// Read only view of one row.
+  class Row
+  {
+  public:
+    Row(const T* first, const T* last) : first_(first), last_(last) {}
+    size_t size() const { return last_ - first_; }
+    bool empty() const { return first_ == last_; }
+    const T& operator[](size_t i) const { return first_[i]; }
+    const T* begin() const { return first_; }
+    const T* end() const { return last_; }
+  private:
+    const T* first_;
+    const T* last_;
+  };
+
+  Row operator[](size_t n) const
+  {
+    if (!edited_.empty())
+    {
+      auto it = edited_.find(n);
+      if (it != edited_.end())
+        return Row(it->second.data(), it->second.data() + it->second.size());
+    }
+    return Row(values_.data() + offsets_[n], values_.data() + offsets_[n + 1]);
+  }
+
+  size_t size() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+  void clear()
+  {
+    std::vector<size_t>().swap(offsets_);
+    std::vector<T>().swap(values_);
+    edited_.clear();
+  }
+
+  /// Builds rows [0, numRows): item i goes to the row rowOf(i) with the
+  /// value valueOf(i). Every row ends up sorted.
+  template <class RowOf, class ValueOf>
+  void build(size_t numItems, size_t numRows, RowOf rowOf, ValueOf valueOf)
+  {
+    clear();
+    offsets_ = detail::bucketOffsets(numItems, numRows, rowOf);
+    values_.resize(numItems);
+    detail::scatterToBuckets(numItems, offsets_, rowOf,
+      [&](size_t from, size_t to) { values_[to] = valueOf(from); });
+    Core::Thread::Parallel::For(0, numRows, [&](size_t begin, size_t end)
+    {
+      for (auto n = begin; n < end; ++n)
+        std::sort(values_.begin() + offsets_[n], values_.begin() + offsets_[n + 1]);
+    });
+  }
+
+  /// Appends an empty row.
+  void add_row()
+  {
+    if (offsets_.empty())
+      offsets_.push_back(0);
+    offsets_.push_back(offsets_.back());
+  }
+
+  /// Appends value to row n.
+  void insert(size_t n, const T& value)
+  {
+    edit(n).push_back(value);
+  }
+
+  /// Removes the first occurrence of value from row n; false if it is absent.
+  bool erase(size_t n, const T& value)
+  {
+    auto& row = edit(n);
+    auto it = std::find(row.begin(), row.end(), value);
+    if (it == row.end())
+      return false;
+    row.erase(it);
+    return true;
+  }
+
+private:
+  std::vector<T>& edit(size_t n)
+  {
+    auto it = edited_.find(n);
+    if (it == edited_.end())
+      it = edited_.emplace(n, std::vector<T>(values_.begin() + offsets_[n], values_.begin() + offsets_[n + 1])).first;
+    return it->second;
+  }
+
+  std::vector<size_t> offsets_;
+  std::vector<T> values_;
+  std::unordered_map<size_t, std::vector<T>> edited_;
+};
+
+/// Rows of the positions in the element connectivity array cells that refer
+/// to each node, in increasing order.
+template <class CellArray, class T>
+void computeNodeNeighbors(const CellArray& cells, size_t numNodes, NodeNeighborTable<T>& neighbors)
+{
+  neighbors.build(cells.size(), numNodes,
+    [&](size_t i) { return static_cast<size_t>(cells[i]); },
+    [](size_t i) { return static_cast<T>(i); });
+}
+
+}
+
+#endif
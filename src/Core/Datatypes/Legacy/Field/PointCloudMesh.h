@@ -1682,13 +1682,9 @@ PointCloudMesh<Basis>::compute_grid(Core::Geometry::BBox& bb)
     Core::Geometry::BBox b = bb; b.extend(10*epsilon_);
     grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    grid_->build_from_points(static_cast<size_type>(points_.size()),
+      [](size_t ni) { return static_cast<index_type>(ni); },
+      [this](size_t ni) { return points_[ni]; });
   }
   else
   {
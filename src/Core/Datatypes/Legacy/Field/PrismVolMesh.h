@@ -51,6 +51,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopology.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 
 #include <Core/Utils/Legacy/CheckSum.h>
@@ -1570,6 +1571,7 @@ protected:
     const index_type off = idx * 6;
     typename Node::index_type n1,n2;
 
+    array.resize(9);
     size_t i = 0;
     typedef typename ARRAY::value_type T;
 
@@ -1629,6 +1631,7 @@ protected:
       PEdge e(n1,n2);
       array[i++] = (static_cast<T>((*(edge_table_.find(e))).second));
     }
+    array.resize(i);
   }
 
   template <class ARRAY, class INDEX>
@@ -1717,9 +1720,9 @@ protected:
                 "Edge not found in PrismVolMesh::edge_table_");
       // Insert all cells that share this edge into
       // the unique set of cell indices
-      for (size_t c = 0; c < (iter->first).cells_.size(); c++)
-        unique_cells.insert(static_cast<typename ARRAY::value_type>(
-                                                    (iter->first).cells_[c]));
+      const PEdge& e = edges_[iter->second];
+      for (size_t c = 0; c < e.cells_.size(); c++)
+        unique_cells.insert(static_cast<typename ARRAY::value_type>(e.cells_[c]));
     }
 
     // Copy the unique set of cells to our Cells array return argument
@@ -1832,11 +1835,11 @@ protected:
   {
     ASSERTMSG(synchronized_ & NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on PrismVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
-    array.resize(sz);
-    for (size_t i=0; i< sz; i++)
+    const auto neighbors = node_neighbors_[node];
+    array.resize(neighbors.size());
+    for (size_t i=0; i< neighbors.size(); i++)
     {
-      array[i] = static_cast<typename ARRAY::value_type>(node_neighbors_[node][i]);
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]);
     }
   }
 
@@ -2169,6 +2172,7 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2410,82 +2414,27 @@ protected:
     }
   };
 
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_quarter_int = (int)(sz_int / 4);
-    static const int top4_mask = -(1 << sz_quarter_int << sz_quarter_int << sz_quarter_int);
-    static const int up4_mask = top4_mask ^ -(1 << sz_quarter_int << sz_quarter_int);
-    static const int mid4_mask =  top4_mask ^ -(1 << sz_quarter_int);
-    static const int low4_mask = ~(top4_mask | mid4_mask);
-
-    /// This is the hash function
-    size_t operator()(const PFace &f) const {
-      if (f.nodes_[1] < f.nodes_[3] )
+  /// Canonical key of a face. Triangles (the fourth node is
+  /// PRISM_DUMMY_NODE_INDEX) are not reordered by order_face_nodes, so their
+  /// nodes are sorted; quadrilaterals are keyed as in QuadFaceKey.
+  struct FaceKey
+  {
+    void operator()(const PFace &f, index_type* out) const
+    {
+      if (f.nodes_[3] == PRISM_DUMMY_NODE_INDEX)
       {
-        return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-              (up4_mask & (f.nodes_[1] << sz_quarter_int << sz_quarter_int)) |
-              (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-              (low4_mask & f.nodes_[3]));
+        std::copy(f.nodes_, f.nodes_ + 4, out);
+        std::sort(out, out + 3);
       }
       else
       {
-        return ((f.nodes_[0] << sz_quarter_int << sz_quarter_int <<sz_quarter_int) |
-              (up4_mask & (f.nodes_[3] << sz_quarter_int << sz_quarter_int)) |
-              (mid4_mask & (f.nodes_[2] << sz_quarter_int)) |
-              (low4_mask & f.nodes_[1]));
+        QuadFaceKey()(f, out);
       }
     }
-    /// This should return less than rather than equal to.
-    bool operator()(const PFace &f1, const PFace& f2) const {
-      return f1 < f2;
-    }
-  };
-
-  friend struct FaceHash; // needed by the gcc-2.95.3 compiler
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    size_t operator()(const PEdge &e) const
-    {
-      return (e.nodes_[0] << sz_half_int) |
-	(low_mask & e.nodes_[1]);
-    }
-
-    ///  This should return less than rather than equal to.
-    bool operator()(const PEdge &e1, const PEdge& e2) const
-    {
-      return e1 < e2;
-    }
   };
 
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
+  using face_ht = TopologyTable<PFace, 4, typename Face::index_type, FaceKey>;
+  using edge_ht = TopologyTable<PEdge, 2, typename Edge::index_type, SortedNodesKey<2>>;
 
   /// container for face storage. Must be computed each time
   ///  nodes or cells change.
@@ -2496,15 +2445,6 @@ protected:
   std::vector<PEdge>            edges_;
   edge_ht                  edge_table_;
 
-  inline
-  void hash_edge(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Cell::index_type ci, edge_ht &table) const;
-
-  inline
-  void hash_face(typename Node::index_type n1, typename Node::index_type n2,
-                 typename Node::index_type n3, typename Node::index_type n4,
-                 index_type combined_index, face_ht &table) const;
-
   template <class INDEX>
   bool order_face_nodes(INDEX& n1, INDEX& n2, INDEX& n3, INDEX& n4) const
   {
@@ -2557,31 +2497,12 @@ protected:
     return (true);
   }
 
-  /// useful functors
-  struct FillNodeNeighbors {
-    FillNodeNeighbors(std::vector<std::vector<typename Node::index_type> > &n,
-                      const PrismVolMesh &m) :
-      nbor_vec_(n),
-      mesh_(m)
-    {}
-
-    void operator()(typename Edge::index_type e) {
-      mesh_.get_nodes(nodes_, e);
-      nbor_vec_[nodes_[0]].push_back(nodes_[1]);
-      nbor_vec_[nodes_[1]].push_back(nodes_[0]);
-    }
-
-    std::vector<std::vector<typename Node::index_type> > &nbor_vec_;
-    const PrismVolMesh            &mesh_;
-    typename Node::array_type   nodes_;
-  };
-
   /// This grid is used as an acceleration structure to expedite calls
   ///  to locate.  For each cell in the grid, we store a list of which
   ///  tets overlap that grid cell -- to find the tet which contains a
   ///  point, we simply find which grid cell contains that point, and
   ///  then search just those tets that overlap that grid cell.
-  std::vector<std::vector<typename Node::index_type> > node_neighbors_;
+  NodeNeighborTable<typename Node::index_type> node_neighbors_;
 
   std::vector<unsigned char> boundary_faces_;
   SharedPointer<SearchGridT<index_type> >  node_grid_;
@@ -2886,99 +2807,86 @@ PrismVolMesh<Basis>::transform(const Core::Geometry::Transform &t)
 
 template <class Basis>
 void
-PrismVolMesh<Basis>::hash_face(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Node::index_type n3,
-			       typename Node::index_type n4,
-			       index_type combined_index,
-			       face_ht &table) const
+PrismVolMesh<Basis>::compute_faces()
 {
-  // Reorder nodes while maintaining CCW or CW orientation
-  // Check for degenerate faces, if faces has degeneracy it
-  // will be ignored (e.g. nodes on opposite corners are equal,
-  // or more then two nodes are equal)
-
-  if (!(order_face_nodes(n1,n2,n3,n4))) return;
-  PFace f(n1, n2, n3, n4);
+  const size_t numCells = cells_.size() / 6;
+  // 5 faces -- each is entered CCW from outside looking in
+  static const int faceNodes[5][4] =
+    { {0, 1, 2, -1}, {5, 4, 3, -1}, {1, 4, 5, 2}, {2, 5, 3, 0}, {0, 3, 4, 1} };
+
+  // Reorder nodes while maintaining CCW or CW orientation. Degenerate faces
+  // (nodes on opposite corners are equal, or more than two nodes are equal)
+  // are ignored.
+  auto faceOf = [this](size_t c, int f, PFace& face)
+  {
+    const auto* nodes = &cells_[c * 6];
+    typename Node::index_type n1 = nodes[faceNodes[f][0]], n2 = nodes[faceNodes[f][1]],
+      n3 = nodes[faceNodes[f][2]];
+    typename Node::index_type n4 = PRISM_DUMMY_NODE_INDEX;
+    if (faceNodes[f][3] >= 0) n4 = nodes[faceNodes[f][3]];
+    if (!order_face_nodes(n1, n2, n3, n4))
+      return false;
+    face = PFace(n1, n2, n3, n4);
+    return true;
+  };
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  std::vector<TopologyRecord<4>> records(numCells * 5);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    PFace face;
+    for (size_t c = begin; c < end; ++c)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << ", #" << (f.cells_[1]>>3) << ", and #" << (combined_index >> 3)
-           << " are illegally adjacent." << std::endl;*/
-    }
-    else if ((f.cells_[0]>>3) == (combined_index>>3))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "PrismVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>3) << " and #" << (combined_index>>3)
-           << " are the same." << std::endl;
-           */
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      for (int f = 0; f < 5; ++f)
+      {
+        auto& record = records[c * 5 + f];
+        if (!faceOf(c, f, face))
+        {
+          record.combined = MESH_NO_NEIGHBOR;
+          continue;
+        }
+        FaceKey()(face, record.key);
+        record.combined = static_cast<index_type>((c << 3) + f);
+      }
     }
-  }
-}
+  });
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::compute_faces()
-{
-  face_table_.clear();
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numFaces = groups.size() - 1;
 
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(6);
-  while (ci != cie)
+  // The first cell found (the lowest index) owns the face and its node
+  // order; a face shared by more than two cells only records the first two.
+  faces_.clear();
+  faces_.resize(numFaces);
+  Core::Thread::Parallel::For(0, numFaces, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 5 faces -- each is entered CCW from outside looking in
-    index_type cell_index = (*ci)<<3;
-    hash_face(arr[0], arr[1], arr[2], PRISM_DUMMY_NODE_INDEX, cell_index, face_table_);
-    hash_face(arr[5], arr[4], arr[3], PRISM_DUMMY_NODE_INDEX, cell_index + 1, face_table_);
-    hash_face(arr[1], arr[4], arr[5], arr[2], cell_index + 2, face_table_);
-    hash_face(arr[2], arr[5], arr[3], arr[0], cell_index + 3, face_table_);
-    hash_face(arr[0], arr[3], arr[4], arr[1], cell_index + 4, face_table_);
-
-    ++ci;
-  }
-
-  // dump edges into the edges_ container.
-  faces_.resize(face_table_.size());
-  typename std::vector<PFace>::iterator f_iter = faces_.begin();
-  typename face_ht::iterator ht_iter = face_table_.begin();
+    for (size_t g = begin; g < end; ++g)
+    {
+      const index_type first = records[groups[g]].combined;
+      PFace& face = faces_[g];
+      faceOf(first >> 3, first & 0x7, face);
+      face.cells_[0] = first;
+      for (size_t r = groups[g] + 1; r < groups[g + 1]; ++r)
+      {
+        if ((records[r].combined >> 3) != (first >> 3))
+        {
+          face.cells_[1] = records[r].combined;
+          break;
+        }
+      }
+    }
+  });
 
-  boundary_faces_.resize(cells_.size() /6);
+  face_table_.assign(numFaces, [&](size_t g) { return records[groups[g]].key; });
 
-  index_type i = 0;
-  while (ht_iter != face_table_.end())
+  boundary_faces_.assign(numCells, 0);
+  for (size_t g = 0; g < numFaces; ++g)
   {
-    *f_iter = (*ht_iter).first;
-    (*ht_iter).second = i;
-
-    if ((*f_iter).cells_[1] == -1)
+    if (faces_[g].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = ((*f_iter).cells_[0]) >> 3;
-      index_type face = ((*f_iter).cells_[0]) & 0x7;
+      index_type cell = (faces_[g].cells_[0]) >> 3;
+      index_type face = (faces_[g].cells_[0]) & 0x7;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++f_iter; ++ht_iter; i++;
   }
 
   synchronize_lock_.lock();
@@ -2986,66 +2894,51 @@ PrismVolMesh<Basis>::compute_faces()
   synchronize_lock_.unlock();
 }
 
-template <class Basis>
-void
-PrismVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-			       typename Node::index_type n2,
-			       typename Cell::index_type ci,
-			       edge_ht &table) const
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-  if (iter == table.end())
-  {
-    e.cells_.push_back(ci); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(ci); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 PrismVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr;
-  while (ci != cie)
-  {
-    get_nodes(arr, *ci);
-    hash_edge(arr[0], arr[1], *ci, edge_table_);
-    hash_edge(arr[1], arr[2], *ci, edge_table_);
-    hash_edge(arr[2], arr[0], *ci, edge_table_);
+  const size_t numCells = cells_.size() / 6;
+  static const int edgeNodes[9][2] =
+    { {0, 1}, {1, 2}, {2, 0}, {3, 4}, {4, 5}, {5, 3}, {0, 3}, {4, 1}, {2, 5} };
 
-    hash_edge(arr[3], arr[4], *ci, edge_table_);
-    hash_edge(arr[4], arr[5], *ci, edge_table_);
-    hash_edge(arr[5], arr[3], *ci, edge_table_);
-
-    hash_edge(arr[0], arr[3], *ci, edge_table_);
-    hash_edge(arr[4], arr[1], *ci, edge_table_);
-    hash_edge(arr[2], arr[5], *ci, edge_table_);
-    ++ci;
-  }
+  std::vector<TopologyRecord<2>> records(numCells * 9);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
+  {
+    for (size_t c = begin; c < end; ++c)
+    {
+      const auto* nodes = &cells_[c * 6];
+      for (int e = 0; e < 9; ++e)
+      {
+        const index_type n1 = nodes[edgeNodes[e][0]];
+        const index_type n2 = nodes[edgeNodes[e][1]];
+        auto& record = records[c * 9 + e];
+        record.key[0] = std::min(n1, n2);
+        record.key[1] = std::max(n1, n2);
+        record.combined = (n1 == n2) ? MESH_NO_NEIGHBOR : static_cast<index_type>((c << 4) + e);
+      }
+    }
+  });
 
-  // dump edges into the edges_ container.
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numEdges = groups.size() - 1;
 
-  edges_.resize(edge_table_.size());
+  edges_.clear();
+  edges_.resize(numEdges);
+  Core::Thread::Parallel::For(0, numEdges, [&](size_t begin, size_t end)
+  {
+    for (size_t g = begin; g < end; ++g)
+    {
+      const auto* key = records[groups[g]].key;
+      PEdge& edge = edges_[g];
+      edge = PEdge(key[0], key[1]);
+      edge.cells_.reserve(groups[g + 1] - groups[g]);
+      for (size_t r = groups[g]; r < groups[g + 1]; ++r)
+        edge.cells_.push_back(records[r].combined >> 4);
+    }
+  });
 
-  typename std::vector<PEdge>::iterator e_iter = edges_.begin();
-  typename edge_ht::iterator ht_iter = edge_table_.begin();
-  while (ht_iter != edge_table_.end()) {
-    *e_iter = (*ht_iter).first;
-    (*ht_iter).second = static_cast<typename Edge::index_type>(
-                                                      e_iter - edges_.begin());
-    ++e_iter; ++ht_iter;
-  }
+  edge_table_.assign(numEdges, [&](size_t g) { return records[groups[g]].key; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3337,11 +3230,10 @@ template <class Basis>
 void
 PrismVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  typename Edge::iterator ei, eie;
-  begin(ei); end(eie);
-  std::for_each(ei, eie, FillNodeNeighbors(node_neighbors_, *this));
+  // Both directions of every edge
+  node_neighbors_.build(edges_.size() * 2, points_.size(),
+    [&](size_t i) { return static_cast<size_t>(edges_[i >> 1].nodes_[i & 1]); },
+    [&](size_t i) { return edges_[i >> 1].nodes_[(i & 1) ^ 1]; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3384,12 +3276,9 @@ PrismVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Cell::
 }
 
 template <class Basis>
-void
-PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+PrismVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*6;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3399,23 +3288,24 @@ PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+4]]);
   box.extend(points_[cells_[idx+5]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+template <class Basis>
+void
+PrismVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
 void
 PrismVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*6;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(points_[cells_[idx+4]]);
-  box.extend(points_[cells_[idx+5]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3456,13 +3346,9 @@ PrismVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->build_from_boxes(esz,
+      [](size_t ci) { return static_cast<index_type>(ci); },
+      [this](size_t ci) { return elem_grid_bbox(static_cast<index_type>(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3493,13 +3379,9 @@ PrismVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->build_from_points(static_cast<size_type>(points_.size()),
+      [](size_t ni) { return static_cast<index_type>(ni); },
+      [this](size_t ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
@@ -1048,6 +1048,7 @@ public:
 
 private:
 
+  Core::Geometry::BBox elem_grid_bbox(typename LatVolMesh<Basis>::Elem::index_type idx) const;
   void insert_elem_into_grid(typename LatVolMesh<Basis>::Elem::index_type idx);
   void remove_elem_from_grid(typename LatVolMesh<Basis>::Elem::index_type idx);
   void insert_node_into_grid(typename LatVolMesh<Basis>::Node::index_type idx);
@@ -1732,12 +1733,9 @@ StructHexVolMesh<Basis>::clear_synchronization()
 }
 
 template <class Basis>
-void
-StructHexVolMesh<Basis>::insert_elem_into_grid(typename LatVolMesh<Basis>::Elem::index_type idx)
+Core::Geometry::BBox
+StructHexVolMesh<Basis>::elem_grid_bbox(typename LatVolMesh<Basis>::Elem::index_type idx) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   Core::Geometry::BBox box;
   box.extend(points_(idx.k_,idx.j_,idx.i_));
   box.extend(points_(idx.k_+1,idx.j_,idx.i_));
@@ -1748,7 +1746,16 @@ StructHexVolMesh<Basis>::insert_elem_into_grid(typename LatVolMesh<Basis>::Elem:
   box.extend(points_(idx.k_,idx.j_+1,idx.i_+1));
   box.extend(points_(idx.k_+1,idx.j_+1,idx.i_+1));
   box.extend(epsilon_);
-  elem_grid_->insert(idx, box);
+  return box;
+}
+
+template <class Basis>
+void
+StructHexVolMesh<Basis>::insert_elem_into_grid(typename LatVolMesh<Basis>::Elem::index_type idx)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(idx, elem_grid_bbox(idx));
 }
 
 
@@ -1756,17 +1763,7 @@ template <class Basis>
 void
 StructHexVolMesh<Basis>::remove_elem_from_grid(typename LatVolMesh<Basis>::Elem::index_type idx)
 {
-  Core::Geometry::BBox box;
-  box.extend(points_(idx.k_,idx.j_,idx.i_));
-  box.extend(points_(idx.k_+1,idx.j_,idx.i_));
-  box.extend(points_(idx.k_,idx.j_+1,idx.i_));
-  box.extend(points_(idx.k_+1,idx.j_+1,idx.i_));
-  box.extend(points_(idx.k_,idx.j_,idx.i_+1));
-  box.extend(points_(idx.k_+1,idx.j_,idx.i_+1));
-  box.extend(points_(idx.k_,idx.j_+1,idx.i_+1));
-  box.extend(points_(idx.k_+1,idx.j_+1,idx.i_+1));
-  box.extend(epsilon_);
-  elem_grid_->remove(idx, box);
+  elem_grid_->remove(idx, elem_grid_bbox(idx));
 }
 
 template <class Basis>
@@ -1808,14 +1805,15 @@ StructHexVolMesh<Basis>::compute_elem_grid(Core::Geometry::BBox& bb)
     Core::Geometry::BBox b = bb; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<typename LatVolMesh<Basis>::Elem::index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
+    std::vector<typename LatVolMesh<Basis>::Elem::index_type> elems;
     typename LatVolMesh<Basis>::Elem::iterator ci, cie;
     this->begin(ci);
     this->end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    for (; ci != cie; ++ci)
+      elems.push_back(*ci);
+    elem_grid_->build_from_boxes(static_cast<size_type>(elems.size()),
+      [&elems](size_t n) { return elems[n]; },
+      [this, &elems](size_t n) { return elem_grid_bbox(elems[n]); });
   }
 
   synchronized_ |= Mesh::ELEM_LOCATE_E;
@@ -1843,14 +1841,15 @@ StructHexVolMesh<Basis>::compute_node_grid(Core::Geometry::BBox& bb)
     Core::Geometry::BBox b = bb; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<typename LatVolMesh<Basis>::Node::index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
+    std::vector<typename LatVolMesh<Basis>::Node::index_type> nodes;
     typename LatVolMesh<Basis>::Node::iterator ni, nie;
     this->begin(ni);
     this->end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    for (; ni != nie; ++ni)
+      nodes.push_back(*ni);
+    node_grid_->build_from_points(static_cast<size_type>(nodes.size()),
+      [&nodes](size_t n) { return nodes[n]; },
+      [this, &nodes](size_t n) { return points_[nodes[n]]; });
   }
 
   synchronized_ |= Mesh::NODE_LOCATE_E;
@@ -0,0 +1,192 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <algorithm>
+#include <cmath>
+
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // n x n x n unit hexes
+  FieldHandle gridHexVol(int n)
+  {
+    FieldInformation fi(mesh_info_type::HEXVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::NONE_E);
+    FieldHandle field = CreateField(fi);
+    auto mesh = field->vmesh();
+    const int m = n + 1;
+    for (int k = 0; k < m; ++k)
+      for (int j = 0; j < m; ++j)
+        for (int i = 0; i < m; ++i)
+          mesh->add_point(Point(i, j, k));
+
+    auto node = [m](int i, int j, int k) { return VMesh::Node::index_type(i + m * (j + m * k)); };
+    for (int k = 0; k < n; ++k)
+      for (int j = 0; j < n; ++j)
+        for (int i = 0; i < n; ++i)
+        {
+          VMesh::Node::array_type nodes(8);
+          nodes[0] = node(i, j, k);
+          nodes[1] = node(i + 1, j, k);
+          nodes[2] = node(i + 1, j + 1, k);
+          nodes[3] = node(i, j + 1, k);
+          nodes[4] = node(i, j, k + 1);
+          nodes[5] = node(i + 1, j, k + 1);
+          nodes[6] = node(i + 1, j + 1, k + 1);
+          nodes[7] = node(i, j + 1, k + 1);
+          mesh->add_elem(nodes);
+        }
+    return field;
+  }
+}
+
+TEST(HexVolMeshTest, BuildsConsistentTopologyTables)
+{
+  auto field = gridHexVol(2);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E);
+
+  EXPECT_EQ(27, mesh->num_nodes());
+  EXPECT_EQ(54, mesh->num_edges());
+  EXPECT_EQ(36, mesh->num_faces());
+  EXPECT_EQ(8, mesh->num_elems());
+
+  size_type boundaryFaces = 0;
+  for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+  {
+    VMesh::Face::array_type faces;
+    mesh->get_faces(faces, e);
+    ASSERT_EQ(6, faces.size());
+    for (auto f : faces)
+    {
+      VMesh::Elem::index_type neighbor;
+      if (mesh->get_neighbor(neighbor, e, VMesh::DElem::index_type(f)))
+      {
+        VMesh::Face::array_type neighborFaces;
+        mesh->get_faces(neighborFaces, neighbor);
+        EXPECT_NE(neighborFaces.end(), std::find(neighborFaces.begin(), neighborFaces.end(), f));
+      }
+      else
+        ++boundaryFaces;
+
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, f);
+      VMesh::Face::index_type found;
+      ASSERT_TRUE(mesh->get_face(found, nodes));
+      EXPECT_EQ(f, found);
+    }
+
+    VMesh::Edge::array_type edges;
+    mesh->get_edges(edges, e);
+    ASSERT_EQ(12, edges.size());
+    for (auto edge : edges)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, edge);
+      VMesh::Edge::index_type found;
+      ASSERT_TRUE(mesh->get_edge(found, nodes));
+      EXPECT_EQ(edge, found);
+    }
+  }
+  EXPECT_EQ(24, boundaryFaces);
+
+  // The center node is shared by all hexes, a corner node by one
+  VMesh::Elem::array_type elems;
+  mesh->get_elems(elems, VMesh::Node::index_type(13));
+  EXPECT_EQ(8, elems.size());
+  mesh->get_elems(elems, VMesh::Node::index_type(0));
+  EXPECT_EQ(1, elems.size());
+}
+
+TEST(HexVolMeshTest, BatchLocateMatchesPointLocate)
+{
+  auto field = gridHexVol(4);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::ELEM_LOCATE_E | Mesh::FIND_CLOSEST_ELEM_E);
+
+  // Points off the element faces, some of them outside the mesh
+  std::vector<Point> points;
+  for (int k = 0; k < 11; ++k)
+    for (int j = 0; j < 11; ++j)
+      for (int i = 0; i < 11; ++i)
+        points.emplace_back(-0.73 + 0.53 * i, -0.43 + 0.47 * j, -0.29 + 0.51 * k);
+
+  std::vector<VMesh::Elem::index_type> elems;
+  std::vector<VMesh::coords_type> coords;
+  mesh->mlocate(elems, coords, points);
+  ASSERT_EQ(points.size(), elems.size());
+  ASSERT_EQ(points.size(), coords.size());
+
+  size_t outside = 0;
+  for (size_t j = 0; j < points.size(); ++j)
+  {
+    VMesh::Elem::index_type expected;
+    if (!mesh->locate(expected, points[j]))
+    {
+      EXPECT_EQ(-1, elems[j]);
+      ++outside;
+      continue;
+    }
+    ASSERT_EQ(expected, elems[j]);
+    Point p;
+    mesh->interpolate(p, coords[j], elems[j]);
+    EXPECT_NEAR(0.0, (p - points[j]).length(), 1e-8);
+  }
+  EXPECT_GT(outside, 0u);
+  EXPECT_LT(outside, points.size());
+
+  // Outside points snap to the closest element within the distance limit
+  std::vector<double> dists;
+  std::vector<Point> results;
+  mesh->mfind_closest_elem(dists, results, coords, elems, points, 0.5);
+  for (size_t j = 0; j < points.size(); ++j)
+  {
+    const Point& q = points[j];
+    const double dx = std::max({0.0, -q.x(), q.x() - 4.0});
+    const double dy = std::max({0.0, -q.y(), q.y() - 4.0});
+    const double dz = std::max({0.0, -q.z(), q.z() - 4.0});
+    const double d = std::sqrt(dx * dx + dy * dy + dz * dz);
+    if (d < 0.45)
+    {
+      ASSERT_GE(elems[j], 0);
+      EXPECT_NEAR(d, dists[j], 1e-8);
+    }
+    else if (d > 0.55)
+    {
+      EXPECT_EQ(-1, elems[j]);
+    }
+  }
+}
@@ -0,0 +1,138 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <algorithm>
+
+#include <gtest/gtest.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  // A unit square split into two triangles, extruded into layers of prisms
+  FieldHandle stackedPrismVol(int layers)
+  {
+    FieldInformation fi(mesh_info_type::PRISMVOLMESH_E, databasis_info_type::LINEARDATA_E, data_info_type::NONE_E);
+    FieldHandle field = CreateField(fi);
+    auto mesh = field->vmesh();
+    for (int k = 0; k <= layers; ++k)
+    {
+      mesh->add_point(Point(0, 0, k));
+      mesh->add_point(Point(1, 0, k));
+      mesh->add_point(Point(1, 1, k));
+      mesh->add_point(Point(0, 1, k));
+    }
+
+    static const int triangles[2][3] = { {0, 1, 2}, {0, 2, 3} };
+    for (int k = 0; k < layers; ++k)
+      for (const auto& tri : triangles)
+      {
+        VMesh::Node::array_type nodes(6);
+        for (int i = 0; i < 3; ++i)
+        {
+          nodes[i] = VMesh::Node::index_type(4 * k + tri[i]);
+          nodes[i + 3] = VMesh::Node::index_type(4 * (k + 1) + tri[i]);
+        }
+        mesh->add_elem(nodes);
+      }
+    return field;
+  }
+}
+
+TEST(PrismVolMeshTest, BuildsConsistentTopologyTables)
+{
+  auto field = stackedPrismVol(2);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E);
+
+  // 5 edges on each of the 3 levels and 4 vertical edges per layer; 2
+  // triangles per level and 5 quadrilaterals per layer
+  EXPECT_EQ(12, mesh->num_nodes());
+  EXPECT_EQ(23, mesh->num_edges());
+  EXPECT_EQ(16, mesh->num_faces());
+  EXPECT_EQ(4, mesh->num_elems());
+
+  size_type boundaryFaces = 0;
+  size_type boundaryTriangles = 0;
+  for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+  {
+    VMesh::Node::array_type elemNodes;
+    mesh->get_nodes(elemNodes, e);
+
+    VMesh::Face::array_type faces;
+    mesh->get_faces(faces, e);
+    ASSERT_EQ(5, faces.size());
+    for (auto f : faces)
+    {
+      VMesh::Node::array_type faceNodes;
+      mesh->get_nodes(faceNodes, f);
+      for (auto n : faceNodes)
+        EXPECT_NE(elemNodes.end(), std::find(elemNodes.begin(), elemNodes.end(), n));
+
+      // The triangles between two layers are entered in opposite orientations
+      // by the prisms below and above them, and are still shared
+      VMesh::Elem::index_type neighbor;
+      if (mesh->get_neighbor(neighbor, e, VMesh::DElem::index_type(f)))
+      {
+        VMesh::Face::array_type neighborFaces;
+        mesh->get_faces(neighborFaces, neighbor);
+        EXPECT_NE(neighborFaces.end(), std::find(neighborFaces.begin(), neighborFaces.end(), f));
+      }
+      else
+      {
+        ++boundaryFaces;
+        if (faceNodes.size() == 3)
+          ++boundaryTriangles;
+      }
+    }
+
+    VMesh::Edge::array_type edges;
+    mesh->get_edges(edges, e);
+    EXPECT_EQ(9, edges.size());
+  }
+  EXPECT_EQ(12, boundaryFaces);
+  EXPECT_EQ(4, boundaryTriangles);
+
+  // Node 4 is on the shared diagonal of the middle level, node 5 is not
+  VMesh::Elem::array_type elems;
+  mesh->get_elems(elems, VMesh::Node::index_type(4));
+  EXPECT_EQ(4, elems.size());
+  mesh->get_elems(elems, VMesh::Node::index_type(5));
+  EXPECT_EQ(2, elems.size());
+
+  VMesh::Node::array_type neighbors;
+  mesh->get_neighbors(neighbors, VMesh::Node::index_type(0));
+  std::vector<index_type> sorted(neighbors.begin(), neighbors.end());
+  std::sort(sorted.begin(), sorted.end());
+  EXPECT_EQ(std::vector<index_type>({1, 2, 3, 4}), sorted);
+}
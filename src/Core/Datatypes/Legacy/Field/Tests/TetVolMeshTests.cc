@@ -32,6 +32,9 @@
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Core/Persistent/Pstreams.h>
+#include <Core/Containers/Array3.h>
+#include <boost/filesystem.hpp>
 
 #include <gtest/gtest.h>
 
@@ -68,3 +71,205 @@ TEST(TetVolMeshTest, CheckMeshIteratorTetVolMesh)
   ASSERT_EQ(c, 6);
 
 }
+
+TEST(TetVolMeshTest, BuildsConsistentTopologyTables)
+{
+  auto field = CubeTetVolLinearBasis(data_info_type::NONE_E);
+  auto mesh = field->vmesh();
+  mesh->synchronize(Mesh::EDGES_E | Mesh::FACES_E | Mesh::NODE_NEIGHBORS_E);
+
+  // The tetrahedralized cube is a ball: V - E + F - C == 1
+  const auto numNodes = mesh->num_nodes();
+  const auto numEdges = mesh->num_edges();
+  const auto numFaces = mesh->num_faces();
+  EXPECT_EQ(8, numNodes);
+  EXPECT_EQ(1, numNodes - numEdges + numFaces - mesh->num_elems());
+
+  // Each of the 6 sides of the cube is split into two boundary triangles
+  size_type boundaryFaces = 0;
+  for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+  {
+    VMesh::Face::array_type faces;
+    mesh->get_faces(faces, e);
+    ASSERT_EQ(4, faces.size());
+    for (auto f : faces)
+    {
+      VMesh::Elem::index_type neighbor;
+      if (mesh->get_neighbor(neighbor, e, VMesh::DElem::index_type(f)))
+      {
+        VMesh::Face::array_type neighborFaces;
+        mesh->get_faces(neighborFaces, neighbor);
+        EXPECT_NE(neighborFaces.end(), std::find(neighborFaces.begin(), neighborFaces.end(), f));
+      }
+      else
+        ++boundaryFaces;
+
+      VMesh::Node::array_type faceNodes, elemNodes;
+      mesh->get_nodes(faceNodes, f);
+      mesh->get_nodes(elemNodes, e);
+      ASSERT_EQ(3, faceNodes.size());
+      for (auto n : faceNodes)
+        EXPECT_NE(elemNodes.end(), std::find(elemNodes.begin(), elemNodes.end(), n));
+    }
+  }
+  EXPECT_EQ(12, boundaryFaces);
+
+  // Every element using a node is listed exactly once among its neighbors
+  size_type incidences = 0;
+  for (VMesh::Node::index_type n = 0; n < numNodes; ++n)
+  {
+    VMesh::Elem::array_type elems;
+    mesh->get_elems(elems, n);
+    for (auto e : elems)
+    {
+      VMesh::Node::array_type nodes;
+      mesh->get_nodes(nodes, e);
+      EXPECT_NE(nodes.end(), std::find(nodes.begin(), nodes.end(), n));
+    }
+    incidences += elems.size();
+  }
+  EXPECT_EQ(4 * mesh->num_elems(), incidences);
+}
+
+TEST(TetVolMeshTest, RoundTripsThroughPersistentStreams)
+{
+  auto field = CubeTetVolLinearBasis(data_info_type::DOUBLE_E);
+  auto mesh = field->vmesh();
+  auto values = field->vfield();
+  for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+    values->set_value(1.5 * i, i);
+
+  for (const std::string type : { "Binary", "Fast", "Text" })
+  {
+    const auto filename = (boost::filesystem::temp_directory_path() / ("TetVolMeshTest_roundtrip." + type)).string();
+    {
+      auto stream = auto_ostream(filename, type);
+      ASSERT_FALSE(stream->error());
+      Pio(*stream, field);
+    }
+
+    FieldHandle loaded;
+    {
+      // auto_istream does not recognize the non-portable Fast format
+      PiostreamPtr stream = type == "Fast" ? makeShared<FastPiostream>(filename, Piostream::Direction::Read) : auto_istream(filename);
+      ASSERT_TRUE(stream != nullptr);
+      Pio(*stream, loaded);
+      EXPECT_FALSE(stream->error());
+    }
+    boost::filesystem::remove(filename);
+
+    ASSERT_TRUE(loaded != nullptr) << type;
+    auto loadedMesh = loaded->vmesh();
+    ASSERT_EQ(mesh->num_nodes(), loadedMesh->num_nodes()) << type;
+    ASSERT_EQ(mesh->num_elems(), loadedMesh->num_elems()) << type;
+    for (VMesh::Node::index_type i = 0; i < mesh->num_nodes(); ++i)
+    {
+      Point expected, actual;
+      mesh->get_point(expected, i);
+      loadedMesh->get_point(actual, i);
+      EXPECT_EQ(expected, actual) << type;
+      double value;
+      loaded->vfield()->get_value(value, i);
+      EXPECT_EQ(1.5 * i, value) << type;
+    }
+    for (VMesh::Elem::index_type e = 0; e < mesh->num_elems(); ++e)
+    {
+      VMesh::Node::array_type expected, actual;
+      mesh->get_nodes(expected, e);
+      loadedMesh->get_nodes(actual, e);
+      EXPECT_EQ(expected, actual) << type;
+    }
+  }
+}
+
+TEST(BinarySwapPiostreamTest, BlockReadsSwapByteOrder)
+{
+  const auto filename = (boost::filesystem::temp_directory_path() / "BinarySwapPiostreamTest.bin").string();
+  std::vector<uint32_t> ints { 0x01020304u, 0xa0b0c0d0u, 7u };
+  std::vector<uint64_t> longs { 0x0102030405060708ull, 1ull };
+  {
+    BinaryPiostream out(filename, Piostream::Direction::Write);
+    ASSERT_TRUE(out.block_io(ints.data(), sizeof(uint32_t), ints.size()));
+    ASSERT_TRUE(out.block_io(longs.data(), sizeof(uint64_t), longs.size()));
+  }
+
+  std::vector<uint32_t> swappedInts(ints.size());
+  std::vector<uint64_t> swappedLongs(longs.size());
+  {
+    BinarySwapPiostream in(filename, Piostream::Direction::Read);
+    ASSERT_TRUE(in.supports_block_io());
+    ASSERT_TRUE(in.block_io(swappedInts.data(), sizeof(uint32_t), swappedInts.size()));
+    ASSERT_TRUE(in.block_io(swappedLongs.data(), sizeof(uint64_t), swappedLongs.size()));
+    EXPECT_FALSE(in.error());
+  }
+  boost::filesystem::remove(filename);
+
+  EXPECT_EQ(0x04030201u, swappedInts[0]);
+  EXPECT_EQ(0xd0c0b0a0u, swappedInts[1]);
+  EXPECT_EQ(0x07000000u, swappedInts[2]);
+  EXPECT_EQ(0x0807060504030201ull, swappedLongs[0]);
+  EXPECT_EQ(0x0100000000000000ull, swappedLongs[1]);
+}
+
+namespace
+{
+  // Writes every value byte reversed, like a binary stream written on a
+  // machine of the opposite endianness.
+  class OppositeEndianWriter : public BinaryPiostream
+  {
+  public:
+    explicit OppositeEndianWriter(const std::string& filename) : BinaryPiostream(filename, Direction::Write) {}
+
+    using BinaryPiostream::io;
+    void io(int& v) override { swapped(v); }
+    void io(unsigned int& v) override { swapped(v); }
+    void io(long long& v) override { swapped(v); }
+    void io(double& v) override { swapped(v); }
+    bool block_io(void*, size_t, size_t) override { return false; }
+
+  private:
+    template <class T> void swapped(T v)
+    {
+      auto bytes = reinterpret_cast<unsigned char*>(&v);
+      std::reverse(bytes, bytes + sizeof(T));
+      BinaryPiostream::io(v);
+    }
+  };
+}
+
+TEST(BinarySwapPiostreamTest, ArrayOfVectorsRoundTrip)
+{
+  const auto filename = (boost::filesystem::temp_directory_path() / "BinarySwapPiostreamTest_array3.bin").string();
+  Array3<Vector> vectors(2, 3, 4);
+  Array3<double> scalars(2, 3, 4);
+  for (size_t i = 0; i < vectors.size(); ++i)
+  {
+    vectors[i] = Vector(i + 0.25, -1.5*i, 1e10 + i);
+    scalars[i] = 0.5*i - 3;
+  }
+  {
+    OppositeEndianWriter out(filename);
+    Pio(out, vectors);
+    Pio(out, scalars);
+    ASSERT_FALSE(out.error());
+  }
+
+  Array3<Vector> loadedVectors;
+  Array3<double> loadedScalars;
+  {
+    BinarySwapPiostream in(filename, Piostream::Direction::Read);
+    Pio(in, loadedVectors);
+    Pio(in, loadedScalars);
+    EXPECT_FALSE(in.error());
+  }
+  boost::filesystem::remove(filename);
+
+  ASSERT_EQ(3, loadedVectors.dim2());
+  ASSERT_EQ(vectors.size(), loadedVectors.size());
+  ASSERT_EQ(scalars.size(), loadedScalars.size());
+  for (size_t i = 0; i < vectors.size(); ++i)
+  {
+    EXPECT_EQ(vectors[i], loadedVectors[i]) << i;
+    EXPECT_EQ(scalars[i], loadedScalars[i]) << i;
+  }
+}
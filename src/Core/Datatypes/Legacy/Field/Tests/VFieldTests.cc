@@ -30,6 +30,7 @@
 
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
 
@@ -190,3 +191,72 @@ TEST(VFieldTest, TetVolMeshSetFieldValueTest2)
   }
 
 }
+
+namespace
+{
+  FieldHandle LatVolWithValues()
+  {
+    FieldInformation fi("LatVolMesh", 1, "double");
+    MeshHandle mesh = CreateMesh(fi, 2, 3, 4, SCIRun::Core::Geometry::Point(0,0,0), SCIRun::Core::Geometry::Point(1,1,1));
+    FieldHandle field = CreateField(fi, mesh);
+    std::vector<double> values(24);
+    for (size_t k = 0; k < values.size(); k++) values[k] = static_cast<double>(k);
+    field->vfield()->set_values(values);
+    return field;
+  }
+}
+
+TEST(VFieldTest, LatVolValuesAreSharedAndCopiedOnWrite)
+{
+  FieldHandle field = LatVolWithValues();
+  VField *vfield = field->vfield();
+
+  auto buffer = std::static_pointer_cast<double>(vfield->share_values_buffer());
+  ASSERT_TRUE(buffer != nullptr);
+  EXPECT_EQ(2, buffer.use_count());
+
+  double val;
+  vfield->get_value(val, 7);
+  EXPECT_EQ(7.0, val);
+  EXPECT_EQ(7.0, buffer.get()[7]);
+  EXPECT_EQ(2, buffer.use_count());
+
+  vfield->set_value(-1.0, 7);
+  EXPECT_EQ(1, buffer.use_count());
+  EXPECT_EQ(7.0, buffer.get()[7]);
+  vfield->get_value(val, 7);
+  EXPECT_EQ(-1.0, val);
+}
+
+TEST(VFieldTest, LatVolAdoptsValueBuffer)
+{
+  FieldHandle field = LatVolWithValues();
+  VField *vfield = field->vfield();
+
+  std::shared_ptr<double> buffer(new double[24], std::default_delete<double[]>());
+  for (int k = 0; k < 24; k++) buffer.get()[k] = 0.5 * k;
+
+  ASSERT_TRUE(vfield->adopt_values_buffer(buffer));
+  EXPECT_EQ(buffer.get(), vfield->share_values_buffer().get());
+
+  double val;
+  vfield->get_value(val, 23);
+  EXPECT_EQ(11.5, val);
+
+  FieldHandle copy(field->clone());
+  copy->vfield()->get_value(val, 23);
+  EXPECT_EQ(11.5, val);
+
+  vfield->set_value(100.0, 23);
+  EXPECT_EQ(11.5, buffer.get()[23]);
+}
+
+TEST(VFieldTest, UnstructuredValuesAreNotShared)
+{
+  FieldHandle field = TetrahedronTetVolLinearBasis(data_info_type::DOUBLE_E);
+  VField *vfield = field->vfield();
+
+  EXPECT_TRUE(vfield->share_values_buffer() == nullptr);
+  std::shared_ptr<double> buffer(new double[4], std::default_delete<double[]>());
+  EXPECT_FALSE(vfield->adopt_values_buffer(buffer));
+}
@@ -51,6 +51,7 @@
 #include <Core/Datatypes/Legacy/Field/FieldIterator.h>
 #include <Core/Datatypes/Legacy/Field/FieldRNG.h>
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
+#include <Core/Datatypes/Legacy/Field/MeshTopology.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <Core/Datatypes/Mesh/VirtualMeshFacade.h>
 #include <Core/Math/MiscMath.h>
@@ -1704,10 +1705,10 @@ protected:
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
             "TetVolMesh: Must call synchronize NODE_NEIGHBORS_E first.");
 
-    array.resize(node_neighbors_[idx].size());
-    for (size_t i = 0; i < node_neighbors_[idx].size(); ++i)
-      array[i] = static_cast<typename ARRAY::value_type>(
-                                                  (node_neighbors_[idx][i])>>2);
+    const auto neighbors = node_neighbors_[idx];
+    array.resize(neighbors.size());
+    for (size_t i = 0; i < neighbors.size(); ++i)
+      array[i] = static_cast<typename ARRAY::value_type>(neighbors[i]>>2);
   }
 
   template<class ARRAY, class INDEX>
@@ -1719,7 +1720,7 @@ protected:
       "HexVolMesh: Must call synchronize EDGES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const auto neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1795,7 +1796,7 @@ protected:
       "TetVolMesh: Must call synchronize FACES_E first");
 
     // Get all the nodes that share an edge with this node
-    const std::vector<typename Cell::index_type>& neighbors = node_neighbors_[idx];
+    const auto neighbors = node_neighbors_[idx];
 
     array.clear();
     array.reserve(neighbors.size());
@@ -1931,12 +1932,12 @@ protected:
   {
     ASSERTMSG(synchronized_ & Mesh::NODE_NEIGHBORS_E,
               "Must call synchronize NODE_NEIGHBORS_E on TetVolMesh first.");
-    size_t sz = node_neighbors_[node].size();
+    const auto neighbors = node_neighbors_[node];
 
     std::set<index_type> inserted;
-    for (size_t i = 0; i < sz; i++)
+    for (size_t i = 0; i < neighbors.size(); i++)
     {
-      const index_type base = ((node_neighbors_[node][i])&(~0x3));
+      const index_type base = ((neighbors[i])&(~0x3));
       for (index_type c = base; c < base+4; ++c)
       {
         if (cells_[c] != node) inserted.insert(cells_[c]);
@@ -2263,6 +2264,7 @@ protected:
   void compute_elem_grid();
   void compute_bounding_box();
 
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
   void insert_node_into_grid(typename Node::index_type ci);
@@ -2481,77 +2483,8 @@ protected:
         PEdgeNode(n1,n2) {}
   };
 
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  static const int sz_int = sizeof(int) * 8; // in bits
-  struct FaceHash
-  {
-    // These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function).
-    static const int sz_third_int = (int)(sz_int / 3);
-    static const int up_mask = -(1 << sz_third_int << sz_third_int);
-    static const int mid_mask =  up_mask ^ -(1 << sz_third_int);
-    static const int low_mask = ~(up_mask | mid_mask);
-
-    /// This is the hash function
-    template <class PFACE>
-    size_t operator()(const PFACE &f) const
-    {
-      return ((up_mask & (static_cast<int>(f.nodes_[0]) << sz_third_int << sz_third_int)) |
-              (mid_mask & (static_cast<int>(f.nodes_[1]) << sz_third_int)) |
-              (low_mask & static_cast<int>(f.nodes_[2])));
-    }
-    /// This should return less than rather than equal to.
-
-    template <class PFACE>
-    bool operator()(const PFACE &f1, const PFACE& f2) const
-    {
-      return f1 < f2;
-    }
-  };
-
-  /// hash the egde's node_indecies such that edges with the same nodes
-  ///  hash to the same value. nodes are sorted on edge construction.
-  struct EdgeHash {
-    /// These are needed by the hash_map particularly
-    // ANSI C++ allows us to initialize these variables in the
-    // declaration.  However there may be compilers which will complain
-    // about it.
-    static const size_t bucket_size = 4;
-    static const size_t min_buckets = 8;
-
-    /// These are for our own use (making the hash function.
-    static const int sz_int = sizeof(int) * 8; // in bits
-    static const int sz_half_int = sizeof(int) << 2; // in bits
-    static const int up_mask = -(1 << sz_half_int);
-    static const int low_mask = (~((int)0) ^ up_mask);
-
-    /// This is the hash function
-    template <class PEDGE>
-    size_t operator()(const PEDGE &e) const
-    {
-      return (static_cast<int>(e.nodes_[0]) << sz_half_int) |
-              (low_mask & static_cast<int>(e.nodes_[1]));
-    }
-
-    ///  This should return less than rather than equal to.
-    template <class PEDGE>
-    bool operator()(const PEDGE &e1, const PEDGE& e2) const
-    {
-      return e1 < e2;
-    }
-  };
-
-  using face_ht = std::unordered_map<PFace, typename Face::index_type, FaceHash>;
-  using face_nt = std::unordered_map<PFaceNode, typename Face::index_type, FaceHash>;
-  using edge_ht = std::unordered_map<PEdge, typename Edge::index_type, EdgeHash>;
-  using edge_nt = std::unordered_map<PEdgeNode, typename Edge::index_type, EdgeHash>;
+  using face_nt = TopologyTable<PFaceNode, 3, typename Face::index_type, SortedNodesKey<3>>;
+  using edge_nt = TopologyTable<PEdgeNode, 2, typename Edge::index_type, SortedNodesKey<2>>;
 
   typedef std::vector<PFaceCell> face_ct;
   typedef std::vector<PEdgeCell> edge_ct;
@@ -2572,11 +2505,6 @@ protected:
 			  typename Cell::index_type ci,
 			  bool table_only = false);
 
-  inline void hash_edge(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        index_type combined_index,
-                        edge_ht& table);
-
   inline void add_edge(typename Node::index_type n1,
                         typename Node::index_type n2,
                         index_type combined_index);
@@ -2586,16 +2514,12 @@ protected:
                           typename Node::index_type n3,
                           typename Cell::index_type ci,
                           bool table_only = false);
-  inline void hash_face(typename Node::index_type n1,
-                        typename Node::index_type n2,
-                        typename Node::index_type n3,
-                        index_type ci, face_ht& table);
   inline void add_face(typename Node::index_type n1,
                        typename Node::index_type n2,
                        typename Node::index_type n3,
                        index_type combined_index);
 
-  std::vector<std::vector<typename Cell::index_type> > node_neighbors_;
+  NodeNeighborTable<typename Cell::index_type> node_neighbors_;
   std::vector<unsigned char> boundary_faces_;
 
   /// This grid is used as an acceleration structure to expedite calls
@@ -2949,101 +2873,68 @@ TetVolMesh<Basis>::remove_face(typename Node::index_type n1,
 
 template <class Basis>
 void
-TetVolMesh<Basis>::hash_face(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             typename Node::index_type n3,
-                             index_type combined_index,
-                             face_ht& table)
+TetVolMesh<Basis>::compute_faces()
 {
-  PFace f(n1, n2, n3);
+  const size_t numCells = cells_.size() >> 2;
+  // 4 faces -- each is entered CCW from outside looking in
+  static const int faceNodes[4][3] = { {0, 2, 1}, {1, 2, 3}, {0, 1, 3}, {0, 3, 2} };
 
-  typename face_ht::iterator iter = table.find(f);
-  if (iter == table.end())
-  {
-    f.cells_[0] = combined_index;
-    table[f] = 0; // insert for the first time
-  }
-  else
+  std::vector<TopologyRecord<3>> records(numCells * 4);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
   {
-    PFace f = (*iter).first;
-    if (f.cells_[1] != MESH_NO_NEIGHBOR)
+    for (size_t c = begin; c < end; ++c)
     {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << ", #" << (f.cells_[1]>>2) << ", and #"
-           << (combined_index>>2) << " are illegally adjacent." << std::endl;
-           */
-    }
-    else if ((f.cells_[0]>>2) == (combined_index>>2))
-    {
-      //TODO: inject new logger
-      /*
-      std::cerr << "TetVolMesh - This Mesh has problems: Cells #"
-           << (f.cells_[0]>>2) << " and #" << (combined_index>>2)
-           << " are the same." << std::endl;*/
-    }
-    else
-    {
-      f.cells_[1] = combined_index; // add this cell
-      table.erase(iter);
-      table[f] = 0;
+      const auto* nodes = &cells_[c << 2];
+      for (int f = 0; f < 4; ++f)
+      {
+        PFaceNode face(nodes[faceNodes[f][0]], nodes[faceNodes[f][1]], nodes[faceNodes[f][2]]);
+        auto& record = records[(c << 2) + f];
+        std::copy(face.nodes_, face.nodes_ + 3, record.key);
+        record.combined = static_cast<index_type>((c << 2) + f);
+      }
     }
-  }
-}
-
-template <class Basis>
-void
-TetVolMesh<Basis>::compute_faces()
-{
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  typename Node::array_type arr(4);
+  });
 
-  face_ht table;
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numFaces = groups.size() - 1;
 
-  while (ci != cie)
+  // The first cell found (the lowest index) owns the face; a face shared by
+  // more than two cells only records the first two.
+  faces_.clear();
+  faces_.resize(numFaces);
+  Core::Thread::Parallel::For(0, numFaces, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    // 4 faces -- each is entered CCW from outside looking in
-
-    index_type cell_index = (*ci)<<2;
-    hash_face(arr[0], arr[2], arr[1], cell_index, table);
-    hash_face(arr[1], arr[2], arr[3], cell_index + 1, table);
-    hash_face(arr[0], arr[1], arr[3], cell_index + 2, table);
-    hash_face(arr[0], arr[3], arr[2], cell_index + 3, table);
-    ++ci;
-  }
-
-  faces_.resize(table.size());
-
-  typename face_ht::iterator ht_iter = table.begin();
-  typename face_ht::iterator ht_iter_end = table.end();
+    for (size_t g = begin; g < end; ++g)
+    {
+      PFaceCell& face = faces_[g];
+      face.cells_[0] = records[groups[g]].combined;
+      for (size_t r = groups[g] + 1; r < groups[g + 1]; ++r)
+      {
+        if ((records[r].combined >> 2) != (face.cells_[0] >> 2))
+        {
+          face.cells_[1] = records[r].combined;
+          break;
+        }
+      }
+    }
+  });
 
-  boundary_faces_.resize(cells_.size() >> 2);
+  face_table_.assign(numFaces, [&](size_t g) { return records[groups[g]].key; });
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  boundary_faces_.assign(numCells, 0);
+  for (size_t g = 0; g < numFaces; ++g)
   {
-    const PFace& pface = (*ht_iter).first;
-    faces_[uidx].cells_[0] = pface.cells_[0];
-    faces_[uidx].cells_[1] = pface.cells_[1];
-    face_table_[PFaceNode(pface.nodes_[0],pface.nodes_[1],pface.nodes_[2])] = uidx;
-
-    if (pface.cells_[1] == -1)
+    if (faces_[g].cells_[1] == MESH_NO_NEIGHBOR)
     {
-      index_type cell = (pface.cells_[0]) >> 2;
-      index_type face = (pface.cells_[0]) & 0x3;
+      index_type cell = (faces_[g].cells_[0]) >> 2;
+      index_type face = (faces_[g].cells_[0]) & 0x3;
       boundary_faces_[cell] |= 1 << face;
     }
-    ++ht_iter; uidx++;
   }
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::FACES_E;
   synchronize_lock_.unlock();
-
-
 }
 
 
@@ -3081,66 +2972,48 @@ TetVolMesh<Basis>::add_face(typename Node::index_type n1,
   }
 }
 
-template <class Basis>
-void
-TetVolMesh<Basis>::hash_edge(typename Node::index_type n1,
-                             typename Node::index_type n2,
-                             index_type combined_index,
-                             edge_ht& table)
-{
-  if (n1 == n2) return;
-  PEdge e(n1, n2);
-  typename edge_ht::iterator iter = table.find(e);
-
-  if (iter == table.end())
-  {
-    e.cells_.push_back(combined_index); // add this cell
-    table[e] = 0; // insert for the first time
-  }
-  else
-  {
-    PEdge e = (*iter).first;
-    e.cells_.push_back(combined_index); // add this cell
-    table.erase(iter);
-    table[e] = 0;
-  }
-}
-
 template <class Basis>
 void
 TetVolMesh<Basis>::compute_edges()
 {
-  typename Cell::iterator ci, cie;
-  begin(ci); end(cie);
-  edge_ht table;
+  const size_t numCells = cells_.size() >> 2;
+  static const int edgeNodes[6][2] = { {0, 1}, {1, 2}, {2, 0}, {3, 0}, {3, 1}, {3, 2} };
 
-  typename Node::array_type arr;
-  while (ci != cie)
+  std::vector<TopologyRecord<2>> records(numCells * 6);
+  Core::Thread::Parallel::For(0, numCells, [&](size_t begin, size_t end)
   {
-    get_nodes(arr, *ci);
-    index_type cell_index = (*ci)<<3;
-    hash_edge(arr[0], arr[1], cell_index  ,table);
-    hash_edge(arr[1], arr[2], cell_index+1,table);
-    hash_edge(arr[2], arr[0], cell_index+2,table);
-    hash_edge(arr[3], arr[0], cell_index+3,table);
-    hash_edge(arr[3], arr[1], cell_index+4,table);
-    hash_edge(arr[3], arr[2], cell_index+5,table);
-    ++ci;
-  }
-
-  edges_.resize(table.size());
+    for (size_t c = begin; c < end; ++c)
+    {
+      const auto* nodes = &cells_[c << 2];
+      for (int e = 0; e < 6; ++e)
+      {
+        const index_type n1 = nodes[edgeNodes[e][0]];
+        const index_type n2 = nodes[edgeNodes[e][1]];
+        auto& record = records[c * 6 + e];
+        record.key[0] = std::min(n1, n2);
+        record.key[1] = std::max(n1, n2);
+        record.combined = (n1 == n2) ? MESH_NO_NEIGHBOR : static_cast<index_type>((c << 3) + e);
+      }
+    }
+  });
 
-  typename edge_ht::iterator ht_iter = table.begin();
-  typename edge_ht::iterator ht_iter_end = table.end();
+  const auto groups = sortTopologyRecords(records, points_.size());
+  const size_t numEdges = groups.size() - 1;
 
-  index_type uidx = 0;
-  while (ht_iter != ht_iter_end)
+  edges_.clear();
+  edges_.resize(numEdges);
+  Core::Thread::Parallel::For(0, numEdges, [&](size_t begin, size_t end)
   {
-    const PEdge& pedge = (*ht_iter).first;
-    edges_[uidx].cells_ = pedge.cells_;
-    edge_table_[PEdgeNode(pedge.nodes_[0],pedge.nodes_[1])] = uidx;
-    ++ht_iter; uidx++;
-  }
+    for (size_t g = begin; g < end; ++g)
+    {
+      auto& cells = edges_[g].cells_;
+      cells.reserve(groups[g + 1] - groups[g]);
+      for (size_t r = groups[g]; r < groups[g + 1]; ++r)
+        cells.push_back(records[r].combined);
+    }
+  });
+
+  edge_table_.assign(numEdges, [&](size_t g) { return records[groups[g]].key; });
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::EDGES_E;
@@ -3541,7 +3414,7 @@ TetVolMesh<Basis>::create_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    node_neighbors_[cells_[i]].push_back(i);
+    node_neighbors_.insert(cells_[i], i);
   }
 }
 
@@ -3552,17 +3425,10 @@ TetVolMesh<Basis>::delete_cell_node_neighbors(typename Cell::index_type c)
 {
   for (index_type i = c*4; i < c*4+4; ++i)
   {
-    const index_type n = cells_[i];
-    typename std::vector<typename Cell::index_type>::iterator node_cells_end =
-      node_neighbors_[n].end();
-    typename std::vector<typename Cell::index_type>::iterator cell =
-      node_neighbors_[n].begin();
-    while (cell != node_cells_end && (*cell) != i) ++cell;
-
-    /// ASSERT that the node_neighbors_ structure contains this cell
-    ASSERT(cell != node_cells_end);
-
-    node_neighbors_[n].erase(cell);
+    if (!node_neighbors_.erase(cells_[i], i))
+    {
+      ASSERTFAIL("node_neighbors_ does not contain this cell");
+    }
   }
 }
 
@@ -3670,13 +3536,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::compute_node_neighbors()
 {
-  node_neighbors_.clear();
-  node_neighbors_.resize(points_.size());
-  index_type i, num_cells = cells_.size();
-  for (i = 0; i < num_cells; i++)
-  {
-    node_neighbors_[cells_[i]].push_back(i);
-  }
+  computeNodeNeighbors(cells_, points_.size(), node_neighbors_);
 
   synchronize_lock_.lock();
   synchronized_ |= Mesh::NODE_NEIGHBORS_E;
@@ -3719,12 +3579,9 @@ TetVolMesh<Basis>::get_weights(const Core::Geometry::Point &p, typename Node::ar
 }
 
 template <class Basis>
-void
-TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TetVolMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
-
   const index_type idx = ci*4;
   Core::Geometry::BBox box;
   box.extend(points_[cells_[idx]]);
@@ -3732,7 +3589,17 @@ TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
   box.extend(points_[cells_[idx+2]]);
   box.extend(points_[cells_[idx+3]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+template <class Basis>
+void
+TetVolMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3740,14 +3607,7 @@ template <class Basis>
 void
 TetVolMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*4;
-  Core::Geometry::BBox box;
-  box.extend(points_[cells_[idx]]);
-  box.extend(points_[cells_[idx+1]]);
-  box.extend(points_[cells_[idx+2]]);
-  box.extend(points_[cells_[idx+3]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 template <class Basis>
@@ -3788,13 +3648,9 @@ TetVolMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->build_from_boxes(esz,
+      [](size_t ci) { return static_cast<index_type>(ci); },
+      [this](size_t ci) { return elem_grid_bbox(static_cast<index_type>(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3825,13 +3681,9 @@ TetVolMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->build_from_points(static_cast<size_type>(points_.size()),
+      [](size_t ni) { return static_cast<index_type>(ni); },
+      [this](size_t ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
@@ -3888,7 +3740,7 @@ TetVolMesh<Basis>::add_find_point(const Core::Geometry::Point &p, double /*err*/
     if (synchronized_ & Mesh::NODE_NEIGHBORS_E)
     {
       synchronize_lock_.lock();
-      node_neighbors_.push_back(std::vector<typename Cell::index_type>());
+      node_neighbors_.add_row();
       synchronize_lock_.unlock();
     }
     return static_cast<typename Node::index_type>(points_.size() - 1);
@@ -4298,7 +4150,7 @@ TetVolMesh<Basis>::insert_node_in_elem(typename Elem::array_type &tets,
     }
 
     typename edge_nt::iterator iter = edge_table_.find(etmp);
-    PEdgeNode e = iter->first;
+    const PEdgeNode e = etmp;
     const std::vector<index_type>& cells = edges_[iter->second].cells_;
 
     pi = add_point(p);
@@ -4336,7 +4188,7 @@ TetVolMesh<Basis>::insert_node_in_elem(typename Elem::array_type &tets,
     }
 
     typename face_nt::iterator iter = face_table_.find(ftmp);
-    const PFaceNode& n = iter->first;
+    const PFaceNode n = ftmp;
     const PFaceCell& f = faces_[iter->second];
     typename Cell::index_type nbr_tet =
       (ci == (f.cells_[0])>>2) ? ((f.cells_[1])>>2) : ((f.cells_[0])>>2);
@@ -2013,6 +2013,7 @@ protected:
   void compute_bounding_box();
 
   /// Used to recompute data for individual cells.
+  Core::Geometry::BBox elem_grid_bbox(typename Elem::index_type ci) const;
   void insert_elem_into_grid(typename Elem::index_type ci);
   void remove_elem_from_grid(typename Elem::index_type ci);
 
@@ -3586,18 +3587,25 @@ TriSurfMesh<Basis>::compute_edge_neighbors()
 
 
 template <class Basis>
-void
-TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+Core::Geometry::BBox
+TriSurfMesh<Basis>::elem_grid_bbox(typename Elem::index_type ci) const
 {
-  /// @todo:  This can crash if you insert a new cell outside of the grid.
-  // Need to recompute grid at that point.
   const index_type idx = ci*3;
   Core::Geometry::BBox box;
   box.extend(points_[faces_[idx]]);
   box.extend(points_[faces_[idx+1]]);
   box.extend(points_[faces_[idx+2]]);
   box.extend(epsilon_);
-  elem_grid_->insert(ci, box);
+  return box;
+}
+
+template <class Basis>
+void
+TriSurfMesh<Basis>::insert_elem_into_grid(typename Elem::index_type ci)
+{
+  /// @todo:  This can crash if you insert a new cell outside of the grid.
+  // Need to recompute grid at that point.
+  elem_grid_->insert(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3605,13 +3613,7 @@ template <class Basis>
 void
 TriSurfMesh<Basis>::remove_elem_from_grid(typename Elem::index_type ci)
 {
-  const index_type idx = ci*3;
-  Core::Geometry::BBox box;
-  box.extend(points_[faces_[idx]]);
-  box.extend(points_[faces_[idx+1]]);
-  box.extend(points_[faces_[idx+2]]);
-  box.extend(epsilon_);
-  elem_grid_->remove(ci, box);
+  elem_grid_->remove(ci, elem_grid_bbox(ci));
 }
 
 
@@ -3655,13 +3657,9 @@ TriSurfMesh<Basis>::compute_elem_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     elem_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Elem::iterator ci, cie;
-    begin(ci); end(cie);
-    while(ci != cie)
-    {
-      insert_elem_into_grid(*ci);
-      ++ci;
-    }
+    elem_grid_->build_from_boxes(esz,
+      [](size_t ci) { return static_cast<index_type>(ci); },
+      [this](size_t ci) { return elem_grid_bbox(static_cast<index_type>(ci)); });
   }
 
   synchronize_lock_.lock();
@@ -3692,14 +3690,9 @@ TriSurfMesh<Basis>::compute_node_grid()
     Core::Geometry::BBox b = bbox_; b.extend(10*epsilon_);
     node_grid_.reset(new SearchGridT<index_type>(sx, sy, sz, b.get_min(), b.get_max()));
 
-    typename Node::iterator ni, nie;
-    begin(ni); end(nie);
-
-    while(ni != nie)
-    {
-      insert_node_into_grid(*ni);
-      ++ni;
-    }
+    node_grid_->build_from_points(static_cast<size_type>(points_.size()),
+      [](size_t ni) { return static_cast<index_type>(ni); },
+      [this](size_t ni) { return points_[ni]; });
   }
 
   synchronize_lock_.lock();
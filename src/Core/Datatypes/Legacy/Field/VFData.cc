@@ -126,6 +126,18 @@ VFData::efdata_pointer() const
   ASSERTFAIL("VFData interface has no virtual function implementation for efdata_pointer");
 }
 
+std::shared_ptr<void>
+VFData::share_fdata() const
+{
+  return std::shared_ptr<void>();
+}
+
+bool
+VFData::adopt_fdata(std::shared_ptr<void>)
+{
+  return false;
+}
+
 void
 VFData::resize_fdata(VMesh::dimension_type )
 {
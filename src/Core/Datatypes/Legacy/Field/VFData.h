@@ -38,6 +38,7 @@
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
 #include <vector>
 #include <complex>
+#include <memory>
 
 #include <Core/Datatypes/Legacy/Field/share.h>
 
@@ -98,6 +99,13 @@ public:
   virtual void* fdata_pointer() const;
   virtual void* efdata_pointer() const;
 
+  /// Share the values with other data without copying them. Only storage
+  /// with a reference counted buffer (Array3) supports this, for other
+  /// storage share_fdata returns an empty handle and adopt_fdata false.
+  /// adopt_fdata expects fdata_size() values of the field's own data type.
+  virtual std::shared_ptr<void> share_fdata() const;
+  virtual bool adopt_fdata(std::shared_ptr<void> data);
+
   VFDATA_ACCESS_DECLARATION_V(char)
   VFDATA_ACCESS_DECLARATION_V(unsigned char)
   VFDATA_ACCESS_DECLARATION_V(short)
@@ -54,7 +54,7 @@ template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_value(type &val, VMesh::index_type idx) const \
 { \
   TESTRANGE(idx,0,fdata_.size())\
-  val = CastFData<type>(fdata_[idx]); \
+  val = CastFData<type>(cfdata()[idx]); \
 } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
@@ -80,7 +80,7 @@ void VFDataT<FDATA,EFDATA,HFDATA>::set_evalue(const type &val, VMesh::index_type
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_values(type *ptr, VMesh::size_type sz, VMesh::size_type offset) const \
-{ if (static_cast<size_type>(fdata_.size()) < sz+offset) sz = static_cast<size_type>(fdata_.size())-offset; for (size_type i=0; i< sz; i++) ptr[i] = CastFData<type>(fdata_[i+offset]); } \
+{ if (static_cast<size_type>(fdata_.size()) < sz+offset) sz = static_cast<size_type>(fdata_.size())-offset; for (size_type i=0; i< sz; i++) ptr[i] = CastFData<type>(cfdata()[i+offset]); } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::set_values(const type *ptr, VMesh::size_type sz, VMesh::size_type offset) \
@@ -104,7 +104,7 @@ void VFDataT<FDATA,EFDATA,HFDATA>::set_all_values(const type &val) \
 } \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_weighted_value(type &val, const VMesh::index_type* idx, const VMesh::weight_type* w, VMesh::size_type sz ) const \
-{ typename FDATA::value_type tval = typename FDATA::value_type(0); for(size_type i=0; i<sz; i++) { TESTRANGE(idx[i],0,fdata_.size()) tval = tval + static_cast<typename FDATA::value_type>(w[i]*fdata_[idx[i]]); } val = CastFData<type>(tval); } \
+{ typename FDATA::value_type tval = typename FDATA::value_type(0); for(size_type i=0; i<sz; i++) { TESTRANGE(idx[i],0,fdata_.size()) tval = tval + static_cast<typename FDATA::value_type>(w[i]*cfdata()[idx[i]]); } val = CastFData<type>(tval); } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_weighted_evalue(type &val, const VMesh::index_type* idx, const VMesh::weight_type* w, VMesh::size_type sz ) const \
@@ -112,11 +112,11 @@ void VFDataT<FDATA,EFDATA,HFDATA>::get_weighted_evalue(type &val, const VMesh::i
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_values(type *ptr, VMesh::Node::array_type& nodes) const \
-{ for(size_t j=0; j<nodes.size(); j++) { TESTRANGE(nodes[j],0,fdata_.size()) ptr[j] = CastFData<type>(fdata_[nodes[j]]); } } \
+{ for(size_t j=0; j<nodes.size(); j++) { TESTRANGE(nodes[j],0,fdata_.size()) ptr[j] = CastFData<type>(cfdata()[nodes[j]]); } } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_values(type *ptr, VMesh::Elem::array_type& elems) const\
-{ for(size_t j=0; j<elems.size(); j++) { TESTRANGE(elems[j],0,fdata_.size()) ptr[j] = CastFData<type>(fdata_[elems[j]]); } } \
+{ for(size_t j=0; j<elems.size(); j++) { TESTRANGE(elems[j],0,fdata_.size()) ptr[j] = CastFData<type>(cfdata()[elems[j]]); } } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::set_values(const type *ptr, VMesh::Node::array_type& nodes) \
@@ -128,7 +128,7 @@ void VFDataT<FDATA,EFDATA,HFDATA>::set_values(const type *ptr, VMesh::Elem::arra
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::get_values(type *ptr, index_type* idx, size_type size) const\
-{ for(index_type j=0; j<size; j++) { TESTRANGE(idx[j],0,fdata_.size()) ptr[j] = CastFData<type>(fdata_[idx[j]]); } } \
+{ for(index_type j=0; j<size; j++) { TESTRANGE(idx[j],0,fdata_.size()) ptr[j] = CastFData<type>(cfdata()[idx[j]]); } } \
 \
 template<class FDATA, class EFDATA, class HFDATA> \
 void VFDataT<FDATA,EFDATA,HFDATA>::set_values(const type *ptr, index_type* idx, size_type size) \
@@ -224,6 +224,29 @@ private:
     fdata.resize(sz3,sz2,sz1);
   }
 
+  template<class T>
+  std::shared_ptr<void> share(const std::vector<T>&) const { return (std::shared_ptr<void>()); }
+
+  template<class T>
+  std::shared_ptr<void> share(const Array2<T>&) const { return (std::shared_ptr<void>()); }
+
+  template<class T>
+  std::shared_ptr<void> share(const Array3<T>& fdata) const { return (fdata.share()); }
+
+  template<class T>
+  bool adopt(std::vector<T>&, std::shared_ptr<void>) { return (false); }
+
+  template<class T>
+  bool adopt(Array2<T>&, std::shared_ptr<void>) { return (false); }
+
+  template<class T>
+  bool adopt(Array3<T>& fdata, std::shared_ptr<void> data)
+  {
+    if (!data) return (false);
+    fdata.adopt(std::static_pointer_cast<T>(data));
+    return (true);
+  }
+
 public:
   // constructor
   VFDataT(FDATA& fdata, EFDATA& efdata, HFDATA& hfdata) :
@@ -262,6 +285,16 @@ public:
       return (&(efdata_[0]));
     }
 
+  std::shared_ptr<void> share_fdata() const override
+  {
+    return (share(fdata_));
+  }
+
+  bool adopt_fdata(std::shared_ptr<void> data) override
+  {
+    return (adopt(fdata_,data));
+  }
+
   VFDATA_ACCESS_DECLARATION_O(char)
   VFDATA_ACCESS_DECLARATION_O(unsigned char)
   VFDATA_ACCESS_DECLARATION_O(short)
@@ -364,7 +397,7 @@ public:
         if (ei.elem_index >= 0)
         {
           TESTRANGE(ei.elem_index,0,fdata_.size())
-          val = CastFData<T>(fdata_[ei.elem_index]);
+          val = CastFData<T>(cfdata()[ei.elem_index]);
         }
         else
           val = defval;
@@ -378,7 +411,7 @@ public:
           for (size_t p=0;p<ei.node_index.size(); p++)
           {
             TESTRANGE(ei.node_index[p],0,fdata_.size())
-            val += CastFData<T>(fdata_[ei.node_index[p]]*ei.weights[p]);
+            val += CastFData<T>(cfdata()[ei.node_index[p]]*ei.weights[p]);
           }
         }
         else
@@ -396,7 +429,7 @@ public:
           for (size_t p=0;p<ei.node_index.size(); p++)
           {
             TESTRANGE(ei.node_index[p],0,fdata_.size())
-            val += CastFData<T>(fdata_[ei.node_index[p]]*ei.weights[k]); k++;
+            val += CastFData<T>(cfdata()[ei.node_index[p]]*ei.weights[k]); k++;
           }
           for (size_t p=0;p<ei.edge_index.size(); p++)
           {
@@ -419,7 +452,7 @@ public:
           for (size_t p=0;p<ei.node_index.size();p++)
           {
             TESTRANGE(ei.node_index[p],0,fdata_.size())
-            val += CastFData<T>(fdata_[ei.node_index[p]]*ei.weights[k]); k++;
+            val += CastFData<T>(cfdata()[ei.node_index[p]]*ei.weights[k]); k++;
             for (index_type q=0;q<ei.num_hderivs;q++)
             {
               TESTRANGE(ei.node_index[p],0,hfdata_.size())
@@ -450,7 +483,7 @@ public:
       {
         for (size_t j=0; j<ei.size(); j++)
           if (ei[j].elem_index >= 0)
-            vals[j] = CastFData<T>(fdata_[ei[j].elem_index]);
+            vals[j] = CastFData<T>(cfdata()[ei[j].elem_index]);
           else
             vals[j] = defval;
         return;
@@ -463,7 +496,7 @@ public:
           {
             vals[j] = static_cast<T>(0.0);
             for (size_t p=0;p<ei[j].node_index.size(); p++)
-              vals[j] += CastFData<T>(fdata_[ei[j].node_index[p]]*ei[j].weights[p]);
+              vals[j] += CastFData<T>(cfdata()[ei[j].node_index[p]]*ei[j].weights[p]);
           }
           else
           {
@@ -481,7 +514,7 @@ public:
             vals[j] = static_cast<T>(0.0);
             index_type k = 0;
             for (size_t p=0;p<ei[j].node_index.size(); p++)
-             { vals[j] += CastFData<T>(fdata_[ei[j].node_index[p]]*ei[j].weights[k]); k++; }
+             { vals[j] += CastFData<T>(cfdata()[ei[j].node_index[p]]*ei[j].weights[k]); k++; }
             for (size_t p=0;p<ei[j].edge_index.size(); p++)
              { vals[j] += CastFData<T>(efdata_[ei[j].edge_index[p]]*ei[j].weights[k]); k++; }
           }
@@ -502,7 +535,7 @@ public:
             vals[j] = static_cast<T>(0.0);
             for (size_t p=0;p<ei[j].node_index.size();p++)
             {
-              vals[j] += CastFData<T>(fdata_[ei[j].node_index[p]]*ei[j].weights[k]); k++;
+              vals[j] += CastFData<T>(cfdata()[ei[j].node_index[p]]*ei[j].weights[k]); k++;
               for (index_type q=0;q<ei[j].num_hderivs;q++)
                { vals[j] += CastFData<T>(hfdata_[ei[j].node_index[p]][q]*ei[j].weights[k]); k++; }
             }
@@ -556,7 +589,7 @@ public:
             {
               grad = T(0);
               for (size_t p=0;p<eg[j].node_index.size();p++)
-                { grad += CastFData<T>(fdata_[eg[j].node_index[p]]*eg[j].weights[q]); q++; }
+                { grad += CastFData<T>(cfdata()[eg[j].node_index[p]]*eg[j].weights[q]); q++; }
 
               vals[j][0] += CastFData<T>(grad*eg[j].inverse_jacobian[k]);
               vals[j][1] += CastFData<T>(grad*eg[j].inverse_jacobian[k+3]);
@@ -584,9 +617,9 @@ public:
             {
               grad = T(0);
               for (size_t p=0;p<eg[j].node_index.size();p++)
-               { grad += CastFData<T>(fdata_[eg[j].node_index[p]]*eg[j].weights[q]); q++; }
+               { grad += CastFData<T>(cfdata()[eg[j].node_index[p]]*eg[j].weights[q]); q++; }
               for (size_t p=0;p<eg[j].edge_index.size();p++)
-               { grad += CastFData<T>(fdata_[eg[j].edge_index[p]]*eg[j].weights[q]); q++; }
+               { grad += CastFData<T>(cfdata()[eg[j].edge_index[p]]*eg[j].weights[q]); q++; }
 
               vals[j][0] += CastFData<T>(grad*eg[j].inverse_jacobian[k]);
               vals[j][1] += CastFData<T>(grad*eg[j].inverse_jacobian[k+3]);
@@ -617,7 +650,7 @@ public:
 
               for (size_t p=0;p<eg[j].node_index.size();p++)
               {
-                grad += CastFData<T>(fdata_[eg[j].node_index[p]]*eg[j].weights[q]); q++;
+                grad += CastFData<T>(cfdata()[eg[j].node_index[p]]*eg[j].weights[q]); q++;
                 for (index_type r=1;r<eg[j].num_hderivs;r++)
                   { grad += CastFData<T>(hfdata_[eg[j].node_index[p]][r]*eg[j].weights[q]); q++; }
               }
@@ -669,7 +702,7 @@ public:
           {
             grad = T(0);
             for (size_t p=0;p<eg.node_index.size();p++)
-              { grad += CastFData<T>(fdata_[eg.node_index[p]]*eg.weights[q]); q++; }
+              { grad += CastFData<T>(cfdata()[eg.node_index[p]]*eg.weights[q]); q++; }
 
             val[0] += CastFData<T>(grad*eg.inverse_jacobian[k]);
             val[1] += CastFData<T>(grad*eg.inverse_jacobian[k+3]);
@@ -694,9 +727,9 @@ public:
           {
             grad = T(0);
             for (size_t p=0;p<eg.node_index.size();p++)
-             { grad += CastFData<T>(fdata_[eg.node_index[p]]*eg.weights[q]); q++; }
+             { grad += CastFData<T>(cfdata()[eg.node_index[p]]*eg.weights[q]); q++; }
             for (size_t p=0;p<eg.edge_index.size();p++)
-             { grad += CastFData<T>(fdata_[eg.edge_index[p]]*eg.weights[q]); q++; }
+             { grad += CastFData<T>(cfdata()[eg.edge_index[p]]*eg.weights[q]); q++; }
 
             val[0] += CastFData<T>(grad*eg.inverse_jacobian[k]);
             val[1] += CastFData<T>(grad*eg.inverse_jacobian[k+3]);
@@ -724,7 +757,7 @@ public:
 
             for (size_t p=0;p<eg.node_index.size();p++)
             {
-              grad += CastFData<T>(fdata_[eg.node_index[p]]*eg.weights[q]); q++;
+              grad += CastFData<T>(cfdata()[eg.node_index[p]]*eg.weights[q]); q++;
               for (index_type r=1;r<eg.num_hderivs;r++)
                 { grad += CastFData<T>(hfdata_[eg.node_index[p]][r]*eg.weights[q]); q++; }
             }
@@ -748,6 +781,9 @@ public:
   VMesh::size_type size() override { return (VMesh::size_type(fdata_.size())); }
 
 protected:
+  // Read access that does not make a shared Array3 buffer private
+  inline const FDATA& cfdata() const { return (fdata_); }
+
   FDATA& fdata_;
   EFDATA& efdata_;  // Additional data for lagrangian interpolation data
   HFDATA& hfdata_;  // Additional data for hermitian interpolation data
@@ -807,16 +843,16 @@ public:
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
     if (sz > 0)
-      tval = this->fdata_[0];
+      tval = this->cfdata()[0];
     else
       return (false);
 
     LessThan<typename FDATA::value_type> less;
     for (size_type p=1; p<sz; p++)
     {
-      if (less(this->fdata_[p], tval))
+      if (less(this->cfdata()[p], tval))
       {
-        tval = this->fdata_[p];
+        tval = this->cfdata()[p];
         idx = VMesh::index_type(p);
       }
     }
@@ -829,13 +865,13 @@ public:
     typename FDATA::value_type tval(0);
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) tval = this->fdata_[0]; else return (false);
+    if (sz > 0) tval = this->cfdata()[0]; else return (false);
     GreaterThan<typename FDATA::value_type> greater;
     for (size_type p = 1; p < sz; p++)
     {
-      if (greater(this->fdata_[p], tval))
+      if (greater(this->cfdata()[p], tval))
       {
-        tval = this->fdata_[p];
+        tval = this->cfdata()[p];
         idx = VMesh::index_type(p);
       }
     }
@@ -851,13 +887,13 @@ public:
     idxmin = 0;
     idxmax = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) { tval = this->fdata_[0]; tval2 = tval; } else return (false);
+    if (sz > 0) { tval = this->cfdata()[0]; tval2 = tval; } else return (false);
     LessThan<typename FDATA::value_type> less;
     GreaterThan<typename FDATA::value_type> greater;
     for (size_type p=1; p<sz; p++)
     {
-      if (less(this->fdata_[p], tval)) { tval = this->fdata_[p]; idxmin = VMesh::index_type(p); }
-      if (greater(this->fdata_[p], tval2)) { tval2 = this->fdata_[p]; idxmax = VMesh::index_type(p); }
+      if (less(this->cfdata()[p], tval)) { tval = this->cfdata()[p]; idxmin = VMesh::index_type(p); }
+      if (greater(this->cfdata()[p], tval2)) { tval2 = this->cfdata()[p]; idxmax = VMesh::index_type(p); }
     }
     min = CastFData<double>(tval);
     max = CastFData<double>(tval2);
@@ -881,11 +917,11 @@ public:
     double tval = 0;
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) tval = this->fdata_[0].length();
+    if (sz > 0) tval = this->cfdata()[0].length();
 
     for (size_type p=1; p<sz; p++)
     {
-      double len = this->fdata_[p].length();
+      double len = this->cfdata()[p].length();
       if (len < tval) { tval = len; idx = VMesh::index_type(p); }
     }
 
@@ -898,10 +934,10 @@ public:
     double tval = 0;
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) tval = this->fdata_[0].length();
+    if (sz > 0) tval = this->cfdata()[0].length();
     for (size_type p=1; p<sz; p++)
     {
-      double len = this->fdata_[p].length();
+      double len = this->cfdata()[p].length();
       if (len > tval) { tval = len; idx = VMesh::index_type(p); }
     }
 
@@ -917,11 +953,11 @@ public:
     idxmin = 0;
     idxmax = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) { tval = this->fdata_[0].length(); tval2 = tval; }
+    if (sz > 0) { tval = this->cfdata()[0].length(); tval2 = tval; }
     for (size_type p=1; p<sz; p++)
     {
-      if (this->fdata_[p].length() < tval) { tval = this->fdata_[p].length(); idxmin = VMesh::index_type(p); }
-      if (this->fdata_[p].length() > tval2) { tval2 = this->fdata_[p].length(); idxmax = VMesh::index_type(p); }
+      if (this->cfdata()[p].length() < tval) { tval = this->cfdata()[p].length(); idxmin = VMesh::index_type(p); }
+      if (this->cfdata()[p].length() > tval2) { tval2 = this->cfdata()[p].length(); idxmax = VMesh::index_type(p); }
     }
     min = CastFData<double>(tval);
     max = CastFData<double>(tval2);
@@ -946,11 +982,11 @@ public:
     double tval = 0;
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) tval = this->fdata_[0].norm();
+    if (sz > 0) tval = this->cfdata()[0].norm();
 
     for (size_type p=1; p<sz; p++)
     {
-      double len = this->fdata_[p].norm();
+      double len = this->cfdata()[p].norm();
       if (len < tval) { tval = len; idx = VMesh::index_type(p); }
     }
 
@@ -963,10 +999,10 @@ public:
     double tval = 0;
     idx = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) tval = this->fdata_[0].norm();
+    if (sz > 0) tval = this->cfdata()[0].norm();
     for (size_type p=1; p<sz; p++)
     {
-      double len = this->fdata_[p].norm();
+      double len = this->cfdata()[p].norm();
       if (len > tval) { tval = len; idx = VMesh::index_type(p); }
     }
 
@@ -981,11 +1017,11 @@ public:
     idxmin = 0;
     idxmax = 0;
     size_type sz = static_cast<size_type>(this->fdata_.size());
-    if (sz > 0) { tval = this->fdata_[0].norm(); tval2 = tval; }
+    if (sz > 0) { tval = this->cfdata()[0].norm(); tval2 = tval; }
     for (size_type p=1; p<sz; p++)
     {
-      if (this->fdata_[p].norm() < tval) { tval = this->fdata_[p].norm(); idxmin = VMesh::index_type(p); }
-      if (this->fdata_[p].norm() > tval2) { tval2 = this->fdata_[p].norm(); idxmax = VMesh::index_type(p); }
+      if (this->cfdata()[p].norm() < tval) { tval = this->cfdata()[p].norm(); idxmin = VMesh::index_type(p); }
+      if (this->cfdata()[p].norm() > tval2) { tval2 = this->cfdata()[p].norm(); idxmax = VMesh::index_type(p); }
     }
     min = CastFData<double>(tval);
     max = CastFData<double>(tval2);
@@ -603,6 +603,14 @@ public:
   inline void* fdata_pointer()   { return (vfdata_->fdata_pointer()); }
   inline void* efdata_pointer()   { return (vfdata_->efdata_pointer()); }
 
+  // Zero-copy exchange of the values with other data (e.g. a Nrrd). Only
+  // regular 3D meshes store their values in a shareable buffer; an empty
+  // handle or false means the caller has to copy. The type of the buffer
+  // has to match the data type of the field. Writing to a field whose values
+  // are shared makes a private copy first.
+  inline std::shared_ptr<void> share_values_buffer() const { return (vfdata_->share_fdata()); }
+  inline bool adopt_values_buffer(std::shared_ptr<void> data) { return (vfdata_->adopt_fdata(data)); }
+
   inline bool is_nodata()        { return (basis_order_ == -1); }
   inline bool is_constantdata()  { return (basis_order_ == 0); }
   inline bool is_lineardata()    { return (basis_order_ == 1); }
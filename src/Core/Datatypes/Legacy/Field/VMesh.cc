@@ -30,6 +30,8 @@
 
 #include <Core/Datatypes/Legacy/Field/Mesh.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/ElemBVH.h>
+#include <Core/Thread/Parallel.h>
 
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/GeometryPrimitives/BBox.h>
@@ -544,6 +546,54 @@ VMesh::mlocate(std::vector<Elem::index_type> &, const std::vector<Point> &) cons
   ASSERTFAIL("VMesh interface: mlocate(std::vector<Elem::index_type>,Point) has not been implemented");
 }
 
+void
+VMesh::mlocate(std::vector<Elem::index_type> &idx, std::vector<coords_type> &coords,
+               const std::vector<Point> &points) const
+{
+  idx.assign(points.size(), -1);
+  coords.resize(points.size());
+  if (points.empty() || num_elems() == 0) return;
+
+  // Regular grids locate in constant time, they do not need a hierarchy
+  if (is_regular_)
+  {
+    Core::Thread::Parallel::For(0, points.size(), [&](size_t begin, size_t end)
+    {
+      for (size_t j = begin; j < end; ++j)
+        if (!locate(idx[j], coords[j], points[j])) idx[j] = -1;
+    });
+    return;
+  }
+
+  const ElemBVH bvh(this, get_epsilon());
+  const std::vector<size_t> order = ElemBVH::spatial_order(points);
+
+  Core::Thread::Parallel::For(0, order.size(), [&](size_t begin, size_t end)
+  {
+    // Consecutive points in Morton order tend to fall in the same element
+    Elem::index_type last = -1;
+    coords_type c;
+    for (size_t n = begin; n < end; ++n)
+    {
+      const size_t j = order[n];
+      const Point& p = points[j];
+      if (last >= 0 && get_coords(c, p, last))
+      {
+        idx[j] = last;
+        coords[j] = c;
+        continue;
+      }
+      bvh.visit_containing(p, [&](Elem::index_type elem)
+      {
+        if (elem == last || !get_coords(c, p, elem)) return (false);
+        idx[j] = last = elem;
+        coords[j] = c;
+        return (true);
+      });
+    }
+  });
+}
+
 
 bool
 VMesh::find_closest_node(double&, Point&, VMesh::Node::index_type&, const Point &) const
@@ -587,6 +637,26 @@ VMesh::find_closest_elem(double&, Point&, VMesh::coords_type&,
   ASSERTFAIL("VMesh interface: find_closest_elem(dist,Point,coords,Elem::index_type,Point,maxdist) has not been implemented");
 }
 
+void
+VMesh::mfind_closest_elem(std::vector<double> &dist, std::vector<Point> &result,
+                          std::vector<coords_type> &coords, std::vector<Elem::index_type> &idx,
+                          const std::vector<Point> &points, double maxdist) const
+{
+  mlocate(idx, coords, points);
+  dist.assign(points.size(), 0.0);
+  result = points;
+
+  Core::Thread::Parallel::For(0, points.size(), [&](size_t begin, size_t end)
+  {
+    for (size_t j = begin; j < end; ++j)
+    {
+      if (idx[j] >= 0) continue;
+      if (!find_closest_elem(dist[j], result[j], coords[j], idx[j], points[j], maxdist))
+        idx[j] = -1;
+    }
+  });
+}
+
 bool
 VMesh::find_closest_elems(double&, Point&, VMesh::Elem::array_type&,
                           const Point&) const
@@ -242,7 +242,8 @@ public:
     num_edges_per_elem_(0),
     num_faces_per_elem_(0),
     num_nodes_per_face_(0),
-    num_edges_per_face_(0)
+    num_edges_per_face_(0),
+    generation_(0)
   {
     /// This call is only made in DEBUG mode, to keep a record of all the
     /// objects that are being allocated and freed.
@@ -584,6 +585,16 @@ public:
   virtual void mlocate(std::vector<Elem::index_type> &i,
                        const std::vector<Core::Geometry::Point> &point) const;
 
+  /// Batched element locate for large sets of points, such as all the nodes
+  /// of a destination mesh. It returns the element and local coordinates for
+  /// each point, or -1 if the point is outside the mesh. The points are
+  /// processed in parallel in Morton order against a bounding volume
+  /// hierarchy over the elements that is built for the call, so it only pays
+  /// off when the batch is large.
+  virtual void mlocate(std::vector<Elem::index_type> &i,
+                       std::vector<coords_type> &coords,
+                       const std::vector<Core::Geometry::Point> &point) const;
+
   /// Find elements that are inside or close to the bounding box. This function
   /// uses the underlying search structure to find candidates that are close.
   /// This functionality is general intended to speed up searching for elements
@@ -695,6 +706,17 @@ public:
   }
 
 
+  /// Batched version of find_closest_elem: points inside the mesh are found
+  /// with the batched mlocate (dist 0), the others through find_closest_elem,
+  /// in parallel. Points without an element within maxdist get index -1.
+  /// Requires synchronize(FIND_CLOSEST_ELEM_E).
+  virtual void mfind_closest_elem(std::vector<double> &dist,
+                                  std::vector<Core::Geometry::Point> &result,
+                                  std::vector<coords_type> &coords,
+                                  std::vector<Elem::index_type> &i,
+                                  const std::vector<Core::Geometry::Point> &point,
+                                  double maxdist) const;
+
   /// @todo: Need to reformulate this one, closest element can have multiple
   // intersection points
   virtual bool find_closest_elems(double& dist,
@@ -96,9 +96,9 @@ public:
 
     element_size_ = basis_->domain_size();
 
-#ifdef SCIRUN4_CODE_TO_BE_ENABLED_LATER
-    generation_ = mesh_->generation;
-#endif
+    /// Meshes are not modified once they leave a module, so the unique id of
+    /// the mesh object serves as its generation.
+    generation_ = mesh_->id();
 
     unit_vertices_.resize(num_nodes_per_elem_);
     for (size_t k=0; k < num_nodes_per_elem_; k++)
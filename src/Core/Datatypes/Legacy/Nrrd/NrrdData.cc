@@ -89,7 +89,6 @@ NrrdData::NrrdData() :
   nrrd_(nrrdNew()),
   write_nrrd_(true),
   embed_object_(false)
-  //data_owner_(0)
 {
   DEBUG_CONSTRUCTOR("NrrdData")
 }
@@ -99,26 +98,13 @@ NrrdData::NrrdData(Nrrd *n) :
   nrrd_(n),
   write_nrrd_(true),
   embed_object_(false)
-  //data_owner_(0)
 {
   DEBUG_CONSTRUCTOR("NrrdData")
 }
 
-/*
-NrrdData::NrrdData(LockingHandle<Datatype> data_owner) :
-  nrrd_(nrrdNew()),
-  write_nrrd_(true),
-  embed_object_(false),
-  data_owner_(data_owner)
-{
-  DEBUG_CONSTRUCTOR("NrrdData")
-}
-*/
-
 NrrdData::NrrdData(const NrrdData &copy) :
   Datatype(copy),
   nrrd_(nrrdNew()),
-  //data_owner_(0),
   nrrd_fname_(copy.nrrd_fname_)
 {
   DEBUG_CONSTRUCTOR("NrrdData")
@@ -129,16 +115,43 @@ NrrdData::NrrdData(const NrrdData &copy) :
 NrrdData::~NrrdData()
 {
   DEBUG_DESTRUCTOR("NrrdData")
+  release_nrrd();
+}
 
-//  if(!data_owner_)
-//  {
+
+void
+NrrdData::release_nrrd()
+{
+  if (data_owner_)
+  {
+    nrrdNix(nrrd_);
+    data_owner_.reset();
+  }
+  else
+  {
     nrrdNuke(nrrd_);
-//  }
-//  else
-//  {
-//    nrrdNix(nrrd_);
-//    data_owner_ = 0;
-//  }
+  }
+}
+
+
+bool
+NrrdData::wrap(std::shared_ptr<void> data, int type, unsigned int dim, const size_t* size)
+{
+  if (!data) return false;
+
+  if (data_owner_) nrrd_->data = nullptr;
+  nrrdEmpty(nrrd_);
+  data_owner_ = data;
+
+  if (nrrdWrap_nva(nrrd_, data.get(), type, dim, size))
+  {
+    char *err = biffGetDone(NRRD);
+    free(err);
+    nrrd_->data = nullptr;
+    data_owner_.reset();
+    return false;
+  }
+  return true;
 }
 
 
@@ -201,15 +214,7 @@ void NrrdData::io(Piostream& stream)
       // memory.
       if (nrrd_)
       {   // make sure we free any existing Nrrd Data set
-        //if (!data_owner_.get_rep())
-        //{
-          nrrdNuke(nrrd_);
-        //}
-        //else
-        //{
-        //  nrrdNix(nrrd_);
-        //  data_owner_ = 0;
-        //}
+        release_nrrd();
         // Make sure we put a zero pointer in the field. There is no nrrd
         nrrd_ = nrrdNew();
       }
@@ -257,15 +262,7 @@ void NrrdData::io(Piostream& stream)
 
       if (nrrd_)
       {   // make sure we free any existing Nrrd Data set
-        //if(!data_owner_.get_rep())
-        //{
-          nrrdNuke(nrrd_);
-        //}
-        //else
-        //{
-        //  nrrdNix(nrrd_);
-        //  data_owner_ = 0;
-        //}
+        release_nrrd();
       }
 
       // Create a new nrrd structure
@@ -303,7 +300,6 @@ void NrrdData::io(Piostream& stream)
         free(err);
         biffDone(NRRD);
       }
-      //data_owner_ = 0;
 
       stream.begin_cheap_delim();
       // Read the contents of the axis
@@ -44,6 +44,7 @@
 #include <Core/GeometryPrimitives/GeomFwd.h>
 #include <Core/Datatypes/PropertyManagerExtensions.h>
 #include <teem/nrrd.h>
+#include <memory>
 #include <Core/Datatypes/Legacy/Nrrd/share.h>
 
 namespace SCIRun {
@@ -69,6 +70,13 @@ public:
   Nrrd*& getNrrd() { return nrrd_; }
   const Nrrd* getNrrd() const { return nrrd_; }
 
+  // Make the nrrd a view on values owned by other data, e.g. the storage of
+  // a LatVol field, instead of copying them. The handle keeps the values
+  // alive and they are not freed with the nrrd; clone() still copies them.
+  // Returns false, leaving the nrrd untouched, if data is empty.
+  bool wrap(std::shared_ptr<void> data, int type, unsigned int dim, const size_t* size);
+  bool owns_data() const { return !data_owner_; }
+
    void set_filename( const std::string &f )
    { nrrd_fname_ = f; embed_object_ = false; }
    const std::string get_filename() const { return nrrd_fname_; }
@@ -86,7 +94,11 @@ private:
   bool    write_nrrd_;
   bool    embed_object_;
 
+  // Set when nrrd_->data belongs to other data
+  std::shared_ptr<void> data_owner_;
+
   bool in_name_set(const std::string &s) const;
+  void release_nrrd();
 
   // To help with pio
   std::string nrrd_fname_;
@@ -254,7 +254,7 @@ namespace Datatypes {
     if (!split)
     {
       size_t block_size = this->rows() * this->cols();
-      if (!stream.block_io(this->data(), sizeof(T), block_size))
+      if (!Pio_block(stream, this->data(), block_size))
       {
         for (size_t i = 0; i < block_size; i++)
         {
@@ -346,7 +346,7 @@ namespace Datatypes {
       }
     }
 
-    if (!stream.block_io(this->data(), sizeof(T), this->nrows()))
+    if (!Pio_block(stream, this->data(), this->nrows()))
     {
       for (size_t i=0; i<this->nrows(); i++)
         stream.io(this->data()[i]);
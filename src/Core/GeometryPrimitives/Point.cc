@@ -26,7 +26,7 @@
 */
 
 
-#include <Core/Persistent/Persistent.h>
+#include <Core/Persistent/PersistentSTL.h>
 #include <Core/GeometryPrimitives/Point.h>
 #include <iostream>
 #include <sstream>
@@ -168,6 +168,13 @@ SCIRun::Core::Geometry::Pio(Piostream& stream, Point& p)
   stream.end_cheap_delim();
 }
 
+template <>
+void
+SCIRun::Pio(Piostream& stream, std::vector<Point>& data)
+{
+  Pio_records<Point, double, 3>(stream, data);
+}
+
 
 const std::string&
 SCIRun::Point_get_h_file_path()
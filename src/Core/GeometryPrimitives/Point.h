@@ -222,6 +222,10 @@ inline Point Max(const Point& p1, const Point& p2)
 
 }}
 
+template <class T> void Pio(Piostream&, std::vector<T>&);
+/// Points are stored as one block of doubles on binary streams.
+template <> SCISHARE void Pio(Piostream&, std::vector<Core::Geometry::Point>&);
+
 /// @todo: This one is obsolete when last part dynamic compilation is gone
 SCISHARE const std::string& Point_get_h_file_path();
 SCISHARE const SCIRun::TypeDescription* get_type_description(Core::Geometry::Point*);
@@ -35,8 +35,12 @@
 #include <Core/GeometryPrimitives/BBox.h>
 #include <Core/GeometryPrimitives/Transform.h>
 #include <Core/Datatypes/Legacy/Base/Types.h>
+#include <Core/Thread/Parallel.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <Core/GeometryPrimitives/share.h>
@@ -61,7 +65,8 @@ class SearchGridT
 
         transform_.pre_translate(Core::Geometry::Vector(min));
         transform_.compute_imat();
-        bin_.resize(x*y*z);
+        offsets_.assign(x*y*z + 1, 0);
+        size_ = 0;
       }
 
     inline void transform(const Core::Geometry::Transform &t)
@@ -137,20 +142,50 @@ class SearchGridT
       k = static_cast<index_type>(r.z());
     }
 
-    void insert(INDEX val, const Core::Geometry::BBox &bbox)
+    /// The bins are stored compressed: the values of bin q are
+    /// values_[offsets_[q]] .. values_[offsets_[q+1]-1]. Filling a whole grid
+    /// through build_from_boxes or build_from_points is done in parallel with
+    /// a counting pass and a scatter pass. insert and remove do not touch the
+    /// compressed arrays: a bin they change is copied to edited_ and served
+    /// from there until the next bulk build replaces the grid, so an update
+    /// costs the size of the bins it changes rather than the size of the grid.
+
+    /// Replaces the contents of the grid with value(0) .. value(count-1),
+    /// where value(n) covers the bins overlapped by bbox(n). Every bin lists
+    /// its values in order of n, as if they had been inserted one by one.
+    template <class ValueFunction, class BoxFunction>
+    void build_from_boxes(size_type count, ValueFunction value, BoxFunction bbox)
     {
-      index_type mini=0, minj=0, mink=0, maxi=0, maxj=0, maxk=0;
+      build(count, value, [this, &bbox](size_t n, index_type range[6])
+      {
+        bin_range(bbox(n), range);
+      });
+    }
 
-      locate(mini, minj, mink, bbox.get_min());
-      locate(maxi, maxj, maxk, bbox.get_max());
+    /// Replaces the contents of the grid with value(0) .. value(count-1),
+    /// where value(n) is stored in the bin containing point(n).
+    template <class ValueFunction, class PointFunction>
+    void build_from_points(size_type count, ValueFunction value, PointFunction point)
+    {
+      build(count, value, [this, &point](size_t n, index_type range[6])
+      {
+        unsafe_locate(range[0], range[1], range[2], point(n));
+        range[3] = range[0]; range[4] = range[1]; range[5] = range[2];
+      });
+    }
 
-      for (index_type i = mini; i <= maxi; i++)
+    void insert(INDEX val, const Core::Geometry::BBox &bbox)
+    {
+      index_type range[6];
+      bin_range(bbox, range);
+
+      for (index_type i = range[0]; i <= range[3]; i++)
       {
-        for (index_type j = minj; j <= maxj; j++)
+        for (index_type j = range[1]; j <= range[4]; j++)
         {
-          for (index_type k = mink; k <= maxk; k++)
+          for (index_type k = range[2]; k <= range[5]; k++)
           {
-            bin_[linearize(i, j, k)].push_back(val);
+            insert_into_bin(linearize(i, j, k), val);
           }
         }
       }
@@ -169,8 +204,7 @@ class SearchGridT
         {
           for (index_type k = mink; k <= maxk; k++)
           {
-            index_type q = linearize(i, j, k);
-            std::remove(bin_[q].begin(),bin_[q].end(),val);
+            remove_from_bin(linearize(i, j, k), val);
           }
         }
       }
@@ -180,15 +214,14 @@ class SearchGridT
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      bin_[linearize(i, j, k)].push_back(val);
+      insert_into_bin(linearize(i, j, k), val);
     }
 
     void remove(INDEX val, const Core::Geometry::Point &point)
     {
       index_type i, j, k;
       unsafe_locate(i, j, k, point);
-      index_type q = linearize(i, j, k);
-      std::remove(bin_[q].begin(),bin_[q].end(),val);
+      remove_from_bin(linearize(i, j, k), val);
     }
 
     inline bool lookup(iterator &begin, iterator &end, const Core::Geometry::Point &p)
@@ -196,9 +229,7 @@ class SearchGridT
       index_type i, j, k;
       if (locate(i, j, k, p))
       {
-        index_type q = linearize(i, j, k);
-        begin = bin_[q].begin();
-        end   = bin_[q].end();
+        lookup_bin(begin, end, linearize(i, j, k));
         return (true);
       }
       return (false);
@@ -207,11 +238,44 @@ class SearchGridT
     inline void lookup_ijk(iterator &begin, iterator &end, size_type i, size_type j,
                     size_type k)
     {
-      index_type q = linearize(i, j, k);
-      begin = bin_[q].begin();
-      end   = bin_[q].end();
+      lookup_bin(begin, end, linearize(i, j, k));
     }
 
+    /// Values stored in bin q, as numbered by locate_bins
+    inline void lookup_bin(iterator &begin, iterator &end, index_type q)
+    {
+      if (!edited_.empty())
+      {
+        auto it = edited_.find(q);
+        if (it != edited_.end())
+        {
+          begin = it->second.begin();
+          end   = it->second.end();
+          return;
+        }
+      }
+      begin = values_.begin() + offsets_[q];
+      end   = values_.begin() + offsets_[q+1];
+    }
+
+    /// Bulk version of lookup: bins[n] is the bin containing points[n], or
+    /// -1 if the point is outside the grid. Pass the result to lookup_bin.
+    void locate_bins(const std::vector<Core::Geometry::Point>& points,
+                     std::vector<index_type>& bins) const
+    {
+      bins.resize(points.size());
+      Core::Thread::Parallel::For(0, points.size(), [&](size_t begin, size_t end)
+      {
+        for (size_t n = begin; n < end; ++n)
+        {
+          index_type i, j, k;
+          bins[n] = locate(i, j, k, points[n]) ? linearize(i, j, k) : -1;
+        }
+      });
+    }
+
+    /// Total number of values over all bins
+    inline size_type size() const { return size_; }
 
     double min_distance_squared(const Core::Geometry::Point &p, size_type i,
                               size_type j, size_type k) const
@@ -241,6 +305,97 @@ class SearchGridT
     index_type linearize(index_type i, index_type j, index_type k) const
       { return (((i * nj_) + j) * nk_ + k); }
 
+    /// Bins overlapped by a box, as mini, minj, mink, maxi, maxj, maxk
+    void bin_range(const Core::Geometry::BBox &bbox, index_type range[6]) const
+    {
+      std::fill(range, range + 6, 0);
+      locate(range[0], range[1], range[2], bbox.get_min());
+      locate(range[3], range[4], range[5], bbox.get_max());
+    }
+
+    /// Copy of bin q that insert and remove may change
+    std::vector<INDEX>& edit_bin(index_type q)
+    {
+      auto it = edited_.find(q);
+      if (it == edited_.end())
+        it = edited_.emplace(q, std::vector<INDEX>(values_.begin() + offsets_[q],
+                                                   values_.begin() + offsets_[q+1])).first;
+      return it->second;
+    }
+
+    void insert_into_bin(index_type q, INDEX val)
+    {
+      edit_bin(q).push_back(val);
+      size_++;
+    }
+
+    void remove_from_bin(index_type q, INDEX val)
+    {
+      iterator begin, end;
+      lookup_bin(begin, end, q);
+      if (std::find(begin, end, val) == end) return;
+
+      auto& bin = edit_bin(q);
+      auto last = std::remove(bin.begin(), bin.end(), val);
+      size_ -= static_cast<size_type>(bin.end() - last);
+      bin.erase(last, bin.end());
+    }
+
+    /// Two pass construction: count the entries per bin, turn the counts
+    /// into offsets, then scatter. Both passes run in parallel; the bins are
+    /// sorted afterwards so the result does not depend on the scheduling.
+    template <class ValueFunction, class RangeFunction>
+    void build(size_type count, ValueFunction value, RangeFunction binsOf)
+    {
+      const size_t numBins = offsets_.size() - 1;
+      std::unique_ptr<std::atomic<index_type>[]> cursor(new std::atomic<index_type>[numBins]);
+      for (size_t q = 0; q < numBins; q++)
+        cursor[q].store(0, std::memory_order_relaxed);
+
+      auto forEachBin = [&](auto visit)
+      {
+        Core::Thread::Parallel::For(0, count, [&](size_t begin, size_t end)
+        {
+          index_type range[6];
+          for (size_t n = begin; n < end; ++n)
+          {
+            binsOf(n, range);
+            for (index_type i = range[0]; i <= range[3]; i++)
+              for (index_type j = range[1]; j <= range[4]; j++)
+                for (index_type k = range[2]; k <= range[5]; k++)
+                  visit(linearize(i, j, k), n);
+          }
+        });
+      };
+
+      forEachBin([&](index_type q, size_t) { cursor[q].fetch_add(1, std::memory_order_relaxed); });
+
+      offsets_[0] = 0;
+      for (size_t q = 0; q < numBins; q++)
+      {
+        offsets_[q+1] = offsets_[q] + cursor[q].load(std::memory_order_relaxed);
+        cursor[q].store(offsets_[q], std::memory_order_relaxed);
+      }
+
+      std::vector<size_t> order(offsets_[numBins]);
+      forEachBin([&](index_type q, size_t n)
+        { order[cursor[q].fetch_add(1, std::memory_order_relaxed)] = n; });
+
+      values_.clear();
+      edited_.clear();
+      size_ = static_cast<size_type>(order.size());
+      if (!order.empty())
+        values_.resize(order.size(), value(order[0]));
+      Core::Thread::Parallel::For(0, numBins, [&](size_t begin, size_t end)
+      {
+        for (size_t q = begin; q < end; ++q)
+        {
+          std::sort(order.begin() + offsets_[q], order.begin() + offsets_[q+1]);
+          for (auto e = offsets_[q]; e < offsets_[q+1]; ++e)
+            values_[e] = value(order[e]);
+        }
+      });
+    }
 
   private:
     /// Size of the search grid
@@ -249,7 +404,11 @@ class SearchGridT
     Core::Geometry::Transform transform_;
 
     /// Where to store the lookup table
-    std::vector<std::vector<INDEX> > bin_;
+    std::vector<index_type> offsets_;
+    std::vector<INDEX> values_;
+    /// Bins changed since the last bulk build
+    std::unordered_map<index_type, std::vector<INDEX>> edited_;
+    size_type size_;
 };
 
 
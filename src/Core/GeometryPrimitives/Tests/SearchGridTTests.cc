@@ -0,0 +1,174 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+
+#include <Core/GeometryPrimitives/SearchGridT.h>
+#include <random>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Geometry;
+
+namespace
+{
+  std::vector<Point> randomPoints(size_t n)
+  {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> coord(0.0, 1.0);
+    std::vector<Point> points(n);
+    for (auto& p : points)
+      p = Point(coord(gen), coord(gen), coord(gen));
+    return points;
+  }
+
+  BBox boxAround(const Point& p)
+  {
+    BBox box;
+    box.extend(p);
+    box.extend(0.08);
+    return box;
+  }
+
+  std::vector<index_type> contents(SearchGridT<index_type>& grid, index_type i, index_type j, index_type k)
+  {
+    SearchGridT<index_type>::iterator it, eit;
+    grid.lookup_ijk(it, eit, i, j, k);
+    return std::vector<index_type>(it, eit);
+  }
+
+  void expectSameBins(SearchGridT<index_type>& a, SearchGridT<index_type>& b)
+  {
+    EXPECT_EQ(a.size(), b.size());
+    for (index_type i = 0; i < a.get_ni(); ++i)
+      for (index_type j = 0; j < a.get_nj(); ++j)
+        for (index_type k = 0; k < a.get_nk(); ++k)
+          EXPECT_EQ(contents(a, i, j, k), contents(b, i, j, k));
+  }
+
+  auto identity = [](size_t n) { return static_cast<index_type>(n); };
+}
+
+TEST(SearchGridTTests, BulkBuildMatchesInsertingOneByOne)
+{
+  const auto points = randomPoints(2000);
+  const Point min(-0.1, -0.1, -0.1), max(1.1, 1.1, 1.1);
+
+  SearchGridT<index_type> nodesBuilt(6, 5, 4, min, max), nodesInserted(6, 5, 4, min, max);
+  nodesBuilt.build_from_points(points.size(), identity, [&](size_t n) { return points[n]; });
+  for (size_t n = 0; n < points.size(); ++n)
+    nodesInserted.insert(n, points[n]);
+  EXPECT_EQ(points.size(), nodesBuilt.size());
+  expectSameBins(nodesBuilt, nodesInserted);
+
+  SearchGridT<index_type> boxesBuilt(6, 5, 4, min, max), boxesInserted(6, 5, 4, min, max);
+  boxesBuilt.build_from_boxes(points.size(), identity, [&](size_t n) { return boxAround(points[n]); });
+  for (size_t n = 0; n < points.size(); ++n)
+    boxesInserted.insert(n, boxAround(points[n]));
+  EXPECT_LT(points.size(), boxesBuilt.size());
+  expectSameBins(boxesBuilt, boxesInserted);
+}
+
+TEST(SearchGridTTests, InsertAndRemoveEditBuiltGrid)
+{
+  const auto points = randomPoints(500);
+  SearchGridT<index_type> grid(4, 4, 4, Point(0, 0, 0), Point(1, 1, 1));
+  grid.build_from_points(points.size(), identity, [&](size_t n) { return points[n]; });
+
+  const Point extra(0.6, 0.3, 0.9);
+  grid.insert(1000, extra);
+  SearchGridT<index_type>::iterator it, eit;
+  ASSERT_TRUE(grid.lookup(it, eit, extra));
+  EXPECT_EQ(1000, *(eit - 1));
+  EXPECT_EQ(points.size() + 1, grid.size());
+
+  for (size_t n = 0; n < points.size(); n += 2)
+    grid.remove(n, points[n]);
+  grid.remove(1000, extra);
+  EXPECT_EQ(points.size() / 2, grid.size());
+
+  for (size_t n = 0; n < points.size(); ++n)
+  {
+    ASSERT_TRUE(grid.lookup(it, eit, points[n]));
+    EXPECT_EQ(n % 2 == 1, std::find(it, eit, static_cast<index_type>(n)) != eit) << n;
+  }
+}
+
+TEST(SearchGridTTests, LocateBinsMatchesLookup)
+{
+  auto points = randomPoints(300);
+  points.push_back(Point(2, 0, 0));
+  SearchGridT<index_type> grid(3, 3, 3, Point(0, 0, 0), Point(1, 1, 1));
+  grid.build_from_points(points.size() - 1, identity, [&](size_t n) { return points[n]; });
+
+  std::vector<index_type> bins;
+  grid.locate_bins(points, bins);
+  ASSERT_EQ(points.size(), bins.size());
+  EXPECT_EQ(-1, bins.back());
+  for (size_t n = 0; n + 1 < points.size(); ++n)
+  {
+    SearchGridT<index_type>::iterator it, eit, bit, beit;
+    ASSERT_TRUE(grid.lookup(it, eit, points[n]));
+    grid.lookup_bin(bit, beit, bins[n]);
+    EXPECT_EQ(it, bit);
+    EXPECT_EQ(eit, beit);
+    EXPECT_NE(eit, std::find(it, eit, static_cast<index_type>(n)));
+  }
+}
+
+TEST(SearchGridTTests, EditedGridMatchesBulkBuildUntilReplaced)
+{
+  const auto points = randomPoints(800);
+  const Point min(0, 0, 0), max(1, 1, 1);
+  auto point = [&](size_t n) { return points[n]; };
+
+  SearchGridT<index_type> edited(5, 5, 5, min, max);
+  edited.build_from_points(400, identity, point);
+  for (size_t n = 1; n < 400; n += 2)
+    edited.remove(n, points[n]);
+  for (size_t n = 400; n < points.size(); ++n)
+    edited.insert(n, points[n]);
+  const auto size = edited.size();
+  edited.remove(5000, points[0]);
+  EXPECT_EQ(size, edited.size());
+
+  std::vector<index_type> kept;
+  for (size_t n = 0; n < points.size(); ++n)
+    if (n >= 400 || n % 2 == 0)
+      kept.push_back(static_cast<index_type>(n));
+  SearchGridT<index_type> built(5, 5, 5, min, max);
+  built.build_from_points(kept.size(), [&](size_t k) { return kept[k]; },
+    [&](size_t k) { return points[kept[k]]; });
+  expectSameBins(built, edited);
+
+  // A bulk build replaces the edited bins along with the rest of the grid
+  edited.build_from_points(100, identity, point);
+  SearchGridT<index_type> fresh(5, 5, 5, min, max);
+  fresh.build_from_points(100, identity, point);
+  expectSameBins(fresh, edited);
+}
@@ -31,7 +31,7 @@
 ///////////////////////////
 
 #include <Core/GeometryPrimitives/Vector.h>
-#include <Core/Persistent/Persistent.h>
+#include <Core/Persistent/PersistentSTL.h>
 
 #include <iostream>
 #include <sstream>
@@ -177,6 +177,13 @@ SCIRun::Core::Geometry::Pio(Piostream& stream, Vector& p)
   stream.end_cheap_delim();
 }
 
+template <>
+void
+SCIRun::Pio(Piostream& stream, std::vector<Vector>& data)
+{
+  Pio_records<Vector, double, 3>(stream, data);
+}
+
 
 const std::string&
 SCIRun::Vector_get_h_file_path()
@@ -37,6 +37,7 @@
 
 #include <cmath>
 #include <algorithm>
+#include <vector>
 #include <Core/Persistent/PersistentFwd.h>
 #include <Core/Utils/Legacy/TypeDescription.h>
 #include <Core/GeometryPrimitives/share.h>
@@ -484,6 +485,11 @@ inline void Vector::Set(double x, double y, double z)
 SCISHARE const TypeDescription* get_type_description(Vector*);
 
 }}
+
+template <class T> void Pio(Piostream&, std::vector<T>&);
+/// Vectors are stored as one block of doubles on binary streams.
+template <> SCISHARE void Pio(Piostream&, std::vector<Core::Geometry::Vector>&);
+
 /// @todo: This one is obsolete when dynamic compilation will be abandoned
 const std::string& Vector_get_h_file_path();
 }
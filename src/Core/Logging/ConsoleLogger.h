@@ -31,6 +31,7 @@
 #ifndef CORE_LOGGING_CONSOLELOGGER_H
 #define CORE_LOGGING_CONSOLELOGGER_H
 
+#include <atomic>
 #include <Core/Logging/LoggerInterface.h>
 #include <Core/Logging/share.h>
 
@@ -49,8 +50,9 @@ namespace SCIRun
         void status(const std::string& msg) const override;
         bool errorReported() const override { return errorReported_; }
         void setErrorFlag(bool flag) override { errorReported_ = flag; }
+        bool takeErrorFlag() override { return errorReported_.exchange(false); }
       private:
-        mutable bool errorReported_{ false };
+        mutable std::atomic<bool> errorReported_{ false };
       };
 
       class SCISHARE NullLogger : public LegacyLoggerInterface
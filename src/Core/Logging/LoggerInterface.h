@@ -49,6 +49,9 @@ namespace SCIRun
         virtual void error(const std::string& msg) const = 0;
         virtual bool errorReported() const = 0;
         virtual void setErrorFlag(bool flag) = 0;
+        // Clears the error flag and returns whether it was set; loggers that
+        // can be shared between threads do this in one atomic step
+        virtual bool takeErrorFlag() { auto flag = errorReported(); setErrorFlag(false); return flag; }
         virtual void warning(const std::string& msg) const = 0;
         virtual void remark(const std::string& msg) const = 0;
         virtual void status(const std::string& msg) const = 0;
@@ -0,0 +1,104 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Matlab/matfiledata.h>
+#include <cstdint>
+
+using namespace SCIRun::MatlabIO;
+
+namespace
+{
+  const int64_t twoGB = static_cast<int64_t>(1) << 31;
+}
+
+// The buffers below are allocated but only touched at a few places, so the
+// operating system does not need to back them with memory.
+
+TEST(MatFileDataTests, ByteSizeAboveTwoGigabytes)
+{
+  matfiledata mfd;
+  mfd.newdatabuffer(twoGB + 16, matfilebase::miDOUBLE);
+
+  EXPECT_EQ(twoGB + 16, mfd.bytesize());
+  EXPECT_EQ(twoGB/8 + 2, mfd.size());
+
+  mfd.putandcastvalue<double>(1.5, twoGB/8 + 1);
+  EXPECT_EQ(1.5, mfd.getandcastvalue<double>(twoGB/8 + 1));
+  EXPECT_THROW(mfd.getandcastvalue<double>(twoGB/8 + 2), matfilebase::out_of_range);
+}
+
+TEST(MatFileDataTests, ElementCountAboveTwoGigabytes)
+{
+  matfiledata mfd;
+  mfd.newdatabuffer(twoGB + 16, matfilebase::miUINT8);
+
+  EXPECT_EQ(twoGB + 16, mfd.size());
+
+  mfd.putandcastvalue<int>(200, twoGB + 8);
+  EXPECT_EQ(200, mfd.getandcastvalue<int>(twoGB + 8));
+  EXPECT_EQ(200.0, mfd.getandcastvalue<double>(twoGB + 8));
+  EXPECT_THROW(mfd.getandcastvalue<int>(twoGB + 16), matfilebase::out_of_range);
+}
+
+TEST(MatFileDataTests, GetAndCastLimitsDimensionsWhoseProductOverflowsInt)
+{
+  matfiledata mfd;
+  std::vector<int> data = { 1, 2, 3, 4 };
+  mfd.putandcastvector(data, matfilebase::miINT32);
+
+  // 65536*65536 and 2048*2048*1024 do not fit in an int, the copy must still
+  // be limited to the four elements in the buffer
+  std::vector<double> out(4, 0.0);
+  double* rows[1] = { &out[0] };
+  mfd.getandcast<double>(rows, 65536, 65536);
+  EXPECT_EQ(std::vector<double>({ 1, 2, 3, 4 }), out);
+
+  std::vector<float> out3(4, 0.0f);
+  float* rows3[1] = { &out3[0] };
+  float** slices[1] = { rows3 };
+  mfd.getandcast<float>(slices, 2048, 2048, 1024);
+  EXPECT_EQ(std::vector<float>({ 1, 2, 3, 4 }), out3);
+}
+
+TEST(MatFileDataTests, GetAndCastCopiesTheRequestedElementCount)
+{
+  matfiledata mfd;
+  std::vector<short> data = { -1, 2, -3, 4, -5 };
+  mfd.putandcastvector(data, matfilebase::miINT16);
+  EXPECT_EQ(5, mfd.size());
+  EXPECT_EQ(10, mfd.bytesize());
+
+  std::vector<double> out(8, 0.0);
+  mfd.getandcast<double>(&out[0], static_cast<int64_t>(out.size()));
+  EXPECT_EQ(std::vector<double>({ -1, 2, -3, 4, -5, 0, 0, 0 }), out);
+
+  std::vector<double> vec;
+  mfd.getandcastvector(vec);
+  EXPECT_EQ(std::vector<double>({ -1, 2, -3, 4, -5 }), vec);
+}
@@ -0,0 +1,290 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <Core/Matlab/matlabfile.h>
+#include <Core/Matlab/matlabarray.h>
+#include <boost/filesystem.hpp>
+#include <zlib.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+using namespace SCIRun::MatlabIO;
+
+namespace
+{
+  const std::string dataDir = MATLAB_TEST_DATA_DIR;
+
+  std::string tempFile(const std::string& name)
+  {
+    return (boost::filesystem::temp_directory_path() / name).string();
+  }
+
+  std::vector<double> values(const matlabarray& ma)
+  {
+    std::vector<double> v;
+    ma.getnumericarray(v);
+    return v;
+  }
+
+  // Writes variables A (3x4 double), big (20000 int32 values) and s (string)
+  // as an uncompressed v5 file.
+  void writeUncompressed(const std::string& filename)
+  {
+    matlabfile mf(filename, "w");
+
+    std::vector<double> A(12);
+    for (int j = 0; j < 4; j++) for (int i = 0; i < 3; i++) A[i + 3*j] = i + 10*j;
+    matlabarray a;
+    a.createdoublematrix(A, std::vector<int>{3, 4});
+    mf.putmatlabarray(a, "A");
+
+    std::vector<int> big(20000);
+    for (int k = 0; k < 20000; k++) big[k] = 7*k - 3;
+    matlabarray b;
+    b.createintvector(big);
+    mf.putmatlabarray(b, "big");
+
+    matlabarray s;
+    s.createstringarray("hello");
+    mf.putmatlabarray(s, "s");
+
+    mf.close();
+  }
+
+  // Rewrites every top level element of an uncompressed v5 file as an
+  // miCOMPRESSED block, which is what MATLAB writes with -v7. The first
+  // kilobyte of each element is flushed into its own part of the deflate
+  // stream. For the element at index damaged the deflate block following
+  // that part gets an invalid block type, so the element can be indexed but
+  // not read.
+  void compress(const std::string& in, const std::string& out, int damaged = -1)
+  {
+    std::ifstream is(in, std::ios::binary);
+    std::vector<char> file((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+
+    std::vector<char> result(file.begin(), file.begin() + 128);
+    size_t pos = 128;
+    for (int index = 0; pos < file.size(); index++)
+    {
+      int32_t tag[2];
+      std::memcpy(tag, &file[pos], 8);
+      uLong elemsize = 8 + static_cast<uLong>(tag[1]);
+      Bytef* elem = reinterpret_cast<Bytef*>(&file[pos]);
+
+      z_stream strm;
+      std::memset(&strm, 0, sizeof(z_stream));
+      ASSERT_EQ(Z_OK, deflateInit(&strm, 6));
+      std::vector<Bytef> block(deflateBound(&strm, elemsize) + 64);
+      strm.next_out = &block[0];
+      strm.avail_out = static_cast<uInt>(block.size());
+
+      uLong head = std::min(elemsize, static_cast<uLong>(1024));
+      strm.next_in = elem;
+      strm.avail_in = static_cast<uInt>(head);
+      ASSERT_EQ(Z_OK, deflate(&strm, Z_FULL_FLUSH));
+      uLong flushed = strm.total_out;
+      strm.avail_in = static_cast<uInt>(elemsize - head);
+      ASSERT_EQ(Z_STREAM_END, deflate(&strm, Z_FINISH));
+      uLong blocksize = strm.total_out;
+      deflateEnd(&strm);
+
+      if (index == damaged)
+      {
+        ASSERT_LT(flushed, blocksize);
+        block[flushed] |= 0x06;
+      }
+
+      int32_t ctag[2] = { matfilebase::miCOMPRESSED, static_cast<int32_t>(blocksize) };
+      result.insert(result.end(), reinterpret_cast<char*>(ctag), reinterpret_cast<char*>(ctag) + 8);
+      result.insert(result.end(), block.begin(), block.begin() + blocksize);
+
+      pos += 8 + ((static_cast<size_t>(tag[1]) + 7)/8)*8;
+    }
+
+    std::ofstream os(out, std::ios::binary);
+    os.write(&result[0], result.size());
+  }
+}
+
+TEST(MatlabFileV5Tests, ReadsCompressedVariables)
+{
+  const auto raw = tempFile("MatlabFileV5Tests_raw.mat");
+  const auto filename = tempFile("MatlabFileV5Tests_compressed.mat");
+  writeUncompressed(raw);
+  compress(raw, filename);
+
+  matlabfile mf(filename, "r");
+  ASSERT_EQ(3, mf.getnummatlabarrays());
+
+  matlabarray a = mf.getmatlabarray("A");
+  EXPECT_EQ(3, a.getm());
+  EXPECT_EQ(4, a.getn());
+  auto av = values(a);
+  ASSERT_EQ(12, av.size());
+  EXPECT_EQ(21, av[1 + 3*2]);
+
+  matlabarray info = mf.getmatlabarrayinfo("big");
+  EXPECT_EQ(20000, info.getnumelements());
+  auto bv = values(mf.getmatlabarray(1));
+  ASSERT_EQ(20000, bv.size());
+  for (int k = 0; k < 20000; k++) ASSERT_EQ(7*k - 3, bv[k]) << k;
+
+  EXPECT_EQ("hello", mf.getmatlabarray("s").getstring());
+  mf.close();
+}
+
+TEST(MatlabFileV5Tests, OpeningDecompressesOnlyTheHeaderOfEachVariable)
+{
+  const auto raw = tempFile("MatlabFileV5Tests_raw.mat");
+  const auto filename = tempFile("MatlabFileV5Tests_damaged.mat");
+  writeUncompressed(raw);
+  compress(raw, filename, 1);
+
+  // The damaged data of big is never inflated while indexing the file or
+  // while reading the variables around it
+  matlabfile mf(filename, "r");
+  ASSERT_EQ(3, mf.getnummatlabarrays());
+  EXPECT_EQ(12, values(mf.getmatlabarray("A")).size());
+  EXPECT_EQ("hello", mf.getmatlabarray("s").getstring());
+  EXPECT_THROW(mf.getmatlabarray("big"), matfilebase::compression_error);
+  EXPECT_EQ(21, values(mf.getmatlabarray("A"))[1 + 3*2]);
+  mf.close();
+}
+
+// chunked73.mat was written with libhdf5 behind a 512 byte user block that
+// holds the MAT 7.3 header. Its variables are
+//   B  int32 100x37, chunks of 16x8, shuffle and deflate, B(k) = 3k-5
+//   D  double 30x20, chunks of 10x10, deflate and fletcher32, D(k) = k/2
+//   F  double 25x4, chunks of 10x4 without filters, F(k) = k-50.25
+// with k counting from zero in column major order, next to contiguous and
+// compact A, C (complex), s (char), L (logical), c (cell), st and sa (structs),
+// S (sparse) and E (empty) variables.
+TEST(MatlabFileV73Tests, ReadsChunkedShuffledAndDeflatedData)
+{
+  matlabfile mf(dataDir + "/chunked73.mat", "r");
+  ASSERT_EQ(12, mf.getnummatlabarrays());
+
+  matlabarray b = mf.getmatlabarray("B");
+  EXPECT_EQ(100, b.getm());
+  EXPECT_EQ(37, b.getn());
+  auto bv = values(b);
+  ASSERT_EQ(3700, bv.size());
+  for (int k = 0; k < 3700; k++) ASSERT_EQ(3*k - 5, bv[k]) << k;
+
+  matlabarray d = mf.getmatlabarray("D");
+  EXPECT_EQ(30, d.getm());
+  EXPECT_EQ(20, d.getn());
+  auto dv = values(d);
+  ASSERT_EQ(600, dv.size());
+  for (int k = 0; k < 600; k++) ASSERT_EQ(0.5*k, dv[k]) << k;
+  EXPECT_EQ(600, mf.getmatlabarrayinfo("D").getnumelements());
+
+  matlabarray f = mf.getmatlabarray("F");
+  EXPECT_EQ(25, f.getm());
+  EXPECT_EQ(4, f.getn());
+  auto fv = values(f);
+  ASSERT_EQ(100, fv.size());
+  for (int k = 0; k < 100; k++) ASSERT_EQ(k - 50.25, fv[k]) << k;
+  mf.close();
+}
+
+TEST(MatlabFileV73Tests, ReadsContiguousAndCompactVariables)
+{
+  matlabfile mf(dataDir + "/chunked73.mat", "r");
+
+  matlabarray a = mf.getmatlabarray("A");
+  EXPECT_EQ("A", a.getname());
+  EXPECT_EQ(3, a.getm());
+  EXPECT_EQ(4, a.getn());
+  auto av = values(a);
+  ASSERT_EQ(12, av.size());
+  EXPECT_EQ(21, av[1 + 3*2]);
+  EXPECT_EQ(32, av[11]);
+
+  matlabarray c = mf.getmatlabarray("C");
+  EXPECT_TRUE(c.iscomplex());
+  EXPECT_EQ(4, values(c)[3]);
+  std::vector<double> im;
+  c.getimagnumericarray(im);
+  ASSERT_EQ(4, im.size());
+  EXPECT_EQ(-3, im[2]);
+
+  EXPECT_EQ("hello", mf.getmatlabarray("s").getstring());
+
+  matlabarray L = mf.getmatlabarray("L");
+  ASSERT_EQ(3, L.getnumelements());
+  EXPECT_EQ(1, values(L)[2]);
+
+  matlabarray cell = mf.getmatlabarray("c");
+  ASSERT_TRUE(cell.iscell());
+  ASSERT_EQ(2, cell.getnumelements());
+  EXPECT_EQ(7, values(cell.getcell(0))[0]);
+  EXPECT_EQ("xy", cell.getcell(1).getstring());
+
+  matlabarray st = mf.getmatlabarray("st");
+  ASSERT_TRUE(st.isstruct());
+  EXPECT_EQ(5, values(st.getfield(0, "x"))[0]);
+  EXPECT_EQ("abc", st.getfield(0, "y").getstring());
+
+  matlabarray sa = mf.getmatlabarray("sa");
+  ASSERT_TRUE(sa.isstruct());
+  ASSERT_EQ(2, sa.getnumelements());
+  EXPECT_EQ(2, values(sa.getfield(1, "v"))[0]);
+
+  matlabarray S = mf.getmatlabarray("S");
+  ASSERT_TRUE(S.issparse());
+  EXPECT_EQ(3, S.getm());
+  EXPECT_EQ(3, S.getn());
+  ASSERT_EQ(2, S.getnnz());
+  int rows[2];
+  S.getrowsarray(rows, 2);
+  EXPECT_EQ(2, rows[1]);
+
+  EXPECT_EQ(0, mf.getmatlabarray("E").getnumelements());
+  mf.close();
+}
+
+// latest73.mat holds the contiguous and compact variables of chunked73.mat,
+// written with the latest format bounds: superblock version 3, version 2
+// object headers and compact link storage.
+TEST(MatlabFileV73Tests, ReadsLatestFormatFile)
+{
+  matlabfile mf(dataDir + "/latest73.mat", "r");
+  ASSERT_EQ(9, mf.getnummatlabarrays());
+
+  auto av = values(mf.getmatlabarray("A"));
+  ASSERT_EQ(12, av.size());
+  EXPECT_EQ(21, av[1 + 3*2]);
+  EXPECT_EQ("hello", mf.getmatlabarray("s").getstring());
+  EXPECT_EQ("abc", mf.getmatlabarray("st").getfield(0, "y").getstring());
+  EXPECT_EQ(2, mf.getmatlabarray("S").getnnz());
+  mf.close();
+}
@@ -53,14 +53,47 @@
  */
 
 #include <Core/Matlab/matfile.h>
+#include <algorithm>
 #include <cstring>
 #include <zlib.h>
 
 using namespace SCIRun::MatlabIO;
 
+// 64 bit versions of fseek and ftell, so files larger than 2GB can be indexed
+
+namespace
+{
+  int mfseek(FILE *fptr,int64_t offset)
+  {
+#ifdef _WIN32
+    return(_fseeki64(fptr,offset,SEEK_SET));
+#else
+    return(fseeko(fptr,static_cast<off_t>(offset),SEEK_SET));
+#endif
+  }
+
+  int mfseekend(FILE *fptr)
+  {
+#ifdef _WIN32
+    return(_fseeki64(fptr,0,SEEK_END));
+#else
+    return(fseeko(fptr,0,SEEK_END));
+#endif
+  }
+
+  int64_t mftell(FILE *fptr)
+  {
+#ifdef _WIN32
+    return(static_cast<int64_t>(_ftelli64(fptr)));
+#else
+    return(static_cast<int64_t>(ftello(fptr)));
+#endif
+  }
+}
+
 // Function for doing byteswapping when loading a file created on a different platform
 
-void matfile::mfswapbytes(void *vbuffer,int elsize,int size)
+void matfile::mfswapbytes(void *vbuffer,int elsize,int64_t size)
 {
    char temp;
    char *buffer = static_cast<char *>(vbuffer);
@@ -75,18 +108,18 @@ void matfile::mfswapbytes(void *vbuffer,int elsize,int size)
          break;
       case 2:
 		// Do a 2 bytes element byte swap.
-		for(int p=0;p<size;p+=2)
+		for(int64_t p=0;p<size;p+=2)
 		  { temp = buffer[p]; buffer[p] = buffer[p+1]; buffer[p+1] = temp; }
 		break;
       case 4:
 		// Do a 4 bytes element byte swap.
-		for(int p=0;p<size;p+=4)
+		for(int64_t p=0;p<size;p+=4)
 		  { temp = buffer[p]; buffer[p] = buffer[p+3]; buffer[p+3] = temp;
 			temp = buffer[p+1]; buffer[p+1] = buffer[p+2]; buffer[p+2] = temp; }
 		break;
       case 8:
 		// Do a 8 bytes element byte swap.
-		for(int p=0;p<size;p+=8)
+		for(int64_t p=0;p<size;p+=8)
 		  { temp = buffer[p]; buffer[p] = buffer[p+7]; buffer[p+7] = temp;
 			temp = buffer[p+1]; buffer[p+1] = buffer[p+6]; buffer[p+6] = temp;
 			temp = buffer[p+2]; buffer[p+2] = buffer[p+5]; buffer[p+5] = temp;
@@ -101,29 +134,29 @@ void matfile::mfswapbytes(void *vbuffer,int elsize,int size)
 // these functions invoke byteswapping and decrease the amount of coding in
 // the more dedicated read and write functions.
 
-void matfile::mfwrite(void *buffer,int elsize,int size)
+void matfile::mfwrite(void *buffer,int elsize,int64_t size)
 {
 	FILE *fptr;
 	fptr = m_->fptr_;
 
     if (fptr == nullptr) return;
-    if (static_cast<int>(fwrite(buffer,elsize,size,fptr)) != size) throw io_error();
+    if (static_cast<int64_t>(fwrite(buffer,elsize,size,fptr)) != size) throw io_error();
     if (ferror(fptr)) throw io_error();
 }
 
-void matfile::mfwrite(void *buffer,int elsize,int size,int offset)
+void matfile::mfwrite(void *buffer,int elsize,int64_t size,int64_t offset)
 {
     FILE *fptr;
   	fptr = m_->fptr_;
 
 	  if (fptr == nullptr) return;
-    if (fseek(fptr,offset,SEEK_SET) != 0) throw io_error();
+    if (mfseek(fptr,offset) != 0) throw io_error();
     if (ferror(fptr)) throw io_error();
-    if (static_cast<int>(fwrite(buffer,elsize,size,fptr)) != size) throw io_error();
+    if (static_cast<int64_t>(fwrite(buffer,elsize,size,fptr)) != size) throw io_error();
     if (ferror(fptr)) throw io_error();
 }
 
-void matfile::mfread(void *buffer,int elsize,int size)
+void matfile::mfread(void *buffer,int elsize,int64_t size)
 {
 	if (m_->fcmpbuffer_ == nullptr)
 	{
@@ -131,7 +164,7 @@ void matfile::mfread(void *buffer,int elsize,int size)
 		fptr = m_->fptr_;
 
 		if (fptr == nullptr) return;
-		if (static_cast<int>(fread(buffer,elsize,size,fptr)) != size) throw io_error();
+		if (static_cast<int64_t>(fread(buffer,elsize,size,fptr)) != size) throw io_error();
 		if (ferror(fptr)) throw io_error();
 		if (m_->byteswap_) mfswapbytes(buffer,elsize,size);
 	}
@@ -144,7 +177,7 @@ void matfile::mfread(void *buffer,int elsize,int size)
 	}
 }
 
-void matfile::mfread(void *buffer,int elsize,int size,int offset)
+void matfile::mfread(void *buffer,int elsize,int64_t size,int64_t offset)
 {
 	if (m_->fcmpbuffer_ == nullptr)
 	{
@@ -152,9 +185,9 @@ void matfile::mfread(void *buffer,int elsize,int size,int offset)
 		fptr = m_->fptr_;
 
 		if (fptr == nullptr) return;
-		if (fseek(fptr,offset,SEEK_SET) != 0) throw io_error();
+		if (mfseek(fptr,offset) != 0) throw io_error();
 		if (ferror(fptr)) throw io_error();
-		if (static_cast<int>(fread(buffer,elsize,size,fptr)) != size) throw io_error();
+		if (static_cast<int64_t>(fread(buffer,elsize,size,fptr)) != size) throw io_error();
 		if (ferror(fptr)) throw io_error();
 		if (m_->byteswap_) mfswapbytes(buffer,elsize,size);
 	}
@@ -217,6 +250,7 @@ matfile::matfile()
 	m_->fcmpbuffer_ = nullptr;
 	m_->fcmpsize_ = 0;
 	m_->byteswap_ = 0;
+	m_->version_ = 0;
 	m_->ref_ = 1;
   m_->compressmode_ = false;
 }
@@ -226,7 +260,10 @@ matfile::matfile(const std::string& filename,const std::string& mode)
 {
 	m_ = new mxfile;
 	m_->fptr_ = nullptr;
+	m_->fcmpbuffer_ = nullptr;
+	m_->fcmpsize_ = 0;
 	m_->byteswap_ = 0;
+	m_->version_ = 0;
 	m_->ref_ = 1;
 	m_->compressmode_ = false;
     open(filename,mode);
@@ -311,8 +348,8 @@ void matfile::open(const std::string& filename,const std::string& mode)
             if (!(m_->fptr_ = fopen(m_->fname_.c_str(),"rb"))) throw could_not_open_file();
 
             // Determine file length, file needs to contain at least the 128 byte header
-            if (fseek(m_->fptr_,0,SEEK_END) != 0) throw io_error();
-            m_->flength_ = ftell(m_->fptr_);
+            if (mfseekend(m_->fptr_) != 0) throw io_error();
+            m_->flength_ = mftell(m_->fptr_);
             if (m_->flength_ < 128) throw invalid_file_format();
 
             // Determine whether file is of a different type
@@ -421,10 +458,11 @@ void matfile::rewind()
 
   m_->compressmode_ = false;
 	m_->fcmpbuffer_ = nullptr;
+	m_->fcmpmbuffer_ = matfiledata();
 	m_->fcmpsize_ = 0;
 }
 
-int matfile::nexttag()
+int64_t matfile::nexttag()
 {
   bool compresstag = false;
 
@@ -489,8 +527,8 @@ bool matfile::openchild()
 
 // When encountering a miCOMPRESSION tag use this function
 // to enter the compressed data.
-// This function uncompresses the data, adds the buffer to the list of
-// uncompressed memory blocks and recomputes the block pointers to read
+// This function uncompresses the data, keeps the buffer as the last
+// uncompressed memory block and recomputes the block pointers to read
 // in the domain of the uncompressed memory block
 
 bool matfile::opencompression()
@@ -512,122 +550,137 @@ bool matfile::opencompression()
 	if (m_->fcmpbuffer_ != nullptr) throw compression_error();
 
 	// Get the size and position of the compressed data
-	int compressblockoffset = m_->curptr_.datptr;
-	int compressblocksize = m_->curptr_.size;
-
-	// Make sure we are not in compressed mode
-	m_->fcmpbuffer_ = nullptr;
-
-	// Create a new buffer structure
-	compressbuffer cmpbuffer;
+	int64_t compressblockoffset = m_->curptr_.datptr;
+	int64_t compressblocksize = m_->curptr_.size;
 
 	// First check whether the work we require has already been
 	// done. We should not overheat the processor without any good
 	// reason.
-	for (unsigned int p = 0;p<m_->cmplist_.size();p++)
+	if (m_->cmplist_.empty() || m_->cmplist_.back().bufferoffset != compressblockoffset)
 	{
-		cmpbuffer = m_->cmplist_[p];
-		if (cmpbuffer.bufferoffset == compressblockoffset)
-		{
-			// Yeah the job has already been done
-			// Enter the data of the block in the
-			// main file descriptor
-			m_->fcmpbuffer_ = static_cast<char *>(cmpbuffer.mbuffer.databuffer());
-			m_->fcmpsize_ = cmpbuffer.buffersize;
-			m_->fcmpoffset_ = cmpbuffer.bufferoffset;
-			m_->fcmpcount_ = 0;
-			break;
-		}
+		// Release the previous block before decompressing the next one
+		m_->cmplist_.clear();
+
+		compressbuffer cmpbuffer;
+		cmpbuffer.buffersize = mfinflate(cmpbuffer.mbuffer,compressblockoffset,compressblocksize,-1);
+		cmpbuffer.bufferoffset = compressblockoffset;
+		m_->cmplist_.push_back(cmpbuffer);
 	}
 
-	// We still need to uncompress the block
-	if (m_->fcmpbuffer_ == nullptr)
+	compressbuffer& cmpbuffer = m_->cmplist_.back();
+	mfentercompression(static_cast<char *>(cmpbuffer.mbuffer.databuffer()),cmpbuffer.buffersize,cmpbuffer.bufferoffset);
+	return(true);
+}
+
+bool matfile::peekcompression(int64_t numbytes)
+{
+    if (m_->curptr_.datptr == -1) return(false);
+	if (iswriteaccess()) throw compression_error();
+	if (m_->fcmpbuffer_ != nullptr) throw compression_error();
+
+	int64_t compressblockoffset = m_->curptr_.datptr;
+	int64_t compressblocksize = m_->curptr_.size;
+
+	// If the block was fully decompressed already, use that one
+	if (!m_->cmplist_.empty() && m_->cmplist_.back().bufferoffset == compressblockoffset)
 	{
-		// We need to decompress the buffer
-		char *sourcebuffer = nullptr;
-		matfiledata destbuffer;
-		int32_t *destbufferheader = nullptr;
-		int destlen = 0;
-
-		// We do some dynamic allocation here, if this fails the function
-		// should clear up its memory
-		try
+		compressbuffer& cmpbuffer = m_->cmplist_.back();
+		mfentercompression(static_cast<char *>(cmpbuffer.mbuffer.databuffer()),cmpbuffer.buffersize,cmpbuffer.bufferoffset);
+		return(true);
+	}
+
+	matfiledata mbuffer;
+	int64_t buffersize = mfinflate(mbuffer,compressblockoffset,compressblocksize,numbytes);
+	m_->fcmpmbuffer_ = mbuffer;
+	mfentercompression(static_cast<char *>(mbuffer.databuffer()),buffersize,compressblockoffset);
+	return(true);
+}
+
+int64_t matfile::mfinflate(matfiledata& mbuffer,int64_t offset,int64_t size,int64_t maxbytes)
+{
+	// Compressed data is read in pieces of this size, so the compressed
+	// block itself never needs to be in memory
+	const int64_t chunksize = 1 << 18;
+
+	std::vector<char> sourcebuffer(static_cast<size_t>(std::min(size,chunksize)));
+	int64_t sourceread = 0;
+	int32_t header[2];
+	int64_t destlen = 8;
+	int64_t destcount = 0;
+
+	z_stream strm;
+	std::memset(&strm,0,sizeof(z_stream));
+	if (inflateInit(&strm) != Z_OK) throw compression_error();
+
+	try
+	{
+		char *dest = reinterpret_cast<char *>(&header[0]);
+
+		while (destcount < destlen)
 		{
-			// Read the block of compressed data
-			sourcebuffer = new char[compressblocksize];
-			mfread(static_cast<void *>(sourcebuffer),sizeof(char),compressblocksize,compressblockoffset);
-
-			// first only read the header to find out how big the data segment should be
-			// Only decompress the first 8 bytes. We need to know whether inside is a matrix
-			// and of what size this one is.
-
-			destlen = 8;
-			destbufferheader = new int32_t[2];
-			// uncompress the first few bytes
-			// we need to do a few ugly casts as somehow the compiler does not recognize
-			// they are all pointers.
-
-			uLongf clen = static_cast<uLongf>(destlen);
-      uncompress(reinterpret_cast<Bytef *>(destbufferheader),&clen,reinterpret_cast<const Bytef *>(sourcebuffer),(uLong)compressblocksize);
-			destlen = static_cast<int>(clen);
-
-			// In case something weird happened
-			if (destlen != 8) throw compression_error();
-
-			// If byteswapping needs to be done, it needs to be done
-			if (m_->byteswap_) mfswapbytes(destbufferheader,sizeof(int32_t),2);
-
-			// The first int should be indicating it is a matrix
-			if (destbufferheader[0] != static_cast<int>(miMATRIX)) throw invalid_file_format();
-			// The secong int descibes the size of the contents of the matrix minus its header
-			// Hence the plus 8
-			destlen = destbufferheader[1]+8;
-
-			// Uncompress the full thing including the previously read header
-			destbuffer.newdatabuffer(destlen,miUINT8);
-			//			destbuffer = new char[destlen];
-
-      clen = static_cast<uLongf>(destlen);
-			uncompress(reinterpret_cast<Bytef *>(destbuffer.databuffer()),&clen,reinterpret_cast<const Bytef *>(sourcebuffer),(uLong)compressblocksize);
-      destlen = static_cast<int>(clen);
-			if (destlen != destbufferheader[1]+8) throw compression_error();
-
-			// enter the information in the cmpbuffer structure
-			cmpbuffer.mbuffer = destbuffer;
-			// destbuffer = 0;
-			cmpbuffer.buffersize = destlen;
-			cmpbuffer.bufferoffset = compressblockoffset;
-
-			// add this one to the list
-			m_->cmplist_.push_back(cmpbuffer);
-
-			// Now fill out the fcmpbuffer stuff to
-			// force reading in the buffer
-			m_->fcmpbuffer_ = static_cast<char *>(cmpbuffer.mbuffer.databuffer());
-			m_->fcmpsize_ = cmpbuffer.buffersize;
-			m_->fcmpoffset_ = cmpbuffer.bufferoffset;
-			m_->fcmpcount_ = 0;
-
-			// free the remaining buffers
-			if (sourcebuffer != nullptr) delete[] sourcebuffer;
-			sourcebuffer = nullptr;
-			if (destbufferheader != nullptr) delete[] destbufferheader;
-			destbufferheader = nullptr;
+			if ((strm.avail_in == 0)&&(sourceread < size))
+			{
+				int64_t len = std::min(size-sourceread,chunksize);
+				if (sourceread == 0) mfread(&sourcebuffer[0],sizeof(char),len,offset);
+				else mfread(&sourcebuffer[0],sizeof(char),len);
+				sourceread += len;
+				strm.next_in = reinterpret_cast<Bytef *>(&sourcebuffer[0]);
+				strm.avail_in = static_cast<uInt>(len);
+			}
 
-		}
-		catch(...)
-		{   // clean up
-			// if (destbuffer != 0) delete[] destbuffer;
-			if (sourcebuffer != nullptr) delete[] sourcebuffer;
-			sourcebuffer = nullptr;
-			if (destbufferheader != nullptr) delete[] destbufferheader;
-			destbufferheader = nullptr;
-			throw;
+			// zlib counts in 32 bits, so limit the output window for very large blocks
+			int64_t window = std::min(destlen-destcount,static_cast<int64_t>(1) << 30);
+			strm.next_out = reinterpret_cast<Bytef *>(dest+destcount);
+			strm.avail_out = static_cast<uInt>(window);
+
+			int ret = inflate(&strm,Z_NO_FLUSH);
+			int64_t produced = window-static_cast<int64_t>(strm.avail_out);
+			destcount += produced;
+
+			if ((ret != Z_OK)&&(ret != Z_STREAM_END)&&(ret != Z_BUF_ERROR)) throw compression_error();
+			if ((ret == Z_STREAM_END)&&(destcount < destlen)) throw compression_error();
+			if ((produced == 0)&&(strm.avail_in == 0)&&(sourceread == size)) throw compression_error();
+
+			if ((dest == reinterpret_cast<char *>(&header[0]))&&(destcount == 8))
+			{
+				// The first 8 bytes are the header of the matrix inside, they tell
+				// how large the uncompressed data is
+				int32_t tag[2] = { header[0], header[1] };
+				if (m_->byteswap_) mfswapbytes(tag,sizeof(int32_t),2);
+
+				// The first int should be indicating it is a matrix
+				if (tag[0] != static_cast<int32_t>(miMATRIX)) throw invalid_file_format();
+				// The second int describes the size of the contents of the matrix minus its header
+				// Hence the plus 8
+				destlen = static_cast<int64_t>(static_cast<uint32_t>(tag[1]))+8;
+				if ((maxbytes >= 0)&&(maxbytes < destlen)) destlen = std::max(maxbytes,static_cast<int64_t>(8));
+
+				mbuffer.newdatabuffer(destlen,miUINT8);
+				dest = static_cast<char *>(mbuffer.databuffer());
+				std::memcpy(dest,&header[0],8);
+			}
 		}
 	}
+	catch (...)
+	{
+		inflateEnd(&strm);
+		mbuffer.clear();
+		throw;
+	}
+
+	inflateEnd(&strm);
+	return(destlen);
+}
+
+void matfile::mfentercompression(char *buffer,int64_t size,int64_t offset)
+{
+	m_->fcmpbuffer_ = buffer;
+	m_->fcmpsize_ = size;
+	m_->fcmpoffset_ = offset;
+	m_->fcmpcount_ = 0;
 
     matfileptr childptr;
-    int datptr = m_->curptr_.datptr;
+    int64_t datptr = m_->curptr_.datptr;
     datptr = (((datptr-1)/8)+1)*8;
 
     childptr.hdrptr = datptr;
@@ -641,8 +694,6 @@ bool matfile::opencompression()
     m_->curptr_ = childptr;
     m_->compressmode_ = true;
     m_->fcmpalignoffset_ = datptr;
-
-    return(true);
 }
 
 
@@ -659,6 +710,7 @@ void matfile::closecompression()
     m_->ptrstack_.pop();
     m_->curptr_ = parptr;
     m_->fcmpbuffer_ = nullptr;
+    m_->fcmpmbuffer_ = matfiledata();
     m_->fcmpsize_ = 0;
     m_->fcmpoffset_ = 0;
     m_->fcmpcount_ = 0;
@@ -675,14 +727,14 @@ void matfile::closechild()
 
     if (iswriteaccess())
     {
-        int segsize;
+        uint32_t segsize;
         if (m_->curptr_.datptr != -1) nexttag();
 
-        segsize = m_->curptr_.hdrptr-parptr.datptr;
+        segsize = static_cast<uint32_t>(m_->curptr_.hdrptr-parptr.datptr);
 
 		m_->ptrstack_.pop();
         m_->curptr_ = parptr;
-        mfwrite(static_cast<void *>(&segsize),sizeof(int),1,m_->curptr_.hdrptr+4);
+        mfwrite(static_cast<void *>(&segsize),sizeof(uint32_t),1,m_->curptr_.hdrptr+4);
 		m_->curptr_.size = segsize;
     }
     else
@@ -692,7 +744,7 @@ void matfile::closechild()
     }
 }
 
-int matfile::firsttag()
+int64_t matfile::firsttag()
 {
     m_->curptr_.hdrptr = m_->curptr_.startptr;
     m_->curptr_.datptr = -1;
@@ -700,7 +752,7 @@ int matfile::firsttag()
     if (m_->curptr_.hdrptr == m_->curptr_.endptr) return(0); else return(m_->curptr_.hdrptr);
 }
 
-int matfile::gototag(int tagaddress)
+int64_t matfile::gototag(int64_t tagaddress)
 {
     m_->curptr_.hdrptr = tagaddress;
     m_->curptr_.datptr = -1;
@@ -711,7 +763,7 @@ int matfile::gototag(int tagaddress)
 
 void matfile::readtag(matfiledata& md)
 {
-    int32_t  size = 0;
+    uint32_t size = 0;
     int32_t  type = 0;
 
     md.clear();
@@ -720,7 +772,7 @@ void matfile::readtag(matfiledata& md)
         if (m_->curptr_.hdrptr == m_->curptr_.endptr) return;
 
         mfread(static_cast<void *>(&type),sizeof(int32_t),1,m_->curptr_.hdrptr);
-        mfread(static_cast<void *>(&size),sizeof(int32_t),1,m_->curptr_.hdrptr+4);
+        mfread(static_cast<void *>(&size),sizeof(uint32_t),1,m_->curptr_.hdrptr+4);
         m_->curptr_.datptr = m_->curptr_.hdrptr+8;
 
         if (type >= miEND)
@@ -731,17 +783,17 @@ void matfile::readtag(matfiledata& md)
             mfread(static_cast<void *>(&(csizetype[0])),sizeof(int32_t),1,m_->curptr_.hdrptr);
             if (byteswapmachine())
 			{
-				size = static_cast<int32_t>(csizetype[1]);
+				size = static_cast<uint32_t>(csizetype[1]);
 				type = static_cast<int32_t>(csizetype[0]);
 			}
 			else
 			{
-				size = static_cast<int32_t>(csizetype[0]);
+				size = static_cast<uint32_t>(csizetype[0]);
 				type = static_cast<int32_t>(csizetype[1]);
       }
       m_->curptr_.datptr = m_->curptr_.hdrptr+4;
     }
-      m_->curptr_.size = static_cast<int>(size);
+      m_->curptr_.size = static_cast<int64_t>(size);
 
       // If type still invalid then something else is going on
       // Throw an exception as we cannot read this field
@@ -760,7 +812,7 @@ void matfile::readtag(matfiledata& md)
 
 void matfile::readdat(matfiledata& md)
 {
-    int32_t  size = 0;
+    uint32_t size = 0;
     int32_t  type = 0;
 
     md.clear();
@@ -769,7 +821,7 @@ void matfile::readdat(matfiledata& md)
         if (m_->curptr_.hdrptr == m_->curptr_.endptr) return;
 
         mfread(static_cast<void *>(&type),sizeof(int32_t),1,m_->curptr_.hdrptr);
-        mfread(static_cast<void *>(&size),sizeof(int32_t),1,m_->curptr_.hdrptr+4);
+        mfread(static_cast<void *>(&size),sizeof(uint32_t),1,m_->curptr_.hdrptr+4);
         m_->curptr_.datptr = m_->curptr_.hdrptr+8;
 
         if (type >= miEND)
@@ -780,17 +832,17 @@ void matfile::readdat(matfiledata& md)
             mfread(static_cast<void *>(&(csizetype[0])),sizeof(int32_t),1,m_->curptr_.hdrptr);
             if (byteswapmachine())
             {
-              size = static_cast<int32_t>(csizetype[1]);
+              size = static_cast<uint32_t>(csizetype[1]);
               type = static_cast<int32_t>(csizetype[0]);
             }
             else
             {
-              size = static_cast<int32_t>(csizetype[0]);
+              size = static_cast<uint32_t>(csizetype[0]);
               type = static_cast<int32_t>(csizetype[1]);
             }
             m_->curptr_.datptr = m_->curptr_.hdrptr+4;
         }
-        m_->curptr_.size = static_cast<int>(size);
+        m_->curptr_.size = static_cast<int64_t>(size);
 
         // If type still invalid then something else is going on
         // Throw an exception as we cannot read this field
@@ -838,7 +890,7 @@ void matfile::writetag(matfiledata& md)
     }
     else
     {   // write a normal header
-        int32_t size = md.bytesize();
+        uint32_t size = static_cast<uint32_t>(md.bytesize());
         int32_t type = static_cast<int32_t>(md.type());
         mfwrite(static_cast<void *>(&type),sizeof(int32_t),1,m_->curptr_.hdrptr);
         mfwrite(static_cast<void *>(&size),sizeof(int32_t),1,m_->curptr_.hdrptr+4);
@@ -861,7 +913,7 @@ void matfile::writedat(matfiledata& md)
 	int headersize = 8;
 	if ((md.type() != miMATRIX)&&(md.bytesize() < 5)) headersize = 4;
 
-	int remsize = (((((md.bytesize()+headersize)-1)/8)+1)*8)-(md.bytesize()+headersize);
+	int remsize = static_cast<int>((((((md.bytesize()+headersize)-1)/8)+1)*8)-(md.bytesize()+headersize));
 
 	if ((headersize == 8)&&(md.bytesize() == 0)) return;
 
@@ -884,6 +936,12 @@ bool matfile::iswriteaccess()
     return(false);
 }
 
+bool matfile::ishdf5()
+{
+	if (m_->version_ == 0x0200) return(true);
+	return(false);
+}
+
 bool matfile::byteswap()
 {
 	if (m_->byteswap_ == 1) return(true);
@@ -53,6 +53,10 @@
  * - reading/writing the file header
  * - reading/writing the tags in the .mat file
  *
+ * Matlab 7.3 files are HDF5 files with a Matlab header, for these files
+ * only the header is read here, ishdf5() tells whether the arrays need to
+ * be read with the matfilehdf5 class.
+ *
  */
 
 
@@ -100,11 +104,11 @@ class SCISHARE matfile : public matfilebase {
 	// a file.
 
 	struct matfileptr {
-            int	hdrptr;		// location of tag header
-            int	datptr;		// location of data segment
-            int	startptr;	// location of the first tag header (to go one level up)
-            int	endptr;		// location of the end of the data segment (end+1)
-            int	size;		// length of data segment
+            int64_t	hdrptr;		// location of tag header
+            int64_t	datptr;		// location of data segment
+            int64_t	startptr;	// location of the first tag header (to go one level up)
+            int64_t	endptr;		// location of the end of the data segment (end+1)
+            int64_t	size;		// length of data segment
             mitype type;
             };
 
@@ -118,8 +122,8 @@ class SCISHARE matfile : public matfilebase {
 	struct compressbuffer {
 			matfiledata mbuffer;	// Buffer with reference counting
 			// char	*buffer;	// buffer with uncompressed data
-			int	buffersize; // size of the buffer;
-			int	bufferoffset; // file offset of the buffer
+			int64_t	buffersize; // size of the buffer;
+			int64_t	bufferoffset; // file offset of the buffer
 			};
 
 	struct mxfile {
@@ -141,17 +145,17 @@ class SCISHARE matfile : public matfilebase {
 			// fcmpcount_ counts the number of bytes read for the mfread and mfwrite calls
 
 			char		*fcmpbuffer_;   // Compression buffer
-			matfiledata fcmpmbuffer_;   // Same buffer but wrapped with my memory management system
-			int		fcmpsize_;		// Size of the buffer
-			int		fcmpoffset_;	// Offset of the buffer
-			int		fcmpcount_;		// Counter to check where next to read data
-      int    fcmpalignoffset_;    // Correction for alignment problem in filess
+			matfiledata fcmpmbuffer_;   // Partially decompressed block opened by peekcompression()
+			int64_t		fcmpsize_;		// Size of the buffer
+			int64_t		fcmpoffset_;	// Offset of the buffer
+			int64_t		fcmpcount_;		// Counter to check where next to read data
+      int64_t    fcmpalignoffset_;    // Correction for alignment problem in filess
 
 			FILE		*fptr_;			// File pointer
 			std::string fname_;			// Filename
 			std::string fmode_;			// File access mode: "r" or "w"
 
-			int	    flength_;		// File length
+			int64_t	    flength_;		// File length
 
 			char	    headertext_[118]; 	// The text in the header of the matfile
 			int32_t		subsysdata_[2];		// NEW IN VERSION 7
@@ -166,9 +170,10 @@ class SCISHARE matfile : public matfilebase {
 												// A matfile is like a directory (tree structure)
 			matfileptr curptr_;					// current pointer
 
-			// The next list contains the compressed buffers that were allocated
-			// Hence compressed variables have to be decompressed only once, which
-			// should boost the performance, but will cost memory
+			// The next list contains the compressed buffer that was decompressed last.
+			// Only one block is kept, so asking for the header and then the data of the
+			// same variable decompresses it once, while memory use stays bounded by the
+			// largest variable instead of the whole file.
 
 			std::deque<compressbuffer> cmplist_;	// maintain a list of segments that have already been decompressed
 			};
@@ -181,7 +186,7 @@ class SCISHARE matfile : public matfilebase {
 	// To further optimize the performance, loops should be
 	// unrolled in this function.
 	// currently it only supports certain element sizes
-   	void mfswapbytes(void *buffer,int elsize,int size);
+   	void mfswapbytes(void *buffer,int elsize,int64_t size);
 
 	// test byte swapping
 	bool byteswap();
@@ -198,12 +203,22 @@ class SCISHARE matfile : public matfilebase {
 	// issue. Actually only the reader does byte swapping, but this way there is a
 	// consistent interface.
 	// The offset version start reading at an certain location (includes a fseek at the start)
+	// Offsets and sizes are 64 bit, so files and arrays can be larger than 2GB
+
+  	void mfread(void *buffer,int elsize,int64_t size);	// read data and do byte swapping
+	void mfread(void *buffer,int elsize,int64_t size,int64_t offset);
+
+	void mfwrite(void *buffer,int elsize,int64_t size);
+	void mfwrite(void *buffer,int elsize,int64_t size,int64_t offset);
 
-  	void mfread(void *buffer,int elsize,int size);	// read data and do byte swapping
-	void mfread(void *buffer,int elsize,int size,int offset);
+	// Decompress a miCOMPRESSED block straight from the file into mbuffer. The
+	// compressed data is streamed through zlib in small pieces, if maxbytes is not
+	// negative only the first maxbytes of the uncompressed data are produced.
+	// Returns the number of bytes in mbuffer.
+	int64_t mfinflate(matfiledata& mbuffer,int64_t offset,int64_t size,int64_t maxbytes);
 
-	void mfwrite(void *buffer,int elsize,int size);
-	void mfwrite(void *buffer,int elsize,int size,int offset);
+	// Make the decompressed buffer the current level of the file
+	void mfentercompression(char *buffer,int64_t size,int64_t offset);
 
   public:
   	// constructors
@@ -251,6 +266,14 @@ class SCISHARE matfile : public matfilebase {
 	bool opencompression();
 	void closecompression();
 
+	// peekcompression:
+	// same as opencompression, but only decompresses the first numbytes of the
+	// block, which is enough to read the header of the array inside. The data
+	// is not cached and reading beyond numbytes results in an io_error.
+	// Close it with closecompression()
+
+	bool peekcompression(int64_t numbytes);
+
 	// navigation through file:
 	// firsttag:
 	//   go back to the first data block
@@ -264,9 +287,9 @@ class SCISHARE matfile : public matfilebase {
 	// rewind:
 	//  Go to the first tag at the top level
 
-	int firsttag();
-	int nexttag();
-	int gototag(int tag);
+	int64_t firsttag();
+	int64_t nexttag();
+	int64_t gototag(int64_t tag);
 	void rewind();
 
 	// A quick test to see what kind of access to the
@@ -276,6 +299,10 @@ class SCISHARE matfile : public matfilebase {
 
 	bool isreadaccess();
 	bool iswriteaccess();
+
+	// Matlab 7.3 files have version 0x0200 in the header, the data
+	// is stored in an HDF5 container after the 512 byte header
+	bool ishdf5();
 };
 
 }}
@@ -142,7 +142,7 @@ matfiledata& matfiledata::operator= (const matfiledata &mfd)
   return *this;
 }
 
-void matfiledata::newdatabuffer(int bytesize,mitype type)
+void matfiledata::newdatabuffer(int64_t bytesize,mitype type)
 {
   if (m_ == nullptr)
   {
@@ -195,14 +195,14 @@ void matfiledata::setType(mitype type)
   m_->type_ = type;
 }
 
-int matfiledata::bytesize() const
+int64_t matfiledata::bytesize() const
 {
   if (m_ == nullptr)
   {
     std::cerr << "internal error in bytesize()\n";
     throw internal_error();
 	}
-  if(ptr_) return(m_->bytesize_ - static_cast<int>(static_cast<char *>(ptr_) - static_cast<char *>(m_->dataptr_)));
+  if(ptr_) return(m_->bytesize_ - static_cast<int64_t>(static_cast<char *>(ptr_) - static_cast<char *>(m_->dataptr_)));
   return(m_->bytesize_);
 }
 
@@ -245,7 +245,7 @@ int matfiledata::elsize() const
   return(elsize(m_->type_));
 }
 
-int matfiledata::size() const
+int64_t matfiledata::size() const
 {
   if (m_ == nullptr)
   {
@@ -346,7 +346,7 @@ int matfiledata::putstringarray(const std::vector<std::string>& vec)
 
 
 // in case of a void just copy the data (no conversion)
-void matfiledata::getdata(void *dataptr,int dbytesize) const
+void matfiledata::getdata(void *dataptr,int64_t dbytesize) const
 {
   if (databuffer() == nullptr) return;
   if (dataptr  == nullptr) return;
@@ -357,7 +357,7 @@ void matfiledata::getdata(void *dataptr,int dbytesize) const
 }
 
 
-void matfiledata::putdata(const void *dataptr,int dbytesize,mitype type)
+void matfiledata::putdata(const void *dataptr,int64_t dbytesize,mitype type)
 {
 	clear();
 	if (dataptr == nullptr) return;
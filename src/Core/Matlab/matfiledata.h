@@ -77,6 +77,7 @@
 *
 */
 
+#include <cstdint>
 #include <vector>
 #include <Core/Utils/SmartPointers.h>
 #include <Core/Matlab/matfilebase.h>
@@ -98,6 +99,7 @@ namespace SCIRun
     // the matfile class to the matlabfile class.
 
     class matfile;
+    class matfilehdf5;
     class matfiledata;
 
     class SCISHARE matfiledata : public matfilebase {
@@ -105,6 +107,7 @@ namespace SCIRun
       // make matfile a friend class so it can directly read and write
       // data into the memory managed by this object.
       friend class matfile;
+      friend class matfilehdf5;
 
       // structure definitions
     private:
@@ -112,7 +115,7 @@ namespace SCIRun
       {
         void	*dataptr_;	// Store the data to put in the matfile
         bool	owndata_;   // Do we own the data
-        int	bytesize_;	// Size of the data in bytes
+        int64_t	bytesize_;	// Size of the data in bytes
         mitype	type_;		// The type of the data
         int	ref_;		// reference counter
       };
@@ -138,7 +141,7 @@ namespace SCIRun
 
       // newdatabuffer() will clear the object and will initiate a new
       // buffer
-      void newdatabuffer(int bytesize,mitype type);
+      void newdatabuffer(int64_t bytesize,mitype type);
       // void extdatabuffer(void *databuffer, int bytesize, mitype type);
 
 
@@ -156,24 +159,24 @@ namespace SCIRun
       mitype 	type() const;
 
       // get size information.
-      int size() const;			// size in elements
-      int bytesize() const;		// size in bytes
+      int64_t size() const;			// size in elements
+      int64_t bytesize() const;		// size in bytes
       int elsize() const;			// size of the elements in the array
       int elsize(mitype type) const; // element size of a type
 
       // Direct access to data
-      void getdata(void *dataptr,int bytesize) const;
-      void putdata(const void *dataptr,int bytesize,mitype type);
+      void getdata(void *dataptr,int64_t bytesize) const;
+      void putdata(const void *dataptr,int64_t bytesize,mitype type);
 
       // copying and casting templates
 
       // copy and cast the data in a user defined memory space
       // dataptr and size specify the data block and the number of elements
       // that can be stored in this data block.
-      template<class T> void getandcast(T *dataptr,int size) const;
+      template<class T> void getandcast(T *dataptr,int64_t size) const;
       template<class T> void getandcast(T **dataptr,int dim1, int dim2) const;
       template<class T> void getandcast(T ***dataptr,int dim1, int dim2, int dim3) const;
-      template<class T> void putandcast(const T *dataptr,int size,mitype type);
+      template<class T> void putandcast(const T *dataptr,int64_t size,mitype type);
       template<class T> void putandcast(const T **dataptr,int dim1, int dim2, mitype type);
       template<class T> void putandcast(const T ***dataptr,int dim1, int dim2, int dim3, mitype type);
 
@@ -189,8 +192,8 @@ namespace SCIRun
 
 
       // Access functions per element.
-      template<class T> T getandcastvalue(int index) const;
-      template<class T> void putandcastvalue(T value,int index);
+      template<class T> T getandcastvalue(int64_t index) const;
+      template<class T> void putandcastvalue(T value,int64_t index);
 
       // string functions
       // support functions for reading and writing field names and matrix names
@@ -224,7 +227,7 @@ namespace SCIRun
 
     };
 
-    template<class T> void matfiledata::getandcast(T *dataptr,int dsize) const
+    template<class T> void matfiledata::getandcast(T *dataptr,int64_t dsize) const
     {
       // This function copies and casts the data in the matfilebuffer into
       // a new buffer specified by dataptr (address of this new buffer) with
@@ -240,43 +243,43 @@ namespace SCIRun
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        for(int p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {dataptr[p] = static_cast<T>(ptr[p]); }}
         break;
       default:
         throw unknown_type();
@@ -296,60 +299,60 @@ namespace SCIRun
       if (size() == 0) return;
 
       // limit casting and copying to amount of data we have
-      if ((dim1*dim2) > size()) dim2 = size()/dim1;
+      if ((static_cast<int64_t>(dim1)*dim2) > size()) dim2 = static_cast<int>(size()/dim1);
       if (dim2 < 1) dim2 = 1;
-      if (dim1 > size()) dim1 = size();
+      if (dim1 > size()) dim1 = static_cast<int>(size());
 
       switch (type())
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        int p,q,s;
+        int p,q; int64_t s;
         s = 0; for(p=0;p<dim2;p++) for(q=0;q<dim1;q++) {dataptr[p][q] = static_cast<T>(ptr[s++]); }}
         break;
       default:
@@ -371,62 +374,62 @@ namespace SCIRun
       if (size() == 0) return;
 
       // limit casting and copying to amount of data we have
-      if ((dim1*dim2*dim3) > size()) dim3 = size()/(dim1*dim2);
+      if ((static_cast<int64_t>(dim1)*dim2*dim3) > size()) dim3 = static_cast<int>(size()/(static_cast<int64_t>(dim1)*dim2));
       if (dim3 < 1) dim3 = 1;
-      if ((dim1*dim2) > size()) dim2 = size()/dim1;
+      if ((static_cast<int64_t>(dim1)*dim2) > size()) dim2 = static_cast<int>(size()/dim1);
       if (dim2 < 1) dim2 = 1;
-      if (dim1 > size()) dim1 = size();
+      if (dim1 > size()) dim1 = static_cast<int>(size());
 
       switch (type())
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        int p,q,r,s;
+        int p,q,r; int64_t s;
         s = 0; for(p=0;p<dim3;p++) for(q=0;q<dim2;q++) for(r=0;r<dim1;r++) {dataptr[p][q][r] = static_cast<T>(ptr[s++]); }}
         break;
       default:
@@ -439,7 +442,7 @@ namespace SCIRun
 
       // This function copies and casts the data into a vector container
 
-      int dsize = size();
+      int64_t dsize = size();
       vec.resize(dsize);
 
       if (databuffer() == nullptr) { vec.resize(0); return; }
@@ -449,43 +452,43 @@ namespace SCIRun
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t*>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        for(int p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) {vec[p] = static_cast<T>(ptr[p]); }}
         break;
       default:
         throw unknown_type();
@@ -493,7 +496,7 @@ namespace SCIRun
     }
 
 
-    template<class T> T matfiledata::getandcastvalue(int index) const
+    template<class T> T matfiledata::getandcastvalue(int64_t index) const
     {
       // direct access to the data
 
@@ -544,7 +547,7 @@ namespace SCIRun
     // functions inserting data
 
 
-    template<class T> void matfiledata::putandcast(const T *dataptr,int dsize,mitype dtype)
+    template<class T> void matfiledata::putandcast(const T *dataptr,int64_t dsize,mitype dtype)
     {
       // This function copies and casts the data in the matfilebuffer into
       // a new buffer specified by dataptr (address of this new buffer) with
@@ -559,43 +562,43 @@ namespace SCIRun
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<signed char>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<signed char>(dataptr[p]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<unsigned char>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<unsigned char>(dataptr[p]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<signed short>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<signed short>(dataptr[p]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<unsigned short>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<unsigned short>(dataptr[p]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<int32_t>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<int32_t>(dataptr[p]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<uint32_t>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<uint32_t>(dataptr[p]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<int64_t>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<int64_t>(dataptr[p]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<uint64_t>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<uint64_t>(dataptr[p]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<float>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<float>(dataptr[p]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        for(int p=0;p<dsize;p++) { ptr[p] = static_cast<double>(dataptr[p]); }}
+        for(int64_t p=0;p<dsize;p++) { ptr[p] = static_cast<double>(dataptr[p]); }}
         break;
       default:
         throw unknown_type();
@@ -612,14 +615,14 @@ namespace SCIRun
       clear();
       if (dataptr  == nullptr) return;
 
-      newdatabuffer(dim1*dim2*elsize(dtype),dtype);
+      newdatabuffer(static_cast<int64_t>(dim1)*dim2*elsize(dtype),dtype);
 
       switch (dtype)
       {
       case miINT8:
         {
           signed char *ptr = static_cast<signed char *>(databuffer());
-          int s = 0;
+          int64_t s = 0;
           for(int p=0;p<dim2;p++)
             for(int q=0;q<dim1;q++)
             {
@@ -629,39 +632,39 @@ namespace SCIRun
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<unsigned char>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<unsigned char>(dataptr[p][q]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed short>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed short>(dataptr[p][q]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed short>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed short>(dataptr[p][q]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<int32_t>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<int32_t>(dataptr[p][q]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<uint32_t>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<uint32_t>(dataptr[p][q]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<int64_t>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<int64_t>(dataptr[p][q]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<uint64_t>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<uint64_t>(dataptr[p][q]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed char>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed char>(dataptr[p][q]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        int s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed char>(dataptr[p][q]); }}
+        int64_t s = 0; for(int p=0;p<dim2;p++) for(int q=0;q<dim1;q++) { ptr[s++] = static_cast<signed char>(dataptr[p][q]); }}
         break;
       default:
         throw unknown_type();
@@ -677,49 +680,49 @@ namespace SCIRun
       clear();
       if (dataptr  == nullptr) return;
 
-      newdatabuffer(dim1*dim2*dim3*elsize(dtype),dtype);
+      newdatabuffer(static_cast<int64_t>(dim1)*dim2*dim3*elsize(dtype),dtype);
 
       switch (dtype)
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<unsigned char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<unsigned char>(dataptr[p][q][r]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed short>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed short>(dataptr[p][q][r]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<unsigned short>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<unsigned short>(dataptr[p][q][r]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<int32_t>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<int32_t>(dataptr[p][q][r]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<uint32_t>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<uint32_t>(dataptr[p][q][r]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        int s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
+        int64_t s = 0; for(int p=0;p<dim3;p++) for(int q=0;q<dim2;q++) for(int r=0;r<dim2;r++) { ptr[s++] = static_cast<signed char>(dataptr[p][q][r]); }}
         break;
       default:
         throw unknown_type();
@@ -731,7 +734,7 @@ namespace SCIRun
     {
       clear();
 
-      int dsize = static_cast<int>(vec.size());
+      int64_t dsize = static_cast<int64_t>(vec.size());
 
       if (dsize == 0) return;
       newdatabuffer(dsize*elsize(type),type);
@@ -740,43 +743,43 @@ namespace SCIRun
       {
       case miINT8:
         { signed char *ptr = static_cast<signed char *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<signed char>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<signed char>(vec[p]); }}
         break;
       case miUINT8: case miUTF8:
         { unsigned char *ptr = static_cast<unsigned char *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<unsigned char>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<unsigned char>(vec[p]); }}
         break;
       case miINT16:
         { signed short *ptr = static_cast<signed short *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<signed short>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<signed short>(vec[p]); }}
         break;
       case miUINT16: case miUTF16:
         { unsigned short *ptr = static_cast<unsigned short *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<unsigned short>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<unsigned short>(vec[p]); }}
         break;
       case miINT32:
         { int32_t *ptr = static_cast<int32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<int32_t>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<int32_t>(vec[p]); }}
         break;
       case miUINT32: case miUTF32:
         { uint32_t *ptr = static_cast<uint32_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<uint32_t>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<uint32_t>(vec[p]); }}
         break;
       case miINT64:
         { int64_t *ptr = static_cast<int64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<int64_t>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<int64_t>(vec[p]); }}
         break;
       case miUINT64:
         { uint64_t *ptr = static_cast<uint64_t *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<uint64_t>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<uint64_t>(vec[p]); }}
         break;
       case miSINGLE:
         { float *ptr = static_cast<float *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<float>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<float>(vec[p]); }}
         break;
       case miDOUBLE:
         { double *ptr = static_cast<double *>(databuffer());
-        for(int p=0;p<dsize;p++) {ptr[p] = static_cast<double>(vec[p]); }}
+        for(int64_t p=0;p<dsize;p++) {ptr[p] = static_cast<double>(vec[p]); }}
         break;
       default:
         throw unknown_type();
@@ -784,7 +787,7 @@ namespace SCIRun
     }
 
 
-    template<class T> void matfiledata::putandcastvalue(T val,int index)
+    template<class T> void matfiledata::putandcastvalue(T val,int64_t index)
     {
       if (index >= size()) throw out_of_range();
 
@@ -834,7 +837,7 @@ namespace SCIRun
 
       // determine size
       ITERATOR it = is;
-      int dsize = 0;
+      int64_t dsize = 0;
       while(it != ie) { dsize++; ++it; }
 
 
@@ -0,0 +1,1162 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+// NOTE: This MatlabIO file is used in different projects as well. Please, do not
+// make it depend on other scirun code. This way it is easier to maintain matlabIO
+// code among different projects. Thank you.
+
+/*
+* FILE: matfilehdf5.cc
+*/
+
+#include <Core/Matlab/matfilehdf5.h>
+#include <algorithm>
+#include <cstring>
+#include <zlib.h>
+
+using namespace SCIRun::MatlabIO;
+
+namespace
+{
+  // 64 bit seek, Matlab 7.3 files are typically used for data larger than 2GB
+  int h5seek(FILE *fptr,int64_t offset,int whence)
+  {
+#ifdef _WIN32
+    return(_fseeki64(fptr,offset,whence));
+#else
+    return(fseeko(fptr,static_cast<off_t>(offset),whence));
+#endif
+  }
+
+  int64_t h5tell(FILE *fptr)
+  {
+#ifdef _WIN32
+    return(static_cast<int64_t>(_ftelli64(fptr)));
+#else
+    return(static_cast<int64_t>(ftello(fptr)));
+#endif
+  }
+
+  size_t pad8(size_t size) { return(((size+7)/8)*8); }
+
+  const unsigned char h5signature[8] = { 0x89, 'H', 'D', 'F', '\r', '\n', 0x1a, '\n' };
+}
+
+matfilehdf5::matfilehdf5()
+  : fptr_(nullptr), base_(0), flength_(0), offsetsize_(8), lengthsize_(8), rootaddress_(0)
+{
+}
+
+matfilehdf5::~matfilehdf5()
+{
+  close();
+}
+
+void matfilehdf5::open(const std::string& filename)
+{
+  close();
+  if (!(fptr_ = fopen(filename.c_str(),"rb"))) throw could_not_open_file();
+
+  try
+  {
+    if (h5seek(fptr_,0,SEEK_END) != 0) throw io_error();
+    flength_ = h5tell(fptr_);
+    readsuperblock();
+  }
+  catch (...)
+  {
+    close();
+    throw;
+  }
+}
+
+void matfilehdf5::close()
+{
+  if (fptr_) fclose(fptr_);
+  fptr_ = nullptr;
+}
+
+// Raw access to the file
+
+void matfilehdf5::h5read(int64_t address,void *buffer,int64_t size)
+{
+  if (fptr_ == nullptr) throw io_error();
+  if ((address < 0)||(size < 0)||(base_+address+size > flength_)) throw invalid_file_format();
+  if (size == 0) return;
+  if (h5seek(fptr_,base_+address,SEEK_SET) != 0) throw io_error();
+  if (static_cast<int64_t>(fread(buffer,1,static_cast<size_t>(size),fptr_)) != size) throw io_error();
+}
+
+uint64_t matfilehdf5::h5uint(const unsigned char *ptr,int size)
+{
+  // All HDF5 meta data is stored in little endian order
+  uint64_t val = 0;
+  for (int p=size-1;p>=0;p--) val = (val << 8) | static_cast<uint64_t>(ptr[p]);
+  return(val);
+}
+
+bool matfilehdf5::h5undefined(uint64_t address,int size)
+{
+  // The undefined address has all bits set
+  if (size >= 8) return(address == ~static_cast<uint64_t>(0));
+  return(address == ((static_cast<uint64_t>(1) << (8*size))-1));
+}
+
+void matfilehdf5::readsuperblock()
+{
+  // The superblock is located at offset 0, 512, 1024, 2048, ...
+  // Matlab puts it at 512, after its own header
+  unsigned char buffer[96];
+  int64_t superblock = -1;
+  for (int64_t offset = 0; offset+8 <= flength_; offset = (offset == 0) ? 512 : 2*offset)
+  {
+    base_ = 0;
+    h5read(offset,buffer,8);
+    if (std::memcmp(buffer,h5signature,8) == 0) { superblock = offset; break; }
+  }
+  if (superblock < 0) throw invalid_file_format();
+
+  base_ = superblock;
+  int64_t len = std::min(static_cast<int64_t>(96),flength_-superblock);
+  h5read(0,buffer,len);
+
+  int version = buffer[8];
+  size_t pos = 0;
+  if ((version == 0)||(version == 1))
+  {
+    offsetsize_ = buffer[13];
+    lengthsize_ = buffer[14];
+    pos = (version == 0) ? 24 : 28;
+    if ((offsetsize_ != 2 && offsetsize_ != 4 && offsetsize_ != 8)||(lengthsize_ != 2 && lengthsize_ != 4 && lengthsize_ != 8)) throw invalid_file_format();
+    // skip the base, free space, end of file and driver information addresses
+    pos += 4*offsetsize_;
+    // the root group symbol table entry, which starts with the link name offset
+    pos += offsetsize_;
+    if (pos+offsetsize_ > static_cast<size_t>(len)) throw invalid_file_format();
+    rootaddress_ = static_cast<int64_t>(h5uint(buffer+pos,offsetsize_));
+  }
+  else if ((version == 2)||(version == 3))
+  {
+    offsetsize_ = buffer[9];
+    lengthsize_ = buffer[10];
+    if ((offsetsize_ != 2 && offsetsize_ != 4 && offsetsize_ != 8)||(lengthsize_ != 2 && lengthsize_ != 4 && lengthsize_ != 8)) throw invalid_file_format();
+    // skip the base, superblock extension and end of file addresses
+    pos = 12 + 3*offsetsize_;
+    if (pos+offsetsize_ > static_cast<size_t>(len)) throw invalid_file_format();
+    rootaddress_ = static_cast<int64_t>(h5uint(buffer+pos,offsetsize_));
+  }
+  else
+  {
+    throw invalid_file_format();
+  }
+}
+
+// Object headers
+
+void matfilehdf5::readobjectheader(int64_t address,h5object& obj)
+{
+  obj.isgroup = false;
+  obj.btreeaddress = -1;
+  obj.heapaddress = -1;
+  obj.links.clear();
+  obj.denselinks = false;
+  obj.dims.clear();
+  obj.hasdataspace = false;
+  obj.hastype = false;
+  obj.type = h5type();
+  obj.layout = -1;
+  obj.dataaddress = -1;
+  obj.compactdata.clear();
+  obj.chunkdims.clear();
+  obj.filters.clear();
+  obj.matlabclass.clear();
+  obj.issparse = false;
+  obj.sparserows = 0;
+  obj.isempty = false;
+
+  std::vector<std::pair<int64_t,int64_t> > continuations;
+  unsigned char prefix[32];
+  int64_t len = std::min(static_cast<int64_t>(32),flength_-base_-address);
+  if (len < 16) throw invalid_file_format();
+  h5read(address,prefix,len);
+
+  bool version2 = false;
+  bool flaggedorder = false;
+
+  if (prefix[0] == 1)
+  {
+    // Version 1: 16 bytes of prefix (including alignment) followed by the messages
+    int64_t headersize = static_cast<int64_t>(h5uint(prefix+8,4));
+    std::vector<unsigned char> block(static_cast<size_t>(headersize));
+    h5read(address+16,block.data(),headersize);
+    readmessages(block,0,block.size(),false,false,obj,continuations);
+  }
+  else if (std::memcmp(prefix,"OHDR",4) == 0)
+  {
+    // Version 2: signature, version, flags, optional fields and the size of the first chunk
+    version2 = true;
+    int flags = prefix[5];
+    size_t pos = 6;
+    if (flags & 0x20) pos += 16;
+    if (flags & 0x10) pos += 4;
+    int width = 1 << (flags & 0x03);
+    if (pos+width > static_cast<size_t>(len)) throw invalid_file_format();
+    int64_t chunksize = static_cast<int64_t>(h5uint(prefix+pos,width));
+    pos += width;
+    flaggedorder = (flags & 0x04) != 0;
+
+    std::vector<unsigned char> block(static_cast<size_t>(chunksize));
+    h5read(address+static_cast<int64_t>(pos),block.data(),chunksize);
+    readmessages(block,0,block.size(),true,flaggedorder,obj,continuations);
+  }
+  else
+  {
+    throw invalid_file_format();
+  }
+
+  // Follow the continuation blocks, they can add new continuations
+  for (size_t c=0;c<continuations.size();c++)
+  {
+    if (c > 1024) throw invalid_file_format();
+    std::vector<unsigned char> block(static_cast<size_t>(continuations[c].second));
+    h5read(continuations[c].first,block.data(),continuations[c].second);
+    if (version2)
+    {
+      if ((block.size() < 8)||(std::memcmp(block.data(),"OCHK",4) != 0)) throw invalid_file_format();
+      readmessages(block,4,block.size()-4,true,flaggedorder,obj,continuations);
+    }
+    else
+    {
+      readmessages(block,0,block.size(),false,false,obj,continuations);
+    }
+  }
+}
+
+void matfilehdf5::readmessages(const std::vector<unsigned char>& block,size_t start,size_t end,bool version2,bool flaggedorder,h5object& obj,std::vector<std::pair<int64_t,int64_t> >& continuations)
+{
+  size_t headersize = version2 ? (flaggedorder ? 6 : 4) : 8;
+  size_t pos = start;
+
+  // Anything smaller than a message header at the end is a gap
+  while (pos+headersize <= end)
+  {
+    int type;
+    size_t size;
+    int flags;
+    if (version2)
+    {
+      type = block[pos];
+      size = static_cast<size_t>(h5uint(&block[pos+1],2));
+      flags = block[pos+3];
+    }
+    else
+    {
+      type = static_cast<int>(h5uint(&block[pos],2));
+      size = static_cast<size_t>(h5uint(&block[pos+2],2));
+      flags = block[pos+4];
+    }
+    pos += headersize;
+    if (pos+size > end) throw invalid_file_format();
+
+    const unsigned char *msg = &block[pos];
+    if (type == 0x0010)
+    {
+      // continuation message: address and length of the next block of messages
+      if (size < static_cast<size_t>(offsetsize_+lengthsize_)) throw invalid_file_format();
+      int64_t address = static_cast<int64_t>(h5uint(msg,offsetsize_));
+      int64_t length = static_cast<int64_t>(h5uint(msg+offsetsize_,lengthsize_));
+      continuations.push_back(std::make_pair(address,length));
+    }
+    else if ((flags & 0x02) && (type == 0x0003))
+    {
+      // Committed (shared) datatypes are not used by Matlab
+      throw unknown_type();
+    }
+    else
+    {
+      readmessage(type,msg,size,obj);
+    }
+    pos += size;
+  }
+}
+
+void matfilehdf5::readmessage(int type,const unsigned char *msg,size_t size,h5object& obj)
+{
+  switch (type)
+  {
+    case 0x0001:	// dataspace
+      readdataspace(msg,size,obj.dims);
+      obj.hasdataspace = true;
+      break;
+    case 0x0002:	// link info, a new style group
+      {
+        if (size < 2) throw invalid_file_format();
+        size_t pos = 2;
+        if (msg[1] & 0x01) pos += 8;
+        if (pos+offsetsize_ > size) throw invalid_file_format();
+        obj.isgroup = true;
+        if (!h5undefined(h5uint(msg+pos,offsetsize_),offsetsize_)) obj.denselinks = true;
+      }
+      break;
+    case 0x0003:	// datatype
+      readtype(msg,size,obj.type);
+      obj.hastype = true;
+      break;
+    case 0x0006:	// link, a member of a new style group
+      {
+        if (size < 2) throw invalid_file_format();
+        int flags = msg[1];
+        size_t pos = 2;
+        int linktype = 0;
+        if (flags & 0x08) linktype = msg[pos++];
+        if (flags & 0x04) pos += 8;
+        if (flags & 0x10) pos += 1;
+        int width = 1 << (flags & 0x03);
+        if (pos+width > size) throw invalid_file_format();
+        size_t namelength = static_cast<size_t>(h5uint(msg+pos,width));
+        pos += width;
+        if (pos+namelength > size) throw invalid_file_format();
+        std::string name(reinterpret_cast<const char *>(msg+pos),namelength);
+        pos += namelength;
+        obj.isgroup = true;
+        // Only hard links point to objects in this file
+        if (linktype == 0)
+        {
+          if (pos+offsetsize_ > size) throw invalid_file_format();
+          obj.links.push_back(std::make_pair(name,static_cast<int64_t>(h5uint(msg+pos,offsetsize_))));
+        }
+      }
+      break;
+    case 0x0008:	// data layout
+      {
+        if (size < 2) throw invalid_file_format();
+        int version = msg[0];
+        if ((version == 3)||(version == 4))
+        {
+          // Version 4 only differs from version 3 in the chunk indices
+          obj.layout = msg[1];
+          if (obj.layout == 0)
+          {
+            if (size < 4) throw invalid_file_format();
+            size_t len = static_cast<size_t>(h5uint(msg+2,2));
+            if (4+len > size) throw invalid_file_format();
+            obj.compactdata.assign(msg+4,msg+4+len);
+          }
+          else if (obj.layout == 1)
+          {
+            if (2+static_cast<size_t>(offsetsize_) > size) throw invalid_file_format();
+            obj.dataaddress = static_cast<int64_t>(h5uint(msg+2,offsetsize_));
+            if (h5undefined(static_cast<uint64_t>(obj.dataaddress),offsetsize_)) obj.dataaddress = -1;
+          }
+          else if ((obj.layout == 2)&&(version == 3))
+          {
+            if (size < 3) throw invalid_file_format();
+            int rank = msg[2];
+            if (3+static_cast<size_t>(offsetsize_)+4*rank > size) throw invalid_file_format();
+            obj.dataaddress = static_cast<int64_t>(h5uint(msg+3,offsetsize_));
+            if (h5undefined(static_cast<uint64_t>(obj.dataaddress),offsetsize_)) obj.dataaddress = -1;
+            obj.chunkdims.resize(rank);
+            for (int p=0;p<rank;p++) obj.chunkdims[p] = static_cast<uint32_t>(h5uint(msg+3+offsetsize_+4*p,4));
+          }
+          else
+          {
+            throw unknown_type();
+          }
+        }
+        else if ((version == 1)||(version == 2))
+        {
+          if (size < 8) throw invalid_file_format();
+          int rank = msg[1];
+          obj.layout = msg[2];
+          size_t pos = 8;
+          if (obj.layout != 0)
+          {
+            if (pos+offsetsize_ > size) throw invalid_file_format();
+            obj.dataaddress = static_cast<int64_t>(h5uint(msg+pos,offsetsize_));
+            if (h5undefined(static_cast<uint64_t>(obj.dataaddress),offsetsize_)) obj.dataaddress = -1;
+            pos += offsetsize_;
+          }
+          if (pos+4*rank > size) throw invalid_file_format();
+          std::vector<uint32_t> dims(rank);
+          for (int p=0;p<rank;p++) dims[p] = static_cast<uint32_t>(h5uint(msg+pos+4*p,4));
+          pos += 4*rank;
+          if (obj.layout == 2) obj.chunkdims = dims;
+          if (obj.layout == 0)
+          {
+            if (pos+4 > size) throw invalid_file_format();
+            size_t len = static_cast<size_t>(h5uint(msg+pos,4));
+            if (pos+4+len > size) throw invalid_file_format();
+            obj.compactdata.assign(msg+pos+4,msg+pos+4+len);
+          }
+        }
+        else
+        {
+          throw unknown_type();
+        }
+      }
+      break;
+    case 0x000B:	// filter pipeline
+      {
+        if (size < 2) throw invalid_file_format();
+        int version = msg[0];
+        int numfilters = msg[1];
+        size_t pos = (version == 1) ? 8 : 2;
+        for (int f=0;f<numfilters;f++)
+        {
+          h5filter filter;
+          size_t namelength = 0;
+          if (pos+2 > size) throw invalid_file_format();
+          filter.id = static_cast<int>(h5uint(msg+pos,2)); pos += 2;
+          if ((version == 1)||(filter.id >= 256))
+          {
+            if (pos+2 > size) throw invalid_file_format();
+            namelength = static_cast<size_t>(h5uint(msg+pos,2)); pos += 2;
+          }
+          if (pos+4 > size) throw invalid_file_format();
+          size_t numvalues = static_cast<size_t>(h5uint(msg+pos+2,2)); pos += 4;
+          pos += (version == 1) ? pad8(namelength) : namelength;
+          if (pos+4*numvalues > size) throw invalid_file_format();
+          for (size_t p=0;p<numvalues;p++) filter.values.push_back(static_cast<uint32_t>(h5uint(msg+pos+4*p,4)));
+          pos += 4*numvalues;
+          if ((version == 1)&&(numvalues & 1)) pos += 4;
+          obj.filters.push_back(filter);
+        }
+      }
+      break;
+    case 0x000C:	// attribute
+      readattribute(msg,size,obj);
+      break;
+    case 0x0011:	// symbol table, an old style group
+      if (size < static_cast<size_t>(2*offsetsize_)) throw invalid_file_format();
+      obj.isgroup = true;
+      obj.btreeaddress = static_cast<int64_t>(h5uint(msg,offsetsize_));
+      obj.heapaddress = static_cast<int64_t>(h5uint(msg+offsetsize_,offsetsize_));
+      break;
+    default:
+      // Fill values, modification times, etc. are not needed
+      break;
+  }
+}
+
+void matfilehdf5::readdataspace(const unsigned char *ptr,size_t size,std::vector<uint64_t>& dims)
+{
+  if (size < 4) throw invalid_file_format();
+  int version = ptr[0];
+  int rank = ptr[1];
+  size_t pos = (version == 1) ? 8 : 4;
+  dims.clear();
+
+  // A null dataspace has no elements at all
+  if ((version == 2)&&(ptr[3] == 2)) { dims.push_back(0); return; }
+  if (pos+static_cast<size_t>(rank)*lengthsize_ > size) throw invalid_file_format();
+  for (int p=0;p<rank;p++) dims.push_back(h5uint(ptr+pos+p*lengthsize_,lengthsize_));
+}
+
+size_t matfilehdf5::readtype(const unsigned char *ptr,size_t size,h5type& type)
+{
+  if (size < 8) throw invalid_file_format();
+  type = h5type();
+  type.cls = ptr[0] & 0x0F;
+  int version = ptr[0] >> 4;
+  int bits = static_cast<int>(h5uint(ptr+1,3));
+  type.size = static_cast<int>(h5uint(ptr+4,4));
+  type.bigendian = (bits & 0x01) != 0;
+  type.issigned = false;
+  type.realoffset = 0;
+  type.imagoffset = 0;
+  type.membersize = 0;
+  type.membercls = -1;
+  type.membersigned = false;
+
+  switch (type.cls)
+  {
+    case 0:	// integer
+      type.issigned = (bits & 0x08) != 0;
+      return(12);
+    case 1:	// floating point
+      return(20);
+    case 3:	// string
+    case 7:	// reference
+      type.bigendian = false;
+      return(8);
+    case 6:	// compound, Matlab uses these for complex numbers
+      {
+        int nummembers = bits & 0xFFFF;
+        size_t pos = 8;
+        bool hasreal = false;
+        bool hasimag = false;
+        for (int m=0;m<nummembers;m++)
+        {
+          size_t namelength = 0;
+          while ((pos+namelength < size)&&(ptr[pos+namelength] != 0)) namelength++;
+          if (pos+namelength >= size) throw invalid_file_format();
+          std::string name(reinterpret_cast<const char *>(ptr+pos),namelength);
+          pos += (version < 3) ? pad8(namelength+1) : namelength+1;
+
+          int offset;
+          if (version == 1)
+          {
+            // offset, dimensionality, permutation and the sizes of the (unused) array dimensions
+            if (pos+32 > size) throw invalid_file_format();
+            offset = static_cast<int>(h5uint(ptr+pos,4));
+            pos += 32;
+          }
+          else if (version == 2)
+          {
+            if (pos+4 > size) throw invalid_file_format();
+            offset = static_cast<int>(h5uint(ptr+pos,4));
+            pos += 4;
+          }
+          else
+          {
+            int width = 1;
+            while ((width < 4)&&(static_cast<uint64_t>(type.size) >= (static_cast<uint64_t>(1) << (8*width)))) width++;
+            if (pos+width > size) throw invalid_file_format();
+            offset = static_cast<int>(h5uint(ptr+pos,width));
+            pos += width;
+          }
+
+          h5type member;
+          pos += readtype(ptr+pos,size-pos,member);
+          if ((member.cls != 0)&&(member.cls != 1)) throw unknown_type();
+          if (name == "real") { type.realoffset = offset; hasreal = true; }
+          else if (name == "imag") { type.imagoffset = offset; hasimag = true; }
+          else throw unknown_type();
+          type.membersize = member.size;
+          type.membercls = member.cls;
+          type.membersigned = member.issigned;
+          type.bigendian = member.bigendian;
+        }
+        if (!hasreal || !hasimag) throw unknown_type();
+        return(pos);
+      }
+    default:
+      throw unknown_type();
+  }
+}
+
+void matfilehdf5::readattribute(const unsigned char *msg,size_t size,h5object& obj)
+{
+  if (size < 8) throw invalid_file_format();
+  int version = msg[0];
+  size_t namesize = static_cast<size_t>(h5uint(msg+2,2));
+  size_t typesize = static_cast<size_t>(h5uint(msg+4,2));
+  size_t spacesize = static_cast<size_t>(h5uint(msg+6,2));
+  size_t pos = (version == 3) ? 9 : 8;
+
+  // Version 1 pads every part to a multiple of 8 bytes
+  size_t namepad = (version == 1) ? pad8(namesize) : namesize;
+  size_t typepad = (version == 1) ? pad8(typesize) : typesize;
+  size_t spacepad = (version == 1) ? pad8(spacesize) : spacesize;
+  if (pos+namepad+typepad+spacepad > size) throw invalid_file_format();
+
+  std::string name(reinterpret_cast<const char *>(msg+pos),strnlen(reinterpret_cast<const char *>(msg+pos),namesize));
+  pos += namepad;
+  if ((name != "MATLAB_class")&&(name != "MATLAB_sparse")&&(name != "MATLAB_empty")) return;
+  // Shared datatypes or dataspaces are never used for these attributes
+  if ((version > 1)&&(msg[1] & 0x03)) return;
+
+  h5type type;
+  readtype(msg+pos,typesize,type);
+  pos += typepad;
+  std::vector<uint64_t> dims;
+  readdataspace(msg+pos,spacesize,dims);
+  pos += spacepad;
+
+  uint64_t numelem = 1;
+  for (size_t p=0;p<dims.size();p++) numelem *= dims[p];
+  if ((numelem == 0)||(pos+static_cast<size_t>(type.size) > size)) return;
+  const unsigned char *data = msg+pos;
+
+  if (name == "MATLAB_class")
+  {
+    if (type.cls != 3) return;
+    obj.matlabclass = std::string(reinterpret_cast<const char *>(data),strnlen(reinterpret_cast<const char *>(data),type.size));
+    while (!obj.matlabclass.empty() && obj.matlabclass.back() == ' ') obj.matlabclass.pop_back();
+  }
+  else
+  {
+    if ((type.cls != 0)||(type.size > 8)) return;
+    uint64_t value = 0;
+    if (type.bigendian) { for (int p=0;p<type.size;p++) value = (value << 8) | data[p]; }
+    else value = h5uint(data,type.size);
+
+    if (name == "MATLAB_sparse") { obj.issparse = true; obj.sparserows = value; }
+    else obj.isempty = (value != 0);
+  }
+}
+
+// Groups
+
+void matfilehdf5::readgroup(const h5object& obj,std::vector<std::pair<std::string,int64_t> >& members)
+{
+  members.clear();
+  if (obj.btreeaddress >= 0)
+  {
+    // The names of the members are stored in a local heap
+    unsigned char header[32];
+    h5read(obj.heapaddress,header,8+2*lengthsize_+offsetsize_);
+    if (std::memcmp(header,"HEAP",4) != 0) throw invalid_file_format();
+    int64_t heapsize = static_cast<int64_t>(h5uint(header+8,lengthsize_));
+    int64_t heapdata = static_cast<int64_t>(h5uint(header+8+2*lengthsize_,offsetsize_));
+    std::vector<char> heap(static_cast<size_t>(heapsize)+1,0);
+    h5read(heapdata,heap.data(),heapsize);
+
+    readsymboltable(obj.btreeaddress,heap,members);
+  }
+  else
+  {
+    if (obj.denselinks) throw unknown_type();
+    members = obj.links;
+  }
+}
+
+void matfilehdf5::readsymboltable(int64_t btreeaddress,const std::vector<char>& heap,std::vector<std::pair<std::string,int64_t> >& members)
+{
+  // Version 1 B-tree node of type 0, keys are offsets into the local heap
+  std::vector<unsigned char> header(8+2*offsetsize_);
+  h5read(btreeaddress,header.data(),static_cast<int64_t>(header.size()));
+  if ((std::memcmp(header.data(),"TREE",4) != 0)||(header[4] != 0)) throw invalid_file_format();
+  int level = header[5];
+  int entries = static_cast<int>(h5uint(&header[6],2));
+
+  size_t entrysize = lengthsize_+offsetsize_;
+  std::vector<unsigned char> node(entries*entrysize+lengthsize_);
+  h5read(btreeaddress+static_cast<int64_t>(header.size()),node.data(),static_cast<int64_t>(node.size()));
+
+  for (int e=0;e<entries;e++)
+  {
+    int64_t child = static_cast<int64_t>(h5uint(&node[e*entrysize+lengthsize_],offsetsize_));
+    if (level > 0)
+    {
+      readsymboltable(child,heap,members);
+      continue;
+    }
+
+    // Symbol table node with the actual entries
+    unsigned char snod[8];
+    h5read(child,snod,8);
+    if (std::memcmp(snod,"SNOD",4) != 0) throw invalid_file_format();
+    int numsymbols = static_cast<int>(h5uint(snod+6,2));
+    size_t symbolsize = 2*offsetsize_+24;
+    std::vector<unsigned char> symbols(numsymbols*symbolsize);
+    h5read(child+8,symbols.data(),static_cast<int64_t>(symbols.size()));
+
+    for (int s=0;s<numsymbols;s++)
+    {
+      size_t nameoffset = static_cast<size_t>(h5uint(&symbols[s*symbolsize],offsetsize_));
+      int64_t address = static_cast<int64_t>(h5uint(&symbols[s*symbolsize+offsetsize_],offsetsize_));
+      if (nameoffset >= heap.size()) throw invalid_file_format();
+      members.push_back(std::make_pair(std::string(&heap[nameoffset]),address));
+    }
+  }
+}
+
+// Dataset contents
+
+uint64_t matfilehdf5::numelements(const h5object& obj)
+{
+  if (!obj.hasdataspace) return(0);
+  uint64_t numelem = 1;
+  for (size_t p=0;p<obj.dims.size();p++) numelem *= obj.dims[p];
+  return(numelem);
+}
+
+void matfilehdf5::readdata(const h5object& obj,char *buffer,int64_t bytesize)
+{
+  if (bytesize <= 0) return;
+  switch (obj.layout)
+  {
+    case 0:
+      if (static_cast<int64_t>(obj.compactdata.size()) < bytesize) throw invalid_file_format();
+      std::memcpy(buffer,obj.compactdata.data(),static_cast<size_t>(bytesize));
+      break;
+    case 1:
+      // Space that was never written contains the fill value, which Matlab leaves at zero
+      if (obj.dataaddress < 0) std::memset(buffer,0,static_cast<size_t>(bytesize));
+      else h5read(obj.dataaddress,buffer,bytesize);
+      break;
+    case 2:
+      std::memset(buffer,0,static_cast<size_t>(bytesize));
+      if (obj.chunkdims.size() != obj.dims.size()+1) throw invalid_file_format();
+      if (obj.dataaddress >= 0) readchunks(obj.dataaddress,obj,buffer,bytesize);
+      break;
+    default:
+      throw invalid_file_format();
+  }
+}
+
+void matfilehdf5::readchunks(int64_t btreeaddress,const h5object& obj,char *buffer,int64_t bytesize)
+{
+  // Version 1 B-tree node of type 1, each key holds the size of the chunk, the
+  // filters that were skipped and the offset of the chunk in the dataset
+  std::vector<unsigned char> header(8+2*offsetsize_);
+  h5read(btreeaddress,header.data(),static_cast<int64_t>(header.size()));
+  if ((std::memcmp(header.data(),"TREE",4) != 0)||(header[4] != 1)) throw invalid_file_format();
+  int level = header[5];
+  int entries = static_cast<int>(h5uint(&header[6],2));
+
+  size_t rank = obj.dims.size();
+  size_t keysize = 8+8*(rank+1);
+  size_t entrysize = keysize+offsetsize_;
+  std::vector<unsigned char> node(entries*entrysize+keysize);
+  h5read(btreeaddress+static_cast<int64_t>(header.size()),node.data(),static_cast<int64_t>(node.size()));
+
+  int64_t elsize = obj.chunkdims[rank];
+  int64_t chunkelems = 1;
+  for (size_t d=0;d<rank;d++) chunkelems *= obj.chunkdims[d];
+  int64_t chunkbytes = chunkelems*elsize;
+
+  std::vector<char> chunk;
+  for (int e=0;e<entries;e++)
+  {
+    const unsigned char *key = &node[e*entrysize];
+    int64_t child = static_cast<int64_t>(h5uint(key+keysize,offsetsize_));
+    if (level > 0)
+    {
+      readchunks(child,obj,buffer,bytesize);
+      continue;
+    }
+
+    int64_t storedsize = static_cast<int64_t>(h5uint(key,4));
+    uint32_t filtermask = static_cast<uint32_t>(h5uint(key+4,4));
+    std::vector<uint64_t> offset(rank);
+    for (size_t d=0;d<rank;d++) offset[d] = h5uint(key+8+8*d,8);
+
+    chunk.resize(static_cast<size_t>(storedsize));
+    h5read(child,chunk.data(),storedsize);
+    decodechunk(obj,chunk,filtermask,chunkbytes);
+    if (static_cast<int64_t>(chunk.size()) < chunkbytes) throw compression_error();
+
+    // Copy the chunk into the array, one run along the fastest dimension
+    // at a time. Chunks at the edges stick out of the dataset and are clipped.
+    if (rank == 0) continue;
+    std::vector<uint64_t> index(rank,0);
+    uint64_t run = 0;
+    if (offset[rank-1] < obj.dims[rank-1]) run = std::min<uint64_t>(obj.chunkdims[rank-1],obj.dims[rank-1]-offset[rank-1]);
+    bool done = (run == 0);
+    while (!done)
+    {
+      bool inside = true;
+      uint64_t dest = 0;
+      uint64_t src = 0;
+      for (size_t d=0;d<rank;d++)
+      {
+        if (offset[d]+index[d] >= obj.dims[d]) inside = false;
+        dest = dest*obj.dims[d]+offset[d]+index[d];
+        src = src*obj.chunkdims[d]+index[d];
+      }
+      if (inside)
+      {
+        if (static_cast<int64_t>((dest+run)*elsize) > bytesize) throw invalid_file_format();
+        std::memcpy(buffer+dest*elsize,chunk.data()+src*elsize,static_cast<size_t>(run*elsize));
+      }
+
+      // advance the index over all but the fastest dimension
+      done = true;
+      for (size_t d=rank-1;d-- > 0;)
+      {
+        if (++index[d] < obj.chunkdims[d]) { done = false; break; }
+        index[d] = 0;
+      }
+    }
+  }
+}
+
+void matfilehdf5::decodechunk(const h5object& obj,std::vector<char>& chunk,uint32_t filtermask,int64_t chunkbytes)
+{
+  // Filters are applied in reverse order when reading
+  for (int f=static_cast<int>(obj.filters.size())-1;f>=0;f--)
+  {
+    if (filtermask & (1u << f)) continue;
+    const h5filter& filter = obj.filters[f];
+
+    switch (filter.id)
+    {
+      case 1:	// deflate
+        {
+          std::vector<char> dest(static_cast<size_t>(chunkbytes));
+          uLongf destlen = static_cast<uLongf>(chunkbytes);
+          int ret = uncompress(reinterpret_cast<Bytef *>(dest.data()),&destlen,reinterpret_cast<const Bytef *>(chunk.data()),static_cast<uLong>(chunk.size()));
+          if ((ret != Z_OK)||(static_cast<int64_t>(destlen) != chunkbytes)) throw compression_error();
+          chunk.swap(dest);
+        }
+        break;
+      case 2:	// shuffle, the bytes of the elements were grouped by significance
+        {
+          size_t elsize = filter.values.empty() ? static_cast<size_t>(obj.chunkdims.back()) : filter.values[0];
+          if (elsize <= 1) break;
+          size_t numelem = chunk.size()/elsize;
+          std::vector<char> dest(chunk.size());
+          for (size_t b=0;b<elsize;b++)
+          {
+            const char *src = chunk.data()+b*numelem;
+            for (size_t p=0;p<numelem;p++) dest[p*elsize+b] = src[p];
+          }
+          std::copy(chunk.begin()+numelem*elsize,chunk.end(),dest.begin()+numelem*elsize);
+          chunk.swap(dest);
+        }
+        break;
+      case 3:	// fletcher32, a checksum is appended to the chunk
+        if (chunk.size() < 4) throw compression_error();
+        chunk.resize(chunk.size()-4);
+        break;
+      default:
+        throw compression_error();
+    }
+  }
+}
+
+std::vector<int64_t> matfilehdf5::readreferences(const h5object& obj)
+{
+  if ((obj.type.cls != 7)||(obj.type.size != offsetsize_)) throw unknown_type();
+  int64_t numelem = static_cast<int64_t>(numelements(obj));
+  std::vector<unsigned char> buffer(static_cast<size_t>(numelem*offsetsize_));
+  readdata(obj,reinterpret_cast<char *>(buffer.data()),static_cast<int64_t>(buffer.size()));
+
+  std::vector<int64_t> refs(static_cast<size_t>(numelem));
+  for (int64_t p=0;p<numelem;p++) refs[p] = static_cast<int64_t>(h5uint(&buffer[p*offsetsize_],offsetsize_));
+  return(refs);
+}
+
+void matfilehdf5::swapbytes(char *buffer,int elsize,int64_t size)
+{
+  if (elsize <= 1) return;
+  for (int64_t p=0;p<size;p++) std::reverse(buffer+p*elsize,buffer+(p+1)*elsize);
+}
+
+// Translation into matlabarrays
+
+matfilehdf5::mitype matfilehdf5::converttype(int cls,int size,bool issigned)
+{
+  if (cls == 1)
+  {
+    if (size == 4) return(miSINGLE);
+    if (size == 8) return(miDOUBLE);
+  }
+  else if (cls == 0)
+  {
+    switch (size)
+    {
+      case 1: return(issigned ? miINT8 : miUINT8);
+      case 2: return(issigned ? miINT16 : miUINT16);
+      case 4: return(issigned ? miINT32 : miUINT32);
+      case 8: return(issigned ? miINT64 : miUINT64);
+    }
+  }
+  throw unknown_type();
+}
+
+std::vector<int> matfilehdf5::matlabdims(const h5object& obj)
+{
+  // HDF5 stores arrays in row major order, hence the dimensions are reversed
+  // with respect to Matlab, while the data is in the same order
+  std::vector<int> dims(obj.dims.rbegin(),obj.dims.rend());
+  if (dims.size() == 0) dims.push_back(1);
+  if (dims.size() == 1) dims.push_back(1);
+  return(dims);
+}
+
+void matfilehdf5::readvalues(const h5object& obj,mitype type,bool readnow,matfiledata& preal,matfiledata& pimag)
+{
+  int64_t numelem = static_cast<int64_t>(numelements(obj));
+  bool iscomplex = (obj.type.cls == 6);
+
+  if (!readnow)
+  {
+    preal.clear(); preal.setType(type);
+    if (iscomplex) { pimag.clear(); pimag.setType(type); }
+    return;
+  }
+
+  if (iscomplex)
+  {
+    // Split the interleaved real and imaginary parts
+    int64_t elsize = obj.type.membersize;
+    std::vector<char> buffer(static_cast<size_t>(numelem*obj.type.size));
+    readdata(obj,buffer.data(),static_cast<int64_t>(buffer.size()));
+    preal.newdatabuffer(numelem*elsize,type);
+    pimag.newdatabuffer(numelem*elsize,type);
+    char *real = static_cast<char *>(preal.databuffer());
+    char *imag = static_cast<char *>(pimag.databuffer());
+    for (int64_t p=0;p<numelem;p++)
+    {
+      std::memcpy(real+p*elsize,buffer.data()+p*obj.type.size+obj.type.realoffset,static_cast<size_t>(elsize));
+      std::memcpy(imag+p*elsize,buffer.data()+p*obj.type.size+obj.type.imagoffset,static_cast<size_t>(elsize));
+    }
+    if (obj.type.bigendian)
+    {
+      swapbytes(real,static_cast<int>(elsize),numelem);
+      swapbytes(imag,static_cast<int>(elsize),numelem);
+    }
+  }
+  else
+  {
+    // Read the data straight into the array
+    preal.newdatabuffer(numelem*obj.type.size,type);
+    if (numelem > 0)
+    {
+      readdata(obj,static_cast<char *>(preal.databuffer()),numelem*obj.type.size);
+      if (obj.type.bigendian) swapbytes(static_cast<char *>(preal.databuffer()),obj.type.size,numelem);
+    }
+  }
+}
+
+void matfilehdf5::readnumeric(matlabarray& ma,const h5object& obj,mitype type,int mode)
+{
+  ma.createdensearray(matlabdims(obj),type);
+  if (obj.type.cls == 6) ma.setcomplex(true);
+
+  // Same policy as for version 5 files: only small arrays are read when
+  // asking for the header
+  matfiledata preal = ma.getpreal();
+  matfiledata pimag = ma.getpimag();
+  readvalues(obj,type,(mode == 2)||(numelements(obj) < 10),preal,pimag);
+}
+
+void matfilehdf5::readarray(matlabarray& ma,int64_t address,const std::string& name,int mode)
+{
+  ma.clear();
+
+  h5object obj;
+  readobjectheader(address,obj);
+  const std::string& mclass = obj.matlabclass;
+
+  if (obj.isgroup)
+  {
+    std::vector<std::pair<std::string,int64_t> > members;
+    readgroup(obj,members);
+
+    if (obj.issparse)
+    {
+      // Sparse matrices are groups with the compressed column storage
+      // in the datasets ir, jc and data
+      h5object ir, jc, data;
+      bool hasir = false, hasjc = false, hasdata = false;
+      for (size_t p=0;p<members.size();p++)
+      {
+        if (members[p].first == "ir") { readobjectheader(members[p].second,ir); hasir = true; }
+        else if (members[p].first == "jc") { readobjectheader(members[p].second,jc); hasjc = true; }
+        else if (members[p].first == "data") { readobjectheader(members[p].second,data); hasdata = true; }
+      }
+      if (!hasjc || !jc.hastype) throw invalid_file_format();
+
+      std::vector<int> dims(2);
+      dims[0] = static_cast<int>(obj.sparserows);
+      dims[1] = static_cast<int>(numelements(jc))-1;
+      mitype type = miDOUBLE;
+      if (mclass == "logical") type = miUINT8;
+      if (hasdata && data.hastype) type = (data.type.cls == 6) ? converttype(data.type.membercls,data.type.membersize,data.type.membersigned) : converttype(data.type.cls,data.type.size,data.type.issigned);
+
+      ma.createsparsearray(dims,type);
+      ma.setname(name);
+      if (mclass == "logical") ma.setlogical(true);
+
+      if (hasdata && data.hastype && (data.type.cls == 6)) ma.setcomplex(true);
+
+      matfiledata pcols = ma.getpcols();
+      matfiledata unused;
+      readvalues(jc,converttype(jc.type.cls,jc.type.size,jc.type.issigned),mode == 2,pcols,unused);
+
+      // An all zero matrix has no ir and data datasets
+      if (hasir && hasdata && ir.hastype && data.hastype)
+      {
+        matfiledata prows = ma.getprows();
+        readvalues(ir,converttype(ir.type.cls,ir.type.size,ir.type.issigned),mode == 2,prows,unused);
+        matfiledata preal = ma.getpreal();
+        matfiledata pimag = ma.getpimag();
+        readvalues(data,type,mode == 2,preal,pimag);
+      }
+      return;
+    }
+
+    if ((mclass == "struct")||(mclass.empty()))
+    {
+      std::vector<std::string> fieldnames;
+      std::vector<h5object> fields;
+      for (size_t p=0;p<members.size();p++)
+      {
+        if (members[p].first.empty() || members[p].first[0] == '#') continue;
+        fieldnames.push_back(members[p].first);
+        fields.push_back(h5object());
+        readobjectheader(members[p].second,fields.back());
+      }
+
+      // In a struct array every field is an array of references with one
+      // entry per element, in a 1x1 struct the fields are stored directly
+      int arrayfield = -1;
+      for (size_t f=0;f<fields.size();f++)
+      {
+        if (!fields[f].isgroup && fields[f].hastype && fields[f].type.cls == 7 && fields[f].matlabclass.empty()) { arrayfield = static_cast<int>(f); break; }
+      }
+
+      std::vector<int> dims(2,1);
+      if (arrayfield >= 0) dims = matlabdims(fields[arrayfield]);
+      ma.createstructarray(dims,fieldnames);
+      ma.setname(name);
+
+      if (mode == 0) return;
+      for (size_t f=0;f<fields.size();f++)
+      {
+        int64_t fieldaddress = -1;
+        for (size_t p=0;p<members.size();p++) if (members[p].first == fieldnames[f]) { fieldaddress = members[p].second; break; }
+
+        if (arrayfield >= 0)
+        {
+          std::vector<int64_t> refs = readreferences(fields[f]);
+          int numelem = ma.getnumelements();
+          for (int p=0;p<numelem && p<static_cast<int>(refs.size());p++)
+          {
+            matlabarray sub;
+            readarray(sub,refs[p],"",mode);
+            ma.setfield(p,static_cast<int>(f),sub);
+          }
+        }
+        else
+        {
+          matlabarray sub;
+          readarray(sub,fieldaddress,"",mode);
+          ma.setfield(0,static_cast<int>(f),sub);
+        }
+      }
+      return;
+    }
+
+    // Objects and other classes stored as groups are not supported
+    return;
+  }
+
+  if (!obj.hastype || !obj.hasdataspace) throw invalid_file_format();
+
+  if (obj.isempty)
+  {
+    // The data of an empty array contains its dimensions
+    std::vector<int> dims(2,0);
+    if ((obj.type.cls == 0)&&(numelements(obj) <= 32))
+    {
+      int64_t numelem = static_cast<int64_t>(numelements(obj));
+      std::vector<char> buffer(static_cast<size_t>(numelem*obj.type.size));
+      readdata(obj,buffer.data(),static_cast<int64_t>(buffer.size()));
+      if (obj.type.bigendian) swapbytes(buffer.data(),obj.type.size,numelem);
+      dims.resize(static_cast<size_t>(numelem));
+      for (int64_t p=0;p<numelem;p++) dims[p] = static_cast<int>(h5uint(reinterpret_cast<unsigned char *>(buffer.data())+p*obj.type.size,obj.type.size));
+    }
+
+    if (mclass == "cell") ma.createcellarray(dims);
+    else if (mclass == "struct") ma.createstructarray(dims,std::vector<std::string>());
+    else if (mclass == "char") ma.createstringarray();
+    else
+    {
+      mitype type = miDOUBLE;
+      if (mclass == "single") type = miSINGLE;
+      else if ((mclass == "int8")) type = miINT8;
+      else if ((mclass == "uint8")||(mclass == "logical")) type = miUINT8;
+      else if (mclass == "int16") type = miINT16;
+      else if (mclass == "uint16") type = miUINT16;
+      else if (mclass == "int32") type = miINT32;
+      else if (mclass == "uint32") type = miUINT32;
+      else if (mclass == "int64") type = miINT64;
+      else if (mclass == "uint64") type = miUINT64;
+      ma.createdensearray(dims,type);
+      if (mclass == "logical") ma.setlogical(true);
+    }
+    ma.setname(name);
+    return;
+  }
+
+  if ((mclass == "cell")||((obj.type.cls == 7)&&(mclass.empty())))
+  {
+    ma.createcellarray(matlabdims(obj));
+    ma.setname(name);
+    if (mode == 0) return;
+
+    std::vector<int64_t> refs = readreferences(obj);
+    for (size_t p=0;p<refs.size();p++)
+    {
+      matlabarray sub;
+      readarray(sub,refs[p],"",mode);
+      ma.setcell(static_cast<int>(p),sub);
+    }
+    return;
+  }
+
+  if (mclass == "char")
+  {
+    // Characters are stored as UTF16 code units
+    if (obj.type.cls != 0) throw unknown_type();
+    int64_t numelem = static_cast<int64_t>(numelements(obj));
+    std::vector<char> buffer(static_cast<size_t>(numelem*obj.type.size));
+    readdata(obj,buffer.data(),static_cast<int64_t>(buffer.size()));
+    if (obj.type.bigendian) swapbytes(buffer.data(),obj.type.size,numelem);
+    std::string str(static_cast<size_t>(numelem),' ');
+    for (int64_t p=0;p<numelem;p++) str[p] = static_cast<char>(h5uint(reinterpret_cast<unsigned char *>(buffer.data())+p*obj.type.size,obj.type.size));
+    ma.createstringarray(str);
+    ma.setname(name);
+    return;
+  }
+
+  if ((obj.type.cls == 0)||(obj.type.cls == 1)||(obj.type.cls == 6))
+  {
+    mitype type = (obj.type.cls == 6) ? converttype(obj.type.membercls,obj.type.membersize,obj.type.membersigned) : converttype(obj.type.cls,obj.type.size,obj.type.issigned);
+    readnumeric(ma,obj,type,mode);
+    ma.setname(name);
+    if (mclass == "logical") ma.setlogical(true);
+    return;
+  }
+
+  // Anything else, e.g. function handles, is not supported
+}
+
+void matfilehdf5::getvariables(std::vector<std::string>& names,std::vector<int64_t>& addresses)
+{
+  names.clear();
+  addresses.clear();
+
+  h5object root;
+  readobjectheader(rootaddress_,root);
+  if (!root.isgroup) throw invalid_file_format();
+
+  std::vector<std::pair<std::string,int64_t> > members;
+  readgroup(root,members);
+
+  // Matlab stores the contents of cells and struct arrays in #refs#, these
+  // are not variables
+  for (size_t p=0;p<members.size();p++)
+  {
+    if (members[p].first.empty() || members[p].first[0] == '#') continue;
+    names.push_back(members[p].first);
+    addresses.push_back(members[p].second);
+  }
+}
+
+matlabarray matfilehdf5::getmatlabarray(int64_t address,const std::string& name,int mode)
+{
+  matlabarray ma;
+  readarray(ma,address,name,mode);
+  return(ma);
+}
@@ -0,0 +1,197 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+// NOTE: This MatlabIO file is used in different projects as well. Please, do not
+// make it depend on other scirun code. This way it is easier to maintain matlabIO
+// code among different projects. Thank you.
+
+/*
+* FILE: matfilehdf5.h
+*/
+
+#ifndef CORE_MATLABIO_MATFILEHDF5_H
+#define CORE_MATLABIO_MATFILEHDF5_H 1
+
+/*
+* The matfilehdf5 class reads Matlab 7.3 files. These files consist of a
+* 512 byte Matlab header followed by an HDF5 container. The class is a
+* minimal HDF5 reader that only supports the parts of the format Matlab
+* and the HDF5 library write for Matlab arrays:
+* - superblock versions 0 to 3
+* - version 1 and 2 object headers
+* - groups stored as symbol tables or as compact link messages
+* - compact, contiguous and chunked datasets (version 1 B-tree index)
+* - the deflate, shuffle and fletcher32 filters
+*
+* Matlab stores each variable as a dataset or group in the root group, the
+* class is given by the MATLAB_class attribute. Numeric, logical, char,
+* complex, sparse, cell and struct arrays are translated into matlabarray
+* objects, other classes (function handles, objects) are not supported.
+*/
+
+/*
+* CLASS DESCRIPTION
+* This class is a read only interface to the HDF5 part of a Matlab 7.3 file.
+*
+* MEMORY MODEL
+* Only the object headers of the variables are read when the file is opened.
+* The data of a variable is read from the file when it is requested, chunks
+* are decompressed one at a time directly into the array data.
+*
+* ERROR HANDLING
+* All errors are reported as exceptions described in the matfilebase class.
+*
+* COPYING/ASSIGNMENT
+* Do not copy the object
+*
+* RESOURCE ALLOCATION
+* Files are closed by calling close() or by destroying the object
+*
+*/
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <Core/Matlab/matfilebase.h>
+#include <Core/Matlab/matfiledata.h>
+#include <Core/Matlab/matlabarray.h>
+#include <Core/Matlab/share.h>
+
+namespace SCIRun
+{
+namespace MatlabIO
+{
+
+  class SCISHARE matfilehdf5 : public matfilebase
+  {
+  private:
+
+    // Description of an HDF5 datatype, only the classes used by Matlab
+    // are decoded
+    struct h5type {
+      int      cls;         // HDF5 type class (0 integer, 1 float, 3 string, 6 compound, 7 reference)
+      int      size;        // size of one element in bytes
+      bool     bigendian;
+      bool     issigned;
+      int      realoffset;  // compound (complex) types: offset of the real part
+      int      imagoffset;  // compound (complex) types: offset of the imaginary part
+      int      membersize;  // compound (complex) types: size of the real and imaginary part
+      int      membercls;   // compound (complex) types: class of the real and imaginary part
+      bool     membersigned;
+    };
+
+    struct h5filter {
+      int id;
+      std::vector<uint32_t> values;
+    };
+
+    // The parts of an object header that are needed to read a dataset or group
+    struct h5object {
+      bool     isgroup;
+      int64_t  btreeaddress;   // symbol table of an old style group
+      int64_t  heapaddress;
+      std::vector<std::pair<std::string,int64_t> > links;  // links of a new style group
+      bool     denselinks;     // new style group with its links in a fractal heap
+
+      std::vector<uint64_t> dims;   // dataspace, in HDF5 (row major) order
+      bool     hasdataspace;
+      h5type   type;
+      bool     hastype;
+
+      int      layout;         // 0 compact, 1 contiguous, 2 chunked
+      int64_t  dataaddress;
+      std::vector<char> compactdata;
+      std::vector<uint32_t> chunkdims;   // includes the element size as last dimension
+      std::vector<h5filter> filters;
+
+      std::string matlabclass;  // MATLAB_class attribute
+      bool     issparse;        // has a MATLAB_sparse attribute
+      uint64_t sparserows;
+      bool     isempty;         // MATLAB_empty attribute is set
+    };
+
+    FILE    *fptr_;
+    int64_t  base_;           // file offset of the HDF5 superblock
+    int64_t  flength_;
+    int      offsetsize_;     // size of addresses in the file
+    int      lengthsize_;     // size of lengths in the file
+    int64_t  rootaddress_;    // object header of the root group
+
+    // raw access to the file, addresses are relative to the superblock
+    void h5read(int64_t address,void *buffer,int64_t size);
+    uint64_t h5uint(const unsigned char *ptr,int size);
+    bool h5undefined(uint64_t address,int size);
+
+    // parsing of the HDF5 structures
+    void readsuperblock();
+    void readobjectheader(int64_t address,h5object& obj);
+    void readmessages(const std::vector<unsigned char>& block,size_t start,size_t end,bool version2,bool flaggedorder,h5object& obj,std::vector<std::pair<int64_t,int64_t> >& continuations);
+    void readmessage(int type,const unsigned char *msg,size_t size,h5object& obj);
+    size_t readtype(const unsigned char *ptr,size_t size,h5type& type);
+    void readdataspace(const unsigned char *ptr,size_t size,std::vector<uint64_t>& dims);
+    void readattribute(const unsigned char *msg,size_t size,h5object& obj);
+    void readgroup(const h5object& obj,std::vector<std::pair<std::string,int64_t> >& members);
+    void readsymboltable(int64_t btreeaddress,const std::vector<char>& heap,std::vector<std::pair<std::string,int64_t> >& members);
+
+    // reading dataset contents
+    uint64_t numelements(const h5object& obj);
+    void readdata(const h5object& obj,char *buffer,int64_t bytesize);
+    void readchunks(int64_t btreeaddress,const h5object& obj,char *buffer,int64_t bytesize);
+    void decodechunk(const h5object& obj,std::vector<char>& chunk,uint32_t filtermask,int64_t chunkbytes);
+    std::vector<int64_t> readreferences(const h5object& obj);
+    void swapbytes(char *buffer,int elsize,int64_t size);
+
+    // translation into matlabarrays
+    mitype converttype(int cls,int size,bool issigned);
+    std::vector<int> matlabdims(const h5object& obj);
+    void readvalues(const h5object& obj,mitype type,bool readnow,matfiledata& preal,matfiledata& pimag);
+    void readnumeric(matlabarray& ma,const h5object& obj,mitype type,int mode);
+    void readarray(matlabarray& ma,int64_t address,const std::string& name,int mode);
+
+  public:
+    matfilehdf5();
+    virtual ~matfilehdf5();
+
+    // Open the HDF5 part of a Matlab 7.3 file, only read access is supported
+    void open(const std::string& filename);
+    void close();
+
+    // names and object header addresses of the variables in the root group
+    void getvariables(std::vector<std::string>& names,std::vector<int64_t>& addresses);
+
+    // Read a variable, mode has the same meaning as in matlabfile:
+    // 0 reads the header of the top level array only
+    // 1 reads the headers of the array and its sub arrays
+    // 2 reads everything
+    matlabarray getmatlabarray(int64_t address,const std::string& name,int mode);
+  };
+
+}}
+
+#endif
@@ -57,66 +57,93 @@ void matlabfile::open(const std::string& filename,const std::string& accessmode)
 {
   matfile::open(filename,accessmode);
 
+  matrixaddress_.clear();
+  matrixname_.clear();
+  hdf5_.reset();
+
   if (isreadaccess())
-  {   // scan the file for the number of matrices
+  {
+    if (ishdf5())
+    {
+      // Matlab 7.3 file, the arrays are stored in an HDF5 container
+      hdf5_.reset(new matfilehdf5);
+      hdf5_->open(filename);
+      hdf5_->getvariables(matrixname_,matrixaddress_);
+      return;
+    }
+
+    // scan the file for the number of matrices
     // This function will index the file and get all the matrix names
-    // If it is a compressed file, it will automatically uncompress every
-    // block (this behavior may be changed to become more memory efficient)
+    // Of a compressed matrix only the start of the block, which contains
+    // the header of the matrix, is decompressed. The data itself is
+    // decompressed when the matrix is requested.
 
-    int tagptr;
+    int64_t tagptr;
     matfiledata mfd;
-    std::stack<int> ptrstack;
-    std::stack<std::string> strstack;
-    bool compressedmatrix = false;
 
     tagptr = firsttag();
     while(tagptr)
     {
       readtag(mfd);
 
-      // Bug fix, this bool was not reset
-      compressedmatrix = false;
-      // If the tag tells that the next block is compressed
-      // Open this compressed block before continuing
+      std::string name;
       if (mfd.type() == miCOMPRESSED)
       {
-        compressedmatrix = true; // to mark that we have to close the compressed session
-        opencompression(); // uncompress the data
-        readtag(mfd); // read the first tag, which should be miMATRIX
+        try
+        {
+          peekcompression(512);
+          name = importmatlabarrayname();
+          closecompression();
+        }
+        catch (io_error&)
+        {
+          // The header did not fit, decompress the whole block instead
+          rewind();
+          gototag(tagptr);
+          readtag(mfd);
+          opencompression();
+          name = importmatlabarrayname();
+          closecompression();
+        }
+      }
+      else
+      {
+        name = importmatlabarrayname();
       }
-      if (mfd.type() != miMATRIX) throw invalid_file_format();
-
-      openchild();
-      readtag(mfd);
-      nexttag();
-      readtag(mfd);
-      nexttag();
-      readdat(mfd);
-      closechild();
-      if (compressedmatrix) closecompression();
 
-      strstack.push(mfd.getstring());
-      ptrstack.push(tagptr);
+      matrixname_.push_back(name);
+      matrixaddress_.push_back(tagptr);
       tagptr = nexttag();
     }
 
-    matrixaddress_.resize(ptrstack.size());
-    matrixname_.resize(strstack.size());
-    for (int p=static_cast<int>(ptrstack.size()-1);p>=0;p--)
-    {
-      matrixaddress_[p] = ptrstack.top();
-      ptrstack.pop();
-      matrixname_[p] = strstack.top();
-      strstack.pop();
-    }
-
     rewind();
   }
 }
 
+std::string matlabfile::importmatlabarrayname()
+{
+  // read the name of the matrix at the current position, the
+  // first three tags are the class, the dimensions and the name
+  matfiledata mfd;
+
+  readtag(mfd);
+  if (mfd.type() != miMATRIX) throw invalid_file_format();
+
+  openchild();
+  readtag(mfd);
+  nexttag();
+  readtag(mfd);
+  nexttag();
+  readdat(mfd);
+  closechild();
+
+  return(mfd.getstring());
+}
+
 
 void matlabfile::close()
 {
+  hdf5_.reset();
   matfile::close();
 }
 
@@ -418,7 +445,7 @@ void matlabfile::importmatlabarray(matlabarray& matrix,int mode)
   matrixdims.getandcastvector(dims);
   std::string name = matrixname.getstring();
 
-  int numelems = 1;
+  int64_t numelems = 1;
   for (size_t p = 0; p < dims.size(); p ++) numelems *= dims[p];
 
   // All matrices contain the data pieces read so far
@@ -621,121 +648,65 @@ int matlabfile::getnummatlabarrays()
   return(static_cast<int>(matrixaddress_.size()));
 }
 
+int matlabfile::findmatlabarray(const std::string& matrixname)
+{
+  for (int p=0;p<static_cast<int>(matrixname_.size());p++)
+  {
+    if (matrixname_[p] == matrixname) return(p);
+  }
+  throw out_of_range();
+}
 
-matlabarray matlabfile::getmatlabarrayshortinfo(int matrixindex)
+matlabarray matlabfile::loadmatlabarray(int matrixindex,int mode)
 {
   if (iswriteaccess()) throw invalid_file_access();
-  if (matrixindex >= static_cast<int>(matrixaddress_.size())) throw out_of_range();
+  if ((matrixindex < 0)||(matrixindex >= static_cast<int>(matrixaddress_.size()))) throw out_of_range();
+
+  if (hdf5_) return(hdf5_->getmatlabarray(matrixaddress_[matrixindex],matrixname_[matrixindex],mode));
 
+  // Go straight to the matrix using the index built when opening the file
   matlabarray ma;
   rewind();
   if (!gototag(matrixaddress_[matrixindex]))
   {
-    std::cerr << "internal error in getmatlabarrayshortinfo()\n";
+    std::cerr << "internal error in loadmatlabarray()\n";
     throw internal_error();
   }
-  importmatlabarray(ma,0);
+  importmatlabarray(ma,mode);
   return(ma);
 }
 
+matlabarray matlabfile::getmatlabarrayshortinfo(int matrixindex)
+{
+  return(loadmatlabarray(matrixindex,0));
+}
 
 matlabarray matlabfile::getmatlabarrayshortinfo(const std::string& matrixname)
 {
   if (iswriteaccess()) throw invalid_file_access();
-  int matrixindex = -1;
-  for (int p=0;p<static_cast<int>(matrixname_.size());p++)
-  {
-    if (matrixname_[p] == matrixname) { matrixindex = p; break; }
-  }
-  if (matrixindex == -1) throw out_of_range();
-
-  matlabarray ma;
-  rewind();
-
-  if (!gototag(matrixaddress_[matrixindex]))
-  {
-    std::cerr << "internal error in getmatlabarrayshortinfo()\n";
-    throw internal_error();
-  }
-  importmatlabarray(ma,0);
-  return(ma);
+  return(loadmatlabarray(findmatlabarray(matrixname),0));
 }
 
 matlabarray matlabfile::getmatlabarrayinfo(int matrixindex)
 {
-  if (iswriteaccess()) throw invalid_file_access();
-  if (matrixindex >= static_cast<int>(matrixaddress_.size())) throw out_of_range();
-
-  matlabarray ma;
-  rewind();
-  if (!gototag(matrixaddress_[matrixindex]))
-  {
-    std::cerr << "internal error in getmatlabarrayinfo()\n";
-    throw internal_error();
-  }
-  importmatlabarray(ma,1);
-  return(ma);
+  return(loadmatlabarray(matrixindex,1));
 }
 
-
 matlabarray matlabfile::getmatlabarrayinfo(const std::string& matrixname)
 {
   if (iswriteaccess()) throw invalid_file_access();
-  int matrixindex = -1;
-  for (int p=0;p<static_cast<int>(matrixname_.size());p++)
-  {
-    if (matrixname_[p] == matrixname) { matrixindex = p; break; }
-  }
-  if (matrixindex == -1) throw out_of_range();
-
-  matlabarray ma;
-  rewind();
-
-  if (!gototag(matrixaddress_[matrixindex]))
-  {
-    std::cerr << "internal error in getmatlabarrayinfo()\n";
-    throw internal_error();
-  }
-  importmatlabarray(ma,1);
-  return(ma);
+  return(loadmatlabarray(findmatlabarray(matrixname),1));
 }
 
 matlabarray matlabfile::getmatlabarray(int matrixindex)
 {
-  if (iswriteaccess()) throw invalid_file_access();
-  if (matrixindex >= static_cast<int>(matrixaddress_.size())) throw out_of_range();
-
-  matlabarray ma;
-  rewind();
-  if (!gototag(matrixaddress_[matrixindex]))
-  {
-    std::cerr << "internal error in getmatlabarray()\n";
-    throw internal_error();
-  }
-  importmatlabarray(ma,2);
-  return(ma);
+  return(loadmatlabarray(matrixindex,2));
 }
 
 matlabarray matlabfile::getmatlabarray(const std::string& matrixname)
 {
   if (iswriteaccess()) throw invalid_file_access();
-  int matrixindex = -1;
-  for (int p=0;p<static_cast<int>(matrixname_.size());p++)
-  {
-    if (matrixname_[p] == matrixname) { matrixindex = p; break; }
-  }
-  if (matrixindex == -1) throw out_of_range();
-
-  matlabarray ma;
-  rewind();
-
-  if (!gototag(matrixaddress_[matrixindex]))
-  {
-    std::cerr << "internal error in getmatlabarray()\n";
-    throw internal_error();
-  }
-  importmatlabarray(ma,2);
-  return(ma);
+  return(loadmatlabarray(findmatlabarray(matrixname),2));
 }
 
 void matlabfile::putmatlabarray(matlabarray& ma,const std::string& matrixname)
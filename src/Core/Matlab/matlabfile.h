@@ -44,6 +44,10 @@
 * MEMORY MODEL
 * The class maintains its own copies of the data. Each vector, string and other
 * data unit is copied.
+* When the file is opened only the headers of the arrays are read to build an
+* index of names and file offsets. The data of an array, and for compressed
+* files the decompression of an array, is only done when it is requested.
+* Matlab 7.3 files are read through the matfilehdf5 class.
 * Large quantities of data are shipped in and out as matlabarray objects. These
 * objects are handles to complex structures in memory and maintain their own data integrity.
 * When copying a matfiledata object only pointers are copied, however all information
@@ -66,7 +70,9 @@
 
 #include <Core/Matlab/matfilebase.h>
 #include <Core/Matlab/matfile.h>
+#include <Core/Matlab/matfilehdf5.h>
 #include <Core/Matlab/share.h>
+#include <memory>
 
 namespace SCIRun
 {
@@ -84,11 +90,19 @@ namespace MatlabIO
 
     // NOTE: These fields are only available for
     // read access
-    std::vector<int> matrixaddress_;
+    // For Matlab 7.3 files the addresses are those of the
+    // HDF5 object headers
+    std::vector<int64_t> matrixaddress_;
     std::vector<std::string> matrixname_;
 
+    // Reader for Matlab 7.3 (HDF5) files
+    std::shared_ptr<matfilehdf5> hdf5_;
+
   private:
     void importmatlabarray(matlabarray& ma,int mode);
+    std::string importmatlabarrayname();
+    int findmatlabarray(const std::string& name);
+    matlabarray loadmatlabarray(int matrixindex,int mode);
     void exportmatlabarray(matlabarray& ma);
     mitype converttype(mxtype type);
     mxtype convertclass(mlclass mclass,mitype type);
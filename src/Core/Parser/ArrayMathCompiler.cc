@@ -0,0 +1,413 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Core/Parser/ArrayMathCompiler.h>
+
+#include <cmath>
+#include <map>
+
+using namespace SCIRun;
+
+namespace {
+
+// Element-wise operations, these compute exactly what the functions in the
+// catalog compute so fusing does not change any result
+
+struct Add  { static double apply(double a, double b) { return (a + b); } };
+struct Sub  { static double apply(double a, double b) { return (a - b); } };
+struct Mult { static double apply(double a, double b) { return (a * b); } };
+struct Div  { static double apply(double a, double b) { return (a / b); } };
+struct Pow  { static double apply(double a, double b) { return (::pow(a,b)); } };
+struct Min  { static double apply(double a, double b) { return (a < b ? a : b); } };
+struct Max  { static double apply(double a, double b) { return (a > b ? a : b); } };
+struct Eq   { static double apply(double a, double b) { return (a == b ? 1.0 : 0.0); } };
+struct Neq  { static double apply(double a, double b) { return (a != b ? 1.0 : 0.0); } };
+struct Le   { static double apply(double a, double b) { return (a <= b ? 1.0 : 0.0); } };
+struct Ge   { static double apply(double a, double b) { return (a >= b ? 1.0 : 0.0); } };
+struct Ls   { static double apply(double a, double b) { return (a < b ? 1.0 : 0.0); } };
+struct Gt   { static double apply(double a, double b) { return (a > b ? 1.0 : 0.0); } };
+struct And  { static double apply(double a, double b) { return ((a != 0.0 && b != 0.0) ? 1.0 : 0.0); } };
+struct Or   { static double apply(double a, double b) { return ((a != 0.0 || b != 0.0) ? 1.0 : 0.0); } };
+
+struct Neg  { static double apply(double a) { return (-a); } };
+struct Inv  { static double apply(double a) { return (1.0/a); } };
+struct Abs  { static double apply(double a) { return (a < 0 ? -a : a); } };
+struct Not  { static double apply(double a) { return (a != 0.0 ? 0.0 : 1.0); } };
+struct Sqrt { static double apply(double a) { return (::sqrt(a)); } };
+struct Exp  { static double apply(double a) { return (::exp(a)); } };
+struct Log  { static double apply(double a) { return (::log(a)); } };
+struct Sin  { static double apply(double a) { return (::sin(a)); } };
+struct Cos  { static double apply(double a) { return (::cos(a)); } };
+struct Tan  { static double apply(double a) { return (::tan(a)); } };
+
+// One loop per operation. The destination may be one of the inputs, which is
+// fine as every element only depends on the same element of the inputs.
+
+template<class OP>
+inline void unary(double* r, const double* a, size_type n)
+{
+  for (size_type i=0; i<n; i++) r[i] = OP::apply(a[i]);
+}
+
+template<class OP>
+inline void binary(double* r, const double* a, const double* b, size_type n)
+{
+  for (size_type i=0; i<n; i++) r[i] = OP::apply(a[i],b[i]);
+}
+
+inline void select(double* r, const double* c, const double* a, const double* b, size_type n)
+{
+  for (size_type i=0; i<n; i++) r[i] = (c[i] != 0.0 ? a[i] : b[i]);
+}
+
+struct OpCodeInfo
+{
+  const char* function_id;
+  ArrayMathFusedKernel::OpCode op;
+};
+
+const OpCodeInfo opcodes[] =
+{
+  { "add$S:S",      ArrayMathFusedKernel::ADD_E },
+  { "sub$S:S",      ArrayMathFusedKernel::SUB_E },
+  { "mult$S:S",     ArrayMathFusedKernel::MULT_E },
+  { "div$S:S",      ArrayMathFusedKernel::DIV_E },
+  { "neg$S",        ArrayMathFusedKernel::NEG_E },
+  { "inv$S",        ArrayMathFusedKernel::INV_E },
+  { "abs$S",        ArrayMathFusedKernel::ABS_E },
+  { "sqrt$S",       ArrayMathFusedKernel::SQRT_E },
+  { "exp$S",        ArrayMathFusedKernel::EXP_E },
+  { "log$S",        ArrayMathFusedKernel::LOG_E },
+  { "ln$S",         ArrayMathFusedKernel::LOG_E },
+  { "pow$S:S",      ArrayMathFusedKernel::POW_E },
+  { "sin$S",        ArrayMathFusedKernel::SIN_E },
+  { "cos$S",        ArrayMathFusedKernel::COS_E },
+  { "tan$S",        ArrayMathFusedKernel::TAN_E },
+  { "min$S:S",      ArrayMathFusedKernel::MIN_E },
+  { "max$S:S",      ArrayMathFusedKernel::MAX_E },
+  { "eq$S:S",       ArrayMathFusedKernel::EQ_E },
+  { "neq$S:S",      ArrayMathFusedKernel::NEQ_E },
+  { "le$S:S",       ArrayMathFusedKernel::LE_E },
+  { "ge$S:S",       ArrayMathFusedKernel::GE_E },
+  { "ls$S:S",       ArrayMathFusedKernel::LS_E },
+  { "gt$S:S",       ArrayMathFusedKernel::GT_E },
+  { "and$S:S",      ArrayMathFusedKernel::AND_E },
+  { "or$S:S",       ArrayMathFusedKernel::OR_E },
+  { "not$S",        ArrayMathFusedKernel::NOT_E },
+  { "select$S:S:S", ArrayMathFusedKernel::SELECT_E }
+};
+
+}
+
+ArrayMathFusedKernel::ArrayMathFusedKernel(size_t num_external,
+                                           size_t num_registers,
+                                           size_type buffer_size,
+                                           const std::vector<Instruction>& code) :
+  code_(code),
+  num_external_(num_external),
+  buffer_size_(buffer_size),
+  registers_(num_registers*buffer_size),
+  operands_(num_external+num_registers)
+{
+  for (size_t j=0; j<num_registers; j++)
+    operands_[num_external+j] = &(registers_[j*buffer_size]);
+}
+
+bool
+ArrayMathFusedKernel::get_opcode(const std::string& function_id, OpCode& op)
+{
+  for (size_t j=0; j<sizeof(opcodes)/sizeof(OpCodeInfo); j++)
+  {
+    if (function_id == opcodes[j].function_id)
+    {
+      op = opcodes[j].op;
+      return (true);
+    }
+  }
+  return (false);
+}
+
+int
+ArrayMathFusedKernel::num_args(OpCode op)
+{
+  switch (op)
+  {
+    case NEG_E: case INV_E: case ABS_E: case SQRT_E: case EXP_E: case LOG_E:
+    case SIN_E: case COS_E: case TAN_E: case NOT_E:
+      return (1);
+    case SELECT_E:
+      return (3);
+    default:
+      return (2);
+  }
+}
+
+bool
+ArrayMathFusedKernel::run(ArrayMathProgramCode& pc)
+{
+  const size_type n = pc.get_size();
+  if (n > buffer_size_) return (false);
+
+  for (size_t j=0; j<num_external_; j++)
+  {
+    operands_[j] = pc.get_variable(j);
+    if (!operands_[j]) return (false);
+  }
+
+  double** d = &(operands_[0]);
+  for (const Instruction& c : code_)
+  {
+    double* r = d[c.dst];
+    const double* a = d[c.src[0]];
+    switch (c.op)
+    {
+      case ADD_E:    binary<Add>(r,a,d[c.src[1]],n); break;
+      case SUB_E:    binary<Sub>(r,a,d[c.src[1]],n); break;
+      case MULT_E:   binary<Mult>(r,a,d[c.src[1]],n); break;
+      case DIV_E:    binary<Div>(r,a,d[c.src[1]],n); break;
+      case POW_E:    binary<Pow>(r,a,d[c.src[1]],n); break;
+      case MIN_E:    binary<Min>(r,a,d[c.src[1]],n); break;
+      case MAX_E:    binary<Max>(r,a,d[c.src[1]],n); break;
+      case EQ_E:     binary<Eq>(r,a,d[c.src[1]],n); break;
+      case NEQ_E:    binary<Neq>(r,a,d[c.src[1]],n); break;
+      case LE_E:     binary<Le>(r,a,d[c.src[1]],n); break;
+      case GE_E:     binary<Ge>(r,a,d[c.src[1]],n); break;
+      case LS_E:     binary<Ls>(r,a,d[c.src[1]],n); break;
+      case GT_E:     binary<Gt>(r,a,d[c.src[1]],n); break;
+      case AND_E:    binary<And>(r,a,d[c.src[1]],n); break;
+      case OR_E:     binary<Or>(r,a,d[c.src[1]],n); break;
+      case NEG_E:    unary<Neg>(r,a,n); break;
+      case INV_E:    unary<Inv>(r,a,n); break;
+      case ABS_E:    unary<Abs>(r,a,n); break;
+      case NOT_E:    unary<Not>(r,a,n); break;
+      case SQRT_E:   unary<Sqrt>(r,a,n); break;
+      case EXP_E:    unary<Exp>(r,a,n); break;
+      case LOG_E:    unary<Log>(r,a,n); break;
+      case SIN_E:    unary<Sin>(r,a,n); break;
+      case COS_E:    unary<Cos>(r,a,n); break;
+      case TAN_E:    unary<Tan>(r,a,n); break;
+      case SELECT_E: select(r,a,d[c.src[1]],d[c.src[2]],n); break;
+    }
+  }
+  return (true);
+}
+
+// -------------------------------------------------------------------------
+// Compile the sequential part of a translated program
+
+bool
+ArrayMathCompiler::compile(ParserProgramHandle& pprogram,
+                           ArrayMathProgramHandle& mprogram,
+                           std::string& error)
+{
+  size_t num_functions = pprogram->num_sequential_functions();
+  size_t num_variables = pprogram->num_sequential_variables();
+  size_type buffer_size = mprogram->get_buffer_size();
+  int num_proc = mprogram->get_num_proc();
+
+  ParserScriptFunctionHandle fhandle;
+  ParserScriptVariableHandle vhandle;
+
+  // Find the functions that can be fused and which functions use each variable
+  std::vector<bool> fusable(num_functions,false);
+  std::vector<ArrayMathFusedKernel::OpCode> ops(num_functions,ArrayMathFusedKernel::ADD_E);
+  std::vector<int> outputs(num_functions,-1);
+  std::vector<std::vector<int> > inputs(num_functions);
+  std::vector<size_t> first_use(num_variables,num_functions);
+  std::vector<size_t> last_use(num_variables,0);
+
+  for (size_t j=0; j<num_functions; j++)
+  {
+    pprogram->get_sequential_function(j,fhandle);
+    vhandle = fhandle->get_output_var();
+    outputs[j] = vhandle->get_var_number();
+
+    bool scalar = (vhandle->get_type() == "S");
+    size_t num_input_vars = fhandle->num_input_vars();
+    for (size_t i=0; i<num_input_vars; i++)
+    {
+      vhandle = fhandle->get_input_var(i);
+      std::string type = vhandle->get_type();
+      int inum = vhandle->get_var_number();
+      inputs[j].push_back(inum);
+      if (type != "S") scalar = false;
+      // Fields, meshes and matrices are not buffers of the sequential part
+      if (type != "S" && type != "V" && type != "T") continue;
+      if (inum < 0 || static_cast<size_t>(inum) >= num_variables)
+      {
+        error = "INTERNAL ERROR - Sequential variable is out of range.";
+        return (false);
+      }
+      if (first_use[inum] == num_functions) first_use[inum] = j;
+      last_use[inum] = j;
+    }
+
+    fusable[j] = scalar &&
+      ArrayMathFusedKernel::get_opcode(fhandle->get_function()->get_function_id(),ops[j]) &&
+      static_cast<int>(num_input_vars) == ArrayMathFusedKernel::num_args(ops[j]);
+  }
+
+  std::vector<std::vector<ArrayMathProgramCodePtr> > code(num_proc);
+  std::vector<size_t> lines;
+
+  size_t j = 0;
+  while (j < num_functions)
+  {
+    size_t end = j;
+    while (end < num_functions && fusable[end]) end++;
+
+    // A single function is not worth a kernel
+    if (end - j < 2)
+    {
+      if (end == j) end = j+1;
+      for (; j<end; j++)
+      {
+        for (int np=0; np<num_proc; np++)
+          code[np].push_back(mprogram->get_sequential_program_code(j,np));
+        lines.push_back(j);
+      }
+      continue;
+    }
+
+    // Results that are only used inside the run live in registers, everything
+    // else is read from or written to the buffers of the program
+    std::map<int,int> external;
+    std::vector<int> external_vars;
+    std::map<int,int> reg;
+    std::vector<int> free_registers;
+    int num_registers = 0;
+
+    std::vector<bool> internal(end-j);
+    for (size_t k=j; k<end; k++)
+    {
+      int v = outputs[k];
+      internal[k-j] = first_use[v] > k && first_use[v] < end && last_use[v] < end;
+    }
+
+    std::vector<ArrayMathFusedKernel::Instruction> instructions;
+    for (size_t k=j; k<end; k++)
+    {
+      ArrayMathFusedKernel::Instruction c;
+      c.op = ops[k];
+      c.src[0] = c.src[1] = c.src[2] = 0;
+
+      for (size_t i=0; i<inputs[k].size(); i++)
+      {
+        int v = inputs[k][i];
+        std::map<int,int>::iterator rit = reg.find(v);
+        if (rit != reg.end())
+        {
+          c.src[i] = -1 - (*rit).second;
+        }
+        else
+        {
+          std::map<int,int>::iterator eit = external.find(v);
+          if (eit == external.end())
+          {
+            eit = external.insert(std::make_pair(v,static_cast<int>(external_vars.size()))).first;
+            external_vars.push_back(v);
+          }
+          c.src[i] = (*eit).second;
+        }
+      }
+
+      // Registers whose value is read for the last time can be reused by the
+      // output of this instruction
+      for (size_t i=0; i<inputs[k].size(); i++)
+      {
+        int v = inputs[k][i];
+        std::map<int,int>::iterator rit = reg.find(v);
+        if (rit != reg.end() && last_use[v] == k)
+        {
+          free_registers.push_back((*rit).second);
+          reg.erase(rit);
+        }
+      }
+
+      int v = outputs[k];
+      if (internal[k-j])
+      {
+        int r;
+        if (free_registers.empty()) { r = num_registers; num_registers++; }
+        else { r = free_registers.back(); free_registers.pop_back(); }
+        reg[v] = r;
+        c.dst = -1 - r;
+      }
+      else
+      {
+        std::map<int,int>::iterator eit = external.find(v);
+        if (eit == external.end())
+        {
+          eit = external.insert(std::make_pair(v,static_cast<int>(external_vars.size()))).first;
+          external_vars.push_back(v);
+        }
+        c.dst = (*eit).second;
+      }
+      instructions.push_back(c);
+    }
+
+    // Registers come after the external buffers
+    int num_external = static_cast<int>(external_vars.size());
+    for (size_t k=0; k<instructions.size(); k++)
+    {
+      ArrayMathFusedKernel::Instruction& c = instructions[k];
+      if (c.dst < 0) c.dst = num_external - 1 - c.dst;
+      for (int i=0; i<3; i++)
+        if (c.src[i] < 0) c.src[i] = num_external - 1 - c.src[i];
+    }
+
+    for (int np=0; np<num_proc; np++)
+    {
+      ArrayMathFusedKernelHandle kernel(new ArrayMathFusedKernel(
+        external_vars.size(),num_registers,buffer_size,instructions));
+      ArrayMathProgramCodePtr pcPtr(new ArrayMathProgramCode(
+        [kernel](ArrayMathProgramCode& pc) { return (kernel->run(pc)); }));
+
+      for (size_t e=0; e<external_vars.size(); e++)
+      {
+        ArrayMathProgramVariableHandle var = mprogram->get_sequential_variable(external_vars[e],np);
+        if (!var)
+        {
+          error = "INTERNAL ERROR - Sequential variable has no buffer.";
+          return (false);
+        }
+        pcPtr->set_variable(e,var->get_data());
+      }
+      code[np].push_back(pcPtr);
+    }
+    lines.push_back(j);
+    j = end;
+  }
+
+  for (int np=0; np<num_proc; np++)
+    mprogram->set_sequential_program(np,code[np]);
+  mprogram->set_sequential_lines(lines);
+
+  return (true);
+}
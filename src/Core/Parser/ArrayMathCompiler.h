@@ -0,0 +1,103 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_PARSER_ARRAYMATHCOMPILER_H
+#define CORE_PARSER_ARRAYMATHCOMPILER_H 1
+
+#include <Core/Parser/ArrayMathInterpreter.h>
+
+#include <string>
+#include <vector>
+
+// Include files needed for Windows
+#include <Core/Parser/share.h>
+
+namespace SCIRun {
+
+//-----------------------------------------------------------------------------
+// Fused kernels. A run of element-wise scalar functions in the sequential part
+// of the program is replaced by one kernel that executes them as a list of
+// instructions. Intermediate results that are not needed outside the run are
+// kept in a few registers of buffer size instead of in their own buffers, and
+// each instruction is a tight loop the compiler can vectorize.
+
+class SCISHARE ArrayMathFusedKernel {
+  public:
+    enum OpCode {
+      ADD_E, SUB_E, MULT_E, DIV_E, NEG_E, INV_E, ABS_E, SQRT_E, EXP_E, LOG_E,
+      POW_E, SIN_E, COS_E, TAN_E, MIN_E, MAX_E, EQ_E, NEQ_E, LE_E, GE_E, LS_E,
+      GT_E, AND_E, OR_E, NOT_E, SELECT_E
+    };
+
+    // Operands below the number of external buffers refer to the variables
+    // of the program code, the others to registers
+    struct Instruction {
+      OpCode op;
+      int    dst;
+      int    src[3];
+    };
+
+    ArrayMathFusedKernel(size_t num_external, size_t num_registers,
+                         size_type buffer_size,
+                         const std::vector<Instruction>& code);
+
+    // Find the instruction for a function of the catalog, returns false if the
+    // function can not be fused
+    static bool get_opcode(const std::string& function_id, OpCode& op);
+
+    // Number of inputs of an instruction
+    static int num_args(OpCode op);
+
+    // Run the kernel on the current part of the sequence
+    bool run(ArrayMathProgramCode& pc);
+
+  private:
+    std::vector<Instruction> code_;
+    size_t num_external_;
+    size_type buffer_size_;
+
+    // Registers of buffer size, each kernel belongs to one thread
+    std::vector<double> registers_;
+    std::vector<double*> operands_;
+};
+
+typedef SharedPointer<ArrayMathFusedKernel> ArrayMathFusedKernelHandle;
+
+class SCISHARE ArrayMathCompiler {
+  public:
+    // Replace runs of element-wise scalar functions in the sequential part of
+    // a translated program by fused kernels
+    static bool compile(ParserProgramHandle& pprogram,
+                        ArrayMathProgramHandle& mprogram,
+                        std::string& error);
+};
+
+}
+
+#endif
@@ -65,15 +65,8 @@ bool get_scalar_fd(ArrayMathProgramCode& pc)
   // Safety check (this one is inline, hence it should be fast)
   if (!(data1->is_scalar())) return (false);
 
-  double* data0_end = data0 + pc.get_size();
-  VMesh::index_type idx = pc.get_index();
-
-  double val;
-  while(data0 != data0_end)
-  {
-    data1->get_value(val,idx); idx++;
-    *data0 = val; data0++;
-  }
+  // One virtual call per buffer instead of one per value
+  data1->get_values(data0,pc.get_size(),pc.get_index());
 
   return (true);
 }
@@ -555,13 +548,7 @@ bool to_fielddata_s(ArrayMathProgramCode& pc)
   // Safety check to see whether the output format is OK
   if (!(data0->is_scalar())) return (false);
 
-  double* data1_end = data1 + (pc.get_size());
-  index_type idx = pc.get_index();
-
-  while (data1 != data1_end)
-  {
-    data0->set_value(*data1,idx); idx++; data1++;
-  }
+  data0->set_values(data1,pc.get_size(),pc.get_index());
 
   return (true);
 }
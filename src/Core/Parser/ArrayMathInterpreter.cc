@@ -28,6 +28,7 @@
 
 #include <Core/Parser/ArrayMathInterpreter.h>
 #include <Core/Parser/ArrayMathFunctionCatalog.h>
+#include <Core/Parser/ArrayMathCompiler.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
@@ -1187,7 +1188,8 @@ ArrayMathInterpreter::translate(ParserProgramHandle& pprogram,
     }
   }
 
-  return (true);
+  // Fuse the element-wise parts of the sequential code
+  return (ArrayMathCompiler::compile(pprogram,mprogram,error));
 }
 
 bool
@@ -1521,6 +1523,7 @@ ArrayMathProgram::run_sequential(size_t& error_line)
     if (!success_[j])
     {
       error_line = error_line_[j];
+      if (error_line < sequential_lines_.size()) error_line = sequential_lines_[error_line];
       return (false);
     }
   }
@@ -408,6 +408,19 @@ class SCISHARE ArrayMathProgramSource {
     void set_sequential_program_code(size_t j, size_t np, ArrayMathProgramCodePtr pc)
       { sequential_functions_[np][j] = pc; }
 
+    ArrayMathProgramCodePtr get_sequential_program_code(size_t j, size_t np) const
+      { return (sequential_functions_[np][j]); }
+    size_t num_sequential_program_codes() const
+      { return (sequential_functions_.empty() ? 0 : sequential_functions_[0].size()); }
+
+    // Replace the sequential code of one thread once it has been compiled.
+    // Lines gives for each code segment the first function of the parser
+    // program it evaluates, so errors can still be traced back to the script
+    void set_sequential_program(size_t np, const std::vector<ArrayMathProgramCodePtr>& code)
+      { sequential_functions_[np] = code; }
+    void set_sequential_lines(const std::vector<size_t>& lines)
+      { sequential_lines_ = lines; }
+
     // Code to find the pointers that are given for sources and sinks
     bool find_source(const std::string& name,  ArrayMathProgramSource& ps);
     bool find_sink(const std::string& name,  ArrayMathProgramSource& ps);
@@ -445,6 +458,7 @@ class SCISHARE ArrayMathProgramSource {
     std::vector<ArrayMathProgramCodePtr> const_functions_;
     std::vector<ArrayMathProgramCodePtr> single_functions_;
     std::vector<std::vector<ArrayMathProgramCodePtr> > sequential_functions_;
+    std::vector<size_t> sequential_lines_;
 
     ParserProgramHandle pprogram_;
 
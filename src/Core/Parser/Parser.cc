@@ -2657,11 +2657,14 @@ Parser::optimize(ParserProgramHandle program,
 
 
   // Phase 5: Remove duplicate expressions
+  // Expressions are keyed on their dependence string, so each one is compared
+  // against all the earlier ones in a single lookup
 
   fit = functions.begin();
   fit_end = functions.end();
 
-  std::string dependence, dependence2;
+  std::string dependence;
+  std::map<std::string,ParserScriptVariableHandle> computed;
 
   while (fit != fit_end)
   {
@@ -2669,46 +2672,44 @@ Parser::optimize(ParserProgramHandle program,
     handle->compute_dependence();
     dependence = handle->get_dependence();
 
-    fit2 = functions.begin();
-    while (fit2 != fit)
+    std::map<std::string,ParserScriptVariableHandle>::iterator dit = computed.find(dependence);
+    if (dit == computed.end())
     {
-      ParserScriptVariableHandle nhandle = (*fit2)->get_output_var();
-
-      dependence2 = nhandle->get_dependence();
-      if (dependence2 == dependence)
+      computed[dependence] = handle;
+    }
+    else
+    {
+      // The handle with which the ones in the script need to be replaced
+      ParserScriptVariableHandle nhandle = (*dit).second;
+      // Expressions are equal
+      // Clear dependence, clear flags
+      handle->clear_dependence();
+      // Clear the used flag for this variable
+      handle->clear_flags();
+      ParserScriptFunctionHandle fhandle = handle->get_parent();
+      if (!fhandle)
       {
-        // The handle with which the ones in the script need to be replaced
-        // Expressions are equal
-        // Clear dependence, clear flags
-        handle->clear_dependence();
-        // Clear the used flag for this variable
-        handle->clear_flags();
-        ParserScriptFunctionHandle fhandle = handle->get_parent();
-        if (!fhandle)
-        {
-          error = "INTERNAL ERROR -  Duplicate input variable.";
-          return (false);
-        }
-        // Clear the function that computes the variable
-        fhandle->clear_flags();
-        std::list<ParserScriptFunctionHandle>::iterator hit, hit_end;
-        hit = functions.begin();
-        hit_end = functions.end();
-        while (hit != hit_end)
+        error = "INTERNAL ERROR -  Duplicate input variable.";
+        return (false);
+      }
+      // Clear the function that computes the variable
+      fhandle->clear_flags();
+      std::list<ParserScriptFunctionHandle>::iterator hit, hit_end;
+      hit = functions.begin();
+      hit_end = functions.end();
+      while (hit != hit_end)
+      {
+        ParserScriptFunctionHandle hhandle = (*hit);
+        size_t num_input_vars = hhandle->num_input_vars();
+        for (size_t j=0; j<num_input_vars;j++)
         {
-          ParserScriptFunctionHandle hhandle = (*hit);
-          size_t num_input_vars = hhandle->num_input_vars();
-          for (size_t j=0; j<num_input_vars;j++)
+          if (hhandle->get_input_var(j) == handle)
           {
-            if (hhandle->get_input_var(j) == handle)
-            {
-              hhandle->set_input_var(j,nhandle);
-            }
+            hhandle->set_input_var(j,nhandle);
           }
-          ++hit;
         }
+        ++hit;
       }
-      ++fit2;
     }
     ++fit;
   }
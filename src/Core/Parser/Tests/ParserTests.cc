@@ -1577,6 +1577,61 @@ TEST_F(BasicParserTests, CreateFieldData_fracanisotropy)
 
 */
 
+TEST_F(BasicParserTests, CreateFieldData_FusedExpressionMatchesElementwise)
+{
+  // Large enough for several buffers per thread, so every chunk runs through
+  // the fused kernels
+  FieldHandle field(CreateEmptyLatVol(20,20,20));
+
+  NewArrayMathEngine engine;
+  setupEngine(engine, field);
+
+  std::string function =
+    "A = X*Y + Z; B = sqrt(A*A + 1) - abs(Z)/(2 + X*X);"
+    "RESULT = select(A > 0, B*B + A, min(X,Y) - exp(-A*A)) + max(B, 0.5);";
+  ASSERT_TRUE(engine.add_expressions(function));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+
+  auto vmesh = ofield->vmesh();
+  auto vfield = ofield->vfield();
+  for (VMesh::Node::index_type idx = 0; idx < vmesh->num_nodes(); ++idx)
+  {
+    Point p;
+    vmesh->get_center(p, idx);
+    const double x = p.x(), y = p.y(), z = p.z();
+    const double a = x*y + z;
+    const double b = ::sqrt(a*a + 1) - ::fabs(z)/(2 + x*x);
+    const double expected = (a > 0 ? b*b + a : (x < y ? x : y) - ::exp(-a*a)) + (b > 0.5 ? b : 0.5);
+    double value;
+    vfield->get_value(value, idx);
+    ASSERT_DOUBLE_EQ(expected, value) << " at node " << idx;
+  }
+}
+
+TEST_F(BasicParserTests, CreateFieldData_DuplicateSubexpressionsAreShared)
+{
+  FieldHandle field(CreateEmptyLatVol());
+
+  NewArrayMathEngine engine;
+  setupEngine(engine, field);
+
+  std::string function = "RESULT = (X+Y)*(Y+X) - (X+Y)*(X+Y);";
+  ASSERT_TRUE(engine.add_expressions(function));
+  ASSERT_TRUE(engine.run());
+
+  FieldHandle ofield;
+  engine.get_field("RESULT",ofield);
+  ASSERT_THAT(ofield, NotNull());
+  double min, max;
+  ofield->vfield()->minmax(min,max);
+  EXPECT_EQ(0, min);
+  EXPECT_EQ(0, max);
+}
+
 TEST(FieldHashTests, TestShiftingZero)
 {
   // copied from TetVolMesh.h, failing compilation on GCC 6.2.
@@ -46,6 +46,7 @@
 #include <map>
 #include <string>
 #include <complex>
+#include <type_traits>
 #include <Core/Utils/SmartPointers.h>
 
 // for index and size types
@@ -178,6 +179,9 @@ class SCISHARE Piostream {
 
     // Returns true if block_io was supported (even on error).
     virtual bool block_io(void*, size_t, size_t) { return false; }
+    // True if values read through this stream change byte order, block_io
+    // then only works on blocks of scalars.
+    virtual bool swaps_bytes() const { return false; }
 
     void disable_pointer_hashing() { disable_pointer_hashing_ = true; }
 
@@ -294,10 +298,20 @@ void Pio2(Piostream& stream, SharedPointer<T>& data, typename boost::enable_if<t
   stream.end_cheap_delim();
 }
 
+/// Moves nmemb values of type T through block_io. Streams that swap byte
+/// order can only do that for scalars, records such as Vector, Tensor or
+/// std::complex are left to their per-element Pio.
+template<class T>
+bool Pio_block(Piostream& stream, T* data, size_t nmemb)
+{
+  if (!std::is_arithmetic<T>::value && stream.swaps_bytes()) return false;
+  return stream.block_io(data, sizeof(T), nmemb);
+}
+
 template<class T>
 void Pio(Piostream& stream, T* data, size_type sz)
 {
-  if (!stream.block_io(data, sizeof(T), sz))
+  if (!Pio_block(stream, data, sz))
   {
     for (index_type i=0;i<sz;i++)
       stream.io(data[i]);
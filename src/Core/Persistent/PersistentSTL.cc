@@ -104,7 +104,7 @@ namespace SCIRun {
       data.resize(size);
     }
 
-    if (data.size() && !stream.block_io(&data.front(), sizeof(T), data.size()))
+    if (data.size() && !Pio_block(stream, &data.front(), data.size()))
     {
       for (int i = 0; i < size; i++)
       {
@@ -171,6 +171,41 @@ void Pio(Piostream& stream, std::vector<T>& data)
   stream.end_class();
 }
 
+/// Vectors of records made of N packed scalars (points, vectors) use the
+/// same layout as the generic version, but streams with block io read and
+/// write the whole array at once instead of one scalar at a time.
+template <class T, class Scalar, size_t N>
+void Pio_records(Piostream& stream, std::vector<T>& data)
+{
+  static_assert(sizeof(T) == N * sizeof(Scalar), "record must consist of N packed scalars");
+
+  if (stream.reading() && stream.peek_class() == "Array1")
+  {
+    stream.begin_class("Array1", STLVECTOR_VERSION);
+  }
+  else
+  {
+    stream.begin_class("STLVector", STLVECTOR_VERSION);
+  }
+
+  int size=static_cast<int>(data.size());
+  stream.io(size);
+
+  if(stream.reading()){
+    data.resize(size);
+  }
+
+  if (size > 0 && !stream.block_io(data.data(), sizeof(Scalar), N * data.size()))
+  {
+    for (int i = 0; i < size; i++)
+    {
+      Pio(stream, data[i]);
+    }
+  }
+
+  stream.end_class();
+}
+
 template <class T>
 void Pio(Piostream& stream, std::vector<T*>& data)
 {
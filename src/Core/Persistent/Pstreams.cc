@@ -57,9 +57,13 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <fcntl.h>
+#include <algorithm>
+#include <cstdint>
 
 #ifdef _WIN32
 #  include <io.h>
+#else
+#  include <sys/mman.h>
 #endif
 
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -71,6 +75,104 @@ using namespace SCIRun::Core::Logging;
 
 namespace SCIRun {
 
+namespace detail
+{
+class MappedFile
+{
+public:
+  /// Maps the regular file behind fp; reading starts at fp's current offset.
+  /// Returns null if the file cannot be mapped, and the caller keeps using fp.
+  static std::unique_ptr<MappedFile> open(FILE* fp)
+  {
+#ifndef _WIN32
+    if (!fp)
+      return nullptr;
+    const int fd = fileno(fp);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0)
+      return nullptr;
+    const auto size = static_cast<size_t>(info.st_size);
+    void* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED)
+      return nullptr;
+    madvise(data, size, MADV_SEQUENTIAL);
+    const long pos = ftell(fp);
+    return std::unique_ptr<MappedFile>(new MappedFile(static_cast<const char*>(data), size, pos > 0 ? pos : 0));
+#else
+    return nullptr;
+#endif
+  }
+
+  ~MappedFile()
+  {
+#ifndef _WIN32
+    munmap(const_cast<char*>(data_), size_);
+#endif
+  }
+
+  /// Same contract as fread: returns the number of whole items copied.
+  size_t read(void* data, size_t size, size_t nmemb)
+  {
+    if (size == 0)
+      return 0;
+    const size_t items = std::min(nmemb, (size_ - pos_) / size);
+    memcpy(data, data_ + pos_, items * size);
+    pos_ += items * size;
+    return items;
+  }
+
+  void seek(size_t pos) { pos_ = std::min(pos, size_); }
+  bool eof() const { return pos_ >= size_; }
+
+private:
+  MappedFile(const char* data, size_t size, size_t pos) : data_(data), size_(size), pos_(std::min(pos, size)) {}
+  const char* data_;
+  size_t size_;
+  size_t pos_;
+};
+
+namespace
+{
+  // Written with shifts so that compilers emit bswap and vectorize the loops below.
+  inline uint16_t byteswap(uint16_t v) { return static_cast<uint16_t>((v >> 8) | (v << 8)); }
+  inline uint32_t byteswap(uint32_t v)
+  {
+    return ((v & 0x000000ffu) << 24) | ((v & 0x0000ff00u) << 8) | ((v & 0x00ff0000u) >> 8) | ((v & 0xff000000u) >> 24);
+  }
+  inline uint64_t byteswap(uint64_t v)
+  {
+    return (static_cast<uint64_t>(byteswap(static_cast<uint32_t>(v))) << 32) | byteswap(static_cast<uint32_t>(v >> 32));
+  }
+
+  template <class T>
+  void swap_block(unsigned char* bytes, size_t nmemb)
+  {
+    for (size_t i = 0; i < nmemb; ++i, bytes += sizeof(T))
+    {
+      T v;
+      memcpy(&v, bytes, sizeof(T));
+      v = byteswap(v);
+      memcpy(bytes, &v, sizeof(T));
+    }
+  }
+}
+
+void swap_bytes(void* data, size_t size, size_t nmemb)
+{
+  auto bytes = static_cast<unsigned char*>(data);
+  switch (size)
+  {
+  case 1: break;
+  case 2: swap_block<uint16_t>(bytes, nmemb); break;
+  case 4: swap_block<uint32_t>(bytes, nmemb); break;
+  case 8: swap_block<uint64_t>(bytes, nmemb); break;
+  default:
+    for (size_t i = 0; i < nmemb; ++i, bytes += size)
+      std::reverse(bytes, bytes + size);
+  }
+}
+}
+
 // BinaryPiostream -- portable
   BinaryPiostream::BinaryPiostream(const std::string& filename, Direction dir,
     const int& v, LoggerHandle pr)
@@ -115,6 +217,7 @@ namespace SCIRun {
           return;
         }
       }
+      map_ = detail::MappedFile::open(fp_);
     }
     else
     {
@@ -242,9 +345,16 @@ BinaryPiostream::BinaryPiostream(int fd, Direction dir, const int& v,
 
 BinaryPiostream::~BinaryPiostream()
 {
+  map_.reset();
   if (fp_) fclose(fp_);
 }
 
+size_t
+BinaryPiostream::read(void* data, size_t size, size_t nmemb)
+{
+  return map_ ? map_->read(data, size, nmemb) : fread(data, size, nmemb, fp_);
+}
+
 void
 BinaryPiostream::reset_post_header()
 {
@@ -267,6 +377,8 @@ BinaryPiostream::reset_post_header()
     // read header
     fread(hdr, 1, 16, fp_);
   }
+  if (map_)
+    map_->seek(ftell(fp_));
 }
 
 const char *
@@ -283,7 +395,7 @@ BinaryPiostream::gen_io(T& data, const char *iotype)
   if (err) return;
   if (dir==Direction::Read)
   {
-    if (!fread(&data, sizeof(data), 1, fp_))
+    if (!read(&data, sizeof(data), 1))
     {
       err = true;
       reporter_->error(std::string("BinaryPiostream error reading ") +
@@ -530,7 +642,7 @@ BinaryPiostream::io(std::string& data)
         char* buf = new char[buf_size];
 
         // Read in data plus padding.
-        if (!fread(buf, sizeof(char), buf_size, fp_))
+        if (!read(buf, sizeof(char), buf_size))
         {
           err = true;
           delete [] buf;
@@ -546,7 +658,7 @@ BinaryPiostream::io(std::string& data)
     else
     {
       char* buf = new char[chars];
-      fread(buf, sizeof(char), chars, fp_);
+      read(buf, sizeof(char), chars);
       data = std::string(buf);
       delete[] buf;
     }
@@ -560,7 +672,7 @@ BinaryPiostream::block_io(void *data, size_t s, size_t nmemb)
   if (err || version() == 1) { return false; }
   if (dir == Direction::Read)
   {
-    const size_t did = fread(data, s, nmemb, fp_);
+    const size_t did = read(data, s, nmemb);
     if (did != nmemb)
     {
       err = true;
@@ -617,7 +729,7 @@ BinarySwapPiostream::gen_io(T& data, const char *iotype)
   if (dir==Direction::Read)
   {
     unsigned char tmp[sizeof(data)];
-    if (!fread(tmp, sizeof(data), 1, fp_))
+    if (!read(tmp, sizeof(data), 1))
     {
       err = true;
       reporter_->error(std::string("BinaryPiostream error reading ") +
@@ -658,6 +770,39 @@ BinarySwapPiostream::gen_io(T& data, const char *iotype)
 
 
 
+bool
+BinarySwapPiostream::block_io(void *data, size_t s, size_t nmemb)
+{
+  // Only blocks of scalars can be swapped, see Pio_block.
+  if (err || version() == 1) { return false; }
+  if (s != 1 && s != 2 && s != 4 && s != 8) { return false; }
+  if (dir == Direction::Read)
+  {
+    const size_t did = read(data, s, nmemb);
+    if (did != nmemb)
+    {
+      err = true;
+      reporter_->error("BinaryPiostream error reading block io.");
+    }
+    else
+    {
+      detail::swap_bytes(data, s, nmemb);
+    }
+  }
+  else
+  {
+    // Like gen_io, values are written in native order.
+    const size_t did = fwrite(data, s, nmemb, fp_);
+    if (did != nmemb)
+    {
+      err = true;
+      reporter_->error("BinaryPiostream error writing block io.");
+    }
+  }
+  return true;
+}
+
+
 void
 BinarySwapPiostream::io(short& data)
 {
@@ -1743,6 +1888,14 @@ FastPiostream::FastPiostream(const std::string& filename, Direction dir,
       return;
     }
     readHeader(reporter_, filename, hdr, "FAS", version_, file_endian);
+    // Versions > 1 have the endianness (LIT | BIG) as a fourth header line.
+    if (version() > 1 && fread(hdr, sizeof(char), 4, fp_) != 4)
+    {
+      reporter_->error("Error reading header from: " + filename);
+      err = true;
+      return;
+    }
+    map_ = detail::MappedFile::open(fp_);
   }
   else
   {
@@ -1808,6 +1961,13 @@ fp_(nullptr)
       return;
     }
     readHeader(reporter_, "socket", hdr, "FAS", version_, file_endian);
+    if (version() > 1 && fread(hdr, sizeof(char), 4, fp_) != 4)
+    {
+      reporter_->error("Error reading header from socket: " +
+        to_string(fd) + ".");
+      err = true;
+      return;
+    }
   }
   else
   {
@@ -1853,10 +2013,25 @@ fp_(nullptr)
 
 FastPiostream::~FastPiostream()
 {
+  map_.reset();
   if (fp_) fclose(fp_);
 }
 
 
+size_t
+FastPiostream::read(void* data, size_t size, size_t nmemb)
+{
+  return map_ ? map_->read(data, size, nmemb) : fread(data, size, nmemb, fp_);
+}
+
+
+bool
+FastPiostream::at_eof() const
+{
+  return map_ ? map_->eof() : feof(fp_) != 0;
+}
+
+
 void
 FastPiostream::reset_post_header()
 {
@@ -1865,14 +2040,16 @@ FastPiostream::reset_post_header()
   if (version() == 1)
   {
     // Old versions had headers of size 12.
-    fseek(fp_, 13, SEEK_SET);
+    fseek(fp_, 12, SEEK_SET);
   }
   else
   {
     // Versions > 1 have size of 16 to account for endianness in
     // header (LIT | BIG).
-    fseek(fp_, 17, SEEK_SET);
+    fseek(fp_, 16, SEEK_SET);
   }
+  if (map_)
+    map_->seek(ftell(fp_));
 }
 
 
@@ -1885,8 +2062,8 @@ FastPiostream::gen_io(T& data, const char *iotype)
   size_t did = 0;
   if (dir == Direction::Read)
   {
-    did = fread(&data, sizeof(data), 1, fp_);
-    if (expect != did && !feof(fp_))
+    did = read(&data, sizeof(data), 1);
+    if (expect != did && !at_eof())
     {
       err = true;
       reporter_->error(std::string("FastPiostream error reading ") + iotype + ".");
@@ -2016,9 +2193,9 @@ FastPiostream::io(std::string& data)
   }
   if (dir==Direction::Read)
   {
-    fread(&chars, sizeof(unsigned int), 1, fp_);
+    read(&chars, sizeof(unsigned int), 1);
     char* buf = new char[chars];
-    fread(buf, sizeof(char), chars, fp_);
+    read(buf, sizeof(char), chars);
     data=std::string(buf);
     delete[] buf;
   }
@@ -2030,7 +2207,7 @@ FastPiostream::block_io(void *data, size_t s, size_t nmemb)
 {
   if (dir == Direction::Read)
   {
-    const size_t did = fread(data, s, nmemb, fp_);
+    const size_t did = read(data, s, nmemb);
     if (did != nmemb)
     {
       err = true;
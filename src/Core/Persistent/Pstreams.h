@@ -43,15 +43,29 @@
 #include <Core/Persistent/Persistent.h>
 #include <cstdio>
 #include <iosfwd>
+#include <memory>
 
 #include <Core/Persistent/share.h>
 
 namespace SCIRun {
 
+namespace detail
+{
+  /// Read-only memory map of a file opened for reading.
+  class MappedFile;
+
+  /// Reverses the byte order of nmemb values of size bytes each, in place.
+  SCISHARE void swap_bytes(void* data, size_t size, size_t nmemb);
+}
+
 class SCISHARE BinaryPiostream : public Piostream {
 protected:
   FILE* fp_;
+  /// Reads of a named file are served from a memory map when the platform
+  /// allows it, otherwise from fp_.
+  std::unique_ptr<detail::MappedFile> map_;
 
+  size_t read(void* data, size_t size, size_t nmemb);
   virtual const char *endianness();
   void reset_post_header() override;
 private:
@@ -108,8 +122,8 @@ public:
   void io(double&) override;
   void io(float&) override;
 
-  bool supports_block_io() override { return false; }
-  bool block_io(void*, size_t, size_t) override { return false; }
+  bool block_io(void*, size_t, size_t) override;
+  bool swaps_bytes() const override { return true; }
 };
 
 
@@ -162,7 +176,10 @@ public:
 class SCISHARE FastPiostream : public Piostream {
 private:
   FILE* fp_;
+  std::unique_ptr<detail::MappedFile> map_;
 
+  size_t read(void* data, size_t size, size_t nmemb);
+  bool at_eof() const;
   void report_error(const char *);
   template <class T> void gen_io(T&, const char *);
 protected:
@@ -0,0 +1,296 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifdef BUILD_WITH_PYTHON
+
+#include <Core/Python/PythonArrayViews.h>
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Python;
+
+namespace py = boost::python;
+
+namespace
+{
+  struct DatatypeArrayView
+  {
+    PyObject_HEAD
+    std::shared_ptr<const void>* owner;
+    void* data;
+    const char* format;
+    Py_ssize_t itemSize;
+    int ndim;
+    Py_ssize_t shape[2];
+    Py_ssize_t strides[2];
+  };
+
+  int getArrayViewBuffer(PyObject* self, Py_buffer* view, int flags)
+  {
+    auto* array = reinterpret_cast<DatatypeArrayView*>(self);
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE)
+    {
+      PyErr_SetString(PyExc_BufferError, "SCIRun datatype views are read-only; copy the array to modify it.");
+      view->obj = nullptr;
+      return -1;
+    }
+
+    Py_ssize_t count = 1;
+    for (int i = 0; i < array->ndim; ++i)
+      count *= array->shape[i];
+
+    view->obj = self;
+    Py_INCREF(self);
+    view->buf = array->data;
+    view->len = count * array->itemSize;
+    view->readonly = 1;
+    view->itemsize = array->itemSize;
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? const_cast<char*>(array->format) : nullptr;
+    view->ndim = array->ndim;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? array->shape : nullptr;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? array->strides : nullptr;
+    view->suboffsets = nullptr;
+    view->internal = nullptr;
+    return 0;
+  }
+
+  void deallocArrayView(PyObject* self)
+  {
+    delete reinterpret_cast<DatatypeArrayView*>(self)->owner;
+    Py_TYPE(self)->tp_free(self);
+  }
+
+  PyTypeObject* arrayViewType()
+  {
+    static PyBufferProcs bufferProcs = { getArrayViewBuffer, nullptr };
+    static PyTypeObject type = { PyVarObject_HEAD_INIT(nullptr, 0) };
+    if (!type.tp_name)
+    {
+      type.tp_name = "SCIRun.DatatypeArrayView";
+      type.tp_doc = "Read-only buffer over the memory of a SCIRun datatype";
+      type.tp_basicsize = sizeof(DatatypeArrayView);
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+      type.tp_dealloc = deallocArrayView;
+      type.tp_as_buffer = &bufferProcs;
+      if (PyType_Ready(&type) < 0)
+        py::throw_error_already_set();
+    }
+    return &type;
+  }
+
+  std::atomic<bool> arrayViewsEnabled_(true);
+
+  class ScopedBuffer
+  {
+  public:
+    explicit ScopedBuffer(const py::object& object)
+    {
+      if (PyBytes_Check(object.ptr()) || PyByteArray_Check(object.ptr()) || !PyObject_CheckBuffer(object.ptr()))
+        return;
+      if (PyObject_GetBuffer(object.ptr(), &view_, PyBUF_RECORDS_RO) == 0)
+        valid_ = view_.ndim >= 1 && view_.ndim <= 2 && elementCode() != 0;
+      else
+        PyErr_Clear();
+    }
+    ~ScopedBuffer()
+    {
+      if (view_.obj)
+        PyBuffer_Release(&view_);
+    }
+    bool valid() const { return valid_; }
+    const Py_buffer& view() const { return view_; }
+
+    /// Single struct module code of the element type, or 0 if it is not a plain number.
+    char elementCode() const
+    {
+      const char* f = view_.format ? view_.format : "B";
+      if (*f == '@' || *f == '=' || *f == '<')
+        ++f;
+      if (f[0] == 0 || f[1] != 0)
+        return 0;
+      return std::strchr("bBhHiIlLqQnNfd?", f[0]) ? f[0] : 0;
+    }
+  private:
+    Py_buffer view_ {};
+    bool valid_ {false};
+  };
+
+  template <class Out>
+  Out readElement(const char* p, char code, Py_ssize_t itemSize)
+  {
+    switch (code)
+    {
+    case 'f': { float v; std::memcpy(&v, p, sizeof(v)); return static_cast<Out>(v); }
+    case 'd': { double v; std::memcpy(&v, p, sizeof(v)); return static_cast<Out>(v); }
+    case 'B': case 'H': case 'I': case 'L': case 'Q': case 'N': case '?':
+    {
+      unsigned long long v = 0;
+      switch (itemSize)
+      {
+      case 1: v = *reinterpret_cast<const uint8_t*>(p); break;
+      case 2: { uint16_t x; std::memcpy(&x, p, 2); v = x; break; }
+      case 4: { uint32_t x; std::memcpy(&x, p, 4); v = x; break; }
+      default: std::memcpy(&v, p, 8); break;
+      }
+      return static_cast<Out>(v);
+    }
+    default:
+    {
+      long long v = 0;
+      switch (itemSize)
+      {
+      case 1: v = *reinterpret_cast<const int8_t*>(p); break;
+      case 2: { int16_t x; std::memcpy(&x, p, 2); v = x; break; }
+      case 4: { int32_t x; std::memcpy(&x, p, 4); v = x; break; }
+      default: std::memcpy(&v, p, 8); break;
+      }
+      return static_cast<Out>(v);
+    }
+    }
+  }
+
+  template <class Out>
+  bool readBuffer(const py::object& object, std::vector<Out>& values, size_t& rows, size_t& columns)
+  {
+    ScopedBuffer buffer(object);
+    if (!buffer.valid())
+      return false;
+
+    const auto& view = buffer.view();
+    const auto code = buffer.elementCode();
+    rows = view.shape[0];
+    columns = view.ndim == 2 ? view.shape[1] : 1;
+    values.resize(rows * columns);
+
+    if (std::is_same<Out, double>::value && code == 'd' && PyBuffer_IsContiguous(&view, 'C'))
+    {
+      std::memcpy(values.data(), view.buf, values.size() * sizeof(double));
+      return true;
+    }
+
+    const auto rowStride = view.strides[0];
+    const auto columnStride = view.ndim == 2 ? view.strides[1] : 0;
+    const auto* base = static_cast<const char*>(view.buf);
+    auto* out = values.data();
+    for (size_t i = 0; i < rows; ++i)
+      for (size_t j = 0; j < columns; ++j)
+        *out++ = readElement<Out>(base + i * rowStride + j * columnStride, code, view.itemsize);
+    return true;
+  }
+}
+
+py::object SCIRun::Core::Python::makeArrayView(std::shared_ptr<const void> owner, const void* data,
+  const char* format, size_t itemSize, const std::vector<size_t>& shape)
+{
+  auto* array = PyObject_New(DatatypeArrayView, arrayViewType());
+  if (!array)
+    py::throw_error_already_set();
+
+  array->owner = new std::shared_ptr<const void>(std::move(owner));
+  array->data = const_cast<void*>(data);
+  array->format = format;
+  array->itemSize = static_cast<Py_ssize_t>(itemSize);
+  array->ndim = static_cast<int>(shape.size());
+  Py_ssize_t stride = array->itemSize;
+  for (int i = array->ndim - 1; i >= 0; --i)
+  {
+    array->shape[i] = static_cast<Py_ssize_t>(shape[i]);
+    array->strides[i] = stride;
+    stride *= array->shape[i];
+  }
+  return py::object(py::handle<>(reinterpret_cast<PyObject*>(array)));
+}
+
+namespace
+{
+  std::atomic<bool> numpyMissing_(false);
+
+  // The module is looked up on each call (sys.modules makes that cheap): a
+  // static reference would outlive the interpreter and be released after
+  // Py_Finalize.
+  py::object numpyModule()
+  {
+    if (numpyMissing_)
+      return {};
+    try
+    {
+      return py::import("numpy");
+    }
+    catch (py::error_already_set&)
+    {
+      PyErr_Clear();
+      numpyMissing_ = true;
+      return {};
+    }
+  }
+}
+
+bool SCIRun::Core::Python::numpyAvailable()
+{
+  return !numpyModule().is_none();
+}
+
+py::object SCIRun::Core::Python::asNumpyArray(const py::object& view)
+{
+  auto numpy = numpyModule();
+  if (numpy.is_none())
+    return view;
+  return numpy.attr("asarray")(view);
+}
+
+void SCIRun::Core::Python::setArrayViewsEnabled(bool enabled)
+{
+  arrayViewsEnabled_ = enabled;
+}
+
+bool SCIRun::Core::Python::arrayViewsEnabled()
+{
+  return arrayViewsEnabled_ && numpyAvailable();
+}
+
+bool SCIRun::Core::Python::isNumericBuffer(const py::object& object)
+{
+  return ScopedBuffer(object).valid();
+}
+
+bool SCIRun::Core::Python::readNumericBuffer(const py::object& object,
+  std::vector<double>& values, size_t& rows, size_t& columns)
+{
+  return readBuffer(object, values, rows, columns);
+}
+
+bool SCIRun::Core::Python::readNumericBuffer(const py::object& object,
+  std::vector<long long>& values, size_t& rows, size_t& columns)
+{
+  return readBuffer(object, values, rows, columns);
+}
+
+#endif
@@ -0,0 +1,104 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifdef BUILD_WITH_PYTHON
+#ifndef CORE_PYTHON_PYTHONARRAYVIEWS_H
+#define CORE_PYTHON_PYTHONARRAYVIEWS_H
+
+#include <memory>
+#include <boost/python.hpp>
+#include <complex>
+#include <cstdint>
+#include <vector>
+#include <Core/Python/share.h>
+
+namespace SCIRun
+{
+  namespace Core
+  {
+    namespace Python
+    {
+      /// struct module format character for the element types SCIRun stores
+      template <class T> const char* bufferFormat();
+      template <> inline const char* bufferFormat<double>() { return "d"; }
+      template <> inline const char* bufferFormat<float>() { return "f"; }
+      template <> inline const char* bufferFormat<int>() { return "i"; }
+      template <> inline const char* bufferFormat<unsigned int>() { return "I"; }
+      template <> inline const char* bufferFormat<long long>() { return "q"; }
+      template <> inline const char* bufferFormat<unsigned long long>() { return "Q"; }
+      template <> inline const char* bufferFormat<std::complex<double>>() { return "Zd"; }
+
+      /// Read-only, C-contiguous buffer protocol object over memory owned by a
+      /// SCIRun datatype or another shared object. The view holds a reference to
+      /// the owner, so the memory stays valid for as long as Python (or a NumPy
+      /// array built on it) uses it.
+      SCISHARE boost::python::object makeArrayView(std::shared_ptr<const void> owner, const void* data,
+        const char* format, size_t itemSize, const std::vector<size_t>& shape);
+
+      template <class T>
+      boost::python::object makeArrayView(std::shared_ptr<const void> owner, const T* data, const std::vector<size_t>& shape)
+      {
+        return makeArrayView(owner, data, bufferFormat<T>(), sizeof(T), shape);
+      }
+
+      /// Wraps a view as a NumPy array without copying when NumPy can be imported,
+      /// otherwise returns the view itself.
+      SCISHARE boost::python::object asNumpyArray(const boost::python::object& view);
+      SCISHARE bool numpyAvailable();
+
+      /// Inputs are handed to Python as NumPy views when this is on and NumPy is
+      /// available; otherwise the nested list conversion is used.
+      SCISHARE void setArrayViewsEnabled(bool enabled);
+      SCISHARE bool arrayViewsEnabled();
+
+      /// Numeric buffer of one or two dimensions (ndarray, memoryview, array.array),
+      /// excluding bytes-like objects.
+      SCISHARE bool isNumericBuffer(const boost::python::object& object);
+
+      /// Copies a numeric buffer of any element type and strides into row-major
+      /// storage. Returns false if the object does not export a suitable buffer.
+      SCISHARE bool readNumericBuffer(const boost::python::object& object,
+        std::vector<double>& values, size_t& rows, size_t& columns);
+      SCISHARE bool readNumericBuffer(const boost::python::object& object,
+        std::vector<long long>& values, size_t& rows, size_t& columns);
+
+      template <class T>
+      std::vector<T> numericBufferToVector(const boost::python::object& object)
+      {
+        std::vector<T> values;
+        size_t rows, columns;
+        readNumericBuffer(object, values, rows, columns);
+        return values;
+      }
+    }
+  }
+}
+
+#endif
+#endif
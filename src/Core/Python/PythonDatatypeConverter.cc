@@ -34,6 +34,7 @@
 #endif
 
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 // ReSharper disable once CppUnusedIncludeDirective
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
@@ -42,6 +43,7 @@
 #include <Core/Matlab/matlabarray.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonArrayViews.h>
 #include <Core/Algorithms/Base/VariableHelper.h>
 #include <boost/variant/apply_visitor.hpp>
 
@@ -229,21 +231,42 @@ py::dict SCIRun::Core::Python::wrapDatatypesInMap(
 {
   py::dict d;
   int i = 0;
+  const auto views = arrayViewsEnabled();
   for (const auto& m : matrices)
   {
     if (auto dense = castMatrix::toDense(m))
-      d[i++] = convertMatrixToPython(dense);
+      d[i++] = views ? convertMatrixToArray(dense) : convertMatrixToPython(dense);
     else if (auto sparse = castMatrix::toSparse(m))
-      d[i++] = convertMatrixToPython(sparse);
+      d[i++] = views ? convertMatrixToArray(sparse) : convertMatrixToPython(sparse);
   }
   for (const auto& f : fields)
-    d[i++] = convertFieldToPython(f);
+    d[i++] = views ? convertFieldToArrays(f) : convertFieldToPython(f);
   for (const auto& s : strings)
     d[i++] = convertStringToPython(s);
   return d;
 }
 
-py::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
+namespace {
+template <class T>
+py::object numericFieldEntry(const matlabarray& subField, bool views)
+{
+  auto values = std::make_shared<std::vector<T>>();
+  subField.getnumericarray(*values);
+  const bool matrix = 1 != subField.getm() && 1 != subField.getn();
+  if (!views)
+  {
+    if (matrix)
+      return toPythonListOfLists(*values, subField.getn(), subField.getm());
+    return toPythonList(*values);
+  }
+  // same layout as the lists: one row per column of the matlab array
+  const auto shape = matrix ?
+    std::vector<size_t>{ static_cast<size_t>(subField.getn()), static_cast<size_t>(subField.getm()) } :
+    std::vector<size_t>{ values->size() };
+  return asNumpyArray(makeArrayView(values, values->data(), shape));
+}
+
+py::dict convertFieldToDictionary(FieldHandle field, bool views)
 {
   matlabarray ma;
   matlabconverter mc(nullptr);
@@ -264,28 +287,11 @@ py::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
       break;
     }
     case matfilebase::miUINT32:
-    {
-      std::vector<unsigned int> v;
-      subField.getnumericarray(v);
-      if (1 != subField.getm() && 1 != subField.getn())
-        matlabStructure[fieldName] = toPythonListOfLists(v, subField.getn(), subField.getm());
-      else
-        matlabStructure[fieldName] = toPythonList(v);
+      matlabStructure[fieldName] = numericFieldEntry<unsigned int>(subField, views);
       break;
-    }
     case matfilebase::miDOUBLE:
-    {
-      std::vector<double> v;
-      subField.getnumericarray(v);
-      // std::cout << "miDOUBLE " << subField.getm() << "x" << subField.getn() << "\n";
-      // std::copy(v.begin(), v.end(), std::ostream_iterator<double>(std::cout, " "));
-      // std::cout << "\n...\n";
-      if (1 != subField.getm() && 1 != subField.getn())
-        matlabStructure[fieldName] = toPythonListOfLists(v, subField.getn(), subField.getm());
-      else
-        matlabStructure[fieldName] = toPythonList(v);
+      matlabStructure[fieldName] = numericFieldEntry<double>(subField, views);
       break;
-    }
     default:
       std::cout << "some other array: " << fieldName << " of type " << subField.gettype()
                 << std::endl;
@@ -294,6 +300,19 @@ py::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
   }
   return matlabStructure;
 }
+}
+
+py::dict SCIRun::Core::Python::convertFieldToPython(FieldHandle field)
+{
+  return convertFieldToDictionary(field, false);
+}
+
+py::dict SCIRun::Core::Python::convertFieldToArrays(FieldHandle field)
+{
+  if (!field)
+    return {};
+  return convertFieldToDictionary(field, true);
+}
 
 py::list SCIRun::Core::Python::convertMatrixToPython(DenseMatrixHandle matrix)
 {
@@ -307,6 +326,39 @@ py::dict SCIRun::Core::Python::convertMatrixToPython(SparseRowMatrixHandle matri
   return {};
 }
 
+py::object SCIRun::Core::Python::convertMatrixToArray(DenseMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  return asNumpyArray(makeArrayView(matrix, matrix->data(),
+    { static_cast<size_t>(matrix->nrows()), static_cast<size_t>(matrix->ncols()) }));
+}
+
+py::object SCIRun::Core::Python::convertMatrixToArray(DenseColumnMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  return asNumpyArray(makeArrayView(matrix, matrix->data(), { static_cast<size_t>(matrix->nrows()) }));
+}
+
+py::object SCIRun::Core::Python::convertMatrixToArray(SparseRowMatrixHandle matrix)
+{
+  if (!matrix)
+    return {};
+  // the row array of an uncompressed matrix has no end entries to point at
+  if (!matrix->isCompressed())
+    return ::toPythonListSparse(*matrix);
+
+  const auto nnz = static_cast<size_t>(matrix->nonZeros());
+  py::dict dict;
+  dict["nrows"] = matrix->nrows();
+  dict["ncols"] = matrix->ncols();
+  dict["rows"] = asNumpyArray(makeArrayView(matrix, matrix->outerIndexPtr(), { static_cast<size_t>(matrix->outerSize()) + 1 }));
+  dict["columns"] = asNumpyArray(makeArrayView(matrix, matrix->innerIndexPtr(), { nnz }));
+  dict["values"] = asNumpyArray(makeArrayView(matrix, matrix->valuePtr(), { nnz }));
+  return std::move(dict);
+}
+
 py::object SCIRun::Core::Python::convertStringToPython(StringHandle str)
 {
   if (str)
@@ -377,6 +429,23 @@ DatatypeHandle DenseMatrixExtractor::operator()() const
   return dense;
 }
 
+bool ArrayMatrixExtractor::check() const
+{
+  return isNumericBuffer(object_);
+}
+
+DatatypeHandle ArrayMatrixExtractor::operator()() const
+{
+  std::vector<double> values;
+  size_t rows, columns;
+  if (!readNumericBuffer(object_, values, rows, columns))
+    return nullptr;
+  auto dense = makeShared<DenseMatrix>(rows, columns);
+  if (!values.empty())
+    std::copy(values.begin(), values.end(), dense->data());
+  return dense;
+}
+
 std::set<std::string> SparseRowMatrixExtractor::validKeys_ = {
     "rows", "columns", "values", "nrows", "ncols"};
 
@@ -401,7 +470,7 @@ bool SparseRowMatrixExtractor::check() const
 
     py::extract<py::list> value_i_list(values[i]);
     py::extract<size_t> value_i_int(values[i]);
-    if (!value_i_int.check() && !value_i_list.check()) return false;
+    if (!value_i_int.check() && !value_i_list.check() && !isNumericBuffer(values[i])) return false;
   }
 
   return true;
@@ -427,11 +496,15 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     py::extract<std::string> key_i(keys[i]);
 
     py::extract<py::list> value_i_list(values[i]);
+    const bool isArray = !value_i_list.check();
     auto fieldName = key_i();
-    if (fieldName == "rows") { rows = to_std_vector<index_type>(value_i_list()); }
+    if (fieldName == "rows")
+    {
+      rows = isArray ? numericBufferToVector<long long>(values[i]) : to_std_vector<index_type>(value_i_list());
+    }
     else if (fieldName == "columns")
     {
-      columns = to_std_vector<index_type>(value_i_list());
+      columns = isArray ? numericBufferToVector<long long>(values[i]) : to_std_vector<index_type>(value_i_list());
     }
     else if (fieldName == "nrows")
     {
@@ -445,7 +518,7 @@ DatatypeHandle SparseRowMatrixExtractor::operator()() const
     }
     else if (fieldName == "values")
     {
-      matrixValues = to_std_vector<double>(value_i_list());
+      matrixValues = isArray ? numericBufferToVector<double>(values[i]) : to_std_vector<double>(value_i_list());
     }
   }
 
@@ -478,7 +551,7 @@ bool FieldExtractor::check() const
 
     py::extract<std::string> value_i_string(values[i]);
     py::extract<py::list> value_i_list(values[i]);
-    if (!value_i_string.check() && !value_i_list.check()) return false;
+    if (!value_i_string.check() && !value_i_list.check() && !isNumericBuffer(values[i])) return false;
   }
 
   return true;
@@ -486,10 +559,22 @@ bool FieldExtractor::check() const
 
 namespace {
 matlabarray getPythonFieldDictionaryValue(
-    const py::extract<std::string>& strExtract, const py::extract<py::list>& listExtract)
+    const py::extract<std::string>& strExtract, const py::extract<py::list>& listExtract, const py::object& object)
 {
   matlabarray value;
-  if (strExtract.check())
+  std::vector<double> arrayValues;
+  size_t rows, columns;
+  if (!strExtract.check() && !listExtract.check() && readNumericBuffer(object, arrayValues, rows, columns))
+  {
+    // same orientation as a list of rows: each row is a column of the matlab array
+    if (1 == arrayValues.size())
+      value.createdoublescalar(arrayValues[0]);
+    else if (1 == columns)
+      value.createdoublevector(arrayValues);
+    else
+      value.createdoublematrix(arrayValues, { static_cast<int>(columns), static_cast<int>(rows) });
+  }
+  else if (strExtract.check())
   {
     value.createstringarray();
     auto strData = strExtract();
@@ -555,7 +640,7 @@ DatatypeHandle FieldExtractor::operator()() const
     py::extract<py::list> value_i_list(values[i]);
     auto fieldName = key_i();
     // std::cout << "setting field " << fieldName << std::endl;
-    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(value_i_string, value_i_list));
+    ma.setfield(0, fieldName, getPythonFieldDictionaryValue(value_i_string, value_i_list, values[i]));
   }
 
   FieldHandle field;
@@ -578,6 +663,11 @@ const std::string SCIRun::Core::Python::getClassName(const py::object& object)
 
 Variable SCIRun::Core::Python::convertPythonObjectToVariable(const py::object& object)
 {
+  {
+    ArrayMatrixExtractor e(object);
+    if (e.check())
+      return makeDatatypeVariable(e);
+  }
   {
     py::extract<int> e(object);
     if (e.check())
@@ -91,6 +91,15 @@ namespace SCIRun
       SCISHARE boost::python::list convertMatrixToPython(Datatypes::DenseMatrixHandle matrix);
       SCISHARE boost::python::dict convertMatrixToPython(Datatypes::SparseRowMatrixHandle matrix);
       SCISHARE boost::python::object convertStringToPython(Datatypes::StringHandle str);
+
+      /// Zero-copy NumPy views (plain buffer views if NumPy is missing). Sparse
+      /// matrices become the same dictionary as the list conversion with array
+      /// values; fields give the same dictionary as convertFieldToPython, with
+      /// NumPy arrays in place of the nested lists.
+      SCISHARE boost::python::object convertMatrixToArray(Datatypes::DenseMatrixHandle matrix);
+      SCISHARE boost::python::object convertMatrixToArray(Datatypes::DenseColumnMatrixHandle matrix);
+      SCISHARE boost::python::object convertMatrixToArray(Datatypes::SparseRowMatrixHandle matrix);
+      SCISHARE boost::python::dict convertFieldToArrays(FieldHandle field);
       SCISHARE boost::python::dict wrapDatatypesInMap(
         const std::vector<Datatypes::MatrixHandle>& matrices,
         const std::vector<FieldHandle>& fields,
@@ -123,6 +132,16 @@ namespace SCIRun
         std::string label() const override { return "dense matrix"; }
       };
 
+      /// Any one or two dimensional numeric buffer, e.g. a NumPy array
+      class SCISHARE ArrayMatrixExtractor : public DatatypePythonExtractor
+      {
+      public:
+        explicit ArrayMatrixExtractor(const boost::python::object& object) : DatatypePythonExtractor(object) {}
+        bool check() const override;
+        Datatypes::DatatypeHandle operator()() const override;
+        std::string label() const override { return "dense matrix"; }
+      };
+
       class SCISHARE SparseRowMatrixExtractor : public DatatypePythonExtractor
       {
       public:
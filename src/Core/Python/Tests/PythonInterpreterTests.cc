@@ -32,9 +32,12 @@
 #include <gtest/gtest.h>
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonArrayViews.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/FieldInformation.h>
 #include <Core/Matlab/matlabconverter.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
 #include <Testing/Utils/MatrixTestUtilities.h>
 #include <Testing/Utils/SCIRunUnitTests.h>
 #include <Testing/Utils/SCIRunFieldSamples.h>
@@ -46,6 +49,7 @@
 
 using namespace SCIRun;
 using namespace SCIRun::Core;
+using namespace SCIRun::Core::Datatypes;
 using namespace Core::Python;
 using namespace Testing;
 using namespace TestUtils;
@@ -413,6 +417,45 @@ TEST_F(FieldConversionTests, RoundTripTetVolCell)
   EXPECT_EQ("GenericField<TetVolMesh<TetLinearLgn<Point>>,ConstantBasis<double>,vector<double>>", info.get_field_type_id());
 }
 
+TEST_F(FieldConversionTests, RoundTripTetVolThroughArrays)
+{
+  auto expected = CubeTetVolLinearBasis(data_info_type::DOUBLE_E);
+  auto* vfield = expected->vfield();
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+    vfield->set_value(0.5 * i - 1, i);
+
+  auto lists = convertFieldToPython(expected);
+  auto arrays = convertFieldToArrays(expected);
+  ASSERT_EQ(len(lists.items()), len(arrays.items()));
+  auto keys = lists.keys();
+  for (int i = 0; i < len(keys); ++i)
+    EXPECT_TRUE(arrays.has_key(keys[i]));
+
+  FieldExtractor converter(arrays);
+  ASSERT_TRUE(converter.check());
+  auto actualField = std::dynamic_pointer_cast<Field>(converter());
+  ASSERT_TRUE(actualField != nullptr);
+
+  EXPECT_EQ(FieldInformation(expected), FieldInformation(actualField));
+  EXPECT_TRUE(compareNodes(expected, actualField));
+  ASSERT_EQ(expected->vmesh()->num_elems(), actualField->vmesh()->num_elems());
+  for (VMesh::Elem::index_type e = 0; e < expected->vmesh()->num_elems(); ++e)
+  {
+    VMesh::Node::array_type expectedNodes, actualNodes;
+    expected->vmesh()->get_nodes(expectedNodes, e);
+    actualField->vmesh()->get_nodes(actualNodes, e);
+    EXPECT_EQ(expectedNodes, actualNodes);
+  }
+  ASSERT_EQ(vfield->num_values(), actualField->vfield()->num_values());
+  for (VMesh::index_type i = 0; i < vfield->num_values(); ++i)
+  {
+    double a, b;
+    vfield->get_value(a, i);
+    actualField->vfield()->get_value(b, i);
+    EXPECT_EQ(a, b);
+  }
+}
+
 TEST_F(FieldConversionTests, RejectsEmptyDictionary)
 {
   boost::python::dict emptyDict;
@@ -430,3 +473,104 @@ TEST_F(FieldConversionTests, RejectsIncompatibleDictionary)
 
   ASSERT_FALSE(converter.check());
 }
+
+class ArrayViewConversionTests : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    Py_Initialize();
+  }
+};
+
+TEST_F(ArrayViewConversionTests, DenseMatrixViewSharesMemory)
+{
+  DenseMatrixHandle m(new DenseMatrix(2, 3));
+  *m << 1, 2, 3,
+        4, 5, 6;
+  auto view = convertMatrixToArray(m);
+
+  Py_buffer buffer;
+  ASSERT_EQ(0, PyObject_GetBuffer(view.ptr(), &buffer, PyBUF_RECORDS_RO));
+  EXPECT_EQ(m->data(), buffer.buf);
+  EXPECT_TRUE(buffer.readonly);
+  EXPECT_EQ(2, buffer.ndim);
+  EXPECT_EQ(2, buffer.shape[0]);
+  EXPECT_EQ(3, buffer.shape[1]);
+  PyBuffer_Release(&buffer);
+
+  EXPECT_EQ(-1, PyObject_GetBuffer(view.ptr(), &buffer, PyBUF_WRITABLE));
+  PyErr_Clear();
+}
+
+TEST_F(ArrayViewConversionTests, ViewKeepsMatrixAlive)
+{
+  boost::python::object view;
+  {
+    DenseMatrixHandle m(new DenseMatrix(DenseMatrix::Identity(3, 3)));
+    view = convertMatrixToArray(m);
+  }
+  ArrayMatrixExtractor converter(view);
+  ASSERT_TRUE(converter.check());
+  auto actual = std::dynamic_pointer_cast<DenseMatrix>(converter());
+  ASSERT_TRUE(actual != nullptr);
+  EXPECT_MATRIX_EQ(*actual, DenseMatrix(DenseMatrix::Identity(3, 3)));
+}
+
+TEST_F(ArrayViewConversionTests, RoundTripDenseMatrixThroughView)
+{
+  DenseMatrixHandle m(new DenseMatrix(3, 2));
+  *m << 1, 2,
+        3, 4,
+        5, 6;
+  ArrayMatrixExtractor converter(convertMatrixToArray(m));
+  ASSERT_TRUE(converter.check());
+  auto actual = std::dynamic_pointer_cast<DenseMatrix>(converter());
+  ASSERT_TRUE(actual != nullptr);
+  EXPECT_MATRIX_EQ(*actual, *m);
+}
+
+TEST_F(ArrayViewConversionTests, SparseMatrixViewsShareMemory)
+{
+  SparseRowMatrixHandle m(new SparseRowMatrix(3, 3));
+  m->insert(0, 0) = 1;
+  m->insert(1, 2) = 2;
+  m->insert(2, 1) = 3;
+  m->makeCompressed();
+  auto dict = convertMatrixToArray(m);
+
+  Py_buffer buffer;
+  boost::python::object values = dict["values"];
+  ASSERT_EQ(0, PyObject_GetBuffer(values.ptr(), &buffer, PyBUF_RECORDS_RO));
+  EXPECT_EQ(m->valuePtr(), buffer.buf);
+  EXPECT_EQ(3, buffer.shape[0]);
+  PyBuffer_Release(&buffer);
+
+  SparseRowMatrixExtractor converter(dict);
+  ASSERT_TRUE(converter.check());
+  auto actual = std::dynamic_pointer_cast<SparseRowMatrix>(converter());
+  ASSERT_TRUE(actual != nullptr);
+  EXPECT_EQ(1, actual->coeff(0, 0));
+  EXPECT_EQ(2, actual->coeff(1, 2));
+  EXPECT_EQ(3, actual->coeff(2, 1));
+}
+
+TEST_F(ArrayViewConversionTests, ReadsStridedIntegerBuffers)
+{
+  boost::python::object array = boost::python::import("array");
+  boost::python::list items;
+  for (int i = 0; i < 6; ++i)
+    items.append(i);
+  boost::python::object ints = array.attr("array")("i", items);
+  boost::python::object everyOther = boost::python::object(boost::python::handle<>(PyMemoryView_FromObject(ints.ptr())))[boost::python::slice(0, 6, 2)];
+
+  ASSERT_TRUE(isNumericBuffer(everyOther));
+  std::vector<double> values;
+  size_t rows, columns;
+  ASSERT_TRUE(readNumericBuffer(everyOther, values, rows, columns));
+  EXPECT_EQ(3, rows);
+  EXPECT_EQ(1, columns);
+  EXPECT_EQ((std::vector<double>{ 0, 2, 4 }), values);
+
+  EXPECT_FALSE(isNumericBuffer(boost::python::object(boost::python::handle<>(PyBytes_FromString("abc")))));
+}
@@ -27,31 +27,225 @@
 
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/WorkStealingThreadPool.h>
 #include <Core/Logging/Log.h>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
 #include <vector>
 #include <iostream>
 
 using namespace SCIRun::Core::Thread;
 using namespace SCIRun::Core::Logging;
 
+namespace
+{
+  unsigned int hardwareThreads()
+  {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+  }
+
+  // Intentionally leaked: workers stay parked until process exit, which avoids
+  // static destruction order problems with detached module threads.
+  WorkStealingThreadPool& arena()
+  {
+    static auto* pool = new WorkStealingThreadPool("task-arena", hardwareThreads());
+    return *pool;
+  }
+
+  // Arena workers that RunTasks groups may still claim. A group takes all its workers
+  // at once, so two groups can never each hold half of what the other needs.
+  class WorkerReservations
+  {
+  public:
+    explicit WorkerReservations(unsigned int total) : available_(total) {}
+
+    void acquire(unsigned int n)
+    {
+      std::unique_lock<std::mutex> lock(lock_);
+      released_.wait(lock, [this, n]() { return available_ >= n; });
+      available_ -= n;
+    }
+
+    void release()
+    {
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        ++available_;
+      }
+      released_.notify_all();
+    }
+
+  private:
+    std::mutex lock_;
+    std::condition_variable released_;
+    unsigned int available_;
+  };
+
+  WorkerReservations& reservations()
+  {
+    static auto* r = new WorkerReservations(arena().size());
+    return *r;
+  }
+
+  class FirstException
+  {
+  public:
+    template <class Func>
+    bool guard(Func&& f)
+    {
+      try
+      {
+        f();
+        return true;
+      }
+      catch (...)
+      {
+        std::lock_guard<std::mutex> lock(lock_);
+        if (!error_)
+          error_ = std::current_exception();
+        return false;
+      }
+    }
+    void rethrow()
+    {
+      if (error_)
+        std::rethrow_exception(error_);
+    }
+  private:
+    std::mutex lock_;
+    std::exception_ptr error_;
+  };
+
+  struct TaskGroupState
+  {
+    explicit TaskGroupState(size_t count) : remaining(count) {}
+
+    void finishOne()
+    {
+      if (--remaining == 0)
+      {
+        std::lock_guard<std::mutex> l(lock);
+        done.notify_all();
+      }
+    }
+    void wait()
+    {
+      std::unique_lock<std::mutex> l(lock);
+      done.wait(l, [this]() { return remaining == 0; });
+    }
+
+    std::atomic<size_t> remaining;
+    std::mutex lock;
+    std::condition_variable done;
+    FirstException error;
+  };
+
+  struct ForState
+  {
+    ForState(size_t b, size_t e, size_t g, const Parallel::RangeTask& f) :
+      begin(b), end(e), grain(g), numChunks((e - b + g - 1) / g), body(f), nextChunk(0), active(0) {}
+
+    // Both the caller and every helper run this; helpers that start after the range is
+    // exhausted return without touching body.
+    void work()
+    {
+      ++active;
+      for (;;)
+      {
+        const auto c = nextChunk.fetch_add(1);
+        if (c >= numChunks)
+          break;
+        const auto b = begin + c * grain;
+        if (!error.guard([&]() { body(b, std::min(end, b + grain)); }))
+          nextChunk = numChunks;
+      }
+      if (--active == 0)
+      {
+        std::lock_guard<std::mutex> l(lock);
+        idle.notify_all();
+      }
+    }
+
+    void waitForHelpers()
+    {
+      std::unique_lock<std::mutex> l(lock);
+      idle.wait(l, [this]() { return active == 0; });
+    }
+
+    const size_t begin, end, grain, numChunks;
+    Parallel::RangeTask body;
+    std::atomic<size_t> nextChunk;
+    std::atomic<int> active;
+    std::mutex lock;
+    std::condition_variable idle;
+    FirstException error;
+  };
+}
+
 void Parallel::RunTasks(IndexedTask task, int numProcs)
 {
-  ThreadGroup threads;
+  const auto n = numProcs > 0 ? capByUserCoreCount(numProcs) : 0u;
+  if (n == 0)
+    return;
 
-  for (unsigned int i = 0; i < capByUserCoreCount(numProcs); ++i)
+  auto& pool = arena();
+  const auto others = n - 1;
+  const auto onArena = pool.isWorkerThread() ? 0u : std::min(others, pool.size());
+  if (onArena > 0)
+    reservations().acquire(onArena);
+
+  auto state = std::make_shared<TaskGroupState>(onArena);
+  for (unsigned int i = 1; i <= onArena; ++i)
+  {
+    pool.submitUrgent([state, task, i]()
+    {
+      state->error.guard([&]() { task(i); });
+      reservations().release();
+      state->finishOne();
+    });
+  }
+
+  ThreadGroup threads;
+  for (unsigned int i = onArena + 1; i < n; ++i)
   {
-    threads.create_thread(task, i);
+    threads.create_thread([state, task, i]() { state->error.guard([&]() { task(i); }); });
   }
 
-  //try
-  //{
-    threads.join_all();
-  //}
-  //catch (std::thread_interrupted&)
-  //{
-  //  threads.interrupt_all();
-  //  throw;
-  //}
+  state->error.guard([&]() { task(0); });
+
+  threads.join_all();
+  state->wait();
+  state->error.rethrow();
+}
+
+void Parallel::For(size_t begin, size_t end, const RangeTask& body, size_t grain)
+{
+  if (end <= begin)
+    return;
+
+  grain = GrainSize(end - begin, grain);
+  auto state = std::make_shared<ForState>(begin, end, grain, body);
+  const auto helpers = std::min<size_t>(state->numChunks, std::max(NumCores(), 1u)) - 1;
+
+  auto& pool = arena();
+  for (size_t i = 0; i < helpers; ++i)
+    pool.submit([state]() { state->work(); });
+
+  state->work();
+  state->waitForHelpers();
+  state->error.rethrow();
+}
+
+size_t Parallel::GrainSize(size_t rangeSize, size_t requestedGrain)
+{
+  if (requestedGrain > 0)
+    return requestedGrain;
+  // Several chunks per core so faster threads can pick up the slack.
+  const size_t chunksPerCore = 8;
+  return std::max<size_t>(1, rangeSize / (chunksPerCore * std::max(NumCores(), 1u)));
 }
 
 unsigned int Parallel::NumCores()
@@ -30,6 +30,7 @@
 #define CORE_THREAD_PARLLEL_H
 
 #include <boost/noncopyable.hpp>
+#include <algorithm>
 #include <thread>
 #include <vector>
 #include <functional>
@@ -41,11 +42,51 @@ namespace Core
 {
 namespace Thread
 {
+  /// All parallel work in the process shares one task arena: a work-stealing pool with one
+  /// worker per hardware thread, so modules running concurrently share cores instead of each
+  /// spawning NumCores() threads of their own.
   class SCISHARE Parallel : public boost::noncopyable
   {
   public:
     typedef std::function<void(int)> IndexedTask;
+    typedef std::function<void(size_t, size_t)> RangeTask;
+
+    /// Runs task(0)..task(numProcs-1) concurrently; tasks may synchronize with a Barrier of
+    /// size numProcs. Task 0 runs on the calling thread, the rest on arena workers reserved for
+    /// the whole group (waiting while other groups hold them). Nested calls from inside the
+    /// arena fall back to dedicated threads so they can never deadlock.
     static void RunTasks(IndexedTask task, int numProcs);
+
+    /// Calls body(chunkBegin, chunkEnd) over [begin, end). Chunks are claimed dynamically by
+    /// the calling thread and arena helpers; grain 0 picks a chunk size from the range length.
+    /// Safe to nest. The first exception thrown by body is rethrown here.
+    static void For(size_t begin, size_t end, const RangeTask& body, size_t grain = 0);
+
+    /// Reduces [begin, end) with body(chunkBegin, chunkEnd, identity) -> T per chunk, then folds
+    /// the chunk results in order with combine, so the result does not depend on scheduling.
+    template <typename T, class ChunkReduce, class Combine>
+    static T Reduce(size_t begin, size_t end, const T& identity, ChunkReduce body, Combine combine, size_t grain = 0)
+    {
+      if (end <= begin)
+        return identity;
+      grain = GrainSize(end - begin, grain);
+      const auto numChunks = (end - begin + grain - 1) / grain;
+      std::vector<T> partials(numChunks, identity);
+      For(0, numChunks, [&](size_t first, size_t last)
+      {
+        for (auto c = first; c < last; ++c)
+        {
+          const auto b = begin + c * grain;
+          partials[c] = body(b, std::min(end, b + grain), identity);
+        }
+      }, 1);
+      auto result = identity;
+      for (const auto& p : partials)
+        result = combine(result, p);
+      return result;
+    }
+
+    static size_t GrainSize(size_t rangeSize, size_t requestedGrain);
     static unsigned int NumCores();
     static void SetMaximumCores(unsigned int max);
   private:
@@ -27,10 +27,12 @@
 
 
 #include <gtest/gtest.h>
+#include <atomic>
 #include <numeric>
 #include <fstream>
 
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/Barrier.h>
 #include <boost/filesystem/path.hpp>
 #include <Testing/Utils/SCIRunUnitTests.h>
 
@@ -114,3 +116,98 @@ TEST(NumCoresTest, CompareToV4Linux)
 
   std::cout << procInfoTest << "\nzugspitze: " << legacyNumProcessors() << std::endl;
 }
+
+TEST(ParallelTests, ForCoversRangeExactlyOnce)
+{
+  const size_t size = 100003;
+  std::vector<int> hits(size, 0);
+
+  Parallel::For(0, size, [&](size_t b, size_t e) { for (auto i = b; i < e; ++i) hits[i]++; });
+
+  EXPECT_EQ(size, std::count(hits.begin(), hits.end(), 1));
+}
+
+TEST(ParallelTests, ForHandlesEmptyAndTinyRanges)
+{
+  int calls = 0;
+  Parallel::For(5, 5, [&](size_t, size_t) { ++calls; });
+  EXPECT_EQ(0, calls);
+
+  std::vector<int> hits(3, 0);
+  Parallel::For(0, 3, [&](size_t b, size_t e) { for (auto i = b; i < e; ++i) hits[i]++; }, 1);
+  EXPECT_EQ(std::vector<int>(3, 1), hits);
+}
+
+TEST(ParallelTests, NestedForDoesNotDeadlock)
+{
+  std::atomic<int> count(0);
+  Parallel::For(0, 64, [&](size_t b, size_t e)
+  {
+    for (auto i = b; i < e; ++i)
+      Parallel::For(0, 100, [&](size_t ib, size_t ie) { count += static_cast<int>(ie - ib); }, 7);
+  }, 1);
+
+  EXPECT_EQ(6400, count);
+}
+
+TEST(ParallelTests, ReduceIsDeterministic)
+{
+  const size_t size = 1000000;
+  auto sum = [&]()
+  {
+    return Parallel::Reduce(0, size, 0.0,
+      [](size_t b, size_t e, double init) { for (auto i = b; i < e; ++i) init += 1.0 / (i + 1); return init; },
+      std::plus<double>());
+  };
+  const auto first = sum();
+  EXPECT_NEAR(14.392726722864, first, 1e-9);
+  for (int i = 0; i < 5; ++i)
+    EXPECT_EQ(first, sum());
+}
+
+TEST(ParallelTests, ForRethrowsFirstException)
+{
+  EXPECT_THROW(Parallel::For(0, 1000, [](size_t b, size_t e)
+  {
+    if (b <= 500 && 500 < e)
+      throw std::runtime_error("bad chunk");
+  }, 10), std::runtime_error);
+}
+
+TEST(ParallelTests, ConcurrentRunTasksWithBarriersShareArena)
+{
+  const int numProcs = Parallel::NumCores();
+  std::atomic<int> total(0);
+  auto group = [&]()
+  {
+    Barrier barrier("test", numProcs);
+    for (int round = 0; round < 10; ++round)
+    {
+      Parallel::RunTasks([&](int) { barrier.wait(); ++total; barrier.wait(); }, numProcs);
+    }
+  };
+
+  std::vector<std::thread> callers;
+  for (int i = 0; i < 4; ++i)
+    callers.emplace_back(group);
+  for (auto& t : callers)
+    t.join();
+
+  EXPECT_EQ(4 * 10 * numProcs, total);
+}
+
+TEST(ParallelTests, RunTasksNestedInForFallsBackToThreads)
+{
+  const int numProcs = std::min(3, static_cast<int>(Parallel::NumCores()));
+  std::atomic<int> total(0);
+  Parallel::For(0, 8, [&](size_t b, size_t e)
+  {
+    for (auto i = b; i < e; ++i)
+    {
+      Barrier barrier("nested", numProcs);
+      Parallel::RunTasks([&](int) { barrier.wait(); ++total; }, numProcs);
+    }
+  }, 1);
+
+  EXPECT_EQ(8 * numProcs, total);
+}
@@ -0,0 +1,90 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <gtest/gtest.h>
+#include <atomic>
+
+#include <Core/Thread/WorkStealingThreadPool.h>
+
+using namespace SCIRun::Core::Thread;
+
+TEST(WorkStealingThreadPoolTests, RunsAllSubmittedTasks)
+{
+  WorkStealingThreadPool pool("test", 4);
+  EXPECT_EQ(4u, pool.size());
+
+  std::atomic<int> count(0);
+  for (int i = 0; i < 1000; ++i)
+    pool.submit([&]() { ++count; });
+  pool.waitForAll();
+
+  EXPECT_EQ(1000, count);
+}
+
+TEST(WorkStealingThreadPoolTests, CanBeReusedAcrossWaits)
+{
+  WorkStealingThreadPool pool("test", 2);
+  std::atomic<int> count(0);
+  for (int round = 0; round < 10; ++round)
+  {
+    for (int i = 0; i < 50; ++i)
+      pool.submit([&]() { ++count; });
+    pool.waitForAll();
+    EXPECT_EQ(50 * (round + 1), count);
+  }
+}
+
+TEST(WorkStealingThreadPoolTests, TasksCanSubmitMoreTasks)
+{
+  WorkStealingThreadPool pool("test", 3);
+  std::atomic<int> count(0);
+  for (int i = 0; i < 10; ++i)
+  {
+    pool.submit([&]()
+    {
+      EXPECT_TRUE(pool.isWorkerThread());
+      for (int j = 0; j < 10; ++j)
+        pool.submit([&]() { ++count; });
+    });
+  }
+  pool.waitForAll();
+
+  EXPECT_EQ(100, count);
+  EXPECT_FALSE(pool.isWorkerThread());
+}
+
+TEST(WorkStealingThreadPoolTests, ExceptionsDoNotKillWorkers)
+{
+  WorkStealingThreadPool pool("test", 1);
+  std::atomic<int> count(0);
+  pool.submit([]() { throw std::runtime_error("oops"); });
+  pool.submit([&]() { ++count; });
+  pool.waitForAll();
+
+  EXPECT_EQ(1, count);
+}
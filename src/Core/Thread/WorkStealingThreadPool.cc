@@ -0,0 +1,190 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#include <Core/Thread/WorkStealingThreadPool.h>
+#include <Core/Logging/Log.h>
+#include <algorithm>
+
+using namespace SCIRun::Core::Thread;
+using namespace SCIRun::Core::Logging;
+
+namespace
+{
+  thread_local const WorkStealingThreadPool* currentPool_ = nullptr;
+  thread_local unsigned int currentWorkerIndex_ = 0;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(const std::string& name, unsigned int numWorkers) :
+  name_(name), queued_(0), stopping_(false), pending_(0), nextQueue_(0)
+{
+  numWorkers = std::max(numWorkers, 1u);
+  queues_.reserve(numWorkers);
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    queues_.emplace_back(new WorkerQueue);
+  workers_.reserve(numWorkers);
+  for (unsigned int i = 0; i < numWorkers; ++i)
+    workers_.emplace_back([this, i]() { workerLoop(i); });
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(parkLock_);
+    stopping_ = true;
+  }
+  workAvailable_.notify_all();
+  for (auto& t : workers_)
+  {
+    if (t.joinable())
+      t.join();
+  }
+}
+
+bool WorkStealingThreadPool::isWorkerThread() const
+{
+  return currentPool_ == this;
+}
+
+void WorkStealingThreadPool::submit(Task task)
+{
+  ++pending_;
+  const auto target = isWorkerThread() ? currentWorkerIndex_ : nextQueue_.fetch_add(1) % size();
+  {
+    std::lock_guard<std::mutex> lock(queues_[target]->lock);
+    queues_[target]->tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(parkLock_);
+    ++queued_;
+  }
+  workAvailable_.notify_one();
+}
+
+void WorkStealingThreadPool::submitUrgent(Task task)
+{
+  ++pending_;
+  {
+    std::lock_guard<std::mutex> lock(urgent_.lock);
+    urgent_.tasks.push_back(std::move(task));
+  }
+  {
+    std::lock_guard<std::mutex> lock(parkLock_);
+    ++queued_;
+  }
+  workAvailable_.notify_one();
+}
+
+bool WorkStealingThreadPool::popUrgent(Task& task)
+{
+  std::lock_guard<std::mutex> lock(urgent_.lock);
+  if (urgent_.tasks.empty())
+    return false;
+  task = std::move(urgent_.tasks.front());
+  urgent_.tasks.pop_front();
+  --queued_;
+  return true;
+}
+
+bool WorkStealingThreadPool::popLocal(unsigned int index, Task& task)
+{
+  auto& queue = *queues_[index];
+  std::lock_guard<std::mutex> lock(queue.lock);
+  if (queue.tasks.empty())
+    return false;
+  task = std::move(queue.tasks.back());
+  queue.tasks.pop_back();
+  --queued_;
+  return true;
+}
+
+bool WorkStealingThreadPool::steal(unsigned int thief, Task& task)
+{
+  const auto n = size();
+  for (unsigned int k = 1; k <= n; ++k)
+  {
+    auto& victim = *queues_[(thief + k) % n];
+    std::lock_guard<std::mutex> lock(victim.lock);
+    if (!victim.tasks.empty())
+    {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      --queued_;
+      return true;
+    }
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::runTask(Task& task)
+{
+  try
+  {
+    task();
+  }
+  catch (std::exception& e)
+  {
+    logCritical("Uncaught exception in thread pool {}: {}", name_, e.what());
+  }
+  catch (...)
+  {
+    logCritical("Uncaught unknown exception in thread pool {}", name_);
+  }
+
+  if (--pending_ == 0)
+  {
+    std::lock_guard<std::mutex> lock(idleLock_);
+    allDone_.notify_all();
+  }
+}
+
+void WorkStealingThreadPool::workerLoop(unsigned int index)
+{
+  currentPool_ = this;
+  currentWorkerIndex_ = index;
+
+  for (;;)
+  {
+    Task task;
+    if (popUrgent(task) || popLocal(index, task) || steal(index, task))
+    {
+      runTask(task);
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(parkLock_);
+    workAvailable_.wait(lock, [this]() { return stopping_ || queued_ > 0; });
+    if (stopping_ && queued_ == 0)
+      return;
+  }
+}
+
+void WorkStealingThreadPool::waitForAll()
+{
+  std::unique_lock<std::mutex> lock(idleLock_);
+  allDone_.wait(lock, [this]() { return pending_ == 0; });
+}
@@ -0,0 +1,106 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+#ifndef CORE_THREAD_WORKSTEALINGTHREADPOOL_H
+#define CORE_THREAD_WORKSTEALINGTHREADPOOL_H
+
+#include <boost/noncopyable.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <Core/Thread/share.h>
+
+namespace SCIRun
+{
+namespace Core
+{
+namespace Thread
+{
+  /// Long-lived pool of worker threads. Each worker owns a deque: tasks submitted from
+  /// a worker go on its own deque (LIFO for locality), idle workers steal from the front
+  /// of the others' deques, and workers with nothing to do park on a condition variable
+  /// instead of spinning.
+  class SCISHARE WorkStealingThreadPool : boost::noncopyable
+  {
+  public:
+    typedef std::function<void()> Task;
+
+    WorkStealingThreadPool(const std::string& name, unsigned int numWorkers);
+    ~WorkStealingThreadPool();
+
+    void submit(Task task);
+    /// Queues a task that every worker checks before its own deque, for work that
+    /// other threads are blocked on.
+    void submitUrgent(Task task);
+    /// Blocks the calling (non-worker) thread until every submitted task has finished.
+    void waitForAll();
+    /// True if the calling thread is one of this pool's workers.
+    bool isWorkerThread() const;
+
+    unsigned int size() const { return static_cast<unsigned int>(workers_.size()); }
+    const std::string& name() const { return name_; }
+
+  private:
+    struct WorkerQueue
+    {
+      std::mutex lock;
+      std::deque<Task> tasks;
+    };
+
+    void workerLoop(unsigned int index);
+    bool popUrgent(Task& task);
+    bool popLocal(unsigned int index, Task& task);
+    bool steal(unsigned int thief, Task& task);
+    void runTask(Task& task);
+
+    std::string name_;
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    WorkerQueue urgent_;
+
+    std::mutex parkLock_;
+    std::condition_variable workAvailable_;
+    std::atomic<size_t> queued_;
+    bool stopping_;
+
+    std::mutex idleLock_;
+    std::condition_variable allDone_;
+    std::atomic<size_t> pending_;
+
+    std::atomic<unsigned int> nextQueue_;
+  };
+
+}}}
+
+#endif
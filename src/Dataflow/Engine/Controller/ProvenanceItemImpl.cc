@@ -30,6 +30,7 @@
 
 #include <string>
 #include <sstream>
+#include <algorithm>
 #include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
 #ifdef BUILD_WITH_PYTHON
 #include <Dataflow/Engine/Python/NetworkEditorPythonInterface.h>
@@ -41,16 +42,74 @@ using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
 using namespace SCIRun::Dataflow::Networks;
 
-ProvenanceItemBase::ProvenanceItemBase(NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy) : state_(state), nedPy_(nedPy)
+NetworkStateRecord::NetworkStateRecord(NetworkFileHandle keyframe) : keyframe_(keyframe)
+{
+}
+
+NetworkStateRecord::NetworkStateRecord(NetworkStateRecordHandle previous, NetworkFileDelta&& delta) :
+  previous_(previous), delta_(std::move(delta))
+{
+}
+
+NetworkFileHandle NetworkStateRecord::state() const
+{
+  if (keyframe_)
+    return keyframe_;
+
+  std::vector<const NetworkStateRecord*> chain;
+  auto record = this;
+  while (!record->keyframe_)
+  {
+    chain.push_back(record);
+    record = record->previous_.get();
+  }
+
+  auto file = makeShared<NetworkFile>(*record->keyframe_);
+  for (auto r = chain.rbegin(); r != chain.rend(); ++r)
+    applyNetworkFileDelta(*file, (*r)->delta_);
+  return file;
+}
+
+NetworkStateRecorder::NetworkStateRecorder(size_t keyframeInterval) : keyframeInterval_(std::max<size_t>(keyframeInterval, 1))
+{
+}
+
+NetworkStateRecordHandle NetworkStateRecorder::record(NetworkFileHandle current)
+{
+  if (!current)
+    return nullptr;
+
+  if (!lastRecord_ || sinceKeyframe_ + 1 >= keyframeInterval_)
+  {
+    lastRecord_ = makeShared<NetworkStateRecord>(current);
+    sinceKeyframe_ = 0;
+  }
+  else
+  {
+    lastRecord_ = makeShared<NetworkStateRecord>(lastRecord_, diffNetworkFiles(*last_, *current));
+    ++sinceKeyframe_;
+  }
+  last_ = current;
+  return lastRecord_;
+}
+
+void NetworkStateRecorder::reset()
+{
+  last_.reset();
+  lastRecord_.reset();
+  sinceKeyframe_ = 0;
+}
+
+ProvenanceItemBase::ProvenanceItemBase(NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy) : state_(state), nedPy_(nedPy)
 {
 }
 
 NetworkFileHandle ProvenanceItemBase::memento() const
 {
-  return state_;
+  return state_ ? state_->state() : nullptr;
 }
 
-ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleName, const std::string& modId, NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
+ModuleAddedProvenanceItem::ModuleAddedProvenanceItem(const std::string& moduleName, const std::string& modId, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
   : ProvenanceItemBase(state, nedPy), moduleName_(moduleName), moduleId_(modId)
 {
 }
@@ -78,7 +137,7 @@ std::string ModuleAddedProvenanceItem::redoCode() const
   return fmt::format("scirun_add_module(\"{}\")", moduleName_);
 }
 
-ModuleRemovedProvenanceItem::ModuleRemovedProvenanceItem(const ModuleId& moduleId, NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
+ModuleRemovedProvenanceItem::ModuleRemovedProvenanceItem(const ModuleId& moduleId, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
   : ProvenanceItemBase(state, nedPy), moduleId_(moduleId)
 {
 }
@@ -104,7 +163,7 @@ std::string ModuleRemovedProvenanceItem::redoCode() const
   return fmt::format("scirun_remove_module(\"{}\")", moduleId_.id_);
 }
 
-ConnectionAddedProvenanceItem::ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd, NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
+ConnectionAddedProvenanceItem::ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
   : ProvenanceItemBase(state, nedPy), desc_(cd)
 {
 #if 0
@@ -130,7 +189,7 @@ std::string ConnectionAddedProvenanceItem::redoCode() const
   return fmt::format("scirun_connect_modules(\"{}\")", ConnectionId::create(desc_).id_);
 }
 
-ConnectionRemovedProvenanceItem::ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id, NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
+ConnectionRemovedProvenanceItem::ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
   : ProvenanceItemBase(state, nedPy), id_(id)
 {
   //logCritical("REDO CODE: scirun_remove_connection(\"{}\")", id.id_);
@@ -153,7 +212,7 @@ std::string ConnectionRemovedProvenanceItem::redoCode() const
 }
 
 ModuleMovedProvenanceItem::ModuleMovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, double newX, double newY, double oldX, double oldY,
-  NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
+  NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy)
   : ProvenanceItemBase(state, nedPy), moduleId_(moduleId), newX_(newX), newY_(newY), oldX_(oldX), oldY_(oldY)
 {
 }
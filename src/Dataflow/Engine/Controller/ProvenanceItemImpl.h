@@ -34,6 +34,7 @@
 #include <Dataflow/Network/ModuleDescription.h>
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Network/ConnectionId.h>
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
 #include <Dataflow/Engine/Controller/share.h>
 
 namespace SCIRun {
@@ -41,20 +42,55 @@ namespace SCIRun {
 namespace Dataflow {
 namespace Engine {
 
+  class NetworkStateRecord;
+  using NetworkStateRecordHandle = SharedPointer<const NetworkStateRecord>;
+
+  /// One network state in a provenance history. A record is either a full
+  /// keyframe or the delta from the record before it; state() replays the
+  /// deltas since the last keyframe.
+  class SCISHARE NetworkStateRecord
+  {
+  public:
+    explicit NetworkStateRecord(Networks::NetworkFileHandle keyframe);
+    NetworkStateRecord(NetworkStateRecordHandle previous, Networks::NetworkFileDelta&& delta);
+    Networks::NetworkFileHandle state() const;
+    bool isKeyframe() const { return keyframe_ != nullptr; }
+  private:
+    Networks::NetworkFileHandle keyframe_;
+    NetworkStateRecordHandle previous_;
+    Networks::NetworkFileDelta delta_;
+  };
+
+  /// Turns successive network snapshots into a chain of state records, writing
+  /// a keyframe every keyframeInterval records so replaying stays short and
+  /// dropped history can be freed.
+  class SCISHARE NetworkStateRecorder
+  {
+  public:
+    explicit NetworkStateRecorder(size_t keyframeInterval = 16);
+    NetworkStateRecordHandle record(Networks::NetworkFileHandle current);
+    void reset();
+  private:
+    size_t keyframeInterval_;
+    size_t sinceKeyframe_ {0};
+    Networks::NetworkFileHandle last_;
+    NetworkStateRecordHandle lastRecord_;
+  };
+
   class SCISHARE ProvenanceItemBase : public ProvenanceItem<Networks::NetworkFileHandle>
   {
   public:
-    explicit ProvenanceItemBase(Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+    explicit ProvenanceItemBase(NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     Networks::NetworkFileHandle memento() const override;
   protected:
-    Networks::NetworkFileHandle state_;
+    NetworkStateRecordHandle state_;
     SharedPointer<NetworkEditorPythonInterface> nedPy_;
   };
 
   class SCISHARE ModuleAddedProvenanceItem : public ProvenanceItemBase
   {
   public:
-    ModuleAddedProvenanceItem(const std::string& moduleName, const std::string& modId, Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+    ModuleAddedProvenanceItem(const std::string& moduleName, const std::string& modId, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     std::string name() const override;
     std::string undoCode() const override;
     std::string redoCode() const override;
@@ -67,7 +103,7 @@ namespace Engine {
   class SCISHARE ModuleRemovedProvenanceItem : public ProvenanceItemBase
   {
   public:
-    ModuleRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+    ModuleRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     std::string name() const override;
     std::string undoCode() const override;
     std::string redoCode() const override;
@@ -79,7 +115,7 @@ namespace Engine {
   class SCISHARE ConnectionAddedProvenanceItem : public ProvenanceItemBase
   {
   public:
-    ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd, Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+    ConnectionAddedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionDescription& cd, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     std::string name() const override;
     std::string undoCode() const override;
     std::string redoCode() const override;
@@ -90,7 +126,7 @@ namespace Engine {
   class SCISHARE ConnectionRemovedProvenanceItem : public ProvenanceItemBase
   {
   public:
-    ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id, Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+    ConnectionRemovedProvenanceItem(const SCIRun::Dataflow::Networks::ConnectionId& id, NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     std::string name() const override;
     std::string undoCode() const override;
     std::string redoCode() const override;
@@ -103,7 +139,7 @@ namespace Engine {
   public:
     ModuleMovedProvenanceItem(const SCIRun::Dataflow::Networks::ModuleId& moduleId, double newX, double newY,
       double oldX, double oldY,
-      Networks::NetworkFileHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
+      NetworkStateRecordHandle state, SharedPointer<NetworkEditorPythonInterface> nedPy);
     std::string name() const override;
     std::string undoCode() const override;
     std::string redoCode() const override;
@@ -43,6 +43,7 @@
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 #include <Core/Datatypes/String.h>
 #include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
 #include <Core/Datatypes/Legacy/Field/Field.h>
 #include <Core/Matlab/matlabfile.h>
@@ -51,6 +52,7 @@
 #include <boost/range/adaptors.hpp>
 #include <boost/range/algorithm/copy.hpp>
 #include <Core/Python/PythonDatatypeConverter.h>
+#include <Core/Python/PythonArrayViews.h>
 #include <Core/Python/PythonInterpreter.h>
 
 using namespace SCIRun;
@@ -92,7 +94,7 @@ namespace
   class PyDatatypeDenseMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeDenseMatrix(DenseMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -103,18 +105,42 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (arrayViewsEnabled())
+        return convertMatrixToArray(underlying_);
+      return convertMatrixToPython(underlying_);
     }
 
   private:
     DenseMatrixHandle underlying_;
-    py::list pyMat_;
+  };
+
+  class PyDatatypeDenseColumnMatrix : public PyDatatype
+  {
+  public:
+    explicit PyDatatypeDenseColumnMatrix(DenseColumnMatrixHandle underlying) : underlying_(underlying)
+    {
+    }
+
+    std::string type() const override
+    {
+      return underlying_->dynamic_type_name();
+    }
+
+    py::object value() const override
+    {
+      if (arrayViewsEnabled())
+        return convertMatrixToArray(underlying_);
+      return convertMatrixToPython(makeShared<DenseMatrix>(*underlying_));
+    }
+
+  private:
+    DenseColumnMatrixHandle underlying_;
   };
 
   class PyDatatypeSparseRowMatrix : public PyDatatype
   {
   public:
-    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying), pyMat_(convertMatrixToPython(underlying))
+    explicit PyDatatypeSparseRowMatrix(SparseRowMatrixHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -125,18 +151,19 @@ namespace
 
     py::object value() const override
     {
-      return pyMat_;
+      if (arrayViewsEnabled())
+        return convertMatrixToArray(underlying_);
+      return convertMatrixToPython(underlying_);
     }
 
   private:
     SparseRowMatrixHandle underlying_;
-    py::dict pyMat_;
   };
 
   class PyDatatypeField : public PyDatatype
   {
   public:
-    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying), matlabStructure_(convertFieldToPython(underlying))
+    explicit PyDatatypeField(FieldHandle underlying) : underlying_(underlying)
     {
     }
 
@@ -147,12 +174,13 @@ namespace
 
     py::object value() const override
     {
-      return matlabStructure_;
+      if (arrayViewsEnabled())
+        return convertFieldToArrays(underlying_);
+      return convertFieldToPython(underlying_);
     }
 
   private:
     FieldHandle underlying_;
-    py::dict matlabStructure_;
   };
 
   class PyDatatypeFactory
@@ -170,6 +198,11 @@ namespace
         if (dense)
           return makeShared<PyDatatypeDenseMatrix>(dense);
       }
+      {
+        auto column = std::dynamic_pointer_cast<DenseColumnMatrix>(data);
+        if (column)
+          return makeShared<PyDatatypeDenseColumnMatrix>(column);
+      }
       {
         auto sparse = std::dynamic_pointer_cast<SparseRowMatrix>(data);
         if (sparse)
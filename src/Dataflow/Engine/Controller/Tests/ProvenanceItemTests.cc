@@ -34,6 +34,7 @@
 #include <Dataflow/Engine/Controller/ProvenanceItem.h>
 #include <Dataflow/Engine/Controller/ProvenanceItemFactory.h>
 #include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
 
 using namespace SCIRun;
 using namespace SCIRun::Dataflow::Engine;
@@ -76,3 +77,41 @@ TEST_F(ProvenanceItemTests, CanCreateRemoveModule)
 
   EXPECT_EQ("Module Removed: " + id, item.name());
 }
+
+namespace
+{
+  std::string toXml(NetworkFileHandle file)
+  {
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(*file, ostr, "networkFile");
+    return ostr.str();
+  }
+}
+
+TEST_F(ProvenanceItemTests, RecorderStoresDeltasBetweenKeyframes)
+{
+  NetworkStateRecorder recorder(3);
+  std::vector<NetworkFileHandle> snapshots;
+  std::vector<NetworkStateRecordHandle> records;
+
+  auto file = makeShared<NetworkFile>();
+  for (int i = 0; i < 7; ++i)
+  {
+    file = makeShared<NetworkFile>(*file);
+    ModuleLookupInfoXML info;
+    info.module_name_ = "ComputeSVD";
+    file->network.modules["ComputeSVD:" + std::to_string(i)] = ModuleWithState(info);
+    file->modulePositions.modulePositions["ComputeSVD:" + std::to_string(i)] = { 10.0 * i, 0 };
+    snapshots.push_back(file);
+    records.push_back(recorder.record(file));
+  }
+
+  for (size_t i = 0; i < records.size(); ++i)
+  {
+    EXPECT_EQ(i % 3 == 0, records[i]->isKeyframe());
+    EXPECT_EQ(toXml(snapshots[i]), toXml(records[i]->state()));
+  }
+
+  ModuleAddedProvenanceItem item("ComputeSVD", "ComputeSVD:6", records.back(), nullptr);
+  EXPECT_EQ(toXml(snapshots.back()), toXml(item.memento()));
+}
@@ -34,6 +34,7 @@
 #include <boost/python.hpp>
 #include <Dataflow/Engine/Python/NetworkEditorPythonInterface.h>
 #include <Dataflow/Engine/Python/NetworkEditorPythonAPI.h>
+#include <Core/Python/PythonArrayViews.h>
 #include <Dataflow/Engine/Python/share.h>
 
 BOOST_PYTHON_MODULE(SCIRunPythonAPI)
@@ -97,6 +98,8 @@ BOOST_PYTHON_MODULE(SCIRunPythonAPI)
   boost::python::def("scirun_get_module_input_object_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_object_index);
   boost::python::def("scirun_get_module_input_value_by_index", &NetworkEditorPythonAPI::scirun_get_module_input_value_index);
 
+  boost::python::def("scirun_use_array_views", &Core::Python::setArrayViewsEnabled);
+
   boost::python::def("get_input_data", &NetworkEditorPythonAPI::get_input_data);
   boost::python::def("get_output_data", &NetworkEditorPythonAPI::get_output_data);
   boost::python::def("set_output_data", &NetworkEditorPythonAPI::set_output_data);
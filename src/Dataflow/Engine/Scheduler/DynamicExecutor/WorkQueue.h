@@ -32,6 +32,9 @@
 #include <Dataflow/Network/NetworkFwd.h>
 #include <boost/next_prior.hpp>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <boost/noncopyable.hpp>
+#include <condition_variable>
+#include <mutex>
 #include <Dataflow/Engine/Scheduler/share.h>
 
 namespace SCIRun {
@@ -39,8 +42,45 @@ namespace Dataflow {
 namespace Engine {
   namespace DynamicExecutor {
 
+    /// Lock-free single-producer queue with a parking spot for the consumer, so the
+    /// consumer can sleep until work arrives instead of polling empty().
     template <class Unit>
-    using WorkQueue = boost::lockfree::spsc_queue<Unit>;
+    class WorkQueue : boost::noncopyable
+    {
+    public:
+      explicit WorkQueue(size_t capacity) : queue_(capacity) {}
+
+      bool push(const Unit& unit)
+      {
+        const auto pushed = queue_.push(unit);
+        wake();
+        return pushed;
+      }
+
+      bool pop(Unit& unit) { return queue_.pop(unit); }
+      template <class Functor>
+      bool consume_one(const Functor& f) { return queue_.consume_one(f); }
+      bool empty() { return queue_.empty(); }
+
+      /// Wakes the consumer so it re-evaluates its wait condition.
+      void wake()
+      {
+        { std::lock_guard<std::mutex> lock(waitLock_); }
+        workArrived_.notify_all();
+      }
+
+      template <class Pred>
+      void waitForWorkOr(Pred stop)
+      {
+        std::unique_lock<std::mutex> lock(waitLock_);
+        workArrived_.wait(lock, [&]() { return !queue_.empty() || stop(); });
+      }
+
+    private:
+      boost::lockfree::spsc_queue<Unit> queue_;
+      std::mutex waitLock_;
+      std::condition_variable workArrived_;
+    };
 
     typedef WorkQueue<Networks::ModuleHandle> ModuleWorkQueue;
     typedef SharedPointer<ModuleWorkQueue> ModuleWorkQueuePtr;
@@ -36,6 +36,7 @@
 #include <Core/Logging/Log.h>
 #include <Core/Thread/Mutex.h>
 #include <Core/Thread/Parallel.h>
+#include <Core/Thread/WorkStealingThreadPool.h>
 
 #include <Dataflow/Engine/Scheduler/share.h>
 
@@ -44,47 +45,34 @@ namespace Dataflow {
 namespace Engine {
 namespace DynamicExecutor {
 
+  /// Runs module executors on a persistent work-stealing pool sized to the
+  /// user's core limit, rather than one new thread per module.
   class SCISHARE ExecutionThreadGroup : boost::noncopyable
   {
   public:
     void startExecution(const ModuleExecutor& executor)
     {
-      //auto thread = 
-      executeThreads_.create_thread([=]() { executor.run(); });
-      //Core::Thread::Guard g(mapLock_->get());
-      //threadsByModuleId_[executor.module_->id().id_] = thread;
+      if (!pool_)
+        clear();
+      pool_->submit([executor]() { executor.run(); });
     }
     void joinAll()
     {
-      executeThreads_.join_all();
+      if (pool_)
+        pool_->waitForAll();
     }
+    /// Called before each execution; rebuilds the pool if the core limit changed since the last one.
     void clear()
     {
-      executeThreads_.clear();
-     // threadsByModuleId_.clear();
-      //std::ostringstream lockName;
-      //lockName << "threadMap " << this;
-      //mapLock_.reset(new Core::Thread::Mutex(lockName.str()));
+      const auto numWorkers = Core::Thread::Parallel::NumCores();
+      if (!pool_ || pool_->size() != numWorkers)
+      {
+        pool_.reset();
+        pool_.reset(new Core::Thread::WorkStealingThreadPool("module-executor", numWorkers));
+      }
     }
-    //std::thread* getThreadForModule(const std::string& moduleId) const
-    //{
-    //  if (!mapLock_)
-    //  {
-    //    return nullptr;
-    //  }
-    //  Core::Thread::Guard g(mapLock_->get());
-
-    //  auto it = threadsByModuleId_.find(moduleId);
-    //  if (it == threadsByModuleId_.end())
-    //    return nullptr;
-    //  if (!executeThreads_->is_thread_in(it->second))
-    //    return nullptr;
-    //  return it->second;
-    //}
   private:
-    mutable Core::Thread::ThreadGroup executeThreads_;
-    //std::map<std::string, std::thread*> threadsByModuleId_;
-    //mutable SharedPointer<Core::Thread::Mutex> mapLock_;
+    std::unique_ptr<Core::Thread::WorkStealingThreadPool> pool_;
   };
 
   typedef SharedPointer<ExecutionThreadGroup> ExecutionThreadGroupPtr;
@@ -111,30 +99,23 @@ namespace DynamicExecutor {
 
       //log_->trace_if(shouldLog_, "Consumer started.");
 
-      while (!producer_->isDone() || moreWork())
+      for (;;)
       {
-        if (moreWork())
-        {
-          //log_->trace_if(shouldLog_, "\tConsumer thinks work queue is not empty.");
-          //log_->trace_if(shouldLog_, "\tConsumer accessing front of work queue.");
-
-          Networks::ModuleHandle unit;
-          work_->pop(unit);
-
-          //log_->trace_if(shouldLog_, "\tConsumer popping front of work queue.");
+        work_->waitForWorkOr([this]() { return producer_->isDone(); });
 
+        Networks::ModuleHandle unit;
+        while (work_->pop(unit))
+        {
+          //log_->trace_if(shouldLog_, "~~~Processing {}", unit->get_id());
           if (unit)
           {
-            //log_->trace_if(shouldLog_, "~~~Processing {}", unit->get_id());
-
             ModuleExecutor executor(unit, lookup_, producer_);
             executeThreadGroup_->startExecution(executor);
           }
-          else
-          {
-            //log_->trace_if(shouldLog_, "\tConsumer received null module");
-          }
         }
+
+        if (producer_->isDone() && !moreWork())
+          break;
       }
      // log_->trace_if(shouldLog_, "Consumer done.");
     }
@@ -32,12 +32,14 @@
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkQueue.h>
 #include <Dataflow/Engine/Scheduler/DynamicExecutor/WorkUnitProducerInterface.h>
 #include <Dataflow/Engine/Scheduler/BoostGraphParallelScheduler.h>
+#include <Dataflow/Engine/Scheduler/ExecutionProfiler.h>
 #include <Dataflow/Network/NetworkInterface.h>
 #include <Core/Thread/Mutex.h>
 #include <boost/foreach.hpp>
 
 #include <Dataflow/Engine/Scheduler/share.h>
 
+#include <atomic>
 #include <iostream>
 
 namespace SCIRun {
@@ -58,9 +60,55 @@ namespace SCIRun {
             //log_.setVerbose(shouldLog_);
           }
 
+          // Called by every executor thread whose module finishes. A scan of the
+          // network sees every module that finished before it started, so
+          // threads that finish while another one is scanning only leave a
+          // request behind instead of queueing up on the lock, and the scanning
+          // thread repeats until no request is pending.
           void enqueueReadyModules() const override
           {
-            Core::Thread::Guard g(enqueueLock_->get());
+            rescanRequested_ = true;
+            if (scanning_.exchange(true))
+              return;
+            do
+            {
+              {
+                Core::Thread::Guard g(enqueueLock_->get());
+                while (rescanRequested_.exchange(false))
+                  scanReadyModules();
+              }
+              scanning_ = false;
+              work_->wake();
+            } while (rescanRequested_ && !scanning_.exchange(true));
+          }
+
+          void operator()() const
+          {
+            id_ = std::this_thread::get_id();
+
+            //log_->trace_if(shouldLog_, "Producer started {}", id_);
+
+            enqueueReadyModules();
+
+            while (!badGroup_ && !isDone())
+            {
+              std::this_thread::sleep_for(std::chrono::milliseconds(100));
+              //std::cout << "producer thread waiting " << id_ << std::endl;
+            }
+
+            if (badGroup_)
+              logCritical("producer is done with bad group, something went wrong. probably a race condition...");
+
+            //log_->trace_if(shouldLog_, "Producer is done. {}", id_);
+          }
+
+          bool isDone() const override
+          {
+            return doneCount_ >= numModules_;
+          }
+        private:
+          void scanReadyModules() const
+          {
             if (!isDone())
             {
               auto order = scheduler_.schedule(*network_);
@@ -89,6 +137,7 @@ namespace SCIRun {
                   }
                   else
                   {
+                    ExecutionProfiler::notifyModuleQueued(mod.second);
                     work_->push(module);
                     doneIds_.insert(mod.second);
                     doneCount_.fetch_add(1);
@@ -101,38 +150,15 @@ namespace SCIRun {
             }
           }
 
-          void operator()() const
-          {
-            id_ = std::this_thread::get_id();
-
-            //log_->trace_if(shouldLog_, "Producer started {}", id_);
-
-            enqueueReadyModules();
-
-            while (!badGroup_ && !isDone())
-            {
-              std::this_thread::sleep_for(std::chrono::milliseconds(100));
-              //std::cout << "producer thread waiting " << id_ << std::endl;
-            }
-
-            if (badGroup_)
-              logCritical("producer is done with bad group, something went wrong. probably a race condition...");
-
-            //log_->trace_if(shouldLog_, "Producer is done. {}", id_);
-          }
-
-          bool isDone() const override
-          {
-            return doneCount_ >= numModules_;
-          }
-        private:
           BoostGraphParallelScheduler scheduler_;
           const Networks::NetworkStateInterface* network_;
           Core::Thread::Mutex* enqueueLock_;
           ModuleWorkQueuePtr work_;
           mutable boost::atomic<int> doneCount_;
-          mutable bool badGroup_;
+          mutable std::atomic<bool> badGroup_;
           mutable std::set<Networks::ModuleId> doneIds_;
+          mutable std::atomic<bool> rescanRequested_ { false };
+          mutable std::atomic<bool> scanning_ { false };
           //static Core::Logging::Logger2 log_;
           //bool shouldLog_;
           size_t numModules_;
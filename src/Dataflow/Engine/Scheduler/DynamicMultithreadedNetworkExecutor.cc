@@ -70,6 +70,7 @@ namespace SCIRun {
         int run() const
         {
           Guard g(executionLock_->get());
+          executeThreads_->clear();
 
           ScopedExecutionBoundsSignaller signaller(bounds_, [=]() { return lookup_->errorCode(); });
 
@@ -106,8 +107,6 @@ std::future<int> DynamicMultithreadedNetworkExecutor::execute(const ExecutionCon
 {
   static Mutex lock("live-scheduler");
 
-  threadGroup_->clear();
-
   auto runner = makeShared<DynamicMultithreadedNetworkExecutorImpl>(context, &network_, &lock, order.size(), &executionLock, threadGroup_);
   std::packaged_task<int()> task([runner] { return runner->run(); });
   auto value = task.get_future();
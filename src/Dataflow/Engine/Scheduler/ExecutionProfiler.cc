@@ -0,0 +1,464 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Engine/Scheduler/ExecutionProfiler.h>
+#include <Dataflow/Engine/Scheduler/ExecutionStrategy.h>
+#include <Dataflow/Engine/Scheduler/GraphNetworkAnalyzer.h>
+#include <Dataflow/Network/NetworkInterface.h>
+#include <Dataflow/Network/ModuleInterface.h>
+#include <Dataflow/Network/PortInterface.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/DenseColumnMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/String.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/GeometryPrimitives/Point.h>
+#include <Core/GeometryPrimitives/Tensor.h>
+#include <Core/Logging/Log.h>
+#include <fstream>
+#include <iomanip>
+
+#ifdef _WIN32
+#  include <windows.h>
+#  include <psapi.h>
+#else
+#  include <ctime>
+#  include <sys/resource.h>
+#endif
+
+using namespace SCIRun;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Dataflow::Engine::NetworkGraph;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+std::atomic<ExecutionProfiler*> ExecutionProfiler::active_(nullptr);
+
+size_t ModuleProfile::outputBytes() const
+{
+  size_t total = 0;
+  for (const auto& output : outputs)
+    total += output.bytes;
+  return total;
+}
+
+ExecutionProfiler::ExecutionProfiler(NetworkSource network) : network_(network), lock_("executionProfiler")
+{
+}
+
+ExecutionProfiler::~ExecutionProfiler()
+{
+  auto self = this;
+  active_.compare_exchange_strong(self, nullptr);
+}
+
+void ExecutionProfiler::attach(ProfileFinished onFinish)
+{
+  onFinish_ = onFinish;
+  active_ = this;
+  connections_.emplace_back(ExecutionContext::connectGlobalNetworkExecutionStarts([this]() { executionStarts(); }));
+  connections_.emplace_back(ExecutionContext::connectGlobalNetworkExecutionFinished([this](int code) { executionFinishes(code); }));
+}
+
+int64_t ExecutionProfiler::now() const
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - executionStart_).count();
+}
+
+void ExecutionProfiler::executionStarts()
+{
+  {
+    Guard g(lock_.get());
+    executionStart_ = std::chrono::steady_clock::now();
+    profiles_.clear();
+    running_.clear();
+    threads_.clear();
+    criticalPath_.clear();
+    totalTime_ = 0;
+  }
+
+  // the module list can change between executions, so reconnect every time,
+  // keeping only the two global connections made in attach().
+  if (connections_.size() > 2)
+    connections_.erase(connections_.begin() + 2, connections_.end());
+
+  auto network = network_ ? network_() : nullptr;
+  if (!network)
+    return;
+  for (size_t i = 0; i < network->nmodules(); ++i)
+  {
+    auto module = network->module(i);
+    auto* exec = network->lookupExecutable(module->id());
+    if (!exec)
+      continue;
+    connections_.emplace_back(exec->connectExecuteBegins([this](const ModuleId& id) { moduleBegins(id); }));
+    connections_.emplace_back(exec->connectExecuteEnds([this](double, const ModuleId& id) { moduleEnds(id); }));
+  }
+}
+
+void ExecutionProfiler::notifyModuleQueued(const ModuleId& id)
+{
+  if (auto* profiler = active_.load())
+    profiler->moduleQueued(id);
+}
+
+void ExecutionProfiler::moduleQueued(const ModuleId& id)
+{
+  Guard g(lock_.get());
+  auto& profile = profiles_[id];
+  profile.id = id;
+  profile.queuedAt = now();
+}
+
+void ExecutionProfiler::moduleBegins(const ModuleId& id)
+{
+  const auto cpu = threadCpuTime();
+  const auto memory = peakResidentMemory();
+  Guard g(lock_.get());
+  auto& profile = profiles_[id];
+  profile.id = id;
+  profile.start = now();
+  auto thread = threads_.emplace(std::this_thread::get_id(), threads_.size() + 1);
+  profile.thread = thread.first->second;
+  running_[id] = std::make_pair(cpu, memory);
+}
+
+void ExecutionProfiler::moduleEnds(const ModuleId& id)
+{
+  const auto cpu = threadCpuTime();
+  const auto memory = peakResidentMemory();
+
+  std::vector<OutputProfile> outputs;
+  auto network = network_ ? network_() : nullptr;
+  if (auto module = network ? network->lookupModule(id) : nullptr)
+  {
+    for (const auto& port : module->outputPorts())
+    {
+      if (port->hasData())
+      {
+        auto data = port->peekData();
+        outputs.push_back({ port->externalId().toString(), data ? data->dynamic_type_name() : "", estimatedSizeInBytes(data) });
+      }
+    }
+  }
+
+  Guard g(lock_.get());
+  auto& profile = profiles_[id];
+  profile.end = now();
+  auto begin = running_.find(id);
+  if (begin != running_.end())
+  {
+    profile.cpuTime = cpu - begin->second.first;
+    profile.peakMemoryDelta = memory - begin->second.second;
+    running_.erase(begin);
+  }
+  profile.outputs = outputs;
+}
+
+void ExecutionProfiler::executionFinishes(int code)
+{
+  {
+    Guard g(lock_.get());
+    totalTime_ = now();
+  }
+  try
+  {
+    computeCriticalPath();
+  }
+  catch (NetworkHasCyclesException&)
+  {
+    logWarning("Execution profiler: network has cycles, no critical path computed.");
+  }
+  if (onFinish_)
+    onFinish_(*this, code);
+}
+
+std::vector<ModuleId> ExecutionProfiler::computeCriticalPath()
+{
+  auto network = network_ ? network_() : nullptr;
+  Guard g(lock_.get());
+  criticalPath_.clear();
+  if (!network || profiles_.empty())
+    return criticalPath_;
+
+  // only modules that ran are part of the graph, so an upstream module that was
+  // not re-executed does not extend the path.
+  auto ran = [this](ModuleHandle mh) { auto p = profiles_.find(mh->id()); return p != profiles_.end() && p->second.end > 0; };
+  NetworkGraphAnalyzer analyzer(*network, ran, true);
+  const auto& graph = analyzer.graph();
+
+  std::vector<int64_t> finish(analyzer.moduleCount(), 0);
+  std::vector<int> previous(analyzer.moduleCount(), -1);
+  int last = -1;
+  for (auto v = analyzer.topologicalBegin(); v != analyzer.topologicalEnd(); ++v)
+  {
+    int64_t longestInput = 0;
+    for (auto e : boost::make_iterator_range(boost::in_edges(*v, graph)))
+    {
+      const auto u = boost::source(e, graph);
+      if (previous[*v] < 0 || finish[u] > longestInput)
+      {
+        longestInput = finish[u];
+        previous[*v] = static_cast<int>(u);
+      }
+    }
+    finish[*v] = longestInput + profiles_[analyzer.moduleAt(*v)].wallTime();
+    if (last < 0 || finish[*v] > finish[last])
+      last = static_cast<int>(*v);
+  }
+
+  for (int v = last; v >= 0; v = previous[v])
+    criticalPath_.insert(criticalPath_.begin(), analyzer.moduleAt(v));
+
+  for (auto& profile : profiles_)
+    profile.second.onCriticalPath = false;
+  for (const auto& id : criticalPath_)
+    profiles_[id].onCriticalPath = true;
+  return criticalPath_;
+}
+
+int64_t ExecutionProfiler::criticalPathTime() const
+{
+  Guard g(lock_.get());
+  int64_t total = 0;
+  for (const auto& id : criticalPath_)
+  {
+    auto p = profiles_.find(id);
+    if (p != profiles_.end())
+      total += p->second.wallTime();
+  }
+  return total;
+}
+
+std::vector<ModuleProfile> ExecutionProfiler::profiles() const
+{
+  Guard g(lock_.get());
+  std::vector<ModuleProfile> result;
+  for (const auto& p : profiles_)
+    result.push_back(p.second);
+  std::sort(result.begin(), result.end(), [](const ModuleProfile& a, const ModuleProfile& b) { return a.start < b.start; });
+  return result;
+}
+
+namespace
+{
+  std::string jsonString(const std::string& s)
+  {
+    std::ostringstream out;
+    out << '"';
+    for (auto c : s)
+    {
+      switch (c)
+      {
+      case '"': out << "\\\""; break;
+      case '\\': out << "\\\\"; break;
+      case '\n': out << "\\n"; break;
+      case '\t': out << "\\t"; break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20)
+          out << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec;
+        else
+          out << c;
+      }
+    }
+    out << '"';
+    return out.str();
+  }
+}
+
+void ExecutionProfiler::writeChromeTrace(std::ostream& out) const
+{
+  const auto modules = profiles();
+  const auto path = criticalPath();
+  Guard g(lock_.get());
+
+  out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"SCIRun network\"}}";
+  for (const auto& thread : threads_)
+  {
+    out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.second
+      << ",\"args\":{\"name\":\"executor " << thread.second << "\"}}";
+  }
+  for (const auto& m : modules)
+  {
+    if (m.end <= 0)
+      continue;
+    out << ",\n{\"name\":" << jsonString(m.id.id_) << ",\"cat\":\"module\",\"ph\":\"X\",\"pid\":1"
+      << ",\"tid\":" << m.thread << ",\"ts\":" << m.start << ",\"dur\":" << m.wallTime();
+    if (m.onCriticalPath)
+      out << ",\"cname\":\"terrible\"";
+    out << ",\"args\":{\"module\":" << jsonString(m.id.name_)
+      << ",\"cpuTimeUs\":" << m.cpuTime
+      << ",\"queueWaitUs\":" << m.queueWait()
+      << ",\"peakMemoryDeltaBytes\":" << m.peakMemoryDelta
+      << ",\"outputBytes\":" << m.outputBytes()
+      << ",\"criticalPath\":" << (m.onCriticalPath ? "true" : "false")
+      << ",\"outputs\":[";
+    for (size_t i = 0; i < m.outputs.size(); ++i)
+    {
+      out << (i > 0 ? "," : "") << "{\"port\":" << jsonString(m.outputs[i].port)
+        << ",\"type\":" << jsonString(m.outputs[i].type) << ",\"bytes\":" << m.outputs[i].bytes << "}";
+    }
+    out << "]}}";
+  }
+  out << "\n],\"otherData\":{\"totalTimeUs\":" << totalTime_ << ",\"criticalPath\":[";
+  int64_t pathTime = 0;
+  for (size_t i = 0; i < path.size(); ++i)
+  {
+    out << (i > 0 ? "," : "") << jsonString(path[i].id_);
+    auto p = profiles_.find(path[i]);
+    if (p != profiles_.end())
+      pathTime += p->second.wallTime();
+  }
+  out << "],\"criticalPathUs\":" << pathTime << "}}\n";
+}
+
+bool ExecutionProfiler::writeChromeTrace(const std::string& filename) const
+{
+  std::ofstream file(filename);
+  if (!file)
+    return false;
+  writeChromeTrace(file);
+  return static_cast<bool>(file);
+}
+
+namespace
+{
+  template <class T>
+  size_t denseSize(const DenseMatrixGeneric<T>& m) { return m.size() * sizeof(T); }
+
+  template <class T>
+  size_t columnSize(const DenseColumnMatrixGeneric<T>& m) { return m.size() * sizeof(T); }
+
+  template <class T>
+  size_t sparseSize(const SparseRowMatrixGeneric<T>& m)
+  {
+    using Index = typename SparseRowMatrixGeneric<T>::StorageIndex;
+    return m.nonZeros() * (sizeof(T) + sizeof(Index)) + (m.outerSize() + 1) * sizeof(Index);
+  }
+
+  size_t valueSize(VField* vfield)
+  {
+    if (vfield->is_vector())
+      return sizeof(Vector);
+    if (vfield->is_tensor())
+      return sizeof(Tensor);
+    if (vfield->is_char() || vfield->is_unsigned_char())
+      return sizeof(char);
+    if (vfield->is_short() || vfield->is_unsigned_short())
+      return sizeof(short);
+    if (vfield->is_int() || vfield->is_unsigned_int() || vfield->is_float())
+      return sizeof(int);
+    if (vfield->is_complex_double())
+      return 2 * sizeof(double);
+    return sizeof(double);
+  }
+
+  /// Regular meshes only store a transform and structured meshes keep no
+  /// connectivity, so only the arrays a mesh actually holds are counted.
+  size_t fieldSize(const Field& field)
+  {
+    auto vmesh = field.vmesh();
+    auto vfield = field.vfield();
+    size_t size = 0;
+    if (vmesh)
+    {
+      if (!vmesh->is_regularmesh())
+        size += vmesh->num_nodes() * sizeof(Point);
+      if (vmesh->is_unstructuredmesh())
+        size += vmesh->num_elems() * vmesh->num_nodes_per_elem() * sizeof(VMesh::index_type);
+    }
+    if (vfield)
+      size += vfield->num_values() * valueSize(vfield);
+    return size;
+  }
+}
+
+size_t ExecutionProfiler::estimatedSizeInBytes(const DatatypeHandle& data)
+{
+  if (!data)
+    return 0;
+  if (auto dense = data->as<DenseMatrix>())
+    return denseSize(*dense);
+  if (auto dense = data->as<ComplexDenseMatrix>())
+    return denseSize(*dense);
+  if (auto column = data->as<DenseColumnMatrix>())
+    return columnSize(*column);
+  if (auto column = data->as<ComplexDenseColumnMatrix>())
+    return columnSize(*column);
+  if (auto sparse = data->as<SparseRowMatrix>())
+    return sparseSize(*sparse);
+  if (auto sparse = data->as<ComplexSparseRowMatrix>())
+    return sparseSize(*sparse);
+  if (auto str = data->as<String>())
+    return str->value().size();
+  if (auto field = data->as<Field>())
+    return fieldSize(*field);
+  /// @todo: geometry reports 0 until Datatype grows a size query
+  return 0;
+}
+
+int64_t ExecutionProfiler::threadCpuTime()
+{
+#ifdef _WIN32
+  FILETIME creation, exit, kernel, user;
+  if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+    return 0;
+  auto ticks = [](const FILETIME& f) { return (static_cast<int64_t>(f.dwHighDateTime) << 32) | f.dwLowDateTime; };
+  return (ticks(kernel) + ticks(user)) / 10;
+#else
+  timespec ts;
+  if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0)
+    return 0;
+  return static_cast<int64_t>(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+#endif
+}
+
+int64_t ExecutionProfiler::peakResidentMemory()
+{
+#ifdef _WIN32
+  PROCESS_MEMORY_COUNTERS counters;
+  if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    return 0;
+  return static_cast<int64_t>(counters.PeakWorkingSetSize);
+#else
+  rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0)
+    return 0;
+#ifdef __APPLE__
+  return static_cast<int64_t>(usage.ru_maxrss);
+#else
+  return static_cast<int64_t>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
@@ -0,0 +1,136 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef ENGINE_SCHEDULER_EXECUTION_PROFILER_H
+#define ENGINE_SCHEDULER_EXECUTION_PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <iosfwd>
+#include <map>
+#include <thread>
+#include <Dataflow/Network/NetworkFwd.h>
+#include <Dataflow/Network/ModuleDescription.h>
+#include <Core/Datatypes/DatatypeFwd.h>
+#include <Core/Thread/Mutex.h>
+#include <boost/signals2.hpp>
+#include <Dataflow/Engine/Scheduler/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Engine {
+
+  struct SCISHARE OutputProfile
+  {
+    std::string port;
+    std::string type;
+    size_t bytes {0};
+  };
+
+  /// Everything measured for one module during one network execution. Times are
+  /// in microseconds from the start of the execution.
+  struct SCISHARE ModuleProfile
+  {
+    Networks::ModuleId id;
+    int64_t queuedAt {-1};
+    int64_t start {0};
+    int64_t end {0};
+    int64_t cpuTime {0};
+    /// Growth of the process' peak resident set while the module ran, in bytes.
+    /// Modules running concurrently share this, so it is only exact for serial runs.
+    int64_t peakMemoryDelta {0};
+    size_t thread {0};
+    bool onCriticalPath {false};
+    std::vector<OutputProfile> outputs;
+
+    int64_t wallTime() const { return end - start; }
+    int64_t queueWait() const { return queuedAt >= 0 ? start - queuedAt : 0; }
+    size_t outputBytes() const;
+  };
+
+  /// Records per-module timing, memory and output sizes for every network execution
+  /// and finds the chain of connected modules that bounded its total time.
+  /// Attach it before executing; it subscribes to the global execution bounds and
+  /// to each module's execute signals when an execution starts.
+  class SCISHARE ExecutionProfiler : boost::noncopyable
+  {
+  public:
+    using NetworkSource = std::function<Networks::NetworkStateHandle()>;
+    using ProfileFinished = std::function<void(const ExecutionProfiler&, int)>;
+
+    explicit ExecutionProfiler(NetworkSource network);
+    ~ExecutionProfiler();
+
+    /// Subscribes to the global execution signals. The callback runs after each
+    /// execution's critical path has been computed.
+    void attach(ProfileFinished onFinish = {});
+
+    void executionStarts();
+    void executionFinishes(int code);
+    void moduleQueued(const Networks::ModuleId& id);
+    void moduleBegins(const Networks::ModuleId& id);
+    void moduleEnds(const Networks::ModuleId& id);
+
+    /// Longest chain of connected modules by wall time, in execution order.
+    std::vector<Networks::ModuleId> computeCriticalPath();
+    const std::vector<Networks::ModuleId>& criticalPath() const { return criticalPath_; }
+    int64_t criticalPathTime() const;
+    int64_t totalTime() const { return totalTime_; }
+    std::vector<ModuleProfile> profiles() const;
+
+    /// Chrome trace event format, readable by chrome://tracing and Perfetto.
+    void writeChromeTrace(std::ostream& out) const;
+    bool writeChromeTrace(const std::string& filename) const;
+
+    /// Called from the scheduler when a module is handed to the work queue.
+    static void notifyModuleQueued(const Networks::ModuleId& id);
+    static size_t estimatedSizeInBytes(const Core::Datatypes::DatatypeHandle& data);
+
+  private:
+    int64_t now() const;
+    static int64_t threadCpuTime();
+    static int64_t peakResidentMemory();
+
+    NetworkSource network_;
+    ProfileFinished onFinish_;
+    mutable Core::Thread::Mutex lock_;
+    std::chrono::steady_clock::time_point executionStart_;
+    std::map<Networks::ModuleId, ModuleProfile> profiles_;
+    std::map<Networks::ModuleId, std::pair<int64_t, int64_t>> running_;
+    std::map<std::thread::id, size_t> threads_;
+    std::vector<Networks::ModuleId> criticalPath_;
+    int64_t totalTime_ {0};
+    std::vector<boost::signals2::scoped_connection> connections_;
+    static std::atomic<ExecutionProfiler*> active_;
+  };
+
+}}}
+
+#endif
@@ -0,0 +1,236 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+#include <Dataflow/Engine/Scheduler/ExecutionProfiler.h>
+#include <Dataflow/Network/Tests/MockNetwork.h>
+#include <Dataflow/Network/Tests/MockModule.h>
+#include <Core/Datatypes/DenseMatrix.h>
+#include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/String.h>
+#include <Core/Datatypes/Legacy/Field/Field.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+
+using namespace SCIRun;
+using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Dataflow::Networks::Mocks;
+using namespace SCIRun::Dataflow::Engine;
+using namespace SCIRun::Core::Geometry;
+
+using ::testing::_;
+using ::testing::NiceMock;
+using ::testing::Return;
+using ::testing::HasSubstr;
+
+class ExecutionProfilerTests : public ::testing::Test
+{
+protected:
+  //Test network:
+  /*
+      a
+     / \
+    b   c     e
+     \ /
+      d
+  */
+  void SetUp() override
+  {
+    network_.reset(new NiceMock<MockNetwork>);
+    const std::vector<std::string> names { "a", "b", "c", "d", "e" };
+    for (const auto& name : names)
+    {
+      ModuleId id(name, 0);
+      auto module = makeShared<NiceMock<MockModule>>();
+      ON_CALL(*module, id()).WillByDefault(Return(id));
+      ON_CALL(*network_, lookupModule(id)).WillByDefault(Return(module));
+      ids_[name] = id;
+      modules_.push_back(module);
+    }
+    ON_CALL(*network_, nmodules()).WillByDefault(Return(modules_.size()));
+    for (size_t i = 0; i < modules_.size(); ++i)
+      ON_CALL(*network_, module(i)).WillByDefault(Return(modules_[i]));
+
+    NetworkStateInterface::ConnectionDescriptionList connections;
+    auto connect = [&](const std::string& from, const std::string& to)
+    {
+      connections.push_back(ConnectionDescription(OutgoingConnectionDescription(ids_[from], PortId(0, "out")),
+        IncomingConnectionDescription(ids_[to], PortId(0, "in"))));
+    };
+    connect("a", "b");
+    connect("a", "c");
+    connect("b", "d");
+    connect("c", "d");
+    ON_CALL(*network_, connections(_)).WillByDefault(Return(connections));
+  }
+
+  void run(ExecutionProfiler& profiler, const std::string& name, int milliseconds)
+  {
+    profiler.moduleQueued(ids_[name]);
+    profiler.moduleBegins(ids_[name]);
+    std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+    profiler.moduleEnds(ids_[name]);
+  }
+
+  void runDiamond(ExecutionProfiler& profiler)
+  {
+    profiler.executionStarts();
+    run(profiler, "a", 5);
+    run(profiler, "e", 5);
+    run(profiler, "c", 1);
+    run(profiler, "b", 60);
+    run(profiler, "d", 5);
+    profiler.executionFinishes(0);
+  }
+
+  SharedPointer<NiceMock<MockNetwork>> network_;
+  std::vector<ModuleHandle> modules_;
+  std::map<std::string, ModuleId> ids_;
+};
+
+TEST_F(ExecutionProfilerTests, RecordsEveryExecutedModule)
+{
+  ExecutionProfiler profiler([this]() { return network_; });
+  runDiamond(profiler);
+
+  auto profiles = profiler.profiles();
+  ASSERT_EQ(5, profiles.size());
+  for (const auto& p : profiles)
+  {
+    EXPECT_GE(p.start, 0);
+    EXPECT_GE(p.end, p.start);
+    EXPECT_GE(p.queueWait(), 0);
+    EXPECT_EQ(1, p.thread);
+  }
+  EXPECT_EQ(ids_["a"], profiles.front().id);
+  EXPECT_EQ(ids_["d"], profiles.back().id);
+  EXPECT_GE(profiles[3].wallTime(), 60000);
+  EXPECT_GE(profiler.totalTime(), profiles.back().end);
+}
+
+TEST_F(ExecutionProfilerTests, CriticalPathFollowsLongestConnectedChain)
+{
+  ExecutionProfiler profiler([this]() { return network_; });
+  runDiamond(profiler);
+
+  std::vector<ModuleId> expected { ids_["a"], ids_["b"], ids_["d"] };
+  EXPECT_EQ(expected, profiler.criticalPath());
+  EXPECT_GE(profiler.criticalPathTime(), 70000);
+  EXPECT_LE(profiler.criticalPathTime(), profiler.totalTime());
+
+  for (const auto& p : profiler.profiles())
+    EXPECT_EQ(p.id == ids_["a"] || p.id == ids_["b"] || p.id == ids_["d"], p.onCriticalPath) << p.id.id_;
+}
+
+TEST_F(ExecutionProfilerTests, OnlyModulesThatRanAreOnTheCriticalPath)
+{
+  ExecutionProfiler profiler([this]() { return network_; });
+  profiler.executionStarts();
+  run(profiler, "c", 20);
+  run(profiler, "d", 1);
+  profiler.executionFinishes(0);
+
+  std::vector<ModuleId> expected { ids_["c"], ids_["d"] };
+  EXPECT_EQ(expected, profiler.criticalPath());
+}
+
+TEST_F(ExecutionProfilerTests, WritesChromeTraceEvents)
+{
+  ExecutionProfiler profiler([this]() { return network_; });
+  runDiamond(profiler);
+
+  std::ostringstream trace;
+  profiler.writeChromeTrace(trace);
+  auto json = trace.str();
+
+  EXPECT_THAT(json, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(json, HasSubstr("\"ph\":\"X\""));
+  for (const auto& name : { "a", "b", "c", "d", "e" })
+    EXPECT_THAT(json, HasSubstr("\"name\":\"" + ids_[name].id_ + "\""));
+  EXPECT_THAT(json, HasSubstr("\"criticalPath\":[\"" + ids_["a"].id_ + "\",\"" + ids_["b"].id_ + "\",\"" + ids_["d"].id_ + "\"]"));
+  EXPECT_THAT(json, HasSubstr("\"cpuTimeUs\":"));
+  EXPECT_THAT(json, HasSubstr("\"queueWaitUs\":"));
+  EXPECT_THAT(json, HasSubstr("\"peakMemoryDeltaBytes\":"));
+}
+
+TEST_F(ExecutionProfilerTests, FinishCallbackRunsAfterCriticalPath)
+{
+  ExecutionProfiler profiler([this]() { return network_; });
+  std::vector<ModuleId> pathAtFinish;
+  int code = -1;
+  profiler.attach([&](const ExecutionProfiler& p, int c) { pathAtFinish = p.criticalPath(); code = c; });
+  runDiamond(profiler);
+
+  EXPECT_EQ(0, code);
+  EXPECT_EQ(3, pathAtFinish.size());
+}
+
+TEST(ExecutionProfilerSizeTests, EstimatesMatrixAndStringSizes)
+{
+  EXPECT_EQ(0, ExecutionProfiler::estimatedSizeInBytes(nullptr));
+
+  DatatypeHandle dense(new DenseMatrix(3, 4, 1.0));
+  EXPECT_EQ(12 * sizeof(double), ExecutionProfiler::estimatedSizeInBytes(dense));
+
+  auto sparse = makeShared<SparseRowMatrix>(10, 10);
+  sparse->insert(0, 0) = 1;
+  sparse->insert(5, 7) = 2;
+  sparse->makeCompressed();
+  const auto indexSize = sizeof(SparseRowMatrix::StorageIndex);
+  EXPECT_EQ(2 * (sizeof(double) + indexSize) + 11 * indexSize, ExecutionProfiler::estimatedSizeInBytes(sparse));
+
+  DatatypeHandle str(new String("profile"));
+  EXPECT_EQ(7, ExecutionProfiler::estimatedSizeInBytes(str));
+}
+
+TEST(ExecutionProfilerSizeTests, EstimatesFieldSizes)
+{
+  FieldInformation tetInfo("TetVolMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "double");
+  auto tetMesh = CreateMesh(tetInfo);
+  auto vmesh = tetMesh->vmesh();
+  vmesh->add_point(Point(0, 0, 0));
+  vmesh->add_point(Point(1, 0, 0));
+  vmesh->add_point(Point(0, 1, 0));
+  vmesh->add_point(Point(0, 0, 1));
+  VMesh::Node::array_type nodes(4);
+  for (VMesh::index_type i = 0; i < 4; ++i)
+    nodes[i] = i;
+  vmesh->add_elem(nodes);
+  auto tet = CreateField(tetInfo, tetMesh);
+  tet->vfield()->resize_values();
+  EXPECT_EQ(4 * sizeof(Point) + 4 * sizeof(VMesh::index_type) + 4 * sizeof(double),
+    ExecutionProfiler::estimatedSizeInBytes(tet));
+
+  FieldInformation latInfo("LatVolMesh", static_cast<int>(databasis_info_type::LINEARDATA_E), "Vector");
+  auto lat = CreateField(latInfo, CreateMesh(latInfo, 2, 3, 4, Point(0, 0, 0), Point(1, 1, 1)));
+  EXPECT_EQ(24 * sizeof(Vector), ExecutionProfiler::estimatedSizeInBytes(lat));
+}
@@ -588,7 +588,8 @@ DatatypeHandleOption Module::get_input_handle(const PortId& id)
   {
     //Log::get() << DEBUG_LOG << id_ << " :: inputsChanged is " << inputsChanged_ << ", querying port for value." << std::endl;
     // NOTE: don't use short-circuited boolean OR here, we need to call hasChanged each time since it updates the port's cache flag.
-    impl_->inputsChanged_ = port->hasChanged() || impl_->inputsChanged_;
+    if (port->hasChanged())
+      impl_->inputsChanged_ = true;
     //Log::get() << DEBUG_LOG << id_ << ":: inputsChanged is now " << inputsChanged_ << std::endl;
   }
 
@@ -609,8 +610,9 @@ std::vector<DatatypeHandleOption> Module::get_dynamic_input_handles(const PortId
   {
     LOG_TRACE("{} :: inputsChanged is {}, querying port for value.", id().id_, impl_->inputsChanged_);
     // NOTE: don't use short-circuited boolean OR here, we need to call hasChanged each time since it updates the port's cache flag.
-    bool startingVal = impl_->inputsChanged_;
-    impl_->inputsChanged_ = std::accumulate(portsWithName.begin(), portsWithName.end(), startingVal, [](bool acc, InputPortHandle input) { return input->hasChanged() || acc; });
+    const bool changed = std::accumulate(portsWithName.begin(), portsWithName.end(), false, [](bool acc, InputPortHandle input) { return input->hasChanged() || acc; });
+    if (changed)
+      impl_->inputsChanged_ = true;
     LOG_TRACE("{} :: inputsChanged is now {}.", id().id_, impl_->inputsChanged_);
   }
 
@@ -900,20 +902,18 @@ ModuleExecutionState& Module::executionState()
 
 /// @todo:
 // need to hook up output ports for cached state.
+// Every flag read here is atomic and owned by this module, so executor
+// threads can check different modules without serializing on a lock.
 bool Module::needToExecute() const
 {
-  static Mutex needToExecuteLock("needToExecute");
   if (impl_->reexecute_)
   {
-    //Test fix for reexecute problem. Seems like it could be a race condition, but not sure.
-    Guard g(needToExecuteLock.get());
     if (impl_->threadStopped_)
     {
       return true;
     }
-    if (getLogger()->errorReported())
+    if (getLogger()->takeErrorFlag())
     {
-      getLogger()->setErrorFlag(false);
       return true;
     }
     auto val = impl_->reexecute_->needToExecute();
@@ -72,6 +72,7 @@ namespace Networks {
     void error(const std::string& msg) const override final;
     bool errorReported() const override final { return getLogger()->errorReported(); }
     void setErrorFlag(bool flag) override final { getLogger()->setErrorFlag(flag); }
+    bool takeErrorFlag() override final { return getLogger()->takeErrorFlag(); }
     void warning(const std::string& msg) const override final { getLogger()->warning(msg); }
     void remark(const std::string& msg) const override final { getLogger()->remark(msg); }
     void status(const std::string& msg) const override final { getLogger()->status(msg); }
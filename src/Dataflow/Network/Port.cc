@@ -63,9 +63,7 @@ void Port::attach(Connection* conn)
 
 bool Port::hasConnectionCountIncreased() const
 {
-  auto val = connectionCountIncreasedFlag_;
-  connectionCountIncreasedFlag_ = false;
-  return val;
+  return connectionCountIncreasedFlag_.exchange(false);
 }
 
 void Port::detach(Connection* conn)
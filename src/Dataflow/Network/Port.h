@@ -32,6 +32,7 @@
 #ifndef DATAFLOW_NETWORK_PORT_H
 #define DATAFLOW_NETWORK_PORT_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <boost/noncopyable.hpp>
@@ -94,7 +95,7 @@ protected:
   const std::string typeName_;
   const std::string portName_;
   const std::string colorName_;
-  mutable bool connectionCountIncreasedFlag_;
+  mutable std::atomic<bool> connectionCountIncreasedFlag_;
 };
 
 #ifdef WIN32
@@ -34,6 +34,8 @@
 #include <gmock/gmock.h>
 
 #include <stdexcept>
+#include <atomic>
+#include <thread>
 
 using namespace SCIRun::Core;
 using namespace SCIRun::Dataflow::Networks;
@@ -105,6 +107,24 @@ TEST_F(PortTests, InputPortTakesAtMostOneConnection)
   EXPECT_THROW(Connection c(outputPort2, inputPort, "test", false), InvalidArgumentException);
 }
 
+TEST_F(PortTests, ConnectionCountIncreaseIsReportedOnceAcrossThreads)
+{
+  Port::ConstructionParams pcp(PortId(0, "ForwardMatrix"), "Matrix", false);
+  InputPortHandle inputPort(new InputPort(inputModule.get(), pcp, DatatypeSinkInterfaceHandle()));
+  OutputPortHandle outputPort(new OutputPort(outputModule.get(), pcp, DatatypeSourceInterfaceHandle()));
+  Connection c(outputPort, inputPort, "test", false);
+
+  std::atomic<int> reported { 0 };
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i)
+    threads.emplace_back([&]() { if (outputPort->hasConnectionCountIncreased()) ++reported; });
+  for (auto& t : threads)
+    t.join();
+
+  EXPECT_EQ(1, reported);
+  EXPECT_FALSE(outputPort->hasConnectionCountIncreased());
+}
+
 /// @todo: this verification pushed up to higher layer.
 TEST_F(PortTests, DISABLED_CannotConnectPortsWithDifferentDatatypes)
 {
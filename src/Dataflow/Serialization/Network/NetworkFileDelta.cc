@@ -0,0 +1,207 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <Dataflow/Network/ConnectionId.h>
+#include <algorithm>
+
+using namespace SCIRun::Dataflow::Networks;
+
+namespace
+{
+  bool sameNote(const NoteXML& lhs, const NoteXML& rhs)
+  {
+    return lhs.noteHTML == rhs.noteHTML && lhs.noteText == rhs.noteText
+      && lhs.position == rhs.position && lhs.fontSize == rhs.fontSize;
+  }
+
+  bool sameNotes(const NotesMapXML& lhs, const NotesMapXML& rhs)
+  {
+    return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin(),
+      [](const NotesMapXML::value_type& l, const NotesMapXML::value_type& r) { return l.first == r.first && sameNote(l.second, r.second); });
+  }
+
+  bool sameTags(const ModuleTags& lhs, const ModuleTags& rhs)
+  {
+    return lhs.tags == rhs.tags && lhs.labels == rhs.labels && lhs.showTagGroupsOnLoad == rhs.showTagGroupsOnLoad;
+  }
+
+  bool sameDisabled(const DisabledComponents& lhs, const DisabledComponents& rhs)
+  {
+    return lhs.disabledModules == rhs.disabledModules && lhs.disabledConnections == rhs.disabledConnections;
+  }
+
+  // Both maps are sorted by key, so one merge pass finds every added, changed
+  // and removed entry.
+  template <class Map, class Same>
+  void diffMaps(const Map& from, const Map& to, Map& changed, std::vector<std::string>& removed, Same same)
+  {
+    auto f = from.begin();
+    auto t = to.begin();
+    while (f != from.end() || t != to.end())
+    {
+      if (t == to.end() || (f != from.end() && f->first < t->first))
+      {
+        removed.push_back(f->first);
+        ++f;
+      }
+      else if (f == from.end() || t->first < f->first)
+      {
+        changed.insert(changed.end(), *t);
+        ++t;
+      }
+      else
+      {
+        if (!same(f->second, t->second))
+          changed.insert(changed.end(), *t);
+        ++f;
+        ++t;
+      }
+    }
+  }
+
+  using ConnectionsById = std::vector<std::pair<std::string, const ConnectionDescriptionXML*>>;
+
+  ConnectionsById connectionsById(const ConnectionsXML& connections)
+  {
+    ConnectionsById byId;
+    byId.reserve(connections.size());
+    for (const auto& c : connections)
+      byId.emplace_back(ConnectionId::create(c).id_, &c);
+    std::sort(byId.begin(), byId.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    return byId;
+  }
+
+  // Appends the connections of lhs that are not in rhs, in the order of lhs' ids
+  void diffConnections(const ConnectionsById& lhs, const ConnectionsById& rhs, ConnectionsXML& onlyInLhs)
+  {
+    auto r = rhs.begin();
+    for (const auto& entry : lhs)
+    {
+      while (r != rhs.end() && r->first < entry.first)
+        ++r;
+      if (r == rhs.end() || r->first != entry.first)
+        onlyInLhs.push_back(*entry.second);
+    }
+  }
+
+  template <class Map>
+  void applyMap(Map& map, const Map& changed, const std::vector<std::string>& removed)
+  {
+    for (const auto& key : removed)
+      map.erase(key);
+    for (const auto& entry : changed)
+      map[entry.first] = entry.second;
+  }
+}
+
+bool SCIRun::Dataflow::Networks::operator==(const ModuleWithState& lhs, const ModuleWithState& rhs)
+{
+  if (!(static_cast<const ModuleLookupInfo&>(lhs.module) == static_cast<const ModuleLookupInfo&>(rhs.module)))
+    return false;
+  const auto keys = lhs.state.getKeys();
+  if (keys != rhs.state.getKeys())
+    return false;
+  return std::all_of(keys.begin(), keys.end(), [&](const auto& key) { return lhs.state.getValue(key) == rhs.state.getValue(key); });
+}
+
+bool SCIRun::Dataflow::Networks::operator!=(const ModuleWithState& lhs, const ModuleWithState& rhs)
+{
+  return !(lhs == rhs);
+}
+
+bool NetworkFileDelta::empty() const
+{
+  return modulesChanged.empty() && modulesRemoved.empty()
+    && connectionsAdded.empty() && connectionsRemoved.empty()
+    && positionsChanged.empty() && positionsRemoved.empty()
+    && !moduleNotes && !connectionNotes && !moduleTags && !disabledComponents && !subnetworks;
+}
+
+NetworkFileDelta SCIRun::Dataflow::Networks::diffNetworkFiles(const NetworkFile& from, const NetworkFile& to)
+{
+  NetworkFileDelta delta;
+
+  diffMaps(from.network.modules, to.network.modules, delta.modulesChanged, delta.modulesRemoved,
+    [](const ModuleWithState& lhs, const ModuleWithState& rhs) { return lhs == rhs; });
+
+  diffMaps(from.modulePositions.modulePositions, to.modulePositions.modulePositions, delta.positionsChanged, delta.positionsRemoved,
+    [](const std::pair<double, double>& lhs, const std::pair<double, double>& rhs) { return lhs == rhs; });
+
+  // ConnectionDescriptionXML's operator< only orders input ports, so the
+  // connections are matched by their full id
+  const auto fromConnections = connectionsById(from.network.connections);
+  const auto toConnections = connectionsById(to.network.connections);
+  diffConnections(fromConnections, toConnections, delta.connectionsRemoved);
+  diffConnections(toConnections, fromConnections, delta.connectionsAdded);
+
+  if (!sameNotes(from.moduleNotes.notes, to.moduleNotes.notes))
+    delta.moduleNotes = to.moduleNotes;
+  if (!sameNotes(from.connectionNotes.notes, to.connectionNotes.notes))
+    delta.connectionNotes = to.connectionNotes;
+  if (!sameTags(from.moduleTags, to.moduleTags))
+    delta.moduleTags = to.moduleTags;
+  if (!sameDisabled(from.disabledComponents, to.disabledComponents))
+    delta.disabledComponents = to.disabledComponents;
+  if (from.subnetworks.subnets != to.subnetworks.subnets)
+    delta.subnetworks = to.subnetworks;
+
+  return delta;
+}
+
+void SCIRun::Dataflow::Networks::applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta)
+{
+  applyMap(file.network.modules, delta.modulesChanged, delta.modulesRemoved);
+  applyMap(file.modulePositions.modulePositions, delta.positionsChanged, delta.positionsRemoved);
+
+  if (!delta.connectionsRemoved.empty())
+  {
+    std::vector<std::string> removed;
+    for (const auto& c : delta.connectionsRemoved)
+      removed.push_back(ConnectionId::create(c).id_);
+    std::sort(removed.begin(), removed.end());
+    auto& connections = file.network.connections;
+    connections.erase(std::remove_if(connections.begin(), connections.end(), [&](const ConnectionDescriptionXML& c)
+      {
+        return std::binary_search(removed.begin(), removed.end(), ConnectionId::create(c).id_);
+      }), connections.end());
+  }
+  file.network.connections.insert(file.network.connections.end(), delta.connectionsAdded.begin(), delta.connectionsAdded.end());
+
+  if (delta.moduleNotes)
+    file.moduleNotes = *delta.moduleNotes;
+  if (delta.connectionNotes)
+    file.connectionNotes = *delta.connectionNotes;
+  if (delta.moduleTags)
+    file.moduleTags = *delta.moduleTags;
+  if (delta.disabledComponents)
+    file.disabledComponents = *delta.disabledComponents;
+  if (delta.subnetworks)
+    file.subnetworks = *delta.subnetworks;
+}
@@ -0,0 +1,74 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+#define CORE_SERIALIZATION_NETWORK_NETWORK_FILE_DELTA_H
+
+#include <optional>
+#include <Dataflow/Serialization/Network/NetworkDescriptionSerialization.h>
+#include <Dataflow/Serialization/Network/share.h>
+
+namespace SCIRun {
+namespace Dataflow {
+namespace Networks {
+
+  /// Structural difference between two network files. Modules are matched by
+  /// id and only the added or changed ones are stored, with their full state;
+  /// connections and module positions are diffed the same way. The remaining
+  /// sections are small and are stored whole when they differ.
+  struct SCISHARE NetworkFileDelta
+  {
+    ModuleMapXML modulesChanged;
+    std::vector<std::string> modulesRemoved;
+    ConnectionsXML connectionsAdded;
+    ConnectionsXML connectionsRemoved;
+    ModulePositions::Data positionsChanged;
+    std::vector<std::string> positionsRemoved;
+    std::optional<ModuleNotes> moduleNotes;
+    std::optional<ConnectionNotes> connectionNotes;
+    std::optional<ModuleTags> moduleTags;
+    std::optional<DisabledComponents> disabledComponents;
+    std::optional<Subnetworks> subnetworks;
+
+    bool empty() const;
+  };
+
+  /// Returns the delta that takes from to to.
+  SCISHARE NetworkFileDelta diffNetworkFiles(const NetworkFile& from, const NetworkFile& to);
+
+  /// Applies a delta made by diffNetworkFiles to a copy of its from file.
+  /// Connections that were added are appended after the unchanged ones.
+  SCISHARE void applyNetworkFileDelta(NetworkFile& file, const NetworkFileDelta& delta);
+
+  SCISHARE bool operator==(const ModuleWithState& lhs, const ModuleWithState& rhs);
+  SCISHARE bool operator!=(const ModuleWithState& lhs, const ModuleWithState& rhs);
+
+}}}
+
+#endif
@@ -0,0 +1,118 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Dataflow/Serialization/Network/NetworkFileDelta.h>
+#include <Dataflow/Serialization/Network/XMLSerializer.h>
+#include <gtest/gtest.h>
+
+using namespace SCIRun::Dataflow::Networks;
+using namespace SCIRun::Core::Algorithms;
+
+namespace
+{
+  ModuleWithState module(const std::string& name, const std::string& category, int value)
+  {
+    ModuleLookupInfoXML info;
+    info.module_name_ = name;
+    info.category_name_ = category;
+    info.package_name_ = "SCIRun";
+    SCIRun::Dataflow::State::SimpleMapModuleStateXML state;
+    state.setValue(AlgorithmParameterName("value"), value);
+    return ModuleWithState(info, state);
+  }
+
+  ConnectionDescriptionXML connection(const std::string& from, const std::string& to)
+  {
+    ConnectionDescriptionXML conn;
+    conn.out_.moduleId_ = ModuleId(from);
+    conn.in_.moduleId_ = ModuleId(to);
+    conn.out_.portId_ = PortId(0, "Matrix");
+    conn.in_.portId_ = PortId(0, "InputMatrix");
+    return conn;
+  }
+
+  NetworkFile exampleFile()
+  {
+    NetworkFile file;
+    file.network.modules["ReadMatrix:0"] = module("ReadMatrix", "DataIO", 1);
+    file.network.modules["EvaluateLinearAlgebraUnary:0"] = module("EvaluateLinearAlgebraUnary", "Math", 2);
+    file.network.modules["WriteMatrix:0"] = module("WriteMatrix", "DataIO", 3);
+    file.network.connections.push_back(connection("ReadMatrix:0", "EvaluateLinearAlgebraUnary:0"));
+    file.network.connections.push_back(connection("EvaluateLinearAlgebraUnary:0", "WriteMatrix:0"));
+    file.modulePositions.modulePositions["ReadMatrix:0"] = { 0, 0 };
+    file.modulePositions.modulePositions["EvaluateLinearAlgebraUnary:0"] = { 0, 100 };
+    file.modulePositions.modulePositions["WriteMatrix:0"] = { 0, 200 };
+    return file;
+  }
+
+  std::string toXml(const NetworkFile& file)
+  {
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(file, ostr, "networkFile");
+    return ostr.str();
+  }
+}
+
+TEST(NetworkFileDeltaTests, IdenticalFilesGiveEmptyDelta)
+{
+  const auto file = exampleFile();
+  EXPECT_TRUE(diffNetworkFiles(file, file).empty());
+}
+
+TEST(NetworkFileDeltaTests, DeltaHoldsOnlyWhatChanged)
+{
+  const auto from = exampleFile();
+  auto to = from;
+  to.network.modules.erase("WriteMatrix:0");
+  to.modulePositions.modulePositions.erase("WriteMatrix:0");
+  to.network.connections.pop_back();
+  to.network.modules["EvaluateLinearAlgebraUnary:0"] = module("EvaluateLinearAlgebraUnary", "Math", 7);
+  to.network.modules["ReportMatrixInfo:0"] = module("ReportMatrixInfo", "Math", 4);
+  to.network.connections.push_back(connection("EvaluateLinearAlgebraUnary:0", "ReportMatrixInfo:0"));
+  to.modulePositions.modulePositions["ReportMatrixInfo:0"] = { 100, 200 };
+  to.moduleNotes.notes["ReadMatrix:0"] = NoteXML("<p>input</p>", 1, "input");
+
+  const auto delta = diffNetworkFiles(from, to);
+  EXPECT_FALSE(delta.empty());
+  ASSERT_EQ(2, delta.modulesChanged.size());
+  EXPECT_EQ(1, delta.modulesChanged.count("EvaluateLinearAlgebraUnary:0"));
+  EXPECT_EQ(1, delta.modulesChanged.count("ReportMatrixInfo:0"));
+  EXPECT_EQ(std::vector<std::string>{ "WriteMatrix:0" }, delta.modulesRemoved);
+  EXPECT_EQ(1, delta.connectionsAdded.size());
+  EXPECT_EQ(1, delta.connectionsRemoved.size());
+  EXPECT_EQ(1, delta.positionsChanged.size());
+  EXPECT_EQ(1, delta.positionsRemoved.size());
+  EXPECT_TRUE(delta.moduleNotes.has_value());
+  EXPECT_FALSE(delta.connectionNotes.has_value());
+  EXPECT_FALSE(delta.moduleTags.has_value());
+
+  auto rebuilt = from;
+  applyNetworkFileDelta(rebuilt, delta);
+  EXPECT_EQ(toXml(to), toXml(rebuilt));
+}
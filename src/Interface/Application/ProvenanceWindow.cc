@@ -89,15 +89,6 @@ public:
     QListWidgetItem(QString::fromStdString(info->name()), parent),
     info_(info)
   {
-    auto xml = info_->memento();
-    if (xml)
-    {
-      std::ostringstream ostr;
-      XMLSerializer::save_xml(*xml, ostr, "networkFile");
-      xmlText_ = QString::fromStdString(ostr.str());
-    }
-    else
-      xmlText_ = "<Unknown state for this item>";
   }
   void setAsUndo()
   {
@@ -113,9 +104,15 @@ public:
     setFont(f);
     setBackground(Qt::lightGray);
   }
+  // Items only hold a delta of the network, so the full text is rebuilt when shown
   QString xmlText() const
   {
-    return xmlText_;
+    auto xml = info_->memento();
+    if (!xml)
+      return "<Unknown state for this item>";
+    std::ostringstream ostr;
+    XMLSerializer::save_xml(*xml, ostr, "networkFile");
+    return QString::fromStdString(ostr.str());
   }
   std::string name() const
   {
@@ -123,7 +120,6 @@ public:
   }
 private:
   ProvenanceItemHandle info_;
-  QString xmlText_;
 };
 
 void ProvenanceWindow::addProvenanceItem(ProvenanceItemHandle item)
@@ -315,7 +311,7 @@ void GuiActionProvenanceConverter::moduleAdded(const std::string& name, SCIRun::
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(makeShared<ModuleAddedProvenanceItem>(name, mod->id().id_, editor_->saveNetwork(), pythonAPIPtr));
+    ProvenanceItemHandle item(makeShared<ModuleAddedProvenanceItem>(name, mod->id().id_, recorder_.record(editor_->saveNetwork()), pythonAPIPtr));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -324,7 +320,7 @@ void GuiActionProvenanceConverter::moduleRemoved(const ModuleId& id)
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(makeShared<ModuleRemovedProvenanceItem>(id, editor_->saveNetwork(), pythonAPIPtr));
+    ProvenanceItemHandle item(makeShared<ModuleRemovedProvenanceItem>(id, recorder_.record(editor_->saveNetwork()), pythonAPIPtr));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -333,7 +329,7 @@ void GuiActionProvenanceConverter::connectionAdded(const SCIRun::Dataflow::Netwo
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(makeShared<ConnectionAddedProvenanceItem>(cd, editor_->saveNetwork(), pythonAPIPtr));
+    ProvenanceItemHandle item(makeShared<ConnectionAddedProvenanceItem>(cd, recorder_.record(editor_->saveNetwork()), pythonAPIPtr));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -342,7 +338,7 @@ void GuiActionProvenanceConverter::connectionRemoved(const SCIRun::Dataflow::Net
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(makeShared<ConnectionRemovedProvenanceItem>(id, editor_->saveNetwork(), pythonAPIPtr));
+    ProvenanceItemHandle item(makeShared<ConnectionRemovedProvenanceItem>(id, recorder_.record(editor_->saveNetwork()), pythonAPIPtr));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -351,7 +347,7 @@ void GuiActionProvenanceConverter::moduleMoved(const SCIRun::Dataflow::Networks:
 {
   if (!provenanceManagerModifyingNetwork_)
   {
-    ProvenanceItemHandle item(makeShared<ModuleMovedProvenanceItem>(id, newX, newY, oldPos.x(), oldPos.y(), editor_->saveNetwork(), pythonAPIPtr));
+    ProvenanceItemHandle item(makeShared<ModuleMovedProvenanceItem>(id, newX, newY, oldPos.x(), oldPos.y(), recorder_.record(editor_->saveNetwork()), pythonAPIPtr));
     Q_EMIT provenanceItemCreated(item);
   }
 }
@@ -36,6 +36,7 @@
 #include <Dataflow/Engine/Controller/ControllerInterfaces.h>
 #include <Dataflow/Serialization/Network/ModulePositionGetter.h>
 #include <Dataflow/Engine/Controller/ProvenanceManager.h>
+#include <Dataflow/Engine/Controller/ProvenanceItemImpl.h>
 #endif
 
 namespace SCIRun {
@@ -94,6 +95,7 @@ Q_SIGNALS:
 private:
   NetworkEditor* editor_;
   bool provenanceManagerModifyingNetwork_;
+  SCIRun::Dataflow::Engine::NetworkStateRecorder recorder_;
 };
 
 }
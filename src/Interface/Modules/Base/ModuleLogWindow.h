@@ -31,6 +31,7 @@
 
 #include "Interface/Modules/Base/ui_ModuleLogWindow.h"
 
+#include <atomic>
 #include <Core/Logging/LoggerInterface.h>
 #include <Dataflow/Network/NetworkFwd.h>
 #include <Interface/Modules/Base/share.h>
@@ -73,6 +74,7 @@ public:
   void status(const std::string& msg) const override;
   bool errorReported() const override { return errorReported_; }
   void setErrorFlag(bool flag) override { errorReported_ = flag; }
+  bool takeErrorFlag() override { return errorReported_.exchange(false); }
 
 Q_SIGNALS:
   void logSignal(const QString& message, const QColor& color) const;
@@ -80,7 +82,7 @@ Q_SIGNALS:
   void popup(const QString& message) const;
 private:
   std::string moduleName_;
-  mutable bool errorReported_{ false };
+  mutable std::atomic<bool> errorReported_{ false };
 };
 
 }
@@ -28,6 +28,7 @@
 
 #include <Interface/Modules/Math/SolveLinearSystemDialog.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Logging/Log.h>
 #include <Dataflow/Network/ModuleStateInterface.h>  //TODO: extract into intermediate
 
@@ -51,6 +52,7 @@ SolveLinearSystemDialog::SolveLinearSystemDialog(const std::string& name, Module
 
   addSpinBoxManager(maxIterationsSpinBox_, Variables::MaxIterations);
   addDoubleSpinBoxManager(targetErrorSpinBox_, Variables::TargetError);
+  addCheckBoxManager(mixedPrecisionCheckBox_, Core::Algorithms::Math::Parameters::MixedPrecision);
 
 #if 0 //TODO: make compiler symbol for WITH_QWT_WIDGETS
   //TODO: fix parenting, all these objects leak
@@ -88,6 +90,7 @@ SolveLinearSystemDialog::SolveLinearSystemDialog(const std::string& name, Module
   addComboBoxManager(preconditionerComboBox_, Variables::Preconditioner);
   addComboBoxManager(methodComboBox_, Variables::Method,
     {{"Conjugate Gradient (SCI)", "cg"},
+    {"Pipelined Conjugate Gradient (SCI)", "pipecg"},
     {"BiConjugate Gradient (SCI)", "bicg"},
     {"Jacobi (SCI)", "jacobi"},
     {"MINRES (SCI)", "minres"}});
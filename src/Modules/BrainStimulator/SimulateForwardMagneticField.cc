@@ -53,6 +53,8 @@ SimulateForwardMagneticField::SimulateForwardMagneticField() : Module(staticInfo
 
 void SimulateForwardMagneticField::setStateDefaults()
 {
+  setStateBoolFromAlgo(Parameters::UseTreeCode);
+  setStateDoubleFromAlgo(Parameters::TreeCodeTolerance);
 }
 
 void SimulateForwardMagneticField::execute()
@@ -64,6 +66,8 @@ void SimulateForwardMagneticField::execute()
 
   if (needToExecute())
   {
+    setAlgoBoolFromState(Parameters::UseTreeCode);
+    setAlgoDoubleFromState(Parameters::TreeCodeTolerance);
      auto output = algo().run(make_input((ElectricField, EField)(ConductivityTensor, CondTensor)(DipoleSources, Dipoles)(DetectorLocations, Detectors)));
     sendOutputFromAlgorithm(MagneticField, output);
     sendOutputFromAlgorithm(MagneticFieldMagnitudes, output);
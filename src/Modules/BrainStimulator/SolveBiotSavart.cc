@@ -51,6 +51,8 @@ void SolveBiotSavart::setStateDefaults()
 {
   auto state = get_state();
   setStateIntFromAlgo(Parameters::OutType);
+  setStateBoolFromAlgo(Parameters::UseTreeCode);
+  setStateDoubleFromAlgo(Parameters::TreeCodeTolerance);
 }
 
 void SolveBiotSavart::execute()
@@ -58,6 +60,8 @@ void SolveBiotSavart::execute()
   if (oport_connected(VectorBField) || oport_connected(VectorAField))
   {
     setAlgoIntFromState(Parameters::OutType);
+    setAlgoBoolFromState(Parameters::UseTreeCode);
+    setAlgoDoubleFromState(Parameters::TreeCodeTolerance);
 
     if (oport_connected(VectorBField) && oport_connected(VectorAField))
     {
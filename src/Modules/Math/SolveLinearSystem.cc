@@ -32,6 +32,7 @@
 #include <Modules/Math/SolveLinearSystem.h>
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Algorithms/Base/AlgorithmVariableNames.h>
+#include <Core/Algorithms/Math/LinearSystem/SolveLinearSystemAlgo.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/DenseColumnMatrix.h>
 #include <Core/Datatypes/MatrixTypeConversions.h>
@@ -57,6 +58,7 @@ void SolveLinearSystem::setStateDefaults()
   setStateIntFromAlgo(Variables::MaxIterations);
   setStateStringFromAlgoOption(Variables::Method);
   setStateStringFromAlgoOption(Variables::Preconditioner);
+  setStateBoolFromAlgo(Core::Algorithms::Math::Parameters::MixedPrecision);
 }
 
 void SolveLinearSystem::execute()
@@ -67,14 +69,27 @@ void SolveLinearSystem::execute()
   if (needToExecute())
   {
     /// @todo: why aren't these checks in the algo class?
-    if (rhs->ncols() != 1)
-      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain only one column.");
+    if (rhs->ncols() < 1)
+      THROW_ALGORITHM_INPUT_ERROR("Right-hand side matrix must contain at least one column.");
     if (!matrixIs::sparse(A))
       THROW_ALGORITHM_INPUT_ERROR("Left-hand side matrix to solve must be sparse.");
 
-    auto rhsCol = castMatrix::toColumn(rhs);
-    if (!rhsCol)
-      rhsCol = convertMatrix::toColumn(rhs);
+    // Several columns are solved together and give a solution matrix with one column each
+    MatrixHandle rhsInput;
+    if (rhs->ncols() == 1)
+    {
+      auto rhsCol = castMatrix::toColumn(rhs);
+      if (!rhsCol)
+        rhsCol = convertMatrix::toColumn(rhs);
+      rhsInput = rhsCol;
+    }
+    else
+    {
+      auto rhsDense = castMatrix::toDense(rhs);
+      if (!rhsDense)
+        rhsDense = convertMatrix::toDense(rhs);
+      rhsInput = rhsDense;
+    }
 
     auto tolerance = get_state()->getValue(Variables::TargetError).toDouble();
     auto maxIterations = get_state()->getValue(Variables::MaxIterations).toInt();
@@ -91,16 +106,19 @@ void SolveLinearSystem::execute()
       algo().setOption(Variables::Method, method);
     if (!precond.empty())
       algo().setOption(Variables::Preconditioner, precond);
+    setAlgoBoolFromState(Core::Algorithms::Math::Parameters::MixedPrecision);
 
     std::ostringstream ostr;
     ostr << "Running algorithm Parallel " << method << " Solver with tolerance " << tolerance << " and maximum iterations " << maxIterations;
+    if (rhs->ncols() > 1)
+      ostr << " for " << rhs->ncols() << " right-hand sides";
     remark(ostr.str());
 
     {
       ScopedTimeRemarker perf(this, "Linear solver");
       remark("Using preconditioner: " + precond);
 
-      auto output = algo().run(withInputData((LHS, A)(RHS, rhsCol)));
+      auto output = algo().run(withInputData((LHS, A)(RHS, rhsInput)));
 
       sendOutputFromAlgorithm(Solution, output);
     }
@@ -31,6 +31,8 @@
 #include <Core/Algorithms/Base/AlgorithmPreconditions.h>
 #include <Core/Datatypes/DenseMatrix.h>
 #include <Core/Datatypes/SparseRowMatrix.h>
+#include <Core/Datatypes/MatrixTypeConversions.h>
+#include <Core/Algorithms/Base/AlgorithmVariableNames.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::Modules::Math;
@@ -84,3 +86,46 @@ TEST_F(SolveLinearSystemModuleTest, CanSolveSimple)
 
   sls->execute();
 }
+
+TEST_F(SolveLinearSystemModuleTest, CanSolveMultipleRightHandSides)
+{
+  UseRealAlgorithmFactory f;
+
+  auto sls = makeModule("SolveLinearSystem");
+  const int n = 5;
+  SparseRowMatrixHandle lhs(new SparseRowMatrix(n,n));
+  for (int i = 0; i < n; ++i)
+  {
+    lhs->insert(i,i) = 4;
+    if (i > 0)
+      lhs->insert(i,i-1) = -1;
+    if (i < n-1)
+      lhs->insert(i,i+1) = -1;
+  }
+  lhs->makeCompressed();
+  DenseMatrixHandle rhs(new DenseMatrix(n,3));
+  for (int i = 0; i < n; ++i)
+  {
+    (*rhs)(i,0) = 1;
+    (*rhs)(i,1) = i;
+    (*rhs)(i,2) = (i % 2) ? -2 : 3;
+  }
+
+  stubPortNWithThisData(sls, 0, lhs);
+  stubPortNWithThisData(sls, 1, rhs);
+
+  sls->execute();
+
+  auto solution = castMatrix::toDense(std::dynamic_pointer_cast<MatrixBase<double>>(getDataOnThisOutputPort(sls, 0)));
+  ASSERT_TRUE(solution != nullptr);
+  ASSERT_EQ(n, solution->nrows());
+  ASSERT_EQ(rhs->ncols(), solution->ncols());
+
+  const double tolerance = sls->get_state()->getValue(Variables::TargetError).toDouble();
+  for (int j = 0; j < rhs->ncols(); ++j)
+  {
+    DenseColumnMatrix b = rhs->col(j);
+    DenseColumnMatrix residual = *lhs * solution->col(j) - b;
+    EXPECT_LE(residual.norm(), tolerance * b.norm()) << "right-hand side " << j;
+  }
+}
@@ -109,6 +109,15 @@ namespace SCIRun
                 auto mat = convertToDenseMatrix(list);
                 module_.sendOutput(matrixPort, makeShared<Datatypes::DenseMatrix>(mat));
               }
+              else if (var.name().name() == Core::Python::pyDenseMatrixLabel())
+              {
+                auto dense = std::dynamic_pointer_cast<Datatypes::DenseMatrix>(var.getDatatype());
+                if (dense)
+                {
+                  output = dense;
+                  module_.sendOutput(matrixPort, dense);
+                }
+              }
               else if (var.name().name() == Core::Python::pySparseRowMatrixLabel())
               {
                 auto sparse = std::dynamic_pointer_cast<Core::Datatypes::SparseRowMatrix>(var.getDatatype());
@@ -0,0 +1,242 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#include <Modules/Visualization/BoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Basis/TetLinearLgn.h>
+#include <Core/Basis/HexTrilinearLgn.h>
+#include <Core/Thread/Parallel.h>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+
+using namespace SCIRun;
+using namespace SCIRun::Modules::Visualization;
+using namespace SCIRun::Core::Basis;
+using namespace SCIRun::Core::Geometry;
+using namespace SCIRun::Core::Thread;
+
+namespace
+{
+  using FaceKey = std::array<index_type, 4>;
+
+  struct ElementTopology
+  {
+    const index_type* cells;
+    const Point* points;
+    size_t nodesPerElem;
+    size_t facesPerElem;
+    size_t nodesPerFace;
+    std::vector<int> faceTable;
+
+    index_type faceNode(size_t face, size_t j) const
+    {
+      const auto elem = face / facesPerElem;
+      const auto local = face % facesPerElem;
+      return cells[elem * nodesPerElem + faceTable[local * nodesPerFace + j]];
+    }
+
+    FaceKey key(size_t face) const
+    {
+      FaceKey k;
+      k.fill(std::numeric_limits<index_type>::max());
+      for (size_t j = 0; j < nodesPerFace; ++j)
+        k[j] = faceNode(face, j);
+      std::sort(k.begin(), k.begin() + nodesPerFace);
+      return k;
+    }
+  };
+
+  template <int F, int N>
+  std::vector<int> flattenFaceTable(const int (&table)[F][N])
+  {
+    std::vector<int> flat;
+    for (int i = 0; i < F; ++i)
+      flat.insert(flat.end(), table[i], table[i] + N);
+    return flat;
+  }
+
+  /// Marks faces whose sorted node set occurs once. FaceId only needs to hold
+  /// the number of element faces, so most meshes get by with 32 bits.
+  template <class FaceId>
+  void markBoundaryFaces(const ElementTopology& topo, size_t numNodes, size_t numFaces, std::vector<char>& isBoundary)
+  {
+    std::vector<std::atomic<uint32_t>> counts(numNodes);
+    Parallel::For(0, numFaces, [&](size_t begin, size_t end)
+    {
+      for (auto f = begin; f < end; ++f)
+        counts[topo.key(f)[0]].fetch_add(1, std::memory_order_relaxed);
+    });
+
+    std::vector<size_t> offsets(numNodes + 1, 0);
+    for (size_t n = 0; n < numNodes; ++n)
+    {
+      offsets[n + 1] = offsets[n] + counts[n].load(std::memory_order_relaxed);
+      counts[n].store(0, std::memory_order_relaxed);
+    }
+
+    std::vector<FaceId> buckets(numFaces);
+    Parallel::For(0, numFaces, [&](size_t begin, size_t end)
+    {
+      for (auto f = begin; f < end; ++f)
+      {
+        const auto n = topo.key(f)[0];
+        buckets[offsets[n] + counts[n].fetch_add(1, std::memory_order_relaxed)] = static_cast<FaceId>(f);
+      }
+    });
+
+    Parallel::For(0, numNodes, [&](size_t begin, size_t end)
+    {
+      std::vector<std::pair<FaceKey, FaceId>> bucket;
+      for (auto n = begin; n < end; ++n)
+      {
+        bucket.clear();
+        for (auto b = offsets[n]; b < offsets[n + 1]; ++b)
+          bucket.emplace_back(topo.key(buckets[b]), buckets[b]);
+        std::sort(bucket.begin(), bucket.end());
+        for (size_t i = 0; i < bucket.size(); )
+        {
+          auto j = i + 1;
+          while (j < bucket.size() && bucket[j].first == bucket[i].first)
+            ++j;
+          if (j == i + 1)
+            isBoundary[bucket[i].second] = 1;
+          i = j;
+        }
+      }
+    });
+  }
+}
+
+bool SCIRun::Modules::Visualization::canExtractBoundaryFaces(VMesh* mesh)
+{
+  return mesh && mesh->is_unstructuredmesh() && mesh->dimensionality() == 3 &&
+    mesh->basis_order() < 2 && (mesh->is_tetvolmesh() || mesh->is_hexvolmesh());
+}
+
+BoundaryFaces SCIRun::Modules::Visualization::extractBoundaryFaces(VMesh* mesh)
+{
+  BoundaryFaces result;
+  if (!canExtractBoundaryFaces(mesh) || mesh->num_elems() == 0)
+    return result;
+
+  ElementTopology topo;
+  topo.cells = mesh->get_elems_pointer();
+  topo.points = mesh->get_points_pointer();
+  topo.nodesPerElem = mesh->num_nodes_per_elem();
+  topo.facesPerElem = mesh->num_faces_per_elem();
+  topo.nodesPerFace = mesh->num_nodes_per_face();
+  topo.faceTable = mesh->is_tetvolmesh() ? flattenFaceTable(TetLinearLgnUnitElement::unit_faces)
+    : flattenFaceTable(HexTrilinearLgnUnitElement::unit_faces);
+
+  const size_t numNodes = mesh->num_nodes();
+  const size_t numFaces = static_cast<size_t>(mesh->num_elems()) * topo.facesPerElem;
+
+  std::vector<char> isBoundary(numFaces, 0);
+  if (numFaces <= std::numeric_limits<uint32_t>::max())
+    markBoundaryFaces<uint32_t>(topo, numNodes, numFaces, isBoundary);
+  else
+    markBoundaryFaces<uint64_t>(topo, numNodes, numFaces, isBoundary);
+
+  std::vector<size_t> boundary;
+  for (size_t f = 0; f < numFaces; ++f)
+    if (isBoundary[f])
+      boundary.push_back(f);
+
+  const auto m = topo.nodesPerFace;
+  result.nodesPerFace = m;
+  result.faceElems.resize(boundary.size());
+  std::vector<index_type> faceNodes(boundary.size() * m);
+
+  // The basis face tables do not agree on winding, and elements may be
+  // inverted, so each face is oriented against its element's centroid.
+  Parallel::For(0, boundary.size(), [&](size_t begin, size_t end)
+  {
+    for (auto i = begin; i < end; ++i)
+    {
+      const auto f = boundary[i];
+      const auto elem = f / topo.facesPerElem;
+      result.faceElems[i] = static_cast<index_type>(elem);
+
+      Point centroid(0, 0, 0);
+      for (size_t j = 0; j < topo.nodesPerElem; ++j)
+        centroid += topo.points[topo.cells[elem * topo.nodesPerElem + j]];
+      centroid /= static_cast<double>(topo.nodesPerElem);
+
+      auto* nodes = &faceNodes[i * m];
+      Point faceCenter(0, 0, 0);
+      for (size_t j = 0; j < m; ++j)
+      {
+        nodes[j] = topo.faceNode(f, j);
+        faceCenter += topo.points[nodes[j]];
+      }
+      faceCenter /= static_cast<double>(m);
+
+      const auto& p = topo.points;
+      const auto normal = m == 4 ? Cross(p[nodes[2]] - p[nodes[0]], p[nodes[3]] - p[nodes[1]])
+        : Cross(p[nodes[1]] - p[nodes[0]], p[nodes[2]] - p[nodes[0]]);
+      if (Dot(normal, faceCenter - centroid) < 0)
+        std::reverse(nodes + 1, nodes + m);
+    }
+  });
+
+  std::vector<uint32_t> vertexOfNode(numNodes, std::numeric_limits<uint32_t>::max());
+  for (const auto node : faceNodes)
+  {
+    if (vertexOfNode[node] == std::numeric_limits<uint32_t>::max())
+    {
+      vertexOfNode[node] = static_cast<uint32_t>(result.vertexNodes.size());
+      result.vertexNodes.push_back(node);
+    }
+  }
+
+  result.faceVertices.resize(faceNodes.size());
+  Parallel::For(0, faceNodes.size(), [&](size_t begin, size_t end)
+  {
+    for (auto i = begin; i < end; ++i)
+      result.faceVertices[i] = vertexOfNode[faceNodes[i]];
+  });
+
+  return result;
+}
+
+std::shared_ptr<const BoundaryFaces> BoundaryFacesCache::get(VMesh* mesh)
+{
+  std::lock_guard<std::mutex> guard(lock_);
+  if (!faces_ || generation_ != mesh->generation() ||
+    numNodes_ != mesh->num_nodes() || numElems_ != mesh->num_elems())
+  {
+    faces_ = std::make_shared<const BoundaryFaces>(extractBoundaryFaces(mesh));
+    generation_ = mesh->generation();
+    numNodes_ = mesh->num_nodes();
+    numElems_ = mesh->num_elems();
+  }
+  return faces_;
+}
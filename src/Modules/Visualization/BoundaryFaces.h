@@ -0,0 +1,87 @@
+/*
+   For more information, please see: http://software.sci.utah.edu
+
+   The MIT License
+
+   Copyright (c) 2020 Scientific Computing and Imaging Institute,
+   University of Utah.
+
+   Permission is hereby granted, free of charge, to any person obtaining a
+   copy of this software and associated documentation files (the "Software"),
+   to deal in the Software without restriction, including without limitation
+   the rights to use, copy, modify, merge, publish, distribute, sublicense,
+   and/or sell copies of the Software, and to permit persons to whom the
+   Software is furnished to do so, subject to the following conditions:
+
+   The above copyright notice and this permission notice shall be included
+   in all copies or substantial portions of the Software.
+
+   THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS
+   OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+   FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL
+   THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+   LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING
+   FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+   DEALINGS IN THE SOFTWARE.
+*/
+
+
+
+#ifndef MODULES_VISUALIZATION_BOUNDARY_FACES_H
+#define MODULES_VISUALIZATION_BOUNDARY_FACES_H
+
+#include <Core/Datatypes/Legacy/Field/FieldFwd.h>
+#include <Core/Datatypes/Legacy/Base/Types.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <Modules/Visualization/share.h>
+
+namespace SCIRun {
+  namespace Modules {
+    namespace Visualization {
+
+      /// Faces of a volume mesh that belong to exactly one element, as an
+      /// indexed surface: the faces share vertices, and every face is wound so
+      /// that its normal points out of its element.
+      struct SCISHARE BoundaryFaces
+      {
+        size_t nodesPerFace = 0;
+        /// mesh node of each shared vertex
+        std::vector<index_type> vertexNodes;
+        /// nodesPerFace entries per face, indexing vertexNodes
+        std::vector<uint32_t> faceVertices;
+        /// element each face belongs to
+        std::vector<index_type> faceElems;
+
+        size_t numFaces() const { return faceElems.size(); }
+        size_t numVertices() const { return vertexNodes.size(); }
+      };
+
+      /// Unstructured linear tet and hex meshes are supported.
+      SCISHARE bool canExtractBoundaryFaces(VMesh* mesh);
+
+      /// Finds the faces without a neighbor by bucketing every element face
+      /// on its smallest node. Counting, bucketing and matching run in parallel.
+      SCISHARE BoundaryFaces extractBoundaryFaces(VMesh* mesh);
+
+      /// Remembers the faces of the last mesh seen, keyed by mesh generation,
+      /// so re-executing with new data or render settings skips the extraction.
+      class SCISHARE BoundaryFacesCache
+      {
+      public:
+        std::shared_ptr<const BoundaryFaces> get(VMesh* mesh);
+      private:
+        std::mutex lock_;
+        int generation_ = -1;
+        size_type numNodes_ = 0;
+        size_type numElems_ = 0;
+        std::shared_ptr<const BoundaryFaces> faces_;
+      };
+
+    }
+  }
+}
+
+#endif
@@ -27,6 +27,7 @@
 
 
 #include <Modules/Visualization/ShowField.h>
+#include <Modules/Visualization/BoundaryFaces.h>
 #include <Core/Datatypes/Geometry.h>
 #include <Graphics/Datatypes/RenderFieldState.h>
 #include <Core/Datatypes/Legacy/Field/VMesh.h>
@@ -38,6 +39,7 @@
 #include <Core/GeometryPrimitives/Vector.h>
 #include <Core/GeometryPrimitives/Tensor.h>
 #include <Graphics/Glyphs/GlyphGeom.h>
+#include <Core/Thread/Parallel.h>
 
 using namespace SCIRun;
 using namespace Modules::Visualization;
@@ -61,6 +63,33 @@ namespace SCIRun {
     namespace Visualization {
 namespace detail
 {
+/// Face buffers of the last execute and what their texture coordinates were
+/// computed from. When the mesh and face settings are unchanged, a new
+/// colormap or new field values only rewrite the texture coordinates.
+struct FaceBufferCache
+{
+  /// MESH_FACES: nodesPerFace vertices per mesh face, in face order.
+  /// ELEM_FACES: nodesPerFace vertices per face, colored by the element in sources.
+  /// SHARED_NODES: one vertex per mesh node in sources.
+  enum class Source { MESH_FACES, ELEM_FACES, SHARED_NODES };
+
+  struct Pass
+  {
+    std::shared_ptr<spire::VarBuffer> vbo;
+    std::shared_ptr<spire::VarBuffer> ibo;
+    size_t firstFace = 0;
+    size_t numFaces = 0;
+    std::vector<VMesh::index_type> sources;
+  };
+
+  std::string geometryKey;
+  std::string dataKey;
+  Source source = Source::MESH_FACES;
+  size_t nodesPerFace = 0;
+  size_t floatsPerVertex = 0;
+  std::vector<Pass> passes;
+};
+
 class GeometryBuilder
 {
 public:
@@ -93,6 +122,36 @@ public:
     RenderState state, GeometryHandle geom,
     const std::string& id);
 
+  /// Outer faces of a volume mesh only, as an indexed mesh with shared vertices.
+  void renderBoundaryFaces(
+    FieldHandle field,
+    std::optional<ColorMapHandle> colorMap,
+    RenderState state, GeometryHandle geom,
+    const std::string& id);
+
+  /// Reuses faceBuffers_, patching the texture coordinates if the field or colormap changed.
+  void refreshFaceColors(
+    FieldHandle field,
+    std::optional<ColorMapHandle> colorMap,
+    RenderState state, GeometryHandle geom,
+    const std::string& id);
+
+  std::string faceGeometryKey(FieldHandle field, const RenderState& state) const;
+
+  void addFacePass(
+    GeometryHandle geom,
+    const std::string& id,
+    size_t passNumber,
+    std::shared_ptr<spire::VarBuffer> vboBuffer,
+    std::shared_ptr<spire::VarBuffer> iboBuffer,
+    bool useNormals,
+    bool useColorMap,
+    bool invertNormals,
+    ColorScheme colorScheme,
+    ColorMapHandle textureMap,
+    const RenderState& state,
+    const BBox& bbox);
+
   void addFaceGeom(
     const std::vector<Point>  &points,
     const std::vector<Vector> &normals,
@@ -121,6 +180,8 @@ private:
   std::string moduleId_;
   ModuleStateHandle state_;
   Stoppable* stoppable_;
+  BoundaryFacesCache boundaryFaces_;
+  FaceBufferCache faceBuffers_;
 };
 }}}}
 
@@ -182,6 +243,7 @@ void ShowField::setStateDefaults()
 
   state->setValue(UseFaceNormals, false);
   state->setValue(FaceInvertNormals, false);
+  state->setValue(BoundaryFacesOnly, true);
 
   state->setValue(FieldName, std::string());
 
@@ -409,6 +471,14 @@ void GeometryBuilder::renderFaces(
 
   if (doLinear)
   {
+    const auto key = faceGeometryKey(field, state);
+    if (key == faceBuffers_.geometryKey && !faceBuffers_.passes.empty())
+      return refreshFaceColors(field, colorMap, state, geom, id);
+
+    faceBuffers_ = FaceBufferCache();
+    faceBuffers_.geometryKey = key;
+    if (state_->getValue(BoundaryFacesOnly).toBool() && canExtractBoundaryFaces(mesh))
+      return renderBoundaryFaces(field, colorMap, state, geom, id);
     return renderFacesLinear(field, colorMap, state, geom, id);
   }
   else
@@ -487,6 +557,33 @@ namespace
     coordinateMap = StandardColorMapFactory::create("Grayscale", 256, 0, false,
       realColorMap->getColorMapRescaleScale(), realColorMap->getColorMapRescaleShift());
   }
+
+  template <class T>
+  float colorMapIndex(VField* fld, VMesh::index_type index, const ColorMapHandle& coordinateMap)
+  {
+    T value;
+    fld->get_value(value, index);
+    return static_cast<float>(coordinateMap->valueToIndex(value));
+  }
+
+  /// Texture coordinate of the field value at index (node, face or element by basis order)
+  std::function<float(VMesh::index_type)> makeColorMapIndexer(VField* fld, const ColorMapHandle& coordinateMap)
+  {
+    if (fld->is_scalar())
+      return [=](VMesh::index_type i) { return colorMapIndex<double>(fld, i, coordinateMap); };
+    if (fld->is_vector())
+      return [=](VMesh::index_type i) { return colorMapIndex<Vector>(fld, i, coordinateMap); };
+    if (fld->is_tensor())
+      return [=](VMesh::index_type i) { return colorMapIndex<Tensor>(fld, i, coordinateMap); };
+    return [](VMesh::index_type) { return 0.0f; };
+  }
+
+  std::string faceDataKey(FieldHandle field, const ColorMapHandle& coordinateMap)
+  {
+    std::ostringstream key;
+    key << field->id() << ' ' << coordinateMap->getColorMapRescaleScale() << ' ' << coordinateMap->getColorMapRescaleShift();
+    return key.str();
+  }
 }
 
 
@@ -561,10 +658,16 @@ void GeometryBuilder::renderFacesLinear(
   size_t passNumber = 0;
   size_t facesLeft = mesh->num_faces();
 
+  faceBuffers_.source = FaceBufferCache::Source::MESH_FACES;
+  faceBuffers_.nodesPerFace = numNodesPerFace;
+  faceBuffers_.floatsPerVertex = numAttributes;
+  faceBuffers_.dataKey = faceDataKey(field, coordinateMap);
+
   while(facesLeft > 0)
   {
     const static size_t maxFacesPerPass = 1 << 24;
     int facesLeftInThisPass = std::min(facesLeft, maxFacesPerPass);
+    const size_t firstFace = mesh->num_faces() - facesLeft;
     facesLeft -= facesLeftInThisPass;
 
     // Three 32 bit ints for each triangle to index into the VBO (triangles = verticies - 2)
@@ -755,71 +858,428 @@ void GeometryBuilder::renderFacesLinear(
       --facesLeftInThisPass;
     }
 
-    std::stringstream ss;
-    ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_" << passNumber;
+    FaceBufferCache::Pass pass;
+    pass.vbo = vboBufferSPtr;
+    pass.ibo = iboBufferSPtr;
+    pass.firstFace = firstFace;
+    pass.numFaces = std::min<size_t>(mesh->num_faces() - firstFace, maxFacesPerPass);
+    faceBuffers_.passes.push_back(pass);
+
+    addFacePass(geom, id, passNumber, vboBufferSPtr, iboBufferSPtr, useNormals, useColorMap,
+      invertNormals, colorScheme, textureMap, state, mesh->get_bounding_box());
+    ++passNumber;
+  }
+}
+
 
-    std::string uniqueNodeID = id + "face" + ss.str();
-    std::string vboName = uniqueNodeID + "VBO";
-    std::string iboName = uniqueNodeID + "IBO";
-    std::string passName = uniqueNodeID + "Pass";
-    std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
 
-    std::vector<SpireVBO::AttributeData> attribs;
-    std::vector<SpireSubPass::Uniform> uniforms;
+void GeometryBuilder::addFacePass(
+  GeometryHandle geom,
+  const std::string& id,
+  size_t passNumber,
+  std::shared_ptr<spire::VarBuffer> vboBuffer,
+  std::shared_ptr<spire::VarBuffer> iboBuffer,
+  bool useNormals,
+  bool useColorMap,
+  bool invertNormals,
+  ColorScheme colorScheme,
+  ColorMapHandle textureMap,
+  const RenderState& state,
+  const BBox& bbox)
+{
+  std::stringstream ss;
+  ss << invertNormals << static_cast<int>(colorScheme) << faceTransparencyValue_ << "_" << passNumber;
 
-    attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
-    uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
-    uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
-    uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
+  std::string uniqueNodeID = id + "face" + ss.str();
+  std::string vboName = uniqueNodeID + "VBO";
+  std::string iboName = uniqueNodeID + "IBO";
+  std::string passName = uniqueNodeID + "Pass";
+  std::string shader = (useNormals ? "Shaders/Phong" : "Shaders/Flat");
 
-    if (useNormals)
+  std::vector<SpireVBO::AttributeData> attribs;
+  std::vector<SpireSubPass::Uniform> uniforms;
+
+  attribs.push_back(SpireVBO::AttributeData("aPos", 3 * sizeof(float)));
+  uniforms.push_back(SpireSubPass::Uniform("uUseClippingPlanes", true));
+  uniforms.push_back(SpireSubPass::Uniform("uUseFog", true));
+  uniforms.push_back(SpireSubPass::Uniform("uTransparency", faceTransparencyValue_));
+
+  if (useNormals)
+  {
+    attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
+    uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
+    uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+  }
+
+  SpireTexture2D texture;
+  if (useColorMap)
+  {
+    shader += "_ColorMap";
+    attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+
+    const static int colorMapResolution = 256;
+    for(int i = 0; i < colorMapResolution; ++i)
     {
-      attribs.push_back(SpireVBO::AttributeData("aNormal", 3 * sizeof(float)));
-      uniforms.push_back(SpireSubPass::Uniform("uAmbientColor", glm::vec4(0.1f, 0.1f, 0.1f, 1.0f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularColor", glm::vec4(0.1f, 0.1f, 0.1f, 0.1f)));
-      uniforms.push_back(SpireSubPass::Uniform("uSpecularPower", 32.0f));
+      ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
+      texture.bitmap.push_back(color.r()*255.99f);
+      texture.bitmap.push_back(color.g()*255.99f);
+      texture.bitmap.push_back(color.b()*255.99f);
+      texture.bitmap.push_back(color.a()*255.99f);
     }
+    texture.name = "ColorMap";
+    texture.height = 1;
+    texture.width = colorMapResolution;
+  }
+  else
+  {
+    uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
+      glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
+  }
+
+  //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
+  SpireVBO geomVBO(vboName, attribs, vboBuffer, 0, bbox, true);
+  geom->vbos().push_back(geomVBO);
+
+  SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBuffer);
+  geom->ibos().push_back(geomIBO);
 
-    SpireTexture2D texture;
+  SpireText text;
+  SpireSubPass pass(passName, vboName, iboName, shader,
+    colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+
+  for (const auto& uniform : uniforms) pass.addUniform(uniform);
+
+  geom->passes().push_back(pass);
+}
+
+namespace
+{
+  inline float* writeVertex(float* out, const Point& point, bool useNormals, const Vector& normal,
+    bool useColorMap, float texCoord)
+  {
+    *out++ = static_cast<float>(point.x());
+    *out++ = static_cast<float>(point.y());
+    *out++ = static_cast<float>(point.z());
+    if (useNormals)
+    {
+      *out++ = static_cast<float>(normal.x());
+      *out++ = static_cast<float>(normal.y());
+      *out++ = static_cast<float>(normal.z());
+    }
     if (useColorMap)
     {
-      shader += "_ColorMap";
-      attribs.push_back(SpireVBO::AttributeData("aTexCoords", 2 * sizeof(float)));
+      *out++ = texCoord;
+      *out++ = texCoord;
+    }
+    return out;
+  }
+
+  template <class T>
+  std::shared_ptr<spire::VarBuffer> makeBuffer(const std::vector<T>& data)
+  {
+    const auto bytes = data.size() * sizeof(T);
+    auto buffer = std::make_shared<spire::VarBuffer>(bytes);
+    buffer->writeBytes(reinterpret_cast<const char*>(data.data()), bytes);
+    return buffer;
+  }
+}
+
+void GeometryBuilder::renderBoundaryFaces(
+  FieldHandle field,
+  std::optional<SharedPointer<ColorMap>> colorMap,
+  RenderState state,
+  GeometryHandle geom,
+  const std::string& id)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
+  auto faces = boundaryFaces_.get(mesh);
+  const size_t numFaces = faces->numFaces();
+  if (numFaces == 0) return;
+
+  const size_t numNodesPerFace = faces->nodesPerFace;
+  const bool useQuads = (numNodesPerFace == 4);
+  const bool useNormals = state.get(RenderState::ActionFlags::USE_NORMALS);
+  const bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
+  const bool useColorMap = (fld->basis_order() >= 0 && state.get(RenderState::ActionFlags::USE_COLORMAP));
+  const bool isCellData = (fld->basis_order() == 0);
+  // A cell value colors a whole face, so those faces cannot share vertices with their neighbors.
+  const bool shareVertices = !(useColorMap && isCellData);
+  const size_t numAttributes = 3 + (useNormals ? 3 : 0) + (useColorMap ? 2 : 0);
 
-      const static int colorMapResolution = 256;
-      for(int i = 0; i < colorMapResolution; ++i)
+  ColorMapHandle textureMap, coordinateMap;
+  spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
+  const ColorScheme colorScheme = useColorMap ? ColorScheme::COLOR_MAP : ColorScheme::COLOR_UNIFORM;
+
+  const auto dataIndex = makeColorMapIndexer(fld, coordinateMap);
+
+  const Point* points = mesh->get_points_pointer();
+  auto vertexPoint = [&](size_t vertex) { return points[faces->vertexNodes[vertex]]; };
+  auto faceNormal = [&](size_t face)
+  {
+    const auto* v = &faces->faceVertices[face * numNodesPerFace];
+    return useQuads ? Cross(vertexPoint(v[2]) - vertexPoint(v[0]), vertexPoint(v[3]) - vertexPoint(v[1]))
+      : Cross(vertexPoint(v[1]) - vertexPoint(v[0]), vertexPoint(v[2]) - vertexPoint(v[0]));
+  };
+  const double normalSign = invertNormals ? -1.0 : 1.0;
+
+  // Smooth normals for the shared vertices, weighted by face area.
+  std::vector<Vector> vertexNormals;
+  if (shareVertices && useNormals)
+  {
+    vertexNormals.resize(faces->numVertices());
+    for (size_t f = 0; f < numFaces; ++f)
+    {
+      const auto normal = faceNormal(f);
+      for (size_t j = 0; j < numNodesPerFace; ++j)
+        vertexNormals[faces->faceVertices[f * numNodesPerFace + j]] += normal;
+    }
+    Parallel::For(0, vertexNormals.size(), [&](size_t begin, size_t end)
+    {
+      for (auto v = begin; v < end; ++v)
+      {
+        vertexNormals[v].safe_normalize();
+        vertexNormals[v] *= normalSign;
+      }
+    });
+  }
+
+  faceBuffers_.source = shareVertices ? FaceBufferCache::Source::SHARED_NODES : FaceBufferCache::Source::ELEM_FACES;
+  faceBuffers_.nodesPerFace = numNodesPerFace;
+  faceBuffers_.floatsPerVertex = numAttributes;
+  faceBuffers_.dataKey = faceDataKey(field, coordinateMap);
+
+  const static size_t maxFacesPerPass = 1 << 24;
+  const uint32_t unused = std::numeric_limits<uint32_t>::max();
+  std::vector<uint32_t> passVertex(shareVertices ? faces->numVertices() : 0, unused);
+  size_t passNumber = 0;
+
+  for (size_t firstFace = 0; firstFace < numFaces; firstFace += maxFacesPerPass, ++passNumber)
+  {
+    const size_t facesInThisPass = std::min(numFaces - firstFace, maxFacesPerPass);
+    const auto* faceVertices = &faces->faceVertices[firstFace * numNodesPerFace];
+
+    // Corners of each face in this pass, as indices into the pass's vertex buffer
+    std::vector<uint32_t> corners(facesInThisPass * numNodesPerFace);
+    std::vector<uint32_t> passVertices;
+    if (shareVertices)
+    {
+      for (size_t c = 0; c < corners.size(); ++c)
       {
-        ColorRGB color = textureMap->valueToColor(static_cast<float>(i)/colorMapResolution * 2.0 - 1.0);
-        texture.bitmap.push_back(color.r()*255.99f);
-        texture.bitmap.push_back(color.g()*255.99f);
-        texture.bitmap.push_back(color.b()*255.99f);
-        texture.bitmap.push_back(color.a()*255.99f);
+        auto& local = passVertex[faceVertices[c]];
+        if (local == unused)
+        {
+          local = static_cast<uint32_t>(passVertices.size());
+          passVertices.push_back(faceVertices[c]);
+        }
+        corners[c] = local;
       }
-      texture.name = "ColorMap";
-      texture.height = 1;
-      texture.width = colorMapResolution;
+      for (const auto v : passVertices)
+        passVertex[v] = unused;
     }
     else
     {
-      uniforms.push_back(SpireSubPass::Uniform("uDiffuseColor",
-        glm::vec4(state.defaultColor.r(), state.defaultColor.g(), state.defaultColor.b(), 1.0f)));
+      for (size_t c = 0; c < corners.size(); ++c)
+        corners[c] = static_cast<uint32_t>(c);
     }
 
-    //numVBOElements is only used in dead code and should be removed which is why its hard coded to 0
-    SpireVBO geomVBO(vboName, attribs, vboBufferSPtr, 0, mesh->get_bounding_box(), true);
-    geom->vbos().push_back(geomVBO);
+    std::vector<float> vertexData;
+    if (shareVertices)
+    {
+      vertexData.resize(passVertices.size() * numAttributes);
+      Parallel::For(0, passVertices.size(), [&](size_t begin, size_t end)
+      {
+        for (auto i = begin; i < end; ++i)
+        {
+          const auto v = passVertices[i];
+          writeVertex(&vertexData[i * numAttributes], vertexPoint(v), useNormals,
+            useNormals ? vertexNormals[v] : Vector(), useColorMap, dataIndex(faces->vertexNodes[v]));
+        }
+      });
+    }
+    else
+    {
+      vertexData.resize(corners.size() * numAttributes);
+      Parallel::For(0, facesInThisPass, [&](size_t begin, size_t end)
+      {
+        for (auto i = begin; i < end; ++i)
+        {
+          const auto face = firstFace + i;
+          Vector normal;
+          if (useNormals)
+          {
+            normal = faceNormal(face);
+            normal.safe_normalize();
+            normal *= normalSign;
+          }
+          const auto texCoord = dataIndex(faces->faceElems[face]);
+          auto* out = &vertexData[i * numNodesPerFace * numAttributes];
+          for (size_t j = 0; j < numNodesPerFace; ++j)
+            out = writeVertex(out, vertexPoint(faceVertices[i * numNodesPerFace + j]), useNormals, normal, useColorMap, texCoord);
+        }
+      });
+    }
 
-    SpireIBO geomIBO(iboName, SpireIBO::PRIMITIVE::TRIANGLES, sizeof(uint32_t), iboBufferSPtr);
-    geom->ibos().push_back(geomIBO);
+    std::vector<uint32_t> indices;
+    indices.reserve(facesInThisPass * (numNodesPerFace - 2) * 3);
+    for (size_t i = 0; i < facesInThisPass; ++i)
+    {
+      const auto* c = &corners[i * numNodesPerFace];
+      if (useQuads)
+        indices.insert(indices.end(), { c[0], c[1], c[2], c[2], c[3], c[0] });
+      else
+        indices.insert(indices.end(), { c[0], c[1], c[2] });
+    }
 
-    SpireText text;
-    SpireSubPass pass(passName, vboName, iboName, shader,
-      colorScheme, state, RenderType::RENDER_VBO_IBO, geomVBO, geomIBO, text, texture);
+    FaceBufferCache::Pass pass;
+    pass.vbo = makeBuffer(vertexData);
+    pass.ibo = makeBuffer(indices);
+    pass.firstFace = firstFace;
+    pass.numFaces = facesInThisPass;
+    if (shareVertices)
+    {
+      pass.sources.reserve(passVertices.size());
+      for (const auto v : passVertices)
+        pass.sources.push_back(faces->vertexNodes[v]);
+    }
+    else
+    {
+      pass.sources.assign(faces->faceElems.begin() + firstFace, faces->faceElems.begin() + firstFace + facesInThisPass);
+    }
+    faceBuffers_.passes.push_back(pass);
 
-    for (const auto& uniform : uniforms) pass.addUniform(uniform);
+    addFacePass(geom, id, passNumber, pass.vbo, pass.ibo, useNormals, useColorMap,
+      invertNormals, colorScheme, textureMap, state, mesh->get_bounding_box());
+  }
+}
 
-    geom->passes().push_back(pass);
-    ++passNumber;
+std::string GeometryBuilder::faceGeometryKey(FieldHandle field, const RenderState& state) const
+{
+  auto mesh = field->vmesh();
+  auto fld = field->vfield();
+  std::ostringstream key;
+  key << mesh->generation() << ' ' << mesh->num_nodes() << ' ' << mesh->num_elems() << ' '
+    << fld->basis_order() << ' ' << fld->is_scalar() << fld->is_vector() << fld->is_tensor() << ' '
+    << state_->getValue(BoundaryFacesOnly).toBool() << state_->getValue(FaceInvertNormals).toBool()
+    << state.get(RenderState::ActionFlags::USE_NORMALS) << state.get(RenderState::ActionFlags::USE_FACE_NORMALS)
+    << state.get(RenderState::ActionFlags::USE_COLORMAP);
+  return key.str();
+}
+
+void GeometryBuilder::refreshFaceColors(
+  FieldHandle field,
+  std::optional<SharedPointer<ColorMap>> colorMap,
+  RenderState state,
+  GeometryHandle geom,
+  const std::string& id)
+{
+  VField* fld = field->vfield();
+  VMesh*  mesh = field->vmesh();
+
+  const bool useNormals = state.get(RenderState::ActionFlags::USE_NORMALS);
+  const bool invertNormals = state_->getValue(FaceInvertNormals).toBool();
+  const bool useColorMap = (fld->basis_order() >= 0 && state.get(RenderState::ActionFlags::USE_COLORMAP));
+  const ColorScheme colorScheme = useColorMap ? ColorScheme::COLOR_MAP : ColorScheme::COLOR_UNIFORM;
+
+  ColorMapHandle textureMap, coordinateMap;
+  spiltColorMapToTextureAndCoordinates(colorMap, textureMap, coordinateMap);
+
+  // The texture coordinates depend only on the field values and the colormap
+  // rescaling, so a change of colors alone reuses the buffers as they are.
+  const auto dataKey = faceDataKey(field, coordinateMap);
+  if (useColorMap && dataKey != faceBuffers_.dataKey)
+  {
+    const auto dataIndex = makeColorMapIndexer(fld, coordinateMap);
+    const size_t stride = faceBuffers_.floatsPerVertex;
+    const size_t nodesPerFace = faceBuffers_.nodesPerFace;
+    const bool isCellData = (fld->basis_order() == 0 && mesh->dimensionality() == 3);
+    const bool isNodeData = (fld->basis_order() == 1);
+
+    for (auto& pass : faceBuffers_.passes)
+    {
+      // The old buffer may still be in use by the renderer, so patch a copy.
+      const auto bytes = pass.vbo->getBufferSize();
+      auto vbo = std::make_shared<spire::VarBuffer>(bytes);
+      vbo->writeBytes(pass.vbo->getBuffer(), bytes);
+      float* texCoords = reinterpret_cast<float*>(vbo->getBuffer()) + stride - 2;
+
+      auto setTexCoords = [&](size_t vertex, float x, float y)
+      {
+        texCoords[vertex * stride] = x;
+        texCoords[vertex * stride + 1] = y;
+      };
+
+      switch (faceBuffers_.source)
+      {
+      case FaceBufferCache::Source::SHARED_NODES:
+        Parallel::For(0, pass.sources.size(), [&](size_t begin, size_t end)
+        {
+          for (auto v = begin; v < end; ++v)
+          {
+            const auto t = dataIndex(pass.sources[v]);
+            setTexCoords(v, t, t);
+          }
+        });
+        break;
+      case FaceBufferCache::Source::ELEM_FACES:
+        Parallel::For(0, pass.numFaces, [&](size_t begin, size_t end)
+        {
+          for (auto f = begin; f < end; ++f)
+          {
+            const auto t = dataIndex(pass.sources[f]);
+            for (size_t j = 0; j < nodesPerFace; ++j)
+              setTexCoords(f * nodesPerFace + j, t, t);
+          }
+        });
+        break;
+      case FaceBufferCache::Source::MESH_FACES:
+        Parallel::For(0, pass.numFaces, [&](size_t begin, size_t end)
+        {
+          VMesh::Node::array_type nodes;
+          VMesh::Elem::array_type cells;
+          for (auto f = begin; f < end; ++f)
+          {
+            const VMesh::Face::index_type face(static_cast<VMesh::index_type>(pass.firstFace + f));
+            if (isCellData)
+            {
+              // Element data (Cells) so two sided faces.
+              mesh->get_elems(cells, face);
+              const auto x = dataIndex(cells[0]);
+              const auto y = cells.size() > 1 ? dataIndex(cells[1]) : x;
+              for (size_t j = 0; j < nodesPerFace; ++j)
+                setTexCoords(f * nodesPerFace + j, x, y);
+            }
+            else if (isNodeData)
+            {
+              mesh->get_nodes(nodes, face);
+              for (size_t j = 0; j < nodesPerFace; ++j)
+              {
+                const auto t = dataIndex(nodes[j]);
+                setTexCoords(f * nodesPerFace + j, t, t);
+              }
+            }
+            else
+            {
+              const auto t = dataIndex(face);
+              for (size_t j = 0; j < nodesPerFace; ++j)
+                setTexCoords(f * nodesPerFace + j, t, t);
+            }
+          }
+        });
+        break;
+      }
+      pass.vbo = vbo;
+    }
+    faceBuffers_.dataKey = dataKey;
+  }
+
+  size_t passNumber = 0;
+  for (const auto& pass : faceBuffers_.passes)
+  {
+    addFacePass(geom, id, passNumber++, pass.vbo, pass.ibo, useNormals, useColorMap,
+      invertNormals, colorScheme, textureMap, state, mesh->get_bounding_box());
   }
 }
 
@@ -1110,3 +1570,4 @@ ALGORITHM_PARAMETER_DEF(Visualization, TextSize);
 ALGORITHM_PARAMETER_DEF(Visualization, TextPrecision);
 ALGORITHM_PARAMETER_DEF(Visualization, TextColoring);
 ALGORITHM_PARAMETER_DEF(Visualization, UseFaceNormals);
+ALGORITHM_PARAMETER_DEF(Visualization, BoundaryFacesOnly);
@@ -28,12 +28,18 @@
 
 #include <Testing/ModuleTestBase/ModuleTestBase.h>
 #include <Modules/Visualization/ShowField.h>
+#include <Modules/Visualization/BoundaryFaces.h>
+#include <Core/Datatypes/Legacy/Field/VMesh.h>
+#include <Core/Datatypes/Legacy/Field/VField.h>
+#include <Core/Datatypes/Legacy/Field/FieldInformation.h>
+#include <Testing/Utils/SCIRunFieldSamples.h>
 #include <Core/Logging/Log.h>
 #include <Core/Datatypes/ColorMap.h>
 
 using namespace SCIRun::Testing;
 using namespace SCIRun::TestUtils;
 using namespace SCIRun::Core::Datatypes;
+using namespace SCIRun::Core::Geometry;
 using namespace SCIRun::Dataflow::Networks;
 using namespace SCIRun::Core::Algorithms;
 using namespace Visualization;
@@ -165,3 +171,139 @@ TEST_F(ShowFieldPerformanceTest, TestFacePerformance)
   }
   std::cout << "\n";
 }
+
+namespace
+{
+  FieldHandle TwoHexes()
+  {
+    FieldInformation fi(mesh_info_type::HEXVOLMESH_E, databasis_info_type::CONSTANTDATA_E, data_info_type::DOUBLE_E);
+    auto field = CreateField(fi);
+    auto vmesh = field->vmesh();
+    for (int x = 0; x < 3; ++x)
+      for (int y = 0; y < 2; ++y)
+        for (int z = 0; z < 2; ++z)
+          vmesh->add_point(Point(x, y, z));
+    auto node = [](int x, int y, int z) { return static_cast<VMesh::index_type>(x * 4 + y * 2 + z); };
+    VMesh::Node::array_type hex(8);
+    for (int x = 0; x < 2; ++x)
+    {
+      hex[0] = node(x, 0, 0); hex[1] = node(x + 1, 0, 0); hex[2] = node(x + 1, 1, 0); hex[3] = node(x, 1, 0);
+      hex[4] = node(x, 0, 1); hex[5] = node(x + 1, 0, 1); hex[6] = node(x + 1, 1, 1); hex[7] = node(x, 1, 1);
+      vmesh->add_elem(hex);
+    }
+    field->vfield()->resize_values();
+    return field;
+  }
+
+  void expectFacesPointAwayFrom(const BoundaryFaces& faces, VMesh* mesh, const Point& center)
+  {
+    for (size_t f = 0; f < faces.numFaces(); ++f)
+    {
+      std::vector<Point> p(faces.nodesPerFace);
+      for (size_t j = 0; j < faces.nodesPerFace; ++j)
+        mesh->get_point(p[j], VMesh::Node::index_type(faces.vertexNodes[faces.faceVertices[f * faces.nodesPerFace + j]]));
+      const auto normal = Cross(p[1] - p[0], p[2] - p[0]);
+      EXPECT_GT(Dot(normal, p[0] - center), 0) << "face " << f;
+    }
+  }
+}
+
+TEST(BoundaryFacesTest, CubeOfTetsHasTwoTrianglesPerSide)
+{
+  auto field = CubeTetVolLinearBasis(data_info_type::DOUBLE_E);
+  auto mesh = field->vmesh();
+  ASSERT_TRUE(canExtractBoundaryFaces(mesh));
+
+  auto faces = extractBoundaryFaces(mesh);
+  EXPECT_EQ(3, faces.nodesPerFace);
+  EXPECT_EQ(12, faces.numFaces());
+  EXPECT_EQ(8, faces.numVertices());
+  EXPECT_EQ(36, faces.faceVertices.size());
+  expectFacesPointAwayFrom(faces, mesh, Point(0.5, 0.5, 0.5));
+}
+
+TEST(BoundaryFacesTest, SharedHexFaceIsDropped)
+{
+  auto field = TwoHexes();
+  auto mesh = field->vmesh();
+  ASSERT_TRUE(canExtractBoundaryFaces(mesh));
+
+  auto faces = extractBoundaryFaces(mesh);
+  EXPECT_EQ(4, faces.nodesPerFace);
+  EXPECT_EQ(10, faces.numFaces());
+  EXPECT_EQ(12, faces.numVertices());
+  EXPECT_EQ(5, std::count(faces.faceElems.begin(), faces.faceElems.end(), 0));
+  EXPECT_EQ(5, std::count(faces.faceElems.begin(), faces.faceElems.end(), 1));
+  expectFacesPointAwayFrom(faces, mesh, Point(1, 0.5, 0.5));
+}
+
+TEST(BoundaryFacesTest, StructuredAndSurfaceMeshesAreNotSupported)
+{
+  EXPECT_FALSE(canExtractBoundaryFaces(CreateEmptyLatVol(3, 3, 3)->vmesh()));
+  EXPECT_FALSE(canExtractBoundaryFaces(CubeTriSurfLinearBasis(data_info_type::DOUBLE_E)->vmesh()));
+}
+
+TEST(BoundaryFacesTest, CacheIsKeyedOnMeshGeneration)
+{
+  BoundaryFacesCache cache;
+  auto cube = CubeTetVolLinearBasis(data_info_type::DOUBLE_E);
+  auto first = cache.get(cube->vmesh());
+  EXPECT_EQ(first, cache.get(cube->vmesh()));
+
+  FieldHandle copy(cube->deep_clone());
+  auto second = cache.get(copy->vmesh());
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first->numFaces(), second->numFaces());
+}
+
+class ShowFieldBoundaryFacesTest : public ModuleTest {};
+
+TEST_F(ShowFieldBoundaryFacesTest, RendersVolumeMeshesWithAndWithoutInteriorFaces)
+{
+  UseRealModuleStateFactory f;
+  auto showField = makeModule("ShowField");
+  showField->setStateDefaults();
+  EXPECT_TRUE(showField->get_state()->getValue(BoundaryFacesOnly).toBool());
+  stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+
+  for (auto field : { CubeTetVolLinearBasis(data_info_type::DOUBLE_E), CubeTetVolConstantBasis(data_info_type::DOUBLE_E), TwoHexes() })
+  {
+    stubPortNWithThisData(showField, 0, field);
+    for (bool boundaryOnly : { true, false })
+    {
+      showField->get_state()->setValue(BoundaryFacesOnly, boundaryOnly);
+      EXPECT_NO_THROW(showField->execute());
+    }
+  }
+}
+
+TEST_F(ShowFieldBoundaryFacesTest, RefreshesColorsWhenOnlyColorMapOrDataChange)
+{
+  UseRealModuleStateFactory f;
+  auto showField = makeModule("ShowField");
+  showField->setStateDefaults();
+
+  for (bool boundaryOnly : { true, false })
+  {
+    showField->get_state()->setValue(BoundaryFacesOnly, boundaryOnly);
+    for (auto field : { CubeTetVolLinearBasis(data_info_type::DOUBLE_E), CubeTetVolConstantBasis(data_info_type::DOUBLE_E) })
+    {
+      stubPortNWithThisData(showField, 0, field);
+      stubPortNWithThisData(showField, 1, StandardColorMapFactory::create());
+      EXPECT_NO_THROW(showField->execute());
+
+      // new colors only
+      stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale"));
+      EXPECT_NO_THROW(showField->execute());
+
+      // new rescaling
+      stubPortNWithThisData(showField, 1, StandardColorMapFactory::create("Grayscale", 256, 0, false, 2.0, -1.0));
+      EXPECT_NO_THROW(showField->execute());
+
+      // new values on the same mesh
+      FieldHandle values(field->clone());
+      stubPortNWithThisData(showField, 0, values);
+      EXPECT_NO_THROW(showField->execute());
+    }
+  }
+}